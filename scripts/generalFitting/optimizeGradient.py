@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+"""
+MASFENON gradient based fitting.
+
+The parameters of the scaling functions are updated with the gradients propagated by the simulator (--sensitivities),
+instead of the finite differences between two simulations of the iteration aware scripts:
+  - gd   : gradient descent
+  - adam : Adam (first and second moment estimates of the gradient)
+
+Pipeline overview:
+1) The initial parameter folder (same layout produced by createParametersIterationAware.py, with the subfolders
+   propagationParameters, dissipationParameters and/or conservationParameters, each with <type>.tsv files with the
+   columns Name and parameters) defines the parameter vector: every value of every node of every type of every model.
+2) At every iteration the parameters are written in
+       <out>/iteration_<k>/parameters/{propagationParameters,...}/<type>.tsv
+   and evaluated by one launch of masfenon-MPI with the *ModelParameterFolder options, --sensitivities,
+   --referenceTimeSeriesFolder and --outputFormat errorMatrix. The simulator saves the total RMSE in
+       <out>/iteration_<k>/output/errorMatrices/rmse.tsv
+   and the gradient of the sum of the squared errors of every type with respect to the parameters of the type in
+       <out>/iteration_<k>/output/gradients/<type>.tsv   (columns parameter and gradient, parameter <model>:<node>:p<index>)
+   The gradients of the types are gathered in the parameter vector, the parameters without a gradient (e.g. not reached
+   by the errors) are not changed.
+3) A step that increases the RMSE is discarded: the learning rate is halved and the step is taken again from the
+   previous parameters (at most --max-backtracks times in a row). The iteration folder is removed unless --keep-iterations.
+4) <out>/RMSE.tsv logs the RMSE, the norm of the gradient and the learning rate of every iteration
+   (iteration \t RMSE \t gradientNorm \t learningRate \t accepted), <out>/best/ contains the best parameters found,
+   in the same layout of the initial parameter folder.
+
+The gradients follow the parameters only through the type itself (the virtual inputs are treated as constants by the
+simulator) and the clamped values of the saturation have zero derivatives, so the gradient is a descent direction of
+the RMSE only locally.
+
+Example:
+  python optimizeGradient.py \
+    --iterations 30 \
+    --method adam \
+    --lr 0.01 \
+    --init-params ../../data/testFitting/parameters \
+    --graphs ../../data/testFitting/graphs \
+    --nodes ../../data/testFitting/nodesDescriptionDifferentStructure \
+    --initial ../../data/testFitting/initialValues \
+    --interactions ../../data/testFitting/interactions \
+    --real-data-dir ../../data/testFitting/syntheticTimeSeries \
+    --out /tmp/testingGradientFitting \
+    --simulator ../../build/masfenon-MPI \
+    --mpirun-np 4 \
+    --saturation
+"""
+
+import argparse
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+from pathlib import Path
+from typing import Dict, List, Tuple
+import pandas as pd
+import numpy as np
+
+MODEL_FOLDERS = ["propagationParameters", "dissipationParameters", "conservationParameters"]
+
+# ---------- Utilities ----------
+
+# Run a command and exit if it fails
+def run(cmd: List[str], cwd: str | None = None) -> None:
+    print("[cmd]", " ".join(cmd))
+    res = subprocess.run(cmd, cwd=cwd)
+    if res.returncode != 0:
+        sys.exit(res.returncode)
+
+# Ensure a directory exists
+def ensure_dir(p: Path) -> None:
+    p.mkdir(parents=True, exist_ok=True)
+
+def natural_key(s: str):
+    return [int(t) if t.isdigit() else t.lower() for t in re.split(r"(\d+)", str(s))]
+
+# ---------- Parameter vector <-> parameter folders ----------
+
+# Layout of the parameter vector: for every model folder and type, the node names and the number of values per node
+Layout = List[Tuple[str, str, List[str], int]]
+
+def read_parameter_folder(folder: Path, name_col: str) -> Tuple[Layout, np.ndarray]:
+    layout: Layout = []
+    values: List[float] = []
+    for model in MODEL_FOLDERS:
+        model_dir = folder / model
+        if not model_dir.is_dir():
+            continue
+        for fname in sorted(os.listdir(model_dir), key=natural_key):
+            if not fname.endswith(".tsv"):
+                continue
+            df = pd.read_csv(model_dir / fname, sep="\t", dtype=str)
+            if name_col not in df.columns or "parameters" not in df.columns:
+                sys.exit(f"[error] {model_dir / fname} must have the columns {name_col} and parameters")
+            nodes = df[name_col].tolist()
+            node_values = [[float(v) for v in str(p).split(",")] for p in df["parameters"]]
+            sizes = {len(v) for v in node_values}
+            if len(sizes) > 1:
+                sys.exit(f"[error] the nodes of {model_dir / fname} have a different number of parameters")
+            layout.append((model, fname[:-len(".tsv")], nodes, sizes.pop() if sizes else 0))
+            for v in node_values:
+                values.extend(v)
+    if not layout:
+        sys.exit(f"[error] {folder} does not contain any of the folders {', '.join(MODEL_FOLDERS)}")
+    return layout, np.array(values, dtype=float)
+
+def write_parameter_folder(folder: Path, layout: Layout, vector: np.ndarray, name_col: str) -> None:
+    offset = 0
+    for model, type_name, nodes, size in layout:
+        ensure_dir(folder / model)
+        rows = []
+        for node in nodes:
+            rows.append({name_col: node, "parameters": ",".join(f"{v:.10g}" for v in vector[offset:offset + size])})
+            offset += size
+        pd.DataFrame(rows, columns=[name_col, "parameters"]).to_csv(folder / model / f"{type_name}.tsv", sep="\t", index=False)
+
+# prefix of the parameter names of the simulator for every model folder
+MODEL_PREFIXES = {"propagationParameters": "propagation", "dissipationParameters": "dissipation", "conservationParameters": "conservation"}
+
+# ---------- Parameter names ----------
+
+# Position in the parameter vector of every (type, simulator parameter name)
+def parameter_indexes(layout: Layout) -> Dict[Tuple[str, str], int]:
+    indexes: Dict[Tuple[str, str], int] = {}
+    offset = 0
+    for model, type_name, nodes, size in layout:
+        for node in nodes:
+            for k in range(size):
+                indexes[(type_name, f"{MODEL_PREFIXES[model]}:{node}:p{k}")] = offset
+                offset += 1
+    return indexes
+
+# ---------- Evaluation of the parameters ----------
+
+def evaluate(args, layout: Layout, indexes: Dict[Tuple[str, str], int], vector: np.ndarray, iteration_dir: Path) -> Tuple[float, np.ndarray]:
+    parameters_dir = iteration_dir / "parameters"
+    output_dir = iteration_dir / "output"
+    if iteration_dir.exists():
+        shutil.rmtree(iteration_dir)
+    write_parameter_folder(parameters_dir, layout, vector, args.nodes_name_col)
+    models = {model for model, _, _, _ in layout}
+    cmd: List[str] = []
+    if args.mpirun_np > 0:
+        cmd += ["mpirun", "-np", str(args.mpirun_np)] + shlex.split(args.mpirun_extra)
+    cmd += [args.simulator,
+            "--graphsFilesFolder", args.graphs,
+            "--typeInteractionFolder", args.interactions,
+            "--propagationModel", args.propagation_model,
+            "--dissipationModel", "custom" if "dissipationParameters" in models else args.dissipation_model,
+            "--conservationModel", "custom" if "conservationParameters" in models else args.conservation_model,
+            "--referenceTimeSeriesFolder", args.real_data_dir,
+            "--virtualNodesGranularity", args.virtual_nodes_granularity,
+            "--sensitivities",
+            "--outputFormat", "errorMatrix",
+            "--outputFolder", str(output_dir)]
+    for model, option in [("propagationParameters", "--propagationModelParameterFolder"),
+                          ("dissipationParameters", "--dissipationModelParameterFolder"),
+                          ("conservationParameters", "--conservationModelParameterFolder")]:
+        if model in models:
+            cmd += [option, str(parameters_dir / model)]
+    if args.nodes:
+        cmd += ["--nodeDescriptionFolder", args.nodes]
+    if args.initial:
+        cmd += ["--initialPerturbationPerTypeFolder", args.initial]
+    if args.saturation:
+        cmd += ["--saturation"]
+    if args.verbose:
+        cmd += ["--verbose"]
+    cmd += shlex.split(args.simulator_extra)
+    run(cmd)
+    rmse_file = output_dir / "errorMatrices" / "rmse.tsv"
+    if not rmse_file.is_file():
+        sys.exit(f"[error] missing {rmse_file}, check the simulator output")
+    df = pd.read_csv(rmse_file, sep="\t")
+    total = df.loc[df["type"] == "total", "rmse"]
+    rmse = float(total.iloc[0]) if not total.empty else np.nan
+    # the gradients of the types are gathered in the parameter vector
+    gradient = np.zeros_like(vector)
+    gradients_dir = output_dir / "gradients"
+    for type_name in sorted({type_name for _, type_name, _, _ in layout}):
+        gradient_file = gradients_dir / f"{type_name}.tsv"
+        if not gradient_file.is_file():
+            continue
+        gdf = pd.read_csv(gradient_file, sep="\t", dtype={"parameter": str})
+        for name, value in zip(gdf["parameter"], gdf["gradient"]):
+            index = indexes.get((type_name, name))
+            if index is not None and np.isfinite(value):
+                gradient[index] += float(value)
+    if not args.keep_iterations:
+        shutil.rmtree(iteration_dir)
+    return rmse, gradient
+
+# ---------- Optimizers ----------
+
+class GradientDescent:
+    """Plain gradient descent, the step is the learning rate times the gradient."""
+
+    def __init__(self, n: int, args):
+        self.args = args
+
+    def step(self, gradient: np.ndarray, lr: float) -> np.ndarray:
+        return -lr * gradient
+
+    def accept(self) -> None:
+        pass
+
+
+class Adam:
+    """Adam, the moments are updated only by the accepted steps, so a discarded step does not change them."""
+
+    def __init__(self, n: int, args):
+        self.args = args
+        self.m = np.zeros(n)
+        self.v = np.zeros(n)
+        self.t = 0
+        self.pending = None
+
+    def step(self, gradient: np.ndarray, lr: float) -> np.ndarray:
+        t = self.t + 1
+        m = self.args.beta1 * self.m + (1 - self.args.beta1) * gradient
+        v = self.args.beta2 * self.v + (1 - self.args.beta2) * gradient ** 2
+        self.pending = (t, m, v)
+        m_hat = m / (1 - self.args.beta1 ** t)
+        v_hat = v / (1 - self.args.beta2 ** t)
+        return -lr * m_hat / (np.sqrt(v_hat) + 1e-8)
+
+    def accept(self) -> None:
+        self.t, self.m, self.v = self.pending
+
+# ---------- Main ----------
+
+def main():
+    ap = argparse.ArgumentParser(description="MASFENON gradient based fitting, the gradients are propagated by the simulator with --sensitivities")
+    ap.add_argument("--iterations", type=int, required=True)
+    ap.add_argument("--method", choices=["gd", "adam"], default="adam")
+    ap.add_argument("--lr", type=float, default=0.01, help="initial learning rate (default 0.01)")
+    ap.add_argument("--beta1", type=float, default=0.9, help="decay of the first moment of adam (default 0.9)")
+    ap.add_argument("--beta2", type=float, default=0.999, help="decay of the second moment of adam (default 0.999)")
+    ap.add_argument("--max-backtracks", type=int, default=5, help="maximum number of consecutive discarded steps before stopping (default 5)")
+    ap.add_argument("--init-params", required=True, help="initial parameter folder, with the subfolders propagationParameters, dissipationParameters and/or conservationParameters")
+    ap.add_argument("--graphs", required=True)
+    ap.add_argument("--nodes", default="", help="node descriptions folder (optional)")
+    ap.add_argument("--initial", default="", help="initial values folder (optional)")
+    ap.add_argument("--interactions", required=True)
+    ap.add_argument("--real-data-dir", required=True, help="reference time series, <type>.tsv with nodeNames + timepoint columns")
+    ap.add_argument("--out", required=True)
+    ap.add_argument("--simulator", default="masfenon-MPI")
+    ap.add_argument("--simulator-extra", default="", help="additional options for the simulator")
+    ap.add_argument("--mpirun-np", type=int, default=0, help="number of MPI processes, 0 to launch the simulator without mpirun")
+    ap.add_argument("--mpirun-extra", default="")
+    ap.add_argument("--propagation-model", default="customPropagation")
+    ap.add_argument("--dissipation-model", default="none", help="dissipation model when the initial parameters have no dissipationParameters")
+    ap.add_argument("--conservation-model", default="none", help="conservation model when the initial parameters have no conservationParameters")
+    ap.add_argument("--virtual-nodes-granularity", default="typeAndNode")
+    ap.add_argument("--nodes-name-col", default="Name")
+    ap.add_argument("--lower", type=float, default=-1.0, help="lower bound of the parameters (default -1)")
+    ap.add_argument("--upper", type=float, default=1.0, help="upper bound of the parameters (default 1)")
+    ap.add_argument("--keep-iterations", action="store_true", help="keep the parameters and the outputs of every iteration")
+    ap.add_argument("--saturation", action="store_true")
+    ap.add_argument("--verbose", action="store_true")
+    args = ap.parse_args()
+
+    if args.lr <= 0:
+        sys.exit("[error] --lr must be positive")
+    out = Path(args.out)
+    ensure_dir(out)
+    layout, x = read_parameter_folder(Path(args.init_params), args.nodes_name_col)
+    indexes = parameter_indexes(layout)
+    print(f"[info] {x.size} parameters from {len(layout)} parameter files")
+
+    optimizer = GradientDescent(x.size, args) if args.method == "gd" else Adam(x.size, args)
+    x = np.clip(x, args.lower, args.upper)
+    rmse, gradient = evaluate(args, layout, indexes, x, out / "iteration_0")
+    if not np.isfinite(rmse):
+        sys.exit("[error] the initial parameters were not scored, check the simulator output")
+    write_parameter_folder(out / "best", layout, x, args.nodes_name_col)
+    lr = args.lr
+    backtracks = 0
+    with open(out / "RMSE.tsv", "w") as log:
+        log.write("iteration\tRMSE\tgradientNorm\tlearningRate\taccepted\n")
+        log.write(f"0\t{rmse:.10g}\t{np.linalg.norm(gradient):.10g}\t{lr:.10g}\t1\n")
+        log.flush()
+        for iteration in range(1, args.iterations + 1):
+            if not np.any(gradient):
+                print("[info] the gradient is zero, stopping")
+                break
+            candidate = np.clip(x + optimizer.step(gradient, lr), args.lower, args.upper)
+            candidate_rmse, candidate_gradient = evaluate(args, layout, indexes, candidate, out / f"iteration_{iteration}")
+            accepted = np.isfinite(candidate_rmse) and candidate_rmse <= rmse
+            log.write(f"{iteration}\t{candidate_rmse:.10g}\t{np.linalg.norm(candidate_gradient):.10g}\t{lr:.10g}\t{int(accepted)}\n")
+            log.flush()
+            if accepted:
+                optimizer.accept()
+                x, rmse, gradient = candidate, candidate_rmse, candidate_gradient
+                backtracks = 0
+                shutil.rmtree(out / "best")
+                write_parameter_folder(out / "best", layout, x, args.nodes_name_col)
+                print(f"[info] iteration {iteration}: RMSE {rmse:.6g}")
+            else:
+                # the step is taken again from the same parameters and gradient with a smaller learning rate
+                lr /= 2
+                backtracks += 1
+                print(f"[info] iteration {iteration}: RMSE {candidate_rmse:.6g} not better than {rmse:.6g}, learning rate halved to {lr:.6g}")
+                if backtracks >= args.max_backtracks:
+                    print(f"[info] {backtracks} consecutive steps discarded, stopping")
+                    break
+
+    print(f"[done] best RMSE {rmse:.6g}, parameters in {out / 'best'}")
+
+
+if __name__ == "__main__":
+    main()
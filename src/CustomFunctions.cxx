@@ -132,6 +132,14 @@ std::function<double(double)> getPropagationScalingFunction(std::vector<double>
     };
 }
 
+/**
+ * @brief Breakpoints of the scaling functions with parameters.
+ * @return The breakpoints used in the scaling functions with parameters defined above.
+ */
+std::vector<double> getScalingFunctionBreakpoints() {
+    return {5.0, 6.0, 10.0};
+}
+
 /**
  * @brief Generates a saturation function with upper and lower bounds.
  * @return A lambda function that clamps a value between [-saturation, +saturation].
@@ -144,4 +152,13 @@ std::function<double(double,double)> getSaturationFunction() {
         else return value;
     };
 }
+
+/**
+ * @brief Generates the batch version of the custom saturation function.
+ * @return A function that clamps every value of an array between [-saturation, +saturation].
+ * @details The values are clamped in a single vectorized pass, a custom batch function can process the whole array in the same way.
+ */
+BatchSaturationFunction getBatchSaturationFunction() {
+    return clampSaturationBatch;
+}
  
\ No newline at end of file
@@ -8,6 +8,7 @@
 */
 #pragma once
 #include <functional>
+#include <vector>
 #include "utils/mathUtilities.hxx"
 
 /**
@@ -55,9 +56,25 @@ std::function<double(double)> getPropagationScalingFunction();
  */
 std::function<double(double)> getPropagationScalingFunction(std::vector<double> parameters);
 
+/**
+ * @brief Breakpoints of the scaling functions with parameters.
+ * @return The sorted breakpoints (in time) where the scaling functions with parameters change value.
+ * @details The scaling functions read from the parameter files are compiled into tables of values for every interval delimited by these breakpoints (@see ScaleFunctionTable).
+ * The scaling functions (with and without parameters) must be constant inside every interval between these breakpoints, the value at a breakpoint can differ.
+ * If the scaling functions are changed, the breakpoints should be changed accordingly, since they are trusted and not checked.
+ */
+std::vector<double> getScalingFunctionBreakpoints();
+
 /**
  * @brief Generates a saturation function. Should clamps a value between [-saturation, +saturation].
  * @return A saturation function that takes two double values(input value and saturation value) and returns a double value. 
  * @details The saturation function is used to limit the values of the nodes in the augmented graph. Used to prevent node values from exceeding defined logical limits in the augmented graph.
  */
-std::function<double(double,double)> getSaturationFunction();
\ No newline at end of file
+std::function<double(double,double)> getSaturationFunction();
+
+/**
+ * @brief Returns the custom saturation function as a batch function, applied to the whole output of a step in a single call.
+ * @return A function that saturates an array of values in place, given the saturation of every value.
+ * @see getSaturationFunction
+ */
+BatchSaturationFunction getBatchSaturationFunction();
\ No newline at end of file
@@ -0,0 +1,43 @@
+/**
+ * @file TrajectoryCache.cxx
+ * @ingroup Core
+ * @brief Implements the TrajectoryCache class used for restarting the runs of a parameter sweep from the states they share.
+ */
+#include "checkpoint/TrajectoryCache.hxx"
+#include "utils/mathUtilities.hxx"
+#include <stdexcept>
+#include <utility>
+
+TrajectoryCache::TrajectoryCache(size_t maxSnapshots):maxSnapshots(maxSnapshots){
+    if(maxSnapshots == 0){
+        throw std::invalid_argument("[ERROR] TrajectoryCache::TrajectoryCache: the maximum number of states must be positive. abort");
+    }
+}
+
+uint64_t TrajectoryCache::key(uint64_t scenarioIndex, int interIteration, uint64_t scalePrefixHash){
+    return hashCombine(hashCombine(hashCombine(0, scenarioIndex), static_cast<uint64_t>(interIteration)), scalePrefixHash);
+}
+
+const TrajectorySnapshot* TrajectoryCache::find(uint64_t key){
+    auto position = keyToSnapshot.find(key);
+    if(position == keyToSnapshot.end()){
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    snapshots.splice(snapshots.begin(), snapshots, position->second);
+    return &position->second->second;
+}
+
+void TrajectoryCache::store(uint64_t key, TrajectorySnapshot snapshot){
+    auto position = keyToSnapshot.find(key);
+    if(position != keyToSnapshot.end()){
+        snapshots.erase(position->second);
+        keyToSnapshot.erase(position);
+    } else if(snapshots.size() == maxSnapshots){
+        keyToSnapshot.erase(snapshots.back().first);
+        snapshots.pop_back();
+    }
+    snapshots.emplace_front(key, std::move(snapshot));
+    keyToSnapshot[key] = snapshots.begin();
+}
@@ -0,0 +1,89 @@
+/**
+ * @file TrajectoryCache.hxx
+ * @ingroup Core
+ * @brief Defines the TrajectoryCache class, an in-memory cache of the states of the types at the start of the intertype iterations.
+ * @details The runs of a parameter sweep only differ in the scaling values of the models, so two runs with the same scaling values before a time
+ * reach the same state at that time. The states are saved with a key computed from the scaling values used before the time (@see Computation::scalePrefixHash),
+ * and a run whose key matches a saved state starts from it instead of starting from the initial perturbation.
+ */
+#pragma once
+#include <cstdint>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "data_structures/ErrorMatrix.hxx"
+
+/**
+ * @struct TrajectorySnapshot
+ * @brief The state of the types of a process at the start of an intertype iteration.
+ */
+struct TrajectorySnapshot{
+    int interIteration = 0; ///< intertype iteration that starts from the state
+    std::vector<std::vector<double>> states; ///< augmented inputs of the types of the process
+    std::map<std::string, ErrorMatrix> errorMatrices; ///< errors against the reference time series accumulated before the intertype iteration, for every type of the process
+};
+
+/**
+ * @class TrajectoryCache
+ * @brief Least recently used cache of the states of the types, keyed by the scaling values used to reach them.
+ * @details Every process keeps the states of its own types, the keys are computed from the scaling values of all the types so that all the processes
+ * find the same states.
+ */
+class TrajectoryCache{
+    private:
+        size_t maxSnapshots; ///< maximum number of saved states, the least recently used one is removed when the cache is full
+        std::list<std::pair<uint64_t, TrajectorySnapshot>> snapshots; ///< the saved states, the most recently used first
+        std::unordered_map<uint64_t, std::list<std::pair<uint64_t, TrajectorySnapshot>>::iterator> keyToSnapshot; ///< position of the saved state of every key
+        size_t hits = 0; ///< number of the states found
+        size_t misses = 0; ///< number of the states not found
+    public:
+        /**
+         * @brief Constructor for the TrajectoryCache class.
+         * @param maxSnapshots The maximum number of saved states.
+         * @throw std::invalid_argument if maxSnapshots is 0.
+         */
+        explicit TrajectoryCache(size_t maxSnapshots);
+        /**
+         * @brief Compute the key of a state.
+         * @param scenarioIndex The index of the scenario, different initial perturbations give different states.
+         * @param interIteration The intertype iteration that starts from the state.
+         * @param scalePrefixHash The hash of the scaling values of all the types used before the intertype iteration.
+         * @return The key.
+         */
+        static uint64_t key(uint64_t scenarioIndex, int interIteration, uint64_t scalePrefixHash);
+        /**
+         * @brief Find a saved state, the state becomes the most recently used.
+         * @param key The key of the state.
+         * @return A pointer to the saved state, nullptr if the state is not saved. The pointer is valid until the next call to store.
+         */
+        const TrajectorySnapshot* find(uint64_t key);
+        /**
+         * @brief Check if a state is saved, without changing the order of the saved states.
+         * @param key The key of the state.
+         * @return true if the state is saved.
+         */
+        bool contains(uint64_t key) const {return keyToSnapshot.contains(key);}
+        /**
+         * @brief Save a state, replacing the state with the same key. The least recently used state is removed if the cache is full.
+         * @param key The key of the state.
+         * @param snapshot The state.
+         */
+        void store(uint64_t key, TrajectorySnapshot snapshot);
+        /**
+         * @brief Get the number of saved states.
+         * @return The number of saved states.
+         */
+        size_t size() const {return snapshots.size();}
+        /**
+         * @brief Get the number of states found by find.
+         * @return The number of hits.
+         */
+        size_t getHits() const {return hits;}
+        /**
+         * @brief Get the number of states not found by find.
+         * @return The number of misses.
+         */
+        size_t getMisses() const {return misses;}
+};
@@ -8,13 +8,17 @@
 #include "data_structures/Matrix.hxx"
 #include "data_structures/WeightedEdgeGraph.hxx"
 #include "utils/armaUtilities.hxx"
+#include "utils/graphUtilities.hxx"
 #include "utils/mathUtilities.hxx"
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <unordered_set>
 #include <vector>
 
 
@@ -68,13 +72,8 @@ Computation::Computation(std::string _thisType,const std::vector<double>& _input
     types = std::vector<std::string>();
 
 
-    std::vector<double> normalizationFactors(graph->getNumNodes(),0);
-    for (int i = 0; i < graph->getNumNodes(); i++) {
-        for(int j = 0; j < graph->getNumNodes();j++){
-            normalizationFactors[i] += std::abs(graph->getEdgeWeight(i,j)); 
-        }
-    }
-    arma::Mat<double> WtransArma = graph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
+    arma::Mat<double> WtransArma = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
     
     arma::Mat<double> IdentityArma = arma::eye(graph->getNumNodes(),graph->getNumNodes());
     
@@ -101,13 +100,8 @@ Computation::Computation(std::string _thisType,const std::vector<double>& _input
     types = std::vector<std::string>();
 
 
-    std::vector<double> normalizationFactors(graph->getNumNodes(),0);
-    for (int i = 0; i < graph->getNumNodes(); i++) {
-        for(int j = 0; j < graph->getNumNodes();j++){
-            normalizationFactors[i] += std::abs(graph->getEdgeWeight(i,j)); 
-        }
-    }
-    arma::Mat<double> WtransArma = graph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
+    arma::Mat<double> WtransArma = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
     
     arma::Mat<double> IdentityArma = arma::eye(graph->getNumNodes(),graph->getNumNodes());
     InputArma = Matrix<double>(input).asArmadilloColumnVector();
@@ -125,6 +119,8 @@ Computation::Computation(std::string _thisType,const std::vector<double>& _input
 }
 
 void Computation::augmentGraph(const std::vector<std::string>& _types,const std::vector<std::pair<std::string, std::string>>& newEdgesList,const std::vector<double>& newEdgesValue, bool includeSelfVirtual){
+    normalizedAdjacencyValid = false; // the normalized adjacency matrix changes
+    conservationWeightsValid = false;
     if(augmentedGraph) {
         delete augmentedGraph;
     }
@@ -139,12 +135,16 @@ void Computation::augmentGraph(const std::vector<std::string>& _types,const std:
         }
         types = tmptypes;
         auto virtualNodes = tmptypes;
+        virtualNodeKeys.clear();
         for (int i = 0; i < SizeToInt( tmptypes.size()); i++) {
             std::string cellTyp = virtualNodes[i];
             virtualNodes[i] = "v-in:" + cellTyp;
             virtualNodes.push_back("v-out:" + cellTyp);
+            registerVirtualNode(virtualNodes[i], cellTyp);
+            registerVirtualNode(virtualNodes.back(), cellTyp);
         }
-        augmentedGraph = graph->addNodesAndCopyNew(virtualNodes);
+        // the augmented graph is an overlay of the core graph, so the types sharing the same core graph do not copy it
+        augmentedGraph = graph->addNodesAndOverlayNew(virtualNodes);
         for(uint it = 0; it < newEdgesList.size(); it++){
             std::string node1Name = newEdgesList[it].first; 
             std::string node2Name = newEdgesList[it].second;
@@ -152,14 +152,8 @@ void Computation::augmentGraph(const std::vector<std::string>& _types,const std:
 
             augmentedGraph->addEdge(node1Name,node2Name, edgeWeight);
         }
-        std::vector<double> normalizationFactors(augmentedGraph->getNumNodes(),0);
-        for (int i = 0; i < augmentedGraph->getNumNodes(); i++) {
-            for(int j = 0; j < augmentedGraph->getNumNodes();j++){
-                double betaToAdd = std::abs(augmentedGraph->getEdgeWeight(i,j));
-                normalizationFactors[i] += betaToAdd; 
-            }
-        }
-        arma::Mat<double> WtransAugmentedArma = augmentedGraph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+        std::vector<double> normalizationFactors = augmentedGraph->getAbsoluteOutWeights();
+        arma::Mat<double> WtransAugmentedArma = augmentedGraph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
         //TODO normalization by previous weight nodes for the matrix
         
         arma::Mat<double> IdentityAugmentedArma = arma::eye(augmentedGraph->getNumNodes(),augmentedGraph->getNumNodes());
@@ -169,12 +163,13 @@ void Computation::augmentGraph(const std::vector<std::string>& _types,const std:
         }
         InputAugmentedArma = arma::Col<double>(inputAugmented);
         Logger::getInstance().printLog("computing pseudoinverse for augmented graph cell : " + localType);
-        pseudoInverseAugmentedArma = arma::pinv(IdentityAugmentedArma - WtransAugmentedArma);
+        pseudoInverseAugmentedArma = pseudoinverseWithInvertibility(IdentityAugmentedArma - WtransAugmentedArma, invertibleAugmentedOperator);
         armaInitializedAugmented = true;
 
 
         //get nodeToIndex map as well
         nodeToIndex = augmentedGraph->getNodeToIndexMap();
+        updateNodeIndexes();
     } catch (...) {
         Logger::getInstance().printError("Computation::augmentGraph: catch section");
         return;
@@ -182,6 +177,8 @@ void Computation::augmentGraph(const std::vector<std::string>& _types,const std:
 }
 
 void Computation::augmentGraphNoComputeInverse(const std::vector<std::string>& _types,const std::vector<std::pair<std::string, std::string>>& newEdgesList,const std::vector<double>& newEdgesValue, bool includeSelfVirtual){
+    normalizedAdjacencyValid = false; // the normalized adjacency matrix changes
+    conservationWeightsValid = false;
     if(augmentedGraph) {
         delete augmentedGraph;
     }
@@ -196,12 +193,16 @@ void Computation::augmentGraphNoComputeInverse(const std::vector<std::string>& _
         }
         types = tmptypes;
         auto virtualNodes = tmptypes;
+        virtualNodeKeys.clear();
         for (int i = 0; i < SizeToInt( tmptypes.size()); i++) {
             std::string cellTyp = virtualNodes[i];
             virtualNodes[i] = "v-in:" + cellTyp;
             virtualNodes.push_back("v-out:" + cellTyp);
+            registerVirtualNode(virtualNodes[i], cellTyp);
+            registerVirtualNode(virtualNodes.back(), cellTyp);
         }
-        augmentedGraph = graph->addNodesAndCopyNew(virtualNodes);
+        // the augmented graph is an overlay of the core graph, so the types sharing the same core graph do not copy it
+        augmentedGraph = graph->addNodesAndOverlayNew(virtualNodes);
         for(uint it = 0; it < newEdgesList.size(); it++){
             std::string node1Name = newEdgesList[it].first; 
             std::string node2Name = newEdgesList[it].second;
@@ -209,16 +210,10 @@ void Computation::augmentGraphNoComputeInverse(const std::vector<std::string>& _
 
             augmentedGraph->addEdge(node1Name,node2Name, edgeWeight);
         }
-        std::vector<double> normalizationFactors(augmentedGraph->getNumNodes(),0);
-        for (int i = 0; i < augmentedGraph->getNumNodes(); i++) {
-            for(int j = 0; j < augmentedGraph->getNumNodes();j++){
-                double betaToAdd = std::abs(augmentedGraph->getEdgeWeight(i,j));
-                normalizationFactors[i] += betaToAdd; 
-            }
-        }
+        std::vector<double> normalizationFactors = augmentedGraph->getAbsoluteOutWeights();
 
         
-        arma::Mat<double> WtransAugmentedArma = augmentedGraph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+        arma::Mat<double> WtransAugmentedArma = augmentedGraph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
         //TODO normalization by previous weight nodes for the matrix
         
         arma::Mat<double> IdentityAugmentedArma = arma::eye(augmentedGraph->getNumNodes(),augmentedGraph->getNumNodes());
@@ -230,6 +225,7 @@ void Computation::augmentGraphNoComputeInverse(const std::vector<std::string>& _
         
         //get nodeToIndex map as well
         nodeToIndex = augmentedGraph->getNodeToIndexMap();
+        updateNodeIndexes();
     } catch (...) {
         Logger::getInstance().printError("Computation::augmentGraph: catch section");
         return;
@@ -237,6 +233,8 @@ void Computation::augmentGraphNoComputeInverse(const std::vector<std::string>& _
 }
 
 void Computation::addEdges(const std::vector<std::pair<std::string,std::string>>& newEdgesList, const std::vector<double>& newEdgesValues,bool bothDirections, bool inverseComputation){
+    normalizedAdjacencyValid = false; // the normalized adjacency matrix changes
+    conservationWeightsValid = false;
     //TODO control over the same length
     int itVal = 0;
     for(auto it = newEdgesList.cbegin(); it!=newEdgesList.cend();it++){
@@ -248,25 +246,21 @@ void Computation::addEdges(const std::vector<std::pair<std::string,std::string>>
         }
         augmentedGraph->addEdge(node1Name,node2Name, edgeWeight);
     }
-    std::vector<double> normalizationFactors(augmentedGraph->getNumNodes(),0);
-    for (int i = 0; i < augmentedGraph->getNumNodes(); i++) {
-        for(int j = 0; j < augmentedGraph->getNumNodes();j++){
-            double betaToAdd = std::abs(augmentedGraph->getEdgeWeight(i,j));
-            normalizationFactors[i] += betaToAdd; 
-        }
-    }
+    std::vector<double> normalizationFactors = augmentedGraph->getAbsoluteOutWeights();
     if(inverseComputation){
-        arma::Mat<double> WtransAugmentedArma = augmentedGraph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+        arma::Mat<double> WtransAugmentedArma = augmentedGraph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
         //TODO normalization by previous weight nodes for the matrix
         arma::Mat<double> IdentityAugmentedArma = arma::eye(augmentedGraph->getNumNodes(),augmentedGraph->getNumNodes());
         Logger::getInstance().printLog("computing pseudoinverse for augmented graph cell : " + localType);
-        pseudoInverseAugmentedArma = arma::pinv(IdentityAugmentedArma - WtransAugmentedArma);
+        pseudoInverseAugmentedArma = pseudoinverseWithInvertibility(IdentityAugmentedArma - WtransAugmentedArma, invertibleAugmentedOperator);
         armaInitializedAugmented = true;
     }
     
 }
 
 void Computation::addEdges(const std::vector<std::tuple<std::string,std::string,double>>& newEdgesList,bool bothDirections, bool inverseComputation){
+    normalizedAdjacencyValid = false; // the normalized adjacency matrix changes
+    conservationWeightsValid = false;
     //TODO control over the same length
     for(auto it = newEdgesList.cbegin(); it!=newEdgesList.cend();it++){
         std::string node1Name = std::get<0>(*it); 
@@ -277,46 +271,51 @@ void Computation::addEdges(const std::vector<std::tuple<std::string,std::string,
         }
         augmentedGraph->addEdge(node1Name,node2Name, edgeWeight);
     }
-    std::vector<double> normalizationFactors(augmentedGraph->getNumNodes(),0);
-    for (int i = 0; i < augmentedGraph->getNumNodes(); i++) {
-        for(int j = 0; j < augmentedGraph->getNumNodes();j++){
-            double betaToAdd = std::abs(augmentedGraph->getEdgeWeight(i,j));
-            normalizationFactors[i] += betaToAdd; 
-        }
-    }
+    std::vector<double> normalizationFactors = augmentedGraph->getAbsoluteOutWeights();
     if(inverseComputation){
-        arma::Mat<double> WtransAugmentedArma = augmentedGraph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+        arma::Mat<double> WtransAugmentedArma = augmentedGraph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
         //TODO normalization by previous weight nodes for the matrix
         arma::Mat<double> IdentityAugmentedArma = arma::eye(augmentedGraph->getNumNodes(),augmentedGraph->getNumNodes());
         Logger::getInstance().printLog("computing pseudoinverse for augmented graph cell : " + localType);
-        pseudoInverseAugmentedArma = arma::pinv(IdentityAugmentedArma - WtransAugmentedArma);
+        pseudoInverseAugmentedArma = pseudoinverseWithInvertibility(IdentityAugmentedArma - WtransAugmentedArma, invertibleAugmentedOperator);
         armaInitializedAugmented = true;
     }
 }
 
 
-void Computation::addEdgesAndNodes(const std::vector<std::tuple<std::string,std::string,double>>& newEdgesList,bool bothDirections, bool inverseComputation){
+void Computation::addEdgesAndNodes(const std::vector<std::tuple<std::string,std::string,double>>& newEdgesList,bool bothDirections, bool inverseComputation, const std::vector<std::string>& virtualNodeTypes){
     // get the nodes that are not in the graph yet and add them
+    // the set keeps the check of the already collected nodes constant time, the vector keeps the order of the edges
     std::vector<std::string> nodesToAdd;
+    std::unordered_set<std::string> nodesToAddSet;
     for(auto it = newEdgesList.cbegin(); it != newEdgesList.cend(); it++){
-        std::string node1Name = std::get<0>(*it); 
-        std::string node2Name = std::get<1>(*it);        
+        const std::string& node1Name = std::get<0>(*it); 
+        const std::string& node2Name = std::get<1>(*it);        
 
-        if(!augmentedGraph->containsNode(node1Name) && !vectorContains(nodesToAdd,node1Name)){
+        if(!augmentedGraph->containsNode(node1Name) && nodesToAddSet.insert(node1Name).second){
             nodesToAdd.push_back(node1Name);
         }
-        if(!augmentedGraph->containsNode(node2Name) && !vectorContains(nodesToAdd,node2Name)){
+        if(!augmentedGraph->containsNode(node2Name) && nodesToAddSet.insert(node2Name).second){
             nodesToAdd.push_back(node2Name);
         }
     }
+    // the type and the node of the new virtual nodes are recorded before the graph changes, so an invalid name leaves the graph untouched
+    std::vector<std::string> knownTypes = virtualNodeTypes;
+    knownTypes.insert(knownTypes.end(), types.begin(), types.end());
+    knownTypes.push_back(localType);
+    for(const auto& nodeName : nodesToAdd){
+        if(nodeName.starts_with("v-in:") || nodeName.starts_with("v-out:")){
+            registerVirtualNode(nodeName, knownTypes);
+        }
+    }
+    // the nodes are added in one batch, so the graph arrays are resized once
     augmentedGraph->addNodes(nodesToAdd);
 
     //get nodeToIndex map as well
     nodeToIndex = augmentedGraph->getNodeToIndexMap();
+    updateNodeIndexes();
     // update inputAugmented and InputAugmentedArma
-    for(uint i = 0; i < nodesToAdd.size(); i++){
-        inputAugmented.push_back(0.0);
-    }
+    inputAugmented.resize(inputAugmented.size() + nodesToAdd.size(), 0.0);
     InputAugmentedArma = arma::Col<double>(inputAugmented);
     // add the edges
     this->addEdges(newEdgesList,bothDirections,inverseComputation);
@@ -324,6 +323,112 @@ void Computation::addEdgesAndNodes(const std::vector<std::tuple<std::string,std:
 }
 
 
+void Computation::updateEdgeWeights(const std::vector<std::tuple<std::string,std::string,double>>& newEdgeWeights, bool bothDirections){
+    normalizedAdjacencyValid = false; // the normalized adjacency matrix changes
+    conservationWeightsValid = false;
+    if(augmentedGraph == nullptr){
+        throw std::invalid_argument("[ERROR] Computation::updateEdgeWeights: augmentedGraph is not set. abort");
+    }
+    std::vector<std::tuple<int,int,double>> previousEdgeWeights = augmentedGraph->updateEdgeWeights(newEdgeWeights, !bothDirections);
+    if(propagationModel){
+        propagationModel->updateEdgeWeights(augmentedGraph, previousEdgeWeights);
+    }
+    if(armaInitializedAugmented){
+        std::map<int, std::pair<arma::Col<double>, arma::Col<double>>> changedColumns = changedNormalizedColumns(*augmentedGraph, previousEdgeWeights);
+        if(changedColumns.empty()){
+            return;
+        }
+        // the rank-1 updates are exact only when the pseudoinverse is the inverse, for a singular operator it is computed again
+        bool updated = invertibleAugmentedOperator;
+        if(updated){
+            for(const auto& [node, columns] : changedColumns){
+                if(!shermanMorrisonColumnUpdate(pseudoInverseAugmentedArma, columns.first - columns.second, node)){
+                    updated = false;
+                    break;
+                }
+            }
+        }
+        if(!updated){
+            std::vector<double> normalizationFactors = augmentedGraph->getAbsoluteOutWeights();
+            arma::Mat<double> WtransAugmentedArma = augmentedGraph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+            arma::Mat<double> IdentityAugmentedArma = arma::eye(augmentedGraph->getNumNodes(),augmentedGraph->getNumNodes());
+            pseudoInverseAugmentedArma = pseudoinverseWithInvertibility(IdentityAugmentedArma - WtransAugmentedArma, invertibleAugmentedOperator);
+        }
+    }
+}
+
+void Computation::scheduleEdgeWeightUpdates(double time, const std::vector<std::tuple<std::string,std::string,double>>& newEdgeWeights){
+    std::vector<std::tuple<std::string,std::string,double>>& scheduledUpdates = edgeWeightUpdatesSchedule[time];
+    scheduledUpdates.insert(scheduledUpdates.end(), newEdgeWeights.cbegin(), newEdgeWeights.cend());
+}
+
+bool Computation::applyScheduledEdgeWeightUpdates(double time){
+    if(edgeWeightUpdatesSchedule.empty() || edgeWeightUpdatesSchedule.cbegin()->first > time){
+        return false;
+    }
+    // all the updates up to the current time are merged, so that the operators are updated once
+    std::vector<std::tuple<std::string,std::string,double>> dueUpdates;
+    auto firstNotDue = edgeWeightUpdatesSchedule.upper_bound(time);
+    for(auto it = edgeWeightUpdatesSchedule.begin(); it != firstNotDue; it++){
+        dueUpdates.insert(dueUpdates.end(), it->second.cbegin(), it->second.cend());
+    }
+    edgeWeightUpdatesSchedule.erase(edgeWeightUpdatesSchedule.begin(), firstNotDue);
+    updateEdgeWeights(dueUpdates);
+    return true;
+}
+
+void Computation::precomputeScaleSchedules(const std::vector<double>& times, ScaleSchedulePool* pool){
+    if (dissipationModel == nullptr || conservationModel == nullptr || propagationModel == nullptr) {
+        throw std::invalid_argument("[ERROR] Computation::precomputeScaleSchedules: the models are not set. abort");
+    }
+    if(augmentedGraph == nullptr){
+        throw std::invalid_argument("[ERROR] Computation::precomputeScaleSchedules: augmentedGraph is not set. abort");
+    }
+    arma::uword numElements = augmentedGraph->getNumNodes();
+    // the models with a constant scale are specialized in the step and never evaluate their scale function
+    if(!dissipationModel->getProperties().constantScale){
+        dissipationModel->precomputeScaleSchedule(times, numElements, pool);
+    }
+    if(!conservationModel->getProperties().constantScale){
+        conservationModel->precomputeScaleSchedule(times, numElements, pool);
+    }
+    propagationModel->precomputeScaleSchedule(times, numElements, pool);
+}
+
+std::optional<uint64_t> Computation::scalePrefixHash(double time) const{
+    uint64_t hash = 0;
+    for(const ScaleSchedule* schedule : {dissipationModel ? dissipationModel->getScaleSchedule().get() : nullptr,
+                                         conservationModel ? conservationModel->getScaleSchedule().get() : nullptr,
+                                         propagationModel ? propagationModel->getScaleSchedule().get() : nullptr}){
+        // the models without a schedule contribute the same value
+        uint64_t modelHash = 0;
+        if(schedule != nullptr){
+            std::optional<uint64_t> schedulePrefixHash = schedule->prefixHash(time);
+            if(!schedulePrefixHash){
+                return std::nullopt;
+            }
+            modelHash = *schedulePrefixHash;
+        }
+        hash = hashCombine(hash, modelHash);
+    }
+    return hash;
+}
+
+std::vector<double> Computation::scaleChangeTimes() const{
+    std::vector<double> changes;
+    for(const ScaleSchedule* schedule : {dissipationModel ? dissipationModel->getScaleSchedule().get() : nullptr,
+                                         conservationModel ? conservationModel->getScaleSchedule().get() : nullptr,
+                                         propagationModel ? propagationModel->getScaleSchedule().get() : nullptr}){
+        if(schedule != nullptr){
+            std::vector<double> scheduleChanges = schedule->changeTimes();
+            changes.insert(changes.end(), scheduleChanges.begin(), scheduleChanges.end());
+        }
+    }
+    std::sort(changes.begin(), changes.end());
+    changes.erase(std::unique(changes.begin(), changes.end()), changes.end());
+    return changes;
+}
+
 std::vector<double> Computation::computePerturbation(){
     arma::Col<double> outputArma =  pseudoInverseArma * InputArma;
     output = armaColumnToVector(outputArma);
@@ -398,7 +503,7 @@ std::vector<double> Computation::computeAugmentedPerturbationEnhanced2(double ti
         if(augmentedGraph == nullptr){
             throw std::invalid_argument("[ERROR] Computation::computeAugmentedPerturbationEnhanced2: augmentedGraph is not set. abort");
         }
-        arma::Col<double> outputArma =  pseudoInverseAugmentedArma * dissipatedPerturbationArma - conservationModel->conservationTerm(dissipatedPerturbationArma, normalize1Rows(augmentedGraph->adjMatrix.asArmadilloMatrix()) , timeStep, qVectorVar);
+        arma::Col<double> outputArma =  pseudoInverseAugmentedArma * dissipatedPerturbationArma - conservationModel->conservationTerm(dissipatedPerturbationArma, augmentedNormalizedAdjacency(), timeStep, qVectorVar);
         //saturation
         for(uint i = 0;i<outputArma.n_elem;i++){
             double saturatedValue = hyperbolicTangentScaled(outputArma[i], saturationVectorVar[i]);
@@ -413,7 +518,7 @@ std::vector<double> Computation::computeAugmentedPerturbationEnhanced2(double ti
         if(augmentedGraph == nullptr){
             throw std::invalid_argument("[ERROR] Computation::computeAugmentedPerturbationEnhanced2: augmentedGraph is not set. abort");
         }
-        arma::Col<double> conservationVector = conservationModel->conservationTerm(dissipatedPerturbationArma, normalize1Rows(augmentedGraph->adjMatrix.asArmadilloMatrix()), timeStep, qVector);
+        arma::Col<double> conservationVector = conservationModel->conservationTerm(dissipatedPerturbationArma, augmentedNormalizedAdjacency(), timeStep, qVector);
         arma::Col<double> outputArma =  pseudoInverseAugmentedArma * dissipatedPerturbationArma - conservationVector;
         outputAugmented = armaColumnToVector(outputArma);
         return outputAugmented;
@@ -436,7 +541,7 @@ std::vector<double> Computation::computeAugmentedPerturbationEnhanced3(double ti
         if(augmentedGraph == nullptr){
             throw std::invalid_argument("[ERROR] Computation::computeAugmentedPerturbationEnhanced3: augmentedGraph is not set. abort");
         }
-        arma::Col<double> outputArma = pseudoInverseAugmentedArma * dissipatedPerturbationArma * propagationScaleFunction(timeStep) - conservationModel->conservationTerm(dissipatedPerturbationArma, normalize1Rows(augmentedGraph->adjMatrix.asArmadilloMatrix()) , timeStep, qVectorVar);
+        arma::Col<double> outputArma = pseudoInverseAugmentedArma * dissipatedPerturbationArma * propagationScaleFunction(timeStep) - conservationModel->conservationTerm(dissipatedPerturbationArma, augmentedNormalizedAdjacency(), timeStep, qVectorVar);
         //saturation
         for(uint i = 0;i<outputArma.n_elem;i++){
             double saturatedValue = hyperbolicTangentScaled(outputArma[i], saturationVectorVar[i]);
@@ -451,7 +556,7 @@ std::vector<double> Computation::computeAugmentedPerturbationEnhanced3(double ti
         if(augmentedGraph == nullptr){
             throw std::invalid_argument("[ERROR] Computation::computeAugmentedPerturbationEnhanced3: augmentedGraph is not set. abort");
         }
-        arma::Col<double> conservationVector = conservationModel->conservationTerm(dissipatedPerturbationArma, normalize1Rows(augmentedGraph->adjMatrix.asArmadilloMatrix()), timeStep, qVector);
+        arma::Col<double> conservationVector = conservationModel->conservationTerm(dissipatedPerturbationArma, augmentedNormalizedAdjacency(), timeStep, qVector);
         arma::Col<double> outputArma = pseudoInverseAugmentedArma * dissipatedPerturbationArma * propagationScaleFunction(timeStep) - conservationVector;
         outputAugmented = armaColumnToVector(outputArma);
         return outputAugmented;
@@ -470,115 +575,333 @@ std::vector<double> Computation::computeAugmentedPerturbationEnhanced4(double ti
     if (propagationModel == nullptr) {
         throw std::invalid_argument("[ERROR] Computation::computeAugmentedPerturbationEnhanced4: propagationModel is not set. abort");
     }
+    if(augmentedGraph == nullptr){
+        throw std::invalid_argument("[ERROR] Computation::computeAugmentedPerturbationEnhanced4: augmentedGraph is not set. abort");
+    }
+    applyScheduledEdgeWeightUpdates(timeStep);
+    std::vector<double> saturationVectorVar;
     if (saturation) {
-        std::vector<double> saturationVectorVar = saturationsVector;
-        std::vector<double> qVectorVar = qVector;
+        saturationVectorVar = saturationsVector;
         if(saturationVectorVar.size() == 0){
             saturationVectorVar = std::vector<double>(InputAugmentedArma.n_elem,1);
         }
         if(saturationVectorVar.size() != InputAugmentedArma.n_elem ){
             throw std::invalid_argument("[ERROR] Computation::computeAugmentedPerturbationEnhanced4: saturationVector is not of the same size as output vector: " + std::to_string(saturationVectorVar.size()) + "!=" + std::to_string(InputAugmentedArma.n_elem) +  ". abort");
         }
-        //dissipation
-        arma::Col<double> dissipatedPerturbationArma;
+    }
+    const ModelProperties dissipationProperties = dissipationModel->getProperties();
+    const ModelProperties conservationProperties = conservationModel->getProperties();
+    selectStepKernel(dissipationProperties, conservationProperties);
+    StepOperands operands;
+    operands.input = &InputAugmentedArma;
+    operands.time = timeStep;
+    operands.dissipationModel = dissipationModel;
+    operands.propagationModel = propagationModel;
+    operands.conservationModel = conservationModel;
+    operands.dissipationScale = dissipationProperties.constantValue;
+    operands.conservationScale = conservationProperties.constantValue;
+    operands.q = &qVector;
+    operands.saturationVector = saturation ? &saturationVectorVar : nullptr;
+    operands.saturationFunction = &batchSaturationFunction;
+    if(stepKernel->needsConservationWeights()){
+        operands.conservationWeights = &augmentedConservationWeights(qVector);
+    }
+    if(stepKernel->needsNormalizedAdjacency()){
+        operands.Wstar = &augmentedNormalizedAdjacency();
+    }
+    arma::Col<double> outputArma;
+    try
+    {
+        outputArma = stepKernel->step(operands);
+    }
+    catch(const std::exception& e)
+    {
+        Logger::getInstance().printError(e.what());
+        throw std::invalid_argument("[ERROR] Computation::computeAugmentedPerturbationEnhanced4: error during the computation of the step");
+    }
+    outputAugmented = armaColumnToVector(outputArma);
+    if(!sensitivityParameters.empty()){
         try
         {
-            dissipatedPerturbationArma = dissipationModel->dissipate(InputAugmentedArma, timeStep);
-            //conservation
-            if(augmentedGraph == nullptr){
-                throw std::invalid_argument("[ERROR] Computation::computeAugmentedPerturbationEnhanced4: augmentedGraph is not set. abort");
-            }
+            outputSensitivities = propagateSensitivities(timeStep, saturation ? &saturationVectorVar : nullptr, qVector);
         }
         catch(const std::exception& e)
         {
             Logger::getInstance().printError(e.what());
-            throw std::invalid_argument("[ERROR] Computation::computeAugmentedPerturbationEnhanced4: error during the computation of dissipation");
+            throw std::invalid_argument("[ERROR] Computation::computeAugmentedPerturbationEnhanced4: error during the propagation of the sensitivities");
         }
-        arma::Col<double> outputArma = propagationModel->propagate(dissipatedPerturbationArma,timeStep) - conservationModel->conservationTerm(dissipatedPerturbationArma, normalize1Rows(augmentedGraph->adjMatrix.asArmadilloMatrix()) , timeStep, qVectorVar);
-        //saturation
-        outputAugmented = armaColumnToVector(outputArma);
-        for(uint i = 0;i<outputAugmented.size();i++){
-            // TODO change to be more general, doesn't make sense to have the hyperbolic tangent if the condition is controlled (already a control of saturation)
-            if(std::abs(outputAugmented[i]) > saturationVectorVar[i]){
-                //double saturatedValue = hyperbolicTangentScaled(outputAugmented[i], saturationVectorVar[i]); //problems when the ouput value is big enough, gives nan
-                double saturatedValue = saturationFunction(outputAugmented[i], saturationVectorVar[i]);
-                outputAugmented[i] = saturatedValue;
-            }
+    }
+    return outputAugmented;
+}
+
+arma::Mat<double> Computation::propagateSensitivities(double timeStep, const std::vector<double>* saturationVector, const std::vector<double>& qVector){
+    const arma::Col<double>& inputArma = InputAugmentedArma;
+    // adds the derivative of a term with respect to the scaling values of the nodes, only for the parameters of the target model
+    auto addScaleSensitivities = [this, timeStep](arma::Mat<double>& sensitivities, SensitivityTarget target, const std::function<arma::Col<double>()>& scaleDerivative, double sign){
+        const std::vector<arma::uword>& parameterIndexes = sensitivityParametersPerTarget[static_cast<size_t>(target)];
+        if(parameterIndexes.empty()){
+            return;
         }
-        return outputAugmented;
-    } else {
-        //dissipation
-        arma::Col<double> dissipatedPerturbationArma = dissipationModel->dissipate(InputAugmentedArma, timeStep);
-        //conservation
-        if(augmentedGraph == nullptr){
-            throw std::invalid_argument("[ERROR] Computation::computeAugmentedPerturbationEnhanced4: augmentedGraph is not set. abort");
+        arma::Col<double> derivatives = scaleDerivative();
+        for(arma::uword parameterIndex : parameterIndexes){
+            const SensitivityParameter& parameter = sensitivityParameters[parameterIndex];
+            sensitivities(parameter.node, parameterIndex) += sign * derivatives(parameter.node) * parameter.scaleDerivative(timeStep);
         }
-        arma::Col<double> conservationVector = conservationModel->conservationTerm(dissipatedPerturbationArma, normalize1Rows(augmentedGraph->adjMatrix.asArmadilloMatrix()), timeStep, qVector);
-        arma::Col<double> outputArma = propagationModel->propagate(dissipatedPerturbationArma,timeStep) - conservationVector;
-        outputAugmented = armaColumnToVector(outputArma);
-        return outputAugmented;
+    };
+    // dissipation
+    arma::Col<double> dissipated = dissipationModel->dissipate(inputArma, timeStep);
+    arma::Mat<double> dissipatedSensitivities = dissipationModel->dissipateTangent(inputSensitivities, inputArma, timeStep);
+    addScaleSensitivities(dissipatedSensitivities, SensitivityTarget::dissipation, [&](){return dissipationModel->dissipateScaleDerivative(inputArma, timeStep);}, 1);
+    // propagation
+    arma::Mat<double> sensitivities = propagationModel->propagateTangent(dissipatedSensitivities, timeStep);
+    addScaleSensitivities(sensitivities, SensitivityTarget::propagation, [&](){return propagationModel->propagateScaleDerivative(dissipated, timeStep);}, 1);
+    // conservation, the normalized adjacency matrix is needed only if the conservation term is not identically zero
+    bool conservation = !conservationModel->getProperties().zero || !sensitivityParametersPerTarget[static_cast<size_t>(SensitivityTarget::conservation)].empty();
+    if(conservation){
+        const arma::Mat<double>& Wstar = augmentedNormalizedAdjacency();
+        sensitivities -= conservationModel->conservationTermTangent(dissipatedSensitivities, Wstar, timeStep, qVector);
+        addScaleSensitivities(sensitivities, SensitivityTarget::conservation, [&](){return conservationModel->conservationTermScaleDerivative(dissipated, Wstar, timeStep, qVector);}, -1);
     }
+    // saturation, differentiated with central differences of the batch saturation function on the values before the saturation
+    if(saturationVector != nullptr){
+        arma::Col<double> unsaturated = propagationModel->propagate(dissipated, timeStep);
+        if(conservation){
+            unsaturated -= conservationModel->conservationTerm(dissipated, augmentedNormalizedAdjacency(), timeStep, qVector);
+        }
+        arma::Col<double> increments = 1e-7 * arma::max(arma::abs(unsaturated), arma::ones<arma::Col<double>>(unsaturated.n_elem));
+        arma::Col<double> upper = unsaturated + increments;
+        arma::Col<double> lower = unsaturated - increments;
+        batchSaturationFunction(upper.memptr(), saturationVector->data(), upper.n_elem);
+        batchSaturationFunction(lower.memptr(), saturationVector->data(), lower.n_elem);
+        sensitivities.each_col() %= (upper - lower) / (2 * increments);
+    }
+    return sensitivities;
+}
+
+void Computation::setSensitivityParameters(const std::vector<SensitivityParameter>& parameters){
+    if(!parameters.empty() && augmentedGraph == nullptr){
+        throw std::invalid_argument("[ERROR] Computation::setSensitivityParameters: augmentedGraph is not set. abort");
+    }
+    std::vector<std::vector<arma::uword>> parametersPerTarget(3);
+    for(arma::uword i = 0; i < parameters.size(); i++){
+        if(parameters[i].node >= InputAugmentedArma.n_elem){
+            throw std::invalid_argument("[ERROR] Computation::setSensitivityParameters: the node " + std::to_string(parameters[i].node) + " of the parameter " + parameters[i].name + " is not in the augmented graph. abort");
+        }
+        if(!parameters[i].scaleDerivative){
+            throw std::invalid_argument("[ERROR] Computation::setSensitivityParameters: the parameter " + parameters[i].name + " has no derivative of the scaling value. abort");
+        }
+        parametersPerTarget[static_cast<size_t>(parameters[i].target)].push_back(i);
+    }
+    sensitivityParameters = parameters;
+    sensitivityParametersPerTarget = parametersPerTarget;
+    resetSensitivities();
+}
+
+void Computation::resetSensitivities(){
+    inputSensitivities.zeros(InputAugmentedArma.n_elem, sensitivityParameters.size());
+    outputSensitivities.zeros(InputAugmentedArma.n_elem, sensitivityParameters.size());
+}
+
+void Computation::selectStepKernel(const ModelProperties& dissipationProperties, const ModelProperties& conservationProperties){
+    // the kernel is selected again only if the properties used for the selection changed since the models were set
+    if(stepKernel &&
+       stepKernelDissipationProperties.identity == dissipationProperties.identity &&
+       stepKernelDissipationProperties.constantScale == dissipationProperties.constantScale &&
+       stepKernelConservationProperties.zero == conservationProperties.zero &&
+       stepKernelConservationProperties.constantScale == conservationProperties.constantScale){
+        return;
+    }
+    stepKernel = makeStepKernel(dissipationModel, propagationModel, conservationModel, defaultSaturationFunction);
+    stepKernelDissipationProperties = dissipationProperties;
+    stepKernelConservationProperties = conservationProperties;
+}
+
+std::string Computation::getStepKernelDescription(){
+    if (dissipationModel == nullptr || conservationModel == nullptr || propagationModel == nullptr) {
+        throw std::invalid_argument("[ERROR] Computation::getStepKernelDescription: the models are not set. abort");
+    }
+    selectStepKernel(dissipationModel->getProperties(), conservationModel->getProperties());
+    return stepKernel->description();
+}
+
+const arma::Mat<double>& Computation::augmentedNormalizedAdjacency(){
+    if(augmentedGraph == nullptr){
+        throw std::invalid_argument("[ERROR] Computation::augmentedNormalizedAdjacency: augmented graph not set. abort");
+    }
+    // Wstar only changes with the augmented graph, so it is normalized once instead of at every step
+    arma::uword numNodes = static_cast<arma::uword>(augmentedGraph->getNumNodes());
+    if(!normalizedAdjacencyValid || normalizedAdjacency.n_rows != numNodes){
+        normalizedAdjacency = normalize1Rows(augmentedGraph->getAdjacencyMatrix().asArmadilloMatrix());
+        normalizedAdjacencyValid = true;
+    }
+    return normalizedAdjacency;
+}
+
+const arma::Col<double>& Computation::augmentedConservationWeights(const std::vector<double>& qVector){
+    arma::uword numElements = InputAugmentedArma.n_elem;
+    if(qVector.size() && qVector.size() != numElements){
+        throw std::invalid_argument("[ERROR] Computation::augmentedConservationWeights: q is not of the same size as input vector. abort");
+    }
+    // Wstar * q only changes with the graph or q, so it is computed once
+    if(!conservationWeightsValid || conservationWeightsQ != qVector || conservationWeights.n_elem != numElements){
+        arma::Col<double> qArma = qVector.size() ? vectorToArmaColumn(qVector) : arma::ones<arma::Col<double>>(numElements);
+        conservationWeights = augmentedNormalizedAdjacency() * qArma;
+        conservationWeightsQ = qVector;
+        conservationWeightsValid = true;
+    }
+    return conservationWeights;
 }
 
         
 
-double Computation::getVirtualInputForType(std::string type, std::string sourceNode)const{
-    if(sourceNode != ""){
-        type = type + "_" + sourceNode;
+void Computation::registerVirtualNode(const std::string& virtualNodeName, const std::string& type, const std::string& node){
+    NameInterner& interner = NameInterner::getInstance();
+    NameId nodeId = node.empty() ? NameInterner::invalidId : interner.intern(node);
+    virtualNodeKeys.insert_or_assign(interner.intern(virtualNodeName), NameInterner::pairKey(interner.intern(type), nodeId));
+}
+
+void Computation::registerVirtualNode(const std::string& virtualNodeName, const std::vector<std::string>& knownTypes){
+    std::string_view typeAndNode(virtualNodeName);
+    typeAndNode.remove_prefix(virtualNodeName.starts_with("v-in:") ? 5 : 6);
+    // the virtual node of a whole type is preferred, then the single type that is followed by "_" and a node name
+    for(const auto& type : knownTypes){
+        if(typeAndNode == type){
+            registerVirtualNode(virtualNodeName, type);
+            return;
+        }
     }
-    int index = nodeToIndex.at("v-in:" + type);
-    if(index > 0) return outputAugmented[index];
-    else return 0;
+    const std::string* matchedType = nullptr;
+    for(const auto& type : knownTypes){
+        if(typeAndNode.size() > type.size() + 1 && typeAndNode.starts_with(type) && typeAndNode[type.size()] == '_' && (matchedType == nullptr || *matchedType != type)){
+            if(matchedType != nullptr){
+                throw std::invalid_argument("[ERROR] Computation::registerVirtualNode: the virtual node " + virtualNodeName + " matches both the types " + *matchedType + " and " + type + ". abort");
+            }
+            matchedType = &type;
+        }
+    }
+    if(matchedType == nullptr){
+        throw std::invalid_argument("[ERROR] Computation::registerVirtualNode: the virtual node " + virtualNodeName + " does not refer to a known type of the computation of type " + localType + ". abort");
+    }
+    registerVirtualNode(virtualNodeName, *matchedType, std::string(typeAndNode.substr(matchedType->size() + 1)));
+}
 
+void Computation::updateNodeIndexes(){
+    NameInterner& interner = NameInterner::getInstance();
+    nameIdToIndex.clear();
+    virtualInputIndexes.clear();
+    virtualOutputIndexes.clear();
+    virtualOutputNodeIndexes.clear();
+    nameIdToIndex.reserve(nodeToIndex.size());
+    for(const auto& [name, index] : nodeToIndex){
+        NameId nameId = interner.intern(name);
+        nameIdToIndex.insert_or_assign(nameId, index);
+        // the (type, node) pair was recorded when the virtual node was added, the name is never split
+        const uint64_t* virtualNodeKey = virtualNodeKeys.find(nameId);
+        if(virtualNodeKey != nullptr){
+            if(name.starts_with("v-in:")){
+                virtualInputIndexes.insert_or_assign(*virtualNodeKey, index);
+            } else {
+                virtualOutputIndexes.insert_or_assign(*virtualNodeKey, index);
+                virtualOutputNodeIndexes.push_back(index);
+            }
+        }
+    }
 }
-double Computation::getVirtualOutputForType(std::string type, std::string targetNode)const{
-    if(targetNode != ""){
-        type = type + "_" + targetNode;
+
+int Computation::virtualNodeIndex(const FlatHashMap<uint64_t, int>& virtualIndexes, NameId type, NameId node)const{
+    const int* index = virtualIndexes.find(NameInterner::pairKey(type, node));
+    if(index == nullptr){
+        throw std::out_of_range("[ERROR] Computation::virtualNodeIndex: the virtual node is not in the augmented graph of type " + localType);
     }
-    int index = nodeToIndex.at("v-out:" + type);
+    return *index;
+}
+
+double Computation::getVirtualInputForType(NameId type, NameId sourceNode)const{
+    int index = virtualNodeIndex(virtualInputIndexes, type, sourceNode);
     if(index > 0) return outputAugmented[index];
     else return 0;
 }
 
-void Computation::setInputVinForType(std::string type, double value, std::string sourceNode){
-    //TODO if the augmented graph is deleted, switch to a direct map saved before deleting the graph
-    //int index = augmentedGraph->getIndexFromName("v-in:" + type);
-    std::string vinName = "v-in:" + type;
-    if(sourceNode != ""){
-        vinName = vinName + "_" + sourceNode;
-    }
-    int index = nodeToIndex.at("v-in:" + type);
+double Computation::getVirtualOutputForType(NameId type, NameId targetNode)const{
+    int index = virtualNodeIndex(virtualOutputIndexes, type, targetNode);
+    if(index > 0) return outputAugmented[index];
+    else return 0;
+}
+
+void Computation::setInputVinForType(NameId type, double value, NameId sourceNode){
+    int index = virtualNodeIndex(virtualInputIndexes, type, sourceNode);
     if(index > 0) {
         inputAugmented[index]=value;
         InputAugmentedArma[index]=value;
+        if(!sensitivityParameters.empty()){
+            inputSensitivities.row(index).zeros();
+        }
     }
-    else throw std::invalid_argument("Computation::setInputVinForType: invalid set for virtual input: type:" + type + "does not exist");
-
+    else throw std::invalid_argument("Computation::setInputVinForType: invalid set for virtual input: type:" + NameInterner::getInstance().getName(type) + "does not exist");
 }
-void Computation::setInputVoutForType(std::string type, double value, std::string targetNode){
-    //int index = augmentedGraph->getIndexFromName("v-out:" + type);
-    std::string voutName = "v-out:" + type;
-    if(targetNode != ""){
-        voutName = voutName + "_" + targetNode;
-    }
-    int index = nodeToIndex.at(voutName);
+
+void Computation::setInputVoutForType(NameId type, double value, NameId targetNode){
+    int index = virtualNodeIndex(virtualOutputIndexes, type, targetNode);
     if(index > 0) {
         inputAugmented[index]=value;
         InputAugmentedArma[index]=value;
+        if(!sensitivityParameters.empty()){
+            inputSensitivities.row(index).zeros();
+        }
+    }
+    else throw std::invalid_argument("Computation::setInputVinForType: invalid set for virtual input: type:" + NameInterner::getInstance().getName(type) + "does not exist");
+}
+
+namespace {
+    /**
+     * @brief Resolve a name used by the string overloads of the virtual nodes accessors to its id.
+     * @param name The name of the type or of the node, empty only for the node of the virtual node of a whole type.
+     * @param caller The name of the calling method, used in the error message.
+     * @return The id of the name, NameInterner::invalidId if the name is empty.
+     * @throw std::out_of_range if the name is not empty and was never interned, so it is not in any graph.
+     */
+    NameId virtualNodeNameId(const std::string& name, const std::string& caller){
+        if(name.empty()){
+            return NameInterner::invalidId;
+        }
+        NameId id = NameInterner::getInstance().find(name);
+        if(id == NameInterner::invalidId){
+            // falling back to the virtual node of the whole type would silently use the wrong node
+            throw std::out_of_range("[ERROR] Computation::" + caller + ": " + name + " is not the name of a type or of a node of any graph");
+        }
+        return id;
     }
-    else throw std::invalid_argument("Computation::setInputVinForType: invalid set for virtual input: type:" + type + "does not exist");
+}
+
+double Computation::getVirtualInputForType(std::string type, std::string sourceNode)const{
+    return getVirtualInputForType(virtualNodeNameId(type, "getVirtualInputForType"), virtualNodeNameId(sourceNode, "getVirtualInputForType"));
+}
+
+double Computation::getVirtualOutputForType(std::string type, std::string targetNode)const{
+    return getVirtualOutputForType(virtualNodeNameId(type, "getVirtualOutputForType"), virtualNodeNameId(targetNode, "getVirtualOutputForType"));
+}
+
+void Computation::setInputVinForType(std::string type, double value, std::string sourceNode){
+    setInputVinForType(virtualNodeNameId(type, "setInputVinForType"), value, virtualNodeNameId(sourceNode, "setInputVinForType"));
+}
+
+void Computation::setInputVoutForType(std::string type, double value, std::string targetNode){
+    setInputVoutForType(virtualNodeNameId(type, "setInputVoutForType"), value, virtualNodeNameId(targetNode, "setInputVoutForType"));
 }
 
 void Computation::setDissipationModel(DissipationModel *dissipationModel){
     this->dissipationModel = dissipationModel;
+    this->stepKernel.reset();
 }
 
 void Computation::setConservationModel(ConservationModel *conservationModel){
     this->conservationModel = conservationModel;
+    this->stepKernel.reset();
 }
 
 void Computation::setPropagationModel(PropagationModel *propagationModel){
     this->propagationModel = propagationModel;
+    this->stepKernel.reset();
 }
 
 
@@ -590,12 +913,13 @@ void Computation::setInputAugmented(const std::vector<double>& newInputAugmented
 }
 
 void Computation::resetVirtualOutputs(){
-    //virtual outputs have the names starting with v-out:
-    for(auto it = nodeToIndex.cbegin(); it!=nodeToIndex.cend();it++){
-        if(it->first.find("v-out:") != std::string::npos){
-            InputAugmentedArma[it->second] = 0;
+    //virtual outputs have the names starting with v-out:, their indexes are collected when the graph is augmented
+    for(int index : virtualOutputNodeIndexes){
+        InputAugmentedArma[index] = 0;
+        if(!sensitivityParameters.empty()){
+            inputSensitivities.row(index).zeros();
         }
-    } 
+    }
 
 }
 
@@ -615,11 +939,19 @@ void Computation::updateInput(const std::vector<double>& newInp, bool augmented)
         if (newInp.size() == 0) {
             InputAugmentedArma = arma::Col<double>(outputAugmented);
             inputAugmented = outputAugmented;    
+            // the output becomes the input, and so do its sensitivities
+            if(!sensitivityParameters.empty()){
+                inputSensitivities = outputSensitivities;
+            }
         }
         else {
             if(newInp.size() == inputAugmented.size()){
                 InputAugmentedArma = arma::Col<double>(newInp);
                 inputAugmented = newInp;
+                // a new input is considered independent of the parameters
+                if(!sensitivityParameters.empty()){
+                    inputSensitivities.zeros();
+                }
             }
         }
     }
@@ -641,6 +973,12 @@ Computation& Computation::operator=( const Computation& rhs){
     pseudoInverseArma = rhs.getPseudoInverseArma();
     InputAugmentedArma = rhs.getInputAugmentedArma();
     pseudoInverseAugmentedArma = rhs.getPseudoInverseAugmentedArma();
+    invertibleAugmentedOperator = rhs.isInvertibleAugmentedOperator();
+    normalizedAdjacencyValid = false; // the cached matrices belong to the previous augmented graph
+    conservationWeightsValid = false;
+    nodeToIndex = rhs.nodeToIndex;
+    virtualNodeKeys = rhs.virtualNodeKeys;
+    updateNodeIndexes();
     return *this;
 }
 
@@ -672,11 +1010,18 @@ void Computation::assign(const Computation & rhs){
     pseudoInverseArma = rhs.getPseudoInverseArma();
     InputAugmentedArma = rhs.getInputAugmentedArma();
     pseudoInverseAugmentedArma = rhs.getPseudoInverseAugmentedArma();
+    invertibleAugmentedOperator = rhs.isInvertibleAugmentedOperator();
+    normalizedAdjacencyValid = false; // the cached matrices belong to the previous augmented graph
+    conservationWeightsValid = false;
+    nodeToIndex = rhs.nodeToIndex;
+    virtualNodeKeys = rhs.virtualNodeKeys;
+    updateNodeIndexes();
 }
 
 // optimization
 void Computation::freeAugmentedGraphs(){
     nodeToIndex = augmentedGraph->getNodeToIndexMap();
+    updateNodeIndexes();
     delete augmentedGraph;
 }
 
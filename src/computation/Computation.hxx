@@ -10,14 +10,21 @@
 #include "computation/DissipationModel.hxx"
 #include "computation/ConservationModel.hxx"
 #include "computation/PropagationModel.hxx"
+#include "computation/SensitivityParameter.hxx"
+#include "computation/StepKernel.hxx"
+#include "data_structures/FlatHashMap.hxx"
 #include "data_structures/Matrix.hxx"
 #include "data_structures/WeightedEdgeGraph.hxx"
 #include "logging/Logger.hxx"
+#include "utils/mathUtilities.hxx"
+#include "utils/NameInterner.hxx"
 #include <map>
 #include <string>
 #include <tuple>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <optional>
 
 /**
  * @class Computation
@@ -32,7 +39,7 @@ class Computation{
         std::vector<double> outputAugmented;          /**< Output vector after computation on the augmented graph. */
 
         WeightedEdgeGraph* graph;                     /**< Pointer to the core graph. */
-        WeightedEdgeGraph* augmentedGraph;            /**< Pointer to the augmented graph. */
+        WeightedEdgeGraph* augmentedGraph;            /**< Pointer to the augmented graph, an overlay of the core graph with the virtual nodes and the inter-type edges. */
 
         std::vector<std::string> types;           /**< List of all known cell types. */
         std::string localType;                    /**< The cell type of the current agent. */
@@ -44,15 +51,101 @@ class Computation{
         arma::Mat<double> pseudoInverseArma;          /**< Armadillo pseudo-inverse matrix for core graph. */
         arma::Col<double> InputAugmentedArma;         /**< Armadillo vector of inputs for augmented graph. */
         arma::Mat<double> pseudoInverseAugmentedArma; /**< Armadillo pseudo-inverse matrix for augmented graph. */
+        bool invertibleAugmentedOperator = false;     /**< Indicates whether (I - W) of the augmented graph is invertible, in which case the pseudo-inverse is the inverse and can be updated with rank-1 updates. */
 
         std::map<std::string, int> nodeToIndex;       /**< Maps node names to their indices. */
+        FlatHashMap<NameId, int> nameIdToIndex;       /**< Maps the interned node names to their indices, used in the simulation loop. */
+        FlatHashMap<uint64_t, int> virtualInputIndexes;  /**< Indices of the virtual input nodes, keyed by the interned (type, node) pair. */
+        FlatHashMap<uint64_t, int> virtualOutputIndexes; /**< Indices of the virtual output nodes, keyed by the interned (type, node) pair. */
+        std::vector<int> virtualOutputNodeIndexes;    /**< Indices of all the virtual output nodes, reset by resetVirtualOutputs. */
+        FlatHashMap<NameId, uint64_t> virtualNodeKeys; /**< The interned (type, node) pair of every virtual node, keyed by the interned name of the virtual node, set when the virtual node is added. */
 
         DissipationModel* dissipationModel = nullptr;     /**< Pointer to dissipation model. */
         ConservationModel* conservationModel = nullptr;   /**< Pointer to conservation model. */
         PropagationModel* propagationModel = nullptr;     /**< Pointer to propagation model. */
 
         std::function<double(double,double)> saturationFunction; /**< Function to apply saturation logic to computed values. */
+        BatchSaturationFunction batchSaturationFunction = clampSaturationBatch; /**< Function to apply saturation logic to the whole output, used by the computation step. */
 
+        std::map<double, std::vector<std::tuple<std::string,std::string,double>>> edgeWeightUpdatesSchedule; /**< Scheduled edge weight updates of the augmented graph, indexed by the time from which they are applied. */
+
+        arma::Mat<double> normalizedAdjacency;        /**< Cached Wstar, the row normalized adjacency matrix of the augmented graph, used by the conservation model. */
+        bool normalizedAdjacencyValid = false;        /**< Indicates whether the cached normalized adjacency matrix is valid (reset when the augmented graph changes). */
+        arma::Col<double> conservationWeights;        /**< Cached Wstar*q of the augmented graph, used when the conservation model has a constant scale. */
+        std::vector<double> conservationWeightsQ;     /**< The q vector used to compute the cached conservation weights. */
+        bool conservationWeightsValid = false;        /**< Indicates whether the cached conservation weights are valid (reset when the augmented graph changes). */
+
+        std::shared_ptr<const StepKernelBase> stepKernel; /**< The step kernel composed for the current models, selected when needed after the models change. */
+        ModelProperties stepKernelDissipationProperties;  /**< The properties of the dissipation model used to select the step kernel. */
+        ModelProperties stepKernelConservationProperties; /**< The properties of the conservation model used to select the step kernel. */
+        bool defaultSaturationFunction = true;            /**< Indicates whether the saturation function is the default one (clamping), used to select the step kernel. */
+
+        std::vector<SensitivityParameter> sensitivityParameters; /**< The parameters whose sensitivities are propagated with the state, empty if the tangent propagation is disabled. */
+        std::vector<std::vector<arma::uword>> sensitivityParametersPerTarget; /**< The indexes of the sensitivity parameters of every target model (dissipation, propagation, conservation). */
+        arma::Mat<double> inputSensitivities;         /**< Derivatives of the augmented input with respect to the sensitivity parameters (nodes x parameters). */
+        arma::Mat<double> outputSensitivities;        /**< Derivatives of the augmented output with respect to the sensitivity parameters (nodes x parameters). */
+
+        /**
+         * @brief Select the step kernel for the current models, if it was not selected yet or the properties of the models changed
+         * @param dissipationProperties: the current properties of the dissipation model
+         * @param conservationProperties: the current properties of the conservation model
+         * @see makeStepKernel
+         */
+        void selectStepKernel(const ModelProperties& dissipationProperties, const ModelProperties& conservationProperties);
+        /**
+         * @brief Get the row normalized adjacency matrix of the augmented graph (Wstar), used by the conservation model
+         * @return a reference to the cached matrix, computed again only when the augmented graph changes
+         * @throw std::invalid_argument if the augmented graph is not set
+         */
+        const arma::Mat<double>& augmentedNormalizedAdjacency();
+        /**
+         * @brief Get the product of the normalized adjacency matrix of the augmented graph and q, used when the conservation model has a constant scale
+         * @param qVector: the q vector of the conservation model (empty means all ones)
+         * @return a reference to the cached product, computed again only when the graph or q change
+         * @throw std::invalid_argument if q is not of the same size as the input
+         */
+        const arma::Col<double>& augmentedConservationWeights(const std::vector<double>& qVector);
+        /**
+         * @brief Propagate the sensitivities of the input through the step, the step is linear in the input for fixed scaling values
+         * @param timeStep: the time of the step
+         * @param saturationVector: the saturation values of the step, nullptr if the saturation is not applied
+         * @param qVector: the q vector for the conservation model (empty means all ones)
+         * @return the derivatives of the output of the step with respect to the sensitivity parameters (nodes x parameters)
+         * @details Every term of the step is differentiated with respect to the input (applied to the input sensitivities) and with respect to the scaling values
+         * of the nodes (multiplied by the derivatives of the scaling values with respect to the parameters); the saturation is differentiated with central differences.
+         * @throw std::invalid_argument if a model does not support the tangent propagation
+         */
+        arma::Mat<double> propagateSensitivities(double timeStep, const std::vector<double>* saturationVector, const std::vector<double>& qVector);
+
+        /**
+         * @brief Record the type and the node of a virtual node added to the augmented graph.
+         * @param virtualNodeName The name of the virtual node (v-in:type, v-out:type or v-in:type_node, v-out:type_node).
+         * @param type The type of the virtual node.
+         * @param node The node of the type, empty for the virtual node of the whole type.
+         */
+        void registerVirtualNode(const std::string& virtualNodeName, const std::string& type, const std::string& node = "");
+        /**
+         * @brief Record the type and the node of a virtual node found in an edges list, the type is one of the known types.
+         * @param virtualNodeName The name of the virtual node (v-in:type, v-out:type or v-in:type_node, v-out:type_node).
+         * @param knownTypes The types the virtual node can refer to.
+         * @details The name is not split at the first "_", since type and node names can contain it: it is matched against the known types.
+         * @throw std::invalid_argument if no known type matches the name, or more known types match it.
+         */
+        void registerVirtualNode(const std::string& virtualNodeName, const std::vector<std::string>& knownTypes);
+        /**
+         * @brief Rebuild the tables of the interned node names and of the virtual nodes from nodeToIndex.
+         * @details Called every time the augmented graph changes, so the simulation loop only looks up integer keys.
+         */
+        void updateNodeIndexes();
+        /**
+         * @brief Get the index of a virtual node in the augmented graph.
+         * @param virtualIndexes The table of the virtual inputs or of the virtual outputs.
+         * @param type The interned name of the type.
+         * @param node The interned name of the node, NameInterner::invalidId for the virtual node of the whole type.
+         * @return The index of the virtual node.
+         * @throw std::out_of_range if the virtual node is not in the augmented graph.
+         */
+        int virtualNodeIndex(const FlatHashMap<uint64_t, int>& virtualIndexes, NameId type, NameId node)const;
     public:
         /**
          * @brief Default constructor for Computation class.
@@ -113,6 +206,7 @@ class Computation{
          * @details The function will create a new graph with the same sub-structure as the original graph, but with additional edges and nodes. The new edges will be added to the graph, and the new nodes will be added to the graph.
          * The new nodes will be added to the graph with different names.
          * The new edges will be added to the graph with weights.
+         * The new graph is an overlay of the core graph (@see WeightedEdgeGraph::addNodesAndOverlayNew): the core is shared, only the virtual nodes and the new edges are stored for this type.
          * @note This function is the one that should be used since it's not computing any other additional variable that is used in the Propagation itself (since the propagation model handles the use of additional variables)
          * @warning This function adds nodes indiscriminately, see issue #43 on the repository for more information https://github.com/josura/MASFENON/issues/43
          */
@@ -159,9 +253,71 @@ class Computation{
          * @param newEdgesList: the list of edges to be added to the graph, in the form of a vector of triples of 2 string and a double, representing the edge and its weight
          * @param bothDirections: if true, the edges will be added in both directions (default is false)
          * @param inverseComputation: if true, the pseudo-inverse of the augmented graph will be computed (default is true)
+         * @param virtualNodeTypes: the types the virtual nodes in the edges list refer to, in addition to the types of the augmented graph and the local type (default is empty)
          * @details The function will add the edges to the graph and compute the pseudo-inverse of the augmented graph if inverseComputation is true. The function will also add the nodes present in the edges list to the graph, if the node is not already present in the graph.
+         * @details The type and the node of a new virtual node (v-in:type_node) are recovered by matching the name with the known types, so both can contain "_".
+         * @throw std::invalid_argument if a new virtual node does not refer to exactly one known type
          */
-        void addEdgesAndNodes(const std::vector<std::tuple<std::string,std::string,double>>& newEdgesList, bool bothDirections = false, bool inverseComputation = true);
+        void addEdgesAndNodes(const std::vector<std::tuple<std::string,std::string,double>>& newEdgesList, bool bothDirections = false, bool inverseComputation = true, const std::vector<std::string>& virtualNodeTypes = std::vector<std::string>());
+        /**
+         * @brief Update the weights of edges of the augmented graph and the operators of the propagation model
+         * @param newEdgeWeights: the edges to update, in the form of a vector of triples of 2 string and a double, representing the edge and its new weight
+         * @param bothDirections: if true, the edges will be updated in both directions (default is false)
+         * @details The propagation model operators are updated incrementally, only for the nodes whose outgoing edges changed (@see PropagationModel::updateEdgeWeights).
+         * @details The conservation term uses the adjacency matrix of the augmented graph directly, only the cached conservation weights of a constant conservation model are invalidated.
+         * @details If the (deprecated) pseudo-inverse of the augmented graph was computed, it is updated as well.
+         * @throw std::invalid_argument if one of the nodes is not in the augmented graph.
+         */
+        void updateEdgeWeights(const std::vector<std::tuple<std::string,std::string,double>>& newEdgeWeights, bool bothDirections = false);
+        /**
+         * @brief Schedule an update of the weights of edges of the augmented graph
+         * @param time: the time from which the new weights are used
+         * @param newEdgeWeights: the edges to update, in the form of a vector of triples of 2 string and a double, representing the edge and its new weight
+         * @details The scheduled updates are applied by applyScheduledEdgeWeightUpdates, called at the beginning of computeAugmentedPerturbationEnhanced4.
+         * @details Updates scheduled for the same time are merged, in the order in which they were scheduled.
+         */
+        void scheduleEdgeWeightUpdates(double time, const std::vector<std::tuple<std::string,std::string,double>>& newEdgeWeights);
+        /**
+         * @brief Apply all the scheduled edge weight updates with time lower or equal to the given time
+         * @param time: the current time
+         * @return true if at least one update was applied, false otherwise
+         * @details The applied updates are removed from the schedule.
+         */
+        bool applyScheduledEdgeWeightUpdates(double time);
+        /**
+         * @brief Remove all the scheduled edge weight updates that were not applied yet
+         * @details Used to schedule the same updates again for a new computation on the same augmented graph.
+         */
+        void clearScheduledEdgeWeightUpdates(){edgeWeightUpdatesSchedule.clear();}
+        /**
+         * @brief Precompute the scaling values of the dissipation, conservation and propagation models over the simulation time grid
+         * @param times: the times of the simulation grid (@see ScaleSchedule::simulationTimeGrid)
+         * @param pool: the pool used to share identical schedules between the models of different agents, if nullptr the schedules are not shared (default is nullptr)
+         * @details The models should be set before calling this function, models set afterwards evaluate their scale functions at every step.
+         * @throw std::invalid_argument if one of the models or the augmented graph is not set.
+         */
+        void precomputeScaleSchedules(const std::vector<double>& times, ScaleSchedulePool* pool = nullptr);
+        /**
+         * @brief Get the hash of the precomputed scaling values of the models used before a given time
+         * @param time: the time, the scaling values at this time are not included
+         * @return the hash, nullopt if the scaling values of a model before the time were not all precomputed
+         * @details Two computations with the same input at time 0 and the same hash at a time reach the same state at that time.
+         * The models without precomputed scaling values (constant or without scale function) are assumed to be the same between the computations compared.
+         * @see ScaleSchedule::prefixHash
+         */
+        std::optional<uint64_t> scalePrefixHash(double time) const;
+        /**
+         * @brief Get the times where the precomputed scaling values of one of the models change
+         * @return the sorted distinct times, @see ScaleSchedule::changeTimes
+         */
+        std::vector<double> scaleChangeTimes() const;
+        /**
+         * @brief Get the description of the step kernel selected for the current models
+         * @return the description, in the form dissipation/propagation/conservation/saturation (e.g. identity/neighbors/zero/clamp)
+         * @details The kernel is selected if it was not selected yet. Kernels with generic parts call the models through their interfaces.
+         * @throw std::invalid_argument if one of the models is not set.
+         */
+        std::string getStepKernelDescription();
         
         // computation functions
         /**
@@ -232,6 +388,9 @@ class Computation{
          * @param qVector: the q vector for the conservation model (default to empty vector)
          * @return The perturbation vector.
          * @note This function is the most general one, allowing for the use of all the models and functions defined in the class.
+         * @details The step is computed by a step kernel composed at compile time for the current models (@see StepKernel), selected once after the models are set:
+         * an identity dissipation and a zero conservation are skipped, models with a constant scale do not evaluate their scale functions,
+         * and the original and neighbors propagation models are called without virtual dispatch.
          */
         std::vector<double> computeAugmentedPerturbationEnhanced4(double timeStep, bool saturation = true, const std::vector<double>& saturationsVector = std::vector<double>(),const std::vector<double>& qVector = std::vector<double>()); //all the models
         /**
@@ -249,6 +408,30 @@ class Computation{
          * @note This function is used to update the input vector of the Computation object. It is useful when the input vector needs to be changed during the execution of the program.
          */
         void updateInput(const std::vector<double>& newInp = std::vector<double>(), bool augmented = false);
+        /**
+         * @brief Enable the tangent propagation, the derivatives of the augmented output with respect to the parameters are computed at every step of computeAugmentedPerturbationEnhanced4
+         * @param parameters: the parameters of the scaling functions of the nodes, an empty vector disables the tangent propagation
+         * @details The sensitivities of the current input are set to zero, the input is considered independent of the parameters.
+         * When the augmented input is updated with the output (updateInput without a new input), the sensitivities of the output become the sensitivities of the input;
+         * a new input vector, the virtual inputs and the virtual outputs set from the other types are considered constants (their sensitivities are zero).
+         * @throw std::invalid_argument if the augmented graph is not set or a parameter refers to a node outside the augmented graph
+         * @see SensitivityParameter
+         */
+        void setSensitivityParameters(const std::vector<SensitivityParameter>& parameters);
+        /**
+         * @brief Getting the parameters whose sensitivities are propagated
+         * @return The corresponding private member.
+         */
+        const std::vector<SensitivityParameter>& getSensitivityParameters()const{return sensitivityParameters;}
+        /**
+         * @brief Getting the derivatives of the augmented output of the last step with respect to the sensitivity parameters
+         * @return The sensitivities matrix (nodes of the augmented graph x parameters), in the order of the sensitivity parameters
+         */
+        const arma::Mat<double>& getSensitivities()const{return outputSensitivities;}
+        /**
+         * @brief Set the sensitivities of the input and of the output to zero, e.g. when the computation starts again from the initial input
+         */
+        void resetSensitivities();
 
         // get sets
         /**
@@ -287,6 +470,21 @@ class Computation{
          * @return The corresponding private member.
          */
         WeightedEdgeGraph* getAugmentedGraph()const{return augmentedGraph;}
+        /**
+         * @brief Getting the dissipation model pointer of the Computation object (the model is not owned by the computation)
+         * @return The corresponding private member.
+         */
+        DissipationModel* getDissipationModel()const{return dissipationModel;}
+        /**
+         * @brief Getting the conservation model pointer of the Computation object (the model is not owned by the computation)
+         * @return The corresponding private member.
+         */
+        ConservationModel* getConservationModel()const{return conservationModel;}
+        /**
+         * @brief Getting the propagation model pointer of the Computation object (the model is not owned by the computation)
+         * @return The corresponding private member.
+         */
+        PropagationModel* getPropagationModel()const{return propagationModel;}
         /**
          * @brief Getting the types of the Computation object
          * @details These functions provide access to the private members of the class, allowing read-only access to the data.
@@ -311,6 +509,12 @@ class Computation{
          * @return True if the Armadillo structure is initialized for the augmented graph, false otherwise.
          */
         bool isInitializedArmaAugmented()const{return armaInitializedAugmented;}
+        /**
+         * @brief Know if the propagation operator (I - W) of the augmented graph is invertible
+         * @details The invertibility is estimated from the reciprocal condition number when the pseudo-inverse is computed. Edge weight updates use rank-1 updates of the pseudo-inverse only when it is the inverse.
+         * @return True if the operator of the augmented graph is invertible, false otherwise.
+         */
+        bool isInvertibleAugmentedOperator()const{return invertibleAugmentedOperator;}
         /**
          * @brief Getting the Armadillo input vector of the Computation object
          * @details These functions provide access to the private members of the class, allowing read-only access to the data.
@@ -347,6 +551,19 @@ class Computation{
             int index = nodeToIndex.at(nodeName);
             return outputAugmented[index];
             };
+        /**
+         * @brief get the output value of a node in the graph from its interned name
+         * @param node: the interned name of the node, @see NameInterner
+         * @return double: the value of the node in the graph
+         * @throw std::out_of_range if the node is not in the graph
+        */
+        double getOutputNodeValue(NameId node)const{
+            const int* index = nameIdToIndex.find(node);
+            if(index == nullptr){
+                throw std::out_of_range("Computation::getOutputNodeValue: the node name is not in the graph");
+            }
+            return outputAugmented[*index];
+            };
         /**
          * @brief get the input value of a node in the graph
          * @param nodeName: the name of the node in the graph
@@ -381,6 +598,19 @@ class Computation{
             inputAugmented[index] = value;
             InputAugmentedArma[index] = value;
         };
+        /**
+         * @brief set the input value of a node in the graph from its interned name
+         * @param node: the interned name of the node, @see NameInterner
+         * @param value: the value to set
+         * @throw std::out_of_range if the node is not in the graph
+         */
+        void setInputNodeValue(NameId node, double value){
+            const int* index = nameIdToIndex.find(node);
+            if(index == nullptr)
+                throw std::out_of_range("Computation::setInputNodeValue: the node name is not in the graph");
+            inputAugmented[*index] = value;
+            InputAugmentedArma[*index] = value;
+        };
         /**
          * @brief get the value of a virtual input node in the graph
          * @param type: the type of the node in the source graph
@@ -409,6 +639,38 @@ class Computation{
          * @param targetNode: the name of the target node in the target graph
          */
         void setInputVoutForType(std::string type, double value, std::string targetNode="");
+        /**
+         * @brief get the value of a virtual input node in the graph from the interned names, used in the simulation loop
+         * @param type: the interned name of the type of the node in the source graph
+         * @param sourceNode: the interned name of the source node in the source graph, NameInterner::invalidId for the virtual input of the whole type
+         * @return double: the value of the node in the graph
+         * @throw std::out_of_range if the virtual node is not in the graph
+         */
+        double getVirtualInputForType(NameId type, NameId sourceNode=NameInterner::invalidId)const;
+        /**
+         * @brief get the value of a virtual output node in the graph from the interned names, used in the simulation loop
+         * @param type: the interned name of the type of the node in the target graph
+         * @param targetNode: the interned name of the target node in the target graph, NameInterner::invalidId for the virtual output of the whole type
+         * @return double: the value of the node in the graph
+         * @throw std::out_of_range if the virtual node is not in the graph
+         */
+        double getVirtualOutputForType(NameId type, NameId targetNode=NameInterner::invalidId)const;
+        /**
+         * @brief set the value of a virtual input node in the graph from the interned names, used in the simulation loop
+         * @param type: the interned name of the type of the node in the source graph
+         * @param value: the value to set
+         * @param sourceNode: the interned name of the source node in the source graph, NameInterner::invalidId for the virtual input of the whole type
+         * @throw std::out_of_range if the virtual node is not in the graph
+         */
+        void setInputVinForType(NameId type, double value, NameId sourceNode=NameInterner::invalidId);
+        /**
+         * @brief set the value of a virtual output node in the graph from the interned names
+         * @param type: the interned name of the type of the node in the target graph
+         * @param value: the value to set
+         * @param targetNode: the interned name of the target node in the target graph, NameInterner::invalidId for the virtual output of the whole type
+         * @throw std::out_of_range if the virtual node is not in the graph
+         */
+        void setInputVoutForType(NameId type, double value, NameId targetNode=NameInterner::invalidId);
         /**
          * @brief set the Dissipation model of the graph (passing the pointer to the instance of the model)
          * @param dissipationModel: the pointer to the instance of the model
@@ -438,6 +700,7 @@ class Computation{
          * @details This function sets the graph of the computation object to the graph passed as a parameter.
          * @details This function is only used for testing and pointer management.
          * @details This function is not really used in the code in key phases, but it is useful for testing purposes and pointer management.
+         * @warning The augmented graph is an overlay of the previous graph, the previous graph must not be deleted until the graph is augmented again.
          */
         void setGraph(WeightedEdgeGraph* _graph){this->graph = _graph;}
 
@@ -455,7 +718,27 @@ class Computation{
          * @details This function sets the saturation function used in the computation.
          * @details The saturation function is a function that takes two double values as input and returns a double value.
          */
-        void setSaturationFunction(std::function<double(double,double)> saturationFunction){this->saturationFunction = saturationFunction;}
+        void setSaturationFunction(std::function<double(double,double)> saturationFunction){this->saturationFunction = saturationFunction; this->batchSaturationFunction = batchSaturationFromElementwise(saturationFunction); this->defaultSaturationFunction = false; this->stepKernel.reset();}
+        /**
+         * @brief get the batch saturation function
+         * @details The batch saturation function saturates the whole output of a step in a single call.
+         * @return BatchSaturationFunction: the batch saturation function
+         */
+        BatchSaturationFunction getBatchSaturationFunction()const{return batchSaturationFunction;}
+        /**
+         * @brief set the batch saturation function
+         * @param batchSaturationFunction: BatchSaturationFunction the function saturating a whole array in place (e.g. clampSaturationBatch, hyperbolicTangentScaledBatch)
+         * @details The single value saturation function is set to the batch function applied to one value.
+         */
+        void setBatchSaturationFunction(BatchSaturationFunction batchSaturationFunction){
+            this->batchSaturationFunction = batchSaturationFunction;
+            this->saturationFunction = [batchSaturationFunction](double value, double saturation)-> double{
+                batchSaturationFunction(&value, &saturation, 1);
+                return value;
+            };
+            this->defaultSaturationFunction = false;
+            this->stepKernel.reset();
+        }
 
         /**
          * @brief reset the virtual outputs for the computation, setting them to 0
@@ -1 +1,104 @@
-#include "computation/ComputationVectorized.hxx"
\ No newline at end of file
+/**
+ * @file ComputationVectorized.cxx
+ * @ingroup Experimental
+ * @brief Implements the ComputationVectorized class, the ensemble computation of the perturbation for many scenarios on the same graph.
+ */
+#include "computation/ComputationVectorized.hxx"
+#include "logging/Logger.hxx"
+#include "utils/armaUtilities.hxx"
+#include <stdexcept>
+#include <string>
+
+ComputationVectorized::ComputationVectorized(const WeightedEdgeGraph* graph, const arma::Mat<double>& input):graph(graph),input(input){
+    if(graph == nullptr){
+        throw std::invalid_argument("[ERROR] ComputationVectorized::ComputationVectorized: graph is not set. abort");
+    }
+    if(SizeToInt(input.n_rows) != graph->getNumNodes()){
+        throw std::invalid_argument("[ERROR] ComputationVectorized::ComputationVectorized: the input does not have a row for every node of the graph: " + std::to_string(input.n_rows) + "!=" + std::to_string(graph->getNumNodes()) + ". abort");
+    }
+    Wstar = normalize1Rows(graph->getAdjacencyMatrix().asArmadilloMatrix());
+}
+
+ComputationVectorized::ComputationVectorized(const WeightedEdgeGraph* graph, const std::vector<std::vector<double>>& scenarioInputs):graph(graph){
+    if(graph == nullptr){
+        throw std::invalid_argument("[ERROR] ComputationVectorized::ComputationVectorized: graph is not set. abort");
+    }
+    if(scenarioInputs.empty()){
+        throw std::invalid_argument("[ERROR] ComputationVectorized::ComputationVectorized: there are no scenarios. abort");
+    }
+    input.set_size(graph->getNumNodes(), scenarioInputs.size());
+    for(arma::uword scenario = 0; scenario < scenarioInputs.size(); scenario++){
+        if(SizeToInt(scenarioInputs[scenario].size()) != graph->getNumNodes()){
+            throw std::invalid_argument("[ERROR] ComputationVectorized::ComputationVectorized: the input of the scenario " + std::to_string(scenario) + " is not of the same size as the number of nodes of the graph. abort");
+        }
+        input.col(scenario) = vectorToArmaColumn(scenarioInputs[scenario]);
+    }
+    Wstar = normalize1Rows(graph->getAdjacencyMatrix().asArmadilloMatrix());
+}
+
+const arma::Mat<double>& ComputationVectorized::computePerturbation(double timeStep, bool saturation, const std::vector<double>& saturationsVector, const std::vector<double>& qVector){
+    //control over the various models
+    if (dissipationModel == nullptr) {
+        throw std::invalid_argument("[ERROR] ComputationVectorized::computePerturbation: dissipationModel is not set. abort");
+    }
+    if (conservationModel == nullptr) {
+        throw std::invalid_argument("[ERROR] ComputationVectorized::computePerturbation: conservationModel is not set. abort");
+    }
+    if (propagationModel == nullptr) {
+        throw std::invalid_argument("[ERROR] ComputationVectorized::computePerturbation: propagationModel is not set. abort");
+    }
+    std::vector<double> saturationVectorVar;
+    if (saturation) {
+        saturationVectorVar = saturationsVector;
+        if(saturationVectorVar.size() == 0){
+            saturationVectorVar = std::vector<double>(input.n_rows,1);
+        }
+        if(saturationVectorVar.size() != input.n_rows){
+            throw std::invalid_argument("[ERROR] ComputationVectorized::computePerturbation: saturationVector is not of the same size as the number of nodes: " + std::to_string(saturationVectorVar.size()) + "!=" + std::to_string(input.n_rows) + ". abort");
+        }
+    }
+    try
+    {
+        // every part of the step works on all the scenarios at once
+        arma::Mat<double> dissipated = dissipationModel->dissipate(input, timeStep);
+        output = propagationModel->propagate(dissipated, timeStep);
+        output -= conservationModel->conservationTerm(dissipated, Wstar, timeStep, qVector);
+    }
+    catch(const std::exception& e)
+    {
+        Logger::getInstance().printError(e.what());
+        throw std::invalid_argument("[ERROR] ComputationVectorized::computePerturbation: error during the computation of the step");
+    }
+    if (saturation) {
+        // the columns are contiguous, so the batch function is called once for every scenario
+        for(arma::uword scenario = 0; scenario < output.n_cols; scenario++){
+            batchSaturationFunction(output.colptr(scenario), saturationVectorVar.data(), output.n_rows);
+        }
+    }
+    return output;
+}
+
+void ComputationVectorized::updateInput(const arma::Mat<double>& newInput){
+    if(newInput.is_empty()){
+        input = output;
+        return;
+    }
+    if(newInput.n_rows != input.n_rows){
+        throw std::invalid_argument("[ERROR] ComputationVectorized::updateInput: the new input does not have a row for every node of the graph: " + std::to_string(newInput.n_rows) + "!=" + std::to_string(input.n_rows) + ". abort");
+    }
+    input = newInput;
+}
+
+void ComputationVectorized::updateNormalizedAdjacency(){
+    if(SizeToInt(input.n_rows) != graph->getNumNodes()){
+        throw std::invalid_argument("[ERROR] ComputationVectorized::updateNormalizedAdjacency: the number of nodes of the graph changed, the computation should be created again. abort");
+    }
+    Wstar = normalize1Rows(graph->getAdjacencyMatrix().asArmadilloMatrix());
+}
+
+std::vector<double> ComputationVectorized::getScenarioOutput(arma::uword scenario)const{
+    if(scenario >= output.n_cols){
+        throw std::out_of_range("ComputationVectorized::getScenarioOutput: the scenario " + std::to_string(scenario) + " does not exist or no step was computed");
+    }
+    return armaColumnToVector(arma::Col<double>(output.col(scenario)));
+}
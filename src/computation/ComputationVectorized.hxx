@@ -0,0 +1,122 @@
+/**
+ * @file ComputationVectorized.hxx
+ * @ingroup Experimental
+ * @brief Defines the ComputationVectorized class, the ensemble version of the Computation class that advances many scenarios on the same graph together.
+ * @details The state is a matrix (nodes x scenarios): every column is a scenario (a different initial perturbation or parameter set) and all the scenarios are
+ * advanced by the same step, computed with matrix-matrix products by the vectorized models (DissipationModelVectorized, ConservationModelVectorized, PropagationModelVectorized).
+ * @details The step is the same as Computation::computeAugmentedPerturbationEnhanced4, applied to every column: the input is dissipated, the dissipated input is propagated,
+ * the conservation term of the dissipated input is subtracted and the output is saturated.
+ */
+#pragma once
+#include <armadillo>
+#include <string>
+#include <vector>
+#include "computation/ConservationModelVectorized.hxx"
+#include "computation/DissipationModelVectorized.hxx"
+#include "computation/PropagationModelVectorized.hxx"
+#include "data_structures/WeightedEdgeGraph.hxx"
+#include "utils/mathUtilities.hxx"
+
+/**
+ * @class ComputationVectorized
+ * @brief Ensemble computation of the perturbation, many scenarios on the same graph advanced through matrix-matrix kernels.
+ * @details The graph is usually the augmented graph of a Computation (@see Computation::getAugmentedGraph), the graph and the models are not owned by the class.
+ * @details The normalized adjacency matrix used by the conservation is computed once, call updateNormalizedAdjacency after the edge weights of the graph changed.
+ */
+class ComputationVectorized{
+    private:
+        const WeightedEdgeGraph* graph = nullptr;                   /**< The graph shared by all the scenarios (not owned). */
+        arma::Mat<double> input;                                    /**< The input of the scenarios (nodes x scenarios). */
+        arma::Mat<double> output;                                   /**< The output of the last step (nodes x scenarios). */
+        arma::Mat<double> Wstar;                                    /**< The normalized adjacency matrix of the graph, used by the conservation model. */
+        DissipationModelVectorized* dissipationModel = nullptr;     /**< Pointer to the dissipation model (not owned). */
+        ConservationModelVectorized* conservationModel = nullptr;   /**< Pointer to the conservation model (not owned). */
+        PropagationModelVectorized* propagationModel = nullptr;     /**< Pointer to the propagation model (not owned). */
+        BatchSaturationFunction batchSaturationFunction = clampSaturationBatch; /**< Function to apply saturation logic to the output, called once for every scenario. */
+    public:
+        /**
+         * @brief Constructor for the ComputationVectorized class.
+         * @param graph The graph shared by all the scenarios.
+         * @param input The input of the scenarios, a matrix with a row for every node of the graph and a column for every scenario.
+         * @throw std::invalid_argument if the graph is nullptr or the number of rows of the input is not the number of nodes of the graph.
+         */
+        ComputationVectorized(const WeightedEdgeGraph* graph, const arma::Mat<double>& input);
+        /**
+         * @brief Constructor for the ComputationVectorized class from the inputs of the single scenarios.
+         * @param graph The graph shared by all the scenarios.
+         * @param scenarioInputs The input of every scenario, every input has a value for every node of the graph.
+         * @throw std::invalid_argument if the graph is nullptr, there are no scenarios or one of the inputs is not of the same size as the number of nodes of the graph.
+         */
+        ComputationVectorized(const WeightedEdgeGraph* graph, const std::vector<std::vector<double>>& scenarioInputs);
+
+        /**
+         * @brief Compute a step of the perturbation for all the scenarios.
+         * @param timeStep: the current time
+         * @param saturation: if true, the saturation will be applied (default to true)
+         * @param saturationsVector: the saturation values of the nodes, shared by all the scenarios (default to empty vector, meaning all ones)
+         * @param qVector: the q vector for the conservation model (default to empty vector)
+         * @return The output of the step (nodes x scenarios), the input is not changed (@see updateInput).
+         * @throw std::invalid_argument if one of the models is not set, the saturation vector is not of the same size as the number of nodes or the step fails.
+         */
+        const arma::Mat<double>& computePerturbation(double timeStep, bool saturation = true, const std::vector<double>& saturationsVector = std::vector<double>(), const std::vector<double>& qVector = std::vector<double>());
+        /**
+         * @brief Update the input of the scenarios.
+         * @param newInput: the new input (nodes x scenarios), if empty the output of the last step is used as the new input
+         * @throw std::invalid_argument if the new input does not have a row for every node of the graph.
+         */
+        void updateInput(const arma::Mat<double>& newInput = arma::Mat<double>());
+        /**
+         * @brief Compute the normalized adjacency matrix again, after the edge weights of the graph have changed.
+         * @throw std::invalid_argument if the number of nodes of the graph changed.
+         */
+        void updateNormalizedAdjacency();
+
+        // get sets
+        /**
+         * @brief Get the number of nodes of the graph.
+         * @return The number of rows of the state.
+         */
+        arma::uword getNumNodes()const{return input.n_rows;}
+        /**
+         * @brief Get the number of scenarios.
+         * @return The number of columns of the state.
+         */
+        arma::uword getNumScenarios()const{return input.n_cols;}
+        /**
+         * @brief Get the input of the scenarios.
+         * @return The input (nodes x scenarios).
+         */
+        const arma::Mat<double>& getInput()const{return input;}
+        /**
+         * @brief Get the output of the last step.
+         * @return The output (nodes x scenarios), empty if no step was computed.
+         */
+        const arma::Mat<double>& getOutput()const{return output;}
+        /**
+         * @brief Get the output of a scenario.
+         * @param scenario: the index of the scenario
+         * @return The output of the scenario in the last step, with a value for every node.
+         * @throw std::out_of_range if the scenario does not exist or no step was computed.
+         */
+        std::vector<double> getScenarioOutput(arma::uword scenario)const;
+        /**
+         * @brief Set the dissipation model.
+         * @param dissipationModel: the dissipation model (not owned)
+         */
+        void setDissipationModel(DissipationModelVectorized* dissipationModel){this->dissipationModel = dissipationModel;}
+        /**
+         * @brief Set the conservation model.
+         * @param conservationModel: the conservation model (not owned)
+         */
+        void setConservationModel(ConservationModelVectorized* conservationModel){this->conservationModel = conservationModel;}
+        /**
+         * @brief Set the propagation model.
+         * @param propagationModel: the propagation model (not owned)
+         */
+        void setPropagationModel(PropagationModelVectorized* propagationModel){this->propagationModel = propagationModel;}
+        /**
+         * @brief Set the batch saturation function.
+         * @param batchSaturationFunction: the function applied to the output of every scenario (default is clampSaturationBatch)
+         */
+        void setBatchSaturationFunction(BatchSaturationFunction batchSaturationFunction){this->batchSaturationFunction = batchSaturationFunction;}
+};
@@ -13,7 +13,13 @@ ConservationModel::ConservationModel(){
     // initialize the vectorized scaled function to be used later when the number of elements is known (to be able to meet a condition when being initialized, like returning a size 0 Matrix)
     // this->scaleFunctionVectorized = [](double time)-> arma::Mat<double>{return arma::Mat<double>(0,0);};
     this->scaleFunctionVectorized = [](double time)-> arma::Col<double>{return arma::Mat<double>(0,0);}; // using a column vector with 0 elements as a placeholder
+    this->properties = ModelProperties::constant(0.5);
+}
 
+ConservationModel::ConservationModel(double constantScale){
+    this->scaleFunction = [constantScale](double time)-> double{return constantScale;};
+    this->scaleFunctionVectorized = [](double time)-> arma::Col<double>{return arma::Mat<double>(0,0);};
+    this->properties = ModelProperties::constant(constantScale);
 }
 
 ConservationModel::ConservationModel(std::function<double(double)> scaleFunction){
@@ -24,22 +30,56 @@ ConservationModel::ConservationModel(std::function<double(double)> scaleFunction
 
 ConservationModel::ConservationModel(std::function<arma::Col<double>(double)> scaleFunction){
     this->scaleFunctionVectorized = scaleFunction;
+    this->scaleFunctionVectorizedSize = this->scaleFunctionVectorized(0).n_elem; // initialize the number of elements based on the scale function
+}
+
+void ConservationModel::setScaleFunctionVectorized(std::function<arma::Col<double>(double)> scaleFunction){
+    this->scaleFunctionVectorized = scaleFunction;
+    this->scaleFunctionVectorizedSize = this->scaleFunctionVectorized(0).n_elem;
+    this->properties = ModelProperties::generic();
+    this->clearScaleSchedule();
 }
 
 ConservationModel::~ConservationModel(){}
 
-arma::Col<double> ConservationModel::conservate(arma::Col<double> input, arma::Col<double> inputDissipated, arma::Mat<double> Wstar,double time, std::vector<double> q){
+const arma::Col<double>& ConservationModel::scaleValues(double time, arma::uword numElem){
+    if(this->scaleSchedule && this->scaleSchedule->getNumElements() == numElem){
+        const arma::Col<double>* scheduledValues = this->scaleSchedule->at(time);
+        if(scheduledValues != nullptr){
+            return *scheduledValues;
+        }
+    }
     // initializing the vectorized scale function if it was not initialized before (we have the number of elements now in the input)
-    // WARNING: do not use n_cols since it is still 1 for control, since armadillo still considers it as 1 even though there are 0 elements in the matrix
-    if (this->scaleFunctionVectorized(0).n_elem != input.n_elem) {
-        // make a vectorized function that returns a diagonal matrix with the scale function values on the diagonal
+    if (this->scaleFunctionVectorizedSize != numElem) {
         //capturing the scale function by copy to avoid issues with the lambda capture
-        this->scaleFunctionVectorized = [scaleFunction = scaleFunction, numElem = input.n_elem](double time)-> arma::Col<double>{
-            // arma::Mat<double> scaleMatrix = arma::diagmat(arma::ones<arma::Col<double>>(input.n_elem) * scaleFunction(time));
+        this->scaleFunctionVectorized = [scaleFunction = scaleFunction, numElem = numElem](double time)-> arma::Col<double>{
             arma::Col<double> scaleValues = arma::ones<arma::Col<double>>(numElem) * scaleFunction(time);
             return scaleValues;
-        };  
+        };
+        this->scaleFunctionVectorizedSize = numElem;
     }
+    this->scaleBuffer = this->scaleFunctionVectorized(time);
+    return this->scaleBuffer;
+}
+
+bool ConservationModel::precomputeScaleSchedule(const std::vector<double>& times, arma::uword numElements, ScaleSchedulePool* pool){
+    std::function<arma::Col<double>(double)> scheduleFunction = this->scaleFunctionVectorized;
+    if (this->scaleFunctionVectorizedSize != numElements) {
+        std::function<double(double)> scaleFunction = this->scaleFunction;
+        scheduleFunction = [scaleFunction, numElements](double time)-> arma::Col<double>{
+            return arma::ones<arma::Col<double>>(numElements) * scaleFunction(time);
+        };
+    }
+    if(pool != nullptr){
+        this->scaleSchedule = pool->getSchedule(times, scheduleFunction, numElements);
+    } else {
+        this->scaleSchedule = std::make_shared<const ScaleSchedule>(times, scheduleFunction, numElements);
+    }
+    return true;
+}
+
+arma::Col<double> ConservationModel::conservate(arma::Col<double> input, arma::Col<double> inputDissipated, arma::Mat<double> Wstar,double time, std::vector<double> q){
+    const arma::Col<double>& scale = this->scaleValues(time, input.n_elem);
 
     //if q is empty, then we assume that all the values in q are 1, that means all the weights of the edges are considered of the same importance and 
     // and the perturbation is completely passed down the network 
@@ -47,7 +87,7 @@ arma::Col<double> ConservationModel::conservate(arma::Col<double> input, arma::C
         if (q.size() == input.n_elem) {
             //convert q vector to arma vector
             arma::Col<double> qArma = vectorToArmaColumn(q);
-            arma::Col<double> outputArma = inputDissipated -  scaleFunctionVectorized(time) % (Wstar * qArma) % input;
+            arma::Col<double> outputArma = inputDissipated -  scale % (Wstar * qArma) % input;
             return outputArma;
         } else{
             throw std::invalid_argument("q vector is not of the same size as input vector. abort");
@@ -56,40 +96,45 @@ arma::Col<double> ConservationModel::conservate(arma::Col<double> input, arma::C
     else {
         //since in the case of vector values with all q values equal to 1
         arma::Col<double> qOnes = arma::ones<arma::Col<double>>(input.n_elem);
-        arma::Col<double> outputArma =  inputDissipated - scaleFunctionVectorized(time) % (Wstar * qOnes) % input;
+        arma::Col<double> outputArma =  inputDissipated - scale % (Wstar * qOnes) % input;
         return outputArma;
     }
 }
 
 arma::Col<double> ConservationModel::conservationTerm(arma::Col<double> input, arma::Mat<double> Wstar, double time, std::vector<double> q){
     uint numElem = input.n_elem;
-    // initializing the vectorized scale function if it was not initialized before (we have the number of elements now in the input)
-    //if (this->scaleFunctionVectorized(0).n_elem == 0) {
-    if (this->scaleFunctionVectorized(0).n_elem != numElem) { // workaround for the case when the scale function is not initialized or we use the same scale function for different input sizes
-        // make a vectorized function that returns a diagonal matrix with the scale function values on the diagonal
-        //this->scaleFunctionVectorized = [scaleFunction = scaleFunction,input](double time)-> arma::Mat<double>{
-            //arma::Mat<double> scaleMatrix = arma::diagmat(arma::ones<arma::Col<double>>(input.n_elem) * scaleFunction(time));
-        this->scaleFunctionVectorized = [scaleFunction = scaleFunction, numElem = numElem](double time)-> arma::Col<double>{
-            //arma::Mat<double> scaleMatrix = arma::diagmat(arma::ones<arma::Col<double>>(input.n_elem) * 1.0); // using 1.0 as a placeholder, since we will multiply it later with the scale function value
-            arma::Col<double> scaleValues = arma::ones<arma::Col<double>>(numElem) * scaleFunction(time);
-            return scaleValues;
-        };  
-    }
+    const arma::Col<double>& scale = this->scaleValues(time, numElem);
 
     if (q.size()) {
         if (q.size() == numElem) {
             //convert q vector to arma vector
             arma::Col<double> qArma = vectorToArmaColumn(q);
-            arma::Col<double> outputArma =  scaleFunctionVectorized(time) % (Wstar * qArma) % input;
+            arma::Col<double> outputArma =  scale % (Wstar * qArma) % input;
             return outputArma;
         } else{
             throw std::invalid_argument("q is not of the same size as input vector. abort");
         }
     } else{
         arma::Col<double> qOnes = arma::ones<arma::Col<double>>(numElem);
-        arma::Col<double> outputArma = scaleFunctionVectorized(time) % (Wstar * qOnes) % input;
+        arma::Col<double> outputArma = scale % (Wstar * qOnes) % input;
         return outputArma;
     }
 }
 
+arma::Mat<double> ConservationModel::conservationTermTangent(const arma::Mat<double>& tangent, const arma::Mat<double>& Wstar, double time, const std::vector<double>& q){
+    if(q.size() && q.size() != tangent.n_rows){
+        throw std::invalid_argument("[ERROR] ConservationModel::conservationTermTangent: q is not of the same size as the tangent vectors. abort");
+    }
+    arma::Col<double> qArma = q.size() ? vectorToArmaColumn(q) : arma::ones<arma::Col<double>>(tangent.n_rows);
+    arma::Mat<double> output = tangent;
+    output.each_col() %= this->scaleValues(time, tangent.n_rows) % (Wstar * qArma);
+    return output;
+}
 
+arma::Col<double> ConservationModel::conservationTermScaleDerivative(const arma::Col<double>& input, const arma::Mat<double>& Wstar, double time, const std::vector<double>& q){
+    if(q.size() && q.size() != input.n_elem){
+        throw std::invalid_argument("[ERROR] ConservationModel::conservationTermScaleDerivative: q is not of the same size as input vector. abort");
+    }
+    arma::Col<double> qArma = q.size() ? vectorToArmaColumn(q) : arma::ones<arma::Col<double>>(input.n_elem);
+    return (Wstar * qArma) % input;
+}
@@ -9,6 +9,11 @@
 #pragma once
 #include <armadillo>
 #include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "computation/ModelProperties.hxx"
+#include "computation/ScaleSchedule.hxx"
 
 /**
  * @class ConservationModel
@@ -22,6 +27,18 @@ class ConservationModel{
     protected:
         std::function<double(double)> scaleFunction; ///< The function to scale the conservation term. It takes a double value (time) and returns a double value.>
         std::function<arma::Col<double>(double)> scaleFunctionVectorized; ///< The function to scale the conservation term for vectorized operations. It takes a double value (time) and returns a vector of double values (scaling values).
+        arma::uword scaleFunctionVectorizedSize = 0; ///< The number of values returned by the vectorized scale function, used to know when the vectorized function should be built from the scalar one.
+        std::shared_ptr<const ScaleSchedule> scaleSchedule; ///< The precomputed scaling values over the simulation time grid, empty if not precomputed.
+        arma::Col<double> scaleBuffer; ///< Buffer for the scaling values of the times that are not precomputed in the schedule.
+        ModelProperties properties; ///< The algebraic properties of the conservation term, constant only if the model was built with a constant scale.
+        /**
+         * @brief Get the scaling values at a given time.
+         * @param time The current time.
+         * @param numElem The number of elements of the input vector.
+         * @return A reference to the precomputed scaling values if the time is in the schedule, otherwise to the buffer with the evaluated scale function.
+         * @details The vectorized scale function is built from the scalar one when the number of elements changes.
+         */
+        const arma::Col<double>& scaleValues(double time, arma::uword numElem);
     public:
         /**
          * @brief Default constructor for the ConservationModel class.
@@ -34,6 +51,12 @@ class ConservationModel{
          * @details Initializes the scale function to the provided value.
          */
         ConservationModel(std::function<double(double)> scaleFunction);
+        /**
+         * @brief Constructor for the ConservationModel class with a constant scale.
+         * @param constantScale The constant value of the scale function.
+         * @details The model advertises the constant scale in its properties, so that the computation can simplify the step (or skip it if the scale is 0).
+         */
+        ConservationModel(double constantScale);
         /**
          * @brief Constructor for the Conservation Model class, passing a scaling function that uses vectorized operations.
          * @param scaleFunction The function to scale the conservation term. It takes a double value (time) and returns a Diagonal matrix of double values (scaling values for each node, outgoing edges are scaled with this).
@@ -69,6 +92,26 @@ class ConservationModel{
          * @details The conservation term is computed as the product of the scale function, the matrix Wstar, and the input vector.
          */
         virtual arma::Col<double> conservationTerm(arma::Col<double> input,arma::Mat<double> Wstar, double time, std::vector<double> q = std::vector<double>());
+        /**
+         * @brief Apply the derivative of the conservation term with respect to the input to the tangent vectors (tangent propagation).
+         * @param tangent The tangent vectors (nodes x parameters), every column is the derivative of the input with respect to a parameter.
+         * @param Wstar The matrix representing the conservation model.
+         * @param time The current time.
+         * @param q A vector of weights for the edges (default is an empty vector).
+         * @return The derivative of the conservation term with respect to the parameters, every row is scaled by scale % (Wstar * q).
+         * @throw std::invalid_argument if q is not of the same size as the tangent vectors.
+         */
+        virtual arma::Mat<double> conservationTermTangent(const arma::Mat<double>& tangent, const arma::Mat<double>& Wstar, double time, const std::vector<double>& q = std::vector<double>());
+        /**
+         * @brief Get the derivative of the conservation term with respect to the scaling value of every node, that is (Wstar * q) % input.
+         * @param input The input vector where the derivative is computed.
+         * @param Wstar The matrix representing the conservation model.
+         * @param time The current time.
+         * @param q A vector of weights for the edges (default is an empty vector).
+         * @return The vector of the derivatives, the element i is the derivative of conservationTerm(input)[i] with respect to the scaling value of the node i.
+         * @throw std::invalid_argument if q is not of the same size as the input vector.
+         */
+        virtual arma::Col<double> conservationTermScaleDerivative(const arma::Col<double>& input, const arma::Mat<double>& Wstar, double time, const std::vector<double>& q = std::vector<double>());
 
         //getters and setters
         /**
@@ -82,5 +125,43 @@ class ConservationModel{
          * @param scaleFunction The scale function to be set.
          * @details This function sets the scale function used in the conservation model.
          */
-        void setScaleFunction(std::function<double(double)> scaleFunction){this->scaleFunction = scaleFunction;}
+        void setScaleFunction(std::function<double(double)> scaleFunction){this->scaleFunction = scaleFunction; this->properties = ModelProperties::generic();}
+        /**
+         * @brief Replace the vectorized scale function of the model.
+         * @param scaleFunctionVectorized The new vectorized scale function, returning the scaling values of every node at a given time.
+         * @details The precomputed scaling values are removed and the model is no longer advertised as constant.
+         */
+        virtual void setScaleFunctionVectorized(std::function<arma::Col<double>(double)> scaleFunctionVectorized);
+        /**
+         * @brief Get the algebraic properties of the conservation term.
+         * @return The properties of the model, constant if the model was built with a constant scale (also the default constructor).
+         * @details The computation uses the properties to skip or simplify the conservation in the step.
+         * @see ModelProperties
+         */
+        virtual ModelProperties getProperties() const {return this->properties;}
+        /**
+         * @brief Precompute the scaling values of the model over the simulation time grid.
+         * @param times The times of the simulation grid.
+         * @param numElements The number of elements of the input vectors.
+         * @param pool The pool used to share identical schedules between models, if nullptr the schedule is not shared.
+         * @return true if the schedule was precomputed.
+         * @details During the computation, the times in the grid use the precomputed values instead of evaluating the scale function.
+         * @see ScaleSchedule
+         */
+        virtual bool precomputeScaleSchedule(const std::vector<double>& times, arma::uword numElements, ScaleSchedulePool* pool = nullptr);
+        /**
+         * @brief Remove the precomputed scaling values, the scale function is evaluated again at every call.
+         */
+        void clearScaleSchedule(){this->scaleSchedule.reset();}
+        /**
+         * @brief Set the precomputed scaling values, computed before for the current scale function.
+         * @param scaleSchedule The schedule of the scaling values over the simulation time grid, empty to evaluate the scale function at every call.
+         * @details Used to restore a schedule kept from a previous precomputation instead of evaluating the scale function again over the grid.
+         */
+        void setScaleSchedule(std::shared_ptr<const ScaleSchedule> scaleSchedule){this->scaleSchedule = std::move(scaleSchedule);}
+        /**
+         * @brief Get the precomputed scaling values.
+         * @return The schedule of the scaling values, empty if not precomputed.
+         */
+        const std::shared_ptr<const ScaleSchedule>& getScaleSchedule() const {return this->scaleSchedule;}
 };
\ No newline at end of file
@@ -0,0 +1,54 @@
+/**
+ * @file ConservationModelPlugin.cxx
+ * @ingroup Core
+ * @brief Implements the ConservationModelPlugin class, a conservation model implemented by a plugin loaded at runtime.
+ */
+#include "computation/ConservationModelPlugin.hxx"
+#include <stdexcept>
+
+ConservationModelPlugin::ConservationModelPlugin(std::shared_ptr<const ModelPlugin> plugin, size_t numNodes, const std::vector<double>& parameters):plugin(plugin){
+    if(!this->plugin){
+        throw std::invalid_argument("[ERROR] ConservationModelPlugin::ConservationModelPlugin: the plugin is not set. abort");
+    }
+    if(!this->plugin->provides(MASFENON_MODEL_CONSERVATION)){
+        throw std::invalid_argument("[ERROR] ConservationModelPlugin::ConservationModelPlugin: the plugin " + this->plugin->getName() + " does not implement a conservation model. abort");
+    }
+    // the term is opaque, the step cannot be specialized on a constant scale
+    this->properties = ModelProperties::generic();
+    this->state = this->plugin->createState(MASFENON_MODEL_CONSERVATION, numNodes, nullptr, parameters);
+}
+
+ConservationModelPlugin::~ConservationModelPlugin(){
+    this->plugin->destroyState(this->state);
+}
+
+arma::Col<double> ConservationModelPlugin::conservate(arma::Col<double> input, arma::Col<double> inputDissipated, arma::Mat<double> Wstar, double time, std::vector<double> q){
+    return inputDissipated - this->conservationTerm(input, Wstar, time, q);
+}
+
+arma::Col<double> ConservationModelPlugin::conservationTerm(arma::Col<double> input, arma::Mat<double> Wstar, double time, std::vector<double> q){
+    if(q.size() == 0){
+        q = std::vector<double>(input.n_elem, 1.0);
+    } else if(q.size() != input.n_elem){
+        throw std::invalid_argument("[ERROR] ConservationModelPlugin::conservationTerm: q is not of the same size as input vector. abort");
+    }
+    if(Wstar.n_rows != input.n_elem || Wstar.n_cols != input.n_elem){
+        throw std::invalid_argument("[ERROR] ConservationModelPlugin::conservationTerm: Wstar is not a square matrix of the same size as input vector. abort");
+    }
+    arma::Col<double> output(input.n_elem);
+    int status = this->plugin->getDescriptor().conservationTerm(this->state, input.memptr(), Wstar.memptr(), q.data(), output.memptr(), input.n_elem, time);
+    this->plugin->checkStatus(status, "ConservationModelPlugin::conservationTerm");
+    return output;
+}
+
+void ConservationModelPlugin::setScaleFunctionVectorized(std::function<arma::Col<double>(double)> scaleFunctionVectorized){
+    throw std::invalid_argument("[ERROR] ConservationModelPlugin::setScaleFunctionVectorized: the conservation term is computed by the plugin " + plugin->getName() + ", there is no scale function to replace. abort");
+}
+
+arma::Mat<double> ConservationModelPlugin::conservationTermTangent(const arma::Mat<double>& tangent, const arma::Mat<double>& Wstar, double time, const std::vector<double>& q){
+    throw std::invalid_argument("[ERROR] ConservationModelPlugin::conservationTermTangent: the conservation term is computed by the plugin " + plugin->getName() + ", its derivative is not known. abort");
+}
+
+arma::Col<double> ConservationModelPlugin::conservationTermScaleDerivative(const arma::Col<double>& input, const arma::Mat<double>& Wstar, double time, const std::vector<double>& q){
+    throw std::invalid_argument("[ERROR] ConservationModelPlugin::conservationTermScaleDerivative: the conservation term is computed by the plugin " + plugin->getName() + ", there are no scaling values. abort");
+}
@@ -0,0 +1,82 @@
+/**
+ * @file ConservationModelPlugin.hxx
+ * @ingroup Core
+ * @brief Defines the ConservationModelPlugin class, a conservation model implemented by a plugin loaded at runtime.
+ * @details The conservation term of all the nodes is computed by the plugin in a single call, see ModelPluginABI.hxx.
+ */
+#pragma once
+#include <armadillo>
+#include <memory>
+#include <vector>
+#include "computation/ConservationModel.hxx"
+#include "computation/ModelPlugin.hxx"
+
+/**
+ * @class ConservationModelPlugin
+ * @brief Class for conservation models implemented by a plugin.
+ * @details The conserved values are inputDissipated - term, where the term is computed by the plugin. The scale function of the base class is not used.
+ */
+class ConservationModelPlugin : public ConservationModel
+{
+    private:
+        std::shared_ptr<const ModelPlugin> plugin; ///< The plugin, kept loaded while the model exists.
+        void* state = nullptr; ///< The state of the model created by the plugin.
+    public:
+        /**
+         * @brief Constructor for the ConservationModelPlugin class.
+         * @param plugin The plugin implementing the conservation term.
+         * @param numNodes The number of nodes of the graph.
+         * @param parameters The parameters of the model, passed to the plugin.
+         * @throw std::invalid_argument if the plugin is nullptr or does not implement the conservation term.
+         */
+        ConservationModelPlugin(std::shared_ptr<const ModelPlugin> plugin, size_t numNodes, const std::vector<double>& parameters = std::vector<double>());
+        /**
+         * @brief Destructor for the ConservationModelPlugin class, the state of the model is destroyed by the plugin.
+         */
+        ~ConservationModelPlugin();
+        ConservationModelPlugin(const ConservationModelPlugin&) = delete;
+        ConservationModelPlugin& operator=(const ConservationModelPlugin&) = delete;
+        /**
+         * @brief Applies the conservation model.
+         * @param input The input vector.
+         * @param inputDissipated The input vector after the dissipation.
+         * @param Wstar The normalized adjacency matrix.
+         * @param time The current time.
+         * @param q The weights of the nodes, all ones if empty.
+         * @return The dissipated input minus the conservation term computed by the plugin.
+         * @throw std::invalid_argument if q is not empty and not of the same size as the input.
+         * @throw std::runtime_error if the plugin returns an error.
+         */
+        arma::Col<double> conservate(arma::Col<double> input, arma::Col<double> inputDissipated, arma::Mat<double> Wstar, double time, std::vector<double> q = std::vector<double>())override;
+        /**
+         * @brief Computes the conservation term.
+         * @param input The input vector.
+         * @param Wstar The normalized adjacency matrix.
+         * @param time The current time.
+         * @param q The weights of the nodes, all ones if empty.
+         * @return The conservation term computed by the plugin.
+         * @throw std::invalid_argument if q is not empty and not of the same size as the input, or Wstar is not a square matrix of the same size.
+         * @throw std::runtime_error if the plugin returns an error.
+         */
+        arma::Col<double> conservationTerm(arma::Col<double> input, arma::Mat<double> Wstar, double time, std::vector<double> q = std::vector<double>())override;
+        /**
+         * @brief The term is computed by the plugin, there is no scale function to precompute.
+         * @return false
+         */
+        bool precomputeScaleSchedule(const std::vector<double>& times, arma::uword numElements, ScaleSchedulePool* pool = nullptr)override {return false;}
+        /**
+         * @brief The term is computed by the plugin, there is no scale function to replace.
+         * @throw std::invalid_argument always.
+         */
+        void setScaleFunctionVectorized(std::function<arma::Col<double>(double)> scaleFunctionVectorized)override;
+        /**
+         * @brief The term is computed by the plugin, its derivative is not known.
+         * @throw std::invalid_argument always.
+         */
+        arma::Mat<double> conservationTermTangent(const arma::Mat<double>& tangent, const arma::Mat<double>& Wstar, double time, const std::vector<double>& q = std::vector<double>())override;
+        /**
+         * @brief The term is computed by the plugin, there are no scaling values.
+         * @throw std::invalid_argument always.
+         */
+        arma::Col<double> conservationTermScaleDerivative(const arma::Col<double>& input, const arma::Mat<double>& Wstar, double time, const std::vector<double>& q = std::vector<double>())override;
+};
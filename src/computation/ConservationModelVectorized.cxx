@@ -6,6 +6,8 @@
 #include "computation/ConservationModelVectorized.hxx"
 #include "utils/armaUtilities.hxx"
 #include "utils/mathUtilities.hxx"
+#include <stdexcept>
+#include <string>
 
 
 ConservationModelVectorized::ConservationModelVectorized(){
@@ -18,42 +20,33 @@ ConservationModelVectorized::ConservationModelVectorized(std::function<double(do
 
 ConservationModelVectorized::~ConservationModelVectorized(){}
 
+ConservationModelVectorized::ConservationModelVectorized(std::function<arma::Row<double>(double)> scaleFunction):scaleFunctionScenarios(scaleFunction){
+    // the shared scale is the mean of the scenarios, only used by getScaleFunction
+    this->scaleFunction = [scaleFunction](double time)-> double{return arma::mean(scaleFunction(time));};
+}
+
 arma::Mat<double> ConservationModelVectorized::conservate(arma::Mat<double> input, arma::Mat<double> inputDissipated, arma::Mat<double> Wstar,double time, std::vector<double> q){
-    //if q is empty, then we assume that all the values in q are 1, that means all the weights of the edges are considered of the same importance and 
-    // and the perturbation is completely passed down the network 
-    if (q.size()) {
-        if (q.size() == input.n_rows) {
-            //convert q vector to arma vector
-            arma::Mat<double> qArmaMatrix = vectorToArmaMatrixRepeatColumns(q, Wstar.n_cols);
-            arma::Mat<double> outputArma = inputDissipated -  (scaleFunction(time) * Wstar * qArmaMatrix) % input;
-            return outputArma;
-        } else{
-            throw std::invalid_argument("q vector is not of the same size as input vector. abort");
-        }
-    }
-    else {
-        //since in the case of vector values with all q values equal to 1
-        arma::Mat<double> qOnesMatrix = arma::ones<arma::Mat<double>>(input.n_rows, input.n_cols);
-        arma::Mat<double> outputArma =  inputDissipated -  (scaleFunction(time)* Wstar * qOnesMatrix) % input;
-        return outputArma;
-    }
+    return inputDissipated - this->conservationTerm(input, Wstar, time, q);
 }
 
 arma::Mat<double> ConservationModelVectorized::conservationTerm(arma::Mat<double> input, arma::Mat<double> Wstar, double time, std::vector<double> q){
-    if (q.size()) {
-        if (q.size() == input.n_rows) {
-            //convert q vector to arma vector
-            arma::Mat<double> qArmaMatrix = vectorToArmaMatrixRepeatColumns(q, Wstar.n_cols);
-            arma::Mat<double> outputArma =  (scaleFunction(time) * Wstar * qArmaMatrix) % input;
-            return outputArma;
-        } else{
-            throw std::invalid_argument("q is not of the same size as input vector. abort");
+    //if q is empty, then we assume that all the values in q are 1, that means all the weights of the edges are considered of the same importance and 
+    // and the perturbation is completely passed down the network 
+    if (q.size() && q.size() != input.n_rows) {
+        throw std::invalid_argument("q is not of the same size as input vector. abort");
+    }
+    arma::Col<double> qArma = q.size() ? vectorToArmaColumn(q) : arma::ones<arma::Col<double>>(input.n_rows);
+    // Wstar*q is the same for all the scenarios, so it is computed once instead of a matrix-matrix product
+    arma::Col<double> conservationWeights = Wstar * qArma;
+    input.each_col() %= conservationWeights;
+    if (this->scaleFunctionScenarios) {
+        arma::Row<double> scales = this->scaleFunctionScenarios(time);
+        if (scales.n_elem != input.n_cols) {
+            throw std::invalid_argument("[ERROR] ConservationModelVectorized::conservationTerm: the number of scaling values is not the number of scenarios: " + std::to_string(scales.n_elem) + "!=" + std::to_string(input.n_cols) + ". abort");
         }
-    } else{
-        arma::Mat<double> qOnesMatrix = arma::ones<arma::Mat<double>>(input.n_rows, input.n_cols);
-        arma::Mat<double> outputArma =  scaleFunction(time) *(Wstar * qOnesMatrix) % input;
-        return outputArma;
+        input.each_row() %= scales;
+    } else {
+        input *= this->scaleFunction(time);
     }
+    return input;
 }
-
-
@@ -5,6 +5,7 @@
  * @details The ConservationModelVectorized class provides methods for applying conservation logic to the perturbation computation.
  * @details The conservation class uses a scale function to determine the scaling of the conservation term. The scale function can be set and modified as needed.
  * @details To set the scale function, @see CustomFunctions.hxx
+ * @details The input is a matrix (nodes x scenarios), the scale can be shared by all the scenarios or defined per scenario.
  */
 #pragma once
 #include <armadillo>
@@ -21,6 +22,7 @@
 class ConservationModelVectorized{
     protected:
         std::function<double(double)> scaleFunction; ///< The function to scale the conservation term. It takes a double value (time) and returns a double value.
+        std::function<arma::Row<double>(double)> scaleFunctionScenarios; ///< The function to scale the conservation term for every scenario. It takes a double value (time) and returns a row of double values (one per scenario), empty if the scale is shared.
     public:
         /**
          * @brief Default constructor for the ConservationModelVectorized class.
@@ -33,6 +35,11 @@ class ConservationModelVectorized{
          * @details Initializes the scale function to the provided value.
          */
         ConservationModelVectorized(std::function<double(double)> scaleFunction);
+        /**
+         * @brief Constructor for the ConservationModelVectorized class with a scale function per scenario.
+         * @param scaleFunction The function to scale the conservation term, returning one scaling value for every scenario (column of the input matrix).
+         */
+        ConservationModelVectorized(std::function<arma::Row<double>(double)> scaleFunction);
         /**
          * @brief Destructor for the ConservationModelVectorized class.
          * @details Cleans up any resources used by the class.
@@ -49,6 +56,7 @@ class ConservationModelVectorized{
          * @return The output matrix after applying the conservation model.
          * @details This function is used to compute the final output of the conservation model.
          * @details The output is computed as the product of the scale function, the matrix Wstar, and the input matrix, taking into account the dissipated input.
+         * @throw std::invalid_argument if q is not of the same size as the number of nodes, or if the scale is defined per scenario and the number of scaling values is not the number of columns of the input.
          */         
         virtual arma::Mat<double> conservate(arma::Mat<double> input, arma::Mat<double> inputDissipated,arma::Mat<double> Wstar, double time, std::vector<double> q = std::vector<double>());
         /**
@@ -60,6 +68,8 @@ class ConservationModelVectorized{
          * @return The conservation term matrix.
          * @details This function is used to compute the conservation term for the input matrix.
          * @details The conservation term is computed as the product of the scale function, the matrix Wstar, and the input matrix.
+         * @details Wstar*q is computed once and shared by all the scenarios.
+         * @throw std::invalid_argument if q is not of the same size as the number of nodes, or if the scale is defined per scenario and the number of scaling values is not the number of columns of the input.
          */
         virtual arma::Mat<double> conservationTerm(arma::Mat<double> input,arma::Mat<double> Wstar, double time, std::vector<double> q = std::vector<double>());
 
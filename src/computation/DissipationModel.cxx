@@ -3,6 +3,32 @@
  * @ingroup Core
  * @brief Implements the DissipationModel class used for managing dissipation dynamics for the computation of the perturbation in MASFENON.
  * @details The DissipationModel class provides methods for applying dissipation logic to the perturbation computation.
- * @details This file is empty because the DissipationModel class is an abstract class and should not be used directly. 
+ * @details The DissipationModel class is an abstract class and should not be used directly, only the precomputation of the scaling values is shared by the implementations.
  */
 #include "computation/DissipationModel.hxx"
+#include <stdexcept>
+
+bool DissipationModel::precomputeScaleSchedule(const std::vector<double>& times, arma::uword numElements, ScaleSchedulePool* pool){
+    std::function<arma::Col<double>(double)> scaleFunctionVectorized = this->scheduleScaleFunction(numElements);
+    if(!scaleFunctionVectorized){
+        return false;
+    }
+    if(pool != nullptr){
+        this->scaleSchedule = pool->getSchedule(times, scaleFunctionVectorized, numElements);
+    } else {
+        this->scaleSchedule = std::make_shared<const ScaleSchedule>(times, scaleFunctionVectorized, numElements);
+    }
+    return true;
+}
+
+void DissipationModel::setScaleFunctionVectorized(std::function<arma::Col<double>(double)> scaleFunctionVectorized){
+    throw std::invalid_argument("[ERROR] DissipationModel::setScaleFunctionVectorized: the dissipation model does not use a scale function that can be replaced. abort");
+}
+
+arma::Mat<double> DissipationModel::dissipateTangent(const arma::Mat<double>& tangent, const arma::Col<double>& input, double time){
+    throw std::invalid_argument("[ERROR] DissipationModel::dissipateTangent: the dissipation model does not support the tangent propagation. abort");
+}
+
+arma::Col<double> DissipationModel::dissipateScaleDerivative(const arma::Col<double>& input, double time){
+    throw std::invalid_argument("[ERROR] DissipationModel::dissipateScaleDerivative: the dissipation model does not use per node scaling values. abort");
+}
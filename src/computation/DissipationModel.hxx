@@ -9,6 +9,12 @@
  */
 #pragma once
 #include <armadillo>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "computation/ModelProperties.hxx"
+#include "computation/ScaleSchedule.hxx"
 
 /**
  * @class DissipationModel
@@ -22,6 +28,13 @@
 class DissipationModel{
     protected:
         int numEl; ///< The number of elements in the dissipation model. This is used to determine the size of the input and output vectors.
+        std::shared_ptr<const ScaleSchedule> scaleSchedule; ///< The precomputed scaling values over the simulation time grid, empty if not precomputed.
+        /**
+         * @brief Get the vectorized scale function to be precomputed in the schedule.
+         * @param numElements The number of elements of the input vectors.
+         * @return The vectorized scale function, an empty function if the model does not use a scale function (the default).
+         */
+        virtual std::function<arma::Col<double>(double)> scheduleScaleFunction(arma::uword numElements){return nullptr;}
     public:
         /**
          * @brief Default destructor for the DissipationModel class. (needed even if the class is abstract)
@@ -44,6 +57,13 @@ class DissipationModel{
          * @details This function is used to compute the dissipation term of the input vector.
          */
         virtual arma::Col<double> dissipationTerm(arma::Col<double> input, double time) = 0;
+        /**
+         * @brief Get the algebraic properties of the dissipation term.
+         * @return The properties of the model, the generic properties (nothing guaranteed) by default.
+         * @details The computation uses the properties to skip or simplify the dissipation in the step.
+         * @see ModelProperties
+         */
+        virtual ModelProperties getProperties() const {return ModelProperties::generic();}
         /**
          * @brief Get the number of elements in the dissipation model.
          * @return The number of elements in the dissipation model.
@@ -56,4 +76,53 @@ class DissipationModel{
          * @details This function is used to set the number of elements in the dissipation model.
          */
         void setNumEl(int numEl){this->numEl = numEl;}
+        /**
+         * @brief Precompute the scaling values of the model over the simulation time grid.
+         * @param times The times of the simulation grid.
+         * @param numElements The number of elements of the input vectors.
+         * @param pool The pool used to share identical schedules between models, if nullptr the schedule is not shared.
+         * @return true if the schedule was precomputed, false if the model does not use a scale function.
+         * @details During the computation, the times in the grid use the precomputed values instead of evaluating the scale function.
+         * @see ScaleSchedule
+         */
+        bool precomputeScaleSchedule(const std::vector<double>& times, arma::uword numElements, ScaleSchedulePool* pool = nullptr);
+        /**
+         * @brief Remove the precomputed scaling values, the scale function is evaluated again at every call.
+         */
+        void clearScaleSchedule(){this->scaleSchedule.reset();}
+        /**
+         * @brief Set the precomputed scaling values, computed before for the current scale function.
+         * @param scaleSchedule The schedule of the scaling values over the simulation time grid, empty to evaluate the scale function at every call.
+         * @details Used to restore a schedule kept from a previous precomputation instead of evaluating the scale function again over the grid.
+         */
+        void setScaleSchedule(std::shared_ptr<const ScaleSchedule> scaleSchedule){this->scaleSchedule = std::move(scaleSchedule);}
+        /**
+         * @brief Get the precomputed scaling values.
+         * @return The schedule of the scaling values, empty if not precomputed.
+         */
+        const std::shared_ptr<const ScaleSchedule>& getScaleSchedule() const {return this->scaleSchedule;}
+        /**
+         * @brief Replace the vectorized scale function of the model, keeping the rest of the model unchanged.
+         * @param scaleFunctionVectorized The new vectorized scale function, returning the scaling values of every node at a given time.
+         * @details The precomputed scaling values are removed, they should be precomputed again for the new scale function.
+         * @throw std::invalid_argument if the model does not use a vectorized scale function (the default).
+         */
+        virtual void setScaleFunctionVectorized(std::function<arma::Col<double>(double)> scaleFunctionVectorized);
+        /**
+         * @brief Apply the derivative of the dissipation with respect to the input to the tangent vectors (tangent propagation).
+         * @param tangent The tangent vectors (nodes x parameters), every column is the derivative of the input with respect to a parameter.
+         * @param input The input vector where the derivative is computed.
+         * @param time The current time.
+         * @return The derivative of the dissipated vector with respect to the parameters (nodes x parameters).
+         * @throw std::invalid_argument if the model does not support the tangent propagation (the default).
+         */
+        virtual arma::Mat<double> dissipateTangent(const arma::Mat<double>& tangent, const arma::Col<double>& input, double time);
+        /**
+         * @brief Get the derivative of the dissipated vector with respect to the scaling value of every node.
+         * @param input The input vector where the derivative is computed.
+         * @param time The current time.
+         * @return The vector of the derivatives, the element i is the derivative of dissipate(input)[i] with respect to the scaling value of the node i.
+         * @throw std::invalid_argument if the model does not use per node scaling values (the default).
+         */
+        virtual arma::Col<double> dissipateScaleDerivative(const arma::Col<double>& input, double time);
 };
\ No newline at end of file
@@ -6,13 +6,24 @@
  * @details The periodic dissipation model uses a set of phases, periods, and amplitudes to compute the dissipation term.
  */
 #include "computation/DissipationModelPeriodic.hxx"
+#include <cmath>
 #include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    /**
+     * @brief Maximum number of consecutive rotations before the sines are evaluated directly again, to bound the accumulation of rounding errors.
+     */
+    constexpr int maxRotationsBetweenEvaluations = 64;
+}
 
 DissipationModelPeriodic::DissipationModelPeriodic(){
     numEl = 1;
     this->phases = arma::Col<double>(numEl);
     this->periods = arma::Col<double>(numEl);
     this->amplitudes = arma::Col<double>(numEl);
+    computeAngularFrequencies();
 }
 
 DissipationModelPeriodic::DissipationModelPeriodic(int numEl,double phase, double period, double amplitude){
@@ -20,6 +31,7 @@ DissipationModelPeriodic::DissipationModelPeriodic(int numEl,double phase, doubl
     this->phases = arma::Col<double>(numEl,arma::fill::scalar_holder(phase));
     this->periods = arma::Col<double>(numEl,arma::fill::scalar_holder(period));
     this->amplitudes = arma::Col<double>(numEl,arma::fill::scalar_holder(amplitude));
+    computeAngularFrequencies();
 }
 
 DissipationModelPeriodic::DissipationModelPeriodic(arma::Col<double> phases, arma::Col<double> periods, arma::Col<double> amplitudes){
@@ -27,23 +39,92 @@ DissipationModelPeriodic::DissipationModelPeriodic(arma::Col<double> phases, arm
     this->phases = phases;
     this->periods = periods;
     this->amplitudes = amplitudes;
+    computeAngularFrequencies();
 }
 
 DissipationModelPeriodic::~DissipationModelPeriodic(){
 }
 
+void DissipationModelPeriodic::computeAngularFrequencies(){
+    this->angularFrequencies = 2*arma::datum::pi/this->periods;
+    this->uniformFrequency = this->periods.n_elem > 0 && arma::all(this->periods == this->periods(0));
+    this->cacheValid = false;
+}
+
+const arma::Col<double>& DissipationModelPeriodic::sinValuesAt(double time){
+    if(this->cacheValid && time == this->cachedTime){
+        return this->sinValues;
+    }
+    const arma::uword numElements = this->angularFrequencies.n_elem;
+    const double* frequencies = this->angularFrequencies.memptr();
+    const double delta = time - this->cachedTime;
+    if(this->cacheValid && delta == this->rotationDelta && this->stepsSinceEvaluation < maxRotationsBetweenEvaluations){
+        // phase recurrence: sin(a + d) = sin(a)cos(d) + cos(a)sin(d), cos(a + d) = cos(a)cos(d) - sin(a)sin(d)
+        double* sines = this->sinValues.memptr();
+        double* cosines = this->cosValues.memptr();
+        if(this->uniformFrequency){
+            const double rotationCosine = this->rotationCos(0);
+            const double rotationSine = this->rotationSin(0);
+            #pragma omp simd
+            for(arma::uword i = 0; i < numElements; i++){
+                const double sine = sines[i];
+                sines[i] = sine*rotationCosine + cosines[i]*rotationSine;
+                cosines[i] = cosines[i]*rotationCosine - sine*rotationSine;
+            }
+        } else {
+            const double* rotationCosines = this->rotationCos.memptr();
+            const double* rotationSines = this->rotationSin.memptr();
+            #pragma omp simd
+            for(arma::uword i = 0; i < numElements; i++){
+                const double sine = sines[i];
+                sines[i] = sine*rotationCosines[i] + cosines[i]*rotationSines[i];
+                cosines[i] = cosines[i]*rotationCosines[i] - sine*rotationSines[i];
+            }
+        }
+        this->stepsSinceEvaluation++;
+    } else {
+        // direct evaluation, the rotation for the current time difference is precomputed for the next steps
+        this->sinValues.set_size(numElements);
+        this->cosValues.set_size(numElements);
+        double* sines = this->sinValues.memptr();
+        double* cosines = this->cosValues.memptr();
+        const double* phasesValues = this->phases.memptr();
+        #pragma omp simd
+        for(arma::uword i = 0; i < numElements; i++){
+            const double angle = frequencies[i]*time + phasesValues[i];
+            sines[i] = std::sin(angle);
+            cosines[i] = std::cos(angle);
+        }
+        if(!this->cacheValid || delta != this->rotationDelta){
+            const arma::uword numRotations = this->uniformFrequency ? 1 : numElements;
+            this->rotationSin.set_size(numRotations);
+            this->rotationCos.set_size(numRotations);
+            double* rotationSines = this->rotationSin.memptr();
+            double* rotationCosines = this->rotationCos.memptr();
+            #pragma omp simd
+            for(arma::uword i = 0; i < numRotations; i++){
+                rotationSines[i] = std::sin(frequencies[i]*delta);
+                rotationCosines[i] = std::cos(frequencies[i]*delta);
+            }
+            this->rotationDelta = delta;
+        }
+        this->stepsSinceEvaluation = 0;
+        this->cacheValid = true;
+    }
+    this->cachedTime = time;
+    return this->sinValues;
+}
+
 arma::Col<double> DissipationModelPeriodic::dissipate(arma::Col<double> input, double time){
-    arma::Col<double> output = arma::Col<double>(input.n_rows);
-    for(size_t i = 0; i < input.n_rows; i++){
-        output(i) = input(i) - this->amplitudes(i)*sin(2*arma::datum::pi/this->periods(i)*time + this->phases(i));
+    if(input.n_elem != this->angularFrequencies.n_elem){
+        throw std::invalid_argument("[ERROR] DissipationModelPeriodic::dissipate: input size " + std::to_string(input.n_elem) + " is different from the number of elements of the model " + std::to_string(this->angularFrequencies.n_elem) + ". abort");
     }
-    return output;
+    return input - this->amplitudes % this->sinValuesAt(time);
 }
 
 arma::Col<double> DissipationModelPeriodic::dissipationTerm(arma::Col<double> input, double time){
-    arma::Col<double> output = arma::Col<double>(input.n_rows);
-    for(size_t i = 0; i < input.n_rows; i++){
-        output(i) = this->amplitudes(i)*sin(2*arma::datum::pi/this->periods(i)*time + this->phases(i));
+    if(input.n_elem != this->angularFrequencies.n_elem){
+        throw std::invalid_argument("[ERROR] DissipationModelPeriodic::dissipationTerm: input size " + std::to_string(input.n_elem) + " is different from the number of elements of the model " + std::to_string(this->angularFrequencies.n_elem) + ". abort");
     }
-    return output;
-}
\ No newline at end of file
+    return this->amplitudes % this->sinValuesAt(time);
+}
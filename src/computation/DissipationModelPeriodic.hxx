@@ -5,6 +5,7 @@
  * @details The DissipationModelPeriodic class inherits from the DissipationModel class and implements periodic dissipation logic.
  * @details The periodic dissipation model uses a set of phases, periods, and amplitudes to compute the dissipation term.
  * @details The dissipation term is computed as a sum of sine functions with the given phases, periods, and amplitudes.
+ * @details The angular frequencies are precomputed, and between consecutive times with the same time difference the sines are updated with a rotation (phase recurrence) instead of being evaluated again.
  * @see DissipationModel.hxx
  */
 #pragma once
@@ -25,6 +26,27 @@ class DissipationModelPeriodic : public DissipationModel
         arma::Col<double> phases; ///< The phases of the sine functions used in the periodic dissipation model.
         arma::Col<double> periods; ///< The periods of the sine functions used in the periodic dissipation model.
         arma::Col<double> amplitudes; ///< The amplitudes of the sine functions used in the periodic dissipation model.
+        arma::Col<double> angularFrequencies; ///< The angular frequencies (2*pi/period) of the sine functions, precomputed at construction.
+        bool uniformFrequency = false; ///< true if all the elements share the same period, in which case the rotation between two times is the same for all the elements.
+        arma::Col<double> sinValues; ///< The sines of the elements at the cached time.
+        arma::Col<double> cosValues; ///< The cosines of the elements at the cached time, used for the rotation.
+        arma::Col<double> rotationSin; ///< The sines of the rotation angles (angular frequency * rotationDelta), one element if the frequency is uniform.
+        arma::Col<double> rotationCos; ///< The cosines of the rotation angles (angular frequency * rotationDelta), one element if the frequency is uniform.
+        double cachedTime = 0; ///< The time of the cached sines.
+        double rotationDelta = 0; ///< The time difference of the precomputed rotation.
+        int stepsSinceEvaluation = 0; ///< The number of rotations applied since the last direct evaluation, used to bound the accumulation of rounding errors.
+        bool cacheValid = false; ///< true if the cached sines are valid.
+        /**
+         * @brief Precompute the angular frequencies from the periods, and reset the cached sines.
+         */
+        void computeAngularFrequencies();
+        /**
+         * @brief Get the sines of all the elements at a given time.
+         * @param time The current time.
+         * @return A reference to the sines of the elements, sin(angularFrequency*time + phase).
+         * @details If the time difference from the cached time is the same as the previous one, the sines are updated with a rotation, otherwise they are evaluated directly.
+         */
+        const arma::Col<double>& sinValuesAt(double time);
     public:
         /**
          * @brief Default constructor for the DissipationModelPeriodic class.
@@ -0,0 +1,38 @@
+/**
+ * @file DissipationModelPlugin.cxx
+ * @ingroup Core
+ * @brief Implements the DissipationModelPlugin class, a dissipation model implemented by a plugin loaded at runtime.
+ */
+#include "computation/DissipationModelPlugin.hxx"
+#include <stdexcept>
+#include <string>
+
+DissipationModelPlugin::DissipationModelPlugin(std::shared_ptr<const ModelPlugin> plugin, size_t numNodes, const std::vector<double>& parameters):plugin(plugin){
+    if(!this->plugin){
+        throw std::invalid_argument("[ERROR] DissipationModelPlugin::DissipationModelPlugin: the plugin is not set. abort");
+    }
+    if(!this->plugin->provides(MASFENON_MODEL_DISSIPATION)){
+        throw std::invalid_argument("[ERROR] DissipationModelPlugin::DissipationModelPlugin: the plugin " + this->plugin->getName() + " does not implement a dissipation model. abort");
+    }
+    this->numEl = static_cast<int>(numNodes);
+    this->state = this->plugin->createState(MASFENON_MODEL_DISSIPATION, numNodes, nullptr, parameters);
+}
+
+DissipationModelPlugin::~DissipationModelPlugin(){
+    this->plugin->destroyState(this->state);
+}
+
+arma::Col<double> DissipationModelPlugin::dissipate(arma::Col<double> input, double time){
+    return input - this->dissipationTerm(input, time);
+}
+
+arma::Col<double> DissipationModelPlugin::dissipationTerm(arma::Col<double> input, double time){
+    // the plugin state and the output written by the plugin are sized for the nodes passed to the constructor
+    if(input.n_elem != static_cast<arma::uword>(this->numEl)){
+        throw std::invalid_argument("[ERROR] DissipationModelPlugin::dissipationTerm: the input is not of the same size as the nodes of the plugin (" + std::to_string(input.n_elem) + " != " + std::to_string(this->numEl) + "). abort");
+    }
+    arma::Col<double> output(input.n_elem);
+    int status = this->plugin->getDescriptor().dissipationTerm(this->state, input.memptr(), output.memptr(), input.n_elem, time);
+    this->plugin->checkStatus(status, "DissipationModelPlugin::dissipationTerm");
+    return output;
+}
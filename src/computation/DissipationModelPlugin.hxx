@@ -0,0 +1,58 @@
+/**
+ * @file DissipationModelPlugin.hxx
+ * @ingroup Core
+ * @brief Defines the DissipationModelPlugin class, a dissipation model implemented by a plugin loaded at runtime.
+ * @details The dissipation term of all the nodes is computed by the plugin in a single call, see ModelPluginABI.hxx.
+ */
+#pragma once
+#include <armadillo>
+#include <memory>
+#include <vector>
+#include "computation/DissipationModel.hxx"
+#include "computation/ModelPlugin.hxx"
+
+/**
+ * @class DissipationModelPlugin
+ * @brief Class for dissipation models implemented by a plugin.
+ * @details The dissipated values are input - term, where the term is computed by the plugin.
+ * @implements DissipationModel
+ */
+class DissipationModelPlugin : public DissipationModel
+{
+    private:
+        std::shared_ptr<const ModelPlugin> plugin; ///< The plugin, kept loaded while the model exists.
+        void* state = nullptr; ///< The state of the model created by the plugin.
+    public:
+        /**
+         * @brief Constructor for the DissipationModelPlugin class.
+         * @param plugin The plugin implementing the dissipation term.
+         * @param numNodes The number of nodes of the graph.
+         * @param parameters The parameters of the model, passed to the plugin.
+         * @throw std::invalid_argument if the plugin is nullptr or does not implement the dissipation term.
+         */
+        DissipationModelPlugin(std::shared_ptr<const ModelPlugin> plugin, size_t numNodes, const std::vector<double>& parameters = std::vector<double>());
+        /**
+         * @brief Destructor for the DissipationModelPlugin class, the state of the model is destroyed by the plugin.
+         */
+        ~DissipationModelPlugin();
+        DissipationModelPlugin(const DissipationModelPlugin&) = delete;
+        DissipationModelPlugin& operator=(const DissipationModelPlugin&) = delete;
+        /**
+         * @brief Applies the dissipation model to the input vector.
+         * @param input The input vector to be processed.
+         * @param time The current time.
+         * @return The input minus the dissipation term computed by the plugin.
+         * @throw std::invalid_argument if the input is not of the same size as the nodes of the plugin.
+         * @throw std::runtime_error if the plugin returns an error.
+         */
+        arma::Col<double> dissipate(arma::Col<double> input, double time)override;
+        /**
+         * @brief Computes the dissipation term of the input vector.
+         * @param input The input vector to be processed.
+         * @param time The current time.
+         * @return The dissipation term computed by the plugin.
+         * @throw std::invalid_argument if the input is not of the same size as the nodes of the plugin.
+         * @throw std::runtime_error if the plugin returns an error.
+         */
+        arma::Col<double> dissipationTerm(arma::Col<double> input, double time)override;
+};
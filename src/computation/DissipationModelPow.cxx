@@ -26,3 +26,9 @@ arma::Col<double> DissipationModelPow::dissipate(arma::Col<double> input, double
 arma::Col<double> DissipationModelPow::dissipationTerm(arma::Col<double> input, double time){
     return pow(input,this->power);
 }
+
+arma::Mat<double> DissipationModelPow::dissipateTangent(const arma::Mat<double>& tangent, const arma::Col<double>& input, double time){
+    arma::Mat<double> output = tangent;
+    output.each_col() %= (1 - this->power * pow(input, this->power - 1));
+    return output;
+}
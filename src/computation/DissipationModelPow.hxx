@@ -59,4 +59,17 @@ class DissipationModelPow : public DissipationModel
          * @details This function returns the power factor used in the power dissipation model.
          */
         double getPower(){return this->power;}
+        /**
+         * @brief Get the algebraic properties of the dissipation term.
+         * @return The properties of the model, the power dissipation does not depend on the time.
+         */
+        ModelProperties getProperties() const override {return ModelProperties::timeInvariantTerm();}
+        /**
+         * @brief Apply the derivative of the power dissipation to the tangent vectors, every row is scaled by (1 - power*input^(power-1)).
+         * @param tangent The tangent vectors (nodes x parameters).
+         * @param input The input vector where the derivative is computed.
+         * @param time The current time.
+         * @return The derivative of the dissipated vector with respect to the parameters.
+         */
+        arma::Mat<double> dissipateTangent(const arma::Mat<double>& tangent, const arma::Col<double>& input, double time)override;
 };
\ No newline at end of file
@@ -6,6 +6,7 @@
  * @details The random dissipation model uses a range of values to compute the dissipation term.
  */
 #include "computation/DissipationModelRandom.hxx"
+#include "utils/mathUtilities.hxx"
 #include <cstddef>
 
 DissipationModelRandom::DissipationModelRandom(){
@@ -18,21 +19,26 @@ DissipationModelRandom::DissipationModelRandom(double rangeMin, double rangeMax)
     this->rangeMax = rangeMax;
 }
 
+DissipationModelRandom::DissipationModelRandom(double rangeMin, double rangeMax, uint64_t seed, uint64_t stream){
+    this->rangeMin = rangeMin;
+    this->rangeMax = rangeMax;
+    this->seed = seed;
+    this->stream = stream;
+}
+
 DissipationModelRandom::~DissipationModelRandom(){
 }
 
+arma::Col<double> DissipationModelRandom::randomFactors(arma::uword numElements, double time) const{
+    arma::Col<double> factors(numElements);
+    counterBasedRealNumberFill(factors.memptr(), numElements, this->seed, this->stream, timeToCounter(time), this->rangeMin, this->rangeMax);
+    return factors;
+}
+
 arma::Col<double> DissipationModelRandom::dissipate(arma::Col<double> input, double time){
-    arma::Col<double> output = arma::Col<double>(input.n_rows);
-    for(size_t i = 0; i < input.n_rows; i++){
-        output(i) = input(i) - input(i)*(this->rangeMin + static_cast <float> (rand()) /( static_cast <float> (RAND_MAX/(this->rangeMax-this->rangeMin))));
-    }
-    return output;
+    return input - input % this->randomFactors(input.n_elem, time);
 }
 
 arma::Col<double> DissipationModelRandom::dissipationTerm(arma::Col<double> input, double time){
-    arma::Col<double> output = arma::Col<double>(input.n_rows);
-    for(size_t i = 0; i < input.n_rows; i++){
-        output(i) = input(i)*(this->rangeMin + static_cast <float> (rand()) /( static_cast <float> (RAND_MAX/(this->rangeMax-this->rangeMin))));
-    }
-    return output;
-}
\ No newline at end of file
+    return input % this->randomFactors(input.n_elem, time);
+}
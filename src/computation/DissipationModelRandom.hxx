@@ -5,9 +5,11 @@
  * @details The DissipationModelRandom class inherits from the DissipationModel class and implements random dissipation logic.
  * @details The random dissipation model uses a range of values to compute the dissipation term.
  * @details The dissipation term is computed as a random value between the given range, for every single element.
+ * @details The random values are generated with a counter-based generator keyed by (seed, stream, node, time), so the results are reproducible independently of the number of ranks and threads.
  */
 #pragma once
 #include <armadillo>
+#include <cstdint>
 #include "computation/DissipationModel.hxx"
 
 /**
@@ -23,6 +25,15 @@ class DissipationModelRandom : public DissipationModel
     private:
         double rangeMin; ///< The minimum value of the range used in the random dissipation model.
         double rangeMax; ///< The maximum value of the range used in the random dissipation model.
+        uint64_t seed = 777; ///< The seed of the counter-based random generator.
+        uint64_t stream = 0; ///< The stream of the counter-based random generator, different types should use different streams (e.g. the global index of the type).
+        /**
+         * @brief Generate the random dissipation factors for every element at a given time.
+         * @param numElements The number of elements.
+         * @param time The current time.
+         * @return The random factors in [rangeMin, rangeMax).
+         */
+        arma::Col<double> randomFactors(arma::uword numElements, double time) const;
     public:
         /**
          * @brief Default constructor for the DissipationModelRandom class.
@@ -36,11 +47,30 @@ class DissipationModelRandom : public DissipationModel
          * @details Initializes the random dissipation model with the given values.
          */
         DissipationModelRandom(double rangeMin, double rangeMax);
+        /**
+         * @brief Constructor for the DissipationModelRandom class, passing the seed and the stream of the random generator.
+         * @param rangeMin The minimum value of the range used in the random dissipation model.
+         * @param rangeMax The maximum value of the range used in the random dissipation model.
+         * @param seed The seed of the counter-based random generator.
+         * @param stream The stream of the counter-based random generator, different types should use different streams (e.g. the global index of the type).
+         * @details The same seed and stream always produce the same random values for the same node and time.
+         */
+        DissipationModelRandom(double rangeMin, double rangeMax, uint64_t seed, uint64_t stream = 0);
         /**
          * @brief Destructor for the DissipationModelRandom class.
          * @details Cleans up any resources used by the class.
          */
         ~DissipationModelRandom();
+        /**
+         * @brief Set the seed of the counter-based random generator, the stream is kept.
+         * @param seed The new seed, e.g. a different seed for every replicate of a stochastic simulation.
+         */
+        void setSeed(uint64_t seed){this->seed = seed;}
+        /**
+         * @brief Get the seed of the counter-based random generator.
+         * @return The seed.
+         */
+        uint64_t getSeed() const {return seed;}
         /**
          * @brief Applies the random dissipation model to the input vector.
          * @param input The input vector to be processed.
@@ -12,6 +12,14 @@ DissipationModelScaled::DissipationModelScaled(){
     this->scaleFunction = [](double time)-> double{return 0.5;};
     this->numEl = 0;
     this->scaleFunctionVectorized = [](double time)-> arma::Col<double>{return arma::Mat<double>(0,0);}; // using a column vector with 0 elements as a placeholder
+    this->properties = ModelProperties::constant(0.5);
+}
+
+DissipationModelScaled::DissipationModelScaled(double constantScale){
+    this->scaleFunction = [constantScale](double time)-> double{return constantScale;};
+    this->numEl = 0;
+    this->scaleFunctionVectorized = [](double time)-> arma::Col<double>{return arma::Mat<double>(0,0);};
+    this->properties = ModelProperties::constant(constantScale);
 }
 
 DissipationModelScaled::~DissipationModelScaled(){
@@ -29,36 +37,58 @@ DissipationModelScaled::DissipationModelScaled(std::function<arma::Col<double>(d
     this->numEl = this->scaleFunctionVectorized(0).n_elem; // initialize the number of elements based on the scale function
 }
 
-arma::Col<double> DissipationModelScaled::dissipate(arma::Col<double> input, double time){
-    uint numElem = input.n_elem;
+const arma::Col<double>& DissipationModelScaled::scaleValues(double time, arma::uword numElem){
+    if(this->scaleSchedule && this->scaleSchedule->getNumElements() == numElem){
+        const arma::Col<double>* scheduledValues = this->scaleSchedule->at(time);
+        if(scheduledValues != nullptr){
+            return *scheduledValues;
+        }
+    }
     // initializing the vectorized scale function if it was not initialized before (we have the number of elements now in the input)
-    //if (this->scaleFunctionVectorized(0).n_elem == 0) {
-    if (this->scaleFunctionVectorized(0).n_elem != numElem) {
-        //this->scaleFunctionVectorized = [scaleFunction = scaleFunction,input](double time)-> arma::Mat<double>{
-            //arma::Mat<double> scaleMatrix = arma::diagmat(arma::ones<arma::Col<double>>(input.n_elem) * scaleFunction(time));
+    if (this->numEl < 0 || static_cast<arma::uword>(this->numEl) != numElem) {
         this->scaleFunctionVectorized = [scaleFunction = scaleFunction, numElem = numElem](double time)-> arma::Col<double>{
-            //arma::Mat<double> scaleMatrix = arma::diagmat(arma::ones<arma::Col<double>>(input.n_elem) * 1.0); // using 1.0 as a placeholder, since we will multiply it later with the scale function value
             arma::Col<double> scaleValues = arma::ones<arma::Col<double>>(numElem) * scaleFunction(time);
             return scaleValues;
-        };  
+        };
+        this->numEl = numElem;
     }
+    this->scaleBuffer = this->scaleFunctionVectorized(time);
+    return this->scaleBuffer;
+}
+
+std::function<arma::Col<double>(double)> DissipationModelScaled::scheduleScaleFunction(arma::uword numElements){
+    if (this->numEl >= 0 && static_cast<arma::uword>(this->numEl) == numElements) {
+        return this->scaleFunctionVectorized;
+    }
+    std::function<double(double)> scaleFunction = this->scaleFunction;
+    return [scaleFunction, numElements](double time)-> arma::Col<double>{
+        return arma::ones<arma::Col<double>>(numElements) * scaleFunction(time);
+    };
+}
+
+arma::Col<double> DissipationModelScaled::dissipate(arma::Col<double> input, double time){
     // return input - (this->scaleFunction(time)*input);
-    return input - this->scaleFunctionVectorized(time) % input;
+    return input - this->scaleValues(time, input.n_elem) % input;
 }
 
 arma::Col<double> DissipationModelScaled::dissipationTerm(arma::Col<double> input, double time){
-    uint numElem = input.n_elem;
-    // initializing the vectorized scale function if it was not initialized before (we have the number of elements now in the input)
-    //if (this->scaleFunctionVectorized(0).n_elem == 0) {
-    if (this->scaleFunctionVectorized(0).n_elem != numElem) {
-        //this->scaleFunctionVectorized = [scaleFunction = scaleFunction,input](double time)-> arma::Mat<double>{
-            //arma::Mat<double> scaleMatrix = arma::diagmat(arma::ones<arma::Col<double>>(input.n_elem) * scaleFunction(time));
-        this->scaleFunctionVectorized = [scaleFunction = scaleFunction, numElem = numElem](double time)-> arma::Col<double>{
-            //arma::Mat<double> scaleMatrix = arma::diagmat(arma::ones<arma::Col<double>>(input.n_elem) * 1.0); // using 1.0 as a placeholder, since we will multiply it later with the scale function value
-            arma::Col<double> scaleValues = arma::ones<arma::Col<double>>(numElem) * scaleFunction(time);
-            return scaleValues;
-        };  
-    }
     // return this->scaleFunction(time)*input;
-    return this->scaleFunctionVectorized(time) % input;
+    return this->scaleValues(time, input.n_elem) % input;
+}
+
+void DissipationModelScaled::setScaleFunctionVectorized(std::function<arma::Col<double>(double)> scaleFun){
+    this->scaleFunctionVectorized = scaleFun;
+    this->numEl = this->scaleFunctionVectorized(0).n_elem;
+    this->properties = ModelProperties::generic();
+    this->clearScaleSchedule();
+}
+
+arma::Mat<double> DissipationModelScaled::dissipateTangent(const arma::Mat<double>& tangent, const arma::Col<double>& input, double time){
+    arma::Mat<double> output = tangent;
+    output.each_col() %= (1 - this->scaleValues(time, input.n_elem));
+    return output;
+}
+
+arma::Col<double> DissipationModelScaled::dissipateScaleDerivative(const arma::Col<double>& input, double time){
+    return -input;
 }
@@ -27,6 +27,18 @@ class DissipationModelScaled : public DissipationModel
     private:
         std::function<double(double)> scaleFunction; ///< The function to scale the dissipation term. It takes a double value (time) and returns a double value.
         std::function<arma::Col<double>(double)> scaleFunctionVectorized; ///< The function to scale the dissipation term for vectorized operations. It takes a double value (time) and returns a vector of double values (scaling values).
+        arma::Col<double> scaleBuffer; ///< Buffer for the scaling values of the times that are not precomputed in the schedule.
+        ModelProperties properties; ///< The algebraic properties of the dissipation term, constant only if the model was built with a constant scale.
+        /**
+         * @brief Get the scaling values at a given time.
+         * @param time The current time.
+         * @param numElem The number of elements of the input vector.
+         * @return A reference to the precomputed scaling values if the time is in the schedule, otherwise to the buffer with the evaluated scale function.
+         * @details The vectorized scale function is built from the scalar one when the number of elements changes.
+         */
+        const arma::Col<double>& scaleValues(double time, arma::uword numElem);
+    protected:
+        std::function<arma::Col<double>(double)> scheduleScaleFunction(arma::uword numElements)override;
     public:
         // default constructor uses scaleFunction = 0.5
         /**
@@ -40,6 +52,12 @@ class DissipationModelScaled : public DissipationModel
          * @details Initializes the scale function to the provided value.
          */
         DissipationModelScaled(std::function<double(double)> scaleFunc);
+        /**
+         * @brief Constructor for the DissipationModelScaled class with a constant scale.
+         * @param constantScale The constant value of the scale function.
+         * @details The model advertises the constant scale in its properties, so that the computation can simplify the step (or skip it if the scale is 0).
+         */
+        DissipationModelScaled(double constantScale);
         /**
          * @brief Constructor for the DissipationModelScaled class, passing a scaling function that uses vectorized operations.
          * @param scaleFunction The function to scale the dissipation term. It takes a double value (time) and returns a vector of double values (scaling values).
@@ -73,4 +91,30 @@ class DissipationModelScaled : public DissipationModel
          * @details This function returns the scale function used in the scaled dissipation model.
          */
         double getScale(double time){return scaleFunction(time);}
+        /**
+         * @brief Replace the vectorized scale function of the model.
+         * @param scaleFunctionVectorized The new vectorized scale function, returning the scaling values of every node at a given time.
+         * @details The precomputed scaling values are removed and the model is no longer advertised as constant.
+         */
+        void setScaleFunctionVectorized(std::function<arma::Col<double>(double)> scaleFunctionVectorized)override;
+        /**
+         * @brief Get the algebraic properties of the dissipation term.
+         * @return The properties of the model, constant if the model was built with a constant scale (also the default constructor).
+         */
+        ModelProperties getProperties() const override {return this->properties;}
+        /**
+         * @brief Apply the derivative of the scaled dissipation to the tangent vectors, every row is scaled by (1 - scale).
+         * @param tangent The tangent vectors (nodes x parameters).
+         * @param input The input vector, used only for its size.
+         * @param time The current time.
+         * @return The derivative of the dissipated vector with respect to the parameters.
+         */
+        arma::Mat<double> dissipateTangent(const arma::Mat<double>& tangent, const arma::Col<double>& input, double time)override;
+        /**
+         * @brief Get the derivative of the dissipated vector with respect to the scaling value of every node, that is -input.
+         * @param input The input vector.
+         * @param time The current time.
+         * @return The vector of the derivatives.
+         */
+        arma::Col<double> dissipateScaleDerivative(const arma::Col<double>& input, double time)override;
 };
\ No newline at end of file
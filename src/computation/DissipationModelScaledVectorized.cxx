@@ -1,6 +1,42 @@
 /**
  * @file DissipationModelScaledVectorized.cxx
  * @ingroup Experimental
- * @brief Implements the DissipationModelScaledVectorized class used for managing vectorized scaled dissipation dynamics for the computation of the perturbation in MASFENON. This class is an abstract class.
+ * @brief Implements the DissipationModelScaledVectorized class used for managing vectorized scaled dissipation dynamics for the computation of the perturbation in MASFENON.
  */
-#include "computation/DissipationModelScaledVectorized.hxx"
\ No newline at end of file
+#include "computation/DissipationModelScaledVectorized.hxx"
+#include <stdexcept>
+#include <string>
+
+DissipationModelScaledVectorized::DissipationModelScaledVectorized(){
+    this->scaleFunction = [](double time)-> double{return 0.5;};
+    this->numEl = 0;
+}
+
+DissipationModelScaledVectorized::DissipationModelScaledVectorized(std::function<double(double)> scaleFunc):scaleFunction(scaleFunc){
+    this->numEl = 0;
+}
+
+DissipationModelScaledVectorized::DissipationModelScaledVectorized(std::function<arma::Row<double>(double)> scaleFunc):scaleFunctionScenarios(scaleFunc){
+    // the shared scale is the mean of the scenarios, only used by getScale
+    this->scaleFunction = [scaleFunc](double time)-> double{return arma::mean(scaleFunc(time));};
+    this->numEl = 0;
+}
+
+DissipationModelScaledVectorized::~DissipationModelScaledVectorized(){
+}
+
+arma::Mat<double> DissipationModelScaledVectorized::dissipate(arma::Mat<double> input, double time){
+    return input - this->dissipationTerm(input, time);
+}
+
+arma::Mat<double> DissipationModelScaledVectorized::dissipationTerm(arma::Mat<double> input, double time){
+    if(!this->scaleFunctionScenarios){
+        return this->scaleFunction(time) * input;
+    }
+    arma::Row<double> scales = this->scaleFunctionScenarios(time);
+    if(scales.n_elem != input.n_cols){
+        throw std::invalid_argument("[ERROR] DissipationModelScaledVectorized::dissipationTerm: the number of scaling values is not the number of scenarios: " + std::to_string(scales.n_elem) + "!=" + std::to_string(input.n_cols) + ". abort");
+    }
+    input.each_row() %= scales;
+    return input;
+}
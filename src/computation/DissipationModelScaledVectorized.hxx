@@ -1,30 +1,31 @@
 /**
  * @file DissipationModelScaledVectorized.hxx
  * @ingroup Experimental
- * @brief Defines the DissipationModelScaledVectorized class used for managing vectorized scaled dissipation dynamics for the computation of the perturbation in MASFENON. This class is an abstract class.
- * @warning This class is not yet implemented.
+ * @brief Defines the DissipationModelScaledVectorized class used for managing vectorized scaled dissipation dynamics for the computation of the perturbation in MASFENON.
+ * @details The input is a matrix (nodes x scenarios), the scale can be shared by all the scenarios or defined per scenario (for example to run different parameter sets together).
  * @details The scaled dissipation class uses a scale function to determine the scaling of the dissipation term. The scale function can be set and modified as needed.
  * @details To set the scale function, @see CustomFunctions.hxx
  * @todo Make it stateful. Related to issue #28
  */
 #pragma once
 #include <armadillo>
+#include <functional>
 #include "computation/DissipationModelVectorized.hxx"
 
 /**
  * @class DissipationModelScaledVectorized
  * @brief Dissipation model implementation for scaled vectorized dissipation dynamics.
  * @details This class provides methods for applying scaled vectorized dissipation logic to the perturbation computation.
- * @warning This class is not yet implemented.
  * @details The scaled dissipation class uses a scale function to determine the scaling of the dissipation term. The scale function can be set and modified as needed.
  * @details To set the scale function, @see CustomFunctions.hxx
+ * @details The scaling values can be defined per scenario (columns of the input matrix), in that case they are shared between the nodes (rows of the input matrix).
  * @todo Make it stateful. Related to issue #28
- * @todo Implement the dissipation model logic and vectorization. Related to issue #5
  */
 class DissipationModelScaledVectorized : public DissipationModelVectorized
 {
     private:
         std::function<double(double)> scaleFunction; ///< The scale function used to determine the scaling of the dissipation term. This function can be set and modified as needed.
+        std::function<arma::Row<double>(double)> scaleFunctionScenarios; ///< The function to scale the dissipation term for every scenario. It takes a double value (time) and returns a row of double values (one per scenario), empty if the scale is shared.
     public:
         // default constructor uses scaleFunction = 0.5
         /**
@@ -38,6 +39,11 @@ class DissipationModelScaledVectorized : public DissipationModelVectorized
          * @details This constructor initializes the scale function to the provided custom value.
          */
         DissipationModelScaledVectorized(std::function<double(double)> scaleFunc);
+        /**
+         * @brief Constructor for the DissipationModelScaledVectorized class with a scale function per scenario.
+         * @param scaleFunc The scale function to be used in the dissipation model, returning one scaling value for every scenario (column of the input matrix).
+         */
+        DissipationModelScaledVectorized(std::function<arma::Row<double>(double)> scaleFunc);
         /**
          * @brief Default destructor for the DissipationModelScaledVectorized class.
          * @details Cleans up the resources used by the DissipationModelScaledVectorized class.
@@ -49,6 +55,7 @@ class DissipationModelScaledVectorized : public DissipationModelVectorized
          * @param time The current time.
          * @return The output vector after applying the dissipation model.
          * @details This function is used to compute the final output of the dissipation model.
+         * @throw std::invalid_argument if the scale is defined per scenario and the number of scaling values is not the number of columns of the input.
          */
         arma::Mat<double> dissipate(arma::Mat<double> input, double time)override;
         /**
@@ -57,12 +64,13 @@ class DissipationModelScaledVectorized : public DissipationModelVectorized
          * @param time The current time.
          * @return The dissipation term vector.
          * @details This function is used to compute the dissipation term of the input vector.
+         * @throw std::invalid_argument if the scale is defined per scenario and the number of scaling values is not the number of columns of the input.
          */
         arma::Mat<double> dissipationTerm(arma::Mat<double> input, double time)override;
         /**
          * @brief Get the scale value at a given time.
          * @param time The current time.
-         * @return The scale value at the given time.
+         * @return The scale value at the given time, the mean of the scenarios if the scale is defined per scenario.
          * @details This function is used to get the scale value at a given time.
          */
         double getScale(double time){return scaleFunction(time);}
@@ -0,0 +1,69 @@
+/**
+ * @file ModelPlugin.cxx
+ * @ingroup Core
+ * @brief Implements the ModelPlugin class, the loading of the shared objects implementing custom models.
+ */
+#include "computation/ModelPlugin.hxx"
+#include <dlfcn.h>
+#include <stdexcept>
+
+ModelPlugin::ModelPlugin(const std::string& path):path(path){
+    handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if(handle == nullptr){
+        const char* error = dlerror();
+        throw std::invalid_argument("[ERROR] ModelPlugin::ModelPlugin: cannot load the plugin " + path + ": " + (error ? error : "unknown error") + ". abort");
+    }
+    MasfenonModelPluginEntry entry = reinterpret_cast<MasfenonModelPluginEntry>(dlsym(handle, MASFENON_MODEL_PLUGIN_SYMBOL));
+    if(entry == nullptr){
+        dlclose(handle);
+        throw std::invalid_argument("[ERROR] ModelPlugin::ModelPlugin: the plugin " + path + " does not export the function " + MASFENON_MODEL_PLUGIN_SYMBOL + ". abort");
+    }
+    descriptor = entry();
+    if(descriptor == nullptr){
+        dlclose(handle);
+        throw std::invalid_argument("[ERROR] ModelPlugin::ModelPlugin: the plugin " + path + " returned no descriptor. abort");
+    }
+    if(descriptor->abiVersion != MASFENON_MODEL_PLUGIN_ABI_VERSION){
+        uint32_t version = descriptor->abiVersion;
+        dlclose(handle);
+        throw std::invalid_argument("[ERROR] ModelPlugin::ModelPlugin: the plugin " + path + " was built for the version " + std::to_string(version) + " of the interface, expected " + std::to_string(MASFENON_MODEL_PLUGIN_ABI_VERSION) + ". abort");
+    }
+}
+
+ModelPlugin::~ModelPlugin(){
+    if(handle != nullptr){
+        dlclose(handle);
+    }
+}
+
+std::string ModelPlugin::getName() const{
+    return descriptor->name != nullptr ? std::string(descriptor->name) : path;
+}
+
+bool ModelPlugin::provides(MasfenonModelKind kind) const{
+    switch(kind){
+        case MASFENON_MODEL_DISSIPATION: return descriptor->dissipationTerm != nullptr;
+        case MASFENON_MODEL_CONSERVATION: return descriptor->conservationTerm != nullptr;
+        case MASFENON_MODEL_PROPAGATION: return descriptor->propagationTerm != nullptr;
+    }
+    return false;
+}
+
+void* ModelPlugin::createState(MasfenonModelKind kind, size_t numNodes, const double* adjacency, const std::vector<double>& parameters) const{
+    if(descriptor->create == nullptr){
+        return nullptr;
+    }
+    return descriptor->create(kind, numNodes, adjacency, parameters.data(), parameters.size());
+}
+
+void ModelPlugin::destroyState(void* state) const{
+    if(descriptor->destroy != nullptr){
+        descriptor->destroy(state);
+    }
+}
+
+void ModelPlugin::checkStatus(int status, const std::string& caller) const{
+    if(status != 0){
+        throw std::runtime_error("[ERROR] " + caller + ": the plugin " + getName() + " returned the error code " + std::to_string(status) + ". abort");
+    }
+}
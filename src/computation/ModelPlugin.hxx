@@ -0,0 +1,79 @@
+/**
+ * @file ModelPlugin.hxx
+ * @ingroup Core
+ * @brief Defines the ModelPlugin class, a shared object loaded at runtime that implements custom models through the interface in ModelPluginABI.hxx.
+ * @details The models built from a plugin (DissipationModelPlugin, ConservationModelPlugin, PropagationModelPlugin) share the ModelPlugin,
+ * so that the shared object stays loaded until the last model is destroyed.
+ */
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "computation/ModelPluginABI.hxx"
+
+/**
+ * @class ModelPlugin
+ * @brief Shared object implementing custom models, loaded with dlopen.
+ * @details The plugin is checked when loaded: the entry point must exist and the version of the interface must be the same as the one MASFENON was built with.
+ */
+class ModelPlugin{
+    private:
+        std::string path; ///< the path of the shared object
+        void* handle = nullptr; ///< the handle returned by dlopen
+        const MasfenonModelPlugin* descriptor = nullptr; ///< the descriptor returned by the entry point of the plugin
+    public:
+        /**
+         * @brief Load a plugin.
+         * @param path The path of the shared object.
+         * @throw std::invalid_argument if the shared object cannot be loaded, does not export the entry point or was built for another version of the interface.
+         */
+        explicit ModelPlugin(const std::string& path);
+        /**
+         * @brief Unload the plugin.
+         */
+        ~ModelPlugin();
+        ModelPlugin(const ModelPlugin&) = delete;
+        ModelPlugin& operator=(const ModelPlugin&) = delete;
+        /**
+         * @brief Get the descriptor of the plugin.
+         * @return The descriptor, with the functions implemented by the plugin.
+         */
+        const MasfenonModelPlugin& getDescriptor() const {return *descriptor;}
+        /**
+         * @brief Get the name of the plugin.
+         * @return The name declared by the plugin, the path if the plugin has no name.
+         */
+        std::string getName() const;
+        /**
+         * @brief Get the path of the plugin.
+         * @return The path of the shared object.
+         */
+        const std::string& getPath() const {return path;}
+        /**
+         * @brief Check if the plugin implements a kind of model.
+         * @param kind The kind of model.
+         * @return true if the function computing the term of the model is implemented.
+         */
+        bool provides(MasfenonModelKind kind) const;
+        /**
+         * @brief Create the state of a model.
+         * @param kind The kind of model.
+         * @param numNodes The number of nodes of the graph.
+         * @param adjacency The adjacency matrix of the graph, nullptr for the dissipation and conservation models.
+         * @param parameters The parameters of the model.
+         * @return The state, nullptr if the plugin does not use a state.
+         */
+        void* createState(MasfenonModelKind kind, size_t numNodes, const double* adjacency, const std::vector<double>& parameters) const;
+        /**
+         * @brief Destroy the state of a model.
+         * @param state The state returned by createState.
+         */
+        void destroyState(void* state) const;
+        /**
+         * @brief Check the status returned by a function of the plugin.
+         * @param status The status returned by the function.
+         * @param caller The name of the caller, used in the error message.
+         * @throw std::runtime_error if the status is not 0.
+         */
+        void checkStatus(int status, const std::string& caller) const;
+};
@@ -0,0 +1,114 @@
+/**
+ * @file ModelPluginABI.hxx
+ * @ingroup Core
+ * @brief Defines the C interface of the model plugins, shared objects loaded at runtime that implement custom dissipation, conservation and propagation models.
+ * @details The header only uses C types, so that a plugin can be written in C or C++ (or any language able to export C symbols) and built without the MASFENON sources.
+ * @details A plugin exports a function named masfenonModelPlugin (MASFENON_MODEL_PLUGIN_SYMBOL) returning a pointer to a static MasfenonModelPlugin descriptor.
+ * The functions of the descriptor compute the terms of the models for all the nodes of a graph in a single call, so that the plugin can vectorize its loops.
+ * @details The matrices are stored in column-major order (the layout of Armadillo): the element (i,j) of a matrix with n rows is at index i + j*n.
+ * @details Example of a plugin implementing a dissipation model:
+ * @code
+ * static int dissipationTerm(void* state, const double* input, double* output, size_t numNodes, double time){
+ *     for(size_t i = 0; i < numNodes; i++) output[i] = 0.1 * input[i];
+ *     return 0;
+ * }
+ * static const MasfenonModelPlugin descriptor = {MASFENON_MODEL_PLUGIN_ABI_VERSION, "example", NULL, NULL, dissipationTerm, NULL, NULL, NULL};
+ * extern "C" const MasfenonModelPlugin* masfenonModelPlugin(void){ return &descriptor; }
+ * @endcode
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The version of the interface, a plugin built for another version is refused when loaded.
+ */
+#define MASFENON_MODEL_PLUGIN_ABI_VERSION 1u
+/**
+ * @brief The name of the function exported by the plugins.
+ */
+#define MASFENON_MODEL_PLUGIN_SYMBOL "masfenonModelPlugin"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The kinds of models, passed to the create function of the plugin.
+ */
+typedef enum MasfenonModelKind{
+    MASFENON_MODEL_DISSIPATION = 1, ///< dissipation model
+    MASFENON_MODEL_CONSERVATION = 2, ///< conservation model
+    MASFENON_MODEL_PROPAGATION = 3 ///< propagation model
+} MasfenonModelKind;
+
+/**
+ * @brief The descriptor of a plugin, the functions that are not implemented are NULL.
+ * @details All the functions returning int return 0 on success and a non-zero error code otherwise.
+ */
+typedef struct MasfenonModelPlugin{
+    uint32_t abiVersion; ///< MASFENON_MODEL_PLUGIN_ABI_VERSION of the header used to build the plugin
+    const char* name; ///< name of the plugin, used in the logs
+    /**
+     * @brief Create the state of a model (optional).
+     * @details Called once for every model built from the plugin, for example to precompute an operator from the adjacency matrix.
+     * @param kind the kind of the model
+     * @param numNodes the number of nodes of the graph
+     * @param adjacency the adjacency matrix of the graph (numNodes x numNodes, the element (i,j) is the weight of the edge i->j), NULL for the dissipation and conservation models
+     * @param parameters the parameters of the model passed from the command line
+     * @param numParameters the number of parameters
+     * @return the state passed to the other functions, NULL is a valid state (returned when no state is needed)
+     */
+    void* (*create)(int kind, size_t numNodes, const double* adjacency, const double* parameters, size_t numParameters);
+    /**
+     * @brief Destroy the state of a model (optional).
+     * @param state the state returned by create
+     */
+    void (*destroy)(void* state);
+    /**
+     * @brief Compute the dissipation term, the dissipated values are input - output.
+     * @param state the state of the model
+     * @param input the values of the nodes
+     * @param output the dissipation term of the nodes, written by the plugin
+     * @param numNodes the number of nodes
+     * @param time the current time
+     */
+    int (*dissipationTerm)(void* state, const double* input, double* output, size_t numNodes, double time);
+    /**
+     * @brief Compute the conservation term, the conserved values are inputDissipated - output.
+     * @param state the state of the model
+     * @param input the values of the nodes
+     * @param Wstar the normalized adjacency matrix of the graph (numNodes x numNodes)
+     * @param q the weights of the nodes, all ones if not specified
+     * @param output the conservation term of the nodes, written by the plugin
+     * @param numNodes the number of nodes
+     * @param time the current time
+     */
+    int (*conservationTerm)(void* state, const double* input, const double* Wstar, const double* q, double* output, size_t numNodes, double time);
+    /**
+     * @brief Compute the propagation term, the propagated values are input + output.
+     * @param state the state of the model
+     * @param input the values of the nodes
+     * @param output the propagation term of the nodes, written by the plugin
+     * @param numNodes the number of nodes
+     * @param time the current time
+     */
+    int (*propagationTerm)(void* state, const double* input, double* output, size_t numNodes, double time);
+    /**
+     * @brief Update the state of a propagation model after the edge weights of the graph have changed (optional).
+     * @details If NULL, the state is destroyed and created again with the new adjacency matrix.
+     * @param state the state of the model
+     * @param adjacency the new adjacency matrix of the graph (numNodes x numNodes)
+     * @param numNodes the number of nodes
+     */
+    int (*updateAdjacency)(void* state, const double* adjacency, size_t numNodes);
+} MasfenonModelPlugin;
+
+/**
+ * @brief Type of the function exported by the plugins.
+ */
+typedef const MasfenonModelPlugin* (*MasfenonModelPluginEntry)(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,50 @@
+/**
+ * @file ModelProperties.hxx
+ * @ingroup Core
+ * @brief Defines the ModelProperties structure used by the dissipation and conservation models to advertise the algebraic properties of their terms.
+ * @details The computation reads the properties of the models to specialize the step, e.g. a term that is identically zero is not computed at all,
+ * and a term scaled by a constant does not need the scale function to be evaluated at every step.
+ */
+#pragma once
+
+/**
+ * @struct ModelProperties
+ * @brief Algebraic properties of the term computed by a model.
+ * @details The properties are conservative: a model that cannot guarantee a property advertises the generic properties (all false).
+ */
+struct ModelProperties{
+    bool zero = false; ///< the term of the model is identically zero, at every time and for every input
+    bool identity = false; ///< applying the model returns its input unchanged (dissipate(input) == input, conservate(input, inputDissipated, ...) == inputDissipated)
+    bool constantScale = false; ///< the scale of the term is the same scalar (constantValue) for every element and every time
+    double constantValue = 0; ///< the constant scale of the term, meaningful only if constantScale is true
+    bool timeInvariant = false; ///< the term does not depend on the time
+
+    /**
+     * @brief Get the properties of a generic model, no property is guaranteed.
+     * @return The generic properties.
+     */
+    static ModelProperties generic(){return ModelProperties();}
+    /**
+     * @brief Get the properties of a model whose term is scaled by a constant.
+     * @param value The constant scale.
+     * @return The properties, zero and identity are set if the constant is 0.
+     */
+    static ModelProperties constant(double value){
+        ModelProperties properties;
+        properties.constantScale = true;
+        properties.constantValue = value;
+        properties.timeInvariant = true;
+        properties.zero = (value == 0);
+        properties.identity = properties.zero;
+        return properties;
+    }
+    /**
+     * @brief Get the properties of a model whose term does not depend on the time.
+     * @return The properties.
+     */
+    static ModelProperties timeInvariantTerm(){
+        ModelProperties properties;
+        properties.timeInvariant = true;
+        return properties;
+    }
+};
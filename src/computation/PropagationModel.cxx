@@ -6,5 +6,40 @@
  * @details The propagation class uses a scale function to determine the scaling of the propagation term. The scale function can be set and modified as needed.
  */
 #include "computation/PropagationModel.hxx"
+#include <stdexcept>
 
+const arma::Col<double>& PropagationModel::scaleValues(double time, arma::uword numElem, const std::function<arma::Col<double>(double)>& scaleFunctionVectorized){
+    if(this->scaleSchedule && this->scaleSchedule->getNumElements() == numElem){
+        const arma::Col<double>* scheduledValues = this->scaleSchedule->at(time);
+        if(scheduledValues != nullptr){
+            return *scheduledValues;
+        }
+    }
+    this->scaleBuffer = scaleFunctionVectorized(time);
+    return this->scaleBuffer;
+}
 
+bool PropagationModel::precomputeScaleSchedule(const std::vector<double>& times, arma::uword numElements, ScaleSchedulePool* pool){
+    std::function<arma::Col<double>(double)> scaleFunctionVectorized = this->scheduleScaleFunction();
+    if(!scaleFunctionVectorized){
+        return false;
+    }
+    if(pool != nullptr){
+        this->scaleSchedule = pool->getSchedule(times, scaleFunctionVectorized, numElements);
+    } else {
+        this->scaleSchedule = std::make_shared<const ScaleSchedule>(times, scaleFunctionVectorized, numElements);
+    }
+    return true;
+}
+
+void PropagationModel::setScaleFunctionVectorized(std::function<arma::Col<double>(double)> scaleFunctionVectorized){
+    throw std::invalid_argument("[ERROR] PropagationModel::setScaleFunctionVectorized: the propagation model does not use a scale function that can be replaced. abort");
+}
+
+arma::Mat<double> PropagationModel::propagateTangent(const arma::Mat<double>& tangent, double time){
+    throw std::invalid_argument("[ERROR] PropagationModel::propagateTangent: the propagation model does not support the tangent propagation. abort");
+}
+
+arma::Col<double> PropagationModel::propagateScaleDerivative(const arma::Col<double>& input, double time){
+    throw std::invalid_argument("[ERROR] PropagationModel::propagateScaleDerivative: the propagation model does not use per node scaling values. abort");
+}
@@ -11,7 +11,11 @@
 #pragma once
 #include <armadillo>
 #include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
 #include <vector>
+#include "computation/ScaleSchedule.hxx"
 #include "data_structures/WeightedEdgeGraph.hxx"
 
 /**
@@ -26,6 +30,21 @@
 class PropagationModel{
     protected:
         std::function<double(double)> scaleFunction; ///< The function to scale the propagation term. It takes a double value (time) and returns a double value.
+        std::shared_ptr<const ScaleSchedule> scaleSchedule; ///< The precomputed scaling values over the simulation time grid, empty if not precomputed.
+        arma::Col<double> scaleBuffer; ///< Buffer for the scaling values of the times that are not precomputed in the schedule.
+        /**
+         * @brief Get the vectorized scale function to be precomputed in the schedule.
+         * @return The vectorized scale function, an empty function if the model does not use a scale function (the default).
+         */
+        virtual std::function<arma::Col<double>(double)> scheduleScaleFunction(){return nullptr;}
+        /**
+         * @brief Get the scaling values at a given time.
+         * @param time The current time.
+         * @param numElem The number of elements of the input vector.
+         * @param scaleFunctionVectorized The vectorized scale function of the implementation, evaluated if the time is not precomputed.
+         * @return A reference to the precomputed scaling values if the time is in the schedule, otherwise to the buffer with the evaluated scale function.
+         */
+        const arma::Col<double>& scaleValues(double time, arma::uword numElem, const std::function<arma::Col<double>(double)>& scaleFunctionVectorized);
     public:
         /**
          * @brief Default destructor for the PropagationModel class. (needed even if the class is abstract)
@@ -49,6 +68,14 @@ class PropagationModel{
          * @details This function is used to compute the propagation term of the input vector.
          */
         virtual arma::Col<double> propagationTerm(arma::Col<double> input, double time) = 0;
+        /**
+         * @brief Update the propagation operator after the edge weights of the graph have changed.
+         * @param graph The graph used by the propagation model, with the new edge weights already set (the number of nodes must not change).
+         * @param previousEdgeWeights The previous weights of the updated edges, as returned by WeightedEdgeGraph::updateEdgeWeights (source index, target index, previous weight).
+         * @details Only the parts of the operator relative to the changed source nodes are updated, instead of rebuilding the whole operator.
+         * @throw std::invalid_argument if the number of nodes of the graph is different from the size of the operator.
+         */
+        virtual void updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights) = 0;
 
         //getters and setters
         /**
@@ -63,4 +90,53 @@ class PropagationModel{
          * @details This function is used to set the scale function used in the propagation model.
          */
         void setScaleFunction(std::function<double(double)> scaleFunction){this->scaleFunction = scaleFunction;}
+        /**
+         * @brief Precompute the scaling values of the model over the simulation time grid.
+         * @param times The times of the simulation grid.
+         * @param numElements The number of elements (nodes of the graph) of the input vectors.
+         * @param pool The pool used to share identical schedules between models, if nullptr the schedule is not shared.
+         * @return true if the schedule was precomputed, false if the model does not use a scale function.
+         * @details During the computation, the times in the grid use the precomputed values instead of evaluating the scale function.
+         * @see ScaleSchedule
+         */
+        bool precomputeScaleSchedule(const std::vector<double>& times, arma::uword numElements, ScaleSchedulePool* pool = nullptr);
+        /**
+         * @brief Remove the precomputed scaling values, the scale function is evaluated again at every call.
+         */
+        void clearScaleSchedule(){this->scaleSchedule.reset();}
+        /**
+         * @brief Set the precomputed scaling values, computed before for the current scale function.
+         * @param scaleSchedule The schedule of the scaling values over the simulation time grid, empty to evaluate the scale function at every call.
+         * @details Used to restore a schedule kept from a previous precomputation instead of evaluating the scale function again over the grid.
+         */
+        void setScaleSchedule(std::shared_ptr<const ScaleSchedule> scaleSchedule){this->scaleSchedule = std::move(scaleSchedule);}
+        /**
+         * @brief Get the precomputed scaling values.
+         * @return The schedule of the scaling values, empty if not precomputed.
+         */
+        const std::shared_ptr<const ScaleSchedule>& getScaleSchedule() const {return this->scaleSchedule;}
+        /**
+         * @brief Replace the vectorized scale function of the model, keeping the propagation operator unchanged.
+         * @param scaleFunctionVectorized The new vectorized scale function, returning the scaling values of every node at a given time.
+         * @details The precomputed scaling values are removed, they should be precomputed again for the new scale function.
+         * @throw std::invalid_argument if the model does not use a vectorized scale function (the default).
+         */
+        virtual void setScaleFunctionVectorized(std::function<arma::Col<double>(double)> scaleFunctionVectorized);
+        /**
+         * @brief Apply the derivative of the propagation with respect to the input to the tangent vectors (tangent propagation).
+         * @param tangent The tangent vectors (nodes x parameters), every column is the derivative of the input with respect to a parameter.
+         * @param time The current time.
+         * @return The derivative of the propagated vector with respect to the parameters (nodes x parameters).
+         * @details The propagation is linear in the input, so the derivative does not depend on the input.
+         * @throw std::invalid_argument if the model does not support the tangent propagation (the default).
+         */
+        virtual arma::Mat<double> propagateTangent(const arma::Mat<double>& tangent, double time);
+        /**
+         * @brief Get the derivative of the propagated vector with respect to the scaling value of every node.
+         * @param input The input vector where the derivative is computed.
+         * @param time The current time.
+         * @return The vector of the derivatives, the element i is the derivative of propagate(input)[i] with respect to the scaling value of the node i.
+         * @throw std::invalid_argument if the model does not use per node scaling values (the default).
+         */
+        virtual arma::Col<double> propagateScaleDerivative(const arma::Col<double>& input, double time);
 };
\ No newline at end of file
@@ -6,6 +6,8 @@
  * @details The propagation class uses a scale function to determine the scaling of the propagation term. The scale function can be set and modified as needed.
  */
 #include "computation/PropagationModelCustom.hxx"
+#include "utils/graphUtilities.hxx"
+#include "utils/mathUtilities.hxx"
 #include <armadillo>
 #include <iostream>
 
@@ -16,14 +18,9 @@ PropagationModelCustom::PropagationModelCustom(const WeightedEdgeGraph* graph){
     this->scaleFunctionVectorized = [numElements](double time)-> arma::Col<double>{return arma::ones<arma::Col<double>>(numElements) * 0.5;};
 
     //getting normalization values for the adjacency matrix
-    std::vector<double> normalizationFactors(graph->getNumNodes(),0);
-    for (int i = 0; i < graph->getNumNodes(); i++) {
-        for(int j = 0; j < graph->getNumNodes();j++){
-            normalizationFactors[i] += std::abs(graph->getEdgeWeight(i,j)); 
-        }
-    }
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
 
-    this->Wmat = graph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+    this->Wmat = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
 }
 
 PropagationModelCustom::~PropagationModelCustom(){
@@ -36,33 +33,44 @@ PropagationModelCustom::PropagationModelCustom(const WeightedEdgeGraph* graph, s
         return arma::ones<arma::Col<double>>(numElements) * scaleFun(time);
     };
     //getting normalization values for the adjacency matrix
-    std::vector<double> normalizationFactors(graph->getNumNodes(),0);
-    for (int i = 0; i < graph->getNumNodes(); i++) {
-        for(int j = 0; j < graph->getNumNodes();j++){
-            normalizationFactors[i] += std::abs(graph->getEdgeWeight(i,j)); 
-        }
-    }
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
 
-    this->Wmat = graph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+    this->Wmat = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
 }
 
 PropagationModelCustom::PropagationModelCustom(const WeightedEdgeGraph* graph, std::function<arma::Col<double>(double)> scaleFun):scaleFunctionVectorized(scaleFun){   
     //getting normalization values for the adjacency matrix
-    std::vector<double> normalizationFactors(graph->getNumNodes(),0);
-    for (int i = 0; i < graph->getNumNodes(); i++) {
-        for(int j = 0; j < graph->getNumNodes();j++){
-            normalizationFactors[i] += std::abs(graph->getEdgeWeight(i,j)); 
-        }
-    }
-    this->Wmat = graph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
+    this->Wmat = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
 }
 
 
 arma::Col<double> PropagationModelCustom::propagate(arma::Col<double> input, double time){
     // return input + (Wmat * input * this->scaleFunction(time));
-    return input + this->scaleFunctionVectorized(time) % (Wmat * input) ;
+    return input + this->scaleValues(time, input.n_elem, this->scaleFunctionVectorized) % (Wmat * input) ;
 }
 
 arma::Col<double> PropagationModelCustom::propagationTerm(arma::Col<double> input, double time){
-    return this->scaleFunctionVectorized(time) % (Wmat * input );
+    return this->scaleValues(time, input.n_elem, this->scaleFunctionVectorized) % (Wmat * input);
+}
+
+void PropagationModelCustom::updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights){
+    if(SizeToInt(Wmat.n_rows) != graph->getNumNodes()){
+        throw std::invalid_argument("[ERROR] PropagationModelCustom::updateEdgeWeights: the number of nodes of the graph changed, the model should be created again. abort");
+    }
+    // only the columns of the changed source nodes are affected, since their normalization factor changed
+    std::map<int, std::pair<arma::Col<double>, arma::Col<double>>> changedColumns = changedNormalizedColumns(*graph, previousEdgeWeights);
+    for(const auto& [node, columns] : changedColumns){
+        Wmat.col(node) = columns.second;
+    }
+}
+
+arma::Mat<double> PropagationModelCustom::propagateTangent(const arma::Mat<double>& tangent, double time){
+    arma::Mat<double> propagated = Wmat * tangent;
+    propagated.each_col() %= this->scaleValues(time, tangent.n_rows, this->scaleFunctionVectorized);
+    return tangent + propagated;
+}
+
+arma::Col<double> PropagationModelCustom::propagateScaleDerivative(const arma::Col<double>& input, double time){
+    return Wmat * input;
 }
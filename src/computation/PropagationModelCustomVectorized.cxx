@@ -1,41 +1,67 @@
+/**
+ * @file PropagationModelCustomVectorized.cxx
+ * @ingroup Experimental
+ * @brief Implements the PropagationModelCustomVectorized class used for managing custom vectorized propagation dynamics for the computation of the perturbation in MASFENON.
+ */
 #include "computation/PropagationModelCustomVectorized.hxx"
+#include "utils/graphUtilities.hxx"
+#include "utils/mathUtilities.hxx"
 #include <armadillo>
 #include <iostream>
 
 PropagationModelCustomVectorized::PropagationModelCustomVectorized(const WeightedEdgeGraph* graph){
     this->scaleFunction = [](double time)-> double{return 0.5;};
+    //using a vectorized scale function that returns 0.5 for all elements
+    int numElements = graph->getNumNodes();
+    this->scaleFunctionVectorized = [numElements](double time)-> arma::Col<double>{return arma::ones<arma::Col<double>>(numElements) * 0.5;};
 
     //getting normalization values for the adjacency matrix
-    std::vector<double> normalizationFactors(graph->getNumNodes(),0);
-    for (int i = 0; i < graph->getNumNodes(); i++) {
-        for(int j = 0; j < graph->getNumNodes();j++){
-            normalizationFactors[i] += std::abs(graph->getEdgeWeight(i,j)); 
-        }
-    }
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
 
-    this->Wmat = graph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+    this->Wmat = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
 }
 
 PropagationModelCustomVectorized::~PropagationModelCustomVectorized(){
 }
 
 PropagationModelCustomVectorized::PropagationModelCustomVectorized(const WeightedEdgeGraph* graph, std::function<double(double)> scaleFun):scaleFunction(scaleFun){
+    //using a vectorized scale function that returns the scale function value for all elements
+    int numElements = graph->getNumNodes();
+    this->scaleFunctionVectorized = [scaleFun, numElements](double time)-> arma::Col<double>{
+        return arma::ones<arma::Col<double>>(numElements) * scaleFun(time);
+    };
     //getting normalization values for the adjacency matrix
-    std::vector<double> normalizationFactors(graph->getNumNodes(),0);
-    for (int i = 0; i < graph->getNumNodes(); i++) {
-        for(int j = 0; j < graph->getNumNodes();j++){
-            normalizationFactors[i] += std::abs(graph->getEdgeWeight(i,j)); 
-        }
-    }
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
 
-    this->Wmat = graph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+    this->Wmat = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+}
+
+PropagationModelCustomVectorized::PropagationModelCustomVectorized(const WeightedEdgeGraph* graph, std::function<arma::Col<double>(double)> scaleFun):scaleFunctionVectorized(scaleFun){
+    //getting normalization values for the adjacency matrix
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
+    this->Wmat = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
 }
 
 
 arma::Mat<double> PropagationModelCustomVectorized::propagate(arma::Mat<double> input, double time){
-    return input + (Wmat * input * this->scaleFunction(time));
+    // return input + (Wmat * input * this->scaleFunction(time));
+    return input + this->propagationTerm(input, time);
 }
 
 arma::Mat<double> PropagationModelCustomVectorized::propagationTerm(arma::Mat<double> input, double time){
-    return (Wmat * input * this->scaleFunction(time));
+    // a single matrix-matrix product for all the scenarios, then the rows are scaled by the per node scaling values
+    arma::Mat<double> term = Wmat * input;
+    term.each_col() %= this->scaleFunctionVectorized(time);
+    return term;
+}
+
+void PropagationModelCustomVectorized::updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights){
+    if(SizeToInt(Wmat.n_rows) != graph->getNumNodes()){
+        throw std::invalid_argument("[ERROR] PropagationModelCustomVectorized::updateEdgeWeights: the number of nodes of the graph changed, the model should be created again. abort");
+    }
+    // only the columns of the changed source nodes are affected, since their normalization factor changed
+    std::map<int, std::pair<arma::Col<double>, arma::Col<double>>> changedColumns = changedNormalizedColumns(*graph, previousEdgeWeights);
+    for(const auto& [node, columns] : changedColumns){
+        Wmat.col(node) = columns.second;
+    }
 }
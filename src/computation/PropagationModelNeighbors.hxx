@@ -26,6 +26,12 @@ class PropagationModelNeighbors : public PropagationModel
         std::function<double(double)> scaleFunction; ///< The function to scale the propagation term. It takes a double value (time) and returns a double value.
         std::function<arma::Col<double>(double)> scaleFunctionVectorized; ///< The function to scale the propagation term for vectorized operations. It takes a double value (time) and returns a vector of double values (scaling values).
         arma::dmat Wmat; ///< The weighted adjacency matrix of the graph, transposed and normalized by column, as an Armadillo matrix.
+    protected:
+        /**
+         * @brief Get the vectorized scale function to be precomputed in the schedule.
+         * @return The vectorized scale function of the model.
+         */
+        std::function<arma::Col<double>(double)> scheduleScaleFunction()override{return this->scaleFunctionVectorized;}
     public:
         /**
          * @brief Constructor for the PropagationModelNeighbors class, passing a graph.
@@ -68,10 +74,36 @@ class PropagationModelNeighbors : public PropagationModel
          * @details This function is used to compute the propagation term of the input vector.
          */
         arma::Col<double> propagationTerm(arma::Col<double> input, double time)override;
+        /**
+         * @brief Update the weighted adjacency matrix after the edge weights of the graph have changed.
+         * @param graph The graph used by the propagation model, with the new edge weights already set.
+         * @param previousEdgeWeights The previous weights of the updated edges, as returned by WeightedEdgeGraph::updateEdgeWeights.
+         * @details Only the columns of the changed source nodes are recomputed (with their new normalization factor).
+         */
+        void updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights)override;
         /**
          * @brief Get the scale function value at a certain time.
          * @return The value of the scale function.
          * @details This function is used to get the scale function value at a certain time.
          */
         double getScale(double time){return scaleFunction(time);}
+        /**
+         * @brief Replace the vectorized scale function of the model, the propagation operator is not computed again.
+         * @param scaleFunctionVectorized The new vectorized scale function, returning the scaling values of every node at a given time.
+         */
+        void setScaleFunctionVectorized(std::function<arma::Col<double>(double)> scaleFunctionVectorized)override{this->scaleFunctionVectorized = scaleFunctionVectorized; this->clearScaleSchedule();}
+        /**
+         * @brief Apply the derivative of the propagation to the tangent vectors, tangent + scale % (Wmat * tangent).
+         * @param tangent The tangent vectors (nodes x parameters).
+         * @param time The current time.
+         * @return The derivative of the propagated vector with respect to the parameters.
+         */
+        arma::Mat<double> propagateTangent(const arma::Mat<double>& tangent, double time)override;
+        /**
+         * @brief Get the derivative of the propagated vector with respect to the scaling value of every node, that is Wmat * input.
+         * @param input The input vector.
+         * @param time The current time.
+         * @return The vector of the derivatives.
+         */
+        arma::Col<double> propagateScaleDerivative(const arma::Col<double>& input, double time)override;
 };
\ No newline at end of file
@@ -1 +1,67 @@
-#include "computation/PropagationModelNeighborsVectorized.hxx"
\ No newline at end of file
+/**
+ * @file PropagationModelNeighborsVectorized.cxx
+ * @ingroup Experimental
+ * @brief Implements the PropagationModelNeighborsVectorized class used for managing vectorized propagation dynamics for the computation of the perturbation in MASFENON.
+ * @details The propagation model is based on the neighbors of the nodes in the graph, and it uses a weighted adjacency matrix to compute the propagation term for all the scenarios at once.
+ */
+#include "computation/PropagationModelNeighborsVectorized.hxx"
+#include "utils/graphUtilities.hxx"
+#include "utils/mathUtilities.hxx"
+#include <armadillo>
+#include <iostream>
+
+PropagationModelNeighborsVectorized::PropagationModelNeighborsVectorized(const WeightedEdgeGraph* graph){
+    this->scaleFunction = [](double time)-> double{return 0.5;};
+
+    int numElements = graph->getNumNodes();
+    this->scaleFunctionVectorized = [numElements](double time)-> arma::Col<double>{return arma::ones<arma::Col<double>>(numElements) * 0.5;};
+
+    //getting normalization values for the adjacency matrix
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
+
+    this->Wmat = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+}
+
+PropagationModelNeighborsVectorized::~PropagationModelNeighborsVectorized(){
+}
+
+PropagationModelNeighborsVectorized::PropagationModelNeighborsVectorized(const WeightedEdgeGraph* graph, std::function<double(double)> scaleFun):scaleFunction(scaleFun){
+    //using a vectorized scale function that returns the scale function value for all elements
+    int numElements = graph->getNumNodes();
+    this->scaleFunctionVectorized = [scaleFun, numElements](double time)-> arma::Col<double>{
+        return arma::ones<arma::Col<double>>(numElements) * scaleFun(time);
+    };
+    //getting normalization values for the adjacency matrix
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
+
+    this->Wmat = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+}
+
+PropagationModelNeighborsVectorized::PropagationModelNeighborsVectorized(const WeightedEdgeGraph* graph, std::function<arma::Col<double>(double)> scaleFun):scaleFunctionVectorized(scaleFun){
+    //getting normalization values for the adjacency matrix
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
+    this->Wmat = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+}
+
+
+arma::Mat<double> PropagationModelNeighborsVectorized::propagate(arma::Mat<double> input, double time){
+    return input + this->propagationTerm(input, time);
+}
+
+arma::Mat<double> PropagationModelNeighborsVectorized::propagationTerm(arma::Mat<double> input, double time){
+    // a single matrix-matrix product for all the scenarios, then the rows are scaled by the per node scaling values
+    arma::Mat<double> term = Wmat * input;
+    term.each_col() %= this->scaleFunctionVectorized(time);
+    return term;
+}
+
+void PropagationModelNeighborsVectorized::updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights){
+    if(SizeToInt(Wmat.n_rows) != graph->getNumNodes()){
+        throw std::invalid_argument("[ERROR] PropagationModelNeighborsVectorized::updateEdgeWeights: the number of nodes of the graph changed, the model should be created again. abort");
+    }
+    // only the columns of the changed source nodes are affected, since their normalization factor changed
+    std::map<int, std::pair<arma::Col<double>, arma::Col<double>>> changedColumns = changedNormalizedColumns(*graph, previousEdgeWeights);
+    for(const auto& [node, columns] : changedColumns){
+        Wmat.col(node) = columns.second;
+    }
+}
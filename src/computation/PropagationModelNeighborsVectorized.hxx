@@ -2,6 +2,7 @@
  * @file PropagationModelNeighborsVectorized.hxx
  * @ingroup Experimental
  * @brief Defines the PropagationModelNeighborsVectorized class used for managing vectorized propagation dynamics for the computation of the perturbation in MASFENON. This class is an implemntation of the PropagationModelVectorized class.
+ * @details The input is a matrix (nodes x scenarios), every column is propagated with the same weighted adjacency matrix, so that all the scenarios are computed with a single matrix-matrix product.
  */
 #pragma once
 #include <armadillo>
@@ -11,19 +12,22 @@
  * @class PropagationModelNeighborsVectorized
  * @brief Propagation model implementation for neighbors vectorized propagation dynamics.
  * @details This class provides methods for applying neighbors vectorized propagation logic to the perturbation computation.
- * @warning This class is not yet implemented.
  * @details The neighbors propagation class uses a scale function to determine the scaling of the propagation term. The scale function can be set and modified as needed.
  * @details To set the scale function, @see CustomFunctions.hxx
+ * @details The scaling values are defined per node (rows of the input matrix) and are shared between the scenarios (columns of the input matrix).
+ * @implements PropagationModelVectorized
  * @todo Make it stateful. Related to issue #28
  */
 class PropagationModelNeighborsVectorized : public PropagationModelVectorized
 {
     private:
         std::function<double(double)> scaleFunction; ///< The scale function used to determine the scaling of the propagation term. This function can be set and modified as needed.
+        std::function<arma::Col<double>(double)> scaleFunctionVectorized; ///< The function to scale the propagation term for every node. It takes a double value (time) and returns a vector of double values (scaling values, one per node).
         arma::dmat Wmat; ///< The adjacency matrix of the graph. This is used to compute the propagation term.
     public:
         /**
          * @brief Default constructor for the PropagationModelNeighborsVectorized class.
+         * @param graph The graph to be used in the propagation model.
          * @details This constructor initializes the scale function to a default value of 0.5.
          */
         PropagationModelNeighborsVectorized(const WeightedEdgeGraph* graph);
@@ -34,27 +38,40 @@ class PropagationModelNeighborsVectorized : public PropagationModelVectorized
          * @details This constructor initializes the scale function to the provided custom value.
          */
         PropagationModelNeighborsVectorized(const WeightedEdgeGraph* graph,std::function<double(double)> scaleFunc);
+        /**
+         * @brief Constructor for the PropagationModelNeighborsVectorized class with a vectorized (per node) scale function.
+         * @param graph The graph to be used in the propagation model.
+         * @param scaleFunc The vectorized scale function to be used in the propagation model, returning one scaling value for every node of the graph.
+         */
+        PropagationModelNeighborsVectorized(const WeightedEdgeGraph* graph,std::function<arma::Col<double>(double)> scaleFunc);
         /**
          * @brief Default destructor for the PropagationModelNeighborsVectorized class.
          * @details Cleans up the resources used by the PropagationModelNeighborsVectorized class.
          */
         ~PropagationModelNeighborsVectorized()override;
         /**
-         * @brief Propagate the input vector.
-         * @param input The input vector to be processed.
+         * @brief Propagate the input matrix.
+         * @param input The input matrix to be processed (nodes x scenarios).
          * @param time The current time.
-         * @return The output vector after applying the propagation model.
+         * @return The output matrix after applying the propagation model.
          * @details This function is used to compute the final output of the propagation model. In this case, the values are propagated to the neighbors of the nodes.
          */
         arma::Mat<double> propagate(arma::Mat<double> input,double time)override;
         /**
-         * @brief Propagation term of the input vector.
-         * @param input The input vector to be processed.
+         * @brief Propagation term of the input matrix.
+         * @param input The input matrix to be processed (nodes x scenarios).
          * @param time The current time.
-         * @return The propagation term vector.
-         * @details This function is used to compute the propagation term of the input vector. In this case, the values are propagated to the neighbors of the nodes.
+         * @return The propagation term matrix.
+         * @details This function is used to compute the propagation term of the input matrix. In this case, the values are propagated to the neighbors of the nodes.
          */
         arma::Mat<double> propagationTerm(arma::Mat<double> input, double time)override;
+        /**
+         * @brief Update the weighted adjacency matrix after the edge weights of the graph have changed.
+         * @param graph The graph used by the propagation model, with the new edge weights already set.
+         * @param previousEdgeWeights The previous weights of the updated edges, as returned by WeightedEdgeGraph::updateEdgeWeights.
+         * @details Only the columns of the changed source nodes are recomputed (with their new normalization factor).
+         */
+        void updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights)override;
         /**
          * @brief Get the scale function value at a given time.
          * @param time The time at which to evaluate the scale function.
@@ -62,4 +79,4 @@ class PropagationModelNeighborsVectorized : public PropagationModelVectorized
          * @details This function is used to get the value of the scale function at a given time.
          */
         double getScale(double time){return scaleFunction(time);}
-};
\ No newline at end of file
+};
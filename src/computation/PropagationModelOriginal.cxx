@@ -5,6 +5,9 @@
  * @details The PropagationModelOriginal class provides methods for applying propagation logic to the perturbation computation.
  */
 #include "computation/PropagationModelOriginal.hxx"
+#include "utils/armaUtilities.hxx"
+#include "utils/graphUtilities.hxx"
+#include "utils/mathUtilities.hxx"
 #include <armadillo>
 #include <iostream>
 
@@ -14,22 +17,11 @@ PropagationModelOriginal::PropagationModelOriginal(const WeightedEdgeGraph* grap
     this->scaleFunctionVectorized = [numElements](double time)-> arma::Col<double>{return arma::ones<arma::Col<double>>(numElements) * 0.5;};
 
     //pseudoinverse initialization
-    std::vector<double> normalizationFactors(graph->getNumNodes(),0);
-    for (int i = 0; i < graph->getNumNodes(); i++) {
-        for(int j = 0; j < graph->getNumNodes();j++){
-            normalizationFactors[i] += std::abs(graph->getEdgeWeight(i,j)); 
-        }
-    }
-    arma::Mat<double> WtransArma = graph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
-    
-    arma::Mat<double> IdentityArma = arma::eye(graph->getNumNodes(),graph->getNumNodes());
-    arma::Mat<double> temp = IdentityArma - WtransArma;
-    
-    //control determinant and invertibility, print warning if not invertible
-    if(arma::det(temp) == 0){
+    computePseudoinverse(graph);
+    //control invertibility, print warning if not invertible
+    if(!invertibleOperator){
         Logger::getInstance().printWarning(" PropagationModelOriginal::PropagationModelOriginal(const WeightedEdgeGraph* graph): The graph is not invertible, the pseudoinverse could lead to faulty results");
     }
-    pseudoinverse = arma::pinv(temp);
 }
 
 PropagationModelOriginal::~PropagationModelOriginal(){
@@ -42,40 +34,64 @@ PropagationModelOriginal::PropagationModelOriginal(const WeightedEdgeGraph* grap
         return arma::ones<arma::Col<double>>(numElements) * scaleFunc(time);
     };
     //pseudoinverse initialization
-    std::vector<double> normalizationFactors(graph->getNumNodes(),0);
-    for (int i = 0; i < graph->getNumNodes(); i++) {
-        for(int j = 0; j < graph->getNumNodes();j++){
-            normalizationFactors[i] += std::abs(graph->getEdgeWeight(i,j)); 
-        }
-    }
-    arma::Mat<double> WtransArma = graph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
-    
-    arma::Mat<double> IdentityArma = arma::eye(graph->getNumNodes(),graph->getNumNodes());
-    
-    pseudoinverse = arma::pinv(IdentityArma - WtransArma);
+    computePseudoinverse(graph);
 }
 
 PropagationModelOriginal::PropagationModelOriginal(const WeightedEdgeGraph* graph,std::function<arma::Col<double>(double)> scaleFunc):scaleFunctionVectorized(scaleFunc){
     //pseudoinverse initialization
-    std::vector<double> normalizationFactors(graph->getNumNodes(),0);
-    for (int i = 0; i < graph->getNumNodes(); i++) {
-        for(int j = 0; j < graph->getNumNodes();j++){
-            normalizationFactors[i] += std::abs(graph->getEdgeWeight(i,j)); 
-        }
-    }
-    arma::Mat<double> WtransArma = graph->adjMatrix.transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+    computePseudoinverse(graph);
+}
+
+void PropagationModelOriginal::computePseudoinverse(const WeightedEdgeGraph* graph){
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
+    arma::Mat<double> WtransArma = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
     
     arma::Mat<double> IdentityArma = arma::eye(graph->getNumNodes(),graph->getNumNodes());
+    arma::Mat<double> temp = IdentityArma - WtransArma;
     
-    pseudoinverse = arma::pinv(IdentityArma - WtransArma);
+    pseudoinverse = pseudoinverseWithInvertibility(temp, invertibleOperator);
+}
+
+void PropagationModelOriginal::updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights){
+    if(SizeToInt(pseudoinverse.n_rows) != graph->getNumNodes()){
+        throw std::invalid_argument("[ERROR] PropagationModelOriginal::updateEdgeWeights: the number of nodes of the graph changed, the model should be created again. abort");
+    }
+    std::map<int, std::pair<arma::Col<double>, arma::Col<double>>> changedColumns = changedNormalizedColumns(*graph, previousEdgeWeights);
+    if(changedColumns.empty()){
+        return;
+    }
+    // rank-1 updates cost O(n^2) each, the pseudoinverse O(n^3) with a bigger constant, so they are used only when few nodes changed
+    bool updated = invertibleOperator && (changedColumns.size() * 4 <= pseudoinverse.n_rows);
+    if(updated){
+        for(const auto& [node, columns] : changedColumns){
+            // the column of (I - W) changes by -(newColumn - previousColumn)
+            if(!shermanMorrisonColumnUpdate(pseudoinverse, columns.first - columns.second, node)){
+                updated = false;
+                break;
+            }
+        }
+    }
+    if(!updated){
+        computePseudoinverse(graph);
+    }
 }
 
 arma::Col<double> PropagationModelOriginal::propagate(arma::Col<double> input, double time){
     // return ( pseudoinverse * input * this->scaleFunction(time));
-    return this->scaleFunctionVectorized(time) % (pseudoinverse * input);
+    return this->scaleValues(time, input.n_elem, this->scaleFunctionVectorized) % (pseudoinverse * input);
 }
 
 arma::Col<double> PropagationModelOriginal::propagationTerm(arma::Col<double> input, double time){
     //a propagation term doesn't exist in this case since it is a resolution of the system of equations
-    return this->scaleFunctionVectorized(time) % (pseudoinverse * input);
+    return this->scaleValues(time, input.n_elem, this->scaleFunctionVectorized) % (pseudoinverse * input);
+}
+
+arma::Mat<double> PropagationModelOriginal::propagateTangent(const arma::Mat<double>& tangent, double time){
+    arma::Mat<double> output = pseudoinverse * tangent;
+    output.each_col() %= this->scaleValues(time, tangent.n_rows, this->scaleFunctionVectorized);
+    return output;
+}
+
+arma::Col<double> PropagationModelOriginal::propagateScaleDerivative(const arma::Col<double>& input, double time){
+    return pseudoinverse * input;
 }
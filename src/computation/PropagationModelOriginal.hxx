@@ -25,6 +25,18 @@ class PropagationModelOriginal : public PropagationModel
         std::function<double(double)> scaleFunction; ///< The function to scale the propagation term. It takes a double value (time) and returns a double value.
         std::function<arma::Col<double>(double)> scaleFunctionVectorized; ///< The function to scale the propagation term for vectorized operations. It takes a double value (time) and returns a vector of double values (scaling values).
         arma::dmat pseudoinverse; ///< The pseudoinverse of the weighted adjacency matrix of the graph, transposed and normalized by column, as an Armadillo matrix.
+        bool invertibleOperator = false; ///< Whether (I - W) is invertible, in which case the pseudoinverse is the inverse and can be updated with rank-1 updates.
+        /**
+         * @brief Compute the pseudoinverse of (I - W) from the graph, where W is the weighted adjacency matrix of the graph transposed and normalized by column.
+         * @param graph The graph to be used for the computation.
+         */
+        void computePseudoinverse(const WeightedEdgeGraph* graph);
+    protected:
+        /**
+         * @brief Get the vectorized scale function to be precomputed in the schedule.
+         * @return The vectorized scale function of the model.
+         */
+        std::function<arma::Col<double>(double)> scheduleScaleFunction()override{return this->scaleFunctionVectorized;}
     public:
         /**
          * @brief Constructor for the PropagationModelOriginal class, passing a graph.
@@ -67,10 +79,37 @@ class PropagationModelOriginal : public PropagationModel
          * @details This function is used to compute the propagation term of the input vector.
          */
         arma::Col<double> propagationTerm(arma::Col<double> input, double time)override;
+        /**
+         * @brief Update the pseudoinverse after the edge weights of the graph have changed.
+         * @param graph The graph used by the propagation model, with the new edge weights already set.
+         * @param previousEdgeWeights The previous weights of the updated edges, as returned by WeightedEdgeGraph::updateEdgeWeights.
+         * @details Every changed source node changes a single column of (I - W), so the pseudoinverse is updated with a rank-1 (Sherman-Morrison) update per changed node, O(n^2) each.
+         * @details The pseudoinverse is recomputed from scratch if (I - W) is not invertible, if an update is numerically unstable or if too many nodes changed for the rank-1 updates to be convenient.
+         */
+        void updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights)override;
         /**
          * @brief Get the scale function value at a certain time.
          * @return The value of the scale function.
          * @details This function is used to get the scale function value at a certain time.
          */
         double getScale(double time){return scaleFunction(time);}
+        /**
+         * @brief Replace the vectorized scale function of the model, the propagation operator is not computed again.
+         * @param scaleFunctionVectorized The new vectorized scale function, returning the scaling values of every node at a given time.
+         */
+        void setScaleFunctionVectorized(std::function<arma::Col<double>(double)> scaleFunctionVectorized)override{this->scaleFunctionVectorized = scaleFunctionVectorized; this->clearScaleSchedule();}
+        /**
+         * @brief Apply the derivative of the propagation to the tangent vectors, scale % (pseudoinverse * tangent).
+         * @param tangent The tangent vectors (nodes x parameters).
+         * @param time The current time.
+         * @return The derivative of the propagated vector with respect to the parameters.
+         */
+        arma::Mat<double> propagateTangent(const arma::Mat<double>& tangent, double time)override;
+        /**
+         * @brief Get the derivative of the propagated vector with respect to the scaling value of every node, that is pseudoinverse * input.
+         * @param input The input vector.
+         * @param time The current time.
+         * @return The vector of the derivatives.
+         */
+        arma::Col<double> propagateScaleDerivative(const arma::Col<double>& input, double time)override;
 };
\ No newline at end of file
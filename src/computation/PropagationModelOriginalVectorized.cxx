@@ -1 +1,82 @@
-#include "computation/PropagationModelOriginalVectorized.hxx"
\ No newline at end of file
+/**
+ * @file PropagationModelOriginalVectorized.cxx
+ * @ingroup Experimental
+ * @brief Implements the methods of the PropagationModelOriginalVectorized class used for managing vectorized propagation dynamics for the computation of the perturbation in MASFENON.
+ */
+#include "computation/PropagationModelOriginalVectorized.hxx"
+#include "utils/armaUtilities.hxx"
+#include "utils/graphUtilities.hxx"
+#include "utils/mathUtilities.hxx"
+#include <armadillo>
+#include <iostream>
+
+void PropagationModelOriginalVectorized::computePseudoinverse(const WeightedEdgeGraph* graph){
+    std::vector<double> normalizationFactors = graph->getAbsoluteOutWeights();
+    arma::Mat<double> WtransArma = graph->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+
+    arma::Mat<double> IdentityArma = arma::eye(graph->getNumNodes(),graph->getNumNodes());
+    arma::Mat<double> temp = IdentityArma - WtransArma;
+
+    pseudoinverse = pseudoinverseWithInvertibility(temp, invertibleOperator);
+}
+
+PropagationModelOriginalVectorized::PropagationModelOriginalVectorized(const WeightedEdgeGraph* graph){
+    this->scaleFunction = [](double time)-> double{return 0.5;};
+    int numElements = graph->getNumNodes();
+    this->scaleFunctionVectorized = [numElements](double time)-> arma::Col<double>{return arma::ones<arma::Col<double>>(numElements) * 0.5;};
+    computePseudoinverse(graph);
+}
+
+PropagationModelOriginalVectorized::~PropagationModelOriginalVectorized(){
+}
+
+PropagationModelOriginalVectorized::PropagationModelOriginalVectorized(const WeightedEdgeGraph* graph,std::function<double(double)> scaleFunc):scaleFunction(scaleFunc){
+    //using a vectorized scale function that returns the scale function value for all elements
+    int numElements = graph->getNumNodes();
+    this->scaleFunctionVectorized = [scaleFunc, numElements](double time)-> arma::Col<double>{
+        return arma::ones<arma::Col<double>>(numElements) * scaleFunc(time);
+    };
+    computePseudoinverse(graph);
+}
+
+PropagationModelOriginalVectorized::PropagationModelOriginalVectorized(const WeightedEdgeGraph* graph,std::function<arma::Col<double>(double)> scaleFunc):scaleFunctionVectorized(scaleFunc){
+    computePseudoinverse(graph);
+}
+
+arma::Mat<double> PropagationModelOriginalVectorized::propagate(arma::Mat<double> input, double time){
+    // a single matrix-matrix product for all the scenarios, then the rows are scaled by the per node scaling values
+    arma::Mat<double> output = pseudoinverse * input;
+    output.each_col() %= this->scaleFunctionVectorized(time);
+    return output;
+}
+
+arma::Mat<double> PropagationModelOriginalVectorized::propagationTerm(arma::Mat<double> input, double time){
+    //a propagation term doesn't exist in this case since it is a resolution of the system of equations
+    arma::Mat<double> output = pseudoinverse * input;
+    output.each_col() %= this->scaleFunctionVectorized(time);
+    return output;
+}
+
+void PropagationModelOriginalVectorized::updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights){
+    if(SizeToInt(pseudoinverse.n_rows) != graph->getNumNodes()){
+        throw std::invalid_argument("[ERROR] PropagationModelOriginalVectorized::updateEdgeWeights: the number of nodes of the graph changed, the model should be created again. abort");
+    }
+    std::map<int, std::pair<arma::Col<double>, arma::Col<double>>> changedColumns = changedNormalizedColumns(*graph, previousEdgeWeights);
+    if(changedColumns.empty()){
+        return;
+    }
+    // rank-1 updates cost O(n^2) each, the pseudoinverse O(n^3) with a bigger constant, so they are used only when few nodes changed
+    bool updated = invertibleOperator && (changedColumns.size() * 4 <= pseudoinverse.n_rows);
+    if(updated){
+        for(const auto& [node, columns] : changedColumns){
+            // the column of (I - W) changes by -(newColumn - previousColumn)
+            if(!shermanMorrisonColumnUpdate(pseudoinverse, columns.first - columns.second, node)){
+                updated = false;
+                break;
+            }
+        }
+    }
+    if(!updated){
+        computePseudoinverse(graph);
+    }
+}
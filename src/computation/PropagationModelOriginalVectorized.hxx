@@ -2,6 +2,7 @@
  * @file PropagationModelOriginalVectorized.hxx
  * @ingroup Experimental
  * @brief Defines the PropagationModelOriginalVectorized class used for managing vectorized propagation dynamics for the computation of the perturbation in MASFENON. This class is an implemntation of the PropagationModelVectorized class.
+ * @details The input is a matrix (nodes x scenarios), every column is propagated with the same pseudoinverse, so that all the scenarios are computed with a single matrix-matrix product.
  */
 #pragma once
 #include <armadillo>
@@ -11,18 +12,27 @@
  * @class PropagationModelOriginalVectorized
  * @brief Propagation model implementation for original vectorized propagation dynamics.
  * @details This class provides methods for applying original vectorized propagation logic to the perturbation computation.
- * @warning This class is not yet implemented.
  * @details The original propagation class uses a scale function to determine the scaling of the propagation term. The scale function can be set and modified as needed.
  * @details To set the scale function, @see CustomFunctions.hxx
+ * @details The scaling values are defined per node (rows of the input matrix) and are shared between the scenarios (columns of the input matrix).
+ * @implements PropagationModelVectorized
  */
 class PropagationModelOriginalVectorized : public PropagationModelVectorized
 {
     private:
         std::function<double(double)> scaleFunction; ///< The scale function used to determine the scaling of the propagation term. This function can be set and modified as needed.
+        std::function<arma::Col<double>(double)> scaleFunctionVectorized; ///< The function to scale the propagation term for every node. It takes a double value (time) and returns a vector of double values (scaling values, one per node).
         arma::dmat pseudoinverse; ///< The pseudoinverse of the adjacency matrix. This is used to compute the propagation term.
+        bool invertibleOperator = false; ///< Whether (I - W) is invertible, in which case the pseudoinverse is the inverse and can be updated with rank-1 updates.
+        /**
+         * @brief Compute the pseudoinverse of (I - W) from the graph, where W is the weighted adjacency matrix of the graph transposed and normalized by column.
+         * @param graph The graph to be used for the computation.
+         */
+        void computePseudoinverse(const WeightedEdgeGraph* graph);
     public:
         /**
          * @brief Default constructor for the PropagationModelOriginalVectorized class.
+         * @param graph The graph to be used in the propagation model.
          * @details This constructor initializes the scale function to a default value of 0.5.
          * @details This function computes the pseudoinverse of the adjacency matrix.
          */
@@ -35,31 +45,46 @@ class PropagationModelOriginalVectorized : public PropagationModelVectorized
          * @details This function computes the pseudoinverse of the adjacency matrix.
          */
         PropagationModelOriginalVectorized(const WeightedEdgeGraph* graph,std::function<double(double)> scaleFunc);
+        /**
+         * @brief Constructor for the PropagationModelOriginalVectorized class with a vectorized (per node) scale function.
+         * @param graph The graph to be used in the propagation model.
+         * @param scaleFunc The vectorized scale function to be used in the propagation model, returning one scaling value for every node of the graph.
+         * @details This function computes the pseudoinverse of the adjacency matrix.
+         */
+        PropagationModelOriginalVectorized(const WeightedEdgeGraph* graph,std::function<arma::Col<double>(double)> scaleFunc);
         /**
          * @brief Default destructor for the PropagationModelOriginalVectorized class.
          * @details Cleans up the resources used by the PropagationModelOriginalVectorized class.
          */
         ~PropagationModelOriginalVectorized()override;
         /**
-         * @brief Propagate the input vector.
-         * @param input The input vector to be processed.
+         * @brief Propagate the input matrix.
+         * @param input The input matrix to be processed (nodes x scenarios).
          * @param time The current time.
-         * @return The output vector after applying the propagation model.
+         * @return The output matrix after applying the propagation model.
          * @details This function is used to compute the final output of the propagation model.
          */
         arma::Mat<double> propagate(arma::Mat<double> input,double time)override;
         /**
-         * @brief Propagation term of the input vector.
-         * @param input The input vector to be processed.
+         * @brief Propagation term of the input matrix.
+         * @param input The input matrix to be processed (nodes x scenarios).
          * @param time The current time.
-         * @return The propagation term vector.
-         * @details This function is used to compute the propagation term of the input vector.
+         * @return The propagation term matrix.
+         * @details This function is used to compute the propagation term of the input matrix.
          */
         arma::Mat<double> propagationTerm(arma::Mat<double> input, double time)override;
+        /**
+         * @brief Update the pseudoinverse after the edge weights of the graph have changed.
+         * @param graph The graph used by the propagation model, with the new edge weights already set.
+         * @param previousEdgeWeights The previous weights of the updated edges, as returned by WeightedEdgeGraph::updateEdgeWeights.
+         * @details Every changed source node changes a single column of (I - W), so the pseudoinverse is updated with a rank-1 (Sherman-Morrison) update per changed node, O(n^2) each.
+         * @details The pseudoinverse is recomputed from scratch if (I - W) is not invertible, if an update is numerically unstable or if too many nodes changed for the rank-1 updates to be convenient.
+         */
+        void updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights)override;
         /**
          * @brief Get the scale function used in the propagation model.
          * @return The scale function used in the propagation model.
          * @details This function is used to get the scale function used in the propagation model.
          */
         double getScale(double time){return scaleFunction(time);}
-};
\ No newline at end of file
+};
@@ -0,0 +1,51 @@
+/**
+ * @file PropagationModelPlugin.cxx
+ * @ingroup Core
+ * @brief Implements the PropagationModelPlugin class, a propagation model implemented by a plugin loaded at runtime.
+ */
+#include "computation/PropagationModelPlugin.hxx"
+#include <stdexcept>
+
+PropagationModelPlugin::PropagationModelPlugin(std::shared_ptr<const ModelPlugin> plugin, const WeightedEdgeGraph* graph, const std::vector<double>& parameters):plugin(plugin),parameters(parameters){
+    if(!this->plugin){
+        throw std::invalid_argument("[ERROR] PropagationModelPlugin::PropagationModelPlugin: the plugin is not set. abort");
+    }
+    if(!this->plugin->provides(MASFENON_MODEL_PROPAGATION)){
+        throw std::invalid_argument("[ERROR] PropagationModelPlugin::PropagationModelPlugin: the plugin " + this->plugin->getName() + " does not implement a propagation model. abort");
+    }
+    this->numNodes = graph->getNumNodes();
+    arma::Mat<double> adjacency = graph->getAdjacencyMatrix().asArmadilloMatrix();
+    this->state = this->plugin->createState(MASFENON_MODEL_PROPAGATION, this->numNodes, adjacency.memptr(), this->parameters);
+}
+
+PropagationModelPlugin::~PropagationModelPlugin(){
+    this->plugin->destroyState(this->state);
+}
+
+arma::Col<double> PropagationModelPlugin::propagate(arma::Col<double> input, double time){
+    return input + this->propagationTerm(input, time);
+}
+
+arma::Col<double> PropagationModelPlugin::propagationTerm(arma::Col<double> input, double time){
+    if(input.n_elem != this->numNodes){
+        throw std::invalid_argument("[ERROR] PropagationModelPlugin::propagationTerm: the input is not of the same size as the graph. abort");
+    }
+    arma::Col<double> output(input.n_elem);
+    int status = this->plugin->getDescriptor().propagationTerm(this->state, input.memptr(), output.memptr(), input.n_elem, time);
+    this->plugin->checkStatus(status, "PropagationModelPlugin::propagationTerm");
+    return output;
+}
+
+void PropagationModelPlugin::updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights){
+    if(static_cast<size_t>(graph->getNumNodes()) != this->numNodes){
+        throw std::invalid_argument("[ERROR] PropagationModelPlugin::updateEdgeWeights: the number of nodes of the graph changed, the model should be created again. abort");
+    }
+    arma::Mat<double> adjacency = graph->getAdjacencyMatrix().asArmadilloMatrix();
+    const MasfenonModelPlugin& descriptor = this->plugin->getDescriptor();
+    if(descriptor.updateAdjacency != nullptr){
+        this->plugin->checkStatus(descriptor.updateAdjacency(this->state, adjacency.memptr(), this->numNodes), "PropagationModelPlugin::updateEdgeWeights");
+    } else {
+        this->plugin->destroyState(this->state);
+        this->state = this->plugin->createState(MASFENON_MODEL_PROPAGATION, this->numNodes, adjacency.memptr(), this->parameters);
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file PropagationModelPlugin.hxx
+ * @ingroup Core
+ * @brief Defines the PropagationModelPlugin class, a propagation model implemented by a plugin loaded at runtime.
+ * @details The propagation term of all the nodes is computed by the plugin in a single call, see ModelPluginABI.hxx.
+ */
+#pragma once
+#include <armadillo>
+#include <memory>
+#include <vector>
+#include "computation/PropagationModel.hxx"
+#include "computation/ModelPlugin.hxx"
+#include "data_structures/WeightedEdgeGraph.hxx"
+
+/**
+ * @class PropagationModelPlugin
+ * @brief Class for propagation models implemented by a plugin.
+ * @details The propagated values are input + term, where the term is computed by the plugin. The plugin receives the adjacency matrix of the graph when the state is created.
+ * @implements PropagationModel
+ */
+class PropagationModelPlugin : public PropagationModel
+{
+    private:
+        std::shared_ptr<const ModelPlugin> plugin; ///< The plugin, kept loaded while the model exists.
+        std::vector<double> parameters; ///< The parameters of the model, kept to create the state again when the plugin cannot update it.
+        size_t numNodes; ///< The number of nodes of the graph.
+        void* state = nullptr; ///< The state of the model created by the plugin.
+    public:
+        /**
+         * @brief Constructor for the PropagationModelPlugin class.
+         * @param plugin The plugin implementing the propagation term.
+         * @param graph The graph used by the propagation model.
+         * @param parameters The parameters of the model, passed to the plugin.
+         * @throw std::invalid_argument if the plugin is nullptr or does not implement the propagation term.
+         */
+        PropagationModelPlugin(std::shared_ptr<const ModelPlugin> plugin, const WeightedEdgeGraph* graph, const std::vector<double>& parameters = std::vector<double>());
+        /**
+         * @brief Destructor for the PropagationModelPlugin class, the state of the model is destroyed by the plugin.
+         */
+        ~PropagationModelPlugin();
+        PropagationModelPlugin(const PropagationModelPlugin&) = delete;
+        PropagationModelPlugin& operator=(const PropagationModelPlugin&) = delete;
+        /**
+         * @brief Propagate the input vector.
+         * @param input The input vector to be processed.
+         * @param time The current time.
+         * @return The input plus the propagation term computed by the plugin.
+         * @throw std::runtime_error if the plugin returns an error.
+         */
+        arma::Col<double> propagate(arma::Col<double> input, double time)override;
+        /**
+         * @brief Propagation term of the input vector.
+         * @param input The input vector to be processed.
+         * @param time The current time.
+         * @return The propagation term computed by the plugin.
+         * @throw std::invalid_argument if the input is not of the size of the graph.
+         * @throw std::runtime_error if the plugin returns an error.
+         */
+        arma::Col<double> propagationTerm(arma::Col<double> input, double time)override;
+        /**
+         * @brief Pass the new adjacency matrix to the plugin after the edge weights of the graph have changed.
+         * @param graph The graph used by the propagation model, with the new edge weights already set.
+         * @param previousEdgeWeights The previous weights of the updated edges (not used, the plugin receives the whole matrix).
+         * @details If the plugin does not implement updateAdjacency, the state is created again.
+         * @throw std::invalid_argument if the number of nodes of the graph changed.
+         */
+        void updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights)override;
+};
@@ -10,6 +10,7 @@
 #pragma once
 #include <armadillo>
 #include <functional>
+#include <tuple>
 #include <vector>
 #include "data_structures/WeightedEdgeGraph.hxx"
 
@@ -48,6 +49,14 @@ class PropagationModelVectorized{
          * @details This function is used to compute the propagation term of the input vector.
          */
         virtual arma::Mat<double> propagationTerm(arma::Mat<double> input, double time) = 0;
+        /**
+         * @brief Update the propagation operator after the edge weights of the graph have changed.
+         * @param graph The graph used by the propagation model, with the new edge weights already set (the number of nodes must not change).
+         * @param previousEdgeWeights The previous weights of the updated edges, as returned by WeightedEdgeGraph::updateEdgeWeights (source index, target index, previous weight).
+         * @details Only the parts of the operator relative to the changed source nodes are updated, instead of rebuilding the whole operator.
+         * @throw std::invalid_argument if the number of nodes of the graph is different from the size of the operator.
+         */
+        virtual void updateEdgeWeights(const WeightedEdgeGraph* graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights) = 0;
 
         //getters and setters
         /**
@@ -0,0 +1,119 @@
+/**
+ * @file ScaleSchedule.cxx
+ * @ingroup Core
+ * @brief Implements the ScaleSchedule and ScaleSchedulePool classes used to precompute the scaling values of the models over the simulation time grid.
+ */
+#include "computation/ScaleSchedule.hxx"
+#include "logging/Logger.hxx"
+#include "utils/mathUtilities.hxx"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    /**
+     * @brief Maximum number of values stored in a schedule, the times after the limit are not stored and evaluated with the scale function.
+     */
+    constexpr arma::uword maxStoredValues = arma::uword(1) << 23;
+
+    /**
+     * @brief Tolerance used to match a time with the times of the grid.
+     * @param time The time.
+     * @return The absolute tolerance.
+     */
+    double timeTolerance(double time){
+        return 1e-12 * std::max(1.0, std::abs(time));
+    }
+}
+
+ScaleSchedule::ScaleSchedule(const std::vector<double>& times, const std::function<arma::Col<double>(double)>& scaleFunctionVectorized, arma::uword numElements):numElements(numElements){
+    prefixHashes.push_back(0);
+    uint64_t columnHash = 0;
+    std::vector<double> sortedTimes = times;
+    std::sort(sortedTimes.begin(), sortedTimes.end());
+    sortedTimes.erase(std::unique(sortedTimes.begin(), sortedTimes.end()), sortedTimes.end());
+    for(const auto& time : sortedTimes){
+        arma::Col<double> values = scaleFunctionVectorized(time);
+        if(values.n_elem != numElements){
+            throw std::invalid_argument("[ERROR] ScaleSchedule::ScaleSchedule: the scale function returned " + std::to_string(values.n_elem) + " values at time " + std::to_string(time) + ", expected " + std::to_string(numElements) + ". abort");
+        }
+        if(columns.empty() || !arma::approx_equal(columns.back(), values, "absdiff", 0.0)){
+            if((columns.size() + 1) * numElements > maxStoredValues){
+                Logger::getInstance().printWarning("ScaleSchedule::ScaleSchedule: too many distinct scaling values to store, the times after " + std::to_string(time) + " will be evaluated during the computation");
+                complete = false;
+                break;
+            }
+            columns.push_back(std::move(values));
+            columnHash = hashDoubles(columns.back().memptr(), columns.back().n_elem);
+        }
+        this->times.push_back(time);
+        timeToColumn.push_back(columns.size() - 1);
+        prefixHashes.push_back(hashCombine(prefixHashes.back(), columnHash));
+    }
+}
+
+std::optional<uint64_t> ScaleSchedule::prefixHash(double time) const{
+    // number of stored times before the time
+    auto it = std::lower_bound(times.begin(), times.end(), time - timeTolerance(time));
+    if(it == times.end() && !complete){
+        return std::nullopt;
+    }
+    return prefixHashes[std::distance(times.begin(), it)];
+}
+
+std::vector<double> ScaleSchedule::changeTimes() const{
+    std::vector<double> changes;
+    for(size_t i = 1; i < times.size(); i++){
+        if(timeToColumn[i] != timeToColumn[i-1]){
+            changes.push_back(times[i]);
+        }
+    }
+    return changes;
+}
+
+const arma::Col<double>* ScaleSchedule::at(double time) const{
+    double tolerance = timeTolerance(time);
+    auto it = std::lower_bound(times.begin(), times.end(), time - tolerance);
+    if(it == times.end() || std::abs(*it - time) > tolerance){
+        return nullptr;
+    }
+    return &columns[timeToColumn[std::distance(times.begin(), it)]];
+}
+
+bool ScaleSchedule::operator==(const ScaleSchedule& other) const{
+    if(numElements != other.numElements || times != other.times || timeToColumn != other.timeToColumn || columns.size() != other.columns.size()){
+        return false;
+    }
+    for(size_t i = 0; i < columns.size(); i++){
+        if(!arma::approx_equal(columns[i], other.columns[i], "absdiff", 0.0)){
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<double> ScaleSchedule::simulationTimeGrid(int intertypeIterations, int intratypeIterations, double timestep){
+    std::vector<double> grid;
+    if(intertypeIterations <= 0 || intratypeIterations <= 0){
+        return grid;
+    }
+    grid.reserve(intertypeIterations * intratypeIterations);
+    for(int iterationInterType = 0; iterationInterType < intertypeIterations; iterationInterType++){
+        for(int iterationIntraType = 0; iterationIntraType < intratypeIterations; iterationIntraType++){
+            grid.push_back((iterationInterType*intratypeIterations + iterationIntraType)*(timestep/intratypeIterations));
+        }
+    }
+    return grid;
+}
+
+std::shared_ptr<const ScaleSchedule> ScaleSchedulePool::getSchedule(const std::vector<double>& times, const std::function<arma::Col<double>(double)>& scaleFunctionVectorized, arma::uword numElements){
+    std::shared_ptr<const ScaleSchedule> schedule = std::make_shared<const ScaleSchedule>(times, scaleFunctionVectorized, numElements);
+    for(const auto& pooledSchedule : schedules){
+        if(*pooledSchedule == *schedule){
+            return pooledSchedule;
+        }
+    }
+    schedules.push_back(schedule);
+    return schedule;
+}
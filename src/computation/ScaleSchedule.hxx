@@ -0,0 +1,106 @@
+/**
+ * @file ScaleSchedule.hxx
+ * @ingroup Core
+ * @brief Defines the ScaleSchedule and ScaleSchedulePool classes used to precompute the scaling values of the models over the simulation time grid.
+ * @details The time grid of the simulation is known before the computation starts, so the vectorized scale functions of the models can be evaluated once for every distinct time
+ * and stored in a table. During the computation the models get a pointer to the precomputed values instead of evaluating the scale function and allocating a new vector for every step.
+ */
+#pragma once
+#include <armadillo>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+/**
+ * @class ScaleSchedule
+ * @brief Precomputed scaling values of a vectorized scale function over a time grid.
+ * @details Consecutive times with the same scaling values (as in the piecewise constant functions) share the same stored column, so the schedule is compact.
+ * @details Times that are not in the grid are not stored, the models fall back to the scale function for them.
+ */
+class ScaleSchedule{
+    private:
+        std::vector<double> times; ///< sorted distinct times of the grid
+        std::vector<arma::uword> timeToColumn; ///< index of the stored column for every time of the grid
+        std::vector<arma::Col<double>> columns; ///< distinct consecutive scaling values
+        arma::uword numElements = 0; ///< number of elements (nodes) of the scaling values
+        std::vector<uint64_t> prefixHashes; ///< hash of the scaling values of the first k times of the grid, for every k from 0 to the number of stored times
+        bool complete = true; ///< false if the times after the last stored one were not stored because of the size limit
+    public:
+        /**
+         * @brief Constructor for the ScaleSchedule class.
+         * @param times The times of the grid, duplicated times are evaluated only once.
+         * @param scaleFunctionVectorized The vectorized scale function to be evaluated.
+         * @param numElements The expected number of elements returned by the scale function.
+         * @throw std::invalid_argument if the scale function returns a vector with a different number of elements.
+         */
+        ScaleSchedule(const std::vector<double>& times, const std::function<arma::Col<double>(double)>& scaleFunctionVectorized, arma::uword numElements);
+        /**
+         * @brief Get the precomputed scaling values at a given time.
+         * @param time The time.
+         * @return A pointer to the precomputed scaling values, nullptr if the time is not in the grid.
+         */
+        const arma::Col<double>* at(double time) const;
+        /**
+         * @brief Get the number of elements of the scaling values.
+         * @return The number of elements.
+         */
+        arma::uword getNumElements() const {return numElements;}
+        /**
+         * @brief Get the number of distinct stored columns.
+         * @return The number of stored columns.
+         */
+        arma::uword getNumStoredColumns() const {return columns.size();}
+        /**
+         * @brief Get the hash of the scaling values at the times of the grid before a given time.
+         * @param time The time, the times of the grid equal to it are not included.
+         * @return The hash of the scaling values used before the time, nullopt if some of them were not stored.
+         * @details Two schedules over the same grid with the same hash at a time give the same scaling values before that time, so the computations with them
+         * reach the same state at that time even if the scaling values differ later. Used as key of the saved states, @see TrajectoryCache
+         */
+        std::optional<uint64_t> prefixHash(double time) const;
+        /**
+         * @brief Get the times of the grid where the scaling values change.
+         * @return The sorted times whose scaling values are different from the ones of the previous time of the grid (the first time is not included).
+         */
+        std::vector<double> changeTimes() const;
+        /**
+         * @brief Check if two schedules contain the same times and scaling values.
+         * @param other The other schedule.
+         * @return true if the schedules are equal, false otherwise.
+         */
+        bool operator==(const ScaleSchedule& other) const;
+        /**
+         * @brief Get the times of the simulation grid.
+         * @param intertypeIterations The number of intertype iterations.
+         * @param intratypeIterations The number of intratype iterations.
+         * @param timestep The timestep of an intertype iteration.
+         * @return The sorted times, computed as (iterationInterType*intratypeIterations + iterationIntraType)*(timestep/intratypeIterations) like in the main loop.
+         */
+        static std::vector<double> simulationTimeGrid(int intertypeIterations, int intratypeIterations, double timestep);
+};
+
+/**
+ * @class ScaleSchedulePool
+ * @brief Pool of schedules shared between models (and agents) with identical scaling values.
+ * @details A schedule is built for every request, but if an equal schedule is already in the pool, the pooled one is returned and the new one is discarded.
+ */
+class ScaleSchedulePool{
+    private:
+        std::vector<std::shared_ptr<const ScaleSchedule>> schedules; ///< the distinct schedules
+    public:
+        /**
+         * @brief Get a schedule for the scale function, shared with the other identical schedules.
+         * @param times The times of the grid.
+         * @param scaleFunctionVectorized The vectorized scale function to be evaluated.
+         * @param numElements The expected number of elements returned by the scale function.
+         * @return The shared schedule.
+         */
+        std::shared_ptr<const ScaleSchedule> getSchedule(const std::vector<double>& times, const std::function<arma::Col<double>(double)>& scaleFunctionVectorized, arma::uword numElements);
+        /**
+         * @brief Get the number of distinct schedules in the pool.
+         * @return The number of distinct schedules.
+         */
+        size_t size() const {return schedules.size();}
+};
@@ -0,0 +1,33 @@
+/**
+ * @file SensitivityParameter.hxx
+ * @ingroup Core
+ * @brief Defines the SensitivityParameter structure, a parameter of the per node scaling functions whose sensitivities are propagated by the computation.
+ * @details A parameter changes the scaling value of a single node of a single model (dissipation, propagation or conservation), so its effect on the step
+ * is described by the node, the model and the derivative of the scaling value of the node with respect to the parameter as a function of the time.
+ * @see Computation::setSensitivityParameters
+ */
+#pragma once
+#include <armadillo>
+#include <functional>
+#include <string>
+
+/**
+ * @enum SensitivityTarget
+ * @brief The model whose scaling values depend on a sensitivity parameter.
+ */
+enum class SensitivityTarget{
+    dissipation, ///< the parameter changes the scaling values of the dissipation model
+    propagation, ///< the parameter changes the scaling values of the propagation model
+    conservation ///< the parameter changes the scaling values of the conservation model
+};
+
+/**
+ * @struct SensitivityParameter
+ * @brief A parameter of the scaling function of a node.
+ */
+struct SensitivityParameter{
+    std::string name; ///< name of the parameter, used in the saved sensitivities
+    SensitivityTarget target = SensitivityTarget::dissipation; ///< model whose scaling values depend on the parameter
+    arma::uword node = 0; ///< index of the node (in the augmented graph) whose scaling value depends on the parameter
+    std::function<double(double)> scaleDerivative; ///< derivative of the scaling value of the node with respect to the parameter, as a function of the time
+};
@@ -0,0 +1,56 @@
+/**
+ * @file StepKernel.cxx
+ * @ingroup Core
+ * @brief Implements the selection of the step kernels, the instantiations of StepKernel for the combinations of models available from the command line.
+ */
+#include "computation/StepKernel.hxx"
+#include <stdexcept>
+#include <typeinfo>
+
+namespace {
+    template<typename Dissipation, typename Propagation, typename Conservation>
+    std::shared_ptr<const StepKernelBase> selectSaturation(bool defaultSaturation){
+        if(defaultSaturation){
+            return std::make_shared<const StepKernel<Dissipation, Propagation, Conservation, ClampSaturation>>();
+        }
+        return std::make_shared<const StepKernel<Dissipation, Propagation, Conservation, GenericSaturation>>();
+    }
+
+    template<typename Dissipation, typename Propagation>
+    std::shared_ptr<const StepKernelBase> selectConservation(const ModelProperties& conservationProperties, bool defaultSaturation){
+        if(conservationProperties.zero){
+            return selectSaturation<Dissipation, Propagation, ZeroConservation>(defaultSaturation);
+        }
+        if(conservationProperties.constantScale){
+            return selectSaturation<Dissipation, Propagation, ConstantConservation>(defaultSaturation);
+        }
+        return selectSaturation<Dissipation, Propagation, GenericConservation>(defaultSaturation);
+    }
+
+    template<typename Dissipation>
+    std::shared_ptr<const StepKernelBase> selectPropagation(const PropagationModel* propagationModel, const ModelProperties& conservationProperties, bool defaultSaturation){
+        // only the exact types are bound statically, a derived class could override propagate
+        if(typeid(*propagationModel) == typeid(PropagationModelOriginal)){
+            return selectConservation<Dissipation, StaticPropagation<PropagationModelOriginal>>(conservationProperties, defaultSaturation);
+        }
+        if(typeid(*propagationModel) == typeid(PropagationModelNeighbors)){
+            return selectConservation<Dissipation, StaticPropagation<PropagationModelNeighbors>>(conservationProperties, defaultSaturation);
+        }
+        return selectConservation<Dissipation, GenericPropagation>(conservationProperties, defaultSaturation);
+    }
+}
+
+std::shared_ptr<const StepKernelBase> makeStepKernel(const DissipationModel* dissipationModel, const PropagationModel* propagationModel, const ConservationModel* conservationModel, bool defaultSaturation){
+    if(dissipationModel == nullptr || propagationModel == nullptr || conservationModel == nullptr){
+        throw std::invalid_argument("[ERROR] makeStepKernel: the models are not set. abort");
+    }
+    const ModelProperties dissipationProperties = dissipationModel->getProperties();
+    const ModelProperties conservationProperties = conservationModel->getProperties();
+    if(dissipationProperties.identity){
+        return selectPropagation<IdentityDissipation>(propagationModel, conservationProperties, defaultSaturation);
+    }
+    if(dissipationProperties.constantScale){
+        return selectPropagation<ConstantDissipation>(propagationModel, conservationProperties, defaultSaturation);
+    }
+    return selectPropagation<GenericDissipation>(propagationModel, conservationProperties, defaultSaturation);
+}
@@ -0,0 +1,234 @@
+/**
+ * @file StepKernel.hxx
+ * @ingroup Core
+ * @brief Defines the StepKernel class template used to compose the dissipation, propagation, conservation and saturation of a computation step at compile time.
+ * @details A step of the computation dissipates the input, propagates the dissipated input, subtracts the conservation term and saturates the output.
+ * Calling the models through their interfaces costs a virtual call (and often a std::function call) for every part of the step.
+ * The step kernels are instantiated for the combinations of models available from the command line, so the parts of the step are bound statically and can be inlined and fused.
+ * The kernel is selected once, when the models are set, by makeStepKernel. Custom models use the generic parts, that call the models through their interfaces.
+ */
+#pragma once
+#include <algorithm>
+#include <armadillo>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "computation/ConservationModel.hxx"
+#include "computation/DissipationModel.hxx"
+#include "computation/ModelProperties.hxx"
+#include "computation/PropagationModel.hxx"
+#include "computation/PropagationModelNeighbors.hxx"
+#include "computation/PropagationModelOriginal.hxx"
+#include "utils/mathUtilities.hxx"
+
+/**
+ * @struct StepOperands
+ * @brief The operands of a computation step, filled by the computation before calling the kernel.
+ */
+struct StepOperands{
+    const arma::Col<double>* input = nullptr; ///< the augmented input
+    double time = 0; ///< the current time
+    DissipationModel* dissipationModel = nullptr; ///< the dissipation model
+    PropagationModel* propagationModel = nullptr; ///< the propagation model
+    ConservationModel* conservationModel = nullptr; ///< the conservation model
+    double dissipationScale = 0; ///< the constant scale of the dissipation model, used by ConstantDissipation
+    double conservationScale = 0; ///< the constant scale of the conservation model, used by ConstantConservation
+    const arma::Col<double>* conservationWeights = nullptr; ///< Wstar*q, used by ConstantConservation
+    const arma::Mat<double>* Wstar = nullptr; ///< the normalized adjacency matrix, used by GenericConservation
+    const std::vector<double>* q = nullptr; ///< the q vector of the conservation, used by GenericConservation
+    const std::vector<double>* saturationVector = nullptr; ///< the saturation values, nullptr if the output is not saturated
+    const BatchSaturationFunction* saturationFunction = nullptr; ///< the batch saturation function, used by GenericSaturation
+};
+
+/**
+ * @brief Dissipation part of the step for a dissipation model that is the identity (zero dissipation term).
+ */
+struct IdentityDissipation{
+    static constexpr const char* name = "identity";
+    static const arma::Col<double>& apply(const StepOperands& operands){return *operands.input;}
+};
+
+/**
+ * @brief Dissipation part of the step for a dissipation model with a constant scale, input - scale*input.
+ */
+struct ConstantDissipation{
+    static constexpr const char* name = "constant";
+    static arma::Col<double> apply(const StepOperands& operands){return *operands.input - operands.dissipationScale * *operands.input;}
+};
+
+/**
+ * @brief Dissipation part of the step for a generic dissipation model, called through its interface.
+ */
+struct GenericDissipation{
+    static constexpr const char* name = "generic";
+    static arma::Col<double> apply(const StepOperands& operands){return operands.dissipationModel->dissipate(*operands.input, operands.time);}
+};
+
+/**
+ * @brief Name of the statically bound propagation models, used in the description of the kernels.
+ * @tparam Model The exact type of the propagation model.
+ */
+template<typename Model> inline constexpr const char* propagationKernelName = "static";
+template<> inline constexpr const char* propagationKernelName<PropagationModelOriginal> = "original";
+template<> inline constexpr const char* propagationKernelName<PropagationModelNeighbors> = "neighbors";
+
+/**
+ * @brief Propagation part of the step for a propagation model of a known type, the call is bound statically.
+ * @tparam Model The exact type of the propagation model.
+ */
+template<typename Model>
+struct StaticPropagation{
+    static constexpr const char* name = propagationKernelName<Model>;
+    static arma::Col<double> apply(const StepOperands& operands, const arma::Col<double>& dissipated){
+        return static_cast<Model*>(operands.propagationModel)->Model::propagate(dissipated, operands.time);
+    }
+};
+
+/**
+ * @brief Propagation part of the step for a generic propagation model, called through its interface.
+ */
+struct GenericPropagation{
+    static constexpr const char* name = "generic";
+    static arma::Col<double> apply(const StepOperands& operands, const arma::Col<double>& dissipated){
+        return operands.propagationModel->propagate(dissipated, operands.time);
+    }
+};
+
+/**
+ * @brief Conservation part of the step for a conservation model with a zero conservation term, nothing is computed.
+ */
+struct ZeroConservation{
+    static constexpr const char* name = "zero";
+    static constexpr bool needsNormalizedAdjacency = false;
+    static constexpr bool needsConservationWeights = false;
+    static void apply(const StepOperands& operands, const arma::Col<double>& dissipated, arma::Col<double>& output){}
+};
+
+/**
+ * @brief Conservation part of the step for a conservation model with a constant scale, the term scale*(Wstar*q)%input is subtracted in a single pass.
+ */
+struct ConstantConservation{
+    static constexpr const char* name = "constant";
+    static constexpr bool needsNormalizedAdjacency = false;
+    static constexpr bool needsConservationWeights = true;
+    static void apply(const StepOperands& operands, const arma::Col<double>& dissipated, arma::Col<double>& output){
+        const double scale = operands.conservationScale;
+        const double* weights = operands.conservationWeights->memptr();
+        const double* values = dissipated.memptr();
+        double* outputValues = output.memptr();
+        const arma::uword numElements = output.n_elem;
+        #pragma omp simd
+        for(arma::uword i = 0; i < numElements; i++){
+            outputValues[i] -= scale * weights[i] * values[i];
+        }
+    }
+};
+
+/**
+ * @brief Conservation part of the step for a generic conservation model, called through its interface.
+ */
+struct GenericConservation{
+    static constexpr const char* name = "generic";
+    static constexpr bool needsNormalizedAdjacency = true;
+    static constexpr bool needsConservationWeights = false;
+    static void apply(const StepOperands& operands, const arma::Col<double>& dissipated, arma::Col<double>& output){
+        output -= operands.conservationModel->conservationTerm(dissipated, *operands.Wstar, operands.time, *operands.q);
+    }
+};
+
+/**
+ * @brief Saturation part of the step for the default saturation function, the values are clamped in [-saturation, saturation].
+ */
+struct ClampSaturation{
+    static constexpr const char* name = "clamp";
+    static void apply(const StepOperands& operands, arma::Col<double>& output){
+        const double* saturations = operands.saturationVector->data();
+        double* outputValues = output.memptr();
+        const arma::uword numElements = output.n_elem;
+        // without branches, so that the pass over the output is vectorized
+        #pragma omp simd
+        for(arma::uword i = 0; i < numElements; i++){
+            outputValues[i] = std::min(std::max(outputValues[i], -saturations[i]), saturations[i]);
+        }
+    }
+};
+
+/**
+ * @brief Saturation part of the step for a custom saturation function, a batch function called once on the whole output.
+ */
+struct GenericSaturation{
+    static constexpr const char* name = "generic";
+    static void apply(const StepOperands& operands, arma::Col<double>& output){
+        (*operands.saturationFunction)(output.memptr(), operands.saturationVector->data(), output.n_elem);
+    }
+};
+
+/**
+ * @class StepKernelBase
+ * @brief Interface of the step kernels, a single virtual call per step.
+ */
+class StepKernelBase{
+    public:
+        virtual ~StepKernelBase(){}
+        /**
+         * @brief Compute a step.
+         * @param operands The operands of the step.
+         * @return The output of the step, saturated if operands.saturationVector is not nullptr.
+         */
+        virtual arma::Col<double> step(const StepOperands& operands) const = 0;
+        /**
+         * @brief Check if the kernel uses the normalized adjacency matrix (operands.Wstar).
+         * @return true if the kernel needs the normalized adjacency matrix.
+         */
+        virtual bool needsNormalizedAdjacency() const = 0;
+        /**
+         * @brief Check if the kernel uses the conservation weights Wstar*q (operands.conservationWeights).
+         * @return true if the kernel needs the conservation weights.
+         */
+        virtual bool needsConservationWeights() const = 0;
+        /**
+         * @brief Get the description of the kernel, in the form dissipation/propagation/conservation/saturation.
+         * @return The description of the kernel.
+         */
+        virtual std::string description() const = 0;
+};
+
+/**
+ * @class StepKernel
+ * @brief Step kernel composed at compile time from its parts.
+ * @tparam Dissipation The dissipation part (IdentityDissipation, ConstantDissipation or GenericDissipation).
+ * @tparam Propagation The propagation part (StaticPropagation<Model> or GenericPropagation).
+ * @tparam Conservation The conservation part (ZeroConservation, ConstantConservation or GenericConservation).
+ * @tparam Saturation The saturation part (ClampSaturation or GenericSaturation).
+ */
+template<typename Dissipation, typename Propagation, typename Conservation, typename Saturation>
+class StepKernel : public StepKernelBase{
+    public:
+        arma::Col<double> step(const StepOperands& operands) const override{
+            decltype(auto) dissipated = Dissipation::apply(operands);
+            arma::Col<double> output = Propagation::apply(operands, dissipated);
+            Conservation::apply(operands, dissipated, output);
+            if(operands.saturationVector != nullptr){
+                Saturation::apply(operands, output);
+            }
+            return output;
+        }
+        bool needsNormalizedAdjacency() const override {return Conservation::needsNormalizedAdjacency;}
+        bool needsConservationWeights() const override {return Conservation::needsConservationWeights;}
+        std::string description() const override {
+            return std::string(Dissipation::name) + "/" + Propagation::name + "/" + Conservation::name + "/" + Saturation::name;
+        }
+};
+
+/**
+ * @brief Select the step kernel for the models.
+ * @param dissipationModel The dissipation model.
+ * @param propagationModel The propagation model.
+ * @param conservationModel The conservation model.
+ * @param defaultSaturation true if the saturation function is the default one (clamping).
+ * @return The step kernel, the parts are chosen from the properties of the dissipation and conservation models and from the exact type of the propagation model.
+ * @throw std::invalid_argument if one of the models is nullptr.
+ */
+std::shared_ptr<const StepKernelBase> makeStepKernel(const DissipationModel* dissipationModel, const PropagationModel* propagationModel, const ConservationModel* conservationModel, bool defaultSaturation);
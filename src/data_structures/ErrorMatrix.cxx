@@ -0,0 +1,233 @@
+/**
+ * @file ErrorMatrix.cxx
+ * @ingroup Core
+ * @brief Implements the ErrorMatrix class used for scoring the simulated types against their reference time series.
+ */
+#include "data_structures/ErrorMatrix.hxx"
+#include "utils/stringUtilities.hxx"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    /**
+     * @brief Convert an entry of the reference file to a value, the entries that are not numbers are NaN (as in createErrorMatrix.py).
+     * @param entry The entry of the file.
+     * @return The value of the entry.
+     */
+    double entryToValue(const std::string& entry){
+        try{
+            size_t parsed = 0;
+            double value = std::stod(entry, &parsed);
+            return parsed == entry.size() ? value : std::numeric_limits<double>::quiet_NaN();
+        } catch(const std::exception& e){
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+
+    /**
+     * @brief Split a line of a tsv file, removing the carriage return and the empty trailing entries.
+     * @param line The line.
+     * @return The entries of the line.
+     */
+    std::vector<std::string> tsvEntries(std::string line){
+        if(!line.empty() && line.back() == '\r'){
+            line.pop_back();
+        }
+        std::vector<std::string> entries = splitStringIntoVector(line, "\t");
+        while(!entries.empty() && entries.back().empty()){
+            entries.pop_back();
+        }
+        return entries;
+    }
+}
+
+ErrorMatrix::ErrorMatrix(const std::vector<std::string>& referenceNodeNames, const std::vector<double>& referenceTimes, const arma::Mat<double>& referenceValues, const std::vector<std::string>& simulationNodeNames, double timeTolerance):timeTolerance(timeTolerance){
+    if(referenceValues.n_rows != referenceNodeNames.size() || referenceValues.n_cols != referenceTimes.size()){
+        throw std::invalid_argument("[ERROR] ErrorMatrix::ErrorMatrix: the reference values are " + std::to_string(referenceValues.n_rows) + "x" + std::to_string(referenceValues.n_cols) + " but there are " + std::to_string(referenceNodeNames.size()) + " nodes and " + std::to_string(referenceTimes.size()) + " times. abort");
+    }
+    // the times are sorted, the values follow the same order
+    std::vector<arma::uword> order(referenceTimes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&referenceTimes](arma::uword first, arma::uword second){return referenceTimes[first] < referenceTimes[second];});
+    for(arma::uword index : order){
+        if(!times.empty() && times.back() == referenceTimes[index]){
+            throw std::invalid_argument("[ERROR] ErrorMatrix::ErrorMatrix: the time " + std::to_string(referenceTimes[index]) + " is duplicated in the reference. abort");
+        }
+        times.push_back(referenceTimes[index]);
+    }
+    this->referenceValues = referenceValues.cols(arma::uvec(order));
+    initialize(referenceNodeNames, simulationNodeNames);
+}
+
+ErrorMatrix::ErrorMatrix(const std::string& referenceFilename, const std::vector<std::string>& simulationNodeNames, double timeTolerance):timeTolerance(timeTolerance){
+    std::ifstream referenceFile(referenceFilename);
+    if(!referenceFile.is_open()){
+        throw std::invalid_argument("[ERROR] ErrorMatrix::ErrorMatrix: unable to open the reference file " + referenceFilename + ". abort");
+    }
+    std::string line;
+    if(!std::getline(referenceFile, line)){
+        throw std::invalid_argument("[ERROR] ErrorMatrix::ErrorMatrix: the reference file " + referenceFilename + " is empty. abort");
+    }
+    std::vector<std::string> header = tsvEntries(line);
+    if(header.empty() || header[0] != "nodeNames"){
+        throw std::invalid_argument("[ERROR] ErrorMatrix::ErrorMatrix: the first column of the reference file " + referenceFilename + " is not nodeNames. abort");
+    }
+    std::vector<double> referenceTimes;
+    for(size_t i = 1; i < header.size(); i++){
+        double time = entryToValue(header[i]);
+        if(std::isnan(time)){
+            throw std::invalid_argument("[ERROR] ErrorMatrix::ErrorMatrix: the column " + header[i] + " of the reference file " + referenceFilename + " is not a time. abort");
+        }
+        referenceTimes.push_back(time);
+    }
+    std::vector<std::string> referenceNodeNames;
+    std::vector<std::vector<double>> rows;
+    while(std::getline(referenceFile, line)){
+        std::vector<std::string> entries = tsvEntries(line);
+        if(entries.empty()){
+            continue;
+        }
+        if(entries.size() > header.size()){
+            throw std::invalid_argument("[ERROR] ErrorMatrix::ErrorMatrix: the node " + entries[0] + " of the reference file " + referenceFilename + " has more values than times. abort");
+        }
+        referenceNodeNames.push_back(entries[0]);
+        // missing values are NaN
+        std::vector<double> row(referenceTimes.size(), std::numeric_limits<double>::quiet_NaN());
+        for(size_t i = 1; i < entries.size(); i++){
+            row[i-1] = entryToValue(entries[i]);
+        }
+        rows.push_back(row);
+    }
+    arma::Mat<double> values(rows.size(), referenceTimes.size());
+    for(size_t i = 0; i < rows.size(); i++){
+        for(size_t j = 0; j < referenceTimes.size(); j++){
+            values(i,j) = rows[i][j];
+        }
+    }
+    *this = ErrorMatrix(referenceNodeNames, referenceTimes, values, simulationNodeNames, timeTolerance);
+}
+
+void ErrorMatrix::initialize(const std::vector<std::string>& referenceNodeNames, const std::vector<std::string>& simulationNodeNames){
+    std::unordered_map<std::string, arma::uword> simulationNodeToIndex;
+    for(arma::uword i = 0; i < simulationNodeNames.size(); i++){
+        simulationNodeToIndex.emplace(simulationNodeNames[i], i);
+    }
+    // only the reference nodes present in the simulation are scored
+    std::vector<arma::uword> referenceRows;
+    for(arma::uword i = 0; i < referenceNodeNames.size(); i++){
+        auto simulationIndex = simulationNodeToIndex.find(referenceNodeNames[i]);
+        if(simulationIndex != simulationNodeToIndex.end()){
+            nodeNames.push_back(referenceNodeNames[i]);
+            simulationIndexes.push_back(simulationIndex->second);
+            referenceRows.push_back(i);
+        }
+    }
+    this->referenceValues = this->referenceValues.rows(arma::uvec(referenceRows));
+    reset();
+}
+
+arma::uword ErrorMatrix::timeColumn(double time) const{
+    // the reference time closest to the simulated time, the times are sorted
+    auto upper = std::lower_bound(times.begin(), times.end(), time);
+    double tolerance = timeTolerance * std::max(1.0, std::abs(time));
+    if(upper != times.end() && std::abs(*upper - time) <= tolerance){
+        return std::distance(times.begin(), upper);
+    } else if(upper != times.begin() && std::abs(*std::prev(upper) - time) <= tolerance){
+        return std::distance(times.begin(), std::prev(upper));
+    }
+    return times.size();
+}
+
+bool ErrorMatrix::accumulate(double time, const std::vector<double>& simulationValues){
+    arma::uword column = timeColumn(time);
+    if(column == times.size()){
+        return false;
+    }
+    for(arma::uword i = 0; i < simulationIndexes.size(); i++){
+        if(simulationIndexes[i] >= simulationValues.size()){
+            throw std::invalid_argument("[ERROR] ErrorMatrix::accumulate: the node " + nodeNames[i] + " is not in the " + std::to_string(simulationValues.size()) + " simulated values. abort");
+        }
+    }
+    // the same time computed again replaces the previous errors
+    if(computedTimes[column]){
+        for(arma::uword i = 0; i < errors.n_rows; i++){
+            if(std::isfinite(errors(i,column))){
+                sumSquaredErrors -= errors(i,column) * errors(i,column);
+                numErrors--;
+            }
+        }
+    }
+    for(arma::uword i = 0; i < errors.n_rows; i++){
+        double error = simulationValues[simulationIndexes[i]] - referenceValues(i,column);
+        errors(i,column) = error;
+        if(std::isfinite(error)){
+            sumSquaredErrors += error * error;
+            numErrors++;
+        }
+    }
+    computedTimes[column] = true;
+    return true;
+}
+
+arma::Row<double> ErrorMatrix::sumSquaredErrorsGradient(double time, const arma::Mat<double>& sensitivities) const{
+    arma::Row<double> gradient(sensitivities.n_cols, arma::fill::zeros);
+    arma::uword column = timeColumn(time);
+    if(column == times.size() || !computedTimes[column]){
+        return gradient;
+    }
+    for(arma::uword i = 0; i < simulationIndexes.size(); i++){
+        if(simulationIndexes[i] >= sensitivities.n_rows){
+            throw std::invalid_argument("[ERROR] ErrorMatrix::sumSquaredErrorsGradient: the node " + nodeNames[i] + " is not in the " + std::to_string(sensitivities.n_rows) + " rows of the sensitivities. abort");
+        }
+        // d(error^2)/dp = 2 * error * d(simulated value)/dp, the missing reference values do not contribute
+        if(std::isfinite(errors(i,column))){
+            gradient += 2 * errors(i,column) * sensitivities.row(simulationIndexes[i]);
+        }
+    }
+    return gradient;
+}
+
+double ErrorMatrix::rmse() const{
+    if(numErrors == 0){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return std::sqrt(sumSquaredErrors / numErrors);
+}
+
+void ErrorMatrix::save(const std::string& filename) const{
+    std::ofstream outfile(filename, std::ios::out | std::ios::trunc);
+    if(!outfile.is_open()){
+        throw std::invalid_argument("[ERROR] ErrorMatrix::save: unable to open the output file " + filename + ". abort");
+    }
+    outfile.precision(10);
+    outfile << "nodeNames";
+    for(size_t j = 0; j < times.size(); j++){
+        if(computedTimes[j]){
+            outfile << "\t" << times[j];
+        }
+    }
+    outfile << std::endl;
+    for(arma::uword i = 0; i < errors.n_rows; i++){
+        outfile << nodeNames[i];
+        for(size_t j = 0; j < times.size(); j++){
+            if(computedTimes[j]){
+                outfile << "\t" << errors(i,j);
+            }
+        }
+        outfile << std::endl;
+    }
+}
+
+void ErrorMatrix::reset(){
+    errors.set_size(referenceValues.n_rows, times.size());
+    errors.fill(std::numeric_limits<double>::quiet_NaN());
+    computedTimes.assign(times.size(), false);
+    sumSquaredErrors = 0;
+    numErrors = 0;
+}
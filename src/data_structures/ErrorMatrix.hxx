@@ -0,0 +1,116 @@
+/**
+ * @file ErrorMatrix.hxx
+ * @ingroup Core
+ * @brief Defines the ErrorMatrix class, the signed errors of a simulated type against its reference time series.
+ * @details The reference time series of a type is loaded once, then the errors (simulation - reference) are accumulated while the iterations are computed,
+ * for the nodes and the times present in both the simulation and the reference. Only the error matrix (reference nodes x reference times) is kept,
+ * so the trajectories do not need to be saved to be scored.
+ * @see scripts/generalFitting/createErrorMatrix.py and scripts/generalFitting/computeRMSE-fromErrorMatrix.py for the same computation on the saved trajectories.
+ */
+#pragma once
+
+#include <armadillo>
+#include <string>
+#include <vector>
+
+/**
+ * @class ErrorMatrix
+ * @brief Online error matrix of a type against its reference time series.
+ * @details The reference nodes not present in the simulation are dropped, as well as the reference times that are never computed by the simulation.
+ * The simulated times are matched to the reference times with a relative tolerance, since the times of the simulation are computed as iteration*(timestep/intratypeIterations).
+ */
+class ErrorMatrix{
+    private:
+        std::vector<std::string> nodeNames; ///< names of the reference nodes present in the simulation
+        std::vector<arma::uword> simulationIndexes; ///< index of every reference node in the simulated values
+        std::vector<double> times; ///< sorted times of the reference time series
+        arma::Mat<double> referenceValues; ///< reference values (nodes x times)
+        arma::Mat<double> errors; ///< signed errors simulation - reference (nodes x times)
+        std::vector<bool> computedTimes; ///< true for the reference times already matched by a simulated time
+        double sumSquaredErrors = 0; ///< sum of the squared finite errors
+        arma::uword numErrors = 0; ///< number of finite errors
+        double timeTolerance; ///< relative tolerance used to match the simulated times to the reference times
+        /**
+         * @brief Initialize the errors and the mapping of the reference nodes into the simulated values.
+         * @param referenceNodeNames The names of the nodes of the reference time series.
+         * @param simulationNodeNames The names of the nodes of the simulated values.
+         */
+        void initialize(const std::vector<std::string>& referenceNodeNames, const std::vector<std::string>& simulationNodeNames);
+        /**
+         * @brief Get the column of the reference time matched by a simulated time.
+         * @param time The simulated time.
+         * @return The index of the reference time, the number of reference times if the time is not in the reference.
+         */
+        arma::uword timeColumn(double time) const;
+    public:
+        /**
+         * @brief Constructor for the ErrorMatrix class from the reference values.
+         * @param referenceNodeNames The names of the nodes of the reference time series (rows of the values).
+         * @param referenceTimes The times of the reference time series (columns of the values).
+         * @param referenceValues The reference values (nodes x times).
+         * @param simulationNodeNames The names of the nodes of the simulated values, in the order of the simulated vectors.
+         * @param timeTolerance The relative tolerance used to match the simulated times to the reference times.
+         * @throw std::invalid_argument if the sizes of the names, the times and the values do not match, or if the times are duplicated.
+         */
+        ErrorMatrix(const std::vector<std::string>& referenceNodeNames, const std::vector<double>& referenceTimes, const arma::Mat<double>& referenceValues, const std::vector<std::string>& simulationNodeNames, double timeTolerance = 1e-9);
+        /**
+         * @brief Constructor for the ErrorMatrix class from a reference time series file.
+         * @param referenceFilename The tsv file of the reference time series, with the header nodeNames followed by the times and a row for every node.
+         * @param simulationNodeNames The names of the nodes of the simulated values, in the order of the simulated vectors.
+         * @param timeTolerance The relative tolerance used to match the simulated times to the reference times.
+         * @throw std::invalid_argument if the file cannot be read or is not well formed.
+         */
+        ErrorMatrix(const std::string& referenceFilename, const std::vector<std::string>& simulationNodeNames, double timeTolerance = 1e-9);
+        /**
+         * @brief Accumulate the errors of the simulated values at a given time.
+         * @param time The time of the simulated values.
+         * @param simulationValues The simulated values, in the order of the simulation node names (additional values, like the virtual nodes, are ignored).
+         * @return true if the time is one of the reference times, false if the values were not used.
+         * @throw std::invalid_argument if there are less simulated values than simulation node names.
+         */
+        bool accumulate(double time, const std::vector<double>& simulationValues);
+        /**
+         * @brief Get the derivatives of the squared errors at a given time with respect to the parameters, from the derivatives of the simulated values.
+         * @param time The time of the simulated values, already accumulated.
+         * @param sensitivities The derivatives of the simulated values with respect to the parameters (simulated values x parameters), @see Computation::getSensitivities.
+         * @return The derivative of the sum of the squared errors of the time with respect to every parameter, zeros if the time is not in the reference or not accumulated.
+         * @throw std::invalid_argument if there are less rows in the sensitivities than simulation node names.
+         * @details Summing the derivatives of all the accumulated times gives the gradient of getSumSquaredErrors, used by the gradient based fitting.
+         */
+        arma::Row<double> sumSquaredErrorsGradient(double time, const arma::Mat<double>& sensitivities) const;
+        /**
+         * @brief Get the root mean squared error of the accumulated errors.
+         * @return The root mean squared error, NaN if no error was accumulated.
+         */
+        double rmse() const;
+        /**
+         * @brief Get the sum of the squared accumulated errors, used to aggregate the errors of more types.
+         * @return The sum of the squared finite errors.
+         */
+        double getSumSquaredErrors() const {return sumSquaredErrors;}
+        /**
+         * @brief Get the number of accumulated errors, used to aggregate the errors of more types.
+         * @return The number of finite errors.
+         */
+        arma::uword getNumErrors() const {return numErrors;}
+        /**
+         * @brief Get the names of the reference nodes present in the simulation (rows of the error matrix).
+         * @return The node names.
+         */
+        const std::vector<std::string>& getNodeNames() const {return nodeNames;}
+        /**
+         * @brief Get the signed errors, the columns of the times not yet computed are NaN.
+         * @return The error matrix (nodes x reference times).
+         */
+        const arma::Mat<double>& getErrors() const {return errors;}
+        /**
+         * @brief Save the error matrix, only the columns of the computed times are saved, with the same layout of createErrorMatrix.py.
+         * @param filename The output tsv file.
+         * @throw std::invalid_argument if the file cannot be opened.
+         */
+        void save(const std::string& filename) const;
+        /**
+         * @brief Clear the accumulated errors, to score a new simulation with the same reference.
+         */
+        void reset();
+};
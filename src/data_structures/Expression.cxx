@@ -0,0 +1,633 @@
+/**
+ * @file Expression.cxx
+ * @ingroup Core
+ * @brief Implements the Expression class, the parser, the constant folding, the compilation into bytecode and the evaluation of the expressions.
+ */
+#include "data_structures/Expression.hxx"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Node of the syntax tree of an expression.
+ * @details The leaves are constants (the parameters are substituted when parsing) and variables.
+ */
+struct ExpressionNode{
+    Expression::Operation operation; ///< the operation of the node
+    double value = 0; ///< the value of a Constant node
+    uint32_t index = 0; ///< the index of a Variable node
+    std::vector<std::shared_ptr<const ExpressionNode>> children; ///< the operands
+};
+
+namespace {
+    using Operation = Expression::Operation;
+    using NodePointer = std::shared_ptr<const ExpressionNode>;
+
+    /**
+     * @brief Get the number of operands of an operation.
+     * @param operation The operation.
+     * @return The number of operands.
+     */
+    size_t arity(Operation operation){
+        switch(operation){
+            case Operation::Constant: case Operation::Variable:
+                return 0;
+            case Operation::Negate: case Operation::Not:
+            case Operation::Sin: case Operation::Cos: case Operation::Tan: case Operation::Exp: case Operation::Log:
+            case Operation::Sqrt: case Operation::Abs: case Operation::Tanh: case Operation::Floor: case Operation::Ceil:
+                return 1;
+            case Operation::Select:
+                return 3;
+            default:
+                return 2;
+        }
+    }
+
+    /**
+     * @brief Check if an operation is a comparison.
+     * @param operation The operation.
+     * @return true if the operation is a comparison.
+     */
+    bool isComparison(Operation operation){
+        return operation == Operation::Less || operation == Operation::LessEqual || operation == Operation::Greater ||
+               operation == Operation::GreaterEqual || operation == Operation::Equal || operation == Operation::NotEqual;
+    }
+
+    /**
+     * @brief Apply an operation to its operands.
+     * @param operation The operation, not Constant or Variable.
+     * @param operands The operands, arity(operation) values.
+     * @return The result of the operation.
+     */
+    inline double applyOperation(Operation operation, const double* operands){
+        switch(operation){
+            case Operation::Negate: return -operands[0];
+            case Operation::Not: return operands[0] == 0 ? 1.0 : 0.0;
+            case Operation::Add: return operands[0] + operands[1];
+            case Operation::Subtract: return operands[0] - operands[1];
+            case Operation::Multiply: return operands[0] * operands[1];
+            case Operation::Divide: return operands[0] / operands[1];
+            case Operation::Power: return std::pow(operands[0], operands[1]);
+            case Operation::Less: return operands[0] < operands[1] ? 1.0 : 0.0;
+            case Operation::LessEqual: return operands[0] <= operands[1] ? 1.0 : 0.0;
+            case Operation::Greater: return operands[0] > operands[1] ? 1.0 : 0.0;
+            case Operation::GreaterEqual: return operands[0] >= operands[1] ? 1.0 : 0.0;
+            case Operation::Equal: return operands[0] == operands[1] ? 1.0 : 0.0;
+            case Operation::NotEqual: return operands[0] != operands[1] ? 1.0 : 0.0;
+            case Operation::And: return (operands[0] != 0 && operands[1] != 0) ? 1.0 : 0.0;
+            case Operation::Or: return (operands[0] != 0 || operands[1] != 0) ? 1.0 : 0.0;
+            case Operation::Select: return operands[0] != 0 ? operands[1] : operands[2];
+            case Operation::Sin: return std::sin(operands[0]);
+            case Operation::Cos: return std::cos(operands[0]);
+            case Operation::Tan: return std::tan(operands[0]);
+            case Operation::Exp: return std::exp(operands[0]);
+            case Operation::Log: return std::log(operands[0]);
+            case Operation::Sqrt: return std::sqrt(operands[0]);
+            case Operation::Abs: return std::abs(operands[0]);
+            case Operation::Tanh: return std::tanh(operands[0]);
+            case Operation::Floor: return std::floor(operands[0]);
+            case Operation::Ceil: return std::ceil(operands[0]);
+            case Operation::Min: return std::min(operands[0], operands[1]);
+            case Operation::Max: return std::max(operands[0], operands[1]);
+            default: return 0;
+        }
+    }
+
+    /**
+     * @brief Recursive descent parser of the expressions.
+     * @details The parameters are substituted and the constant subexpressions are folded while the tree is built.
+     */
+    class Parser{
+        private:
+            const std::string& source;
+            const std::vector<std::string>& variableNames;
+            const std::vector<double>* parameters; // nullptr if the parameters are only counted
+            size_t position = 0;
+        public:
+            size_t numParameters = 0;
+
+            Parser(const std::string& source, const std::vector<std::string>& variableNames, const std::vector<double>* parameters):source(source),variableNames(variableNames),parameters(parameters){}
+
+            NodePointer parse(){
+                NodePointer root = parseConditional();
+                skipSpaces();
+                if(position != source.size()){
+                    error("unexpected character '" + std::string(1, source[position]) + "'");
+                }
+                return root;
+            }
+        private:
+            [[noreturn]] void error(const std::string& message) const{
+                throw std::invalid_argument("[ERROR] Expression::Expression: " + message + " at position " + std::to_string(position) + " in \"" + source + "\". abort");
+            }
+
+            void skipSpaces(){
+                while(position < source.size() && std::isspace(static_cast<unsigned char>(source[position]))){
+                    position++;
+                }
+            }
+
+            bool accept(const std::string& token){
+                skipSpaces();
+                if(source.compare(position, token.size(), token) == 0){
+                    position += token.size();
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(const std::string& token){
+                if(!accept(token)){
+                    error("expected '" + token + "'");
+                }
+            }
+
+            static NodePointer constantNode(double value){
+                auto node = std::make_shared<ExpressionNode>();
+                node->operation = Operation::Constant;
+                node->value = value;
+                return node;
+            }
+
+            static NodePointer makeNode(Operation operation, std::vector<NodePointer> children){
+                // constant folding
+                bool allConstant = true;
+                std::vector<double> operands;
+                for(const auto& child : children){
+                    allConstant = allConstant && child->operation == Operation::Constant;
+                    operands.push_back(child->value);
+                }
+                if(allConstant){
+                    return constantNode(applyOperation(operation, operands.data()));
+                }
+                // a conditional with a constant condition is one of its branches
+                if(operation == Operation::Select && children[0]->operation == Operation::Constant){
+                    return children[0]->value != 0 ? children[1] : children[2];
+                }
+                auto node = std::make_shared<ExpressionNode>();
+                node->operation = operation;
+                node->children = std::move(children);
+                return node;
+            }
+
+            NodePointer parseConditional(){
+                NodePointer condition = parseOr();
+                if(accept("?")){
+                    NodePointer whenTrue = parseConditional();
+                    expect(":");
+                    NodePointer whenFalse = parseConditional();
+                    return makeNode(Operation::Select, {condition, whenTrue, whenFalse});
+                }
+                return condition;
+            }
+
+            NodePointer parseOr(){
+                NodePointer left = parseAnd();
+                while(accept("||")){
+                    left = makeNode(Operation::Or, {left, parseAnd()});
+                }
+                return left;
+            }
+
+            NodePointer parseAnd(){
+                NodePointer left = parseComparison();
+                while(accept("&&")){
+                    left = makeNode(Operation::And, {left, parseComparison()});
+                }
+                return left;
+            }
+
+            NodePointer parseComparison(){
+                NodePointer left = parseAdditive();
+                // the two characters operators are tested first
+                static const std::vector<std::pair<std::string, Operation>> comparisons{
+                    {"<=", Operation::LessEqual}, {">=", Operation::GreaterEqual}, {"==", Operation::Equal}, {"!=", Operation::NotEqual},
+                    {"<", Operation::Less}, {">", Operation::Greater}
+                };
+                for(const auto& [token, operation] : comparisons){
+                    if(accept(token)){
+                        return makeNode(operation, {left, parseAdditive()});
+                    }
+                }
+                return left;
+            }
+
+            NodePointer parseAdditive(){
+                NodePointer left = parseMultiplicative();
+                while(true){
+                    if(accept("+")){
+                        left = makeNode(Operation::Add, {left, parseMultiplicative()});
+                    } else if(accept("-")){
+                        left = makeNode(Operation::Subtract, {left, parseMultiplicative()});
+                    } else {
+                        return left;
+                    }
+                }
+            }
+
+            NodePointer parseMultiplicative(){
+                NodePointer left = parseUnary();
+                while(true){
+                    if(accept("*")){
+                        left = makeNode(Operation::Multiply, {left, parseUnary()});
+                    } else if(accept("/")){
+                        left = makeNode(Operation::Divide, {left, parseUnary()});
+                    } else {
+                        return left;
+                    }
+                }
+            }
+
+            NodePointer parseUnary(){
+                if(accept("-")){
+                    return makeNode(Operation::Negate, {parseUnary()});
+                }
+                if(accept("+")){
+                    return parseUnary();
+                }
+                skipSpaces();
+                // "!" but not "!="
+                if(source.compare(position, 1, "!") == 0 && source.compare(position, 2, "!=") != 0){
+                    position++;
+                    return makeNode(Operation::Not, {parseUnary()});
+                }
+                return parsePower();
+            }
+
+            NodePointer parsePower(){
+                NodePointer base = parsePrimary();
+                if(accept("^")){
+                    // right associative, the exponent can have a sign
+                    return makeNode(Operation::Power, {base, parseUnary()});
+                }
+                return base;
+            }
+
+            NodePointer parsePrimary(){
+                skipSpaces();
+                if(position >= source.size()){
+                    error("unexpected end of the expression");
+                }
+                if(accept("(")){
+                    NodePointer inner = parseConditional();
+                    expect(")");
+                    return inner;
+                }
+                char current = source[position];
+                if(std::isdigit(static_cast<unsigned char>(current)) || current == '.'){
+                    const char* begin = source.c_str() + position;
+                    char* end = nullptr;
+                    double value = std::strtod(begin, &end);
+                    if(end == begin){
+                        error("invalid number");
+                    }
+                    position += end - begin;
+                    return constantNode(value);
+                }
+                if(std::isalpha(static_cast<unsigned char>(current)) || current == '_'){
+                    size_t start = position;
+                    while(position < source.size() && (std::isalnum(static_cast<unsigned char>(source[position])) || source[position] == '_')){
+                        position++;
+                    }
+                    return parseName(source.substr(start, position - start));
+                }
+                error("unexpected character '" + std::string(1, current) + "'");
+            }
+
+            NodePointer parseName(const std::string& name){
+                auto variableIterator = std::find(variableNames.begin(), variableNames.end(), name);
+                if(variableIterator != variableNames.end()){
+                    auto node = std::make_shared<ExpressionNode>();
+                    node->operation = Operation::Variable;
+                    node->index = static_cast<uint32_t>(std::distance(variableNames.begin(), variableIterator));
+                    return node;
+                }
+                if(name == "p"){
+                    expect("[");
+                    skipSpaces();
+                    size_t start = position;
+                    while(position < source.size() && std::isdigit(static_cast<unsigned char>(source[position]))){
+                        position++;
+                    }
+                    if(start == position){
+                        error("expected the index of the parameter");
+                    }
+                    size_t index = std::stoul(source.substr(start, position - start));
+                    expect("]");
+                    numParameters = std::max(numParameters, index + 1);
+                    if(parameters == nullptr){
+                        return constantNode(0);
+                    }
+                    if(index >= parameters->size()){
+                        error("parameter p[" + std::to_string(index) + "] is used but only " + std::to_string(parameters->size()) + " parameters were passed");
+                    }
+                    return constantNode((*parameters)[index]);
+                }
+                if(name == "pi"){
+                    return constantNode(arma::datum::pi);
+                }
+                if(name == "e"){
+                    return constantNode(arma::datum::e);
+                }
+                static const std::vector<std::pair<std::string, Operation>> functions{
+                    {"sin", Operation::Sin}, {"cos", Operation::Cos}, {"tan", Operation::Tan}, {"exp", Operation::Exp}, {"log", Operation::Log},
+                    {"sqrt", Operation::Sqrt}, {"abs", Operation::Abs}, {"tanh", Operation::Tanh}, {"floor", Operation::Floor}, {"ceil", Operation::Ceil},
+                    {"min", Operation::Min}, {"max", Operation::Max}, {"pow", Operation::Power}
+                };
+                for(const auto& [functionName, operation] : functions){
+                    if(functionName == name){
+                        expect("(");
+                        std::vector<NodePointer> arguments{parseConditional()};
+                        while(accept(",")){
+                            arguments.push_back(parseConditional());
+                        }
+                        expect(")");
+                        if(arguments.size() != arity(operation)){
+                            error("function " + name + " expects " + std::to_string(arity(operation)) + " arguments, got " + std::to_string(arguments.size()));
+                        }
+                        return makeNode(operation, std::move(arguments));
+                    }
+                }
+                error("unknown name '" + name + "'");
+            }
+    };
+
+    /**
+     * @brief Emit the bytecode of a subtree in postfix order.
+     * @param node The root of the subtree.
+     * @param bytecode The bytecode.
+     * @param stackSize The current size of the stack, updated.
+     * @param maxStackSize The maximum size of the stack, updated.
+     */
+    void emit(const ExpressionNode& node, std::vector<Expression::Instruction>& bytecode, size_t& stackSize, size_t& maxStackSize){
+        for(const auto& child : node.children){
+            emit(*child, bytecode, stackSize, maxStackSize);
+        }
+        bytecode.push_back(Expression::Instruction{node.operation, node.value, node.index});
+        stackSize = stackSize - node.children.size() + 1;
+        maxStackSize = std::max(maxStackSize, stackSize);
+    }
+
+    /**
+     * @brief Check if a subtree depends on the first variable only through comparisons with constants.
+     * @param node The root of the subtree.
+     * @param breakpoints The constants compared with the variable, updated.
+     * @return true if the subtree is piecewise constant in the first variable.
+     */
+    bool piecewiseConstantIn(const ExpressionNode& node, std::set<double>& breakpoints){
+        if(node.operation == Operation::Constant){
+            return true;
+        }
+        if(node.operation == Operation::Variable){
+            return false;
+        }
+        if(isComparison(node.operation)){
+            const ExpressionNode& left = *node.children[0];
+            const ExpressionNode& right = *node.children[1];
+            if(left.operation == Operation::Variable && right.operation == Operation::Constant){
+                breakpoints.insert(right.value);
+                return true;
+            }
+            if(right.operation == Operation::Variable && left.operation == Operation::Constant){
+                breakpoints.insert(left.value);
+                return true;
+            }
+        }
+        for(const auto& child : node.children){
+            if(!piecewiseConstantIn(*child, breakpoints)){
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+Expression::Expression(const std::string& source, const std::vector<std::string>& variableNames, const std::vector<double>& parameters):source(source),variableNames(variableNames){
+    for(const auto& name : variableNames){
+        if(name == "p" || name == "pi" || name == "e"){
+            throw std::invalid_argument("[ERROR] Expression::Expression: the variable name " + name + " is reserved. abort");
+        }
+    }
+    Parser parser(this->source, this->variableNames, &parameters);
+    root = parser.parse();
+    numParameters = parser.numParameters;
+    compile();
+}
+
+Expression Expression::withParameters(const std::vector<double>& parameters) const{
+    return Expression(source, variableNames, parameters);
+}
+
+size_t Expression::countParameters(const std::string& source, const std::vector<std::string>& variableNames){
+    Parser parser(source, variableNames, nullptr);
+    parser.parse();
+    return parser.numParameters;
+}
+
+void Expression::compile(){
+    bytecode.clear();
+    size_t stackSize = 0;
+    maxStackSize = 0;
+    emit(*root, bytecode, stackSize, maxStackSize);
+
+    piecewiseConstant = false;
+    breakpoints.clear();
+    breakpointValues.clear();
+    intervalValues.clear();
+    if(variableNames.size() != 1){
+        return;
+    }
+    std::set<double> breakpointsSet;
+    if(!piecewiseConstantIn(*root, breakpointsSet)){
+        return;
+    }
+    for(const auto& breakpoint : breakpointsSet){
+        if(!std::isfinite(breakpoint)){
+            return;
+        }
+    }
+    breakpoints.assign(breakpointsSet.begin(), breakpointsSet.end());
+    // the value is constant between two breakpoints, so a single point is evaluated for every interval
+    for(size_t interval = 0; interval <= breakpoints.size(); interval++){
+        double point;
+        if(breakpoints.empty()){
+            point = 0;
+        } else if(interval == 0){
+            point = breakpoints.front() - 1.0;
+        } else if(interval == breakpoints.size()){
+            point = breakpoints.back() + 1.0;
+        } else {
+            point = (breakpoints[interval - 1] + breakpoints[interval]) / 2.0;
+        }
+        intervalValues.push_back(evaluateBytecode(&point));
+    }
+    for(const auto& breakpoint : breakpoints){
+        breakpointValues.push_back(evaluateBytecode(&breakpoint));
+    }
+    piecewiseConstant = true;
+}
+
+double Expression::evaluateBytecode(const double* variables) const{
+    constexpr size_t inlineStackSize = 32;
+    double inlineStack[inlineStackSize];
+    std::vector<double> heapStack;
+    double* stack = inlineStack;
+    if(maxStackSize > inlineStackSize){
+        heapStack.resize(maxStackSize);
+        stack = heapStack.data();
+    }
+    size_t stackSize = 0;
+    for(const auto& instruction : bytecode){
+        switch(instruction.operation){
+            case Operation::Constant:
+                stack[stackSize++] = instruction.value;
+                break;
+            case Operation::Variable:
+                stack[stackSize++] = variables[instruction.index];
+                break;
+            default:{
+                size_t numOperands = arity(instruction.operation);
+                stackSize -= numOperands;
+                stack[stackSize] = applyOperation(instruction.operation, stack + stackSize);
+                stackSize++;
+            }
+        }
+    }
+    return stack[0];
+}
+
+double Expression::evaluate(double variable) const{
+    if(piecewiseConstant && !std::isnan(variable)){
+        size_t interval = std::lower_bound(breakpoints.begin(), breakpoints.end(), variable) - breakpoints.begin();
+        if(interval < breakpoints.size() && breakpoints[interval] == variable){
+            return breakpointValues[interval];
+        }
+        return intervalValues[interval];
+    }
+    return evaluateBytecode(&variable);
+}
+
+double Expression::evaluate(const std::vector<double>& variables) const{
+    if(variables.size() != variableNames.size()){
+        throw std::invalid_argument("[ERROR] Expression::evaluate: expected " + std::to_string(variableNames.size()) + " variables, got " + std::to_string(variables.size()) + ". abort");
+    }
+    if(variables.size() == 1){
+        return evaluate(variables[0]);
+    }
+    return evaluateBytecode(variables.data());
+}
+
+arma::Col<double> Expression::evaluate(const std::vector<const arma::Col<double>*>& variables) const{
+    if(variables.size() != variableNames.size()){
+        throw std::invalid_argument("[ERROR] Expression::evaluate: expected " + std::to_string(variableNames.size()) + " variables, got " + std::to_string(variables.size()) + ". abort");
+    }
+    arma::uword numElements = variables.empty() ? 1 : variables[0]->n_elem;
+    for(const auto& variable : variables){
+        if(variable->n_elem != numElements){
+            throw std::invalid_argument("[ERROR] Expression::evaluate: the variables have different sizes. abort");
+        }
+    }
+    if(piecewiseConstant){
+        arma::Col<double> result(numElements);
+        const double* values = variables[0]->memptr();
+        for(arma::uword i = 0; i < numElements; i++){
+            result(i) = evaluate(values[i]);
+        }
+        return result;
+    }
+    // every instruction is applied to whole vectors
+    std::vector<arma::Col<double>> stack(maxStackSize);
+    size_t stackSize = 0;
+    for(const auto& instruction : bytecode){
+        switch(instruction.operation){
+            case Operation::Constant:
+                stack[stackSize++].set_size(numElements);
+                stack[stackSize - 1].fill(instruction.value);
+                break;
+            case Operation::Variable:
+                stack[stackSize++] = *variables[instruction.index];
+                break;
+            case Operation::Add:
+                stack[stackSize - 2] += stack[stackSize - 1];
+                stackSize--;
+                break;
+            case Operation::Subtract:
+                stack[stackSize - 2] -= stack[stackSize - 1];
+                stackSize--;
+                break;
+            case Operation::Multiply:
+                stack[stackSize - 2] %= stack[stackSize - 1];
+                stackSize--;
+                break;
+            case Operation::Divide:
+                stack[stackSize - 2] /= stack[stackSize - 1];
+                stackSize--;
+                break;
+            default:{
+                size_t numOperands = arity(instruction.operation);
+                stackSize -= numOperands;
+                double* results = stack[stackSize].memptr();
+                const double* second = numOperands > 1 ? stack[stackSize + 1].memptr() : nullptr;
+                const double* third = numOperands > 2 ? stack[stackSize + 2].memptr() : nullptr;
+                double operands[3];
+                for(arma::uword i = 0; i < numElements; i++){
+                    operands[0] = results[i];
+                    if(second) operands[1] = second[i];
+                    if(third) operands[2] = third[i];
+                    results[i] = applyOperation(instruction.operation, operands);
+                }
+                stackSize++;
+            }
+        }
+    }
+    return stack[0];
+}
+
+bool Expression::isConstant() const{
+    return bytecode.size() == 1 && bytecode[0].operation == Operation::Constant;
+}
+
+double Expression::constantValue() const{
+    return isConstant() ? bytecode[0].value : 0;
+}
+
+std::function<double(double)> Expression::asScaleFunction() const{
+    if(variableNames.size() != 1){
+        throw std::invalid_argument("[ERROR] Expression::asScaleFunction: a scale function has one variable, the expression has " + std::to_string(variableNames.size()) + ". abort");
+    }
+    std::shared_ptr<const Expression> shared = std::make_shared<const Expression>(*this);
+    return [shared](double time)-> double{return shared->evaluate(time);};
+}
+
+std::function<double(double,double)> Expression::asSaturationFunction() const{
+    if(variableNames.size() != 2){
+        throw std::invalid_argument("[ERROR] Expression::asSaturationFunction: a saturation function has two variables, the expression has " + std::to_string(variableNames.size()) + ". abort");
+    }
+    std::shared_ptr<const Expression> shared = std::make_shared<const Expression>(*this);
+    return [shared](double value, double saturation)-> double{
+        const double variables[2] = {value, saturation};
+        return shared->evaluateBytecode(variables);
+    };
+}
+
+BatchSaturationFunction Expression::asBatchSaturationFunction() const{
+    if(variableNames.size() != 2){
+        throw std::invalid_argument("[ERROR] Expression::asBatchSaturationFunction: a saturation function has two variables, the expression has " + std::to_string(variableNames.size()) + ". abort");
+    }
+    std::shared_ptr<const Expression> shared = std::make_shared<const Expression>(*this);
+    return [shared](double* values, const double* saturations, size_t numElements){
+        // the arrays are used as the variables without copying them
+        const arma::Col<double> valuesView(values, numElements, false, true);
+        const arma::Col<double> saturationsView(const_cast<double*>(saturations), numElements, false, true);
+        arma::Col<double> saturated = shared->evaluate(std::vector<const arma::Col<double>*>{&valuesView, &saturationsView});
+        for(size_t i = 0; i < numElements; i++){
+            if(std::abs(values[i]) > saturations[i]){
+                values[i] = saturated(i);
+            }
+        }
+    };
+}
@@ -0,0 +1,171 @@
+/**
+ * @file Expression.hxx
+ * @ingroup Core
+ * @brief Defines the Expression class, a small expression language used for the custom scale and saturation functions.
+ * @details The custom functions in CustomFunctions.cxx need the shared library to be built again for every change.
+ * An expression is read from the command line or from a parameters file, parsed once and compiled into a compact bytecode, that can be evaluated for a single value or over whole vectors.
+ * @details The language supports real numbers, the variables passed to the constructor, the parameters p[0], p[1], ..., the constants pi and e,
+ * the operators + - * / ^, the comparisons < <= > >= == != (1 if true, 0 otherwise), the logical operators && || !, the conditional c ? a : b
+ * and the functions sin, cos, tan, exp, log, sqrt, abs, tanh, floor, ceil (one argument), min, max, pow (two arguments).
+ * @details Example of a scale function with the same form as the custom functions: "t <= 5 ? p[0] : (t <= 6 ? p[1] : p[2])"
+ * @details Example of a saturation function: "s * tanh(x / s)"
+ */
+#pragma once
+#include <armadillo>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "utils/mathUtilities.hxx"
+
+struct ExpressionNode;
+
+/**
+ * @class Expression
+ * @brief Expression compiled into bytecode, with constant folding and detection of piecewise constant forms.
+ * @details The parameters are substituted and the constant subexpressions are folded when the expression is compiled.
+ * @details If the expression depends on its first variable only through comparisons with constants, the expression is piecewise constant:
+ * the value at every breakpoint and in every interval between breakpoints is precomputed, and the evaluation is a search in the breakpoints.
+ */
+class Expression{
+    public:
+        /**
+         * @brief The operations of the bytecode.
+         */
+        enum class Operation : uint8_t {
+            Constant, Variable,
+            Negate, Not,
+            Add, Subtract, Multiply, Divide, Power,
+            Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual, And, Or,
+            Select,
+            Sin, Cos, Tan, Exp, Log, Sqrt, Abs, Tanh, Floor, Ceil,
+            Min, Max
+        };
+        /**
+         * @brief An instruction of the bytecode, executed on a stack of values.
+         */
+        struct Instruction{
+            Operation operation; ///< the operation
+            double value = 0; ///< the value pushed by a Constant instruction
+            uint32_t index = 0; ///< the index of the variable pushed by a Variable instruction
+        };
+    private:
+        std::string source; ///< the source of the expression
+        std::vector<std::string> variableNames; ///< the names of the variables, in the order of evaluation
+        std::shared_ptr<const ExpressionNode> root; ///< the syntax tree, after the substitution of the parameters and the constant folding
+        std::vector<Instruction> bytecode; ///< the compiled expression
+        size_t maxStackSize = 0; ///< the maximum size of the stack during the evaluation
+        size_t numParameters = 0; ///< the number of parameters used in the source (highest index + 1)
+        bool piecewiseConstant = false; ///< true if the expression is piecewise constant in the first variable
+        std::vector<double> breakpoints; ///< the sorted breakpoints of the piecewise constant form
+        std::vector<double> breakpointValues; ///< the values of the piecewise constant form at the breakpoints
+        std::vector<double> intervalValues; ///< the values of the piecewise constant form in the intervals between breakpoints (breakpoints.size() + 1 values)
+        /**
+         * @brief Compile the syntax tree into bytecode and detect the piecewise constant form.
+         */
+        void compile();
+        /**
+         * @brief Evaluate the bytecode for a single set of values.
+         * @param variables The values of the variables.
+         * @return The value of the expression.
+         */
+        double evaluateBytecode(const double* variables) const;
+    public:
+        /**
+         * @brief Parse and compile an expression.
+         * @param source The source of the expression.
+         * @param variableNames The names of the variables, e.g. {"t"} for the scale functions, {"x","s"} for the saturation functions.
+         * @param parameters The values of the parameters p[0], p[1], ... used in the expression.
+         * @throw std::invalid_argument if the expression is not valid, uses an unknown name or a parameter that was not passed.
+         */
+        Expression(const std::string& source, const std::vector<std::string>& variableNames, const std::vector<double>& parameters = std::vector<double>());
+        /**
+         * @brief Compile the same source with other parameters.
+         * @param parameters The values of the parameters.
+         * @return The compiled expression.
+         * @throw std::invalid_argument if the expression uses a parameter that was not passed.
+         */
+        Expression withParameters(const std::vector<double>& parameters) const;
+        /**
+         * @brief Count the parameters used in an expression, without compiling it.
+         * @param source The source of the expression.
+         * @param variableNames The names of the variables.
+         * @return The highest index of the parameters used in the expression plus one, 0 if no parameter is used.
+         * @throw std::invalid_argument if the expression is not valid.
+         */
+        static size_t countParameters(const std::string& source, const std::vector<std::string>& variableNames);
+        /**
+         * @brief Evaluate the expression.
+         * @param variables The values of the variables, in the order of the names passed to the constructor.
+         * @return The value of the expression.
+         * @throw std::invalid_argument if the number of values is different from the number of variables.
+         */
+        double evaluate(const std::vector<double>& variables) const;
+        /**
+         * @brief Evaluate an expression with one variable (e.g. a scale function of the time).
+         * @param variable The value of the variable.
+         * @return The value of the expression.
+         */
+        double evaluate(double variable) const;
+        /**
+         * @brief Evaluate the expression over whole vectors.
+         * @param variables The values of the variables, one vector per variable, all of the same size.
+         * @return The values of the expression, element by element.
+         * @throw std::invalid_argument if the number of vectors is different from the number of variables, or the vectors have different sizes.
+         */
+        arma::Col<double> evaluate(const std::vector<const arma::Col<double>*>& variables) const;
+        /**
+         * @brief Check if the expression is a constant (after the substitution of the parameters).
+         * @return true if the expression is a constant.
+         */
+        bool isConstant() const;
+        /**
+         * @brief Get the value of a constant expression.
+         * @return The value of the expression, meaningful only if isConstant() is true.
+         */
+        double constantValue() const;
+        /**
+         * @brief Check if the expression is piecewise constant in the first variable.
+         * @return true if the expression depends on the first variable only through comparisons with constants (constant expressions are piecewise constant too).
+         */
+        bool isPiecewiseConstant() const {return piecewiseConstant;}
+        /**
+         * @brief Get the breakpoints of the piecewise constant form.
+         * @return The sorted breakpoints, empty if the expression is not piecewise constant or is constant.
+         */
+        const std::vector<double>& getBreakpoints() const {return breakpoints;}
+        /**
+         * @brief Get the number of parameters used in the source.
+         * @return The highest index of the parameters used plus one.
+         */
+        size_t getNumParameters() const {return numParameters;}
+        /**
+         * @brief Get the number of instructions of the compiled expression.
+         * @return The number of instructions, 1 for constant expressions.
+         */
+        size_t getNumInstructions() const {return bytecode.size();}
+        /**
+         * @brief Get the source of the expression.
+         * @return The source.
+         */
+        const std::string& getSource() const {return source;}
+        /**
+         * @brief Get the expression as a scale function of the time.
+         * @return The scale function, sharing the compiled expression.
+         * @throw std::invalid_argument if the expression does not have exactly one variable.
+         */
+        std::function<double(double)> asScaleFunction() const;
+        /**
+         * @brief Get the expression as a saturation function of the value and the saturation.
+         * @return The saturation function, sharing the compiled expression.
+         * @throw std::invalid_argument if the expression does not have exactly two variables.
+         */
+        std::function<double(double,double)> asSaturationFunction() const;
+        /**
+         * @brief Get the expression as a batch saturation function, evaluated over the whole output of a step.
+         * @return The batch saturation function, sharing the compiled expression, applied to the values whose absolute value exceeds the saturation.
+         * @throw std::invalid_argument if the expression does not have exactly two variables.
+         */
+        BatchSaturationFunction asBatchSaturationFunction() const;
+};
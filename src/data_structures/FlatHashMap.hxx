@@ -0,0 +1,185 @@
+/**
+ * @file FlatHashMap.hxx
+ * @ingroup Core
+ * @brief Defines the FlatHashMap class, an open addressing hash map with the entries stored in a contiguous array.
+ * @details The lookups of the simulation loop (node indexes of the interned names, virtual nodes of the types) use small integer keys,
+ * for these keys a linear probing table avoids the allocation of a node for every entry and the pointer chasing of std::map and std::unordered_map.
+ * The entries are only added while the structures are set up, so the removal of single entries is not supported.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct FlatHash
+ * @brief Default hash of the FlatHashMap, std::hash followed by a mixing step.
+ * @details std::hash of the integers is the identity, the mixing (finalizer of splitmix64) spreads the consecutive keys over the power of two table.
+ * @tparam Key The type of the keys.
+ */
+template<typename Key>
+struct FlatHash{
+    size_t operator()(const Key& key) const{
+        uint64_t hash = static_cast<uint64_t>(std::hash<Key>{}(key));
+        hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<size_t>(hash ^ (hash >> 31));
+    }
+};
+
+/**
+ * @class FlatHashMap
+ * @brief Open addressing hash map with linear probing.
+ * @details The capacity is a power of two and the load factor is kept under 0.5, so the probe sequences stay short.
+ * @tparam Key The type of the keys, default constructible and comparable with ==.
+ * @tparam Value The type of the values, default constructible.
+ * @tparam Hash The hash function of the keys.
+ */
+template<typename Key, typename Value, typename Hash = FlatHash<Key>>
+class FlatHashMap{
+    private:
+        std::vector<Key> keys; ///< keys of the slots
+        std::vector<Value> values; ///< values of the slots
+        std::vector<uint8_t> occupied; ///< 1 for the slots that contain an entry
+        size_t numEntries = 0; ///< number of entries in the map
+        Hash hasher; ///< hash function of the keys
+
+        /**
+         * @brief Get the slot of a key, or the empty slot where the key would be inserted.
+         * @param key The key.
+         * @return The index of the slot, the capacity must be greater than 0.
+         */
+        size_t slotOf(const Key& key) const{
+            size_t mask = keys.size() - 1;
+            size_t slot = hasher(key) & mask;
+            while(occupied[slot] && !(keys[slot] == key)){
+                slot = (slot + 1) & mask;
+            }
+            return slot;
+        }
+        /**
+         * @brief Move the entries into a table with a new capacity.
+         * @param newCapacity The new capacity, a power of two.
+         */
+        void rehash(size_t newCapacity){
+            std::vector<Key> oldKeys = std::move(keys);
+            std::vector<Value> oldValues = std::move(values);
+            std::vector<uint8_t> oldOccupied = std::move(occupied);
+            keys.assign(newCapacity, Key());
+            values.assign(newCapacity, Value());
+            occupied.assign(newCapacity, 0);
+            for(size_t i = 0; i < oldKeys.size(); i++){
+                if(oldOccupied[i]){
+                    size_t slot = slotOf(oldKeys[i]);
+                    keys[slot] = std::move(oldKeys[i]);
+                    values[slot] = std::move(oldValues[i]);
+                    occupied[slot] = 1;
+                }
+            }
+        }
+    public:
+        /**
+         * @brief Reserve the table for a number of entries.
+         * @param numEntries The number of entries that can be inserted without rehashing.
+         */
+        void reserve(size_t numEntries){
+            size_t capacity = keys.empty() ? 8 : keys.size();
+            while(capacity < 2 * numEntries){
+                capacity *= 2;
+            }
+            if(capacity != keys.size()){
+                rehash(capacity);
+            }
+        }
+        /**
+         * @brief Insert an entry or replace the value of an existing key.
+         * @param key The key.
+         * @param value The value.
+         * @return true if the key was not in the map.
+         */
+        bool insert_or_assign(const Key& key, const Value& value){
+            reserve(numEntries + 1);
+            size_t slot = slotOf(key);
+            bool inserted = !occupied[slot];
+            if(inserted){
+                keys[slot] = key;
+                occupied[slot] = 1;
+                numEntries++;
+            }
+            values[slot] = value;
+            return inserted;
+        }
+        /**
+         * @brief Find the value of a key.
+         * @param key The key.
+         * @return A pointer to the value, nullptr if the key is not in the map.
+         */
+        const Value* find(const Key& key) const{
+            if(numEntries == 0){
+                return nullptr;
+            }
+            size_t slot = slotOf(key);
+            return occupied[slot] ? &values[slot] : nullptr;
+        }
+        /**
+         * @brief Find the value of a key.
+         * @param key The key.
+         * @return A pointer to the value, nullptr if the key is not in the map.
+         */
+        Value* find(const Key& key){
+            return const_cast<Value*>(std::as_const(*this).find(key));
+        }
+        /**
+         * @brief Get the value of a key.
+         * @param key The key.
+         * @return The value.
+         * @throw std::out_of_range if the key is not in the map.
+         */
+        const Value& at(const Key& key) const{
+            const Value* value = find(key);
+            if(value == nullptr){
+                throw std::out_of_range("[ERROR] FlatHashMap::at: the key is not in the map");
+            }
+            return *value;
+        }
+        /**
+         * @brief Check if a key is in the map.
+         * @param key The key.
+         * @return true if the key is in the map.
+         */
+        bool contains(const Key& key) const{return find(key) != nullptr;}
+        /**
+         * @brief Get the number of entries.
+         * @return The number of entries in the map.
+         */
+        size_t size() const{return numEntries;}
+        /**
+         * @brief Check if the map is empty.
+         * @return true if there are no entries.
+         */
+        bool empty() const{return numEntries == 0;}
+        /**
+         * @brief Remove all the entries, the capacity is kept.
+         */
+        void clear(){
+            std::fill(occupied.begin(), occupied.end(), 0);
+            numEntries = 0;
+        }
+        /**
+         * @brief Call a function for every entry, in the order of the slots.
+         * @param function The function, called with the key and the value.
+         */
+        template<typename Function>
+        void forEach(Function&& function) const{
+            for(size_t i = 0; i < keys.size(); i++){
+                if(occupied[i]){
+                    function(keys[i], values[i]);
+                }
+            }
+        }
+};
@@ -6,6 +6,7 @@
  */
 #include "data_structures/Matrix.hxx"
 #include "utils/mathUtilities.hxx"
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 #include <vector>
@@ -21,6 +22,7 @@ void Matrix<T>::allocateMatrixSpace()
     }
     int totalLength = rows_ * cols_;
     _matrix = new T[totalLength]; //columns first
+    capacity_ = totalLength;
     
     for (int i = 0; i < rows_; i++) {
         for (int j = 0; j < cols_; j++) {
@@ -31,6 +33,24 @@ void Matrix<T>::allocateMatrixSpace()
 
 template void Matrix<double>::allocateMatrixSpace();
 
+template<typename T>
+void Matrix<T>::ensureCapacity(int minimumCapacity)
+{
+    if(minimumCapacity <= capacity_){
+        return;
+    }
+    int newCapacity = std::max(minimumCapacity, 2*capacity_);
+    T* newMatrix = new T[newCapacity];
+    std::copy(_matrix, _matrix + rows_*cols_, newMatrix);
+    if(_matrix){
+        delete[] _matrix;
+    }
+    _matrix = newMatrix;
+    capacity_ = newCapacity;
+}
+
+template void Matrix<double>::ensureCapacity(int minimumCapacity);
+
 
 //constructors and destructors
 template<typename T>
@@ -360,27 +380,40 @@ template Matrix<double> Matrix<double>::transpose()const;
 
 template<typename T>
 Matrix<T> Matrix<T>::copyAndAddRowsColsWithZeros(int additionalRows, int additionalCols)const{
-    Matrix<T> ret = Matrix<T>(this->getRows()+additionalRows,this->getCols()+additionalCols);
+    Matrix<T> ret = Matrix<T>(this->getRows()+additionalRows,this->getCols()+additionalCols);  //filled with zeros
     for (int i = 0 ; i<this->getRows(); i++) {
-        for (int j = 0 ; j<this->getRows(); j++) {
-            ret(i,j) = getValue(i, j);
-        }
+        std::copy(_matrix + i*cols_, _matrix + (i+1)*cols_, ret._matrix + i*ret.cols_);
     }
-    for( int i = this->getRows(); i<this->getRows()+additionalRows; i++){
-        for (int j = 0 ; j<this->getCols(); j++) {
-            ret(i,j) = 0;
-        }
+    return ret;
+}
+
+template Matrix<double> Matrix<double>::copyAndAddRowsColsWithZeros(int additionalRows, int additionalCols)const;
+
+template<typename T>
+void Matrix<T>::addRowsColsWithZeros(int additionalRows, int additionalCols){
+    if(additionalRows < 0 || additionalCols < 0){
+        throw std::invalid_argument("Matrix::addRowsColsWithZeros : the number of rows and columns to add cannot be negative");
     }
-    for( int i = 0; i<this->getRows(); i++){
-        for (int j = this->getCols(); j<this->getCols()+additionalCols; j++) {
-            ret(i,j) = 0;
-        }
+    int newCols = cols_ + additionalCols;
+    ensureCapacity((rows_ + additionalRows) * newCols);
+    // the rows are moved from the last one, so no element is overwritten before being moved
+    for (int i = rows_ - 1; i >= 0; i--) {
+        std::copy_backward(_matrix + i*cols_, _matrix + (i+1)*cols_, _matrix + i*newCols + cols_);
+        std::fill(_matrix + i*newCols + cols_, _matrix + (i+1)*newCols, 0);
     }
+    std::fill(_matrix + rows_*newCols, _matrix + (rows_ + additionalRows)*newCols, 0);
+    rows_ += additionalRows;
+    cols_ = newCols;
+}
 
-    return ret;
+template void Matrix<double>::addRowsColsWithZeros(int additionalRows, int additionalCols);
+
+template<typename T>
+void Matrix<T>::reserve(int rows, int cols){
+    ensureCapacity(rows * cols);
 }
 
-template Matrix<double> Matrix<double>::copyAndAddRowsColsWithZeros(int additionalRows, int additionalCols)const;
+template void Matrix<double>::reserve(int rows, int cols);
 
 
 template<typename T>
@@ -432,24 +465,11 @@ template Matrix<double>* Matrix<double>::addColumnNew(const std::vector<double>&
 template<typename T>
 void Matrix<T>::addRow(const std::vector<T>& row, int position){
     if(position >= 0 && position <= rows_){
-        T* old_matrix = _matrix;
-        int totalLength = (rows_+1) * cols_;
-        _matrix = new T[totalLength];
+        ensureCapacity((rows_+1) * cols_);
+        // the rows after the position are shifted down by one row
+        std::copy_backward(_matrix + position*cols_, _matrix + rows_*cols_, _matrix + (rows_+1)*cols_);
+        std::copy(row.cbegin(), row.cbegin() + cols_, _matrix + position*cols_);
         rows_++;
-        for (int i = 0; i<position; i++) {
-            for (int j = 0; j<cols_; j++) {
-                this->setValue(i,j,old_matrix[i*cols_ + j]);
-            }
-        }
-        for (int j = 0; j<cols_; j++) {
-            this->setValue(position,j,row[j]);
-        }
-        for (int i = position+1; i<rows_; i++) {
-            for (int j = 0; j<cols_; j++) {
-                this->setValue(i,j,old_matrix[(i-1)*cols_ + j]);
-            }
-        }
-        delete[] old_matrix;
     } else {
         throw std::invalid_argument("Matrix::addRow : position is not in the range of the rows");
     }
@@ -460,20 +480,16 @@ template void Matrix<double>::addRow(const std::vector<double>& row, int positio
 template<typename T>
 void Matrix<T>::addColumn(const std::vector<T>& column, int position){
     if(position >= 0 && position <= cols_){
-        T* old_matrix = _matrix;
-        int totalLength = rows_ * (cols_+1);
-        _matrix = new T[totalLength];
-        cols_++;
-        for (int i = 0; i<rows_; i++) {
-            for (int j = 0; j<position; j++) {
-                this->setValue(i,j,old_matrix[i*(cols_-1) + j]);
-            }
-            _matrix[i*cols_ + position] = column[i];
-            for (int j = position+1; j<cols_; j++) {
-                this->setValue(i,j,old_matrix[i*(cols_-1) + j-1]);
-            }
+        ensureCapacity(rows_ * (cols_+1));
+        // the rows are moved from the last one, so no element is overwritten before being moved
+        for (int i = rows_ - 1; i >= 0; i--) {
+            T* oldRow = _matrix + i*cols_;
+            T* newRow = _matrix + i*(cols_+1);
+            std::copy_backward(oldRow + position, oldRow + cols_, newRow + cols_ + 1);
+            newRow[position] = column[i];
+            std::copy_backward(oldRow, oldRow + position, newRow + position);
         }
-        delete[] old_matrix;
+        cols_++;
     } else {
         throw std::invalid_argument("Matrix::addColumn : position is not in the range of the columns");
     }
@@ -393,6 +393,26 @@ class Matrix {
          * @return A new matrix containing the result of the addition.
          */
         Matrix copyAndAddRowsColsWithZeros(int additionalRows, int additionalCols) const;
+        /**
+         * @brief Function to add rows and columns filled with zeros at the end of the matrix, in place.
+         * @param additionalRows The number of additional rows to add.
+         * @param additionalCols The number of additional columns to add.
+         * @details The matrix is resized once for the whole batch, and the memory is reallocated only when the capacity is not enough.
+         * @throw std::invalid_argument if one of the numbers is negative.
+         */
+        void addRowsColsWithZeros(int additionalRows, int additionalCols);
+        /**
+         * @brief Function to reserve the memory for a matrix of the given dimensions.
+         * @param rows The number of rows to reserve.
+         * @param cols The number of columns to reserve.
+         * @details The dimensions of the matrix do not change, the rows and columns added later up to the reserved size do not reallocate the memory.
+         */
+        void reserve(int rows, int cols);
+        /**
+         * @brief Function to get the number of elements that fit in the allocated memory.
+         * @return The capacity of the matrix, at least rows x cols.
+         */
+        int getCapacity()const{return capacity_;}
 
         /**
          * @brief   add a row to the matrix and return a new matrix
@@ -417,6 +437,7 @@ class Matrix {
          * @param  row : the row to add
          * @param  position : the position where to add the row
          * @throw  std::invalid_argument if the position is not in the range of the rows
+         * @details the capacity grows geometrically, so adding rows at the end costs amortized O(cols)
          */
         void addRow(const std::vector<T>& row, int position);
 
@@ -425,6 +446,7 @@ class Matrix {
          * @param  column : the column to add
          * @param  position : the position where to add the column
          * @throw  std::invalid_argument if the position is not in the range of the columns
+         * @details the capacity grows geometrically, the rows are shifted in place when the memory is enough
          */
         void addColumn(const std::vector<T>& column, int position);
 
@@ -469,11 +491,18 @@ class Matrix {
         int rows_; ///< Number of rows in the matrix.
         int cols_; ///< Number of columns in the matrix.
         T *_matrix=nullptr; ///< Pointer to the matrix data.
+        int capacity_=0; ///< Number of elements allocated for the matrix data, at least rows_*cols_.
 
         /**
          * @brief Protected function to allocate memory for the matrix.
          * @details Allocates memory for the matrix and initializes all elements to zero.
          */
         void allocateMatrixSpace();
+        /**
+         * @brief Protected function to make room for at least a number of elements.
+         * @param minimumCapacity The number of elements needed.
+         * @details The capacity is at least doubled when the memory is reallocated, the current elements are kept in the same linear positions.
+         */
+        void ensureCapacity(int minimumCapacity);
         Matrix expHelper(const Matrix&, int);
 };
\ No newline at end of file
@@ -0,0 +1,186 @@
+/**
+ * @file ReplicateStatistics.cxx
+ * @ingroup Core
+ * @brief Implements the ReplicateStatistics class used for summarizing the replicates of the stochastic simulations.
+ */
+#include "data_structures/ReplicateStatistics.hxx"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    /**
+     * @brief Update the five markers of the P-square algorithm with a new observation, after the first five observations.
+     * @param heights The heights of the markers.
+     * @param positions The positions of the markers.
+     * @param probability The probability of the estimated quantile.
+     * @param count The number of observations, including the new one.
+     * @param value The new observation.
+     */
+    void updateMarkers(double* heights, double* positions, double probability, arma::uword count, double value){
+        // cell of the new observation, the extreme markers follow the minimum and the maximum
+        int cell;
+        if(value < heights[0]){
+            heights[0] = value;
+            cell = 0;
+        } else if(value >= heights[4]){
+            heights[4] = value;
+            cell = 3;
+        } else {
+            cell = 0;
+            while(value >= heights[cell + 1]){
+                cell++;
+            }
+        }
+        for(int i = cell + 1; i < 5; i++){
+            positions[i]++;
+        }
+        // desired positions of the markers with count observations
+        const double increments[5] = {0, probability / 2, probability, (1 + probability) / 2, 1};
+        for(int i = 1; i < 4; i++){
+            double desired = 1 + (count - 1) * increments[i];
+            double difference = desired - positions[i];
+            if((difference >= 1 && positions[i+1] - positions[i] > 1) || (difference <= -1 && positions[i-1] - positions[i] < -1)){
+                double step = difference > 0 ? 1.0 : -1.0;
+                // piecewise parabolic prediction, linear when the parabola is not monotone between the neighbours
+                double parabolic = heights[i] + step / (positions[i+1] - positions[i-1]) *
+                    ((positions[i] - positions[i-1] + step) * (heights[i+1] - heights[i]) / (positions[i+1] - positions[i]) +
+                     (positions[i+1] - positions[i] - step) * (heights[i] - heights[i-1]) / (positions[i] - positions[i-1]));
+                if(heights[i-1] < parabolic && parabolic < heights[i+1]){
+                    heights[i] = parabolic;
+                } else {
+                    int neighbour = i + static_cast<int>(step);
+                    heights[i] += step * (heights[neighbour] - heights[i]) / (positions[neighbour] - positions[i]);
+                }
+                positions[i] += step;
+            }
+        }
+    }
+}
+
+ReplicateStatistics::ReplicateStatistics(arma::uword numNodes, arma::uword numTimes, const std::vector<double>& quantiles):numNodes(numNodes),numTimes(numTimes),quantiles(quantiles){
+    for(double probability : quantiles){
+        if(!(probability > 0 && probability < 1)){
+            throw std::invalid_argument("[ERROR] ReplicateStatistics::ReplicateStatistics: the quantile probability " + std::to_string(probability) + " is not in (0,1). abort");
+        }
+    }
+    counts.assign(numTimes, 0);
+    means.zeros(numNodes, numTimes);
+    squaredDeviations.zeros(numNodes, numTimes);
+    markerHeights.assign(numNodes * numTimes * quantiles.size() * 5, 0);
+    markerPositions.assign(numNodes * numTimes * quantiles.size() * 5, 0);
+}
+
+void ReplicateStatistics::add(arma::uword timeIndex, const std::vector<double>& values){
+    if(timeIndex >= numTimes){
+        throw std::invalid_argument("[ERROR] ReplicateStatistics::add: the time index " + std::to_string(timeIndex) + " is out of range for " + std::to_string(numTimes) + " times. abort");
+    }
+    if(values.size() < numNodes){
+        throw std::invalid_argument("[ERROR] ReplicateStatistics::add: " + std::to_string(values.size()) + " values for " + std::to_string(numNodes) + " nodes. abort");
+    }
+    arma::uword count = ++counts[timeIndex];
+    for(arma::uword node = 0; node < numNodes; node++){
+        // Welford's update of the mean and of the squared deviations
+        double value = values[node];
+        double delta = value - means(node, timeIndex);
+        means(node, timeIndex) += delta / count;
+        squaredDeviations(node, timeIndex) += delta * (value - means(node, timeIndex));
+        for(size_t q = 0; q < quantiles.size(); q++){
+            double* heights = markerHeights.data() + markerOffset(node, timeIndex, q);
+            double* positions = markerPositions.data() + markerOffset(node, timeIndex, q);
+            if(count <= 5){
+                // the first five observations are kept sorted, they become the initial markers
+                heights[count - 1] = value;
+                std::sort(heights, heights + count);
+                if(count == 5){
+                    for(int i = 0; i < 5; i++){
+                        positions[i] = i + 1;
+                    }
+                }
+            } else {
+                updateMarkers(heights, positions, quantiles[q], count, value);
+            }
+        }
+    }
+}
+
+arma::Mat<double> ReplicateStatistics::getMeans() const{
+    arma::Mat<double> result = means;
+    for(arma::uword t = 0; t < numTimes; t++){
+        if(counts[t] == 0){
+            result.col(t).fill(std::numeric_limits<double>::quiet_NaN());
+        }
+    }
+    return result;
+}
+
+arma::Mat<double> ReplicateStatistics::getVariances() const{
+    arma::Mat<double> result(numNodes, numTimes);
+    for(arma::uword t = 0; t < numTimes; t++){
+        if(counts[t] < 2){
+            result.col(t).fill(std::numeric_limits<double>::quiet_NaN());
+        } else {
+            result.col(t) = squaredDeviations.col(t) / (counts[t] - 1);
+        }
+    }
+    return result;
+}
+
+arma::Mat<double> ReplicateStatistics::getQuantile(size_t quantileIndex) const{
+    if(quantileIndex >= quantiles.size()){
+        throw std::invalid_argument("[ERROR] ReplicateStatistics::getQuantile: the quantile index " + std::to_string(quantileIndex) + " is out of range for " + std::to_string(quantiles.size()) + " quantiles. abort");
+    }
+    arma::Mat<double> result(numNodes, numTimes);
+    for(arma::uword t = 0; t < numTimes; t++){
+        for(arma::uword node = 0; node < numNodes; node++){
+            const double* heights = markerHeights.data() + markerOffset(node, t, quantileIndex);
+            if(counts[t] == 0){
+                result(node, t) = std::numeric_limits<double>::quiet_NaN();
+            } else if(counts[t] <= 5){
+                // exact quantile of the sorted observations, linear interpolation as numpy
+                double position = quantiles[quantileIndex] * (counts[t] - 1);
+                arma::uword lower = static_cast<arma::uword>(std::floor(position));
+                arma::uword upper = std::min<arma::uword>(lower + 1, counts[t] - 1);
+                result(node, t) = heights[lower] + (position - lower) * (heights[upper] - heights[lower]);
+            } else {
+                result(node, t) = heights[2];
+            }
+        }
+    }
+    return result;
+}
+
+void ReplicateStatistics::save(const std::string& folder, const std::string& type, const std::vector<std::string>& nodeNames, const std::vector<double>& times) const{
+    if(nodeNames.size() != numNodes || times.size() != numTimes){
+        throw std::invalid_argument("[ERROR] ReplicateStatistics::save: " + std::to_string(nodeNames.size()) + " node names and " + std::to_string(times.size()) + " times for statistics of " + std::to_string(numNodes) + " nodes and " + std::to_string(numTimes) + " times. abort");
+    }
+    std::vector<std::pair<std::string, arma::Mat<double>>> statistics = {{"mean", getMeans()}, {"variance", getVariances()}};
+    for(size_t q = 0; q < quantiles.size(); q++){
+        std::ostringstream name;
+        name << "q" << quantiles[q];
+        statistics.emplace_back(name.str(), getQuantile(q));
+    }
+    for(const auto& [name, values] : statistics){
+        std::string filename = folder + "/" + type + "_" + name + ".tsv";
+        std::ofstream outfile(filename, std::ios::out | std::ios::trunc);
+        if(!outfile.is_open()){
+            throw std::invalid_argument("[ERROR] ReplicateStatistics::save: unable to open the output file " + filename + ". abort");
+        }
+        outfile.precision(10);
+        outfile << "nodeNames";
+        for(double time : times){
+            outfile << "\t" << time;
+        }
+        outfile << std::endl;
+        for(arma::uword i = 0; i < numNodes; i++){
+            outfile << nodeNames[i];
+            for(arma::uword t = 0; t < numTimes; t++){
+                outfile << "\t" << values(i, t);
+            }
+            outfile << std::endl;
+        }
+    }
+}
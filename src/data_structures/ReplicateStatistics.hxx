@@ -0,0 +1,93 @@
+/**
+ * @file ReplicateStatistics.hxx
+ * @ingroup Core
+ * @brief Defines the ReplicateStatistics class, the streaming statistics of the values of a type over the replicates of a stochastic simulation.
+ * @details The replicates of a simulation with random models differ only in the seed, so instead of saving the trajectory of every replicate
+ * the mean, the variance (Welford's algorithm) and approximate quantiles (P-square algorithm) of every node at every time are updated while the replicates are computed.
+ * The replicates are added one at a time, as they are computed one after the other by masfenon-MPI.
+ * The memory does not depend on the number of replicates.
+ */
+#pragma once
+
+#include <armadillo>
+#include <string>
+#include <vector>
+
+/**
+ * @class ReplicateStatistics
+ * @brief Online mean, variance and quantiles of the values of the nodes of a type at every time, over the replicates.
+ * @details The quantiles are estimated with the P-square algorithm (Jain and Chlamtac, 1985), five markers for every quantile, node and time.
+ * With at most five replicates the quantiles are computed exactly from the stored values.
+ */
+class ReplicateStatistics{
+    private:
+        arma::uword numNodes; ///< number of nodes (rows of the statistics)
+        arma::uword numTimes; ///< number of times (columns of the statistics)
+        std::vector<double> quantiles; ///< probabilities of the estimated quantiles
+        std::vector<arma::uword> counts; ///< number of replicates added for every time
+        arma::Mat<double> means; ///< running means (nodes x times)
+        arma::Mat<double> squaredDeviations; ///< running sums of the squared deviations from the mean (nodes x times)
+        std::vector<double> markerHeights; ///< heights of the five markers of every quantile, node and time
+        std::vector<double> markerPositions; ///< positions of the five markers of every quantile, node and time
+        /**
+         * @brief Get the offset of the markers of a quantile of a node at a time.
+         * @param node The node.
+         * @param timeIndex The index of the time.
+         * @param quantileIndex The index of the quantile.
+         * @return The offset of the first marker in markerHeights and markerPositions.
+         */
+        size_t markerOffset(arma::uword node, arma::uword timeIndex, size_t quantileIndex) const {return ((timeIndex * numNodes + node) * quantiles.size() + quantileIndex) * 5;}
+    public:
+        /**
+         * @brief Constructor for the ReplicateStatistics class.
+         * @param numNodes The number of nodes.
+         * @param numTimes The number of times.
+         * @param quantiles The probabilities of the quantiles to estimate, in (0,1).
+         * @throw std::invalid_argument if a probability is not in (0,1).
+         */
+        ReplicateStatistics(arma::uword numNodes, arma::uword numTimes, const std::vector<double>& quantiles = {0.05, 0.5, 0.95});
+        /**
+         * @brief Add the values of a replicate at a time.
+         * @param timeIndex The index of the time.
+         * @param values The values of the nodes, additional values are ignored.
+         * @throw std::invalid_argument if the time index is out of range or there are less values than nodes.
+         */
+        void add(arma::uword timeIndex, const std::vector<double>& values);
+        /**
+         * @brief Get the number of replicates added at a time.
+         * @param timeIndex The index of the time.
+         * @return The number of replicates.
+         */
+        arma::uword getCount(arma::uword timeIndex) const {return counts.at(timeIndex);}
+        /**
+         * @brief Get the means over the replicates.
+         * @return The means (nodes x times), NaN for the times without replicates.
+         */
+        arma::Mat<double> getMeans() const;
+        /**
+         * @brief Get the sample variances over the replicates.
+         * @return The variances (nodes x times), NaN for the times with less than two replicates.
+         */
+        arma::Mat<double> getVariances() const;
+        /**
+         * @brief Get the estimated quantile over the replicates.
+         * @param quantileIndex The index of the quantile in the probabilities passed to the constructor.
+         * @return The quantiles (nodes x times), NaN for the times without replicates.
+         * @throw std::invalid_argument if the index is out of range.
+         */
+        arma::Mat<double> getQuantile(size_t quantileIndex) const;
+        /**
+         * @brief Get the probabilities of the estimated quantiles.
+         * @return The probabilities.
+         */
+        const std::vector<double>& getQuantiles() const {return quantiles;}
+        /**
+         * @brief Save the statistics, a file for every statistic with the layout of the iteration matrices: <folder>/<type>_mean.tsv, <folder>/<type>_variance.tsv and <folder>/<type>_q<probability>.tsv.
+         * @param folder The output folder.
+         * @param type The name of the type.
+         * @param nodeNames The names of the nodes (rows).
+         * @param times The times (columns).
+         * @throw std::invalid_argument if the sizes do not match or a file cannot be opened.
+         */
+        void save(const std::string& folder, const std::string& type, const std::vector<std::string>& nodeNames, const std::vector<double>& times) const;
+};
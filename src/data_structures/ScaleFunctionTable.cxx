@@ -0,0 +1,99 @@
+/**
+ * @file ScaleFunctionTable.cxx
+ * @ingroup Core
+ * @brief Implements the ScaleFunctionTable class used for evaluating the per node scaling functions.
+ */
+#include "data_structures/ScaleFunctionTable.hxx"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    /**
+     * @brief Get the point used to sample a column of the compiled values.
+     * @param breakpoints The sorted breakpoints.
+     * @param column The column, 2i for the interval i and 2i+1 for the breakpoint i.
+     * @return The breakpoint itself, or a point strictly inside the interval.
+     */
+    double columnSamplePoint(const std::vector<double>& breakpoints, size_t column){
+        size_t index = column / 2;
+        if(column % 2 == 1){
+            return breakpoints[index];
+        }
+        if(breakpoints.empty()){
+            return 0.0;
+        }
+        if(index == 0){
+            return breakpoints.front() - 1.0;
+        }
+        if(index == breakpoints.size()){
+            return breakpoints.back() + 1.0;
+        }
+        return (breakpoints[index - 1] + breakpoints[index]) / 2.0;
+    }
+}
+
+ScaleFunctionTable::ScaleFunctionTable(const std::vector<double>& breakpoints, const std::vector<std::function<double(double)>>& uniqueFunctions, const std::vector<arma::uword>& nodeToUniqueFunction, bool piecewiseConstant):breakpoints(breakpoints),uniqueFunctions(uniqueFunctions),piecewiseConstant(piecewiseConstant){
+    if(!std::is_sorted(breakpoints.begin(), breakpoints.end())){
+        throw std::invalid_argument("[ERROR] ScaleFunctionTable::ScaleFunctionTable: the breakpoints are not sorted. abort");
+    }
+    if(uniqueFunctions.empty()){
+        throw std::invalid_argument("[ERROR] ScaleFunctionTable::ScaleFunctionTable: no scaling functions were passed. abort");
+    }
+    for(const auto& uniqueIndex : nodeToUniqueFunction){
+        if(uniqueIndex >= uniqueFunctions.size()){
+            throw std::invalid_argument("[ERROR] ScaleFunctionTable::ScaleFunctionTable: node refers to the scaling function " + std::to_string(uniqueIndex) + " but only " + std::to_string(uniqueFunctions.size()) + " functions were passed. abort");
+        }
+    }
+    this->nodeToUniqueFunction = arma::conv_to<arma::uvec>::from(nodeToUniqueFunction);
+
+    if(!piecewiseConstant){
+        // nothing is compiled, the functions are evaluated at every call
+        return;
+    }
+    // the functions are declared constant inside every interval, so a single point is sampled for every breakpoint and for every interval
+    size_t numColumns = 2 * breakpoints.size() + 1;
+    arma::Mat<double> uniqueValues(uniqueFunctions.size(), numColumns);
+    for(size_t column = 0; column < numColumns; column++){
+        double samplePoint = columnSamplePoint(breakpoints, column);
+        for(size_t uniqueIndex = 0; uniqueIndex < uniqueFunctions.size(); uniqueIndex++){
+            uniqueValues(uniqueIndex, column) = uniqueFunctions[uniqueIndex](samplePoint);
+        }
+    }
+    // expanded once, so that every evaluation is a copy of a contiguous column
+    nodeValues = uniqueValues.rows(this->nodeToUniqueFunction);
+}
+
+arma::uword ScaleFunctionTable::intervalIndex(double time) const{
+    arma::uword interval = 0;
+    for(const auto& breakpoint : breakpoints){
+        interval += static_cast<arma::uword>(time > breakpoint);
+    }
+    return interval;
+}
+
+arma::uword ScaleFunctionTable::columnIndex(double time) const{
+    arma::uword interval = intervalIndex(time);
+    bool atBreakpoint = interval < breakpoints.size() && breakpoints[interval] == time;
+    return 2 * interval + static_cast<arma::uword>(atBreakpoint);
+}
+
+arma::Col<double> ScaleFunctionTable::evaluate(double time) const{
+    if(piecewiseConstant){
+        return nodeValues.col(columnIndex(time));
+    }
+    // functions that are not declared piecewise constant are still evaluated only once for every distinct set of parameters
+    arma::Col<double> uniqueValues(uniqueFunctions.size());
+    for(size_t uniqueIndex = 0; uniqueIndex < uniqueFunctions.size(); uniqueIndex++){
+        uniqueValues(uniqueIndex) = uniqueFunctions[uniqueIndex](time);
+    }
+    return uniqueValues.elem(nodeToUniqueFunction);
+}
+
+std::function<arma::Col<double>(double)> ScaleFunctionTable::asFunction() const{
+    std::shared_ptr<const ScaleFunctionTable> table = std::make_shared<const ScaleFunctionTable>(*this);
+    return [table](double time) -> arma::Col<double> {
+        return table->evaluate(time);
+    };
+}
@@ -0,0 +1,78 @@
+/**
+ * @file ScaleFunctionTable.hxx
+ * @ingroup Core
+ * @brief Defines the ScaleFunctionTable class, a compiled per node representation of the scaling functions.
+ * @details The per node scaling functions read from the parameter files are deduplicated (nodes with the same parameters share the same function)
+ * and, when the caller declares them piecewise constant over a set of breakpoints, compiled into a structure-of-arrays table (one column per breakpoint and per interval between breakpoints, one row per node).
+ * Evaluating the table at a given time is then a branch-free interval lookup and a contiguous copy of the interval column, instead of a call for every node.
+ */
+#pragma once
+
+#include <armadillo>
+#include <functional>
+#include <vector>
+
+/**
+ * @class ScaleFunctionTable
+ * @brief Compiled table of per node scaling functions.
+ * @details The table is built from the unique scaling functions and the index of the unique function used by every node.
+ * If the caller declares every unique function piecewise constant over the breakpoints, the values are sampled once at every breakpoint and once inside every interval between breakpoints, and stored per node.
+ * Otherwise the unique functions are evaluated once per call and the values are gathered for the nodes.
+ * @warning Piecewise constancy is never guessed from samples of the functions: declaring a function that changes value inside an interval gives wrong values.
+ */
+class ScaleFunctionTable{
+    private:
+        std::vector<double> breakpoints; ///< sorted breakpoints of the piecewise constant functions, the intervals are (-inf,b0), (b0,b1), ..., (bn,+inf)
+        std::vector<std::function<double(double)>> uniqueFunctions; ///< the unique scaling functions, one for every distinct set of parameters
+        arma::uvec nodeToUniqueFunction; ///< index of the unique function used by every node
+        arma::Mat<double> nodeValues; ///< compiled values (nodes x (2 * breakpoints + 1)), column 2i is the interval i and column 2i+1 the breakpoint i, valid only if piecewiseConstant is true
+        bool piecewiseConstant = false; ///< true if the caller declared all the unique functions piecewise constant over the breakpoints and the values were compiled
+    public:
+        /**
+         * @brief Constructor for the ScaleFunctionTable class.
+         * @param breakpoints The sorted breakpoints of the piecewise constant functions.
+         * @param uniqueFunctions The unique scaling functions.
+         * @param nodeToUniqueFunction The index of the unique function used by every node.
+         * @param piecewiseConstant true if every unique function is known to be constant inside every interval between the breakpoints (the value at a breakpoint can differ), false to evaluate the functions at every call.
+         * @throw std::invalid_argument if the breakpoints are not sorted, if there are no unique functions or if a node refers to a non existing unique function.
+         */
+        ScaleFunctionTable(const std::vector<double>& breakpoints, const std::vector<std::function<double(double)>>& uniqueFunctions, const std::vector<arma::uword>& nodeToUniqueFunction, bool piecewiseConstant = false);
+        /**
+         * @brief Get the index of the interval that contains the time.
+         * @param time The time.
+         * @return The number of breakpoints strictly lower than the time, that is the index of the interval.
+         */
+        arma::uword intervalIndex(double time) const;
+        /**
+         * @brief Get the column of the compiled values used for a given time.
+         * @param time The time.
+         * @return 2i+1 if the time is the breakpoint i, 2i if the time is inside the interval i.
+         */
+        arma::uword columnIndex(double time) const;
+        /**
+         * @brief Evaluate the scaling values of all the nodes at a given time.
+         * @param time The time.
+         * @return The column vector of the scaling values, one for every node.
+         */
+        arma::Col<double> evaluate(double time) const;
+        /**
+         * @brief Get the table as a vectorized scaling function, used by the vectorized models and the computation.
+         * @return The vectorized scaling function, sharing the compiled table.
+         */
+        std::function<arma::Col<double>(double)> asFunction() const;
+        /**
+         * @brief Get the number of nodes of the table.
+         * @return The number of nodes.
+         */
+        arma::uword getNumNodes() const {return nodeToUniqueFunction.n_elem;}
+        /**
+         * @brief Get the number of unique scaling functions.
+         * @return The number of unique scaling functions.
+         */
+        arma::uword getNumUniqueFunctions() const {return uniqueFunctions.size();}
+        /**
+         * @brief Check if the functions were compiled into the table of values.
+         * @return true if the functions were declared piecewise constant over the breakpoints and the values were compiled, false otherwise.
+         */
+        bool isCompiled() const {return piecewiseConstant;}
+};
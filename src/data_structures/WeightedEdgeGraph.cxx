@@ -8,12 +8,16 @@
 #include "data_structures/Matrix.hxx"
 #include "utils/mathUtilities.hxx"
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
 #include <iterator>
 #include <map>
 #include <numeric>
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <sys/types.h>
 #include <unordered_set>
 #include <iostream>
@@ -23,23 +27,14 @@
 
 WeightedEdgeGraph::WeightedEdgeGraph(){
     this->numberOfNodes = 0;
-    this->nodeValues = nullptr;
-    this->adjList = std::vector<std::unordered_set<int>>();
-    this->adjMatrix = Matrix<double>(0,0);
     this->nodeToIndex = std::map<std::string, int>();
     
 }
 
 WeightedEdgeGraph::WeightedEdgeGraph(int numNodes){
     this->numberOfNodes = numNodes;
-    this->nodeValues = new double[numNodes];
-    this->adjList = std::vector<std::unordered_set<int>>(numNodes);
-    //edgesVector = new std::vector<std::pair<int, int>>;
-
-    for (int i = 0; i < numNodes; i++) {
-        nodeValues[i]=0;
-    }
-    this->adjMatrix = Matrix<double>(numNodes,numNodes);
+    this->nodeValues.assign(numNodes, 0);
+    this->rowOffsets.assign(numNodes+1, 0);
 
     this->nodeToIndex = std::map<std::string, int>();
     // ADDING NODE NAMES AS INTEGERS CAST TO STRING?
@@ -56,18 +51,16 @@ WeightedEdgeGraph::WeightedEdgeGraph(const Matrix<double>& _adjMatrix){
     if (_adjMatrix.getCols()==_adjMatrix.getRows()) {
         int numNodes = _adjMatrix.getCols();
         this->numberOfNodes = numNodes;
-        this->nodeValues = new double[numNodes];
-        for (int i = 0; i < numNodes; i++) {
-            nodeValues[i]=0;
-        }
-        this->adjList = std::vector<std::unordered_set<int>>(numNodes);
-        this->adjMatrix = Matrix<double>(numNodes,numNodes);
+        this->nodeValues.assign(numNodes, 0);
+        // the non-zero entries are already in row-major order, so the CSR arrays are built in one pass
+        std::vector<std::tuple<int, int, double>> entries;
         for (int i = 0 ; i<numNodes; i++) {
             for (int j = 0; j<numNodes; j++) {
                 if(!approximatelyEqual(_adjMatrix.getValue(i, j),0.0,0.0000000001)) 
-                    addEdge(i, j, _adjMatrix.getValue(i, j));
+                    entries.push_back(std::tuple<int, int, double>(i, j, _adjMatrix.getValue(i, j)));
             }
         }
+        assignEntries(entries, entries);
 
         // ADDING NODE NAMES AS INTEGERS CAST TO STRING?
 
@@ -85,14 +78,12 @@ WeightedEdgeGraph::WeightedEdgeGraph(const Matrix<double>& _adjMatrix){
 WeightedEdgeGraph::WeightedEdgeGraph(std::vector<std::string>& nodeNames){
     int numNodes = SizeToInt(nodeNames.size());
     this->numberOfNodes = numNodes;
-    this->nodeValues = new double[numNodes];
-    this->adjList = std::vector<std::unordered_set<int>>(numNodes);
-
-    this->adjMatrix = Matrix<double>(numNodes,numNodes);
+    this->nodeValues.assign(numNodes, 0);
+    this->rowOffsets.assign(numNodes+1, 0);
 
     this->nodeToIndex = std::map<std::string, int>();
+    nameVector.reserve(numNodes);
     for (int i = 0; i < numNodes; i++) {
-        nodeValues[i]=0;
         nodeToIndex[nodeNames[i]] = i;
         nameVector.push_back(nodeNames[i]);
     }
@@ -103,14 +94,12 @@ WeightedEdgeGraph::WeightedEdgeGraph(std::vector<std::string>& nodeNames,std::ve
     if(nodeNames.size()==nodeVal.size()){
         int numNodes = SizeToInt(nodeNames.size());
         this->numberOfNodes = numNodes;
-        this->nodeValues = new double[numNodes];
-        this->adjList = std::vector<std::unordered_set<int>>(numNodes);
-
-        this->adjMatrix = Matrix<double>(numNodes,numNodes);
+        this->nodeValues = nodeVal;
+        this->rowOffsets.assign(numNodes+1, 0);
 
         this->nodeToIndex = std::map<std::string, int>();
+        nameVector.reserve(numNodes);
         for (int i = 0; i < numNodes; i++) {
-            nodeValues[i]=nodeVal[i];
             nodeToIndex[nodeNames[i]] = i;
             nameVector.push_back(nodeNames[i]);
         }
@@ -119,11 +108,180 @@ WeightedEdgeGraph::WeightedEdgeGraph(std::vector<std::string>& nodeNames,std::ve
     
 }
 
+WeightedEdgeGraph::WeightedEdgeGraph(const WeightedEdgeGraph& g2){
+    assign(g2);
+}
+
 WeightedEdgeGraph::~WeightedEdgeGraph(){
-    if(nodeValues) {
-        delete [] this->nodeValues;
+}
+
+double* WeightedEdgeGraph::findEntry(int node1, int node2){
+    auto rowBegin = columnIndexes.begin() + rowOffsets[node1];
+    auto rowEnd = columnIndexes.begin() + rowOffsets[node1+1];
+    auto column = std::lower_bound(rowBegin, rowEnd, static_cast<uint32_t>(node2));
+    if(column != rowEnd && *column == static_cast<uint32_t>(node2)){
+        return &weights[std::distance(columnIndexes.begin(), column)];
     }
-    
+    if(!pendingEntries.empty()){
+        auto pendingEntry = pendingEntryIndexes.find(entryKey(node1, node2));
+        if(pendingEntry != pendingEntryIndexes.end()){
+            return &std::get<2>(pendingEntries[pendingEntry->second]);
+        }
+    }
+    return nullptr;
+}
+
+void WeightedEdgeGraph::setEntry(int node1, int node2, double weight){
+    double* entryWeight = findEntry(node1, node2);
+    if(entryWeight){
+        *entryWeight = weight;
+    } else {
+        pendingEntryIndexes[entryKey(node1, node2)] = pendingEntries.size();
+        pendingEntries.push_back(std::tuple<uint32_t, uint32_t, double>(node1, node2, weight));
+        hasPendingEntries.store(true, std::memory_order_release);
+    }
+}
+
+void WeightedEdgeGraph::compact()const{
+    if(!hasPendingEntries.load(std::memory_order_acquire)){
+        return;
+    }
+    std::lock_guard<std::mutex> lock(lazyMutex);
+    // another query could have merged the entries while waiting for the lock
+    if(!hasPendingEntries.load(std::memory_order_relaxed)){
+        return;
+    }
+    std::sort(pendingEntries.begin(), pendingEntries.end(), [](const auto& first, const auto& second){
+        return std::get<0>(first) < std::get<0>(second) || (std::get<0>(first) == std::get<0>(second) && std::get<1>(first) < std::get<1>(second));
+    });
+    std::vector<uint32_t> mergedOffsets(rowOffsets.size(), 0);
+    std::vector<uint32_t> mergedColumns;
+    std::vector<double> mergedWeights;
+    mergedColumns.reserve(columnIndexes.size() + pendingEntries.size());
+    mergedWeights.reserve(columnIndexes.size() + pendingEntries.size());
+    auto pendingEntry = pendingEntries.cbegin();
+    for(uint32_t row = 0; row + 1 < rowOffsets.size(); row++){
+        uint32_t position = rowOffsets[row];
+        // the rows and the pending entries are both sorted and disjoint, so they are merged
+        while(position < rowOffsets[row+1] || (pendingEntry != pendingEntries.cend() && std::get<0>(*pendingEntry) == row)){
+            bool pendingIsNext = pendingEntry != pendingEntries.cend() && std::get<0>(*pendingEntry) == row && (position == rowOffsets[row+1] || std::get<1>(*pendingEntry) < columnIndexes[position]);
+            if(pendingIsNext){
+                mergedColumns.push_back(std::get<1>(*pendingEntry));
+                mergedWeights.push_back(std::get<2>(*pendingEntry));
+                pendingEntry++;
+            } else {
+                mergedColumns.push_back(columnIndexes[position]);
+                mergedWeights.push_back(weights[position]);
+                position++;
+            }
+        }
+        mergedOffsets[row+1] = mergedColumns.size();
+    }
+    rowOffsets.swap(mergedOffsets);
+    columnIndexes.swap(mergedColumns);
+    weights.swap(mergedWeights);
+    pendingEntries.clear();
+    pendingEntryIndexes.clear();
+    predecessorsBuilt.store(false, std::memory_order_relaxed);
+    hasPendingEntries.store(false, std::memory_order_release);
+}
+
+void WeightedEdgeGraph::buildPredecessors()const{
+    compactAll();
+    if(predecessorsBuilt.load(std::memory_order_acquire)){
+        return;
+    }
+    std::lock_guard<std::mutex> lock(lazyMutex);
+    if(predecessorsBuilt.load(std::memory_order_relaxed)){
+        return;
+    }
+    // counting sort of the entries by column, the rows are visited in order so the predecessors are sorted
+    // the rows are visited with the core merged, so the transpose of an overlay covers the whole graph
+    predecessorOffsets.assign(numberOfNodes+1, 0);
+    for(int row = 0; row < numberOfNodes; row++){
+        forEachEntryOfRow(row, [this](uint32_t column, double){predecessorOffsets[column+1]++;});
+    }
+    std::partial_sum(predecessorOffsets.begin(), predecessorOffsets.end(), predecessorOffsets.begin());
+    predecessorIndexes.resize(predecessorOffsets.back());
+    std::vector<uint32_t> nextPosition(predecessorOffsets.begin(), predecessorOffsets.end() - 1);
+    for(int row = 0; row < numberOfNodes; row++){
+        forEachEntryOfRow(row, [this, row, &nextPosition](uint32_t column, double){predecessorIndexes[nextPosition[column]++] = row;});
+    }
+    predecessorsBuilt.store(true, std::memory_order_release);
+}
+
+int64_t WeightedEdgeGraph::entryPosition(int node1, int node2)const{
+    auto rowBegin = columnIndexes.cbegin() + rowOffsets[node1];
+    auto rowEnd = columnIndexes.cbegin() + rowOffsets[node1+1];
+    auto column = std::lower_bound(rowBegin, rowEnd, static_cast<uint32_t>(node2));
+    if(column != rowEnd && *column == static_cast<uint32_t>(node2)){
+        return std::distance(columnIndexes.cbegin(), column);
+    }
+    return -1;
+}
+
+const double* WeightedEdgeGraph::coreEntry(int node1, int node2)const{
+    if(coreGraph == nullptr || node1 >= numberOfCoreNodes || node2 >= numberOfCoreNodes){
+        return nullptr;
+    }
+    coreGraph->compact();
+    int64_t position = coreGraph->entryPosition(node1, node2);
+    return position >= 0 ? &coreGraph->weights[position] : nullptr;
+}
+
+int WeightedEdgeGraph::indexOfName(const std::string& name)const{
+    auto node = nodeToIndex.find(name);
+    if(node != nodeToIndex.end()){
+        return node->second;
+    }
+    if(coreGraph){
+        auto coreNode = coreGraph->nodeToIndex.find(name);
+        if(coreNode != coreGraph->nodeToIndex.end()){
+            return coreNode->second;
+        }
+    }
+    return -1;
+}
+
+int WeightedEdgeGraph::indexOfNameAt(const std::string& name)const{
+    int index = indexOfName(name);
+    if(index < 0){
+        throw std::out_of_range("[ERROR] WeightedEdgeGraph::indexOfNameAt: node " + name + " is not in the graph");
+    }
+    return index;
+}
+
+void WeightedEdgeGraph::assignEntries(const std::vector<std::tuple<int, int, double>>& rowMajorEntries, const std::vector<std::tuple<int, int, double>>& edges){
+    rowOffsets.assign(numberOfNodes+1, 0);
+    columnIndexes.resize(rowMajorEntries.size());
+    weights.resize(rowMajorEntries.size());
+    for(uint32_t i = 0; i < rowMajorEntries.size(); i++){
+        rowOffsets[std::get<0>(rowMajorEntries[i])+1]++;
+        columnIndexes[i] = std::get<1>(rowMajorEntries[i]);
+        weights[i] = std::get<2>(rowMajorEntries[i]);
+    }
+    std::partial_sum(rowOffsets.begin(), rowOffsets.end(), rowOffsets.begin());
+    pendingEntries.clear();
+    pendingEntryIndexes.clear();
+    hasPendingEntries.store(false, std::memory_order_relaxed);
+    predecessorsBuilt.store(false, std::memory_order_relaxed);
+    edgesVector = edges;
+    numberOfEdges = SizeToInt(edges.size());
+}
+
+void WeightedEdgeGraph::addEmptyRows(int numNewNodes){
+    rowOffsets.resize(rowOffsets.size() + numNewNodes, rowOffsets.back());
+    predecessorsBuilt.store(false, std::memory_order_relaxed);
+}
+
+void WeightedEdgeGraph::reserveNodes(int numNodes){
+    if(numNodes < 0){
+        Logger::getInstance().printError("WeightedEdgeGraph::reserveNodes: the number of nodes cannot be negative");
+        throw std::invalid_argument("[ERROR] WeightedEdgeGraph::reserveNodes: invalid argument, the number of nodes is negative");
+    }
+    nodeValues.reserve(numNodes);
+    nameVector.reserve(std::max(numNodes - numberOfCoreNodes, 0));
+    rowOffsets.reserve(numNodes+1);
 }
 
 int WeightedEdgeGraph::outDegreeOfNode(int node)const{
@@ -131,22 +289,19 @@ int WeightedEdgeGraph::outDegreeOfNode(int node)const{
         Logger::getInstance().printError("WeightedEdgeGraph::outDegreeOfNode: node is not in the graph ");
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::outDegreeOfNode: invalid argument for outdegree of node");
     }
-    return adjList[node].size();
+    compactAll();
+    int outDegree = 0;
+    forEachEntryOfRow(node, [&outDegree](uint32_t, double){outDegree++;});
+    return outDegree;
 }
 
-//TODO use adjacency matrix to get the outdegree, since it's more efficient
 int WeightedEdgeGraph::inDegreeOfNode(int node)const{
     if(node >= numberOfNodes || node < 0){
         Logger::getInstance().printError("WeightedEdgeGraph::inDegreeOfNode: node " + std::to_string(node) + " is not in the graph ");
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::inDegreeOfNode: invalid argument for indegree of node");
     }
-    int inDegree = 0;
-    for(int i = 0; i < numberOfNodes; i++){
-        if(adjList[i].contains(node)){
-            inDegree++;
-        }
-    }
-    return inDegree;
+    buildPredecessors();
+    return predecessorOffsets[node+1] - predecessorOffsets[node];
 }
 
 int WeightedEdgeGraph::degreeOfNode(int node)const{
@@ -167,16 +322,17 @@ WeightedEdgeGraph* WeightedEdgeGraph::addEdge(int node1, int node2, double weigh
             Logger::getInstance().printError("node2(number " + std::to_string(node2) + ") is not in the graph that has " + std::to_string(numberOfNodes) + " nodes");
         }
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::addEdge: failed to add an edge, see error logs");
-    } else if (connectedNodes(node1, node2)) {
+    } else if(node1 < 0 || node2 < 0){
+        Logger::getInstance().printError("add edge failed for negative index edges " + std::to_string(node1) + " and " + std::to_string(node2));
+        throw std::invalid_argument("[ERROR] WeightedEdgeGraph::addEdge: failed to add an edge, see error logs");
+    } else if (findEntry(node1, node2) || coreEntry(node1, node2)) {
         //edge already added
     } else {
         numberOfEdges++;
         edgesVector.push_back(std::tuple<int, int, double>(node1,node2, weight));
-        adjList[node1].insert(node2);
-        adjMatrix(node1,node2) = weight;
+        setEntry(node1, node2, weight);
         if(!directed){
-            adjList[node2].insert(node1);
-            adjMatrix(node2,node1) = weight;
+            setEntry(node2, node1, weight);
         }
 
     }
@@ -186,62 +342,191 @@ WeightedEdgeGraph* WeightedEdgeGraph::addEdge(int node1, int node2, double weigh
 
 
 WeightedEdgeGraph* WeightedEdgeGraph::addEdge(std::string node1name, std::string node2name, double weight, bool directed){
-    if(!(nodeToIndex.contains(node1name) && nodeToIndex.contains(node2name)) ){
+    int node1 = indexOfName(node1name);
+    int node2 = indexOfName(node2name);
+    if(node1 < 0 || node2 < 0){
         Logger::getInstance().printError("add edge failed for edges " + node1name + " and " + node2name);
-        if(!nodeToIndex.contains(node1name)){
+        if(node1 < 0){
             Logger::getInstance().printError("WeightedEdgeGraph::addEdge: node1 " + node1name + " is not in the graph ");
         }
         else{
             Logger::getInstance().printError("WeightedEdgeGraph::addEdge: node2 " + node2name + " is not in the graph ");
         }
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::addEdge: invalid argument when adding an edge");
-    } else if (connectedNodes(node1name, node2name)) {
-        adjMatrix(nodeToIndex[node1name],nodeToIndex[node2name]) = weight;
+    } else if (connectedNodes(node1, node2)) {
+        setEntry(node1, node2, weight);
     } else {
-        int node1 = nodeToIndex[node1name];
-        int node2 = nodeToIndex[node2name];
         numberOfEdges++;
         edgesVector.push_back(std::tuple<int, int, double>(node1,node2, weight));
-        adjList[node1].insert(node2);
-        adjMatrix(node1,node2) = weight;
+        setEntry(node1, node2, weight);
         if(!directed){
-            adjList[node2].insert(node1);
-            adjMatrix(node2,node1) = weight;
+            setEntry(node2, node1, weight);
         }
     }
 
     return this;
 }
 
+WeightedEdgeGraph* WeightedEdgeGraph::addEdges(const std::vector<std::tuple<std::string, std::string, double>>& edges, bool directed){
+    // the names are resolved once with a hash index over the node names, before adding any edge, so a missing node leaves the graph unchanged
+    std::unordered_map<std::string_view, int> nameIndexes;
+    nameIndexes.reserve(numberOfNodes);
+    for(int i = 0; i < numberOfNodes; i++){
+        nameIndexes.emplace(nameOfNode(i), i);
+    }
+    std::vector<std::tuple<int, int, double>> indexedEdges;
+    indexedEdges.reserve(edges.size());
+    for(const auto& [node1name, node2name, weight] : edges){
+        auto node1 = nameIndexes.find(node1name);
+        auto node2 = nameIndexes.find(node2name);
+        if(node1 == nameIndexes.end() || node2 == nameIndexes.end()){
+            Logger::getInstance().printError("add edge failed for edges " + node1name + " and " + node2name);
+            if(node1 == nameIndexes.end()){
+                Logger::getInstance().printError("WeightedEdgeGraph::addEdges: node1 " + node1name + " is not in the graph ");
+            }
+            else{
+                Logger::getInstance().printError("WeightedEdgeGraph::addEdges: node2 " + node2name + " is not in the graph ");
+            }
+            throw std::invalid_argument("[ERROR] WeightedEdgeGraph::addEdges: invalid argument when adding the edges");
+        }
+        indexedEdges.push_back(std::tuple<int, int, double>(node1->second, node2->second, weight));
+    }
+    edgesVector.reserve(edgesVector.size() + indexedEdges.size());
+    if(!directed){
+        // the reverse entries depend on the edges already added, so the edges are added in order
+        pendingEntries.reserve(pendingEntries.size() + 2*indexedEdges.size());
+        pendingEntryIndexes.reserve(pendingEntryIndexes.size() + 2*indexedEdges.size());
+        for(const auto& [node1, node2, weight] : indexedEdges){
+            double* entryWeight = findEntry(node1, node2);
+            if(entryWeight){
+                *entryWeight = weight;
+            } else if(coreEntry(node1, node2)){
+                // the overlay entry replaces the weight of the core
+                setEntry(node1, node2, weight);
+            } else {
+                numberOfEdges++;
+                edgesVector.push_back(std::tuple<int, int, double>(node1, node2, weight));
+                setEntry(node1, node2, weight);
+                setEntry(node2, node1, weight);
+            }
+        }
+        compact();
+        return this;
+    }
+    compact();
+    // sorting by entry and then by position groups the repeated edges and keeps them in the order of the list
+    std::vector<std::pair<uint64_t, uint32_t>> sortedEntries(indexedEdges.size());
+    for(uint32_t i = 0; i < indexedEdges.size(); i++){
+        sortedEntries[i] = std::make_pair(entryKey(std::get<0>(indexedEdges[i]), std::get<1>(indexedEdges[i])), i);
+    }
+    std::sort(sortedEntries.begin(), sortedEntries.end());
+    std::vector<bool> isNewEdge(indexedEdges.size(), false);
+    for(size_t first = 0; first < sortedEntries.size();){
+        size_t last = first;
+        while(last + 1 < sortedEntries.size() && sortedEntries[last+1].first == sortedEntries[first].first){
+            last++;
+        }
+        int node1 = std::get<0>(indexedEdges[sortedEntries[first].second]);
+        int node2 = std::get<1>(indexedEdges[sortedEntries[first].second]);
+        // the entry keeps the weight of the last repetition, the edges vector the weight of the first one
+        double lastWeight = std::get<2>(indexedEdges[sortedEntries[last].second]);
+        int64_t position = entryPosition(node1, node2);
+        if(position >= 0){
+            weights[position] = lastWeight;
+        } else {
+            // an entry of the core is replaced by the overlay entry, but it is not a new edge
+            isNewEdge[sortedEntries[first].second] = coreEntry(node1, node2) == nullptr;
+            pendingEntries.push_back(std::tuple<uint32_t, uint32_t, double>(node1, node2, lastWeight));
+        }
+        first = last + 1;
+    }
+    for(size_t i = 0; i < indexedEdges.size(); i++){
+        if(isNewEdge[i]){
+            numberOfEdges++;
+            edgesVector.push_back(indexedEdges[i]);
+        }
+    }
+    // the new entries are already sorted, they are merged into the CSR arrays at once
+    hasPendingEntries.store(!pendingEntries.empty(), std::memory_order_relaxed);
+    compact();
+    return this;
+}
+
+std::vector<std::tuple<int, int, double>> WeightedEdgeGraph::updateEdgeWeights(const std::vector<std::tuple<int, int, double>>& newEdgeWeights, bool directed){
+    std::vector<std::tuple<int, int, double>> previousEdgeWeights;
+    bool existingEdgeUpdated = false;
+    for(auto it = newEdgeWeights.cbegin(); it != newEdgeWeights.cend(); it++){
+        int node1 = std::get<0>(*it);
+        int node2 = std::get<1>(*it);
+        double weight = std::get<2>(*it);
+        if(node1 < 0 || node2 < 0 || node1 >= numberOfNodes || node2 >= numberOfNodes){
+            Logger::getInstance().printError("WeightedEdgeGraph::updateEdgeWeights: edge (" + std::to_string(node1) + "," + std::to_string(node2) + ") is not in the graph that has " + std::to_string(numberOfNodes) + " nodes");
+            throw std::invalid_argument("[ERROR] WeightedEdgeGraph::updateEdgeWeights: failed to update the edge weights, see error logs");
+        }
+        std::vector<std::pair<int,int>> entries = {std::make_pair(node1,node2)};
+        if(!directed && node1 != node2){
+            entries.push_back(std::make_pair(node2,node1));
+        }
+        for(auto entry : entries){
+            double* entryWeight = findEntry(entry.first, entry.second);
+            const double* coreWeight = entryWeight ? nullptr : coreEntry(entry.first, entry.second);
+            previousEdgeWeights.push_back(std::tuple<int, int, double>(entry.first, entry.second, entryWeight ? *entryWeight : (coreWeight ? *coreWeight : 0)));
+            if(entryWeight){
+                *entryWeight = weight;
+                existingEdgeUpdated = true;
+            } else if(coreWeight){
+                // the core is read-only, the new weight is kept by the overlay
+                setEntry(entry.first, entry.second, weight);
+            } else {
+                addEdge(entry.first, entry.second, weight);
+            }
+        }
+    }
+    // the edges vector is refreshed once for all the updates, instead of searching it for every edge
+    if(existingEdgeUpdated){
+        for(auto& edge : edgesVector){
+            std::get<2>(edge) = *findEntry(std::get<0>(edge), std::get<1>(edge));
+        }
+    }
+    return previousEdgeWeights;
+}
+
+std::vector<std::tuple<int, int, double>> WeightedEdgeGraph::updateEdgeWeights(const std::vector<std::tuple<std::string, std::string, double>>& newEdgeWeights, bool directed){
+    std::vector<std::tuple<int, int, double>> newEdgeWeightsIndexes;
+    newEdgeWeightsIndexes.reserve(newEdgeWeights.size());
+    for(auto it = newEdgeWeights.cbegin(); it != newEdgeWeights.cend(); it++){
+        std::string node1name = std::get<0>(*it);
+        std::string node2name = std::get<1>(*it);
+        int node1 = indexOfName(node1name);
+        int node2 = indexOfName(node2name);
+        if(node1 < 0 || node2 < 0){
+            Logger::getInstance().printError("WeightedEdgeGraph::updateEdgeWeights: node " + node1name + " or " + node2name + " is not in the graph ");
+            throw std::invalid_argument("[ERROR] WeightedEdgeGraph::updateEdgeWeights: invalid argument when updating the edge weights");
+        }
+        newEdgeWeightsIndexes.push_back(std::tuple<int, int, double>(node1, node2, std::get<2>(*it)));
+    }
+    return updateEdgeWeights(newEdgeWeightsIndexes, directed);
+}
+
 WeightedEdgeGraph* WeightedEdgeGraph::addNode(double value){
     this->numberOfNodes++;
-    adjMatrix = adjMatrix.copyAndAddRowsColsWithZeros(1, 1);
-    double* tmp = nodeValues;
-    nodeValues = new double[this->numberOfNodes];
-    std::copy(tmp,tmp+(this->numberOfNodes-1),nodeValues);
-    delete [] tmp;
-    nodeValues[this->numberOfNodes-1]=value;
-
-    adjList.push_back(std::unordered_set<int>());
+    addEmptyRows(1);
+    nodeValues.push_back(value);
+
     nameVector.push_back(std::to_string(this->numberOfNodes-1));
     nodeToIndex[std::to_string(this->numberOfNodes-1)] = this->numberOfNodes-1;
     return this;
 }
 WeightedEdgeGraph* WeightedEdgeGraph::addNode(std::string name, double value){
-    if(nodeToIndex.contains(name)){
+    if(indexOfName(name) >= 0){
         //throw exceptions or handle it differently, like incrementing a counter or changing-adding the last characters to the string
         // for now it just throws an exception
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::addNode: node name already present");
     }else{
         this->numberOfNodes++;
-        adjMatrix = adjMatrix.copyAndAddRowsColsWithZeros(1, 1);
-        double* tmp = nodeValues;
-        nodeValues = new double[this->numberOfNodes];
-        std::copy(tmp,tmp+(this->numberOfNodes-1),nodeValues);
-        delete [] tmp;
-        nodeValues[this->numberOfNodes-1]=value;
-
-        adjList.push_back(std::unordered_set<int>());
+        addEmptyRows(1);
+        nodeValues.push_back(value);
+
         nameVector.push_back(name);
         nodeToIndex[name] = this->numberOfNodes-1;
     }
@@ -252,25 +537,21 @@ WeightedEdgeGraph* WeightedEdgeGraph::addNode(std::string name, double value){
 WeightedEdgeGraph* WeightedEdgeGraph::addNodes(const std::vector<double>& values){
     int oldNumberOfNodes = this->numberOfNodes; 
     this->numberOfNodes += values.size();
-    adjMatrix = adjMatrix.copyAndAddRowsColsWithZeros(values.size(), values.size());
-    double* tmp = nodeValues;
-    nodeValues = new double[this->numberOfNodes];
-    std::copy(tmp,tmp+(oldNumberOfNodes),nodeValues);
-    delete [] tmp;
-    
-    int i = 0;
-    for(auto it = values.cbegin();it != values.cend();it++,i++){
-        adjList.push_back(std::unordered_set<int>());
-        nameVector.push_back(std::to_string(oldNumberOfNodes+i));
-        nodeToIndex[std::to_string(oldNumberOfNodes+i)] = oldNumberOfNodes + i;
-        nodeValues[oldNumberOfNodes+i]=*it;
+    addEmptyRows(values.size());
+    // the arrays are resized once for the whole batch
+    nodeValues.insert(nodeValues.end(), values.cbegin(), values.cend());
+    nameVector.reserve(this->numberOfNodes - numberOfCoreNodes);
+
+    for(int i = oldNumberOfNodes; i < this->numberOfNodes; i++){
+        nameVector.push_back(std::to_string(i));
+        nodeToIndex[nameVector.back()] = i;
     }
     return this;
 }
 
 WeightedEdgeGraph* WeightedEdgeGraph::addNodes(const std::vector<std::string>& names, const std::vector<double>& values){
     //how to handle some names already present in the graph?
-    auto controlMapContainsValue = [this](std::string name){return this->nodeToIndex.contains(name);};
+    auto controlMapContainsValue = [this](std::string name){return this->indexOfName(name) >= 0;};
     std::vector<bool> tmpVec = std::vector<bool>(names.size(),false);  // initialization is necessary when working with transformation
     std::transform(names.cbegin(),names.cend(),tmpVec.begin(),controlMapContainsValue);
     if(std::reduce(tmpVec.cbegin(),tmpVec.cend(),false,[](bool num1, bool num2){return num1 || num2;})){
@@ -280,18 +561,13 @@ WeightedEdgeGraph* WeightedEdgeGraph::addNodes(const std::vector<std::string>& n
         //default values
         int oldNumberOfNodes = this->numberOfNodes; 
         this->numberOfNodes += names.size();
-        adjMatrix = adjMatrix.copyAndAddRowsColsWithZeros(names.size(), names.size());
-        double* tmp = nodeValues;
-        nodeValues = new double[this->numberOfNodes];
-        std::copy(tmp,tmp+(oldNumberOfNodes),nodeValues);
-        delete [] tmp;
+        addEmptyRows(names.size());
+        nodeValues.resize(this->numberOfNodes, 0);
+        nameVector.insert(nameVector.end(), names.cbegin(), names.cend());
         
         int i = 0;
         for(auto it = names.cbegin();it != names.cend();it++,i++){
-            adjList.push_back(std::unordered_set<int>());
-            nameVector.push_back(*it);
             nodeToIndex[*it] = oldNumberOfNodes + i;
-            nodeValues[oldNumberOfNodes+i]=0;
         }
 
     }
@@ -301,19 +577,13 @@ WeightedEdgeGraph* WeightedEdgeGraph::addNodes(const std::vector<std::string>& n
     else {
         int oldNumberOfNodes = this->numberOfNodes; 
         this->numberOfNodes += names.size();
-        adjMatrix = adjMatrix.copyAndAddRowsColsWithZeros(names.size(), names.size());
-        double* tmp = nodeValues;
-        nodeValues = new double[this->numberOfNodes];
-        std::copy(tmp,tmp+(oldNumberOfNodes),nodeValues);
-        delete [] tmp;
+        addEmptyRows(names.size());
+        nodeValues.insert(nodeValues.end(), values.cbegin(), values.cend());
+        nameVector.insert(nameVector.end(), names.cbegin(), names.cend());
         
-        //std::copy(nodeValues + oldNumberOfNodes,nodeValues+this->numberOfNodes,values.cbegin());
         int i = 0;
         for(auto it = names.cbegin();it != names.cend();it++,i++){
-            adjList.push_back(std::unordered_set<int>());
-            nameVector.push_back(*it);
             nodeToIndex[*it] = oldNumberOfNodes + i;
-            nodeValues[oldNumberOfNodes+i]=values[i];
         }
     }
     return this;
@@ -321,14 +591,41 @@ WeightedEdgeGraph* WeightedEdgeGraph::addNodes(const std::vector<std::string>& n
 
 WeightedEdgeGraph* WeightedEdgeGraph::addNodesAndCopyNew(const std::vector<double>& values){
     WeightedEdgeGraph* retPointer = this->copyNew();
+    retPointer->reserveNodes(numberOfNodes + SizeToInt(values.size()));
     return retPointer->addNodes(values);
 }
 
 WeightedEdgeGraph* WeightedEdgeGraph::addNodesAndCopyNew(const std::vector<std::string>& names, const std::vector<double>& values){
     WeightedEdgeGraph* retPointer = this->copyNew();
+    retPointer->reserveNodes(numberOfNodes + SizeToInt(names.size()));
     return retPointer->addNodes(names,values);
 }
 
+WeightedEdgeGraph* WeightedEdgeGraph::addNodesAndOverlayNew(const std::vector<std::string>& names, const std::vector<double>& values)const{
+    WeightedEdgeGraph* retPointer = new WeightedEdgeGraph();
+    if(coreGraph){
+        // the overlays are never chained, the new overlay shares the core and copies the delta of this overlay
+        retPointer->assign(*this);
+    } else {
+        compact();
+        retPointer->coreGraph = this;
+        retPointer->numberOfCoreNodes = numberOfNodes;
+        retPointer->numberOfNodes = numberOfNodes;
+        retPointer->numberOfEdges = numberOfEdges;
+        retPointer->nodeValues = nodeValues;
+        // the rows of the core nodes are empty until the overlay adds or changes their entries
+        retPointer->rowOffsets.assign(numberOfNodes+1, 0);
+    }
+    retPointer->reserveNodes(retPointer->numberOfNodes + SizeToInt(names.size()));
+    try {
+        retPointer->addNodes(names, values);
+    } catch (const std::invalid_argument&) {
+        delete retPointer;
+        throw;
+    }
+    return retPointer;
+}
+
 WeightedEdgeGraph* WeightedEdgeGraph::setNodeValue(int node, double value){
     if (node < numberOfNodes && node >= 0) {
         nodeValues[node] = value;
@@ -338,8 +635,9 @@ WeightedEdgeGraph* WeightedEdgeGraph::setNodeValue(int node, double value){
     return this;
 }
 WeightedEdgeGraph* WeightedEdgeGraph::setNodeValue(std::string node, double value){
-    if ( nodeToIndex.contains(node)) {
-        nodeValues[nodeToIndex[node]] = value;
+    int index = indexOfName(node);
+    if (index >= 0) {
+        nodeValues[index] = value;
     } else{
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::setNodeValue: node name not in the graph");
     }
@@ -354,6 +652,10 @@ WeightedEdgeGraph* WeightedEdgeGraph::setNodeName(std::string nodenameTarget, st
         node.key() = nodenameSet;
         nodeToIndex.insert(std::move(node));
     }
+    else if(coreGraph && coreGraph->containsNode(nodenameTarget)){
+        Logger::getInstance().printError("WeightedEdgeGraph::setNodeName: node " + nodenameTarget + " is in the read-only core of the overlay");
+        throw std::invalid_argument("[ERROR] WeightedEdgeGraph::setNodeName: the nodes of the core of an overlay cannot be renamed");
+    }
     else{
         Logger::getInstance().printError("WeightedEdgeGraph::setNodeName: node name not found: " + nodenameTarget);
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::setNodeName: node name not found");
@@ -372,6 +674,10 @@ WeightedEdgeGraph* WeightedEdgeGraph::setNodesNames(const std::vector<std::strin
             
         }
     } else if( (nodenameTargets.size() == 0)){
+        if(coreGraph){
+            Logger::getInstance().printError("WeightedEdgeGraph::setNodesNames: the names of the core of an overlay are read-only");
+            throw std::invalid_argument("[ERROR] WeightedEdgeGraph::setNodesNames: the nodes of the core of an overlay cannot be renamed");
+        }
         if ((nodenameSets.size()==nodeToIndex.size() && nameVector.size() == nodenameSets.size())) {
             nodeToIndex = std::map<std::string, int>(); //getting rid of the old mapping
             nameVector = nodenameSets;
@@ -395,8 +701,9 @@ double WeightedEdgeGraph::getNodeValue(int node)const{
     else throw std::invalid_argument("[ERROR] WeightedEdgeGraph::getNodeValue: node value cannot be retrieved: node not in the list (as index)"); 
 }
 double WeightedEdgeGraph::getNodeValue(std::string node)const{
-    if(nodeToIndex.contains(node))
-        return nodeValues[nodeToIndex.at(node)];
+    int index = indexOfName(node);
+    if(index >= 0)
+        return nodeValues[index];
     else throw std::invalid_argument("[ERROR] WeightedEdgeGraph::getNodeValue: node value cannot be retrieved: node not in the list (as name)");
 }
 std::vector<double> WeightedEdgeGraph::getNodeValues(const std::vector<int>& nodes)const{
@@ -424,13 +731,43 @@ std::vector<double> WeightedEdgeGraph::getNodeValues(const std::vector<std::stri
 
 
 
+double WeightedEdgeGraph::getEdgeWeight(int node1, int node2)const{
+    if(node1 < 0 || node2 < 0){
+        throw std::out_of_range("WeightedEdgeGraph::getEdgeWeight: one of the nodes is out of range(index)");
+    } else if(node1 >= numberOfNodes || node2 >= numberOfNodes){
+        throw std::invalid_argument("[ERROR] WeightedEdgeGraph::getEdgeWeight: one of the nodes is not in the graph that has " + std::to_string(numberOfNodes) + " nodes");
+    }
+    compact();
+    int64_t position = entryPosition(node1, node2);
+    if(position >= 0){
+        return weights[position];
+    }
+    const double* coreWeight = coreEntry(node1, node2);
+    return coreWeight ? *coreWeight : 0;
+}
+
+Matrix<double> WeightedEdgeGraph::getAdjacencyMatrix()const{
+    compactAll();
+    Matrix<double> adjacencyMatrix(numberOfNodes, numberOfNodes);
+    for(int i = 0; i < numberOfNodes; i++){
+        forEachEntryOfRow(i, [&adjacencyMatrix, i](uint32_t column, double weight){adjacencyMatrix(i, column) = weight;});
+    }
+    return adjacencyMatrix;
+}
+
+std::vector<double> WeightedEdgeGraph::getAbsoluteOutWeights()const{
+    compactAll();
+    std::vector<double> absoluteOutWeights(numberOfNodes, 0);
+    for(int i = 0; i < numberOfNodes; i++){
+        forEachEntryOfRow(i, [&absoluteOutWeights, i](uint32_t, double weight){absoluteOutWeights[i] += std::abs(weight);});
+    }
+    return absoluteOutWeights;
+}
+
 //functions to remove since they can be problematic
 
-//TODO complete
 Matrix<double> WeightedEdgeGraph::makeMatrix(){
-    //emptying old memory
-    // new array
-    return this->adjMatrix;
+    return getAdjacencyMatrix();
 }
 
 
@@ -446,6 +783,45 @@ int WeightedEdgeGraph::getNumEdges()const {
     return numberOfEdges;
 }
 
+std::vector<std::string> WeightedEdgeGraph::getNodeNames()const{
+    if(coreGraph == nullptr){
+        return nameVector;
+    }
+    std::vector<std::string> names;
+    names.reserve(numberOfNodes);
+    names.insert(names.end(), coreGraph->nameVector.cbegin(), coreGraph->nameVector.cend());
+    names.insert(names.end(), nameVector.cbegin(), nameVector.cend());
+    return names;
+}
+
+std::map<std::string, int> WeightedEdgeGraph::getNodeToIndexMap()const{
+    if(coreGraph == nullptr){
+        return nodeToIndex;
+    }
+    std::map<std::string, int> mergedNodeToIndex = coreGraph->nodeToIndex;
+    mergedNodeToIndex.insert(nodeToIndex.cbegin(), nodeToIndex.cend());
+    return mergedNodeToIndex;
+}
+
+std::vector<std::tuple<int, int, double>> WeightedEdgeGraph::getEdgesVector()const{
+    if(coreGraph == nullptr){
+        return edgesVector;
+    }
+    compact();
+    std::vector<std::tuple<int, int, double>> edges;
+    edges.reserve(coreGraph->edgesVector.size() + edgesVector.size());
+    for(const auto& edge : coreGraph->edgesVector){
+        edges.push_back(edge);
+        // the weights of the core changed by the overlay
+        int64_t position = entryPosition(std::get<0>(edge), std::get<1>(edge));
+        if(position >= 0){
+            std::get<2>(edges.back()) = weights[position];
+        }
+    }
+    edges.insert(edges.end(), edgesVector.cbegin(), edgesVector.cend());
+    return edges;
+}
+
 
 std::string WeightedEdgeGraph::getnodeValuesStr()const{
     std::string stringa = "";
@@ -464,11 +840,14 @@ std::unordered_set<int> WeightedEdgeGraph::getAdjList(int node)const{
         Logger::getInstance().printError("getAdjList: trying to get an adjacent list of negative index node: " + std::to_string(node));
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::getAdjList: adjacent list of an negative index node");    
     }
-    return adjList[node];
+    compactAll();
+    std::unordered_set<int> adjList;
+    forEachEntryOfRow(node, [&adjList](uint32_t column, double){adjList.insert(column);});
+    return adjList;
 }
 
 std::unordered_set<int> WeightedEdgeGraph::getAdjList(std::string node)const{
-    return getAdjList(nodeToIndex.at(node));
+    return getAdjList(indexOfNameAt(node));
 }
 
 std::string WeightedEdgeGraph::getAdjListStr(int node)const{
@@ -481,7 +860,7 @@ std::string WeightedEdgeGraph::getAdjListStr(int node)const{
 }
 
 bool WeightedEdgeGraph::containsNode(std::string node)const{
-    return nodeToIndex.contains(node);
+    return indexOfName(node) >= 0;
 }
 
 std::vector<int> WeightedEdgeGraph::getPredecessors(int node)const{
@@ -489,13 +868,8 @@ std::vector<int> WeightedEdgeGraph::getPredecessors(int node)const{
         Logger::getInstance().printError("WeightedEdgeGraph::getPredecessors: node " + std::to_string(node) + " is not in the graph ");
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::getPredecessors: invalid argument for predecessors of node");
     }
-    std::vector<int> predecessors;
-    for(int i = 0; i < numberOfNodes; i++){
-        if(adjList[i].contains(node)){
-            predecessors.push_back(i);
-        }
-    }
-    return predecessors;
+    buildPredecessors();
+    return std::vector<int>(predecessorIndexes.cbegin() + predecessorOffsets[node], predecessorIndexes.cbegin() + predecessorOffsets[node+1]);
 }
 
 std::vector<int> WeightedEdgeGraph::getSuccessors(int node)const{
@@ -503,10 +877,9 @@ std::vector<int> WeightedEdgeGraph::getSuccessors(int node)const{
         Logger::getInstance().printError("WeightedEdgeGraph::getSuccessors: node " + std::to_string(node) + " is not in the graph ");
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::getSuccessors: invalid argument for successors of node");
     }
+    compactAll();
     std::vector<int> successors;
-    for(auto it = adjList[node].cbegin(); it != adjList[node].cend(); it++){
-        successors.push_back(*it);
-    }
+    forEachEntryOfRow(node, [&successors](uint32_t column, double){successors.push_back(column);});
     return successors;
 }
 
@@ -524,82 +897,85 @@ std::vector<int> WeightedEdgeGraph::getNeighbors(int node)const{
 }
 
 std::vector<std::string> WeightedEdgeGraph::getPredecessors(std::string node)const{
-    if(!nodeToIndex.contains(node)){
+    int nodeIndex = indexOfName(node);
+    if(nodeIndex < 0){
         Logger::getInstance().printError("WeightedEdgeGraph::getPredecessors: node " + node + " is not in the graph ");
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::getPredecessors: invalid argument for predecessors of node");
     }
-    int nodeIndex = nodeToIndex.at(node);
     std::vector<int> predecessors = getPredecessors(nodeIndex);
     std::vector<std::string> ret;
     for(auto it = predecessors.cbegin(); it != predecessors.cend(); it++){
-        ret.push_back(nameVector[*it]);
+        ret.push_back(nameOfNode(*it));
     }
     return ret;
 }
 
 std::vector<std::string> WeightedEdgeGraph::getSuccessors(std::string node)const{
-    if(!nodeToIndex.contains(node)){
+    int nodeIndex = indexOfName(node);
+    if(nodeIndex < 0){
         Logger::getInstance().printError("WeightedEdgeGraph::getSuccessors: node " + node + " is not in the graph ");
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::getSuccessors: invalid argument for successors of node");
     }
-    int nodeIndex = nodeToIndex.at(node);
     std::vector<int> successors = getSuccessors(nodeIndex);
     std::vector<std::string> ret;
     for(auto it = successors.cbegin(); it != successors.cend(); it++){
-        ret.push_back(nameVector[*it]);
+        ret.push_back(nameOfNode(*it));
     }
     return ret;
 }
 
 std::vector<std::string> WeightedEdgeGraph::getNeighbors(std::string node)const{
-    if(!nodeToIndex.contains(node)){
+    int nodeIndex = indexOfName(node);
+    if(nodeIndex < 0){
         Logger::getInstance().printError("WeightedEdgeGraph::getNeighbors: node " + node + " is not in the graph ");
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::getNeighbors: invalid argument for neighbors of node");
     }
-    int nodeIndex = nodeToIndex.at(node);
     std::vector<int> neighbors = getNeighbors(nodeIndex);
     std::vector<std::string> ret;
     for(auto it = neighbors.cbegin(); it != neighbors.cend(); it++){
-        ret.push_back(nameVector[*it]);
+        ret.push_back(nameOfNode(*it));
     }
     return ret;
 }
 
 
 std::string WeightedEdgeGraph::getAdjListStr(std::string node)const{
-    return getAdjListStr(nodeToIndex.at(node));
-}
-
-std::vector<std::tuple<int, int,double>> WeightedEdgeGraph::getEdgesVector()const{
-    return edgesVector;
+    return getAdjListStr(indexOfNameAt(node));
 }
 
-
 bool WeightedEdgeGraph::adjNodes(int node1, int node2){
-    std::unordered_set<int> adjListNode1 = getAdjList(node1);
-    std::unordered_set<int> adjListNode2 = getAdjList(node2);
-    return ( (adjListNode1.find(node2) != adjListNode1.end()) || (adjListNode2.find(node1) != adjListNode2.end())) ;
+    if(node2 >= numberOfNodes || node2 < 0){
+        Logger::getInstance().printError("WeightedEdgeGraph::adjNodes: node " + std::to_string(node2) + " is not in the graph ");
+        throw std::invalid_argument("[ERROR] WeightedEdgeGraph::adjNodes: invalid argument for adjacent nodes");
+    }
+    return connectedNodes(node1, node2) || connectedNodes(node2, node1);
 }
 
 bool WeightedEdgeGraph::adjNodes(std::string node1, std::string node2){
-    int node1Index = nodeToIndex.at(node1);
-    int node2Index = nodeToIndex.at(node2);
+    int node1Index = indexOfNameAt(node1);
+    int node2Index = indexOfNameAt(node2);
     return adjNodes(node1Index,node2Index);
 }
 
 
 bool WeightedEdgeGraph::connectedNodes(int node1, int node2){
-    std::unordered_set<int> adjListNode = getAdjList(node1);
-    return ( adjListNode.find(node2) != adjListNode.end());
+    if(node1 >= numberOfNodes || node1 < 0){
+        Logger::getInstance().printError("WeightedEdgeGraph::connectedNodes: node " + std::to_string(node1) + " is not in the graph ");
+        throw std::invalid_argument("[ERROR] WeightedEdgeGraph::connectedNodes: invalid argument for connected nodes");
+    }
+    if(node2 >= numberOfNodes || node2 < 0){
+        return false;
+    }
+    return findEntry(node1, node2) != nullptr || coreEntry(node1, node2) != nullptr;
 }
 
 bool WeightedEdgeGraph::connectedNodes(std::string node1, std::string node2){
-    if(!nodeToIndex.contains(node1) || !nodeToIndex.contains(node2)){
+    int node1Index = indexOfName(node1);
+    int node2Index = indexOfName(node2);
+    if(node1Index < 0 || node2Index < 0){
         Logger::getInstance().printError("WeightedEdgeGraph::connectedNodes: node " + node1 + " or " + node2 + " is not in the graph ");
         throw std::invalid_argument("[ERROR] WeightedEdgeGraph::connectedNodes: invalid argument for connected nodes");
     }
-    int node1Index = nodeToIndex.at(node1);
-    int node2Index = nodeToIndex.at(node2);
     return ( connectedNodes(node1Index,node2Index)); ;
 }
 
@@ -622,30 +998,8 @@ double WeightedEdgeGraph::getAverageDegree()const{
     return sum/numberOfNodes;
 }
 
-//non copy and swap to not reallocate some of the resources (doesn't get called with g1 = g2 but its called when invocking *g1=*g2 on pointers)
 WeightedEdgeGraph& WeightedEdgeGraph::operator=(const WeightedEdgeGraph& g2){
-    if (this!=&g2) {
-        this->numberOfNodes = g2.numberOfNodes;
-        //deleting old data
-        if(nodeValues)delete[] nodeValues;
-
-        //creating new data
-        this->nodeValues = new double[g2.numberOfNodes];
-        this->adjList = std::vector<std::unordered_set<int>>(g2.numberOfNodes);
-        this->edgesVector.clear();
-        this->adjMatrix = Matrix<double>(g2.numberOfNodes,g2.numberOfNodes);
-
-        for(auto it = g2.edgesVector.cbegin(); it!=g2.edgesVector.cend();it++){
-            int node1 = std::get<0>(*it);
-            int node2 = std::get<1>(*it);
-            double weight = std::get<2>(*it);
-            this->addEdge(node1,node2,weight);
-        }
-        this->nodeToIndex = g2.getNodeToIndexMap();   //maybe the error is here
-        for (int i = 0; i < this->numberOfNodes; i++) {
-            nodeValues[i]=g2.getNodeValue(i);
-        }
-    }
+    assign(g2);
     return *this;
 }
 
@@ -653,39 +1007,48 @@ WeightedEdgeGraph& WeightedEdgeGraph::operator=(const WeightedEdgeGraph& g2){
 void WeightedEdgeGraph::assign(const WeightedEdgeGraph& g2){
     if (this!=&g2) {
         this->numberOfNodes = g2.numberOfNodes;
-        //deleting old data
-        if(nodeValues)delete[] nodeValues;
-
-        //creating new data
-        this->nodeValues = new double[g2.numberOfNodes];
-        this->adjList = std::vector<std::unordered_set<int>>(g2.numberOfNodes);
-        this->edgesVector.clear();
-        this->adjMatrix = Matrix<double>(g2.numberOfNodes,g2.numberOfNodes);
-
-        for(auto it = g2.edgesVector.cbegin(); it!=g2.edgesVector.cend();it++){
-            int node1 = std::get<0>(*it);
-            int node2 = std::get<1>(*it);
-            double weight = std::get<2>(*it);
-            this->addEdge(node1,node2,weight);
-        }
-        this->nodeToIndex = g2.getNodeToIndexMap();   //maybe the error is here
-        for (int i = 0; i < this->numberOfNodes; i++) {
-            nodeValues[i]=g2.getNodeValue(i);
-        }
+        this->coreGraph = g2.coreGraph;
+        this->numberOfCoreNodes = g2.numberOfCoreNodes;
+        this->nodeValues = g2.nodeValues;
+        this->nameVector = g2.nameVector;
+        this->nodeToIndex = g2.nodeToIndex;
+        // the CSR arrays are copied as they are, instead of adding the edges one by one
+        g2.compact();
+        this->rowOffsets = g2.rowOffsets;
+        this->columnIndexes = g2.columnIndexes;
+        this->weights = g2.weights;
+        this->pendingEntries.clear();
+        this->pendingEntryIndexes.clear();
+        this->hasPendingEntries.store(false, std::memory_order_relaxed);
+        this->predecessorsBuilt.store(false, std::memory_order_relaxed);
+        this->edgesVector = g2.edgesVector;
+        this->numberOfEdges = g2.numberOfEdges;
     }
     return;
 }
 
 WeightedEdgeGraph* WeightedEdgeGraph::copyNew()const{
-    WeightedEdgeGraph* g2 = new WeightedEdgeGraph(adjMatrix);
+    compactAll();
+    std::vector<std::tuple<int, int, double>> entries;
+    entries.reserve(columnIndexes.size() + (coreGraph ? coreGraph->columnIndexes.size() : 0));
+    for (int i = 0 ; i<numberOfNodes; i++) {
+        forEachEntryOfRow(i, [&entries, i](uint32_t column, double weight){
+            if(!approximatelyEqual(weight,0.0,0.0000000001))
+                entries.push_back(std::tuple<int, int, double>(i, column, weight));
+        });
+    }
+    WeightedEdgeGraph* g2 = new WeightedEdgeGraph(numberOfNodes);
+    g2->assignEntries(entries, entries);
     //creating new data
-    g2->setNodesNames(nameVector);
+    g2->setNodesNames(getNodeNames());
     
     for (int i = 0; i < this->numberOfNodes; i++) {
         g2->setNodeValue(i,getNodeValue(i));
     }
 
-    for(auto it = edgesVector.cbegin(); it!=edgesVector.cend();it++){
+    // the zero weight edges are not among the non-zero entries
+    std::vector<std::tuple<int, int, double>> allEdges = getEdgesVector();
+    for(auto it = allEdges.cbegin(); it!=allEdges.cend();it++){
         int node1 = std::get<0>(*it);
         int node2 = std::get<1>(*it);
         double weight = std::get<2>(*it);
@@ -743,7 +1106,7 @@ std::ostream& operator<< (std::ostream &out, const WeightedEdgeGraph& data) {
             out << "Adj matrix: (";
             for(int i = 0;i<data.getNumNodes();i++){
                 for(int j = 0;j<data.getNumNodes();j++){
-                    out << data.adjMatrix.getValue(i,j) << ", ";
+                    out << data.getEdgeWeight(i,j) << ", ";
                 }
                 out <<std::endl ;
             }
@@ -780,11 +1143,12 @@ void WeightedEdgeGraph::saveEdgesToFile(std::string outputFolder, std::string fi
     // write the header
     myfile << "source" << "\t" << "target" << "\t" << "weight" << std::endl;
     if(myfile.is_open()){
-        for(auto it = edgesVector.cbegin(); it!=edgesVector.cend();it++){
+        std::vector<std::tuple<int, int, double>> allEdges = getEdgesVector();
+        for(auto it = allEdges.cbegin(); it!=allEdges.cend();it++){
             int node1_id = std::get<0>(*it);
             int node2_id = std::get<1>(*it);
-            std::string node1 = nameVector[node1_id];
-            std::string node2 = nameVector[node2_id];
+            const std::string& node1 = nameOfNode(node1_id);
+            const std::string& node2 = nameOfNode(node2_id);
             double weight = std::get<2>(*it);
             myfile << node1 << "\t" << node2 << "\t" << weight << std::endl;
         }
@@ -8,31 +8,173 @@
 
 #include "data_structures/Matrix.hxx"
 #include "logging/Logger.hxx"  
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <ostream>
 #include <stdexcept>
 #include <string>
 #include <sys/types.h>
 #include <tuple>
 /*std::get<i>( tpl) to get the value or set it in a tuple*/
+#include <unordered_map>
 #include <unordered_set>
 #include <iostream>
 #include <vector>
 #include <utility>
 
+/**
+ * @class WeightedEdgeGraph
+ * @brief Weighted directed graph stored in compressed sparse row (CSR) format.
+ * @details The adjacency is kept as the row offsets, the sorted column indexes and the contiguous weights of the entries, so the memory is linear in the number of edges.
+ * @details The edges added one at a time are buffered and merged into the CSR arrays by the first query that needs them, the predecessors (transpose of the CSR) are built on demand.
+ * @details The dense adjacency matrix is not stored, it is built only when requested with getAdjacencyMatrix (dense engines).
+ * @details A graph can also be an overlay of a shared read-only core graph (see addNodesAndOverlayNew): the core keeps the nodes, the names and the edges shared by many graphs,
+ * the overlay stores only its own nodes (appended after the nodes of the core), the entries it adds and the entries of the core whose weight it changes.
+ * Every query merges the core and the overlay, so an overlay behaves as the full graph, without copying the core.
+ * @note The lazy structures are built under a mutex, so concurrent const queries on the same graph are safe. Mutations still require exclusive access.
+ */
 class WeightedEdgeGraph{
     private:
         int numberOfNodes=0; ///< number of nodes in the graph
         int numberOfEdges=0; ///< number of edges in the graph
-        double* nodeValues=nullptr;  ///< arrays of nodeValues
-        std::vector<std::unordered_set<int>> adjList;  ///< adjList as vector of unordered sets
+        std::vector<double> nodeValues;  ///< values of the nodes, grown geometrically when nodes are added
         std::vector<std::string> nameVector; ///< vector of node names
         std::map<std::string, int> nodeToIndex; ///< map of node names to indexes
+        std::vector<std::tuple<int, int, double> > edgesVector; ///< vector of edges as tuples (node1ID, node2ID, weight), in the order in which they were added
 
-    public:
+        mutable std::vector<uint32_t> rowOffsets{0}; ///< CSR row offsets, the entries of node i are in [rowOffsets[i], rowOffsets[i+1])
+        mutable std::vector<uint32_t> columnIndexes; ///< CSR column indexes, sorted inside every row
+        mutable std::vector<double> weights; ///< CSR weights, aligned with the column indexes
+        mutable std::vector<std::tuple<uint32_t, uint32_t, double>> pendingEntries; ///< entries added but not yet merged into the CSR arrays
+        mutable std::unordered_map<uint64_t, size_t> pendingEntryIndexes; ///< position of every pending entry, keyed by entryKey
+        mutable std::vector<uint32_t> predecessorOffsets; ///< transpose row offsets, valid only when predecessorsBuilt is true
+        mutable std::vector<uint32_t> predecessorIndexes; ///< transpose column indexes (predecessors), sorted inside every row
+        mutable std::atomic<bool> hasPendingEntries{false}; ///< true when pendingEntries must be merged before querying the CSR arrays
+        mutable std::atomic<bool> predecessorsBuilt{false}; ///< true when the transpose is up to date with the CSR arrays
+        mutable std::mutex lazyMutex; ///< guards the merge of the pending entries and the construction of the transpose
+        const WeightedEdgeGraph* coreGraph = nullptr; ///< shared read-only core of an overlay graph, nullptr for a standalone graph (not owned)
+        int numberOfCoreNodes = 0; ///< number of nodes of the core, the nodes of the overlay have the indexes after them. nameVector holds only the names after the core
 
-        Matrix<double> adjMatrix; ///< adjacency matrix, public for easy access
-        std::vector<std::tuple<int, int, double> > edgesVector; ///< vector of edges as tuples (node1ID, node2ID, weight)
+        /**
+         * @brief Key of an entry of the adjacency, used to index the pending entries.
+         * @param node1 The source node.
+         * @param node2 The target node.
+         * @return The key of the entry.
+         */
+        static uint64_t entryKey(uint32_t node1, uint32_t node2){return (static_cast<uint64_t>(node1) << 32) | node2;}
+        /**
+         * @brief Find the weight of an entry among the CSR arrays and the pending entries, without merging them.
+         * @param node1 The source node (in range).
+         * @param node2 The target node (in range).
+         * @return A pointer to the weight of the entry, nullptr if the entry is not in the graph.
+         */
+        double* findEntry(int node1, int node2);
+        /**
+         * @brief Set the weight of an entry, adding it to the pending entries if it is not in the graph.
+         * @param node1 The source node (in range).
+         * @param node2 The target node (in range).
+         * @param weight The weight of the entry.
+         */
+        void setEntry(int node1, int node2, double weight);
+        /**
+         * @brief Merge the pending entries into the CSR arrays, if there are any.
+         * @details Sorting the pending entries and merging them row by row costs O(E + P log P), instead of O(E) for every single insertion.
+         */
+        void compact()const;
+        /**
+         * @brief Build the transpose of the CSR arrays (the predecessors of every node), if it is not up to date.
+         */
+        void buildPredecessors()const;
+        /**
+         * @brief Get the position of an entry in the CSR arrays.
+         * @param node1 The source node (in range).
+         * @param node2 The target node (in range).
+         * @return The position of the entry in columnIndexes and weights, -1 if the entry is not in the CSR arrays.
+         * @warning The pending entries are not considered, call compact before.
+         */
+        int64_t entryPosition(int node1, int node2)const;
+        /**
+         * @brief Replace the adjacency with a set of entries and edges.
+         * @param rowMajorEntries The entries (source, target, weight), sorted by source and target and without duplicates.
+         * @param edges The edges of the graph, in the order in which they were added.
+         * @details The CSR arrays are built in one pass, used by the bulk constructors and the copies.
+         */
+        void assignEntries(const std::vector<std::tuple<int, int, double>>& rowMajorEntries, const std::vector<std::tuple<int, int, double>>& edges);
+        /**
+         * @brief Add empty rows to the CSR arrays for the nodes added at the end of the graph.
+         * @param numNewNodes The number of new nodes.
+         */
+        void addEmptyRows(int numNewNodes);
+        /**
+         * @brief Merge the pending entries of the graph and of its core, if there are any.
+         */
+        void compactAll()const{
+            compact();
+            if(coreGraph) coreGraph->compact();
+        }
+        /**
+         * @brief Find the weight of an entry in the core of an overlay graph.
+         * @param node1 The source node (in range).
+         * @param node2 The target node (in range).
+         * @return A pointer to the weight of the entry in the core, nullptr if the graph is not an overlay or the entry is not in the core.
+         */
+        const double* coreEntry(int node1, int node2)const;
+        /**
+         * @brief Get the index of a node by its name, among the nodes of the core and of the overlay.
+         * @param name The name of the node.
+         * @return The index of the node, -1 if the node is not in the graph.
+         */
+        int indexOfName(const std::string& name)const;
+        /**
+         * @brief Get the index of a node by its name, among the nodes of the core and of the overlay.
+         * @param name The name of the node.
+         * @return The index of the node.
+         * @throw std::out_of_range if the node is not in the graph.
+         */
+        int indexOfNameAt(const std::string& name)const;
+        /**
+         * @brief Get the name of a node by its index, from the core or from the overlay.
+         * @param node The index of the node (in range).
+         * @return The name of the node.
+         */
+        const std::string& nameOfNode(int node)const{
+            return (coreGraph && node < numberOfCoreNodes) ? coreGraph->nameVector[node] : nameVector[node - numberOfCoreNodes];
+        }
+        /**
+         * @brief Call a function for every entry of a row, in the order of the columns.
+         * @param row The index of the node (in range).
+         * @param function The function, called with the column index and the weight of the entry.
+         * @details For an overlay the row of the core and the row of the overlay are merged, the entries of the overlay replace the entries of the core with the same column.
+         * @warning compactAll must be called before.
+         */
+        template<typename Function>
+        void forEachEntryOfRow(int row, Function&& function)const{
+            uint32_t position = rowOffsets[row];
+            uint32_t rowEnd = rowOffsets[row+1];
+            if(coreGraph && row < numberOfCoreNodes){
+                // both rows are sorted by column, the core is a standalone graph
+                for(uint32_t corePosition = coreGraph->rowOffsets[row]; corePosition < coreGraph->rowOffsets[row+1]; corePosition++){
+                    uint32_t column = coreGraph->columnIndexes[corePosition];
+                    while(position < rowEnd && columnIndexes[position] < column){
+                        function(columnIndexes[position], weights[position]);
+                        position++;
+                    }
+                    if(position < rowEnd && columnIndexes[position] == column){
+                        function(column, weights[position]);
+                        position++;
+                    } else {
+                        function(column, coreGraph->weights[corePosition]);
+                    }
+                }
+            }
+            for(; position < rowEnd; position++){
+                function(columnIndexes[position], weights[position]);
+            }
+        }
+
+    public:
 
         // constructors and destructors
         /**
@@ -70,9 +212,15 @@ class WeightedEdgeGraph{
          */
         WeightedEdgeGraph(const Matrix<double>& _adjMatrix);
 
+        /**
+         * @brief Copy constructor, copies the nodes and the adjacency of another graph.
+         * @param g2 The graph to copy.
+         */
+        WeightedEdgeGraph(const WeightedEdgeGraph& g2);
+
         /**
          * @brief Destructor for cleaning up the allocated memory.
-         * @details Deallocates the memory used for the node values. Memory handling for adjMatrix is done in the Matrix class.
+         * @details Deallocates the memory used for the node values. The CSR arrays are handled by their vectors.
          */
         ~WeightedEdgeGraph();
 
@@ -98,19 +246,47 @@ class WeightedEdgeGraph{
          * @warning This function doesn't throw exceptions for invalid node names. It just prints an error message in cerror and continues 
          */
         WeightedEdgeGraph* addEdge(std::string node1name, std::string node2name, double weight, bool directed=true);
+        /**
+         * @brief Function to add a list of edges to the graph using node names, in one pass.
+         * @param edges The edges to add, as tuples (source name, target name, weight), for example the edges read by edgesFileToEdgesListAndNodesByName.
+         * @param directed Whether the edges are directed (default is true).
+         * @return A pointer to the updated graph.
+         * @details The result is the same as calling addEdge(node1name, node2name, weight, directed) for every edge in order: a repeated edge updates the weight of the entry but it is not added again to the edges vector.
+         * @details The names are resolved once, the directed edges are deduplicated by sorting their indexes and merged into the CSR arrays at once, instead of being inserted one by one.
+         * @throw std::invalid_argument if one of the nodes is not in the graph, no edge is added in that case.
+         */
+        WeightedEdgeGraph* addEdges(const std::vector<std::tuple<std::string, std::string, double>>& edges, bool directed=true);
+
+        /**
+         * @brief Function to update the weights of a set of edges of the graph.
+         * @param newEdgeWeights The edges to update, as tuples (source index, target index, new weight).
+         * @param directed Whether the edges are directed (default is true). If false, the reverse edges are updated as well.
+         * @return The previous weights of the updated entries of the adjacency matrix, as tuples (source index, target index, previous weight), in the order in which they were updated.
+         * @details Edges that are not in the graph are added. The edges vector is refreshed once for the whole set of updates.
+         * @details The returned previous weights can be passed to the propagation models (updateEdgeWeights) to update their operators incrementally.
+         * @note An edge updated to a weight of 0 is kept in the adjacency list.
+         * @throw std::invalid_argument if one of the nodes is out of range.
+         */
+        std::vector<std::tuple<int, int, double>> updateEdgeWeights(const std::vector<std::tuple<int, int, double>>& newEdgeWeights, bool directed=true);
+        /**
+         * @brief Function to update the weights of a set of edges of the graph using node names.
+         * @param newEdgeWeights The edges to update, as tuples (source name, target name, new weight).
+         * @param directed Whether the edges are directed (default is true). If false, the reverse edges are updated as well.
+         * @return The previous weights of the updated entries of the adjacency matrix, as tuples (source index, target index, previous weight), in the order in which they were updated.
+         * @throw std::invalid_argument if one of the nodes is not in the graph.
+         */
+        std::vector<std::tuple<int, int, double>> updateEdgeWeights(const std::vector<std::tuple<std::string, std::string, double>>& newEdgeWeights, bool directed=true);
 
         /**
          * @brief Function to get the weight of an edge between two nodes.
          * @param node1 The index of the first node.
          * @param node2 The index of the second node.
-         * @return The weight of the edge between the specified nodes.
+         * @return The weight of the edge between the specified nodes, 0 if there is no edge.
          * @throw std::out_of_range if one of the nodes is out of range (index). 
+         * @throw std::invalid_argument if one of the nodes is greater or equal than the number of nodes.
+         * @details The weight is found with a binary search in the CSR row of the first node.
          */
-        double getEdgeWeight(int node1, int node2)const{
-            if(node1 >= 0 && node2 >= 0)
-                return adjMatrix.getValue(node1,node2);
-            else throw std::out_of_range("WeightedEdgeGraph::getEdgeWeight: one of the nodes is out of range(index)");
-        }
+        double getEdgeWeight(int node1, int node2)const;
 
         /**
          * @brief Function to control if an edge exists between two nodes.
@@ -118,12 +294,12 @@ class WeightedEdgeGraph{
          * @param node2 The index of the second node.
          * @return True if the edge exists, false otherwise.
          * @throw std::out_of_range if one of the nodes is out of range (index).
-         * @details This function checks if an edge exists between the specified nodes by checking the value in the adjacency matrix.
+         * @details This function checks if an edge exists between the specified nodes by checking the weight of the entry in the adjacency.
          * @details If the value is greater than 0, it means the edge exists.
          */
         bool hasEdge(int node1, int node2)const{
             if(node1 >= 0 && node2 >= 0)
-                return adjMatrix.getValue(node1,node2) > 0;
+                return getEdgeWeight(node1,node2) > 0;
             else throw std::out_of_range("WeightedEdgeGraph::hasEdge: one of the nodes is out of range(index)");
         }
 
@@ -136,13 +312,7 @@ class WeightedEdgeGraph{
          * @details This function is used to get the index of a node by its name. It uses the nodeToIndex map to find the index.
          */
         int getIndexFromName(std::string name)const {
-            try {
-                return nodeToIndex.at(name);
-            }
-            catch (const std::out_of_range&) {
-                return -1;
-                // TODO: Deal with the missing element.
-            }
+            return indexOfName(name);
         }
 
         /**
@@ -154,7 +324,7 @@ class WeightedEdgeGraph{
          */
         double getEdgeWeight(std::string node1, std::string node2)const{
             if(getIndexFromName(node1) >= 0 && getIndexFromName(node2) >= 0)
-                return adjMatrix.getValue(nodeToIndex.at(node1),nodeToIndex.at(node2));
+                return getEdgeWeight(indexOfName(node1),indexOfName(node2));
             else throw std::out_of_range("WeightedEdgeGraph::getEdgeWeight: one of the nodes is out of range(string)");
         }
 
@@ -192,6 +362,13 @@ class WeightedEdgeGraph{
          * @throw std::invalid_argument if the some of the node names already exist in the graph.
         */
         WeightedEdgeGraph* addNodes(const std::vector<std::string>& names, const std::vector<double>& values=std::vector<double>());
+        /**
+         * @brief Function to reserve the memory of the node arrays for a number of nodes.
+         * @param numNodes The total number of nodes expected in the graph.
+         * @details The nodes added later up to numNodes do not reallocate the node values, the names and the CSR row offsets.
+         * @throw std::invalid_argument if the number of nodes is negative.
+         */
+        void reserveNodes(int numNodes);
 
         /**
          * @brief Function to add multiple nodes to the graph and copy the graph into a new graph in dynamic memory.
@@ -214,6 +391,28 @@ class WeightedEdgeGraph{
          * @throw std::invalid_argument if the some of the node names already exist in the graph.
         */
         WeightedEdgeGraph* addNodesAndCopyNew(const std::vector<std::string>& names, const std::vector<double>& values=std::vector<double>());
+        /**
+         * @brief Function to create an overlay of the graph in dynamic memory, with multiple nodes added.
+         * @param names A vector of strings representing the names of the new nodes.
+         * @param values A vector of doubles representing the values of the new nodes (default is an empty vector).
+         * @return A pointer to the new graph, that has the same nodes and edges of addNodesAndCopyNew(names, values).
+         * @details The new graph uses this graph as its read-only core instead of copying it: only the new nodes, the node values and the edges added later to the new graph are stored in it.
+         * @details Used for the augmented graphs, where many types share the same core graph and add only their virtual nodes and the inter-type edges.
+         * @details If this graph is an overlay, the new graph is an overlay of the same core, with a copy of the nodes and edges of this overlay.
+         * @warning The core must not be modified or deleted while the overlays exist.
+         * @throw std::invalid_argument if the some of the node names already exist in the graph.
+         */
+        WeightedEdgeGraph* addNodesAndOverlayNew(const std::vector<std::string>& names, const std::vector<double>& values=std::vector<double>())const;
+        /**
+         * @brief Function to know if the graph is an overlay of a core graph(immutable).
+         * @return true if the graph is an overlay.
+         */
+        bool isOverlay()const{return coreGraph != nullptr;}
+        /**
+         * @brief Function to get the core graph of an overlay(immutable).
+         * @return A pointer to the core graph, nullptr if the graph is not an overlay.
+         */
+        const WeightedEdgeGraph* getCoreGraph()const{return coreGraph;}
 
 
         // setters
@@ -243,7 +442,7 @@ class WeightedEdgeGraph{
          * @param nodenameSet The new name for the node.
          * @return A pointer to the updated graph.
          * @details Sets the name of the specified node to the given new name.
-         * @throw std::invalid_argument if the node name is not found in the graph.
+         * @throw std::invalid_argument if the node name is not found in the graph, or if the node is in the core of an overlay.
         */
         WeightedEdgeGraph* setNodeName(std::string nodenameTarget, std::string nodenameSet);
         /**
@@ -255,6 +454,7 @@ class WeightedEdgeGraph{
          * @details If provided with one parameter, controls the vector size and sets the node names if they are of the same size.
          * @details If provided with two parameters, changes the nodes in nodenameTargets with the values in nodenameSets.
          * @throw std::invalid_argument if the node names are not found in the graph or if the sizes of the vectors are not equal.
+         * @throw std::invalid_argument if all the nodes are renamed in an overlay, the names of the core are read-only.
         */
         WeightedEdgeGraph* setNodesNames(const std::vector<std::string>& nodenameSets, const std::vector<std::string>& nodenameTargets = std::vector<std::string>());
 
@@ -269,7 +469,7 @@ class WeightedEdgeGraph{
          */
         std::string getNodeName(int node)const{
             if(node >= 0 && node < numberOfNodes)
-                return nameVector[node];
+                return nameOfNode(node);
             else throw std::invalid_argument("[ERROR] WeightedEdgeGraph::getNodeName: node name cannot be retrieved: node not in the list (as index)");
         }
         /**
@@ -303,12 +503,25 @@ class WeightedEdgeGraph{
          */
         std::vector<double> getNodeValues(const std::vector<std::string>& node=std::vector<std::string>())const;
 
+        /**
+         * @brief Function to build the dense adjacency matrix of the graph(immutable).
+         * @return The adjacency matrix (numNodes x numNodes), the entry (i,j) is the weight of the edge from i to j.
+         * @details The matrix is built from the CSR arrays every time it is requested and it is not kept by the graph, so it should be requested only by the dense engines.
+         */
+        Matrix<double> getAdjacencyMatrix()const;
+        /**
+         * @brief Function to get the sum of the absolute weights of the outgoing edges of every node(immutable).
+         * @return A vector with the sum of the absolute weights of the row of every node, used to normalize the adjacency.
+         * @details Computed from the CSR arrays in O(E), instead of querying all the numNodes x numNodes weights.
+         */
+        std::vector<double> getAbsoluteOutWeights()const;
+
         //optimization functions to make new Matrix, SUGGESTED not using these functions
         /**
          * @brief Function to create a new adjacency matrix from the current graph.
          * @return A new adjacency matrix representing the graph.
-         * @details This function creates a new adjacency matrix from the current graph. It is suggested not to use this function as it may cause memory leaks.
-         * @warning This function is not implemented completely and will probably be removed in the future.
+         * @details Same as getAdjacencyMatrix.
+         * @warning This function will probably be removed in the future, use getAdjacencyMatrix.
          */
         Matrix<double> makeMatrix();
 
@@ -327,8 +540,9 @@ class WeightedEdgeGraph{
         /**
          * @brief Function to get the names of the nodes in the graph(immutable).
          * @return A vector of strings representing the names of the nodes.
+         * @details For an overlay the names of the core are followed by the names of the overlay.
          */
-        std::vector<std::string> getNodeNames()const{ return nameVector;}
+        std::vector<std::string> getNodeNames()const;
         /**
          * @brief Function to get the out degree of a certain node in the graph(immutable).
          * @param node The index of the node.
@@ -366,6 +580,7 @@ class WeightedEdgeGraph{
          * @param node The index of the node.
          * @return A vector of integers representing the predecessors of the specified node.
          * @details The predecessors of a node are the nodes that have edges directed towards the specified node (entering neighbors).
+         * @details The predecessors are read from the transpose of the CSR arrays, built at the first request, so they are sorted by index.
          * @throw std::invalid_argument if the node index is out of range.(-1 or greater than the number of nodes)
          */
         std::vector<int> getPredecessors(int node)const;
@@ -376,8 +591,7 @@ class WeightedEdgeGraph{
          * @return A vector of integers representing the successors of the specified node.
          * @details The successors of a node are the nodes that have edges directed away from the specified node (exiting neighbors).
          * @throw std::invalid_argument if the node index is out of range.(-1 or greater than the number of nodes)
-         * @details This function uses the adjacency list to get the successors of the specified node.
-         * @see getAdjList(int node)
+         * @details The successors are read from the CSR row of the node, so they are sorted by index.
          */
         std::vector<int> getSuccessors(int node)const;
         /**
@@ -516,8 +730,10 @@ class WeightedEdgeGraph{
 
         /**
          * @brief Function to get the edges of the graph as a vector of tuples.
-         * @return A vector of tuples representing the edges of the graph.
+         * @return A vector of tuples representing the edges of the graph, in the order in which they were added.
          * @details Each tuple contains the index of the first node, the index of the second node, and the weight of the edge.
+         * @details An undirected edge is a single tuple, while both its entries are in the adjacency.
+         * @details For an overlay the edges of the core, with the weights changed by the overlay, are followed by the edges added to the overlay.
          */
         std::vector<std::tuple<int, int, double>> getEdgesVector()const;
 
@@ -526,21 +742,23 @@ class WeightedEdgeGraph{
          * @brief Operator to assign a new graph to the current graph.
          * @param g2 The graph to assign.
          * @return A reference to the current graph.
-         * @details This operator assigns a new graph to the current graph. It copies the adjacency matrix, node values, and adjacency list from the new graph.
+         * @details This operator assigns a new graph to the current graph. It copies the adjacency, the edges, the node names and the node values from the new graph.
+         * @details If g2 is an overlay, the current graph becomes an overlay of the same core.
          */
         WeightedEdgeGraph& operator=(const WeightedEdgeGraph& g2);
         /**
          * @brief Function to assign a new graph to the current graph.
          * @param g2 The graph to assign.
-         * @details This function assigns a new graph to the current graph. It copies the adjacency matrix, node values, and adjacency list from the new graph.
-         * @warning This function is not implemented yet.
+         * @details This function assigns a new graph to the current graph. It copies the adjacency, the edges, the node names and the node values from the new graph.
+         * @details If g2 is an overlay, the current graph becomes an overlay of the same core.
          */
         void assign(const WeightedEdgeGraph& g2);
         /**
          * @brief Function to copy the current graph into a new graph in dynamic memory.
          * @return A pointer to the new graph.
-         * @details This function copies the current graph into a new graph in dynamic memory. It uses the copy constructor to create the new graph.
-         * @warning This function is not implemented yet.
+         * @details This function copies the current graph into a new graph in dynamic memory.
+         * @details The edges of the new graph are the entries with non-zero weight in row-major order, followed by the zero weight edges of the current graph.
+         * @details The copy of an overlay is a standalone graph, that does not depend on the core.
          */
         WeightedEdgeGraph* copyNew()const;
 
@@ -562,9 +780,9 @@ class WeightedEdgeGraph{
         /**
          * @brief Function to get the node to index map(immutable).
          * @return A map of node names to indexes.
-         * @details This function just returns the private member nodeToIndex.
+         * @details This function just returns the private member nodeToIndex, merged with the map of the core for an overlay.
          */
-        std::map<std::string, int> getNodeToIndexMap()const {return nodeToIndex;}
+        std::map<std::string, int> getNodeToIndexMap()const;
         /**
          * @brief Function to print the graph
          * @details This function prints the graph to the standard output. It uses the operator<< to print the graph.
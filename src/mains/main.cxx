@@ -28,6 +28,7 @@
 #include "data_structures/WeightedEdgeGraph.hxx"
 #include "utils/utilities.hxx"
 #include "utils/mathUtilities.hxx"
+#include "utils/NameInterner.hxx"
 #include "CustomFunctions.hxx"
 #include "logging/Logger.hxx"
 
@@ -492,14 +493,10 @@ int main(int argc, char** argv ) {
 
     //add the edges to the graphs
     if(vm.count("fUniqueGraph")){
-        for(auto edge = namesAndEdges[0].second.cbegin() ; edge != namesAndEdges[0].second.cend(); edge++ ){
-            graphs[0]->addEdge(std::get<0> (*edge), std::get<1> (*edge) ,std::get<2>(*edge) ,!undirected);
-        }
+        graphs[0]->addEdges(namesAndEdges[0].second, !undirected);
     } else if (vm.count("graphsFilesFolder")) {
         for(uint i = 0; i < types.size(); i++){
-            for(auto edge = namesAndEdges[i].second.cbegin() ; edge != namesAndEdges[i].second.cend(); edge++ ){
-                graphs[i]->addEdge(std::get<0> (*edge), std::get<1> (*edge) ,std::get<2>(*edge) ,!undirected);
-            }
+            graphs[i]->addEdges(namesAndEdges[i].second, !undirected);
         }
     }
 
@@ -718,7 +715,7 @@ int main(int argc, char** argv ) {
     //         break;
     //     }
     // }
-    // typeComputations[index]->getAugmentedGraph()->adjMatrix.printMatrix();
+    // typeComputations[index]->getAugmentedGraph()->getAdjacencyMatrix().printMatrix();
     // logger<< "[DEBUG] input vector for type \"2\":"<<std::endl;
     // std::vector<double> input = typeComputations[index]->getInputAugmented();
     // for(int i = 0; i < SizeToInt(input.size());i++){
@@ -738,6 +735,21 @@ int main(int argc, char** argv ) {
 
     // EndTypetype -> (sourceTypeType -> value)
 
+    // the types and their interaction times are resolved once, the exchange of the virtual nodes in the iterations only uses interned ids
+    std::vector<NameId> typeIds;
+    for(const std::string& type : typesFiltered){
+        typeIds.push_back(NameInterner::getInstance().intern(type));
+    }
+    std::vector<std::vector<const std::unordered_set<int>*>> typesInteractionTimes(typesFiltered.size(), std::vector<const std::unordered_set<int>*>(typesFiltered.size(), nullptr));
+    for (uint i = 0; i < typesFiltered.size(); i++) {
+        for(uint j = 0; j < typesFiltered.size(); j++){
+            auto interactionTimes = interactionBetweenTypesMap.find(std::make_pair(typesFiltered[i], typesFiltered[j]));
+            if(interactionTimes != interactionBetweenTypesMap.end()){
+                typesInteractionTimes[i][j] = &interactionTimes->second;
+            }
+        }
+    }
+
     for(uint iterationInterType = 0; iterationInterType < intertypeIterations; iterationInterType++){
         for(uint iterationIntraType = 0; iterationIntraType < intratypeIterations; iterationIntraType++){
             #pragma omp parallel for
@@ -821,15 +833,12 @@ int main(int argc, char** argv ) {
 
         for (uint i = 0; i < typesFiltered.size(); i++) {
             for(uint j = 0; j < typesFiltered.size(); j++){
-                std::pair<std::string,std::string> keyTypes = std::make_pair(typesFiltered[i], typesFiltered[j]);
-                if(interactionBetweenTypesMap.contains(keyTypes)){
-                    std::unordered_set<int> interactionTimes = interactionBetweenTypesMap[keyTypes];
-                    if(interactionTimes.contains(iterationInterType)){
-                        if(i==j){
-                            if(sameTypeCommunication) typeComputations[i]->setInputVinForType(typesFiltered[j], typeComputations[j]->getVirtualOutputForType(typesFiltered[i]));
-                        } else {
-                            typeComputations[i]->setInputVinForType(typesFiltered[j], typeComputations[j]->getVirtualOutputForType(typesFiltered[i]));
-                        }
+                const std::unordered_set<int>* interactionTimes = typesInteractionTimes[i][j];
+                if(interactionTimes != nullptr && interactionTimes->contains(iterationInterType)){
+                    if(i==j){
+                        if(sameTypeCommunication) typeComputations[i]->setInputVinForType(typeIds[j], typeComputations[j]->getVirtualOutputForType(typeIds[i]));
+                    } else {
+                        typeComputations[i]->setInputVinForType(typeIds[j], typeComputations[j]->getVirtualOutputForType(typeIds[i]));
                     }
                 }
             }
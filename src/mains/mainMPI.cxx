@@ -17,22 +17,39 @@
 #include <map>
 #include <sys/types.h>
 #include <tuple>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <set>
 #include "computation/Computation.hxx"
 #include "computation/PropagationModel.hxx"
 #include "computation/PropagationModelOriginal.hxx"
 #include "computation/PropagationModelNeighbors.hxx"
 #include "computation/PropagationModelCustom.hxx"
 #include "computation/ConservationModel.hxx"
+#include "computation/ConservationModelPlugin.hxx"
 #include "computation/DissipationModel.hxx"
 #include "computation/DissipationModelPow.hxx"
 #include "computation/DissipationModelRandom.hxx"
 #include "computation/DissipationModelScaled.hxx"
+#include "computation/DissipationModelPlugin.hxx"
+#include "computation/ModelPlugin.hxx"
+#include "computation/PropagationModelPlugin.hxx"
+#include "computation/ScaleSchedule.hxx"
+#include "computation/SensitivityParameter.hxx"
+#include "data_structures/ErrorMatrix.hxx"
+#include "data_structures/Expression.hxx"
+#include "data_structures/ReplicateStatistics.hxx"
 #include "data_structures/WeightedEdgeGraph.hxx"
 #include "utils/utilities.hxx"
 #include "utils/mathUtilities.hxx"
+#include "utils/NameInterner.hxx"
 #include "CustomFunctions.hxx"
 #include "logging/Logger.hxx"
 #include "checkpoint/Checkpoint.hxx"
+#include "checkpoint/TrajectoryCache.hxx"
 #include "utils/boost_ignore_numbers_parser.hxx"
 
 namespace po = boost::program_options;///< namespace for program options
@@ -43,12 +60,14 @@ int main(int argc, char** argv) {
     bool sameTypeCommunication=false; ///< boolean variable to indicate if the same type communication is used
     bool saturation=false; ///< boolean variable to indicate if saturation is used
     bool customSaturation=false; ///< boolean variable to indicate if custom saturation is used
+    bool tanhSaturation=false; ///< boolean variable to indicate if the scaled hyperbolic tangent is used as saturation function
     bool conservateInitialNorm=false; ///< boolean variable to indicate if the initial norm is conserved
     bool undirected = false; ///< boolean variable to indicate if the single graphs associated to every type are undirected
     bool undirectedTypeEdges = false; ///< boolean variable to indicate if the edges between types are undirected
     bool resetVirtualOutputs = false; ///< boolean variable to indicate if the virtual outputs are reset at each iteration
     bool resumeCheckpoint = false; ///< boolean variable to indicate if the computation should resume from the checkpoint
     bool saveAugmentedNetworks = false; ///< boolean variable to indicate if the augmented networks should be saved
+    bool sensitivities = false; ///< boolean variable to indicate if the derivatives of the outputs with respect to the parameters of the nodes are propagated
     std::string logMode=""; ///< string variable to indicate the logging mode
     bool verbose = false; ///< boolean variable to indicate if verbose mode is used
     bool treatWarningAsError = false; ///< boolean variable to indicate if warnings should be treated as errors
@@ -56,6 +75,8 @@ int main(int argc, char** argv) {
     std::string virtualNodesGranularity = "type"; ///< string variable to indicate the virtual nodes granularity
     std::string performanceFilename = ""; ///< string variable to indicate the performance filename where the performance times are saved
     std::string outputFormat = "singleIteration"; ///< string variable to indicate the output format
+    uint64_t randomSeed = 777; ///< seed of the counter-based random generator used by the random dissipation and conservation models
+    int candidateGroups = 1; ///< number of groups of processes computing different parameter candidates at the same time
     po::options_description desc("Allowed options"); ///< options description
     desc.add_options()
         ("help", "() print help section")//<initialPerturbationPerType>.tsv [<subtypes>.txt] [<typesInteraction>.tsv]\nFILE STRUCTURE SCHEMA:\ngraph.tsv\nstart end weight\n<gene1> <gene2>  <0.something>\n...\n\n\ninitialPerturbationPerType.tsv\n type1 type2 ... typeN\ngene1 <lfc_type1:gene1> <lfc_type2:gene1> ... <lfc_typeN:gene1>\ngene1 <lfc_type1:gene2> <lfc_type2:gene2> ... <lfc_typeN:gene2>\n...\n\n\ntypesInteraction.tsv\nstartType:geneLigand endType:geneReceptor weight\n<type1:geneLigand> <type2:genereceptor>  <0.something>\n...\n\n\nsubtypes.txt\ntype1\ntype3\n...")
@@ -63,6 +84,9 @@ int main(int argc, char** argv) {
         ("fInitialPerturbationPerType", po::value<std::string>(), "(string) initialPerturbationPerType matrix filename, for an example see in data data/testdata/testGraph/initialValues-general.tsv")
         ("subtypes", po::value<std::string>(), "subtypes filename, for an example see in data, see data/testdata/testGraph/subcelltypes.txt")
         ("initialPerturbationPerTypeFolder", po::value<std::string>(), "(string) initialPerturbationPerType folder, for an example see in data data/testdata/testGraph/initialValues")
+        ("scenarioFolder", po::value<std::string>(), "(string) folder containing a subfolder for every scenario, each structured as the initialPerturbationPerTypeFolder. The graphs, the type interactions and the models are set up once and the scenarios are computed one after the other with the same model parameters unless scenarioParametersFolder is set (they are not batched in the computation or in the messages between the processes), the output of every scenario is saved in outputFolder/<scenario name>. NOTE: cannot be used with fInitialPerturbationPerType, initialPerturbationPerTypeFolder or resumeCheckpoint")
+        ("scenarioParametersFolder", po::value<std::string>(), "(string) folder containing a subfolder for every scenario of scenarioFolder (with the same name), each with the optional subfolders dissipationParameters, conservationParameters and propagationParameters structured as the corresponding ModelParameterFolder options. The scaling functions of every scenario are read and compiled once before the runs and replace the scaling functions of the models when the scenario is computed, every scenario must contain the same parameter folders. The parameters cannot be in the scenario subfolders since the initial perturbations are read from all the files in them. Only supported with 'custom' dissipation and conservation and 'customScaling', 'customScalingNeighbors' and 'customPropagation' propagation. NOTE: requires scenarioFolder, cannot be used with parameterSweepFolder")
+        ("parameterSweepFolder", po::value<std::string>(), "(string) folder containing a subfolder for every parameter candidate, each with the optional subfolders dissipationParameters, conservationParameters and propagationParameters structured as the corresponding ModelParameterFolder options. The graphs, the type interactions and the models are set up once, the scaling functions of all the candidates are read and compiled once before the runs and only the scaling functions of the models are replaced for every candidate, see also candidateGroups. The output of every candidate is saved in outputFolder/<candidate name> (outputFolder/<candidate name>/<scenario name> with scenarioFolder). Only supported with 'custom' dissipation and conservation and 'customScaling', 'customScalingNeighbors' and 'customPropagation' propagation. NOTE: cannot be used with resumeCheckpoint")
         ("typeInteractionFolder", po::value<std::string>(), "(string) directory for the type interactions, for an example see in data data/testdata/testHeterogeneousGraph/interactions")
         ("nodeDescriptionFile", po::value<std::string>(), "(string) node description file, used to generate the output description in the case of common graph between types, if not specified no names are used. For an example see in data resources/graphs/metapathwayNew/nodes.tsv")
         ("nodeDescriptionFolder", po::value<std::string>(), "(string) nodes folder, where the files containing the description/nodes for all the graphs are contained, used to read the graph nodes, if not specified the graphs will be built with the edges files(could not contain some isolated nodes) for an example see the folder structure in data/testdata/testHeterogeneousTemporalGraph/nodesDescriptionDifferentStructure")
@@ -71,19 +95,26 @@ int main(int argc, char** argv) {
         ("intertypeIterations",po::value<int>(),"(positive integer) number of iterations for intertype communication")
         ("intratypeIterations",po::value<int>(),"(positive integer) number of iterations for intratype communication")
         ("timestep",po::value<double>(),"timestep to use for the iteration, the final time is iterationIntracell*iterationIntercell*timestep")
-        ("dissipationModel",po::value<std::string>(),"(string) the dissipation model for the computation, available models are: 'none (default)','power','random','periodic','scaled' and 'custom'")
+        ("dissipationModel",po::value<std::string>(),"(string) the dissipation model for the computation, available models are: 'none (default)','power','random','periodic','scaled', 'custom' and 'plugin' (implemented by the plugin in modelPlugin)")
         ("dissipationModelParameters",po::value<std::vector<double>>()->multitoken(),"(string) the parameters for the dissipation model, for the power dissipation indicate the base, for the random dissipation indicate the min and max value, for the periodic dissipation indicate the period")
         ("dissipationModelParameterFolder", po::value<std::string>(),"(string) the folder where the parameters for the dissipation model are contained. Only supported with 'custom' dissipation. Each type can have a parameter file as a mapping of node->parameter(or parameters), if a file is missing for a type, than the parameters for that type will be 0, same can be said about nodes with no mapping. if not specified, the default parameters are used or the parameters in dissipationModelParameters parameter are used")
+        ("dissipationModelExpression", po::value<std::string>(),"(string) expression of the time t used as the scaling function instead of the one defined in src/CustomFunctions.cxx, the parameters passed with dissipationModelParameters or dissipationModelParameterFolder are bound to p[0], p[1], ... Only supported with 'custom' dissipation. Example: \"t <= 5 ? p[0] : (t <= 6 ? p[1] : p[2])\"")
         ("graphsFilesFolder",po::value<std::string>(),"(string) graphs (pathways or other types of graphs) file folder, for an example see in data data/testdata/testHeterogeneousGraph/graphsDifferentStructure")
-        ("conservationModel",po::value<std::string>(),"(string) the conservation model used for the computation, available models are: 'none (default)','scaled','random' and 'custom' ")
+        ("conservationModel",po::value<std::string>(),"(string) the conservation model used for the computation, available models are: 'none (default)','scaled','random', 'custom' and 'plugin' (implemented by the plugin in modelPlugin) ")
         ("conservationModelParameters", po::value<std::vector<double>>()->multitoken(),"(vector<double>) the parameters for the dissipation model, for the scaled parameter the constant used to scale the conservation final results, in the case of random the upper and lower limit (between 0 and 1)")
         ("conservationModelParameterFolder", po::value<std::string>(),"(string) the folder where the parameters for the conservation model are contained. Only supported with 'custom' conservation. each type can have a parameter file as a mapping of node->parameter(or parameters), if a file is missing for a type, than the parameters for that type will be 0, same can be said about nodes with no mapping. if not specified, the default parameters are used or the parameters in conservationModelParameters parameter are used")
-        ("propagationModel",po::value<std::string>(),"(string) the propagation model used for the computation, available models are: 'default(pseudoinverse creation)','scaled (pseudoinverse * scale parameter)', neighbors(propagate the values only on neighbors at every iteration and scale parameter) and 'customScaling' (pseudoinverse*scalingFunction(parameters)), 'customScalingNeighbors' (neighbors propagation and scalingFunction(parameters)), 'customPropagation' (custom scaling function and custom propagation function defined in src/PropagationModelCustom) ")
+        ("conservationModelExpression", po::value<std::string>(),"(string) expression of the time t used as the scaling function instead of the one defined in src/CustomFunctions.cxx, the parameters passed with conservationModelParameters or conservationModelParameterFolder are bound to p[0], p[1], ... Only supported with 'custom' conservation. Example: \"t <= 5 ? p[0] : (t <= 6 ? p[1] : p[2])\"")
+        ("propagationModel",po::value<std::string>(),"(string) the propagation model used for the computation, available models are: 'default(pseudoinverse creation)','scaled (pseudoinverse * scale parameter)', neighbors(propagate the values only on neighbors at every iteration and scale parameter) and 'customScaling' (pseudoinverse*scalingFunction(parameters)), 'customScalingNeighbors' (neighbors propagation and scalingFunction(parameters)), 'customPropagation' (custom scaling function and custom propagation function defined in src/PropagationModelCustom), 'plugin' (implemented by the plugin in modelPlugin) ")
         ("propagationModelParameters", po::value<std::vector<double>>()->multitoken(),"(vector<double>) the parameters for the propagation model, for the scaled parameter the constant used to scale the conservation final results")
         ("propagationModelParameterFolder", po::value<std::string>(),"(string) the folder where the parameters for the propagation model are contained, each type can have a parameter file as a mapping of node->parameter(or parameters), if a file is missing for a type, than the parameters for that type will be 0, same can be said about nodes with no mapping. if not specified, the default parameters are used or the parameters in propagationModelParameters parameter are used")
+        ("propagationModelExpression", po::value<std::string>(),"(string) expression of the time t used as the scaling function instead of the one defined in src/CustomFunctions.cxx, the parameters passed with propagationModelParameters or propagationModelParameterFolder are bound to p[0], p[1], ... Only supported with 'customScaling', 'customScalingNeighbors' and 'customPropagation' propagation. Example: \"t <= 5 ? p[0] : (t <= 6 ? p[1] : p[2])\"")
+        ("modelPlugin",po::value<std::string>(),"(string) path of a shared object implementing custom models (see src/computation/ModelPluginABI.hxx and the example in src/plugins), used by the models set to 'plugin'. The parameters of the models are passed to the plugin")
+        ("randomSeed",po::value<uint64_t>(&randomSeed),"(non-negative integer) seed for the random dissipation and conservation models, the results are reproducible for the same seed independently of the number of processes and threads, default to 777")
         ("saturation",po::bool_switch(&saturation),"use saturation of values, default to 1, if another value is needed, use the saturationTerm")
         ("saturationTerm",po::value<double>(),"defines the limits of the saturation [-saturationTerm,saturationTerm], default to 1, if saturation is not set, this option is not used, if specified the program will stop the execution")
         ("customSaturationFunction",po::bool_switch(&customSaturation),"use custom saturation function defined in src/CustomFunctions.cxx, if this option is not set, the saturation function will be the default one")
+        ("tanhSaturation",po::bool_switch(&tanhSaturation),"use the scaled hyperbolic tangent saturationTerm*tanh(value/saturationTerm) as saturation function instead of clamping the values")
+        ("saturationExpression",po::value<std::string>(),"(string) expression of the value x and the saturation s used as the saturation function, applied to the values outside [-s,s]. Example: \"s * tanh(x / s)\"")
         ("conservateInitialNorm",po::bool_switch(&conservateInitialNorm), "conservate the initial euclidean norm of the perturbation values, that is ||Pn|| <= ||Initial||, default to false")
         ("undirectedEdges",po::bool_switch(&undirected), "edges in the graphs are undirected")
         ("undirectedTypeEdges",po::bool_switch(&undirectedTypeEdges), "edges between types are undirected")
@@ -96,8 +127,16 @@ int main(int argc, char** argv) {
         ("treatWarningAsError",po::bool_switch(&treatWarningAsError), "treat warnings as errors, if set, the program will throw an exception if a warning is encountered")
         ("savePerformance",po::value<std::string>(&performanceFilename), "(string) output performance (running time, number of total nodes, number of communities, number of total edges) to the defined file, if nothing is specified the performance are not saved")
         ("resumeCheckpoint",po::bool_switch(&resumeCheckpoint), "resume the computation from the last checkpoint, if the checkpoint is not found, the computation will start from the beginning")
-        ("outputFormat",po::value<std::string>(), "(string) output format for the output files, available options are: 'singleIteration' (default) and 'iterationMatrix'. If one is chosen, the other won't generate the corrispondent output files")
+        ("outputFormat",po::value<std::string>(), "(string) output format for the output files, available options are: 'singleIteration' (default), 'iterationMatrix', 'errorMatrix' and 'replicateStatistics'. If one is chosen, the other won't generate the corrispondent output files. 'errorMatrix' saves only the error matrices against the referenceTimeSeriesFolder, without the trajectories. 'replicateStatistics' saves only the statistics over the replicates")
+        ("referenceTimeSeriesFolder",po::value<std::string>(), "(string) folder containing the reference time series of the types (<type>.tsv, with the header nodeNames followed by the times, as the iteration matrices). The errors (simulation - reference) of the nodes and times in both are accumulated during the computation and saved in outputFolder/errorMatrices/<type>.tsv, the RMSE of every type and of all the types in outputFolder/errorMatrices/rmse.tsv. With scenarioFolder, the subfolder <scenario name> is used for a scenario if it exists")
+        ("fittingWindows",po::value<std::string>(), "(string) comma separated times splitting the simulation into windows that are fitted one after the other with the candidates of parameterSweepFolder. Every candidate of a window is computed from the state at the start of the window (kept in memory) to the end of the window, the candidate with the lowest RMSE in the window is selected and its state at the end of the window is the start of the next window, so the times before a window are never computed again. The errors of every candidate are saved in outputFolder/<candidate name>/window<index>/errorMatrices and the selected candidates in outputFolder/fittingWindows.tsv. The times are rounded up to the start of an intertype iteration. NOTE: requires parameterSweepFolder, referenceTimeSeriesFolder and outputFormat errorMatrix, cannot be used with scenarioFolder and resumeCheckpoint")
+        ("candidateGroups",po::value<int>(&candidateGroups), "(positive integer) number of groups of processes that compute different candidates of parameterSweepFolder at the same time, default to 1. The processes are split into groups of consecutive ranks, every group partitions the types as the processes without groups and computes the candidates whose index (in the sorted candidates) modulo candidateGroups is the index of the group. With fittingWindows the candidate of a window is selected over all the groups. NOTE: requires parameterSweepFolder, the number of processes must be a multiple of candidateGroups and candidateGroups cannot be greater than the number of candidates")
+        ("trajectoryCache",po::value<int>(), "(int) maximum number of states kept in memory to restart the candidates of parameterSweepFolder. The states of all the types at the start of the intertype iterations where the scaling values of the models change are saved with a key computed from the scaling values used before them, a candidate with the same scaling values before one of these iterations starts from the latest saved state instead of the initial perturbation. NOTE: requires parameterSweepFolder and outputFormat errorMatrix, cannot be used with fittingWindows")
+        ("replicates",po::value<int>(), "(positive integer) number of replicates of a simulation with random dissipation or conservation, computed one after the other with the seeds randomSeed, randomSeed+1, ... (every replicate is a full run, they are not batched as ensemble columns). The replicates share the setup and only the statistics over the replicates of every node at every time are kept, the mean, the variance and the quantiles of replicateQuantiles are saved in outputFolder/replicateStatistics/<type>_mean.tsv, <type>_variance.tsv and <type>_q<probability>.tsv (same layout as the iteration matrices). NOTE: requires outputFormat replicateStatistics and dissipationModel or conservationModel random, cannot be used with scenarioFolder, parameterSweepFolder, referenceTimeSeriesFolder, sensitivities and resumeCheckpoint")
+        ("replicateQuantiles",po::value<std::vector<double>>()->multitoken(), "(vector<double>) probabilities of the quantiles estimated over the replicates with the P-square algorithm, default to 0.05 0.5 0.95")
+        ("sensitivities",po::bool_switch(&sensitivities), "propagate the derivatives of the outputs with respect to the parameters of the nodes in dissipationModelParameterFolder, conservationModelParameterFolder and propagationModelParameterFolder together with the outputs (tangent propagation). The derivatives are saved in outputFolder/sensitivities/<type>.tsv (a row for every time and node, a column for every parameter) unless outputFormat is errorMatrix; with referenceTimeSeriesFolder the gradient of the sum of the squared errors of every type is saved in outputFolder/gradients/<type>.tsv. NOTE: cannot be used with conservateInitialNorm, parameterSweepFolder and resumeCheckpoint")
         ("saveAugmentedNetworks",po::bool_switch(&saveAugmentedNetworks), "save the augmented networks for each iteration, default to false")
+        ("edgeWeightUpdatesFile",po::value<std::string>(), "(string) file of edge weight updates of the augmented graphs during the computation, with the columns time, type, startNodeName, endNodeName and weight. From the given time the edge of the augmented graph of the type has the new weight (the edge is added if it does not exist), the nodes can be the virtual nodes of the type (v-in:<type> and v-out:<type>). The propagation operators are updated incrementally instead of being built again. With undirectedEdges the updates of the edges between nodes of the graph are applied in both directions. Every run (scenario, candidate, replicate and window) starts from the weights of the setup")
     ;
 
     
@@ -119,6 +158,13 @@ int main(int argc, char** argv) {
     std::string typesInitialPerturbationMatrixFilename; ///< string variable to indicate the filename of the initial perturbation matrix, where the initial perturbation values are contained. WARNING: only use this option if the graph is unique for every type, otherwise use the initialPerturbationPerTypeFolder
     std::string graphsFilesFolder; ///< string variable to indicate the folder where the graphs edges files are contained
     std::string typeInitialPerturbationFolderFilename; ///< string variable to indicate the folder where the initial perturbation values for every type are contained
+    std::string scenarioFoldername; ///< string variable to indicate the folder where the scenarios are contained, every subfolder contains the initial perturbation values for every type of a scenario
+    std::vector<std::string> scenarioNames = {""}; ///< names of the scenarios computed with the same setup, a single unnamed scenario (saved directly in the output folder) if scenarioFolder is not set
+    std::string scenarioParametersFoldername; ///< string variable to indicate the folder where the parameters of the scenarios are contained, every subfolder contains the parameter folders of the models for a scenario
+    std::string parameterSweepFoldername; ///< string variable to indicate the folder where the parameter candidates are contained, every subfolder contains the parameter folders of the models for a candidate
+    std::vector<std::string> candidateNames = {""}; ///< names of the parameter candidates computed with the same setup, a single unnamed candidate (the parameters from the other options) if parameterSweepFolder is not set
+    std::vector<int> windowStartIterations = {0}; ///< intertype iterations where the fitting windows start, a single window for the whole simulation if fittingWindows is not set
+    std::vector<std::string> windowNames = {""}; ///< names of the fitting windows, used for the output folders of the candidates
     std::string outputFoldername; ///< string variable to indicate the folder where the output files will be saved
     int intertypeIterations; ///< integer variable to indicate the number of iterations for the intertype communication
     int intratypeIterations; ///< integer variable to indicate the number of iterations for the intratype communication
@@ -152,9 +198,22 @@ int main(int argc, char** argv) {
     // initialize MPI
     MPI_Init(&argc, &argv);
 
-    int numProcesses, rank;
-    MPI_Comm_size(MPI_COMM_WORLD, &numProcesses);
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    int worldNumProcesses, worldRank;
+    MPI_Comm_size(MPI_COMM_WORLD, &worldNumProcesses);
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+    // the processes are split into groups computing different parameter candidates, inside a group the processes partition the types and exchange the virtual outputs
+    if(candidateGroups <= 0 || worldNumProcesses % candidateGroups != 0){
+        if(worldRank==0)std::cerr << "[ERROR] candidateGroups must be a positive divisor of the number of processes (" << worldNumProcesses << "), aborting"<<std::endl;
+        return 1;
+    }
+    int candidateGroup = worldRank / (worldNumProcesses / candidateGroups);
+    MPI_Comm typesCommunicator; ///< communicator of the processes of the group, used for the exchange of the virtual outputs and the reductions over the types
+    MPI_Comm_split(MPI_COMM_WORLD, candidateGroup, worldRank, &typesCommunicator);
+    MPI_Comm candidateGroupsCommunicator; ///< communicator of the processes with the same types in every group (the rank is the group), used to select the candidate of a fitting window
+    MPI_Comm_split(MPI_COMM_WORLD, worldRank % (worldNumProcesses / candidateGroups), worldRank, &candidateGroupsCommunicator);
+    int numProcesses, rank; ///< number of processes and rank inside the group, the same as in MPI_COMM_WORLD without candidateGroups
+    MPI_Comm_size(typesCommunicator, &numProcesses);
+    MPI_Comm_rank(typesCommunicator, &rank);
 
 
     //logging options
@@ -192,6 +251,9 @@ int main(int argc, char** argv) {
 
     // print the number of processes and the rank
     logger.printLog(true,"Number of processes: ", numProcesses,", rank: ", rank);
+    if(candidateGroups > 1){
+        logger.printLog(true,"Number of candidate groups: ", candidateGroups,", group: ", candidateGroup, ", rank in MPI_COMM_WORLD: ", worldRank);
+    }
 
 
     //controls over impossible configurations
@@ -201,7 +263,7 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    if(vm.count("fInitialPerturbationPerType") == 0 && vm.count("initialPerturbationPerTypeFolder") == 0){
+    if(vm.count("fInitialPerturbationPerType") == 0 && vm.count("initialPerturbationPerTypeFolder") == 0 && vm.count("scenarioFolder") == 0){
         //no way of getting the initial perturbation values
         if(rank==0)logger.printError("no matrix for the initial values was passed as filename or single vector in files contained in the folder specified was set, set one ")<<std::endl;
         return 1;
@@ -226,6 +288,18 @@ int main(int argc, char** argv) {
         if(rank==0)logger.printError("fInitialPerturbationPerType and initialPerturbationPerTypeFolder were both set. Aborting");
         return 1;
     }
+    if(vm.count("scenarioFolder") && (vm.count("fInitialPerturbationPerType") || vm.count("initialPerturbationPerTypeFolder"))){
+        if(rank==0)logger.printError("scenarioFolder cannot be used with fInitialPerturbationPerType or initialPerturbationPerTypeFolder, the initial perturbations are read from the scenarios. Aborting");
+        return 1;
+    }
+    if(vm.count("scenarioFolder") && resumeCheckpoint){
+        if(rank==0)logger.printError("resumeCheckpoint is not supported with scenarioFolder. Aborting");
+        return 1;
+    }
+    if(vm.count("parameterSweepFolder") && resumeCheckpoint){
+        if(rank==0)logger.printError("resumeCheckpoint is not supported with parameterSweepFolder. Aborting");
+        return 1;
+    }
 
     if(!saturation){
         if (vm.count("saturationTerm")){
@@ -236,7 +310,19 @@ int main(int argc, char** argv) {
             if(rank==0)logger.printError("customSaturation was set but saturation was not set, impossible configuration, aborting")<<std::endl;
             return 1;
         }
+        if (vm.count("saturationExpression")){
+            if(rank==0)logger.printError("saturationExpression was set but saturation was not set, impossible configuration, aborting")<<std::endl;
+            return 1;
+        }
+        if (tanhSaturation){
+            if(rank==0)logger.printError("tanhSaturation was set but saturation was not set, impossible configuration, aborting")<<std::endl;
+            return 1;
+        }
     } 
+    if(int(customSaturation) + int(tanhSaturation) + int(vm.count("saturationExpression") > 0) > 1){
+        if(rank==0)logger.printError("only one of customSaturationFunction, tanhSaturation and saturationExpression can be set, aborting")<<std::endl;
+        return 1;
+    }
 
     if(vm.count("dissipationModelParameters") && !vm.count("dissipationModel")){
         //dissipation model parameters were set but no dissipation model was set
@@ -293,6 +379,68 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    // the expressions are only used as the scaling functions of the custom models, they are parsed here to fail before reading the graphs
+    std::string dissipationModelExpression = vm.count("dissipationModelExpression") ? vm["dissipationModelExpression"].as<std::string>() : ""; ///< expression of the dissipation scaling function, empty to use the custom function
+    std::string conservationModelExpression = vm.count("conservationModelExpression") ? vm["conservationModelExpression"].as<std::string>() : ""; ///< expression of the conservation scaling function, empty to use the custom function
+    std::string propagationModelExpression = vm.count("propagationModelExpression") ? vm["propagationModelExpression"].as<std::string>() : ""; ///< expression of the propagation scaling function, empty to use the custom function
+    std::string saturationExpression = vm.count("saturationExpression") ? vm["saturationExpression"].as<std::string>() : ""; ///< expression of the saturation function, empty to use the default or custom function
+    if(!dissipationModelExpression.empty() && (!vm.count("dissipationModel") || vm["dissipationModel"].as<std::string>() != "custom")){
+        if(rank==0)logger.printError("dissipationModelExpression was set but dissipationModel is not custom, aborting")<<std::endl;
+        return 1;
+    }
+    if(!conservationModelExpression.empty() && (!vm.count("conservationModel") || vm["conservationModel"].as<std::string>() != "custom")){
+        if(rank==0)logger.printError("conservationModelExpression was set but conservationModel is not custom, aborting")<<std::endl;
+        return 1;
+    }
+    if(!propagationModelExpression.empty() && (!vm.count("propagationModel") || (vm["propagationModel"].as<std::string>() != "customScaling" && vm["propagationModel"].as<std::string>() != "customScalingNeighbors" && vm["propagationModel"].as<std::string>() != "customPropagation"))){
+        if(rank==0)logger.printError("propagationModelExpression was set but propagationModel is not customScaling, customScalingNeighbors or customPropagation, aborting")<<std::endl;
+        return 1;
+    }
+    try{
+        if(!dissipationModelExpression.empty()) Expression::countParameters(dissipationModelExpression, {"t"});
+        if(!conservationModelExpression.empty()) Expression::countParameters(conservationModelExpression, {"t"});
+        if(!propagationModelExpression.empty()) Expression::countParameters(propagationModelExpression, {"t"});
+        if(!saturationExpression.empty()) Expression::countParameters(saturationExpression, {"x", "s"});
+    } catch(const std::invalid_argument& e){
+        if(rank==0)logger.printError(std::string("invalid expression: ") + e.what())<<std::endl;
+        return 1;
+    }
+    // the scaling functions of the custom models, compiled from the expressions if they are set
+    auto dissipationScalingFunctionFor = [&dissipationModelExpression](const std::vector<double>& parameters)->std::function<double(double)>{
+        if(dissipationModelExpression.empty()) return parameters.empty() ? getDissipationScalingFunction() : getDissipationScalingFunction(parameters);
+        return Expression(dissipationModelExpression, {"t"}, parameters).asScaleFunction();
+    };
+    auto conservationScalingFunctionFor = [&conservationModelExpression](const std::vector<double>& parameters)->std::function<double(double)>{
+        if(conservationModelExpression.empty()) return parameters.empty() ? getConservationScalingFunction() : getConservationScalingFunction(parameters);
+        return Expression(conservationModelExpression, {"t"}, parameters).asScaleFunction();
+    };
+    auto propagationScalingFunctionFor = [&propagationModelExpression](const std::vector<double>& parameters)->std::function<double(double)>{
+        if(propagationModelExpression.empty()) return parameters.empty() ? getPropagationScalingFunction() : getPropagationScalingFunction(parameters);
+        return Expression(propagationModelExpression, {"t"}, parameters).asScaleFunction();
+    };
+
+    // the plugin implementing the models set to 'plugin'
+    std::shared_ptr<const ModelPlugin> modelPlugin; ///< the plugin loaded from the modelPlugin option, nullptr if not set
+    bool pluginModelRequested = (vm.count("dissipationModel") && vm["dissipationModel"].as<std::string>() == "plugin") ||
+                                (vm.count("conservationModel") && vm["conservationModel"].as<std::string>() == "plugin") ||
+                                (vm.count("propagationModel") && vm["propagationModel"].as<std::string>() == "plugin");
+    if(pluginModelRequested && !vm.count("modelPlugin")){
+        if(rank==0)logger.printError("a model was set to plugin but modelPlugin was not set, aborting")<<std::endl;
+        return 1;
+    }
+    if(vm.count("modelPlugin")){
+        try{
+            modelPlugin = std::make_shared<const ModelPlugin>(vm["modelPlugin"].as<std::string>());
+        } catch(const std::invalid_argument& e){
+            if(rank==0)logger.printError(e.what())<<std::endl;
+            return 1;
+        }
+        if(rank==0)logger << "[LOG] model plugin " << modelPlugin->getName() << " loaded from " << modelPlugin->getPath() << std::endl;
+        if(!pluginModelRequested){
+            if(rank==0)logger.printWarning("modelPlugin was set but no model was set to plugin, the plugin is not used")<<std::endl;
+        }
+    }
+
     // reading the parameters
 
     if (vm.count("intertypeIterations")) {
@@ -401,8 +549,8 @@ int main(int argc, char** argv) {
     // output format parameter
     if(vm.count("outputFormat")){
         outputFormat = vm["outputFormat"].as<std::string>();
-        if(outputFormat != "singleIteration" && outputFormat != "iterationMatrix"){
-            if(rank==0)logger.printError("outputFormat must be one of the following: 'singleIteration' or 'iterationMatrix': aborting")<<std::endl;
+        if(outputFormat != "singleIteration" && outputFormat != "iterationMatrix" && outputFormat != "errorMatrix" && outputFormat != "replicateStatistics"){
+            if(rank==0)logger.printError("outputFormat must be one of the following: 'singleIteration', 'iterationMatrix', 'errorMatrix' or 'replicateStatistics': aborting")<<std::endl;
             return 1;
         }
     } else {
@@ -410,6 +558,137 @@ int main(int argc, char** argv) {
         outputFormat = "singleIteration";
     }
 
+    // reference time series, the errors are accumulated during the computation
+    std::string referenceTimeSeriesFoldername; ///< folder of the reference time series, empty if the errors are not computed
+    if(vm.count("referenceTimeSeriesFolder")){
+        referenceTimeSeriesFoldername = vm["referenceTimeSeriesFolder"].as<std::string>();
+        if(!folderExists(referenceTimeSeriesFoldername)){
+            if(rank==0)logger.printError("folder ")<< referenceTimeSeriesFoldername << " for the reference time series do not exist: aborting"<<std::endl;
+            return 1;
+        }
+        if(rank==0)logger << "[LOG] reference time series folder was set to " << referenceTimeSeriesFoldername << ", the error matrices will be saved" << std::endl;
+    } else if(outputFormat == "errorMatrix"){
+        if(rank==0)logger.printError("outputFormat errorMatrix was set but referenceTimeSeriesFolder was not set: aborting")<<std::endl;
+        return 1;
+    }
+
+    // edge weight updates of the augmented graphs, applied by the computations from their times
+    std::map<std::string, std::map<double, std::vector<std::tuple<std::string,std::string,double>>>> edgeWeightUpdates; ///< scheduled edge weight updates of every type, indexed by the time from which they are applied, empty if the weights do not change
+    if(vm.count("edgeWeightUpdatesFile")){
+        std::string edgeWeightUpdatesFilename = vm["edgeWeightUpdatesFile"].as<std::string>();
+        try{
+            edgeWeightUpdates = edgeWeightUpdatesFromFile(edgeWeightUpdatesFilename);
+        } catch(const std::invalid_argument& e){
+            if(rank==0)logger.printError(e.what())<<std::endl;
+            return 1;
+        }
+        if(rank==0)logger << "[LOG] edge weight updates file was set to " << edgeWeightUpdatesFilename << ", the edge weights of the augmented graphs change during the computation" << std::endl;
+    }
+
+    // windowed fitting, the candidates are computed one window at a time from the state of the selected candidate of the previous window
+    if(vm.count("fittingWindows")){
+        if(!vm.count("parameterSweepFolder") || referenceTimeSeriesFoldername.empty() || outputFormat != "errorMatrix"){
+            if(rank==0)logger.printError("fittingWindows requires parameterSweepFolder, referenceTimeSeriesFolder and outputFormat errorMatrix: aborting")<<std::endl;
+            return 1;
+        }
+        if(vm.count("scenarioFolder") || resumeCheckpoint){
+            if(rank==0)logger.printError("fittingWindows cannot be used with scenarioFolder or resumeCheckpoint: aborting")<<std::endl;
+            return 1;
+        }
+        for(const std::string& windowTime : splitStringIntoVector(vm["fittingWindows"].as<std::string>(), ",")){
+            double time;
+            try{
+                time = std::stod(windowTime);
+            } catch(const std::exception& e){
+                if(rank==0)logger.printError("the fitting window time ")<< windowTime << " is not a number: aborting"<<std::endl;
+                return 1;
+            }
+            // the state is exchanged between the types at the end of the intertype iterations, so the windows start with an intertype iteration
+            int windowStartIteration = static_cast<int>(std::ceil(time / timestep - 1e-9));
+            if(windowStartIteration <= windowStartIterations.back() || windowStartIteration >= intertypeIterations){
+                if(rank==0)logger.printError("the fitting window times must be increasing, in different intertype iterations and inside the simulation, the time ")<< windowTime << " is not: aborting"<<std::endl;
+                return 1;
+            }
+            windowStartIterations.push_back(windowStartIteration);
+        }
+        windowNames.clear();
+        for(uint windowIndex = 0; windowIndex < windowStartIterations.size(); windowIndex++){
+            windowNames.push_back("window" + std::to_string(windowIndex));
+        }
+        if(rank==0)logger << "[LOG] fittingWindows specified, the candidates are fitted in " << windowStartIterations.size() << " windows" << std::endl;
+    }
+
+    // states shared between the candidates, restored instead of computing again the iterations before them
+    int trajectoryCacheSize = 0;
+    if(vm.count("trajectoryCache")){
+        trajectoryCacheSize = vm["trajectoryCache"].as<int>();
+        if(trajectoryCacheSize <= 0){
+            if(rank==0)logger.printError("trajectoryCache must be a positive value: aborting")<<std::endl;
+            return 1;
+        }
+        // the iterations before the saved state are not computed again, so only the errors accumulated before it can be restored
+        if(!vm.count("parameterSweepFolder") || outputFormat != "errorMatrix" || vm.count("fittingWindows")){
+            if(rank==0)logger.printError("trajectoryCache requires parameterSweepFolder and outputFormat errorMatrix and cannot be used with fittingWindows: aborting")<<std::endl;
+            return 1;
+        }
+        if(rank==0)logger << "[LOG] trajectoryCache specified, up to " << trajectoryCacheSize << " states are kept to restart the candidates" << std::endl;
+    }
+
+    // replicates of the random models, the statistics over the replicates are updated while they are computed
+    int numReplicates = 1;
+    std::vector<double> replicateQuantiles = {0.05, 0.5, 0.95};
+    bool randomConservation = vm.count("conservationModel") && vm["conservationModel"].as<std::string>() == "random";
+    if(vm.count("replicates")){
+        numReplicates = vm["replicates"].as<int>();
+        if(numReplicates <= 0){
+            if(rank==0)logger.printError("replicates must be a positive value: aborting")<<std::endl;
+            return 1;
+        }
+        if(outputFormat != "replicateStatistics"){
+            if(rank==0)logger.printError("replicates requires outputFormat replicateStatistics: aborting")<<std::endl;
+            return 1;
+        }
+        bool randomDissipation = vm.count("dissipationModel") && vm["dissipationModel"].as<std::string>() == "random";
+        if(!randomDissipation && !randomConservation){
+            if(rank==0)logger.printError("replicates requires dissipationModel or conservationModel random, the replicates of the other models are identical: aborting")<<std::endl;
+            return 1;
+        }
+        if(vm.count("scenarioFolder") || vm.count("parameterSweepFolder") || !referenceTimeSeriesFoldername.empty() || sensitivities || resumeCheckpoint){
+            if(rank==0)logger.printError("replicates cannot be used with scenarioFolder, parameterSweepFolder, referenceTimeSeriesFolder, sensitivities or resumeCheckpoint: aborting")<<std::endl;
+            return 1;
+        }
+        if(vm.count("replicateQuantiles")){
+            replicateQuantiles = vm["replicateQuantiles"].as<std::vector<double>>();
+            for(double probability : replicateQuantiles){
+                if(probability <= 0 || probability >= 1){
+                    if(rank==0)logger.printError("replicateQuantiles must be between 0 and 1 (excluded), ")<< probability << " is not: aborting"<<std::endl;
+                    return 1;
+                }
+            }
+        }
+        if(rank==0)logger << "[LOG] replicates specified, " << numReplicates << " replicates are computed with the seeds from " << randomSeed << " and only their statistics are saved" << std::endl;
+    } else if(outputFormat == "replicateStatistics"){
+        if(rank==0)logger.printError("outputFormat replicateStatistics was set but replicates was not set: aborting")<<std::endl;
+        return 1;
+    } else if(vm.count("replicateQuantiles")){
+        if(rank==0)logger.printError("replicateQuantiles was set but replicates was not set: aborting")<<std::endl;
+        return 1;
+    }
+
+    // tangent propagation of the parameters of the nodes
+    if(sensitivities){
+        if(!vm.count("dissipationModelParameterFolder") && !vm.count("conservationModelParameterFolder") && !vm.count("propagationModelParameterFolder")){
+            if(rank==0)logger.printError("sensitivities was set but none of dissipationModelParameterFolder, conservationModelParameterFolder and propagationModelParameterFolder was set: aborting")<<std::endl;
+            return 1;
+        }
+        // the normalization of the input is not differentiated, the parameters are the ones of the folders and the sensitivities are not saved in the checkpoints
+        if(conservateInitialNorm || vm.count("parameterSweepFolder") || resumeCheckpoint){
+            if(rank==0)logger.printError("sensitivities cannot be used with conservateInitialNorm, parameterSweepFolder or resumeCheckpoint: aborting")<<std::endl;
+            return 1;
+        }
+        if(rank==0)logger << "[LOG] sensitivities specified, the derivatives of the outputs with respect to the parameters of the nodes will be computed" << std::endl;
+    }
+
 
     if (vm.count("fUniqueGraph")) {
         if(rank==0)logger << "[LOG] file for the graph was set to " 
@@ -436,6 +715,29 @@ int main(int argc, char** argv) {
             if(rank==0)logger.printError("file ")<< typesInitialPerturbationMatrixFilename << " for the initialPerturbationPerType does not exist: aborting"<<std::endl;
             return 1;
         }
+    } else if (vm.count("scenarioFolder")) {
+        if(rank==0)logger << "[LOG] folder for the scenarios was set to "
+            << vm["scenarioFolder"].as<std::string>() << ".\n";
+        scenarioFoldername = vm["scenarioFolder"].as<std::string>();
+        if(!folderExists(scenarioFoldername)){
+            if(rank==0)logger.printError("folder ")<< scenarioFoldername << " for the scenarios do not exist: aborting"<<std::endl;
+            return 1;
+        }
+        // every subfolder is a scenario, sorted so that all the processes compute the scenarios in the same order
+        scenarioNames.clear();
+        for(const std::string& scenarioPath : listFiles(scenarioFoldername, true, false)){
+            if(std::filesystem::is_directory(scenarioPath)){
+                scenarioNames.push_back(std::filesystem::path(scenarioPath).filename().string());
+            }
+        }
+        std::sort(scenarioNames.begin(), scenarioNames.end());
+        if(scenarioNames.empty()){
+            if(rank==0)logger.printError("folder ")<< scenarioFoldername << " for the scenarios does not contain any scenario: aborting"<<std::endl;
+            return 1;
+        }
+        if(rank==0)logger << "[LOG] " << scenarioNames.size() << " scenarios found, the types are read from the first scenario (" << scenarioNames[0] << ")" << std::endl;
+        // the setup uses the first scenario, the other ones only change the initial perturbations
+        typeInitialPerturbationFolderFilename = scenarioFoldername + "/" + scenarioNames[0];
     } else if (vm.count("initialPerturbationPerTypeFolder")) {
         if(rank==0)logger << "[LOG] folder for the initialPerturbationPerType was set to "
             << vm["initialPerturbationPerTypeFolder"].as<std::string>() << ".\n";
@@ -446,6 +748,123 @@ int main(int argc, char** argv) {
         }
     }
 
+    // the models whose parameters are swept, the same for every candidate
+    bool sweepDissipationParameters = false;
+    bool sweepConservationParameters = false;
+    bool sweepPropagationParameters = false;
+    if (vm.count("parameterSweepFolder")) {
+        if(rank==0)logger << "[LOG] folder for the parameter sweep was set to "
+            << vm["parameterSweepFolder"].as<std::string>() << ".\n";
+        parameterSweepFoldername = vm["parameterSweepFolder"].as<std::string>();
+        if(!folderExists(parameterSweepFoldername)){
+            if(rank==0)logger.printError("folder ")<< parameterSweepFoldername << " for the parameter sweep do not exist: aborting"<<std::endl;
+            return 1;
+        }
+        // every subfolder is a candidate, sorted so that all the processes compute the candidates in the same order
+        candidateNames.clear();
+        for(const std::string& candidatePath : listFiles(parameterSweepFoldername, true, false)){
+            if(std::filesystem::is_directory(candidatePath)){
+                candidateNames.push_back(std::filesystem::path(candidatePath).filename().string());
+            }
+        }
+        std::sort(candidateNames.begin(), candidateNames.end());
+        if(candidateNames.empty()){
+            if(rank==0)logger.printError("folder ")<< parameterSweepFoldername << " for the parameter sweep does not contain any candidate: aborting"<<std::endl;
+            return 1;
+        }
+        std::string firstCandidateFoldername = parameterSweepFoldername + "/" + candidateNames[0];
+        sweepDissipationParameters = folderExists(firstCandidateFoldername + "/dissipationParameters");
+        sweepConservationParameters = folderExists(firstCandidateFoldername + "/conservationParameters");
+        sweepPropagationParameters = folderExists(firstCandidateFoldername + "/propagationParameters");
+        if(!sweepDissipationParameters && !sweepConservationParameters && !sweepPropagationParameters){
+            if(rank==0)logger.printError("the candidate ")<< candidateNames[0] << " does not contain any of the folders dissipationParameters, conservationParameters and propagationParameters: aborting"<<std::endl;
+            return 1;
+        }
+        // a model missing from a candidate would keep the parameters of the previous one, so every candidate must sweep the same models
+        for(const std::string& candidateName : candidateNames){
+            std::string candidateFoldername = parameterSweepFoldername + "/" + candidateName;
+            if(folderExists(candidateFoldername + "/dissipationParameters") != sweepDissipationParameters ||
+               folderExists(candidateFoldername + "/conservationParameters") != sweepConservationParameters ||
+               folderExists(candidateFoldername + "/propagationParameters") != sweepPropagationParameters){
+                if(rank==0)logger.printError("the candidate ")<< candidateName << " does not contain the same parameter folders of the candidate " << candidateNames[0] << ": aborting"<<std::endl;
+                return 1;
+            }
+        }
+        if(sweepDissipationParameters && (!vm.count("dissipationModel") || vm["dissipationModel"].as<std::string>() != "custom")){
+            if(rank==0)logger.printError("the candidates contain dissipation parameters but dissipationModel is not custom, aborting")<<std::endl;
+            return 1;
+        }
+        if(sweepConservationParameters && (!vm.count("conservationModel") || vm["conservationModel"].as<std::string>() != "custom")){
+            if(rank==0)logger.printError("the candidates contain conservation parameters but conservationModel is not custom, aborting")<<std::endl;
+            return 1;
+        }
+        if(sweepPropagationParameters && (!vm.count("propagationModel") || (vm["propagationModel"].as<std::string>() != "customScaling" && vm["propagationModel"].as<std::string>() != "customScalingNeighbors" && vm["propagationModel"].as<std::string>() != "customPropagation"))){
+            if(rank==0)logger.printError("the candidates contain propagation parameters but propagationModel is not customScaling, customScalingNeighbors or customPropagation, aborting")<<std::endl;
+            return 1;
+        }
+        if(rank==0)logger << "[LOG] " << candidateNames.size() << " parameter candidates found" << std::endl;
+        if(candidateGroups > SizeToInt(candidateNames.size())){
+            if(worldRank==0)logger.printError("candidateGroups (")<< candidateGroups << ") is greater than the number of candidates (" << candidateNames.size() << "), some groups would not compute any candidate: aborting"<<std::endl;
+            return 1;
+        }
+    } else if(candidateGroups > 1){
+        if(worldRank==0)logger.printError("candidateGroups requires parameterSweepFolder: aborting")<<std::endl;
+        return 1;
+    }
+
+    // the models whose parameters change with the scenario, the same for every scenario
+    bool scenarioDissipationParameters = false;
+    bool scenarioConservationParameters = false;
+    bool scenarioPropagationParameters = false;
+    if (vm.count("scenarioParametersFolder")) {
+        if(!vm.count("scenarioFolder")){
+            if(rank==0)logger.printError("scenarioParametersFolder requires scenarioFolder: aborting")<<std::endl;
+            return 1;
+        }
+        // both replace the scaling functions of the models before the runs, so the parameters of a scenario would be overwritten by the candidate
+        if(vm.count("parameterSweepFolder")){
+            if(rank==0)logger.printError("scenarioParametersFolder cannot be used with parameterSweepFolder: aborting")<<std::endl;
+            return 1;
+        }
+        if(rank==0)logger << "[LOG] folder for the parameters of the scenarios was set to "
+            << vm["scenarioParametersFolder"].as<std::string>() << ".\n";
+        scenarioParametersFoldername = vm["scenarioParametersFolder"].as<std::string>();
+        if(!folderExists(scenarioParametersFoldername)){
+            if(rank==0)logger.printError("folder ")<< scenarioParametersFoldername << " for the parameters of the scenarios do not exist: aborting"<<std::endl;
+            return 1;
+        }
+        std::string firstScenarioParametersFoldername = scenarioParametersFoldername + "/" + scenarioNames[0];
+        scenarioDissipationParameters = folderExists(firstScenarioParametersFoldername + "/dissipationParameters");
+        scenarioConservationParameters = folderExists(firstScenarioParametersFoldername + "/conservationParameters");
+        scenarioPropagationParameters = folderExists(firstScenarioParametersFoldername + "/propagationParameters");
+        if(!scenarioDissipationParameters && !scenarioConservationParameters && !scenarioPropagationParameters){
+            if(rank==0)logger.printError("the parameters of the scenario ")<< scenarioNames[0] << " do not contain any of the folders dissipationParameters, conservationParameters and propagationParameters: aborting"<<std::endl;
+            return 1;
+        }
+        // a model missing from a scenario would keep the parameters of the previous one, so every scenario must contain the same models
+        for(const std::string& scenarioName : scenarioNames){
+            std::string scenarioParametersSubfoldername = scenarioParametersFoldername + "/" + scenarioName;
+            if(folderExists(scenarioParametersSubfoldername + "/dissipationParameters") != scenarioDissipationParameters ||
+               folderExists(scenarioParametersSubfoldername + "/conservationParameters") != scenarioConservationParameters ||
+               folderExists(scenarioParametersSubfoldername + "/propagationParameters") != scenarioPropagationParameters){
+                if(rank==0)logger.printError("the parameters of the scenario ")<< scenarioName << " do not contain the same parameter folders of the scenario " << scenarioNames[0] << ": aborting"<<std::endl;
+                return 1;
+            }
+        }
+        if(scenarioDissipationParameters && (!vm.count("dissipationModel") || vm["dissipationModel"].as<std::string>() != "custom")){
+            if(rank==0)logger.printError("the scenarios contain dissipation parameters but dissipationModel is not custom, aborting")<<std::endl;
+            return 1;
+        }
+        if(scenarioConservationParameters && (!vm.count("conservationModel") || vm["conservationModel"].as<std::string>() != "custom")){
+            if(rank==0)logger.printError("the scenarios contain conservation parameters but conservationModel is not custom, aborting")<<std::endl;
+            return 1;
+        }
+        if(scenarioPropagationParameters && (!vm.count("propagationModel") || (vm["propagationModel"].as<std::string>() != "customScaling" && vm["propagationModel"].as<std::string>() != "customScalingNeighbors" && vm["propagationModel"].as<std::string>() != "customPropagation"))){
+            if(rank==0)logger.printError("the scenarios contain propagation parameters but propagationModel is not customScaling, customScalingNeighbors or customPropagation, aborting")<<std::endl;
+            return 1;
+        }
+    }
+
     if (vm.count("typeInteractionFolder")) {
         if(rank==0)logger << "[LOG] folder for the type interactions was set to " 
             << vm["typeInteractionFolder"].as<std::string>() << ".\n";
@@ -473,26 +892,76 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    // create output folder for the current perturbations, if the output format is set to singleIteration
-    if(outputFormat == "singleIteration"){
-        std::string outputFolderNameSingular = outputFoldername + "/currentPerturbations";
-        if(!folderExists(outputFolderNameSingular)){
-            if(rank==0)logger.printWarning("folder for the output of singular perturbance values do not exist: creating the folder")<<std::endl;
-            if(!createFolder(outputFolderNameSingular)){
-                if(rank==0)logger.printError("folder for the output of singular perturbance values could not be created: aborting")<<std::endl;
+    // the output of a run is saved in outputFolder[/<candidate name>][/<scenario name>]
+    auto runOutputFolder = [&outputFoldername](const std::string& candidateName, const std::string& scenarioName)-> std::string{
+        std::string runOutputFoldername = candidateName.empty() ? outputFoldername : outputFoldername + "/" + candidateName;
+        return scenarioName.empty() ? runOutputFoldername : runOutputFoldername + "/" + scenarioName;
+    };
+    // create the output folders for every candidate and scenario (the output folder itself if no candidates and scenarios are used), the windows take the place of the scenarios with fittingWindows
+    const std::vector<std::string>& runSubfolderNames = vm.count("fittingWindows") ? windowNames : scenarioNames;
+    for(const std::string& candidateName : candidateNames){
+        if(!createFolder(runOutputFolder(candidateName, ""))){
+            if(rank==0)logger.printError("folder for the output of the candidate ")<< candidateName << " could not be created: aborting"<<std::endl;
+            return 1;
+        }
+        for(const std::string& scenarioName : runSubfolderNames){
+            std::string scenarioOutputFoldername = runOutputFolder(candidateName, scenarioName);
+            if(!createFolder(scenarioOutputFoldername)){
+                if(rank==0)logger.printError("folder for the output of the scenario ")<< scenarioName << " could not be created: aborting"<<std::endl;
                 return 1;
             }
-        }
-    }
+            // create output folder for the current perturbations, if the output format is set to singleIteration
+            if(outputFormat == "singleIteration"){
+                std::string outputFolderNameSingular = scenarioOutputFoldername + "/currentPerturbations";
+                if(!folderExists(outputFolderNameSingular)){
+                    if(rank==0)logger.printWarning("folder for the output of singular perturbance values do not exist: creating the folder")<<std::endl;
+                    if(!createFolder(outputFolderNameSingular)){
+                        if(rank==0)logger.printError("folder for the output of singular perturbance values could not be created: aborting")<<std::endl;
+                        return 1;
+                    }
+                }
+            }
 
-    // create output folder if the output format is iterationMatrix
-    if(outputFormat == "iterationMatrix"){
-        std::string outputFolderNameIterationMatrix = outputFoldername + "/iterationMatrices";
-        if(!folderExists(outputFolderNameIterationMatrix)){
-            if(rank==0)logger.printWarning("folder for the output of iteration matrix do not exist: creating the folder")<<std::endl;
-            if(!createFolder(outputFolderNameIterationMatrix)){
-                if(rank==0)logger.printError("folder for the output of iteration matrix could not be created: aborting")<<std::endl;
-                return 1;
+            // create output folder if the output format is iterationMatrix
+            if(outputFormat == "iterationMatrix"){
+                std::string outputFolderNameIterationMatrix = scenarioOutputFoldername + "/iterationMatrices";
+                if(!folderExists(outputFolderNameIterationMatrix)){
+                    if(rank==0)logger.printWarning("folder for the output of iteration matrix do not exist: creating the folder")<<std::endl;
+                    if(!createFolder(outputFolderNameIterationMatrix)){
+                        if(rank==0)logger.printError("folder for the output of iteration matrix could not be created: aborting")<<std::endl;
+                        return 1;
+                    }
+                }
+            }
+
+            // create output folder for the statistics over the replicates
+            if(outputFormat == "replicateStatistics"){
+                if(!createFolder(scenarioOutputFoldername + "/replicateStatistics")){
+                    if(rank==0)logger.printError("folder for the output of the replicate statistics could not be created: aborting")<<std::endl;
+                    return 1;
+                }
+            }
+
+            // create output folder for the error matrices if the reference time series are set
+            if(!referenceTimeSeriesFoldername.empty()){
+                if(!createFolder(scenarioOutputFoldername + "/errorMatrices")){
+                    if(rank==0)logger.printError("folder for the output of the error matrices could not be created: aborting")<<std::endl;
+                    return 1;
+                }
+            }
+
+            // create output folders for the sensitivities and the gradients of the errors
+            if(sensitivities && outputFormat != "errorMatrix"){
+                if(!createFolder(scenarioOutputFoldername + "/sensitivities")){
+                    if(rank==0)logger.printError("folder for the output of the sensitivities could not be created: aborting")<<std::endl;
+                    return 1;
+                }
+            }
+            if(sensitivities && !referenceTimeSeriesFoldername.empty()){
+                if(!createFolder(scenarioOutputFoldername + "/gradients")){
+                    if(rank==0)logger.printError("folder for the output of the gradients could not be created: aborting")<<std::endl;
+                    return 1;
+                }
             }
         }
     }
@@ -544,7 +1013,7 @@ int main(int argc, char** argv) {
         if(vm.count("fInitialPerturbationPerType")){
             types = getTypesFromMatrixFile(typesInitialPerturbationMatrixFilename);
 
-        } else if (vm.count("initialPerturbationPerTypeFolder")){
+        } else if (vm.count("initialPerturbationPerTypeFolder") || vm.count("scenarioFolder")){
             types = getTypesFromFolderFileNames(typeInitialPerturbationFolderFilename);
         } else {
             if(rank==0)logger.printError("no initial perturbation file or folder specified: aborting")<<std::endl;
@@ -718,9 +1187,7 @@ int main(int argc, char** argv) {
 
     //add the edges to the graphs
     if(vm.count("fUniqueGraph")){
-        for(auto edge = namesAndEdges[0].second.cbegin() ; edge != namesAndEdges[0].second.cend(); edge++ ){
-            graphs[0]->addEdge(std::get<0> (*edge), std::get<1> (*edge) ,std::get<2>(*edge) ,!undirected);
-        }
+        graphs[0]->addEdges(namesAndEdges[0].second, !undirected);
     } else if (vm.count("graphsFilesFolder")) {
         for(int i = startIdx; i < endIdx; i++){
             int namesAndEdgesIdx = 0;
@@ -730,9 +1197,7 @@ int main(int argc, char** argv) {
                     break;
                 }
             }
-            for(auto edge = namesAndEdges[namesAndEdgesIdx].second.cbegin() ; edge != namesAndEdges[namesAndEdgesIdx].second.cend(); edge++ ){
-                graphs[i-startIdx]->addEdge(std::get<0> (*edge), std::get<1> (*edge) ,std::get<2>(*edge) ,!undirected);
-            }
+            graphs[i-startIdx]->addEdges(namesAndEdges[namesAndEdgesIdx].second, !undirected);
         }
     }
 
@@ -743,7 +1208,7 @@ int main(int argc, char** argv) {
         if(rank==0)
             logger << "[LOG] initial perturbation per type specified, using the file "<<typesInitialPerturbationMatrixFilename<<std::endl;
         initialValues = valuesMatrixToTypeVectors(typesInitialPerturbationMatrixFilename,graphsNodes[0],subtypes);
-    } else if (vm.count("initialPerturbationPerTypeFolder")){
+    } else if (vm.count("initialPerturbationPerTypeFolder") || vm.count("scenarioFolder")){
         if(rank==0) logger << "[LOG] initial perturbation per type specified, using the folder "<<typeInitialPerturbationFolderFilename<<std::endl;
         initialValues = valuesVectorsFromFolder(typeInitialPerturbationFolderFilename,types,graphsNodesAll,subtypes); // TODO change the function to return only the values for the types in the workload
     } else {
@@ -824,7 +1289,18 @@ int main(int argc, char** argv) {
     if(saturation && customSaturation){
         if(rank==0)logger << "[LOG] custom saturation function set, using the custom saturation function defined in src/CustomFunctions.cxx"<<std::endl;
         for(int i = 0; i < finalWorkload;i++){
-            typeComputations[i]->setSaturationFunction(getSaturationFunction());
+            typeComputations[i]->setBatchSaturationFunction(getBatchSaturationFunction());
+        }
+    } else if(saturation && tanhSaturation){
+        if(rank==0)logger << "[LOG] scaled hyperbolic tangent saturation set"<<std::endl;
+        for(int i = 0; i < finalWorkload;i++){
+            typeComputations[i]->setBatchSaturationFunction(hyperbolicTangentScaledBatch);
+        }
+    } else if(saturation && !saturationExpression.empty()){
+        if(rank==0)logger << "[LOG] saturation expression set, using the saturation function " << saturationExpression <<std::endl;
+        Expression compiledSaturationExpression(saturationExpression, {"x", "s"});
+        for(int i = 0; i < finalWorkload;i++){
+            typeComputations[i]->setBatchSaturationFunction(compiledSaturationExpression.asBatchSaturationFunction());
         }
     } else {
         if(rank==0)logger << "[LOG] custom saturation function not set, using the default saturation function"<<std::endl;
@@ -851,7 +1327,8 @@ int main(int argc, char** argv) {
         for (int i = 0; i < finalWorkload;i++) {
             if(typeInteractionsEdges.first.contains(types[i+startIdx])){
                 // granularity is already considered in the function that reads from the file previously called
-                typeComputations[i]->addEdgesAndNodes(typeInteractionsEdges.first[types[i+startIdx]], false, false); // no inverse computation since it is done in the propagation model
+                // the types of the interactions file resolve the type and the node of the virtual nodes, that can both contain "_"
+                typeComputations[i]->addEdgesAndNodes(typeInteractionsEdges.first[types[i+startIdx]], false, false, subtypes.size() == 0 ? types : subtypes); // no inverse computation since it is done in the propagation model
             }
         }
         for(auto edge = typeInteractionsEdges.second.cbegin() ; edge != typeInteractionsEdges.second.cend(); edge++ ){
@@ -883,9 +1360,9 @@ int main(int argc, char** argv) {
         std::string conservationModelName = vm["conservationModel"].as<std::string>();
         if(conservationModelName == "none"){
             if(rank==0)logger << "[LOG] conservation model set to default (none)\n";
-            conservationModel = new ConservationModel([](double time)->double{return 0;});
+            conservationModel = new ConservationModel(0.0);
             for(int i = 0; i < finalWorkload; ++i){
-                conservationModels[i] = new ConservationModel([](double time)->double{return 0;}); // all processes will use the same conservation model
+                conservationModels[i] = new ConservationModel(0.0); // all processes will use the same conservation model
             }
         } else if (conservationModelName == "scaled"){
             if (vm.count("conservationModelParameters")) {
@@ -893,9 +1370,9 @@ int main(int argc, char** argv) {
             << vm["conservationModelParameters"].as<std::vector<double>>()[0] << ".\n";
                 std::vector<double> conservationModelParameters = vm["conservationModelParameters"].as<std::vector<double>>();
                 if(conservationModelParameters.size() == 1){
-                    conservationModel = new ConservationModel([conservationModelParameters](double time)->double{return conservationModelParameters[0];});
+                    conservationModel = new ConservationModel(conservationModelParameters[0]);
                     for(int i = 0; i < finalWorkload; ++i){
-                        conservationModels[i] = new ConservationModel([conservationModelParameters](double time)->double{return conservationModelParameters[0];}); // all processes will use the same conservation model
+                        conservationModels[i] = new ConservationModel(conservationModelParameters[0]); // all processes will use the same conservation model
                     }
                 } else {
                     if(rank==0)logger.printError("conservation model parameters for scaled conservation must be one parameter: aborting")<<std::endl;
@@ -920,9 +1397,12 @@ int main(int argc, char** argv) {
                         if(rank==0)logger.printError("conservation model parameters for random conservation must be between 0 and 1 and must be a < b: aborting")<<std::endl;
                         return 1;
                     }
-                    conservationModel = new ConservationModel([conservationModelParameters](double time)->double{return randomRealNumber(conservationModelParameters[0],conservationModelParameters[1]);});
+                    conservationModel = new ConservationModel([conservationModelParameters, &randomSeed](double time)->double{return counterBasedRealNumber(randomSeed, 0, 0, timeToCounter(time), conservationModelParameters[0],conservationModelParameters[1]);});
                     for(int i = 0; i < finalWorkload; ++i){
-                        conservationModels[i] = new ConservationModel([conservationModelParameters](double time)->double{return randomRealNumber(conservationModelParameters[0],conservationModelParameters[1]);}); // all processes will use the same conservation model
+                        // the streams after the ones of the types (used by the random dissipation) are used for the conservation, so that the random values are independent
+                        // the seed is captured by reference since the replicates change it
+                        uint64_t conservationStream = types.size() + i + startIdx;
+                        conservationModels[i] = new ConservationModel([conservationModelParameters, &randomSeed, conservationStream](double time)->double{return counterBasedRealNumber(randomSeed, conservationStream, 0, timeToCounter(time), conservationModelParameters[0],conservationModelParameters[1]);}); // all processes will use the same conservation model, with a different random stream for every type
                     }
                 } else {
                     if(rank==0)logger.printError("conservation model parameters for random conservation must be two: aborting")<<std::endl;
@@ -944,9 +1424,9 @@ int main(int argc, char** argv) {
                     }
                     logger << ")" << std::endl;
                 }
-                conservationModel = new ConservationModel(getConservationScalingFunction(conservationModelParameters));
+                conservationModel = new ConservationModel(conservationScalingFunctionFor(conservationModelParameters));
                 for(int i = 0; i < finalWorkload; ++i){
-                    conservationModels[i] = new ConservationModel(getConservationScalingFunction(conservationModelParameters)); // all processes will use the same conservation model
+                    conservationModels[i] = new ConservationModel(conservationScalingFunctionFor(conservationModelParameters)); // all processes will use the same conservation model
                 }
             } else if(vm.count("conservationModelParameterFolder")){
                 if(rank==0)logger << "[LOG] conservation model parameters were declared to be in the folder "<<vm["conservationModelParameterFolder"].as<std::string>()<<std::endl;
@@ -955,26 +1435,40 @@ int main(int argc, char** argv) {
                 for(int i = 0; i < finalWorkload; ++i){
                     typeToOrderedNodeNames[types[i+startIdx]] = typeComputations[i]->getAugmentedGraph()->getNodeNames();
                 }
-                auto conservationModelScalingFunctions = conservationScalingFunctionsFromFolder(conservationModelParametersFolder,typeToOrderedNodeNames);
+                auto conservationModelScalingFunctions = conservationScalingFunctionsFromFolder(conservationModelParametersFolder,typeToOrderedNodeNames,conservationModelExpression);
                 for(int i = 0; i < finalWorkload; ++i){
                     conservationModels[i] = new ConservationModel(conservationModelScalingFunctions[types[i+startIdx]]); // all processes will use the same dissipation model with different parameters
                 }
             } else {
                 if(rank==0)logger << "[LOG] conservation model parameters were not set, using the default scaling function (defined in the custom functions)" << std::endl;
-                conservationModel = new ConservationModel(getConservationScalingFunction());
+                conservationModel = new ConservationModel(conservationScalingFunctionFor({}));
                 for(int i = 0; i < finalWorkload; ++i){
-                    conservationModels[i] = new ConservationModel(getConservationScalingFunction()); // all processes will use the same conservation model
+                    conservationModels[i] = new ConservationModel(conservationScalingFunctionFor({})); // all processes will use the same conservation model
                 }
             }
+        } else if(conservationModelName == "plugin"){
+            if(rank==0)logger << "[LOG] conservation model set to the plugin " << modelPlugin->getName() << std::endl;
+            std::vector<double> conservationModelParameters;
+            if (vm.count("conservationModelParameters")) {
+                conservationModelParameters = vm["conservationModelParameters"].as<std::vector<double>>();
+            }
+            try{
+                for(int i = 0; i < finalWorkload; ++i){
+                    conservationModels[i] = new ConservationModelPlugin(modelPlugin, typeComputations[i]->getAugmentedGraph()->getNumNodes(), conservationModelParameters);
+                }
+            } catch(const std::invalid_argument& e){
+                if(rank==0)logger.printError(e.what())<<std::endl;
+                return 1;
+            }
         } else {
-            if(rank==0)logger.printError("conservation model scale function is not any of the types. Conservation model scale functions available are none(default), scaled, random and custom");
+            if(rank==0)logger.printError("conservation model scale function is not any of the types. Conservation model scale functions available are none(default), scaled, random, custom and plugin");
             return 1;
         }
     } else {
         if(rank==0)logger << "[LOG] conservation model was not set. set to default (none)"<<std::endl;
-        conservationModel = new ConservationModel([](double time)->double{return 0;});
+        conservationModel = new ConservationModel(0.0);
         for(int i = 0; i < finalWorkload; ++i){
-            conservationModels[i] = new ConservationModel([](double time)->double{return 0;}); // all processes will use the same conservation model
+            conservationModels[i] = new ConservationModel(0.0); // all processes will use the same conservation model
         }
     }
 
@@ -986,9 +1480,9 @@ int main(int argc, char** argv) {
         std::string dissipationModelName = vm["dissipationModel"].as<std::string>();
         if(dissipationModelName == "none"){
             if(rank==0)logger << "[LOG] dissipation model set to default (none)\n";
-            dissipationModel = new DissipationModelScaled([](double time)->double{return 0;});
+            dissipationModel = new DissipationModelScaled(0.0);
             for(int i = 0; i < finalWorkload; ++i){
-                dissipationModels[i] = new DissipationModelScaled([](double time)->double{return 0;}); // all processes will use the same dissipation model
+                dissipationModels[i] = new DissipationModelScaled(0.0); // all processes will use the same dissipation model
             }
         } else if(dissipationModelName == "power"){
             if (vm.count("dissipationModelParameters")) {
@@ -1016,9 +1510,9 @@ int main(int argc, char** argv) {
                     << vm["dissipationModelParameters"].as<std::vector<double>>()[0] << " & " << vm["dissipationModelParameters"].as<std::vector<double>>()[1] << ".\n";
                 std::vector<double> dissipationModelParameters = vm["dissipationModelParameters"].as<std::vector<double>>();
                 if(dissipationModelParameters.size() == 2){
-                    dissipationModel = new DissipationModelRandom(dissipationModelParameters[0],dissipationModelParameters[1]);
+                    dissipationModel = new DissipationModelRandom(dissipationModelParameters[0],dissipationModelParameters[1], randomSeed);
                     for(int i = 0; i < finalWorkload; ++i){
-                        dissipationModels[i] = new DissipationModelRandom(dissipationModelParameters[0],dissipationModelParameters[1]); // all processes will use the same dissipation model
+                        dissipationModels[i] = new DissipationModelRandom(dissipationModelParameters[0],dissipationModelParameters[1], randomSeed, i + startIdx); // all processes will use the same dissipation model, with a different random stream for every type
                     }
                 } else {
                     if(rank==0)logger.printError("dissipation model parameters for random dissipation must be two: aborting")<<std::endl;
@@ -1035,9 +1529,9 @@ int main(int argc, char** argv) {
                     << vm["dissipationModelParameters"].as<std::vector<double>>()[0] << ".\n";
                 std::vector<double> dissipationModelParameters = vm["dissipationModelParameters"].as<std::vector<double>>();
                 if(dissipationModelParameters.size() == 1){
-                    dissipationModel = new DissipationModelScaled([dissipationModelParameters](double time)->double{return dissipationModelParameters[0];});
+                    dissipationModel = new DissipationModelScaled(dissipationModelParameters[0]);
                     for(int i = 0; i < finalWorkload; ++i){
-                        dissipationModels[i] = new DissipationModelScaled([dissipationModelParameters](double time)->double{return dissipationModelParameters[0];}); // all processes will use the same dissipation model
+                        dissipationModels[i] = new DissipationModelScaled(dissipationModelParameters[0]); // all processes will use the same dissipation model
                     }
                 } else {
                     if(rank==0)logger.printError("dissipation model parameters for scaled dissipation must be one: aborting")<<std::endl;
@@ -1083,9 +1577,9 @@ int main(int argc, char** argv) {
                     }
                     logger << ")" << std::endl;
                 }
-                dissipationModel = new DissipationModelScaled(getDissipationScalingFunction(dissipationModelParameters));
+                dissipationModel = new DissipationModelScaled(dissipationScalingFunctionFor(dissipationModelParameters));
                 for(int i = 0; i < finalWorkload; ++i){
-                    dissipationModels[i] = new DissipationModelScaled(getDissipationScalingFunction(dissipationModelParameters)); // all processes will use the same dissipation model
+                    dissipationModels[i] = new DissipationModelScaled(dissipationScalingFunctionFor(dissipationModelParameters)); // all processes will use the same dissipation model
                 }
             } else if(vm.count("dissipationModelParameterFolder")) {
                 if(rank==0)logger << "[LOG] dissipation model parameters were declared to be in the folder "<<vm["dissipationModelParameterFolder"].as<std::string>()<<std::endl;
@@ -1094,26 +1588,40 @@ int main(int argc, char** argv) {
                 for(int i = 0; i < finalWorkload; ++i){
                     typeToOrderedNodeNames[types[i+startIdx]] = typeComputations[i]->getAugmentedGraph()->getNodeNames();
                 }
-                auto dissipationModelScalingFunctions = dissipationScalingFunctionsFromFolder(dissipationModelParametersFolder,typeToOrderedNodeNames);
+                auto dissipationModelScalingFunctions = dissipationScalingFunctionsFromFolder(dissipationModelParametersFolder,typeToOrderedNodeNames,dissipationModelExpression);
                 for(int i = 0; i < finalWorkload; ++i){
                     dissipationModels[i] = new DissipationModelScaled(dissipationModelScalingFunctions[types[i+startIdx]]); // all processes will use the same dissipation model with different parameters
                 }
             } else {
                 if(rank==0)logger << "[LOG] dissipation model parameters were not set, using the default scaling function (defined in the custom functions)" << std::endl;
-                dissipationModel = new DissipationModelScaled(getDissipationScalingFunction());
+                dissipationModel = new DissipationModelScaled(dissipationScalingFunctionFor({}));
+                for(int i = 0; i < finalWorkload; ++i){
+                    dissipationModels[i] = new DissipationModelScaled(dissipationScalingFunctionFor({})); // all processes will use the same dissipation model
+                }
+            }
+        } else if(dissipationModelName == "plugin"){
+            if(rank==0)logger << "[LOG] dissipation model set to the plugin " << modelPlugin->getName() << std::endl;
+            std::vector<double> dissipationModelParameters;
+            if (vm.count("dissipationModelParameters")) {
+                dissipationModelParameters = vm["dissipationModelParameters"].as<std::vector<double>>();
+            }
+            try{
                 for(int i = 0; i < finalWorkload; ++i){
-                    dissipationModels[i] = new DissipationModelScaled(getDissipationScalingFunction()); // all processes will use the same dissipation model
+                    dissipationModels[i] = new DissipationModelPlugin(modelPlugin, typeComputations[i]->getAugmentedGraph()->getNumNodes(), dissipationModelParameters);
                 }
+            } catch(const std::invalid_argument& e){
+                if(rank==0)logger.printError(e.what())<<std::endl;
+                return 1;
             }
         } else {
-            if(rank==0)logger.printError("dissipation model scale function is not any of the types. Conservation model scale functions available are none(default), scaled, random and custom");
+            if(rank==0)logger.printError("dissipation model scale function is not any of the types. Conservation model scale functions available are none(default), scaled, random, custom and plugin");
             return 1;
         }
     } else { //dissipation model set to default (none)
         if(rank==0)logger << "[LOG] dissipation model was not set. set to default (none)\n";
-        dissipationModel = new DissipationModelScaled([](double time)->double{return 0;});
+        dissipationModel = new DissipationModelScaled(0.0);
         for(int i = 0; i < finalWorkload; ++i){
-            dissipationModels[i] = new DissipationModelScaled([](double time)->double{return 0;}); // all processes will use the same dissipation model
+            dissipationModels[i] = new DissipationModelScaled(0.0); // all processes will use the same dissipation model
         }
     }
     //initialize the dissipation and conservation models for each computation
@@ -1237,6 +1745,89 @@ int main(int argc, char** argv) {
         
     }
     logger << "[LOG] type interactions loaded for rank "<< rank << std::endl; 
+
+    // the names of the virtual nodes are resolved here once, the exchange of the virtual nodes in the iterations only uses interned ids and positions
+    NameInterner& nameInterner = NameInterner::getInstance();
+    std::vector<NameId> typeIds;
+    std::vector<int> typeRanks;
+    typeIds.reserve(types.size());
+    typeRanks.reserve(types.size());
+    for(const std::string& type : types){
+        typeIds.push_back(nameInterner.intern(type));
+        typeRanks.push_back(typeToRank[type]);
+    }
+    // contact times between the local types and every source type (type granularity), nullptr if the types never interact
+    std::vector<std::vector<const std::set<double>*>> localTypesContactTimes(finalWorkload, std::vector<const std::set<double>*>(types.size(), nullptr));
+    // for every pair of ranks (local rank, target rank): the position of the source local type and the virtual output node sent (typeAndNode granularity)
+    std::unordered_map<std::pair<int, int>, std::vector<std::pair<int, NameId>>, hash_pair_ints> ranksPairVirtualOutputSources;
+    // for every pair of ranks (source rank, local rank): the position of the target local type, the virtual input node, the contact times and if the types are the same (typeAndNode granularity)
+    std::unordered_map<std::pair<int, int>, std::vector<std::tuple<int, NameId, const std::set<double>*, bool>>, hash_pair_ints> ranksPairVirtualInputTargets;
+    if(virtualNodesGranularity == "type"){
+        for(int ilocal = 0; ilocal < finalWorkload; ilocal++){
+            for(uint sourceTypePosition = 0; sourceTypePosition < types.size(); sourceTypePosition++){
+                auto contactTimes = interactionBetweenTypesMap.find(std::make_pair(types[ilocal + startIdx], types[sourceTypePosition]));
+                if(contactTimes != interactionBetweenTypesMap.end()){
+                    localTypesContactTimes[ilocal][sourceTypePosition] = &contactTimes->second;
+                }
+            }
+        }
+    } else if(virtualNodesGranularity == "typeAndNode"){
+        for(const auto& [keyRanks, virtualNodes] : ranksPairMappedVirtualNodesVectors){
+            if(keyRanks.first == rank){
+                std::vector<std::pair<int, NameId>>& virtualOutputSources = ranksPairVirtualOutputSources[keyRanks];
+                for(const auto& virtualNode : virtualNodes){
+                    std::vector<std::string> virtualInputNodeSplit = splitVirtualNodeStringIntoVector(virtualNode.second);
+                    if(virtualInputNodeSplit.size()!=3){
+                        logger.printError("virtual node string is not in the correct format: aborting") << std::endl;
+                        return 1;
+                    }
+                    int sourceTypePosition = -1;
+                    for(int j = 0; j < finalWorkload; j++){
+                        if(types[j+startIdx] == virtualInputNodeSplit[1]){
+                            sourceTypePosition = j;
+                            break;
+                        }
+                    }
+                    if(sourceTypePosition == -1){
+                        logger.printError("source type not found in the types vector: aborting") << std::endl;
+                        return 1;
+                    }
+                    virtualOutputSources.push_back(std::make_pair(sourceTypePosition, nameInterner.intern(virtualNode.first)));
+                }
+            }
+            if(keyRanks.second == rank){
+                std::vector<std::tuple<int, NameId, const std::set<double>*, bool>>& virtualInputTargets = ranksPairVirtualInputTargets[keyRanks];
+                for(const auto& [virtualOutputNodeName, virtualInputNodeName] : virtualNodes){
+                    std::vector<std::string> virtualOutputNodeNameSplitted = splitVirtualNodeStringIntoVector(virtualOutputNodeName);
+                    if(virtualOutputNodeNameSplitted.size()!=3) throw std::runtime_error("main:: virtual output node name is not in the correct format: " + virtualOutputNodeName);
+                    std::string targetType = virtualOutputNodeNameSplitted[1];
+                    std::string targetNodeName = virtualOutputNodeNameSplitted[2];
+
+                    std::vector<std::string> virtualInputNodeNameSplitted = splitVirtualNodeStringIntoVector(virtualInputNodeName);
+                    if(virtualInputNodeNameSplitted.size()!=3) throw std::runtime_error("main:: virtual input node name is not in the correct format: " + virtualInputNodeName);
+                    std::string sourceType = virtualInputNodeNameSplitted[1];
+                    std::string sourceNodeName = virtualInputNodeNameSplitted[2];
+
+                    // get local target index for typeComputation
+                    int targetTypeIndex = -1;
+                    for(int i = 0; i < finalWorkload; i++){
+                        if(types[i+startIdx] == targetType){
+                            targetTypeIndex = i;
+                            break;
+                        }
+                    }
+                    if(targetTypeIndex == -1) throw std::runtime_error("main:: target type index not found for type: " + targetType);
+                    auto contactTimes = interactionBetweenTypesFinerMap.find(std::make_tuple(sourceNodeName, targetNodeName, sourceType, targetType));
+                    if(contactTimes == interactionBetweenTypesFinerMap.end()){
+                        logger.printError("interaction between nodes: ") << sourceNodeName << " and " << targetNodeName << " for types " << sourceType << " and " << targetType << " is not present in the interactionBetweenTypesFinerMap" << std::endl;
+                        logger.printError("aborting") << std::endl;
+                        return 1;
+                    }
+                    virtualInputTargets.push_back(std::make_tuple(targetTypeIndex, nameInterner.intern(virtualInputNodeName), &contactTimes->second, sourceType == targetType));
+                }
+            }
+        }
+    }
     
 
     // setting propagation model in this moment since in the case of the original model, the pseudoinverse should be computed for the augmented pathway
@@ -1303,7 +1894,7 @@ int main(int argc, char** argv) {
                 if(rank==0)logger << "[LOG] propagation model parameters were declared to be "
                     << vm["propagationModelParameters"].as<std::vector<double>>()[0] << std::endl; //TODO change the logger to print the whole vector
                 std::vector<double> propagationModelParameters = vm["propagationModelParameters"].as<std::vector<double>>();
-                propagationScalingFunction = getPropagationScalingFunction(propagationModelParameters);
+                propagationScalingFunction = propagationScalingFunctionFor(propagationModelParameters);
                 for(int i = 0; i < finalWorkload;i++ ){
                     PropagationModel* tmpPropagationModel = new PropagationModelOriginal(typeComputations[i]->getAugmentedGraph(),propagationScalingFunction);
                     typeComputations[i]->setPropagationModel(tmpPropagationModel);
@@ -1315,14 +1906,14 @@ int main(int argc, char** argv) {
                 for(int i = 0; i < finalWorkload; ++i){
                     typeToOrderedNodeNames[types[i+startIdx]] = typeComputations[i]->getAugmentedGraph()->getNodeNames();
                 }
-                auto propagationModelScalingFunctions = propagationScalingFunctionsFromFolder(propagationModelParametersFolder,typeToOrderedNodeNames);
+                auto propagationModelScalingFunctions = propagationScalingFunctionsFromFolder(propagationModelParametersFolder,typeToOrderedNodeNames,propagationModelExpression);
                 for(int i = 0; i < finalWorkload ;i++ ){
                     PropagationModel* tmpPropagationModel = new PropagationModelOriginal(typeComputations[i]->getAugmentedGraph(),propagationModelScalingFunctions[types[i+startIdx]]);
                     typeComputations[i]->setPropagationModel(tmpPropagationModel);
                 }
             } else {
                 if(rank==0)logger.printError("[LOG] propagation model parameters for custom scaling propagation was not set: setting to default custom function (no parameters passed)")<<std::endl;
-                propagationScalingFunction = getPropagationScalingFunction();
+                propagationScalingFunction = propagationScalingFunctionFor({});
                 for(int i = 0; i < finalWorkload;i++ ){
                     PropagationModel* tmpPropagationModel = new PropagationModelOriginal(typeComputations[i]->getAugmentedGraph(),propagationScalingFunction);
                     typeComputations[i]->setPropagationModel(tmpPropagationModel);
@@ -1334,7 +1925,7 @@ int main(int argc, char** argv) {
                 if(rank==0)logger << "[LOG] propagation model parameters were declared to be "
                     << vm["propagationModelParameters"].as<std::vector<double>>()[0] << std::endl; //TODO change the logger to print the whole vector
                 std::vector<double> propagationModelParameters = vm["propagationModelParameters"].as<std::vector<double>>();
-                propagationScalingFunction = getPropagationScalingFunction(propagationModelParameters);
+                propagationScalingFunction = propagationScalingFunctionFor(propagationModelParameters);
                 for(int i = 0; i < finalWorkload;i++ ){
                     PropagationModel* tmpPropagationModel = new PropagationModelNeighbors(typeComputations[i]->getAugmentedGraph(),propagationScalingFunction);
                     typeComputations[i]->setPropagationModel(tmpPropagationModel);
@@ -1346,14 +1937,14 @@ int main(int argc, char** argv) {
                 for(int i = 0; i < finalWorkload; ++i){
                     typeToOrderedNodeNames[types[i+startIdx]] = typeComputations[i]->getAugmentedGraph()->getNodeNames();
                 }
-                auto propagationModelScalingFunctions = propagationScalingFunctionsFromFolder(propagationModelParametersFolder,typeToOrderedNodeNames);
+                auto propagationModelScalingFunctions = propagationScalingFunctionsFromFolder(propagationModelParametersFolder,typeToOrderedNodeNames,propagationModelExpression);
                 for(int i = 0; i < finalWorkload ;i++ ){
                     PropagationModel* tmpPropagationModel = new PropagationModelNeighbors(typeComputations[i]->getAugmentedGraph(),propagationModelScalingFunctions[types[i+startIdx]]);
                     typeComputations[i]->setPropagationModel(tmpPropagationModel);
                 }
             } else {
                 if(rank==0)logger.printError("[LOG] propagation model parameters for custom scaling neighbors propagation was not set: setting to default custom function (no parameters passed)")<<std::endl;
-                propagationScalingFunction = getPropagationScalingFunction();
+                propagationScalingFunction = propagationScalingFunctionFor({});
                 for(int i = 0; i < finalWorkload;i++ ){
                     PropagationModel* tmpPropagationModel = new PropagationModelNeighbors(typeComputations[i]->getAugmentedGraph(),propagationScalingFunction);
                     typeComputations[i]->setPropagationModel(tmpPropagationModel);
@@ -1366,7 +1957,7 @@ int main(int argc, char** argv) {
                 if(rank==0)logger << "[LOG] propagation model parameters were declared to be "
                 << vm["propagationModelParameters"].as<std::vector<double>>()[0] << std::endl;  //TODO change the logger to print the whole vector
                 std::vector<double> propagationModelParameters = vm["propagationModelParameters"].as<std::vector<double>>();
-                propagationScalingFunction = getPropagationScalingFunction(propagationModelParameters);
+                propagationScalingFunction = propagationScalingFunctionFor(propagationModelParameters);
                 for(int i = 0; i < finalWorkload;i++ ){
                     PropagationModel* tmpPropagationModel = new PropagationModelCustom(typeComputations[i]->getAugmentedGraph(),propagationScalingFunction);
                     typeComputations[i]->setPropagationModel(tmpPropagationModel);
@@ -1378,22 +1969,37 @@ int main(int argc, char** argv) {
                 for(int i = 0; i < finalWorkload; ++i){
                     typeToOrderedNodeNames[types[i+startIdx]] = typeComputations[i]->getAugmentedGraph()->getNodeNames();
                 }
-                auto propagationModelScalingFunctions = propagationScalingFunctionsFromFolder(propagationModelParametersFolder,typeToOrderedNodeNames);
+                auto propagationModelScalingFunctions = propagationScalingFunctionsFromFolder(propagationModelParametersFolder,typeToOrderedNodeNames,propagationModelExpression);
                 for(int i = 0; i < finalWorkload ;i++ ){
                     PropagationModel* tmpPropagationModel = new PropagationModelCustom(typeComputations[i]->getAugmentedGraph(),propagationModelScalingFunctions[types[i+startIdx]]);
                     typeComputations[i]->setPropagationModel(tmpPropagationModel);
                 }
             } else {
                 if(rank==0)logger.printError("[LOG] propagation model parameters for custom propagation was not set: setting to default custom function (no parameters passed)")<<std::endl;
-                propagationScalingFunction = getPropagationScalingFunction();
+                propagationScalingFunction = propagationScalingFunctionFor({});
                 for(int i = 0; i < finalWorkload;i++ ){
                     PropagationModel* tmpPropagationModel = new PropagationModelCustom(typeComputations[i]->getAugmentedGraph(),propagationScalingFunction);
                     typeComputations[i]->setPropagationModel(tmpPropagationModel);
                 }
             }
         
+        } else if(propagationModelName == "plugin"){
+            if(rank==0)logger << "[LOG] propagation model set to the plugin " << modelPlugin->getName() << std::endl;
+            std::vector<double> propagationModelParameters;
+            if(vm.count("propagationModelParameters")){
+                propagationModelParameters = vm["propagationModelParameters"].as<std::vector<double>>();
+            }
+            try{
+                for(int i = 0; i < finalWorkload;i++ ){
+                    PropagationModel* tmpPropagationModel = new PropagationModelPlugin(modelPlugin, typeComputations[i]->getAugmentedGraph(), propagationModelParameters);
+                    typeComputations[i]->setPropagationModel(tmpPropagationModel);
+                }
+            } catch(const std::invalid_argument& e){
+                if(rank==0)logger.printError(e.what())<<std::endl;
+                return 1;
+            }
         } else {
-            if(rank==0)logger.printError("propagation model is not any of the types. propagation model scale functions available are default, scaled, neighbors and custom");
+            if(rank==0)logger.printError("propagation model is not any of the types. propagation model scale functions available are default, scaled, neighbors, custom and plugin");
             return 1;
         }
     } else {
@@ -1404,6 +2010,17 @@ int main(int argc, char** argv) {
         }
     }
 
+    // the time grid is known before the computation, the scaling values of the models are precomputed once (identical schedules are shared between the types of the process)
+    std::vector<double> simulationTimes = ScaleSchedule::simulationTimeGrid(intertypeIterations, intratypeIterations, timestep);
+    ScaleSchedulePool scaleSchedulePool;
+    for(int i = 0; i < finalWorkload; i++){
+        typeComputations[i]->precomputeScaleSchedules(simulationTimes, &scaleSchedulePool);
+    }
+    // the step kernel is composed once for the models of the types, before the iterations
+    if(finalWorkload > 0){
+        logger << "[LOG] step kernel selected for rank " << rank << ": " << typeComputations[0]->getStepKernelDescription() << std::endl;
+    }
+
     // virtual inputs and virtual outputs buffers for the MPI communication
     // buffer for the virtual outputs from the other processes(virtual inputs), the maximum size is the power of 2 of the workload per process(since every type will send values to every other type)
     std::vector<double*> rankVirtualInputsBuffer;
@@ -1468,367 +2085,952 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-    // load checkpoint if resumeCheckpoint parameter is set
-    int startingInterIteration = 0;
-    int startingIntraIteration = 0;
-    if(resumeCheckpoint){
-        for(int i = 0; i < finalWorkload; i++){
-            checkpoint.loadState(types[i+startIdx], startingInterIteration, startingIntraIteration, typeComputations[i]);
+    // the type names of the nodes of every type, to read the parameters of the candidates and of the scenarios
+    std::map<std::string, std::vector<std::string>> typeToOrderedNodeNamesSweep;
+    if(vm.count("parameterSweepFolder") || vm.count("scenarioParametersFolder")){
+        for(int i = 0; i < finalWorkload; ++i){
+            typeToOrderedNodeNamesSweep[types[i+startIdx]] = typeComputations[i]->getAugmentedGraph()->getNodeNames();
         }
     }
 
-    for(int iterationInterType = startingInterIteration; iterationInterType < intertypeIterations; iterationInterType++){
-        for(int iterationIntraType = startingIntraIteration; iterationIntraType < intratypeIterations; iterationIntraType++){
-            // save checkpoint
-            for(int i = 0; i < finalWorkload; i++){
-                checkpoint.cleanCheckpoints(types[i+startIdx]);
-                checkpoint.saveState(types[i+startIdx], iterationInterType, iterationIntraType, typeComputations[i]);
+    // the parameters of the nodes whose sensitivities are propagated, read from the same folders of the scaling functions
+    if(sensitivities){
+        std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames;
+        for(int i = 0; i < finalWorkload; ++i){
+            typeToOrderedNodeNames[types[i+startIdx]] = typeComputations[i]->getAugmentedGraph()->getNodeNames();
+        }
+        std::map<std::string, std::vector<SensitivityParameter>> typeToSensitivityParameters;
+        std::vector<std::tuple<std::string, SensitivityTarget, std::string>> parameterFolders = {
+            {"dissipationModelParameterFolder", SensitivityTarget::dissipation, dissipationModelExpression},
+            {"conservationModelParameterFolder", SensitivityTarget::conservation, conservationModelExpression},
+            {"propagationModelParameterFolder", SensitivityTarget::propagation, propagationModelExpression}
+        };
+        try{
+            for(const auto& [optionName, target, expression] : parameterFolders){
+                if(!vm.count(optionName)){
+                    continue;
+                }
+                auto folderParameters = scalingParameterSensitivitiesFromFolder(vm[optionName].as<std::string>(), typeToOrderedNodeNames, target, expression);
+                for(auto& [type, parameters] : folderParameters){
+                    typeToSensitivityParameters[type].insert(typeToSensitivityParameters[type].end(), parameters.begin(), parameters.end());
+                }
             }
-            
-            // computation of perturbation
-            #pragma omp parallel for
-            for(int i = 0; i < finalWorkload; i++){
-                if(rank==0)logger.printLog(true,"computation of perturbation for iteration intertype-intratype (", iterationInterType, "<->", iterationIntraType, ") for type (", types[i+startIdx], ")"); 
-                // TODO use stateful scaling function to consider previous times
-                try
-                {
-                    if (saturation) {
-                        if(vm.count("saturationTerm") == 0){
-                            std::vector<double> outputValues = typeComputations[i]->computeAugmentedPerturbationEnhanced4((iterationInterType*intratypeIterations + iterationIntraType)*(timestep/intratypeIterations), saturation = true);
-                        } else if (vm.count("saturationTerm") >= 1) {
-                            double saturationTerm = vm["saturationTerm"].as<double>();
-                            std::vector<double> saturationVector = std::vector<double>(typeComputations[i]->getAugmentedGraph()->getNumNodes(),saturationTerm);
-                            std::vector<double> outputValues = typeComputations[i]->computeAugmentedPerturbationEnhanced4((iterationInterType*intratypeIterations + iterationIntraType)*(timestep/intratypeIterations), saturation = true, saturationVector);
-                        }
-                    } else{
-                        std::vector<double> outputValues = typeComputations[i]->computeAugmentedPerturbationEnhanced4((iterationInterType*intratypeIterations + iterationIntraType)*(timestep/intratypeIterations), saturation = false);
-                    }
+            for(int i = 0; i < finalWorkload; ++i){
+                typeComputations[i]->setSensitivityParameters(typeToSensitivityParameters[types[i+startIdx]]);
+                logger.printLog(true, "propagating the sensitivities of ", typeToSensitivityParameters[types[i+startIdx]].size(), " parameters for type ", types[i+startIdx]);
+            }
+        } catch(const std::invalid_argument& e){
+            logger.printError(e.what())<<std::endl;
+            return 1;
+        }
+    }
+
+    // error matrices of the types of the process against the reference time series, read once for every scenario
+    std::map<std::string, std::map<std::string, ErrorMatrix>> errorMatricesPerScenario;
+
+    // with fittingWindows the state of the types at the start of the current window and at the end of the window for the best candidate, kept in memory
+    std::vector<std::vector<double>> windowStartStates;
+    std::vector<std::vector<double>> windowBestStates(finalWorkload);
+    double windowBestRmse = std::numeric_limits<double>::quiet_NaN();
+    uint windowBestCandidate = 0;
+    // an error in the runs can happen on a single process while the other ones wait in a collective or for the virtual outputs, so the whole job is aborted instead of returning from the process
+    auto abortRuns = []() -> int {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        return 1;
+    };
+    std::ofstream fittingWindowsFile;
+    if(vm.count("fittingWindows")){
+        for(int i = 0; i < finalWorkload; i++){
+            windowStartStates.push_back(typeComputations[i]->getInputAugmented());
+        }
+        if(worldRank == 0){
+            fittingWindowsFile.open(outputFoldername + "/fittingWindows.tsv", std::ios::out | std::ios::trunc);
+            if(!fittingWindowsFile.is_open()){
+                logger.printError("unable to open the file " + outputFoldername + "/fittingWindows.tsv: aborting")<<std::endl;
+                return abortRuns();
+            }
+            fittingWindowsFile.precision(10);
+            fittingWindowsFile << "window\tstartTime\tendTime\tcandidate\trmse" << std::endl;
+        }
+    }
+
+    // the scaling functions of the candidates of the group are read and compiled once, the runs only replace the scaling functions of the models
+    struct CandidateScalingFunctions{
+        std::map<std::string, std::function<arma::Col<double>(double)>> dissipation; ///< scaling functions of the dissipation model of the types of the process
+        std::map<std::string, std::function<arma::Col<double>(double)>> conservation; ///< scaling functions of the conservation model of the types of the process
+        std::map<std::string, std::function<arma::Col<double>(double)>> propagation; ///< scaling functions of the propagation model of the types of the process
+        std::vector<std::shared_ptr<const ScaleSchedule>> dissipationSchedules; ///< with fittingWindows, the schedules of the dissipation model of the types of the process precomputed in the first window
+        std::vector<std::shared_ptr<const ScaleSchedule>> conservationSchedules; ///< with fittingWindows, the schedules of the conservation model of the types of the process precomputed in the first window
+        std::vector<std::shared_ptr<const ScaleSchedule>> propagationSchedules; ///< with fittingWindows, the schedules of the propagation model of the types of the process precomputed in the first window
+    };
+    std::vector<CandidateScalingFunctions> candidateScalingFunctions(candidateNames.size());
+    if(vm.count("parameterSweepFolder")){
+        for(uint candidateIndex = candidateGroup; candidateIndex < candidateNames.size(); candidateIndex += candidateGroups){
+            std::string candidateFoldername = parameterSweepFoldername + "/" + candidateNames[candidateIndex];
+            try{
+                if(sweepDissipationParameters){
+                    candidateScalingFunctions[candidateIndex].dissipation = dissipationScalingFunctionsFromFolder(candidateFoldername + "/dissipationParameters",typeToOrderedNodeNamesSweep,dissipationModelExpression);
+                }
+                if(sweepConservationParameters){
+                    candidateScalingFunctions[candidateIndex].conservation = conservationScalingFunctionsFromFolder(candidateFoldername + "/conservationParameters",typeToOrderedNodeNamesSweep,conservationModelExpression);
+                }
+                if(sweepPropagationParameters){
+                    candidateScalingFunctions[candidateIndex].propagation = propagationScalingFunctionsFromFolder(candidateFoldername + "/propagationParameters",typeToOrderedNodeNamesSweep,propagationModelExpression);
+                }
+            } catch(const std::invalid_argument& e){
+                logger.printError(e.what())<<std::endl;
+                return abortRuns();
+            }
+        }
+        if(rank==0)logger << "[LOG] scaling functions of the parameter candidates of the group " << candidateGroup << " read and compiled" << std::endl;
+    }
+    // the scaling functions of the scenarios are read and compiled once in the same way, the schedules are not kept since there are no fitting windows with scenarios
+    std::vector<CandidateScalingFunctions> scenarioScalingFunctions(scenarioNames.size());
+    if(vm.count("scenarioParametersFolder")){
+        for(uint scenarioIndex = 0; scenarioIndex < scenarioNames.size(); scenarioIndex++){
+            std::string scenarioParametersSubfoldername = scenarioParametersFoldername + "/" + scenarioNames[scenarioIndex];
+            try{
+                if(scenarioDissipationParameters){
+                    scenarioScalingFunctions[scenarioIndex].dissipation = dissipationScalingFunctionsFromFolder(scenarioParametersSubfoldername + "/dissipationParameters",typeToOrderedNodeNamesSweep,dissipationModelExpression);
+                }
+                if(scenarioConservationParameters){
+                    scenarioScalingFunctions[scenarioIndex].conservation = conservationScalingFunctionsFromFolder(scenarioParametersSubfoldername + "/conservationParameters",typeToOrderedNodeNamesSweep,conservationModelExpression);
                 }
-                catch(const std::exception& e)
-                {
-                    std::cerr << e.what() << '\n';
-                    exit(1);
+                if(scenarioPropagationParameters){
+                    scenarioScalingFunctions[scenarioIndex].propagation = propagationScalingFunctionsFromFolder(scenarioParametersSubfoldername + "/propagationParameters",typeToOrderedNodeNamesSweep,propagationModelExpression);
                 }
+            } catch(const std::invalid_argument& e){
+                logger.printError(e.what())<<std::endl;
+                return abortRuns();
             }
+        }
+        if(rank==0)logger << "[LOG] scaling functions of the scenarios read and compiled" << std::endl;
+    }
 
+    // the edge weight updates of the types of the process and the weights of the setup of the updated edges, restored before every run
+    std::vector<std::map<double, std::vector<std::tuple<std::string,std::string,double>>>> localEdgeWeightUpdates(finalWorkload);
+    std::vector<std::vector<std::tuple<std::string,std::string,double>>> localSetupEdgeWeights(finalWorkload);
+    bool edgeWeightsUpdated = false;
+    if(!edgeWeightUpdates.empty()){
+        if(rank==0){
+            for(const auto& [type, typeUpdates] : edgeWeightUpdates){
+                if(std::find(types.begin(), types.end(), type) == types.end()){
+                    logger.printWarning("type " + type + " of the edge weight updates is not one of the types, its updates are ignored")<<std::endl;
+                }
+            }
+        }
+        auto isVirtualNode = [](const std::string& nodeName)-> bool{
+            return nodeName.starts_with("v-in:") || nodeName.starts_with("v-out:");
+        };
+        for(int i = 0; i < finalWorkload; i++){
+            auto typeUpdates = edgeWeightUpdates.find(types[i+startIdx]);
+            if(typeUpdates == edgeWeightUpdates.end()){
+                continue;
+            }
+            const WeightedEdgeGraph* augmentedGraph = typeComputations[i]->getAugmentedGraph();
+            std::set<std::pair<std::string,std::string>> updatedEdges;
+            for(const auto& [time, edges] : typeUpdates->second){
+                std::vector<std::tuple<std::string,std::string,double>>& scheduledEdges = localEdgeWeightUpdates[i][time];
+                for(const auto& [startNodeName, endNodeName, weight] : edges){
+                    if(!augmentedGraph->containsNode(startNodeName) || !augmentedGraph->containsNode(endNodeName)){
+                        logger.printError("edge " + startNodeName + " -> " + endNodeName + " of the edge weight updates is not in the augmented graph of type " + types[i+startIdx] + ": aborting")<<std::endl;
+                        return abortRuns();
+                    }
+                    scheduledEdges.emplace_back(startNodeName, endNodeName, weight);
+                    updatedEdges.emplace(startNodeName, endNodeName);
+                    // the edges between types are directed, the reverse edges of the interactions use other virtual nodes
+                    if(undirected && !isVirtualNode(startNodeName) && !isVirtualNode(endNodeName)){
+                        scheduledEdges.emplace_back(endNodeName, startNodeName, weight);
+                        updatedEdges.emplace(endNodeName, startNodeName);
+                    }
+                }
+            }
+            for(const auto& [startNodeName, endNodeName] : updatedEdges){
+                localSetupEdgeWeights[i].emplace_back(startNodeName, endNodeName, augmentedGraph->getEdgeWeight(startNodeName, endNodeName));
+            }
+        }
+    }
 
+    // the states shared between the candidates, every process keeps the states of its types
+    std::unique_ptr<TrajectoryCache> trajectoryCache;
+    if(trajectoryCacheSize > 0){
+        trajectoryCache = std::make_unique<TrajectoryCache>(trajectoryCacheSize);
+    }
 
-            //save output values
+    // the statistics of the types of the process over the replicates, one column for every iteration
+    std::vector<ReplicateStatistics> replicateStatistics;
+    if(outputFormat == "replicateStatistics"){
+        for(int i = 0; i < finalWorkload; i++){
+            replicateStatistics.emplace_back(typeComputations[i]->getAugmentedGraph()->getNumNodes(), intertypeIterations*intratypeIterations, replicateQuantiles);
+        }
+    }
+    const uint64_t firstReplicateSeed = randomSeed;
+
+    // the runs (every replicate of every scenario for every parameter candidate, for every window) share the setup (graphs, type interactions, models and MPI buffers), only the scaling functions of the models, the seeds and the initial perturbations change between them
+    const uint runsPerWindow = candidateNames.size() * scenarioNames.size() * numReplicates;
+    for(uint runIndex = 0; runIndex < windowStartIterations.size() * runsPerWindow; runIndex++){
+        uint windowIndex = runIndex / runsPerWindow;
+        uint candidateIndex = (runIndex % runsPerWindow) / (scenarioNames.size() * numReplicates);
+        uint scenarioIndex = (runIndex / numReplicates) % scenarioNames.size();
+        uint replicateIndex = runIndex % numReplicates;
+        // the candidates of the other groups are computed by their processes
+        if(candidateIndex % candidateGroups != static_cast<uint>(candidateGroup)){
+            continue;
+        }
+        const std::string& candidateName = candidateNames[candidateIndex];
+        const std::string& scenarioName = scenarioNames[scenarioIndex];
+        std::string scenarioOutputFoldername = runOutputFolder(candidateName, vm.count("fittingWindows") ? windowNames[windowIndex] : scenarioName);
+        // the checkpoints of the types are distinguished by candidate and scenario
+        auto checkpointName = [&candidateName, &scenarioName](const std::string& type)-> std::string{
+            std::string runName = candidateName.empty() ? scenarioName : (scenarioName.empty() ? candidateName : candidateName + "_" + scenarioName);
+            return runName.empty() ? type : runName + "_" + type;
+        };
+        if(scenarioIndex == 0 && replicateIndex == 0 && !candidateName.empty()){
+            // only the scaling functions of the models are replaced, the propagation operators and the step are kept
+            if(rank==0)logger << "[LOG] computing parameter candidate " << candidateName << " (" << candidateIndex + 1 << "/" << candidateNames.size() << ")" << std::endl;
+            CandidateScalingFunctions& scalingFunctions = candidateScalingFunctions[candidateIndex];
+            for(int i = 0; i < finalWorkload; ++i){
+                if(sweepDissipationParameters){
+                    typeComputations[i]->getDissipationModel()->setScaleFunctionVectorized(scalingFunctions.dissipation.at(types[i+startIdx]));
+                }
+                if(sweepConservationParameters){
+                    typeComputations[i]->getConservationModel()->setScaleFunctionVectorized(scalingFunctions.conservation.at(types[i+startIdx]));
+                }
+                if(sweepPropagationParameters){
+                    typeComputations[i]->getPropagationModel()->setScaleFunctionVectorized(scalingFunctions.propagation.at(types[i+startIdx]));
+                }
+            }
+            if(windowIndex > 0){
+                // the windows after the first one reuse the scaling values of the candidate precomputed in the first window
+                for(int i = 0; i < finalWorkload; i++){
+                    typeComputations[i]->getDissipationModel()->setScaleSchedule(scalingFunctions.dissipationSchedules[i]);
+                    typeComputations[i]->getConservationModel()->setScaleSchedule(scalingFunctions.conservationSchedules[i]);
+                    typeComputations[i]->getPropagationModel()->setScaleSchedule(scalingFunctions.propagationSchedules[i]);
+                }
+            } else {
+                // the scaling values of the candidate are precomputed again, in a new pool since the previous schedules are not shared anymore
+                ScaleSchedulePool candidateScaleSchedulePool;
+                for(int i = 0; i < finalWorkload; i++){
+                    typeComputations[i]->precomputeScaleSchedules(simulationTimes, &candidateScaleSchedulePool);
+                }
+                // the schedules are kept for the next windows, where the candidate has the same scaling functions
+                if(windowStartIterations.size() > 1){
+                    for(int i = 0; i < finalWorkload; i++){
+                        scalingFunctions.dissipationSchedules.push_back(typeComputations[i]->getDissipationModel()->getScaleSchedule());
+                        scalingFunctions.conservationSchedules.push_back(typeComputations[i]->getConservationModel()->getScaleSchedule());
+                        scalingFunctions.propagationSchedules.push_back(typeComputations[i]->getPropagationModel()->getScaleSchedule());
+                    }
+                }
+            }
+        }
+        if(replicateIndex == 0 && vm.count("scenarioParametersFolder")){
+            // the scaling functions of the scenario replace the ones of the previous scenario, the propagation operators and the step are kept
+            CandidateScalingFunctions& scalingFunctions = scenarioScalingFunctions[scenarioIndex];
+            for(int i = 0; i < finalWorkload; ++i){
+                if(scenarioDissipationParameters){
+                    typeComputations[i]->getDissipationModel()->setScaleFunctionVectorized(scalingFunctions.dissipation.at(types[i+startIdx]));
+                }
+                if(scenarioConservationParameters){
+                    typeComputations[i]->getConservationModel()->setScaleFunctionVectorized(scalingFunctions.conservation.at(types[i+startIdx]));
+                }
+                if(scenarioPropagationParameters){
+                    typeComputations[i]->getPropagationModel()->setScaleFunctionVectorized(scalingFunctions.propagation.at(types[i+startIdx]));
+                }
+            }
+            ScaleSchedulePool scenarioScaleSchedulePool;
             for(int i = 0; i < finalWorkload; i++){
-                std::vector<std::string> nodeNames = typeComputations[i]->getAugmentedGraph()->getNodeNames();
-                int currentIteration = iterationInterType*intratypeIterations + iterationIntraType;
-                double currentTime = currentIteration*(timestep/intratypeIterations);
-                if(outputFormat == "singleIteration"){
-                    std::string outputFolderNameSingular = outputFoldername + "/currentPerturbations";
-                    saveNodeValuesWithTimeSimple(outputFolderNameSingular, currentIteration, currentTime, types[i+startIdx], typeComputations[i]->getOutputAugmented(), nodeNames, nodesDescriptionFilename);
-                } else if(outputFormat == "iterationMatrix"){
-                    std::vector<double> currentPerturbation = typeComputations[i]->getOutputAugmented();
-                    if(currentIteration != 0){
-                        // add the column to the matrix
-                        outputMatrices[types[i+startIdx]]->addColumnAtTheEnd(currentPerturbation);
-                    } else {
-                        // create the matrix
-                        outputMatrices[types[i+startIdx]] = new Matrix<double>(currentPerturbation, currentPerturbation.size(), 1);
-                        outputMatricesRowNames[types[i+startIdx]] = nodeNames;
+                typeComputations[i]->precomputeScaleSchedules(simulationTimes, &scenarioScaleSchedulePool);
+            }
+        }
+        if(numReplicates > 1){
+            // the replicates differ only in the seed of the random models, the first replicate is the run with randomSeed
+            if(rank==0)logger << "[LOG] computing replicate " << replicateIndex + 1 << "/" << numReplicates << " with seed " << firstReplicateSeed + replicateIndex << std::endl;
+            if(replicateIndex > 0){
+                randomSeed = firstReplicateSeed + replicateIndex;
+                for(int i = 0; i < finalWorkload; i++){
+                    DissipationModelRandom* randomDissipationModel = dynamic_cast<DissipationModelRandom*>(typeComputations[i]->getDissipationModel());
+                    if(randomDissipationModel != nullptr){
+                        randomDissipationModel->setSeed(randomSeed);
+                    }
+                }
+                // the random conservation values are precomputed, so they are computed again with the new seed
+                if(randomConservation){
+                    ScaleSchedulePool replicateScaleSchedulePool;
+                    for(int i = 0; i < finalWorkload; i++){
+                        typeComputations[i]->precomputeScaleSchedules(simulationTimes, &replicateScaleSchedulePool);
                     }
                 }
             }
-
-            //update input
+        }
+        if(!edgeWeightUpdates.empty()){
+            // the weights changed by the previous run are restored, every run applies the whole schedule from the weights of the setup
             for(int i = 0; i < finalWorkload; i++){
-                //If conservation of the initial values is required, the input is first updated with the initial norm value
-                if (conservateInitialNorm) {
-                    int index = indexMapGraphTypesToValuesTypes[i+startIdx];
-                    std::vector<double> inputInitial = inputInitials[index];
-                    double initialNorm = vectorNorm(inputInitial);
-                    double outputNorm = vectorNorm(typeComputations[i]->getOutputAugmented());
-                    double normRatio = initialNorm/outputNorm;
-                    std::vector<double> newInput = vectorScalarMultiplication(typeComputations[i]->getOutputAugmented(),normRatio);
-                    logger.printLog(true,"update input with conservation of the initial perturbation for iteration intertype-intratype (", iterationInterType, "<->", iterationIntraType, ") for type (", types[i+startIdx], ")"); // could change this to verbose
-                    typeComputations[i]->updateInput(newInput,true);
-                } else {
-                    logger.printLog(true,"update input for iteration intertype-intratype (", iterationInterType, "<->", iterationIntraType, ") for type (", types[i+startIdx], ")");  //could change this to verbose
-                    typeComputations[i]->updateInput(std::vector<double>(),true);
+                if(localEdgeWeightUpdates[i].empty()){
+                    continue;
+                }
+                typeComputations[i]->clearScheduledEdgeWeightUpdates();
+                if(edgeWeightsUpdated){
+                    typeComputations[i]->updateEdgeWeights(localSetupEdgeWeights[i]);
+                }
+                for(const auto& [time, edges] : localEdgeWeightUpdates[i]){
+                    typeComputations[i]->scheduleEdgeWeightUpdates(time, edges);
                 }
-                
             }
+            edgeWeightsUpdated = true;
         }
-
-        // send virtual outputs to the other processes, the vector contains the virtual outputs for each type as an array
-        // for every type, send the virtual outputs to the other processes, all in the same array (this array will be decomposed on the target)
-
-
-        if(virtualNodesGranularity == "type"){ //classical way of building the virtual outputs arrays, one array for each type representing virtual nodes for each type
-            // fill the arrays
-            for(int i = 0; i < SizeToInt(types.size()); i++){
-                int targetRank = typeToRank[types[i]];
-                int targetWorkload;
-                if(targetRank == (numProcesses-1)){
-                    targetWorkload = types.size() - (targetRank*workloadPerProcess);
+        if(vm.count("fittingWindows")){
+            // every candidate of the window starts from the state at the start of the window
+            if(candidateIndex == static_cast<uint>(candidateGroup)){
+                if(rank==0)logger << "[LOG] fitting window " << windowIndex + 1 << "/" << windowStartIterations.size() << " starting at time " << windowStartIterations[windowIndex]*timestep << std::endl;
+            }
+            for(int i = 0; i < finalWorkload; i++){
+                typeComputations[i]->setInputAugmented(windowStartStates[i]);
+            }
+        } else if(runIndex > 0){
+            if(!scenarioName.empty()){
+                if(rank==0)logger << "[LOG] computing scenario " << scenarioName << " (" << scenarioIndex + 1 << "/" << scenarioNames.size() << ")" << std::endl;
+                initialValues = valuesVectorsFromFolder(scenarioFoldername + "/" + scenarioName,types,graphsNodesAll,subtypes);
+                inputInitials = std::get<2>(initialValues);
+                indexMapGraphTypesToValuesTypes = get_indexmap_vector_values_full(types, std::get<1>(initialValues));
+                if(indexMapGraphTypesToValuesTypes.size() == 0){
+                    if(rank==0)logger.printError("types from the scenario ")<< scenarioName << " and types from file do not match even on one instance: aborting"<<std::endl;
+                    return abortRuns();
+                }
+            }
+            // the augmented input is reset to the initial perturbation of the scenario, the virtual nodes (after the nodes of the graph) start from 0
+            for(int i = 0; i < finalWorkload; i++){
+                std::vector<double> scenarioInput(typeComputations[i]->getInputAugmented().size(), 0);
+                int index = indexMapGraphTypesToValuesTypes[i+startIdx];
+                if(index == -1){
+                    logger.printLog(true, "type ", types[i+startIdx], " not found in the initial perturbation files of the scenario ", scenarioName, ", using zero vector as input");
                 } else {
-                    targetWorkload = workloadPerProcess;
+                    std::copy(inputInitials[index].begin(), inputInitials[index].end(), scenarioInput.begin());
                 }
-                int targetPosition = i - targetRank * workloadPerProcess;
-                for(int j = 0; j < finalWorkload; j++ ){
-                    int virtualOutputPosition = targetPosition + j * targetWorkload;
-                    
-                    virtualOutputs[targetRank][virtualOutputPosition] = typeComputations[j]->getVirtualOutputForType(types[i]);
+                typeComputations[i]->setInputAugmented(scenarioInput);
+                // the initial perturbation does not depend on the parameters
+                if(sensitivities){
+                    typeComputations[i]->resetSensitivities();
                 }
-                
             }
-        } else if (virtualNodesGranularity == "typeAndNode"){ // finer granularity, one array for each type and node representing virtual nodes for each type and node (as a couple)    
-            // fill the arrays
-            for (int targetRank = 0; targetRank < numProcesses; targetRank++){
-                std::pair<int, int> keyRanks = std::make_pair(rank, targetRank);
-                if(ranksPairMappedVirtualNodesVectors.contains(keyRanks)){
-                    for(uint i = 0; i < ranksPairMappedVirtualNodesVectors[keyRanks].size(); i++){
-                        std::pair<std::string, std::string> virtualNode = ranksPairMappedVirtualNodesVectors[keyRanks][i];
-                        std::vector<std::string> virtualInputNodeSplit = splitVirtualNodeStringIntoVector(virtualNode.second);
-                        if(virtualInputNodeSplit.size()==3){
-                            std::string sourceType = virtualInputNodeSplit[1];
-                            std::string sourceNode = virtualInputNodeSplit[2];
-                            int sourceTypePosition = -1;
-                            for(int j = 0; j < finalWorkload; j++){
-                                if(types[j+startIdx] == sourceType){
-                                    sourceTypePosition = j;
-                                    break;
-                                }
-                            }
-                            if(sourceTypePosition == -1){
-                                logger.printError("source type not found in the types vector: aborting") << std::endl;
-                                return 1;
-                            }
-                            double virtualOutputValue = typeComputations[sourceTypePosition]->getOutputNodeValue(virtualNode.first);
-                            virtualOutputs[targetRank][i] = virtualOutputValue;
-                        } else {
-                            logger.printError("virtual node string is not in the correct format: aborting") << std::endl;
-                            return 1;
-                        }
+        } else if(!scenarioName.empty()){
+            if(rank==0)logger << "[LOG] computing scenario " << scenarioName << " (1/" << scenarioNames.size() << ")" << std::endl;
+        }
+
+        // the reference time series of the scenario are read by the first run, the next runs (candidates) only reset the errors
+        std::map<std::string, ErrorMatrix>* runErrorMatrices = nullptr;
+        if(!referenceTimeSeriesFoldername.empty()){
+            if(!errorMatricesPerScenario.contains(scenarioName)){
+                std::string referenceFoldername = referenceTimeSeriesFoldername;
+                if(!scenarioName.empty() && folderExists(referenceTimeSeriesFoldername + "/" + scenarioName)){
+                    referenceFoldername = referenceTimeSeriesFoldername + "/" + scenarioName;
+                }
+                std::map<std::string, ErrorMatrix>& scenarioErrorMatrices = errorMatricesPerScenario[scenarioName];
+                for(int i = 0; i < finalWorkload; i++){
+                    std::string referenceFilename = referenceFoldername + "/" + types[i+startIdx] + ".tsv";
+                    if(!fileExistsPath(referenceFilename)){
+                        logger.printWarning("reference time series for type " + types[i+startIdx] + " not found in " + referenceFoldername + ", the type is not scored")<<std::endl;
+                        continue;
+                    }
+                    try{
+                        scenarioErrorMatrices.emplace(types[i+startIdx], ErrorMatrix(referenceFilename, typeComputations[i]->getAugmentedGraph()->getNodeNames()));
+                    } catch(const std::invalid_argument& e){
+                        logger.printError(e.what())<<std::endl;
+                        return abortRuns();
                     }
                 }
-                        
             }
-        } else {
-            if(rank==0)logger.printError("virtual nodes granularity is not any of the types. virtual nodes granularity available are type and typeAndNode");
-            return 1;
+            runErrorMatrices = &errorMatricesPerScenario[scenarioName];
+            for(auto& [type, errorMatrix] : *runErrorMatrices){
+                errorMatrix.reset();
+            }
         }
 
-
-        
-
-
-        // reset virtual outputs if specified, should work since virtual outputs are assigned before
-        if(resetVirtualOutputs){
+        // the sensitivities of every type are saved in a single file for the run, the gradients of the errors are summed over the times
+        std::map<std::string, std::ofstream> sensitivityFiles;
+        std::map<std::string, arma::Row<double>> typeGradients;
+        if(sensitivities){
             for(int i = 0; i < finalWorkload; i++){
-                typeComputations[i]->resetVirtualOutputs();
+                const std::vector<SensitivityParameter>& parameters = typeComputations[i]->getSensitivityParameters();
+                if(outputFormat != "errorMatrix"){
+                    std::string sensitivityFilename = scenarioOutputFoldername + "/sensitivities/" + types[i+startIdx] + ".tsv";
+                    std::ofstream& sensitivityFile = sensitivityFiles[types[i+startIdx]];
+                    sensitivityFile.open(sensitivityFilename, std::ios::out | std::ios::trunc);
+                    if(!sensitivityFile.is_open()){
+                        logger.printError("unable to open the file " + sensitivityFilename + ": aborting")<<std::endl;
+                        return abortRuns();
+                    }
+                    sensitivityFile.precision(10);
+                    sensitivityFile << "time\tnodeName";
+                    for(const auto& parameter : parameters){
+                        sensitivityFile << "\t" << parameter.name;
+                    }
+                    sensitivityFile << std::endl;
+                }
+                typeGradients[types[i+startIdx]] = arma::Row<double>(parameters.size(), arma::fill::zeros);
+            }
+        }
+        // the error matrices, the sensitivity files and the gradients of the local types are resolved once for the run, not at every iteration
+        std::vector<ErrorMatrix*> localErrorMatrices(finalWorkload, nullptr);
+        std::vector<std::ofstream*> localSensitivityFiles(finalWorkload, nullptr);
+        std::vector<arma::Row<double>*> localTypeGradients(finalWorkload, nullptr);
+        for(int i = 0; i < finalWorkload; i++){
+            if(runErrorMatrices != nullptr){
+                auto errorMatrix = runErrorMatrices->find(types[i+startIdx]);
+                if(errorMatrix != runErrorMatrices->end()){
+                    localErrorMatrices[i] = &errorMatrix->second;
+                }
+            }
+            auto sensitivityFile = sensitivityFiles.find(types[i+startIdx]);
+            if(sensitivityFile != sensitivityFiles.end()){
+                localSensitivityFiles[i] = &sensitivityFile->second;
+            }
+            auto typeGradient = typeGradients.find(types[i+startIdx]);
+            if(typeGradient != typeGradients.end()){
+                localTypeGradients[i] = &typeGradient->second;
+            }
+        }
+        // the options are compared once, not at every iteration
+        const bool singleIterationOutput = outputFormat == "singleIteration";
+        const bool iterationMatrixOutput = outputFormat == "iterationMatrix";
+        const bool replicateStatisticsOutput = outputFormat == "replicateStatistics";
+        const bool typeGranularity = virtualNodesGranularity == "type";
+        const bool typeAndNodeGranularity = virtualNodesGranularity == "typeAndNode";
+        const bool singleQuantization = quantizationMethod == "single";
+        const bool multipleQuantization = quantizationMethod == "multiple";
+        // the slots of the iteration matrices of the local types, the matrices are created at the first iteration
+        std::vector<Matrix<double>**> localOutputMatrices(finalWorkload, nullptr);
+        if(iterationMatrixOutput){
+            for(int i = 0; i < finalWorkload; i++){
+                localOutputMatrices[i] = &outputMatrices[types[i+startIdx]];
             }
         }
 
+        // load checkpoint if resumeCheckpoint parameter is set
+        int startingInterIteration = windowStartIterations[windowIndex];
+        int startingIntraIteration = 0;
+        int endingInterIteration = windowIndex + 1 < windowStartIterations.size() ? windowStartIterations[windowIndex + 1] : intertypeIterations;
 
-
-        // preliminary asynchronous receive
-        
-        // receive the virtual outputs from the other processes
-        MPI_Request request[numProcesses];
-        for(int i = 0; i < numProcesses; i++){
-            int sourceRank = i;
-            // receive only the virtual outputs for the types granularity (v-out for each type), or the full vectors for each pair of source type and target type
-            if(virtualNodesGranularity == "typeAndNode" || virtualNodesGranularity == "type"){
-                std::pair<int, int> keyRanks = std::make_pair(sourceRank, rank);
-                if(ranksPairMappedVirtualNodesVectors.contains(keyRanks)){
-                    MPI_Irecv(rankVirtualInputsBuffer[sourceRank], rankVirtualInputsSizes[sourceRank], MPI_DOUBLE, sourceRank, 0, MPI_COMM_WORLD, &request[sourceRank]);
+        // keys of the states at the start of the intertype iterations where the scaling values of one of the types change, the same in all the processes
+        std::map<int, uint64_t> trajectoryCacheKeys;
+        if(trajectoryCache){
+            std::vector<int> changeIterations(intertypeIterations, 0);
+            for(int i = 0; i < finalWorkload; i++){
+                for(double changeTime : typeComputations[i]->scaleChangeTimes()){
+                    int changeIteration = static_cast<int>(std::floor(changeTime / timestep + 1e-9));
+                    if(changeIteration > 0 && changeIteration < intertypeIterations){
+                        changeIterations[changeIteration] = 1;
+                    }
+                }
+            }
+            MPI_Allreduce(MPI_IN_PLACE, changeIterations.data(), intertypeIterations, MPI_INT, MPI_MAX, typesCommunicator);
+            std::vector<int> cacheIterations;
+            for(int iteration = 0; iteration < intertypeIterations; iteration++){
+                if(changeIterations[iteration]){
+                    cacheIterations.push_back(iteration);
+                }
+            }
+            // the hashes of the types are combined independently of the process that computes them
+            std::vector<uint64_t> scaleHashes(cacheIterations.size(), 0);
+            std::vector<int> validHashes(cacheIterations.size(), 1);
+            for(size_t k = 0; k < cacheIterations.size(); k++){
+                for(int i = 0; i < finalWorkload; i++){
+                    std::optional<uint64_t> typeHash = typeComputations[i]->scalePrefixHash(cacheIterations[k]*timestep);
+                    if(!typeHash){
+                        validHashes[k] = 0;
+                        break;
+                    }
+                    scaleHashes[k] ^= hashCombine(i + startIdx, *typeHash);
+                }
+            }
+            if(!cacheIterations.empty()){
+                MPI_Allreduce(MPI_IN_PLACE, scaleHashes.data(), cacheIterations.size(), MPI_UINT64_T, MPI_BXOR, typesCommunicator);
+                MPI_Allreduce(MPI_IN_PLACE, validHashes.data(), cacheIterations.size(), MPI_INT, MPI_MIN, typesCommunicator);
+            }
+            for(size_t k = 0; k < cacheIterations.size(); k++){
+                if(validHashes[k]){
+                    trajectoryCacheKeys[cacheIterations[k]] = TrajectoryCache::key(scenarioIndex, cacheIterations[k], scaleHashes[k]);
+                }
+            }
+            // the run starts from the latest saved state reached with the same scaling values
+            for(auto cacheKey = trajectoryCacheKeys.rbegin(); cacheKey != trajectoryCacheKeys.rend(); cacheKey++){
+                const TrajectorySnapshot* snapshot = trajectoryCache->find(cacheKey->second);
+                if(snapshot != nullptr){
+                    for(int i = 0; i < finalWorkload; i++){
+                        typeComputations[i]->setInputAugmented(snapshot->states[i]);
+                    }
+                    for(const auto& [type, errorMatrix] : snapshot->errorMatrices){
+                        runErrorMatrices->at(type) = errorMatrix;
+                    }
+                    startingInterIteration = snapshot->interIteration;
+                    if(rank==0)logger << "[LOG] restarting from the saved state at time " << startingInterIteration*timestep << std::endl;
+                    break;
                 }
-            } else {
-                // OTHER CASES NOT IMPLEMENTED YET
+            }
+        }
+        if(resumeCheckpoint){
+            for(int i = 0; i < finalWorkload; i++){
+                checkpoint.loadState(checkpointName(types[i+startIdx]), startingInterIteration, startingIntraIteration, typeComputations[i]);
             }
         }
 
-    
-
-        // send the virtual outputs to the other processes
-        for(int targetRank = 0; targetRank < numProcesses; targetRank++){
-            //sending virtual outputs to target cell
-            // int targetStartIdx = j * workloadPerProcess;
-            // int targetEndIdx = (j == numProcesses - 1) ? types.size() : (j + 1) * workloadPerProcess;
-            // logger << "[LOG] sending virtual output from type " << types[startIdx] << " to type " << types[endIdx-1] << " from process " << rank << " to process " << j << " from type " << types[targetStartIdx] << " to type " << types[targetEndIdx-1] << std::endl;
+        for(int iterationInterType = startingInterIteration; iterationInterType < endingInterIteration; iterationInterType++){
+            // save the state before the scaling values change, for the next candidates with the same scaling values until here
+            if(trajectoryCache && trajectoryCacheKeys.contains(iterationInterType) && !trajectoryCache->contains(trajectoryCacheKeys[iterationInterType])){
+                TrajectorySnapshot snapshot;
+                snapshot.interIteration = iterationInterType;
+                for(int i = 0; i < finalWorkload; i++){
+                    snapshot.states.push_back(typeComputations[i]->getInputAugmented());
+                }
+                snapshot.errorMatrices = *runErrorMatrices;
+                trajectoryCache->store(trajectoryCacheKeys[iterationInterType], std::move(snapshot));
+            }
+            for(int iterationIntraType = startingIntraIteration; iterationIntraType < intratypeIterations; iterationIntraType++){
+                // save checkpoint
+                for(int i = 0; i < finalWorkload; i++){
+                    checkpoint.cleanCheckpoints(checkpointName(types[i+startIdx]));
+                    checkpoint.saveState(checkpointName(types[i+startIdx]), iterationInterType, iterationIntraType, typeComputations[i]);
+                }
             
-            //synchronized communication will lead to deadlocks with this type of implementation
-            if(virtualNodesGranularity == "typeAndNode" || virtualNodesGranularity == "type"){
-                //send the subvectors of the virtual outputs for the combination of types and nodes
-                std::pair<int, int> keyRanks = std::make_pair(rank, targetRank);
-                if(ranksPairMappedVirtualNodesVectors.contains(keyRanks)){
+                // computation of perturbation
+                #pragma omp parallel for
+                for(int i = 0; i < finalWorkload; i++){
+                    if(rank==0)logger.printLog(true,"computation of perturbation for iteration intertype-intratype (", iterationInterType, "<->", iterationIntraType, ") for type (", types[i+startIdx], ")"); 
+                    // TODO use stateful scaling function to consider previous times
                     try
                     {
-                        MPI_Send(virtualOutputs.at(targetRank), rankVirtualOutputsSizes[targetRank], MPI_DOUBLE, targetRank, 0, MPI_COMM_WORLD);
+                        if (saturation) {
+                            if(vm.count("saturationTerm") == 0){
+                                std::vector<double> outputValues = typeComputations[i]->computeAugmentedPerturbationEnhanced4((iterationInterType*intratypeIterations + iterationIntraType)*(timestep/intratypeIterations), saturation = true);
+                            } else if (vm.count("saturationTerm") >= 1) {
+                                double saturationTerm = vm["saturationTerm"].as<double>();
+                                std::vector<double> saturationVector = std::vector<double>(typeComputations[i]->getAugmentedGraph()->getNumNodes(),saturationTerm);
+                                std::vector<double> outputValues = typeComputations[i]->computeAugmentedPerturbationEnhanced4((iterationInterType*intratypeIterations + iterationIntraType)*(timestep/intratypeIterations), saturation = true, saturationVector);
+                            }
+                        } else{
+                            std::vector<double> outputValues = typeComputations[i]->computeAugmentedPerturbationEnhanced4((iterationInterType*intratypeIterations + iterationIntraType)*(timestep/intratypeIterations), saturation = false);
+                        }
                     }
                     catch(const std::exception& e)
                     {
-                        std::cerr << e.what() << std::endl;
-                        logger.printError("error in sending virtual outputs from process ") << rank << " to process " << targetRank << std::endl;
-                        return 1;
+                        std::cerr << e.what() << '\n';
+                        exit(1);
                     }
-                    logger.printLog(true,"sent virtual outputs from process ", rank, " to process ", targetRank);
+                }
+
+
+
+                //save output values
+                for(int i = 0; i < finalWorkload; i++){
+                    int currentIteration = iterationInterType*intratypeIterations + iterationIntraType;
+                    double currentTime = currentIteration*(timestep/intratypeIterations);
+                    if(singleIterationOutput){
+                        std::string outputFolderNameSingular = scenarioOutputFoldername + "/currentPerturbations";
+                        saveNodeValuesWithTimeSimple(outputFolderNameSingular, currentIteration, currentTime, types[i+startIdx], typeComputations[i]->getOutputAugmented(), typeComputations[i]->getAugmentedGraph()->getNodeNames(), nodesDescriptionFilename);
+                    } else if(iterationMatrixOutput){
+                        std::vector<double> currentPerturbation = typeComputations[i]->getOutputAugmented();
+                        if(currentIteration != 0){
+                            // add the column to the matrix
+                            (*localOutputMatrices[i])->addColumnAtTheEnd(currentPerturbation);
+                        } else {
+                            // create the matrix
+                            *localOutputMatrices[i] = new Matrix<double>(currentPerturbation, currentPerturbation.size(), 1);
+                            // one column for every iteration, so the columns added later do not reallocate the matrix
+                            (*localOutputMatrices[i])->reserve(currentPerturbation.size(), intertypeIterations*intratypeIterations);
+                            outputMatricesRowNames[types[i+startIdx]] = typeComputations[i]->getAugmentedGraph()->getNodeNames();
+                        }
+                    } else if(replicateStatisticsOutput){
+                        replicateStatistics[i].add(currentIteration, typeComputations[i]->getOutputAugmented());
+                    }
+                    // accumulate the errors against the reference time series, only the times in the reference are used
+                    if(localErrorMatrices[i] != nullptr){
+                        localErrorMatrices[i]->accumulate(currentTime, typeComputations[i]->getOutputAugmented());
+                        if(sensitivities){
+                            *localTypeGradients[i] += localErrorMatrices[i]->sumSquaredErrorsGradient(currentTime, typeComputations[i]->getSensitivities());
+                        }
+                    }
+                    // the derivatives of the output of every node with respect to the parameters
+                    if(localSensitivityFiles[i] != nullptr){
+                        std::ofstream& sensitivityFile = *localSensitivityFiles[i];
+                        const std::vector<std::string> nodeNames = typeComputations[i]->getAugmentedGraph()->getNodeNames();
+                        const arma::Mat<double>& typeSensitivities = typeComputations[i]->getSensitivities();
+                        for(arma::uword node = 0; node < typeSensitivities.n_rows; node++){
+                            sensitivityFile << currentTime << "\t" << nodeNames[node];
+                            for(arma::uword parameter = 0; parameter < typeSensitivities.n_cols; parameter++){
+                                sensitivityFile << "\t" << typeSensitivities(node, parameter);
+                            }
+                            sensitivityFile << "\n";
+                        }
+                    }
+                }
+
+                //update input
+                for(int i = 0; i < finalWorkload; i++){
+                    //If conservation of the initial values is required, the input is first updated with the initial norm value
+                    if (conservateInitialNorm) {
+                        int index = indexMapGraphTypesToValuesTypes[i+startIdx];
+                        std::vector<double> inputInitial = inputInitials[index];
+                        double initialNorm = vectorNorm(inputInitial);
+                        double outputNorm = vectorNorm(typeComputations[i]->getOutputAugmented());
+                        double normRatio = initialNorm/outputNorm;
+                        std::vector<double> newInput = vectorScalarMultiplication(typeComputations[i]->getOutputAugmented(),normRatio);
+                        logger.printLog(true,"update input with conservation of the initial perturbation for iteration intertype-intratype (", iterationInterType, "<->", iterationIntraType, ") for type (", types[i+startIdx], ")"); // could change this to verbose
+                        typeComputations[i]->updateInput(newInput,true);
+                    } else {
+                        logger.printLog(true,"update input for iteration intertype-intratype (", iterationInterType, "<->", iterationIntraType, ") for type (", types[i+startIdx], ")");  //could change this to verbose
+                        typeComputations[i]->updateInput(std::vector<double>(),true);
+                    }
+                
+                }
+            }
+
+            // send virtual outputs to the other processes, the vector contains the virtual outputs for each type as an array
+            // for every type, send the virtual outputs to the other processes, all in the same array (this array will be decomposed on the target)
+
+
+            if(typeGranularity){ //classical way of building the virtual outputs arrays, one array for each type representing virtual nodes for each type
+                // fill the arrays
+                for(int i = 0; i < SizeToInt(types.size()); i++){
+                    int targetRank = typeRanks[i];
+                    int targetWorkload;
+                    if(targetRank == (numProcesses-1)){
+                        targetWorkload = types.size() - (targetRank*workloadPerProcess);
+                    } else {
+                        targetWorkload = workloadPerProcess;
+                    }
+                    int targetPosition = i - targetRank * workloadPerProcess;
+                    for(int j = 0; j < finalWorkload; j++ ){
+                        int virtualOutputPosition = targetPosition + j * targetWorkload;
+                    
+                        virtualOutputs[targetRank][virtualOutputPosition] = typeComputations[j]->getVirtualOutputForType(typeIds[i]);
+                    }
+                
+                }
+            } else if (typeAndNodeGranularity){ // finer granularity, one array for each type and node representing virtual nodes for each type and node (as a couple)    
+                // fill the arrays, the source types and the virtual output nodes were resolved before the iterations
+                for (int targetRank = 0; targetRank < numProcesses; targetRank++){
+                    auto virtualOutputSources = ranksPairVirtualOutputSources.find(std::make_pair(rank, targetRank));
+                    if(virtualOutputSources != ranksPairVirtualOutputSources.end()){
+                        for(uint i = 0; i < virtualOutputSources->second.size(); i++){
+                            const auto& [sourceTypePosition, virtualOutputNode] = virtualOutputSources->second[i];
+                            virtualOutputs[targetRank][i] = typeComputations[sourceTypePosition]->getOutputNodeValue(virtualOutputNode);
+                        }
+                    }
+                        
                 }
             } else {
-                // send only the virtual outputs for the types granularity (v-out for each type
+                if(rank==0)logger.printError("virtual nodes granularity is not any of the types. virtual nodes granularity available are type and typeAndNode");
+                return abortRuns();
             }
-        }
 
-        // receive outputs from the other processes and update the input
-        for(int sourceRank = 0; sourceRank < numProcesses; sourceRank++){
-            std::pair<int, int> ranksPair = std::make_pair(sourceRank, rank);
-            if(ranksPairMappedVirtualNodesVectors.contains(ranksPair)){
-                logger.printLog(true,"receiving virtuals outputs from process ", sourceRank, " to process ", rank);
-                try{
-                    MPI_Wait(&request[sourceRank], MPI_STATUS_IGNORE);
-                } catch(const std::exception& e){
-                    std::cerr << e.what() << std::endl;
-                    logger.printError("error in waiting for virtual outputs from process ") << sourceRank << " to process " << rank << std::endl;
-                    return 1;
+
+        
+
+
+            // reset virtual outputs if specified, should work since virtual outputs are assigned before
+            if(resetVirtualOutputs){
+                for(int i = 0; i < finalWorkload; i++){
+                    typeComputations[i]->resetVirtualOutputs();
                 }
-                logger.printLog(true,"received virtual outputs from process ", sourceRank, " to process ", rank);
             }
-            // source workload and virtual outputs decomposition on the target
 
-            int sourceWorkload;
-            if(sourceRank == (numProcesses-1)){
-                sourceWorkload = types.size() - (sourceRank*workloadPerProcess);
-            } else {
-                sourceWorkload = workloadPerProcess;
+
+
+            // preliminary asynchronous receive
+        
+            // receive the virtual outputs from the other processes
+            MPI_Request request[numProcesses];
+            for(int i = 0; i < numProcesses; i++){
+                int sourceRank = i;
+                // receive only the virtual outputs for the types granularity (v-out for each type), or the full vectors for each pair of source type and target type
+                if(typeAndNodeGranularity || typeGranularity){
+                    std::pair<int, int> keyRanks = std::make_pair(sourceRank, rank);
+                    if(ranksPairMappedVirtualNodesVectors.contains(keyRanks)){
+                        MPI_Irecv(rankVirtualInputsBuffer[sourceRank], rankVirtualInputsSizes[sourceRank], MPI_DOUBLE, sourceRank, 0, typesCommunicator, &request[sourceRank]);
+                    }
+                } else {
+                    // OTHER CASES NOT IMPLEMENTED YET
+                }
             }
-            if(virtualNodesGranularity == "type"){
-                for(int isource = 0; isource < sourceWorkload; isource++){
-                    for(int ilocal = 0; ilocal < finalWorkload; ilocal++){
-                        int virtualInputPosition = ilocal + isource * finalWorkload;
-                        int localTypePosition = ilocal + startIdx;
-                        int sourceTypePosition = isource + sourceRank*workloadPerProcess;
-                        std::pair<std::string,std::string> keyTypes = std::make_pair(types[localTypePosition], types[sourceTypePosition]);
-                        if(quantizationMethod=="single"){
-                            if(setDoubleContainsInterval(interactionBetweenTypesMap[keyTypes], iterationInterType* timestep, (iterationInterType + 1)* timestep)){
-                                // logger << "[TEST] contact times for types " << types[localTypePosition] << " and " << types[sourceTypePosition] << " are ";
-                                // for(auto time: interactionBetweenTypesMap[keyTypes]){
-                                //     logger << time << ", ";
-                                // } 
-                                // logger << std::endl;
-                                if(localTypePosition==sourceTypePosition){
-                                    if(sameTypeCommunication) typeComputations[ilocal]->setInputVinForType(types[sourceTypePosition], rankVirtualInputsBuffer[sourceRank][virtualInputPosition]);
-                                } else {
-                                    typeComputations[ilocal]->setInputVinForType(types[sourceTypePosition], rankVirtualInputsBuffer[sourceRank][virtualInputPosition]);
-                                }
-                            }
-                        }else if(quantizationMethod=="multiple"){
-                            int countIntervalWidth = setDoubleIntervalWidth(interactionBetweenTypesMap[keyTypes], iterationInterType* timestep, (iterationInterType + 1)* timestep);
-                            if(countIntervalWidth>0){
-                                double newValue = rankVirtualInputsBuffer[sourceRank][virtualInputPosition]*countIntervalWidth;
-                                if(localTypePosition==sourceTypePosition){
-                                    if(sameTypeCommunication) typeComputations[ilocal]->setInputVinForType(types[sourceTypePosition], newValue);
-                                } else {
-                                    typeComputations[ilocal]->setInputVinForType(types[sourceTypePosition], newValue);
-                                }
-                            }
-                        } else {
-                            logger.printError("quantization method is not any of the types. quantization method available are single and multiple");
-                            return 1;
+
+    
+
+            // send the virtual outputs to the other processes
+            for(int targetRank = 0; targetRank < numProcesses; targetRank++){
+                //sending virtual outputs to target cell
+                // int targetStartIdx = j * workloadPerProcess;
+                // int targetEndIdx = (j == numProcesses - 1) ? types.size() : (j + 1) * workloadPerProcess;
+                // logger << "[LOG] sending virtual output from type " << types[startIdx] << " to type " << types[endIdx-1] << " from process " << rank << " to process " << j << " from type " << types[targetStartIdx] << " to type " << types[targetEndIdx-1] << std::endl;
+            
+                //synchronized communication will lead to deadlocks with this type of implementation
+                if(typeAndNodeGranularity || typeGranularity){
+                    //send the subvectors of the virtual outputs for the combination of types and nodes
+                    std::pair<int, int> keyRanks = std::make_pair(rank, targetRank);
+                    if(ranksPairMappedVirtualNodesVectors.contains(keyRanks)){
+                        try
+                        {
+                            MPI_Send(virtualOutputs.at(targetRank), rankVirtualOutputsSizes[targetRank], MPI_DOUBLE, targetRank, 0, typesCommunicator);
+                        }
+                        catch(const std::exception& e)
+                        {
+                            std::cerr << e.what() << std::endl;
+                            logger.printError("error in sending virtual outputs from process ") << rank << " to process " << targetRank << std::endl;
+                            return abortRuns();
                         }
+                        logger.printLog(true,"sent virtual outputs from process ", rank, " to process ", targetRank);
                     }
+                } else {
+                    // send only the virtual outputs for the types granularity (v-out for each type
                 }
-            } else if (virtualNodesGranularity == "node"){
-                if(rank==0)logger.printError("virtual nodes granularity is not supported yet: aborting");
-                return 1;
-            } else if (virtualNodesGranularity == "typeAndNode"){
-                // logic of reading the subvectors of the virtual inputs
-
-                // use ranksPairMappedVirtualNodesVectors to get all the information needed to update the input
-                int targetRank = rank;
-                std::pair<int,int> ranksPair = std::make_pair(sourceRank,targetRank);
+            }
 
+            // receive outputs from the other processes and update the input
+            for(int sourceRank = 0; sourceRank < numProcesses; sourceRank++){
+                std::pair<int, int> ranksPair = std::make_pair(sourceRank, rank);
                 if(ranksPairMappedVirtualNodesVectors.contains(ranksPair)){
+                    logger.printLog(true,"receiving virtuals outputs from process ", sourceRank, " to process ", rank);
+                    try{
+                        MPI_Wait(&request[sourceRank], MPI_STATUS_IGNORE);
+                    } catch(const std::exception& e){
+                        std::cerr << e.what() << std::endl;
+                        logger.printError("error in waiting for virtual outputs from process ") << sourceRank << " to process " << rank << std::endl;
+                        return abortRuns();
+                    }
+                    logger.printLog(true,"received virtual outputs from process ", sourceRank, " to process ", rank);
+                }
+                // source workload and virtual outputs decomposition on the target
 
-                    for(uint i = 0; i < ranksPairMappedVirtualNodesVectors[ranksPair].size(); i++){
-                        
-                        std::pair<std::string, std::string> virtualNodes = ranksPairMappedVirtualNodesVectors[ranksPair][i];
-                        std::string virtualOutputNodeName = virtualNodes.first;
-                        std::string virtualInputNodeName = virtualNodes.second;
-                        std::vector<std::string> virtualOutputNodeNameSplitted = splitVirtualNodeStringIntoVector(virtualOutputNodeName);
-                        if(virtualOutputNodeNameSplitted.size()!=3) throw std::runtime_error("main:: virtual output node name is not in the correct format: " + virtualOutputNodeName);
-                        std::string targetType = virtualOutputNodeNameSplitted[1];
-                        std::string targetNodeName = virtualOutputNodeNameSplitted[2];
-
-                        std::vector<std::string> virtualInputNodeNameSplitted = splitVirtualNodeStringIntoVector(virtualInputNodeName);
-                        if(virtualInputNodeNameSplitted.size()!=3) throw std::runtime_error("main:: virtual input node name is not in the correct format: " + virtualInputNodeName);
-                        std::string sourceType = virtualInputNodeNameSplitted[1];
-                        std::string sourceNodeName = virtualInputNodeNameSplitted[2];
-
-                        // get local target index for typeComputation
-                        int targetTypeIndex = -1;
-                        for(int i = 0; i < finalWorkload; i++){
-                            if(types[i+startIdx] == targetType){
-                                targetTypeIndex = i;
-                                break;
-                            }
-                        }
-
-                        if(targetTypeIndex == -1) throw std::runtime_error("main:: target type index not found for type: " + targetType);
-                        std::tuple<std::string, std::string, std::string, std::string> interactionKey = std::make_tuple(sourceNodeName, targetNodeName, sourceType, targetType);
-                        if(interactionBetweenTypesFinerMap.contains(interactionKey)){
-                            if(quantizationMethod=="single"){
-                                if(setDoubleContainsInterval(interactionBetweenTypesFinerMap[interactionKey], iterationInterType* timestep, (iterationInterType + 1)* timestep)){
-                                    double newValue = rankVirtualInputsBuffer[sourceRank][i];
-                                    try{
-                                        if(sourceType == targetType){
-                                            if(sameTypeCommunication) typeComputations[targetTypeIndex ]->setInputNodeValue(virtualInputNodeName, newValue);
-                                        } else {
-                                            typeComputations[targetTypeIndex]->setInputNodeValue(virtualInputNodeName, newValue);
-                                        }
-                                    } catch(const std::exception& e){
-                                        std::cerr << e.what() << std::endl;
-                                        logger.printError("error in setting input for virtual nodes from process: ")<< sourceRank<< " to process "<< targetRank << " for virtual nodes: " << virtualInputNodeName << " and " << virtualOutputNodeName << std::endl;
-                                        return 1;
+                int sourceWorkload;
+                if(sourceRank == (numProcesses-1)){
+                    sourceWorkload = types.size() - (sourceRank*workloadPerProcess);
+                } else {
+                    sourceWorkload = workloadPerProcess;
+                }
+                if(typeGranularity){
+                    for(int isource = 0; isource < sourceWorkload; isource++){
+                        for(int ilocal = 0; ilocal < finalWorkload; ilocal++){
+                            int virtualInputPosition = ilocal + isource * finalWorkload;
+                            int localTypePosition = ilocal + startIdx;
+                            int sourceTypePosition = isource + sourceRank*workloadPerProcess;
+                            const std::set<double>* contactTimes = localTypesContactTimes[ilocal][sourceTypePosition];
+                            if(singleQuantization){
+                                if(contactTimes != nullptr && setDoubleContainsInterval(*contactTimes, iterationInterType* timestep, (iterationInterType + 1)* timestep)){
+                                    if(localTypePosition==sourceTypePosition){
+                                        if(sameTypeCommunication) typeComputations[ilocal]->setInputVinForType(typeIds[sourceTypePosition], rankVirtualInputsBuffer[sourceRank][virtualInputPosition]);
+                                    } else {
+                                        typeComputations[ilocal]->setInputVinForType(typeIds[sourceTypePosition], rankVirtualInputsBuffer[sourceRank][virtualInputPosition]);
                                     }
-                                } else {
-                                    // // TESTING
-                                    // std::cout << "[DEBUG] rank: " << rank << " interaction between nodes " << sourceNodeName << " and " << targetNodeName << " for types " << sourceType << " and " << targetType << " have no contact time for inter iteration "<< iterationInterType << std::endl;
-                                    // // TESTING
                                 }
-                            } else if(quantizationMethod=="multiple"){
-                                int countIntervalWidth = setDoubleIntervalWidth(interactionBetweenTypesFinerMap[interactionKey], iterationInterType* timestep, (iterationInterType + 1)* timestep);
+                            }else if(multipleQuantization){
+                                int countIntervalWidth = contactTimes != nullptr ? setDoubleIntervalWidth(*contactTimes, iterationInterType* timestep, (iterationInterType + 1)* timestep) : 0;
                                 if(countIntervalWidth>0){
-                                    double newValue = rankVirtualInputsBuffer[sourceRank][i]*countIntervalWidth;
-                                    try{
-                                        if(sourceType == targetType){
-                                            if(sameTypeCommunication) typeComputations[targetTypeIndex ]->setInputNodeValue(virtualInputNodeName, newValue);
-                                        } else {
-                                            typeComputations[targetTypeIndex]->setInputNodeValue(virtualInputNodeName, newValue);
-                                        }
-                                    } catch(const std::exception& e){
-                                        std::cerr << e.what() << std::endl;
-                                        logger.printError("error in setting input for virtual nodes from process: ")<< sourceRank<< " to process "<< targetRank << " for virtual nodes: " << virtualInputNodeName << " and " << virtualOutputNodeName << std::endl;
-                                        return 1;
+                                    double newValue = rankVirtualInputsBuffer[sourceRank][virtualInputPosition]*countIntervalWidth;
+                                    if(localTypePosition==sourceTypePosition){
+                                        if(sameTypeCommunication) typeComputations[ilocal]->setInputVinForType(typeIds[sourceTypePosition], newValue);
+                                    } else {
+                                        typeComputations[ilocal]->setInputVinForType(typeIds[sourceTypePosition], newValue);
                                     }
-                                } else {
-                                    // // TESTING
-                                    // std::cout << "[DEBUG] rank: " << rank << " interaction between nodes " << sourceNodeName << " and " << targetNodeName << " for types " << sourceType << " and " << targetType << " have no contact time for inter iteration "<< iterationInterType << std::endl;
-                                    // // TESTING
                                 }
                             } else {
                                 logger.printError("quantization method is not any of the types. quantization method available are single and multiple");
-                                return 1;
+                                return abortRuns();
                             }
-                        } else {
-                            logger.printError("interaction between nodes: ") << sourceNodeName << " and " << targetNodeName << " for types " << sourceType << " and " << targetType << " is not present in the interactionBetweenTypesFinerMap" << std::endl;
-                            logger.printError("aborting") << std::endl;
-                            return 1;
                         }
+                    }
+                } else if (virtualNodesGranularity == "node"){
+                    if(rank==0)logger.printError("virtual nodes granularity is not supported yet: aborting");
+                    return abortRuns();
+                } else if (typeAndNodeGranularity){
+                    // logic of reading the subvectors of the virtual inputs
+
+                    // the target types, the virtual input nodes and the contact times of the subvector were resolved before the iterations
+                    int targetRank = rank;
+                    auto virtualInputTargets = ranksPairVirtualInputTargets.find(std::make_pair(sourceRank,targetRank));
+
+                    if(virtualInputTargets != ranksPairVirtualInputTargets.end()){
+
+                        for(uint i = 0; i < virtualInputTargets->second.size(); i++){
+                            const auto& [targetTypeIndex, virtualInputNode, contactTimes, sameType] = virtualInputTargets->second[i];
+                            double newValue;
+                            if(singleQuantization){
+                                if(!setDoubleContainsInterval(*contactTimes, iterationInterType* timestep, (iterationInterType + 1)* timestep)){
+                                    continue;
+                                }
+                                newValue = rankVirtualInputsBuffer[sourceRank][i];
+                            } else if(multipleQuantization){
+                                int countIntervalWidth = setDoubleIntervalWidth(*contactTimes, iterationInterType* timestep, (iterationInterType + 1)* timestep);
+                                if(countIntervalWidth<=0){
+                                    continue;
+                                }
+                                newValue = rankVirtualInputsBuffer[sourceRank][i]*countIntervalWidth;
+                            } else {
+                                logger.printError("quantization method is not any of the types. quantization method available are single and multiple");
+                                return abortRuns();
+                            }
+                            try{
+                                if(!sameType || sameTypeCommunication){
+                                    typeComputations[targetTypeIndex]->setInputNodeValue(virtualInputNode, newValue);
+                                }
+                            } catch(const std::exception& e){
+                                std::cerr << e.what() << std::endl;
+                                logger.printError("error in setting input for virtual nodes from process: ")<< sourceRank<< " to process "<< targetRank << " for virtual node: " << nameInterner.getName(virtualInputNode) << std::endl;
+                                return abortRuns();
+                            }
+                        }
+                    }
+                }
+            }
+        }
 
-                        
+        // save into the iterationMatrix files for every type if the option was set
+        if (outputFormat == "iterationMatrix") {
+            logger << "[LOG] saving the iteration matrices for types in rank " << rank<<std::endl;
+            // create the output folder if it does not exist
+            std::string outputFolderNameMatrices = scenarioOutputFoldername + "/iterationMatrices";
+            if (!std::filesystem::exists(outputFolderNameMatrices)) {
+                std::filesystem::create_directory(outputFolderNameMatrices);
+            }
+            // save all the iteration values in a single file for every type
+            for(int i = 0; i < finalWorkload; i++){
+                std::string type = types[i+startIdx];
+                saveOutputMatrix(outputFolderNameMatrices, outputMatrices[type], outputMatricesRowNames[type], intertypeIterations,intratypeIterations, timestep,type);
+                // the matrices are created again by the next scenario
+                delete outputMatrices[type];
+                outputMatrices[type] = nullptr;
+            }
+        }
+
+        // save the statistics of every type after the last replicate
+        if(outputFormat == "replicateStatistics" && replicateIndex == static_cast<uint>(numReplicates) - 1){
+            logger << "[LOG] saving the statistics over the replicates for types in rank " << rank << std::endl;
+            std::vector<double> iterationTimes(intertypeIterations*intratypeIterations);
+            for(size_t iteration = 0; iteration < iterationTimes.size(); iteration++){
+                iterationTimes[iteration] = iteration*(timestep/intratypeIterations);
+            }
+            for(int i = 0; i < finalWorkload; i++){
+                try{
+                    replicateStatistics[i].save(scenarioOutputFoldername + "/replicateStatistics", types[i+startIdx], typeComputations[i]->getAugmentedGraph()->getNodeNames(), iterationTimes);
+                } catch(const std::invalid_argument& e){
+                    logger.printError(e.what())<<std::endl;
+                    return abortRuns();
+                }
+            }
+        }
+
+        // save the error matrices of the types of the process, the RMSE of every type and of all the types is aggregated in the first process
+        if(runErrorMatrices != nullptr){
+            std::string outputFolderNameErrors = scenarioOutputFoldername + "/errorMatrices";
+            // sum of the squared errors and number of errors for every type (0 for the types of the other processes)
+            std::vector<double> typesSumSquaredErrors(types.size(), 0);
+            std::vector<double> typesNumErrors(types.size(), 0);
+            for(int i = 0; i < finalWorkload; i++){
+                auto errorMatrix = runErrorMatrices->find(types[i+startIdx]);
+                if(errorMatrix != runErrorMatrices->end()){
+                    try{
+                        errorMatrix->second.save(outputFolderNameErrors + "/" + types[i+startIdx] + ".tsv");
+                    } catch(const std::invalid_argument& e){
+                        logger.printError(e.what())<<std::endl;
+                        return abortRuns();
+                    }
+                    typesSumSquaredErrors[i+startIdx] = errorMatrix->second.getSumSquaredErrors();
+                    typesNumErrors[i+startIdx] = errorMatrix->second.getNumErrors();
+                }
+            }
+            std::vector<double> totalSumSquaredErrors(types.size(), 0);
+            std::vector<double> totalNumErrors(types.size(), 0);
+            MPI_Reduce(typesSumSquaredErrors.data(), totalSumSquaredErrors.data(), types.size(), MPI_DOUBLE, MPI_SUM, 0, typesCommunicator);
+            MPI_Reduce(typesNumErrors.data(), totalNumErrors.data(), types.size(), MPI_DOUBLE, MPI_SUM, 0, typesCommunicator);
+            if(rank == 0){
+                std::ofstream rmseFile(outputFolderNameErrors + "/rmse.tsv", std::ios::out | std::ios::trunc);
+                if(!rmseFile.is_open()){
+                    logger.printError("unable to open the file " + outputFolderNameErrors + "/rmse.tsv: aborting")<<std::endl;
+                    return abortRuns();
+                }
+                rmseFile.precision(10);
+                rmseFile << "type\trmse\tnumErrors" << std::endl;
+                double sumSquaredErrors = 0;
+                double numErrors = 0;
+                for(uint typeIndex = 0; typeIndex < types.size(); typeIndex++){
+                    if(totalNumErrors[typeIndex] > 0){
+                        rmseFile << types[typeIndex] << "\t" << std::sqrt(totalSumSquaredErrors[typeIndex] / totalNumErrors[typeIndex]) << "\t" << totalNumErrors[typeIndex] << std::endl;
+                        sumSquaredErrors += totalSumSquaredErrors[typeIndex];
+                        numErrors += totalNumErrors[typeIndex];
+                    }
+                }
+                double totalRmse = numErrors > 0 ? std::sqrt(sumSquaredErrors / numErrors) : std::numeric_limits<double>::quiet_NaN();
+                rmseFile << "total\t" << totalRmse << "\t" << numErrors << std::endl;
+                logger << "[LOG] RMSE against the reference time series: " << totalRmse << " (" << numErrors << " errors)" << std::endl;
+            }
+        }
+
+        // save the gradients of the sum of the squared errors of every type with respect to its parameters
+        if(sensitivities && runErrorMatrices != nullptr){
+            for(int i = 0; i < finalWorkload; i++){
+                if(!runErrorMatrices->contains(types[i+startIdx])){
+                    continue;
+                }
+                std::string gradientFilename = scenarioOutputFoldername + "/gradients/" + types[i+startIdx] + ".tsv";
+                std::ofstream gradientFile(gradientFilename, std::ios::out | std::ios::trunc);
+                if(!gradientFile.is_open()){
+                    logger.printError("unable to open the file " + gradientFilename + ": aborting")<<std::endl;
+                    return abortRuns();
+                }
+                gradientFile.precision(10);
+                gradientFile << "parameter\tgradient" << std::endl;
+                const std::vector<SensitivityParameter>& parameters = typeComputations[i]->getSensitivityParameters();
+                for(size_t parameter = 0; parameter < parameters.size(); parameter++){
+                    gradientFile << parameters[parameter].name << "\t" << typeGradients[types[i+startIdx]](parameter) << std::endl;
+                }
+            }
+        }
+
+        // select the candidate of the window with the lowest RMSE, all the processes need the RMSE of all the types to keep the same state
+        if(vm.count("fittingWindows")){
+            double localErrors[2] = {0, 0};
+            for(const auto& [type, errorMatrix] : *runErrorMatrices){
+                localErrors[0] += errorMatrix.getSumSquaredErrors();
+                localErrors[1] += errorMatrix.getNumErrors();
+            }
+            double totalErrors[2] = {0, 0};
+            MPI_Allreduce(localErrors, totalErrors, 2, MPI_DOUBLE, MPI_SUM, typesCommunicator);
+            double windowRmse = totalErrors[1] > 0 ? std::sqrt(totalErrors[0] / totalErrors[1]) : std::numeric_limits<double>::quiet_NaN();
+            // the first candidate of the group is kept if no candidate of the group has errors in the window
+            if(candidateIndex == static_cast<uint>(candidateGroup) || windowRmse < windowBestRmse || (std::isnan(windowBestRmse) && !std::isnan(windowRmse))){
+                windowBestRmse = windowRmse;
+                windowBestCandidate = candidateIndex;
+                for(int i = 0; i < finalWorkload; i++){
+                    windowBestStates[i] = typeComputations[i]->getInputAugmented();
+                }
+            }
+            // the state at the end of the window of the selected candidate is the start of the next window
+            if(candidateIndex + candidateGroups >= candidateNames.size()){
+                if(candidateGroups > 1){
+                    // the candidate with the lowest RMSE over the groups is selected, the first one if they are equal or no candidate has errors
+                    struct {double rmse; int candidate;} groupBest, best;
+                    groupBest.rmse = std::isnan(windowBestRmse) ? std::numeric_limits<double>::infinity() : windowBestRmse;
+                    groupBest.candidate = windowBestCandidate;
+                    MPI_Allreduce(&groupBest, &best, 1, MPI_DOUBLE_INT, MPI_MINLOC, candidateGroupsCommunicator);
+                    windowBestRmse = std::isinf(best.rmse) ? std::numeric_limits<double>::quiet_NaN() : best.rmse;
+                    windowBestCandidate = best.candidate;
+                    // the group of the selected candidate sends its states to the processes with the same types in the other groups
+                    for(int i = 0; i < finalWorkload; i++){
+                        MPI_Bcast(windowBestStates[i].data(), windowBestStates[i].size(), MPI_DOUBLE, windowBestCandidate % candidateGroups, candidateGroupsCommunicator);
                     }
                 }
+                if(worldRank == 0){
+                    logger << "[LOG] fitting window " << windowIndex + 1 << " selected candidate " << candidateNames[windowBestCandidate] << " with RMSE " << windowBestRmse << std::endl;
+                    fittingWindowsFile << windowNames[windowIndex] << "\t" << startingInterIteration*timestep << "\t" << endingInterIteration*timestep << "\t" << candidateNames[windowBestCandidate] << "\t" << windowBestRmse << std::endl;
+                }
+                std::swap(windowStartStates, windowBestStates);
             }
         }
     }
 
+    if(trajectoryCache && rank==0){
+        logger << "[LOG] trajectoryCache restarted " << trajectoryCache->getHits() << " runs from a saved state, " << trajectoryCache->getMisses() << " searches did not find one" << std::endl;
+    }
+
     // save the augmented graph for every type if the option was set
-    if (saveAugmentedNetworks) {
+    if (saveAugmentedNetworks && candidateGroup == 0) {
         logger << "[LOG] saving the augmented graphs for types in rank " << rank<<std::endl;
         // create the output folder if it does not exist
         std::string outputFolderNameGraphs = outputFoldername + "/augmentedGraphs";
@@ -1880,33 +3082,20 @@ int main(int argc, char** argv) {
         if (rankVirtualInputsBuffer.at(i) != nullptr) delete[] rankVirtualInputsBuffer.at(i);
     }
 
-    // save into the iterationMatrix files for every type if the option was set
-    if (outputFormat == "iterationMatrix") {
-        logger << "[LOG] saving the iteration matrices for types in rank " << rank<<std::endl;
-        // create the output folder if it does not exist
-        std::string outputFolderNameMatrices = outputFoldername + "/iterationMatrices";
-        if (!std::filesystem::exists(outputFolderNameMatrices)) {
-            std::filesystem::create_directory(outputFolderNameMatrices);
-        }
-        // save all the iteration values in a single file for every type
-        for(int i = 0; i < finalWorkload; i++){
-            std::string type = types[i+startIdx];
-            saveOutputMatrix(outputFolderNameMatrices, outputMatrices[type], outputMatricesRowNames[type], intertypeIterations,intratypeIterations, timestep,type);
-        }
-    }
-
     logger.printLog(true,"computation ended for rank ", rank, " with no errors");
+    MPI_Comm_free(&typesCommunicator);
+    MPI_Comm_free(&candidateGroupsCommunicator);
     MPI_Finalize();
 
     logger.printLog(true,"MPI finalized for rank ", rank);
 
     // take ending time after the computation
     auto end = std::chrono::steady_clock::now();
-    if(rank == 0){
+    if(worldRank == 0){
         if(vm.count("savePerformance")){
             logger << "[LOG] saving performance"<<std::endl;
             std::ofstream performanceFile;
-            int numberProcesses = numProcesses;
+            int numberProcesses = worldNumProcesses;
             int numberTypes = types.size();
             int numberIterations = intratypeIterations * intertypeIterations;
             performanceFile.open (performanceFilename, std::ios::out | std::ios::app);
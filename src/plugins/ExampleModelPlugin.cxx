@@ -0,0 +1,96 @@
+/**
+ * @file ExampleModelPlugin.cxx
+ * @ingroup Core
+ * @brief Example of a model plugin, loaded at runtime with the --modelPlugin option.
+ * @details The plugin implements the three kinds of models:
+ * - dissipation: the term is p[0] * input (p[0] defaults to 0.5)
+ * - conservation: the term is p[0] * (Wstar * q) % input, the same as ConservationModel with a constant scale (p[0] defaults to 0.5)
+ * - propagation: the term is p[0] * (A^T * input), where A is the adjacency matrix (p[0] defaults to 1)
+ * @details The plugin only includes ModelPluginABI.hxx and can be built outside the MASFENON sources, for example with
+ * g++ -O3 -shared -fPIC -I<masfenon>/src ExampleModelPlugin.cxx -o libexampleModelPlugin.so
+ */
+#include "computation/ModelPluginABI.hxx"
+#include <vector>
+
+namespace {
+    struct ExampleState{
+        double scale;
+        std::vector<double> adjacency; // column-major numNodes x numNodes, only for the propagation model
+    };
+
+    void* create(int kind, size_t numNodes, const double* adjacency, const double* parameters, size_t numParameters){
+        double defaultScale = kind == MASFENON_MODEL_PROPAGATION ? 1.0 : 0.5;
+        ExampleState* state = new ExampleState{numParameters > 0 ? parameters[0] : defaultScale, {}};
+        if(adjacency != nullptr){
+            state->adjacency.assign(adjacency, adjacency + numNodes * numNodes);
+        }
+        return state;
+    }
+
+    void destroy(void* state){
+        delete static_cast<ExampleState*>(state);
+    }
+
+    int dissipationTerm(void* state, const double* input, double* output, size_t numNodes, double time){
+        const double scale = static_cast<ExampleState*>(state)->scale;
+        for(size_t i = 0; i < numNodes; i++){
+            output[i] = scale * input[i];
+        }
+        return 0;
+    }
+
+    int conservationTerm(void* state, const double* input, const double* Wstar, const double* q, double* output, size_t numNodes, double time){
+        const double scale = static_cast<ExampleState*>(state)->scale;
+        for(size_t i = 0; i < numNodes; i++){
+            output[i] = 0;
+        }
+        // column by column, to read Wstar contiguously
+        for(size_t j = 0; j < numNodes; j++){
+            const double* column = Wstar + j * numNodes;
+            for(size_t i = 0; i < numNodes; i++){
+                output[i] += column[i] * q[j];
+            }
+        }
+        for(size_t i = 0; i < numNodes; i++){
+            output[i] *= scale * input[i];
+        }
+        return 0;
+    }
+
+    int propagationTerm(void* state, const double* input, double* output, size_t numNodes, double time){
+        const ExampleState* exampleState = static_cast<ExampleState*>(state);
+        if(exampleState->adjacency.size() != numNodes * numNodes){
+            return 1;
+        }
+        // output = scale * A^T * input, the column i of A holds the incoming edges of i
+        for(size_t i = 0; i < numNodes; i++){
+            const double* column = exampleState->adjacency.data() + i * numNodes;
+            double sum = 0;
+            for(size_t j = 0; j < numNodes; j++){
+                sum += column[j] * input[j];
+            }
+            output[i] = exampleState->scale * sum;
+        }
+        return 0;
+    }
+
+    int updateAdjacency(void* state, const double* adjacency, size_t numNodes){
+        static_cast<ExampleState*>(state)->adjacency.assign(adjacency, adjacency + numNodes * numNodes);
+        return 0;
+    }
+
+    const MasfenonModelPlugin descriptor = {
+        MASFENON_MODEL_PLUGIN_ABI_VERSION,
+        "example",
+        create,
+        destroy,
+        dissipationTerm,
+        conservationTerm,
+        propagationTerm,
+        updateAdjacency
+    };
+}
+
+extern "C" const MasfenonModelPlugin* masfenonModelPlugin(void){
+    return &descriptor;
+}
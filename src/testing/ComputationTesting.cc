@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include "computation/Computation.hxx"
+#include "utils/NameInterner.hxx"
 #include "data_structures/Matrix.hxx"
 #include "utils/mathUtilities.hxx"
 #include "computation/DissipationModel.hxx"
@@ -184,7 +185,7 @@ TEST_F(ComputationTesting, testingAddingEdgesArmaInitialized) {
                 normalizationFactors[i] += betaToAdd; 
             }
         }
-    auto wtransArma = computationTest.getAugmentedGraph()->adjMatrix.transpose().normalizeByVectorRow(normalizationFactors).asArmadilloMatrix();
+    auto wtransArma = computationTest.getAugmentedGraph()->getAdjacencyMatrix().transpose().normalizeByVectorRow(normalizationFactors).asArmadilloMatrix();
     EXPECT_EQ(inputArma.n_cols, 1);
     EXPECT_EQ(inputArma.n_rows, 12);
     EXPECT_EQ(wtransArma.n_cols, 12);
@@ -678,4 +679,115 @@ TEST_F(ComputationTesting,testNewAugmentedVinputZerosHalfDissipationHalfConserva
 
 //TESTING IF NODE VALUES FOR v-input nodes are the same as the previous iteration
 
-//TODO TESTING FOR THROWS
\ No newline at end of file
+//TODO TESTING FOR THROWS
+TEST_F(ComputationTesting,testScheduledEdgeWeightUpdates){
+    Computation computationTest;
+    computationTest.assign(*c1);
+    computationTest.augmentGraph(cellTypes);
+    computationTest.addEdges(virtualInputEdges,virtualInputEdgesValues);
+    computationTest.addEdges(virtualOutputEdges,virtualOutputEdgesValues);
+    PropagationModel* propagationModel = new PropagationModelOriginal(computationTest.getAugmentedGraph());
+    computationTest.setConservationModel(conservationModelHalf);
+    computationTest.setDissipationModel(dissipationModelNull);
+    computationTest.setPropagationModel(propagationModel);
+    std::vector<std::tuple<std::string,std::string,double>> newEdgeWeights{{"testGene1","testGene2",0.9},{"testGene1","testGene3",0.1}};
+    computationTest.scheduleEdgeWeightUpdates(0.5, newEdgeWeights);
+    // the update is not yet due
+    EXPECT_FALSE(computationTest.applyScheduledEdgeWeightUpdates(0.2));
+    EXPECT_DOUBLE_EQ(computationTest.getAugmentedGraph()->getEdgeWeight("testGene1","testGene2"),0.2);
+    auto perturbation = computationTest.computeAugmentedPerturbationEnhanced4(1);
+    EXPECT_DOUBLE_EQ(computationTest.getAugmentedGraph()->getEdgeWeight("testGene1","testGene2"),0.9);
+    EXPECT_DOUBLE_EQ(computationTest.getAugmentedGraph()->getEdgeWeight("testGene1","testGene3"),0.1);
+    // same computation with the operator built from scratch on the updated graph
+    Computation computationExpected;
+    computationExpected.assign(*c1);
+    computationExpected.augmentGraph(cellTypes);
+    computationExpected.addEdges(virtualInputEdges,virtualInputEdgesValues);
+    computationExpected.addEdges(virtualOutputEdges,virtualOutputEdgesValues);
+    computationExpected.getAugmentedGraph()->updateEdgeWeights(newEdgeWeights);
+    PropagationModel* propagationModelExpected = new PropagationModelOriginal(computationExpected.getAugmentedGraph());
+    computationExpected.setConservationModel(conservationModelHalf);
+    computationExpected.setDissipationModel(dissipationModelNull);
+    computationExpected.setPropagationModel(propagationModelExpected);
+    auto perturbationExpected = computationExpected.computeAugmentedPerturbationEnhanced4(1);
+    ASSERT_EQ(perturbation.size(), perturbationExpected.size());
+    for (uint i = 0; i< perturbation.size(); i++) {
+        EXPECT_NEAR(perturbation[i], perturbationExpected[i], 1e-10);
+    }
+    EXPECT_TRUE(arma::approx_equal(computationTest.getPseudoInverseAugmentedArma(), computationExpected.getPseudoInverseAugmentedArma(), "absdiff", 1e-10));
+    delete propagationModel;
+    delete propagationModelExpected;
+}
+
+TEST_F(ComputationTesting, edgeWeightUpdatesRecomputeSingularOperators){
+    // testGene1 -> testGene2 and testGene2 -> testGene1 with weight 1 make (I - W) singular once testGene1 -> testGene3 is zero
+    std::vector<double> cycleVector{0,1,1,
+                                    1,0,0,
+                                    0,0,0};
+    Matrix<double> cycleMatrix(cycleVector,3,3);
+    Computation computationTest(thisCellType,{0.1,0.2,0.3},cycleMatrix,{"testGene1","testGene2","testGene3"});
+    computationTest.augmentGraph(cellTypes);
+    EXPECT_TRUE(computationTest.isInvertibleAugmentedOperator());
+    computationTest.updateEdgeWeights({{"testGene1","testGene3",0}});
+    EXPECT_FALSE(computationTest.isInvertibleAugmentedOperator());
+    // the pseudoinverse of the singular operator is not an inverse, so it cannot be updated with rank-1 updates
+    computationTest.updateEdgeWeights({{"testGene1","testGene3",1}});
+    EXPECT_TRUE(computationTest.isInvertibleAugmentedOperator());
+    Computation computationExpected(thisCellType,{0.1,0.2,0.3},cycleMatrix,{"testGene1","testGene2","testGene3"});
+    computationExpected.augmentGraph(cellTypes);
+    EXPECT_TRUE(arma::approx_equal(computationTest.getPseudoInverseAugmentedArma(), computationExpected.getPseudoInverseAugmentedArma(), "absdiff", 1e-10));
+}
+
+TEST_F(ComputationTesting, virtualNodesByInternedNames){
+    Computation computationTest;
+    computationTest.assign(*c1);
+    computationTest.augmentGraph(cellTypes,virtualInputEdges,virtualInputEdgesValues,true);
+    NameInterner& interner = NameInterner::getInstance();
+    NameId type2 = interner.intern("testCell2");
+    NameId type3 = interner.intern("testCell3");
+    int vin2 = computationTest.getAugmentedGraph()->getIndexFromName("v-in:testCell2");
+    int vout3 = computationTest.getAugmentedGraph()->getIndexFromName("v-out:testCell3");
+    computationTest.setInputVinForType(type2, 0.7);
+    EXPECT_DOUBLE_EQ(computationTest.getInputAugmented()[vin2], 0.7);
+    EXPECT_DOUBLE_EQ(computationTest.getInputAugmentedArma()[vin2], 0.7);
+    // the names and the interned ids reach the same virtual node
+    computationTest.setInputVinForType("testCell2", 0.3);
+    EXPECT_DOUBLE_EQ(computationTest.getInputAugmented()[vin2], 0.3);
+    computationTest.setInputVoutForType(type3, 0.9);
+    EXPECT_DOUBLE_EQ(computationTest.getInputAugmentedArma()[vout3], 0.9);
+    computationTest.resetVirtualOutputs();
+    EXPECT_DOUBLE_EQ(computationTest.getInputAugmentedArma()[vout3], 0);
+    EXPECT_DOUBLE_EQ(computationTest.getInputAugmentedArma()[vin2], 0.3);
+    computationTest.setInputNodeValue(interner.intern("testGene3"), 0.25);
+    EXPECT_DOUBLE_EQ(computationTest.getInputNodeValue("testGene3"), 0.25);
+    EXPECT_THROW(computationTest.setInputVinForType(interner.intern("testCellNotPresent"), 0.1), std::out_of_range);
+    EXPECT_THROW(computationTest.setInputNodeValue(interner.intern("testGeneNotPresent"), 0.1), std::out_of_range);
+}
+
+TEST_F(ComputationTesting, virtualNodesOfTypesWithUnderscores){
+    Computation computationTest;
+    computationTest.assign(*c1);
+    computationTest.augmentGraphNoComputeInverse(std::vector<std::string>(), std::vector<std::pair<std::string,std::string>>(), std::vector<double>(), false);
+    std::vector<std::tuple<std::string,std::string,double>> edges{{"v-in:B_cell_gene_x","testGene1",0.5},
+                                                                  {"v-in:T_cell","testGene2",0.5},
+                                                                  {"testGene3","v-out:B_cell_gene_y",0.5}};
+    computationTest.addEdgesAndNodes(edges, false, false, {"B_cell","T_cell"});
+    int vinNode = computationTest.getAugmentedGraph()->getIndexFromName("v-in:B_cell_gene_x");
+    int vinType = computationTest.getAugmentedGraph()->getIndexFromName("v-in:T_cell");
+    int voutNode = computationTest.getAugmentedGraph()->getIndexFromName("v-out:B_cell_gene_y");
+    // the type is not split at the first "_", so both the type and the node keep their underscores
+    computationTest.setInputVinForType("B_cell", 0.7, "gene_x");
+    EXPECT_DOUBLE_EQ(computationTest.getInputAugmented()[vinNode], 0.7);
+    computationTest.setInputVinForType("T_cell", 0.4);
+    EXPECT_DOUBLE_EQ(computationTest.getInputAugmented()[vinType], 0.4);
+    computationTest.setInputVoutForType("B_cell", 0.2, "gene_y");
+    EXPECT_DOUBLE_EQ(computationTest.getInputAugmented()[voutNode], 0.2);
+    EXPECT_THROW(computationTest.setInputVinForType("B", 0.1, "cell_gene_x"), std::out_of_range);
+    // a node that was never interned is not silently replaced by the virtual node of the whole type
+    EXPECT_THROW(computationTest.setInputVinForType("T_cell", 0.1, "geneNeverInterned"), std::out_of_range);
+    EXPECT_THROW(computationTest.getVirtualInputForType("T_cell", "geneNeverInterned"), std::out_of_range);
+    EXPECT_DOUBLE_EQ(computationTest.getInputAugmented()[vinType], 0.4);
+    // a name that matches two known types is rejected instead of guessed
+    EXPECT_THROW(computationTest.addEdgesAndNodes({{"v-in:B_cell_gene_z","testGene1",0.5}}, false, false, {"B","B_cell"}), std::invalid_argument);
+    EXPECT_THROW(computationTest.addEdgesAndNodes({{"v-in:NK_gene_z","testGene1",0.5}}, false, false), std::invalid_argument);
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
+#include <armadillo>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include "computation/Computation.hxx"
@@ -9,6 +12,7 @@
 #include "computation/PropagationModel.hxx"
 #include "computation/PropagationModelOriginal.hxx"
 #include "computation/PropagationModelNeighbors.hxx"
+#include "computation/SensitivityParameter.hxx"
 #include "data_structures/WeightedEdgeGraph.hxx"
 #include "data_structures/Matrix.hxx"
 #include "utils/mathUtilities.hxx"
@@ -339,3 +343,168 @@ TEST_F(ComputationTestingPerturbation, computePerturbationIsCorrectDissipationCo
     }
 }
 
+
+TEST_F(ComputationTestingPerturbation, specializedModelsMatchGenericModels) {
+    Computation computationSpecialized, computationGeneric;
+    for(Computation* computation : {&computationSpecialized, &computationGeneric}){
+        computation->assign(*c1);
+        computation->augmentGraphNoComputeInverse(types);
+        computation->addEdges(virtualInputEdges,virtualInputEdgesValues);
+        computation->addEdges(virtualOutputEdges,virtualOutputEdgesValues);
+        computation->setPropagationModel(new PropagationModelNeighbors(computation->getAugmentedGraph()));
+    }
+    std::vector<std::pair<double,double>> scales{{0,0},{0.5,0},{0,0.3},{0.25,0.3}};
+    for(const auto& [dissipationScale, conservationScale] : scales){
+        DissipationModelScaled dissipationSpecialized(dissipationScale);
+        DissipationModelScaled dissipationGeneric([dissipationScale](double time)->double{return dissipationScale;});
+        ConservationModel conservationSpecialized(conservationScale);
+        ConservationModel conservationGeneric([conservationScale](double time)->double{return conservationScale;});
+        EXPECT_TRUE(dissipationSpecialized.getProperties().constantScale);
+        EXPECT_EQ(dissipationSpecialized.getProperties().identity, dissipationScale == 0);
+        EXPECT_EQ(conservationSpecialized.getProperties().zero, conservationScale == 0);
+        EXPECT_FALSE(conservationGeneric.getProperties().constantScale);
+        computationSpecialized.setDissipationModel(&dissipationSpecialized);
+        computationSpecialized.setConservationModel(&conservationSpecialized);
+        computationGeneric.setDissipationModel(&dissipationGeneric);
+        computationGeneric.setConservationModel(&conservationGeneric);
+        std::vector<double> result = computationSpecialized.computeAugmentedPerturbationEnhanced4(1,false);
+        std::vector<double> expected = computationGeneric.computeAugmentedPerturbationEnhanced4(1,false);
+        ASSERT_EQ(result.size(),expected.size());
+        for (uint i = 0; i < expected.size() ; i++) {
+            EXPECT_NEAR(result[i],expected[i],1e-12);
+        }
+        // the cached conservation weights are recomputed after the graph changes
+        computationSpecialized.updateEdgeWeights({{"node1","node2",0.7}});
+        computationGeneric.updateEdgeWeights({{"node1","node2",0.7}});
+        result = computationSpecialized.computeAugmentedPerturbationEnhanced4(2,false);
+        expected = computationGeneric.computeAugmentedPerturbationEnhanced4(2,false);
+        for (uint i = 0; i < expected.size() ; i++) {
+            EXPECT_NEAR(result[i],expected[i],1e-12);
+        }
+    }
+}
+
+TEST_F(ComputationTestingPerturbation, cachedNormalizedAdjacencyFollowsTheGraph) {
+    DissipationModelScaled dissipation(0.2);
+    ConservationModel conservationSpecialized(0.3);
+    ConservationModel conservationGeneric([](double time)->double{return 0.3;});
+    for(ConservationModel* conservation : {&conservationSpecialized, &conservationGeneric}){
+        Computation computation;
+        computation.assign(*c1);
+        computation.augmentGraphNoComputeInverse(types);
+        computation.addEdges(virtualInputEdges,virtualInputEdgesValues);
+        computation.addEdges(virtualOutputEdges,virtualOutputEdgesValues);
+        computation.setPropagationModel(new PropagationModelNeighbors(computation.getAugmentedGraph()));
+        computation.setDissipationModel(&dissipation);
+        computation.setConservationModel(conservation);
+        // the first step fills the cached Wstar, the update must discard it
+        computation.computeAugmentedPerturbationEnhanced4(1,false);
+        computation.updateEdgeWeights({{"node1","node2",0.7},{"node3","node4",0.1}});
+        // a copy of the updated computation normalizes the adjacency matrix from scratch
+        Computation reference;
+        reference.assign(computation);
+        reference.setPropagationModel(new PropagationModelNeighbors(reference.getAugmentedGraph()));
+        reference.setDissipationModel(&dissipation);
+        reference.setConservationModel(conservation);
+        std::vector<double> result = computation.computeAugmentedPerturbationEnhanced4(2,false);
+        std::vector<double> expected = reference.computeAugmentedPerturbationEnhanced4(2,false);
+        ASSERT_EQ(result.size(),expected.size());
+        for (uint i = 0; i < expected.size() ; i++) {
+            EXPECT_NEAR(result[i],expected[i],1e-12);
+        }
+    }
+}
+
+TEST_F(ComputationTestingPerturbation, sensitivitiesMatchFiniteDifferences) {
+    // one parameter for every model, each one is the scaling value of a single node
+    std::vector<SensitivityParameter> parameters(3);
+    parameters[0] = {"dissipation:node1", SensitivityTarget::dissipation, 0, [](double time)->double{return 1;}};
+    parameters[1] = {"propagation:node2", SensitivityTarget::propagation, 1, [](double time)->double{return 1 + 0.1*time;}};
+    parameters[2] = {"conservation:node4", SensitivityTarget::conservation, 3, [](double time)->double{return 1;}};
+    std::vector<double> parameterValues{0.3, 0.4, 0.2};
+    for(bool original : {false, true}){
+        // three steps with saturation, the output of every step is the input of the next one
+        auto simulate = [&](const std::vector<double>& values, arma::Mat<double>* sensitivities)-> std::vector<double>{
+            Computation computation;
+            computation.assign(*c1);
+            computation.augmentGraphNoComputeInverse(types);
+            computation.addEdges(virtualInputEdges,virtualInputEdgesValues);
+            computation.addEdges(virtualOutputEdges,virtualOutputEdgesValues);
+            arma::uword numNodes = computation.getAugmentedGraph()->getNumNodes();
+            arma::Col<double> dissipationScales = arma::ones<arma::Col<double>>(numNodes) * 0.1;
+            arma::Col<double> propagationScales = arma::ones<arma::Col<double>>(numNodes) * 0.5;
+            arma::Col<double> conservationScales = arma::ones<arma::Col<double>>(numNodes) * 0.05;
+            dissipationScales(0) = values[0];
+            propagationScales(1) = values[1];
+            conservationScales(3) = values[2];
+            DissipationModelScaled dissipation(std::function<arma::Col<double>(double)>([dissipationScales](double time)->arma::Col<double>{return dissipationScales;}));
+            ConservationModel conservation(std::function<arma::Col<double>(double)>([conservationScales](double time)->arma::Col<double>{return conservationScales;}));
+            std::function<arma::Col<double>(double)> propagationScaleFunction = [propagationScales](double time)->arma::Col<double>{return propagationScales * (1 + 0.1*time);};
+            std::unique_ptr<PropagationModel> propagation;
+            if(original){
+                propagation = std::make_unique<PropagationModelOriginal>(computation.getAugmentedGraph(), propagationScaleFunction);
+            } else {
+                propagation = std::make_unique<PropagationModelNeighbors>(computation.getAugmentedGraph(), propagationScaleFunction);
+            }
+            computation.setDissipationModel(&dissipation);
+            computation.setConservationModel(&conservation);
+            computation.setPropagationModel(propagation.get());
+            if(sensitivities != nullptr){
+                computation.setSensitivityParameters(parameters);
+            }
+            std::vector<double> saturationVector(numNodes, 2.5);
+            std::vector<double> result;
+            for(int step = 0; step < 3; step++){
+                result = computation.computeAugmentedPerturbationEnhanced4(step, true, saturationVector);
+                computation.updateInput(std::vector<double>(), true);
+            }
+            if(sensitivities != nullptr){
+                *sensitivities = computation.getSensitivities();
+            }
+            return result;
+        };
+        arma::Mat<double> sensitivities;
+        std::vector<double> result = simulate(parameterValues, &sensitivities);
+        ASSERT_EQ(sensitivities.n_rows, result.size());
+        ASSERT_EQ(sensitivities.n_cols, parameters.size());
+        double increment = 1e-6;
+        for(uint k = 0; k < parameters.size(); k++){
+            std::vector<double> upperValues = parameterValues, lowerValues = parameterValues;
+            upperValues[k] += increment;
+            lowerValues[k] -= increment;
+            std::vector<double> upper = simulate(upperValues, nullptr);
+            std::vector<double> lower = simulate(lowerValues, nullptr);
+            for(uint i = 0; i < result.size(); i++){
+                EXPECT_NEAR(sensitivities(i,k), (upper[i] - lower[i]) / (2*increment), 1e-5);
+            }
+        }
+        // the parameter of the propagation changes the output of the other nodes after the first step
+        EXPECT_GT(arma::accu(arma::abs(sensitivities.col(1))), 0);
+    }
+}
+
+TEST_F(ComputationTestingPerturbation, sensitivitiesArePropagatedOnlyByTheTimedStep) {
+    Computation computation;
+    computation.assign(*c1);
+    computation.augmentGraph(types);
+    computation.addEdges(virtualInputEdges,virtualInputEdgesValues);
+    arma::uword numNodes = computation.getAugmentedGraph()->getNumNodes();
+    DissipationModelScaled dissipation([](double time)->double{return 0.1;});
+    ConservationModel conservation([](double time)->double{return 0.05;});
+    PropagationModelNeighbors propagation(computation.getAugmentedGraph(), [](double time)->double{return 0.5;});
+    computation.setDissipationModel(&dissipation);
+    computation.setConservationModel(&conservation);
+    computation.setPropagationModel(&propagation);
+    std::vector<SensitivityParameter> parameters(1);
+    parameters[0] = {"propagation:node2", SensitivityTarget::propagation, 1, [](double time)->double{return 1;}};
+    computation.setSensitivityParameters(parameters);
+    // the pseudoinverse path has no time step, the sensitivities are left as they are
+    std::vector<double> result = computation.computeAugmentedPerturbation();
+    ASSERT_EQ(result.size(), numNodes);
+    EXPECT_EQ(arma::accu(arma::abs(computation.getSensitivities())), 0);
+    result = computation.computeAugmentedPerturbationEnhanced4(1, false);
+    ASSERT_EQ(result.size(), numNodes);
+    ASSERT_EQ(computation.getSensitivities().n_rows, numNodes);
+    ASSERT_EQ(computation.getSensitivities().n_cols, parameters.size());
+    EXPECT_GT(arma::accu(arma::abs(computation.getSensitivities())), 0);
+}
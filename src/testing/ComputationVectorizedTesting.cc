@@ -0,0 +1,115 @@
+/**
+ * @file ComputationVectorizedTesting.cc
+ * @ingroup Testing
+ * @brief Contains unit tests for the ComputationVectorized class in MASFENON.
+ * @details The tests check that every scenario of the ensemble computation gives the same result as the single scenario models.
+ * @warning This file is intended for testing purposes only and should not be used in production code.
+ * @see ComputationVectorized.hxx
+ */
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <armadillo>
+#include <stdexcept>
+#include <vector>
+#include "computation/ComputationVectorized.hxx"
+#include "computation/ConservationModel.hxx"
+#include "computation/ConservationModelVectorized.hxx"
+#include "computation/DissipationModelScaled.hxx"
+#include "computation/DissipationModelScaledVectorized.hxx"
+#include "computation/PropagationModelCustom.hxx"
+#include "computation/PropagationModelCustomVectorized.hxx"
+#include "data_structures/WeightedEdgeGraph.hxx"
+#include "utils/armaUtilities.hxx"
+
+class ComputationVectorizedTesting : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            graph = new WeightedEdgeGraph(4);
+            graph->addEdge(0,1,1);
+            graph->addEdge(1,2,2);
+            graph->addEdge(2,3,1);
+            graph->addEdge(3,0,0.5);
+            graph->addEdge(0,2,-1);
+            input = {{1, 0, 2},
+                     {-2, 1, 0},
+                     {0.5, 0, -1},
+                     {3, 0.2, 0}};
+        }
+        void TearDown() override {
+            delete graph;
+        }
+        // the step of a single scenario, computed with the models of the single scenario computation
+        arma::Col<double> referenceStep(const arma::Col<double>& scenarioInput, double dissipationScale, double conservationScale, double time, const std::vector<double>& saturations){
+            DissipationModelScaled dissipationModel([dissipationScale](double time)->double{return dissipationScale;});
+            ConservationModel conservationModel([conservationScale](double time)->double{return conservationScale;});
+            PropagationModelCustom propagationModel(graph, [](double time)->double{return 0.7;});
+            arma::Mat<double> Wstar = normalize1Rows(graph->getAdjacencyMatrix().asArmadilloMatrix());
+            arma::Col<double> dissipated = dissipationModel.dissipate(scenarioInput, time);
+            arma::Col<double> output = propagationModel.propagate(dissipated, time) - conservationModel.conservationTerm(dissipated, Wstar, time);
+            for(arma::uword i = 0; i < output.n_elem; i++){
+                output(i) = std::min(std::max(output(i), -saturations[i]), saturations[i]);
+            }
+            return output;
+        }
+        WeightedEdgeGraph* graph;
+        arma::Mat<double> input;
+};
+
+TEST_F(ComputationVectorizedTesting, constructorsWork) {
+    ComputationVectorized computation(graph, input);
+    EXPECT_EQ(computation.getNumNodes(), 4);
+    EXPECT_EQ(computation.getNumScenarios(), 3);
+    ComputationVectorized fromScenarios(graph, std::vector<std::vector<double>>{{1, -2, 0.5, 3}, {0, 1, 0, 0.2}});
+    EXPECT_EQ(fromScenarios.getNumScenarios(), 2);
+    EXPECT_TRUE(arma::approx_equal(fromScenarios.getInput(), input.cols(0,1), "absdiff", 1e-12));
+    EXPECT_THROW(ComputationVectorized(graph, arma::Mat<double>(3, 2, arma::fill::zeros)), std::invalid_argument);
+    EXPECT_THROW(ComputationVectorized(graph, std::vector<std::vector<double>>{{1, 2}}), std::invalid_argument);
+    EXPECT_THROW(ComputationVectorized(nullptr, input), std::invalid_argument);
+}
+
+TEST_F(ComputationVectorizedTesting, scenariosMatchSingleComputation) {
+    std::vector<double> dissipationScales{0.1, 0.3, 0.5};
+    std::vector<double> conservationScales{0.2, 0.0, 0.4};
+    DissipationModelScaledVectorized dissipationModel(std::function<arma::Row<double>(double)>([dissipationScales](double time)->arma::Row<double>{return arma::Row<double>(dissipationScales);}));
+    ConservationModelVectorized conservationModel(std::function<arma::Row<double>(double)>([conservationScales](double time)->arma::Row<double>{return arma::Row<double>(conservationScales);}));
+    PropagationModelCustomVectorized propagationModel(graph, [](double time)->double{return 0.7;});
+    ComputationVectorized computation(graph, input);
+    EXPECT_THROW(computation.computePerturbation(0), std::invalid_argument);
+    computation.setDissipationModel(&dissipationModel);
+    computation.setConservationModel(&conservationModel);
+    computation.setPropagationModel(&propagationModel);
+    std::vector<double> saturations{1, 2, 0.5, 3};
+    arma::Mat<double> state = input;
+    for(double time : {0.0, 1.0, 2.0}){
+        const arma::Mat<double>& output = computation.computePerturbation(time, true, saturations);
+        ASSERT_EQ(output.n_rows, 4);
+        ASSERT_EQ(output.n_cols, 3);
+        for(arma::uword scenario = 0; scenario < 3; scenario++){
+            arma::Col<double> expected = referenceStep(state.col(scenario), dissipationScales[scenario], conservationScales[scenario], time, saturations);
+            EXPECT_TRUE(arma::approx_equal(output.col(scenario), expected, "absdiff", 1e-12));
+            state.col(scenario) = expected;
+        }
+        computation.updateInput();
+    }
+    EXPECT_EQ(computation.getScenarioOutput(2), armaColumnToVector(arma::Col<double>(state.col(2))));
+    EXPECT_THROW(computation.getScenarioOutput(3), std::out_of_range);
+    EXPECT_THROW(computation.computePerturbation(3, true, std::vector<double>{1, 1}), std::invalid_argument);
+}
+
+TEST_F(ComputationVectorizedTesting, sharedScaleAndCustomSaturationWork) {
+    DissipationModelScaledVectorized dissipationModel([](double time)->double{return 0.2;});
+    ConservationModelVectorized conservationModel([](double time)->double{return 0.1;});
+    PropagationModelCustomVectorized propagationModel(graph, [](double time)->double{return 0.7;});
+    ComputationVectorized computation(graph, input);
+    computation.setDissipationModel(&dissipationModel);
+    computation.setConservationModel(&conservationModel);
+    computation.setPropagationModel(&propagationModel);
+    arma::Mat<double> unsaturated = computation.computePerturbation(0, false);
+    computation.setBatchSaturationFunction(hyperbolicTangentScaledBatch);
+    const arma::Mat<double>& saturated = computation.computePerturbation(0);
+    for(arma::uword scenario = 0; scenario < 3; scenario++){
+        arma::Col<double> expected = referenceStep(input.col(scenario), 0.2, 0.1, 0, std::vector<double>(4, 1e9));
+        EXPECT_TRUE(arma::approx_equal(unsaturated.col(scenario), expected, "absdiff", 1e-12));
+    }
+    EXPECT_TRUE(arma::approx_equal(saturated, arma::tanh(unsaturated), "absdiff", 1e-12));
+}
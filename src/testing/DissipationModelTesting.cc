@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -7,6 +8,7 @@
 #include "computation/DissipationModelPeriodic.hxx"
 #include "computation/DissipationModelRandom.hxx"
 #include "computation/DissipationModelScaled.hxx"
+#include "utils/mathUtilities.hxx"
 
 class DissipationModelTesting : public ::testing::Test {
     protected:
@@ -30,3 +32,46 @@ TEST_F(DissipationModelTesting, constructorWorksDefault) {
 TEST_F(DissipationModelTesting, constructorWorksGeneral) {
     EXPECT_EQ(c1->getNumEl(),0);
 }
+
+
+TEST_F(DissipationModelTesting, randomDissipationIsReproducible) {
+    DissipationModelRandom first(0.2, 0.4, 42, 3);
+    DissipationModelRandom second(0.2, 0.4, 42, 3);
+    DissipationModelRandom otherStream(0.2, 0.4, 42, 4);
+    arma::Col<double> input = arma::ones<arma::Col<double>>(100);
+    arma::Col<double> term = first.dissipationTerm(input, 1.5);
+    EXPECT_TRUE(arma::approx_equal(term, second.dissipationTerm(input, 1.5), "absdiff", 0.0));
+    EXPECT_FALSE(arma::approx_equal(term, otherStream.dissipationTerm(input, 1.5), "absdiff", 0.0));
+    EXPECT_FALSE(arma::approx_equal(term, first.dissipationTerm(input, 2.5), "absdiff", 0.0));
+    EXPECT_TRUE(arma::all(term >= 0.2));
+    EXPECT_TRUE(arma::all(term < 0.4));
+    EXPECT_TRUE(arma::approx_equal(first.dissipate(input, 1.5), input - term, "absdiff", 1e-15));
+    // the element i only depends on (seed, stream, i, time)
+    EXPECT_DOUBLE_EQ(term(7), counterBasedRealNumber(42, 3, 7, timeToCounter(1.5), 0.2, 0.4));
+}
+
+TEST_F(DissipationModelTesting, periodicDissipationMatchesScalarFormula) {
+    arma::Col<double> phases = {0, 0.5, -1, 2};
+    arma::Col<double> periods = {3, 7.5, 0.8, 3};
+    arma::Col<double> amplitudes = {1, 0.5, 2, -0.3};
+    DissipationModelPeriodic periodic(phases, periods, amplitudes);
+    DissipationModelPeriodic sharedPeriod(4, 0.25, 2.5, 1.5);
+    arma::Col<double> input = {1, -2, 0.5, 3};
+    // consecutive times with the same step use the phase recurrence, the jumps evaluate the sines again
+    std::vector<double> times;
+    for(int i = 0; i < 200; i++) times.push_back(i*0.125);
+    times.push_back(40.3);
+    times.push_back(40.3);
+    times.push_back(12.0);
+    for(double time : times){
+        arma::Col<double> expected(4), expectedShared(4);
+        for(arma::uword i = 0; i < 4; i++){
+            expected(i) = amplitudes(i)*std::sin(2*arma::datum::pi/periods(i)*time + phases(i));
+            expectedShared(i) = 1.5*std::sin(2*arma::datum::pi/2.5*time + 0.25);
+        }
+        EXPECT_TRUE(arma::approx_equal(periodic.dissipationTerm(input, time), expected, "absdiff", 1e-12)) << "Mismatch at time " << time;
+        EXPECT_TRUE(arma::approx_equal(periodic.dissipate(input, time), input - expected, "absdiff", 1e-12)) << "Mismatch at time " << time;
+        EXPECT_TRUE(arma::approx_equal(sharedPeriod.dissipationTerm(input, time), expectedShared, "absdiff", 1e-12)) << "Mismatch at time " << time;
+    }
+    EXPECT_THROW(periodic.dissipate(arma::ones<arma::Col<double>>(3), 1.0), std::invalid_argument);
+}
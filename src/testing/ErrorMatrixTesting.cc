@@ -0,0 +1,96 @@
+/**
+ * @file ErrorMatrixTesting.cc
+ * @ingroup Testing
+ * @brief Contains unit tests for the ErrorMatrix class in MASFENON.
+ * @details The tests cover the alignment of the nodes and the times with the reference, the online accumulation of the errors and the saved error matrix.
+ * @warning This file is intended for testing purposes only and should not be used in production code.
+ * @see ErrorMatrix.hxx
+ */
+#include <gtest/gtest.h>
+#include <armadillo>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "data_structures/ErrorMatrix.hxx"
+
+TEST(ErrorMatrixTesting, errorsAreAlignedWithTheReference) {
+    // the reference times are not sorted and the node c is not simulated
+    arma::Mat<double> reference = {{1.0, 0.0}, {2.0, 0.5}, {3.0, 1.0}};
+    ErrorMatrix errorMatrix({"a", "b", "c"}, {6.0, 5.0}, reference, {"b", "a", "v-in:t1"});
+    EXPECT_EQ(errorMatrix.getNodeNames(), std::vector<std::string>({"a", "b"}));
+    // the virtual node is ignored, the time 5.5 is not in the reference
+    EXPECT_FALSE(errorMatrix.accumulate(5.5, {1.0, 1.0, 7.0}));
+    EXPECT_TRUE(errorMatrix.accumulate(5.0, {1.0, 1.0, 7.0}));
+    EXPECT_TRUE(errorMatrix.accumulate(6.0 + 1e-12, {3.0, 2.0, 7.0}));
+    arma::Mat<double> expected = {{1.0, 1.0}, {0.5, 1.0}};
+    EXPECT_TRUE(arma::approx_equal(errorMatrix.getErrors(), expected, "absdiff", 1e-12));
+    EXPECT_EQ(errorMatrix.getNumErrors(), 4u);
+    EXPECT_NEAR(errorMatrix.rmse(), std::sqrt((1.0 + 1.0 + 0.25 + 1.0) / 4), 1e-12);
+    // the same time computed again replaces the previous errors
+    EXPECT_TRUE(errorMatrix.accumulate(5.0, {0.0, 2.0, 7.0}));
+    EXPECT_EQ(errorMatrix.getNumErrors(), 4u);
+    EXPECT_NEAR(errorMatrix.rmse(), std::sqrt((4.0 + 0.25 + 1.0 + 1.0) / 4), 1e-12);
+    errorMatrix.reset();
+    EXPECT_EQ(errorMatrix.getNumErrors(), 0u);
+    EXPECT_TRUE(std::isnan(errorMatrix.rmse()));
+    EXPECT_THROW(errorMatrix.accumulate(5.0, {1.0}), std::invalid_argument);
+}
+
+TEST(ErrorMatrixTesting, gradientUsesTheErrorsOfTheTime) {
+    arma::Mat<double> reference = {{1.0, 0.0}, {2.0, arma::datum::nan}};
+    ErrorMatrix errorMatrix({"a", "b"}, {0.0, 1.0}, reference, {"b", "a", "v-in:t1"});
+    // derivatives of the simulated values (b, a, v-in:t1) with respect to two parameters
+    arma::Mat<double> sensitivities = {{1.0, 0.0}, {0.5, 2.0}, {7.0, 7.0}};
+    // the time was not accumulated yet
+    EXPECT_TRUE(arma::approx_equal(errorMatrix.sumSquaredErrorsGradient(0.0, sensitivities), arma::Row<double>({0.0, 0.0}), "absdiff", 1e-12));
+    errorMatrix.accumulate(0.0, {3.0, 2.0, 0.0});
+    errorMatrix.accumulate(1.0, {3.0, 2.0, 0.0});
+    // errors at time 0: a = 1, b = 1; at time 1 only a = 2 since the reference of b is missing
+    EXPECT_TRUE(arma::approx_equal(errorMatrix.sumSquaredErrorsGradient(0.0, sensitivities), arma::Row<double>({2*1.0*0.5 + 2*1.0*1.0, 2*1.0*2.0}), "absdiff", 1e-12));
+    EXPECT_TRUE(arma::approx_equal(errorMatrix.sumSquaredErrorsGradient(1.0, sensitivities), arma::Row<double>({2*2.0*0.5, 2*2.0*2.0}), "absdiff", 1e-12));
+    EXPECT_TRUE(arma::approx_equal(errorMatrix.sumSquaredErrorsGradient(0.5, sensitivities), arma::Row<double>({0.0, 0.0}), "absdiff", 1e-12));
+    EXPECT_THROW(errorMatrix.sumSquaredErrorsGradient(0.0, sensitivities.rows(0, 0)), std::invalid_argument);
+}
+
+TEST(ErrorMatrixTesting, missingReferenceValuesAreNotScored) {
+    arma::Mat<double> reference = {{1.0, arma::datum::nan}};
+    ErrorMatrix errorMatrix({"a"}, {0.0, 1.0}, reference, {"a"});
+    errorMatrix.accumulate(0.0, {2.0});
+    errorMatrix.accumulate(1.0, {2.0});
+    EXPECT_EQ(errorMatrix.getNumErrors(), 1u);
+    EXPECT_DOUBLE_EQ(errorMatrix.rmse(), 1.0);
+    EXPECT_THROW(ErrorMatrix({"a"}, {0.0, 0.0}, reference, {"a"}), std::invalid_argument);
+    EXPECT_THROW(ErrorMatrix({"a", "b"}, {0.0, 1.0}, reference, {"a"}), std::invalid_argument);
+}
+
+TEST(ErrorMatrixTesting, referenceFileAndSavedMatrixWork) {
+    std::filesystem::path folder = std::filesystem::temp_directory_path() / "ErrorMatrixTesting";
+    std::filesystem::create_directories(folder);
+    std::string referenceFilename = (folder / "t0.tsv").string();
+    std::ofstream referenceFile(referenceFilename);
+    referenceFile << "nodeNames\t5\t6\t9\n";
+    referenceFile << "a0\t0.2\t0.3\t0.5\n";
+    referenceFile << "b0\t0.2\tNA\t0.45\n";
+    referenceFile.close();
+    ErrorMatrix errorMatrix(referenceFilename, {"a0", "b0"});
+    // the time 9 is never computed, so it is not saved
+    for(double time : {4.0, 5.0, 6.0}){
+        errorMatrix.accumulate(time, {1.0, 1.0});
+    }
+    EXPECT_EQ(errorMatrix.getNumErrors(), 3u);
+    std::string errorsFilename = (folder / "errors.tsv").string();
+    errorMatrix.save(errorsFilename);
+    ErrorMatrix savedErrors(errorsFilename, {"a0", "b0"});
+    savedErrors.accumulate(5.0, {0.0, 0.0});
+    savedErrors.accumulate(6.0, {0.0, 0.0});
+    // the saved errors are read back as reference, so they are the opposite of the errors of a zero simulation
+    arma::Mat<double> expected = {{0.8, 0.7}, {0.8, arma::datum::nan}};
+    EXPECT_TRUE(arma::approx_equal(-savedErrors.getErrors().cols(0, 0), expected.cols(0, 0), "absdiff", 1e-9));
+    EXPECT_NEAR(-savedErrors.getErrors()(0, 1), 0.7, 1e-9);
+    EXPECT_TRUE(std::isnan(savedErrors.getErrors()(1, 1)));
+    EXPECT_THROW(ErrorMatrix((folder / "missing.tsv").string(), {"a0"}), std::invalid_argument);
+    std::filesystem::remove_all(folder);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file ExpressionTesting.cc
+ * @ingroup Testing
+ * @brief Contains unit tests for the Expression class in MASFENON.
+ * @details The tests cover the parsing, the constant folding, the piecewise constant forms and the vectorized evaluation of the expressions.
+ * @warning This file is intended for testing purposes only and should not be used in production code.
+ * @see Expression.hxx
+ */
+#include <gtest/gtest.h>
+#include <armadillo>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "data_structures/Expression.hxx"
+#include "CustomFunctions.hxx"
+
+TEST(ExpressionTesting, evaluationWorks) {
+    Expression expression("2 * t + 3 ^ 2 - sin(pi / 2)", {"t"});
+    EXPECT_DOUBLE_EQ(expression.evaluate(1.5), 11.0);
+    Expression precedence("-2 ^ 2 + 10 / 4 * 2", {"t"});
+    EXPECT_DOUBLE_EQ(precedence.evaluate(0.0), 1.0);
+    Expression rightAssociative("2 ^ 3 ^ 2", {"t"});
+    EXPECT_DOUBLE_EQ(rightAssociative.evaluate(0.0), 512.0);
+    Expression functions("max(x, s) + min(x, s) + pow(abs(x), 2) + exp(0) + log(e)", {"x", "s"});
+    EXPECT_DOUBLE_EQ(functions.evaluate(std::vector<double>{-3.0, 2.0}), 2.0 - 3.0 + 9.0 + 1.0 + 1.0);
+    Expression logical("(x > 1 && s < 1) || !(x == 0) ? 1 : 2", {"x", "s"});
+    EXPECT_DOUBLE_EQ(logical.evaluate(std::vector<double>{0.0, 0.0}), 2.0);
+    EXPECT_DOUBLE_EQ(logical.evaluate(std::vector<double>{2.0, 0.5}), 1.0);
+    EXPECT_THROW(logical.evaluate(std::vector<double>{1.0}), std::invalid_argument);
+}
+
+TEST(ExpressionTesting, parametersAreSubstituted) {
+    std::string source = "p[0] * t + p[1]";
+    EXPECT_EQ(Expression::countParameters(source, {"t"}), 2);
+    Expression expression(source, {"t"}, {2.0, 1.0});
+    EXPECT_DOUBLE_EQ(expression.evaluate(3.0), 7.0);
+    EXPECT_DOUBLE_EQ(expression.withParameters({1.0, 0.0}).evaluate(3.0), 3.0);
+    EXPECT_THROW(Expression(source, {"t"}, {2.0}), std::invalid_argument);
+}
+
+TEST(ExpressionTesting, constantSubexpressionsAreFolded) {
+    Expression expression("p[0] * (1 + 2) / cos(0)", {"t"}, {0.5});
+    EXPECT_TRUE(expression.isConstant());
+    EXPECT_DOUBLE_EQ(expression.constantValue(), 1.5);
+    EXPECT_EQ(expression.getNumInstructions(), 1);
+    Expression partial("t * (2 + 3)", {"t"});
+    EXPECT_FALSE(partial.isConstant());
+    EXPECT_EQ(partial.getNumInstructions(), 3);
+}
+
+TEST(ExpressionTesting, piecewiseConstantFormIsDetected) {
+    std::vector<double> parameters{0.1, 0.2, 0.3};
+    Expression expression("t <= 5 ? p[0] : (t <= 6 ? p[1] : p[2])", {"t"}, parameters);
+    EXPECT_TRUE(expression.isPiecewiseConstant());
+    EXPECT_EQ(expression.getBreakpoints(), std::vector<double>({5.0, 6.0}));
+    auto customFunction = getDissipationScalingFunction(parameters);
+    for(double time : {-1.0, 0.0, 4.99, 5.0, 5.01, 5.5, 6.0, 6.01, 10.0, 20.0}){
+        EXPECT_DOUBLE_EQ(expression.evaluate(time), customFunction(time));
+    }
+    Expression notPiecewise("t <= 5 ? t : 1", {"t"});
+    EXPECT_FALSE(notPiecewise.isPiecewiseConstant());
+    EXPECT_DOUBLE_EQ(notPiecewise.evaluate(2.0), 2.0);
+}
+
+TEST(ExpressionTesting, vectorizedEvaluationMatchesScalarEvaluation) {
+    Expression saturationExpression("s * tanh(x / s)", {"x", "s"});
+    arma::Col<double> values = {-3, -1, 0, 0.5, 2, 4};
+    arma::Col<double> saturations = {1, 2, 1, 0.5, 1, 3};
+    arma::Col<double> result = saturationExpression.evaluate(std::vector<const arma::Col<double>*>{&values, &saturations});
+    ASSERT_EQ(result.n_elem, values.n_elem);
+    auto saturationFunction = saturationExpression.asSaturationFunction();
+    for(arma::uword i = 0; i < values.n_elem; i++){
+        EXPECT_NEAR(result(i), saturations(i) * std::tanh(values(i) / saturations(i)), 1e-12);
+        EXPECT_NEAR(saturationFunction(values(i), saturations(i)), result(i), 1e-12);
+    }
+    // the batch function only replaces the values outside [-s, s]
+    arma::Col<double> batchValues = values;
+    saturationExpression.asBatchSaturationFunction()(batchValues.memptr(), saturations.memptr(), batchValues.n_elem);
+    for(arma::uword i = 0; i < values.n_elem; i++){
+        double expected = std::abs(values(i)) > saturations(i) ? result(i) : values(i);
+        EXPECT_NEAR(batchValues(i), expected, 1e-12);
+    }
+    Expression piecewise("t < 1 ? 0 : 2", {"t"});
+    arma::Col<double> times = {0, 0.5, 1, 1.5};
+    arma::Col<double> piecewiseResult = piecewise.evaluate(std::vector<const arma::Col<double>*>{&times});
+    EXPECT_TRUE(arma::approx_equal(piecewiseResult, arma::Col<double>({0, 0, 2, 2}), "absdiff", 1e-12));
+}
+
+TEST(ExpressionTesting, invalidExpressionsThrow) {
+    EXPECT_THROW(Expression("2 +", {"t"}), std::invalid_argument);
+    EXPECT_THROW(Expression("(t + 1", {"t"}), std::invalid_argument);
+    EXPECT_THROW(Expression("x + 1", {"t"}), std::invalid_argument);
+    EXPECT_THROW(Expression("sin(t, 1)", {"t"}), std::invalid_argument);
+    EXPECT_THROW(Expression("t 1", {"t"}), std::invalid_argument);
+    EXPECT_THROW(Expression("t", {"p"}), std::invalid_argument);
+    EXPECT_THROW(Expression("t", {"t"}).asSaturationFunction(), std::invalid_argument);
+    EXPECT_THROW(Expression("x + s", {"x", "s"}).asScaleFunction(), std::invalid_argument);
+}
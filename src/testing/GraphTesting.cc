@@ -15,7 +15,7 @@ class GraphTesting : public ::testing::Test {
     g1_->addEdge(1,2,0.3)->addEdge(0,2,0.4);
     *g2_ = *g1_;   //Problem with the equal operator(assignment)
 
-    g3_ = new WeightedEdgeGraph(g1_->adjMatrix);
+    g3_ = new WeightedEdgeGraph(g1_->getAdjacencyMatrix());
 
     g4_ = new WeightedEdgeGraph(nodeNames);
     g5_ = new WeightedEdgeGraph(nodeNames,nodeValues);
@@ -60,13 +60,13 @@ TEST_F(GraphTesting, constructorWorksNumNodes) {
 
 
 TEST_F(GraphTesting, constructorWorksNumNodesSquareMatrix) {
-  EXPECT_EQ(g1_->adjMatrix.getCols(), g1_->adjMatrix.getRows());
+  EXPECT_EQ(g1_->getAdjacencyMatrix().getCols(), g1_->getAdjacencyMatrix().getRows());
 }
 
 
 TEST_F(GraphTesting, constructorWorksMatrixHasRightEdges) {
-  EXPECT_FLOAT_EQ(g1_->adjMatrix.getValue(1, 2),0.3);
-  EXPECT_FLOAT_EQ(g1_->adjMatrix.getValue(0, 2),0.4);
+  EXPECT_FLOAT_EQ(g1_->getAdjacencyMatrix().getValue(1, 2),0.3);
+  EXPECT_FLOAT_EQ(g1_->getAdjacencyMatrix().getValue(0, 2),0.4);
 }
 
 TEST_F(GraphTesting, assignmentWorks1) {
@@ -163,8 +163,8 @@ TEST_F(GraphTesting, addingNodeOnlyValueAndDefualt){
   EXPECT_NO_THROW({graphTest.getAdjList(nodeDefaultIndex);});
   EXPECT_NO_THROW({graphTest.getAdjList(nodeValueName);});
   EXPECT_NO_THROW({graphTest.getAdjList(nodeDefaultName);});
-  EXPECT_EQ(graphTest.adjMatrix.getCols(), graphTest.getNumNodes());
-  EXPECT_EQ(graphTest.adjMatrix.getRows(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getCols(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getRows(), graphTest.getNumNodes());
 
 }
 
@@ -189,8 +189,8 @@ TEST_F(GraphTesting, addingNodeNameAndValue){
   EXPECT_NO_THROW({graphTest.getAdjList(nodeDefaultIndex);});
   EXPECT_NO_THROW({graphTest.getAdjList(nodeValueName);});
   EXPECT_NO_THROW({graphTest.getAdjList(nodeDefaultName);});
-  EXPECT_EQ(graphTest.adjMatrix.getCols(), graphTest.getNumNodes());
-  EXPECT_EQ(graphTest.adjMatrix.getRows(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getCols(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getRows(), graphTest.getNumNodes());
 }
 
 
@@ -216,8 +216,8 @@ TEST_F(GraphTesting, addingNodesOnlyValues){
   EXPECT_NO_THROW({graphTest.getAdjList(nodeStartName[0]);});
   EXPECT_NO_THROW({graphTest.getAdjList(nodeStartName[1]);});
   EXPECT_NO_THROW({graphTest.getAdjList(nodeStartName[2]);});
-  EXPECT_EQ(graphTest.adjMatrix.getCols(), graphTest.getNumNodes());
-  EXPECT_EQ(graphTest.adjMatrix.getRows(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getCols(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getRows(), graphTest.getNumNodes());
 
   std::vector<double> graphNodeValues = graphTest.getNodeValues(nodeStartName);
   for (uint i = 0; i < nodeStartName.size(); i++) {
@@ -246,8 +246,8 @@ TEST_F(GraphTesting, addingNodesNamesAndValuesAndDefault){
   EXPECT_FLOAT_EQ(graphTest.getNodeValue(namesWithVal[0]),4.0);
   EXPECT_FLOAT_EQ(graphTest.getNodeValue(namesWithVal[1]),8.0);
   EXPECT_FLOAT_EQ(graphTest.getNodeValue(namesWithVal[2]),3.2);
-  EXPECT_EQ(graphTest.adjMatrix.getCols(), graphTest.getNumNodes());
-  EXPECT_EQ(graphTest.adjMatrix.getRows(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getCols(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getRows(), graphTest.getNumNodes());
 
   graphTest.addNodes(namesWithDefault);
   nodesStartIndex = graphTest.getNumNodes()-7;
@@ -282,8 +282,8 @@ TEST_F(GraphTesting, addingNodesNamesAndValuesAndDefault){
   EXPECT_NO_THROW({graphTest.getAdjList(namesWithDefault[1]);});
   EXPECT_NO_THROW({graphTest.getAdjList(namesWithDefault[2]);});
   EXPECT_NO_THROW({graphTest.getAdjList(namesWithDefault[3]);});
-  EXPECT_EQ(graphTest.adjMatrix.getCols(), graphTest.getNumNodes());
-  EXPECT_EQ(graphTest.adjMatrix.getRows(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getCols(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getRows(), graphTest.getNumNodes());
   //also test if getNodeValues with default argument returns all the nodes with the right values
   std::vector<double> graphNodeValues = graphTest.getNodeValues();
   for (uint i = 0; i < namesWithVal.size(); i++) {
@@ -306,16 +306,16 @@ TEST_F(GraphTesting, addingNodesEmptyVector){
 
   ASSERT_EQ(graphTest.getNumNodes(), 5);
   ASSERT_EQ(graphTest.getNumEdges(), 0);
-  EXPECT_EQ(graphTest.adjMatrix.getCols(), graphTest.getNumNodes());
-  EXPECT_EQ(graphTest.adjMatrix.getRows(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getCols(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getRows(), graphTest.getNumNodes());
 
   graphTest.addNodes(namesWithDefault);
 
   
   ASSERT_EQ(graphTest.getNumNodes(), 5);
   ASSERT_EQ(graphTest.getNumEdges(), 0);
-  EXPECT_EQ(graphTest.adjMatrix.getCols(), graphTest.getNumNodes());
-  EXPECT_EQ(graphTest.adjMatrix.getRows(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getCols(), graphTest.getNumNodes());
+  EXPECT_EQ(graphTest.getAdjacencyMatrix().getRows(), graphTest.getNumNodes());
 }
 
 
@@ -492,4 +492,182 @@ TEST_F(GraphTesting, setNodeValueOfNotPresentNode){
 
 TEST_F(GraphTesting, setNodeValueOfNotPresentNodeName){
   EXPECT_ANY_THROW(g5_->setNodeValue("nodeNotPresent",0.2));
-}
\ No newline at end of file
+}
+
+TEST_F(GraphTesting, updateEdgeWeightsWorks){
+  std::vector<std::tuple<int,int,double>> previous = g1_->updateEdgeWeights(std::vector<std::tuple<int,int,double>>{{1,2,0.7},{3,0,1.2}});
+  ASSERT_EQ(previous.size(), 2);
+  EXPECT_FLOAT_EQ(std::get<2>(previous[0]), 0.3);
+  EXPECT_FLOAT_EQ(std::get<2>(previous[1]), 0);
+  EXPECT_FLOAT_EQ(g1_->getEdgeWeight(1,2), 0.7);
+  EXPECT_FLOAT_EQ(g1_->getEdgeWeight(3,0), 1.2);
+  EXPECT_EQ(g1_->getNumEdges(), 3);
+  for(auto edge : g1_->getEdgesVector()){
+    EXPECT_FLOAT_EQ(std::get<2>(edge), g1_->getEdgeWeight(std::get<0>(edge), std::get<1>(edge)));
+  }
+}
+
+TEST_F(GraphTesting, updateEdgeWeightsByNameUndirected){
+  std::vector<std::tuple<int,int,double>> previous = g4_->updateEdgeWeights(std::vector<std::tuple<std::string,std::string,double>>{{"node1","node3",1.1}}, false);
+  ASSERT_EQ(previous.size(), 2);
+  EXPECT_FLOAT_EQ(g4_->getEdgeWeight("node1","node3"), 1.1);
+  EXPECT_FLOAT_EQ(g4_->getEdgeWeight("node3","node1"), 1.1);
+  EXPECT_THROW(g4_->updateEdgeWeights(std::vector<std::tuple<std::string,std::string,double>>{{"node1","node10",1.1}}), std::invalid_argument);
+  EXPECT_THROW(g1_->updateEdgeWeights(std::vector<std::tuple<int,int,double>>{{0,10,1.1}}), std::invalid_argument);
+}
+
+TEST_F(GraphTesting, sparseAdjacencyMatchesTheDenseMatrix){
+  WeightedEdgeGraph graphTest(5);
+  // edges added out of order, the queries merge them into the sorted rows
+  graphTest.addEdge(3,1,0.5)->addEdge(0,4,-0.2)->addEdge(0,1,0.3)->addEdge(2,0,0.7,false);
+  EXPECT_EQ(graphTest.getNumEdges(), 4);
+  EXPECT_EQ(graphTest.getSuccessors(0), std::vector<int>({1,2,4}));
+  EXPECT_EQ(graphTest.getPredecessors(1), std::vector<int>({0,3}));
+  EXPECT_FLOAT_EQ(graphTest.getEdgeWeight(0,2), 0.7);
+  EXPECT_FLOAT_EQ(graphTest.getEdgeWeight(4,4), 0);
+  EXPECT_FALSE(graphTest.hasEdge(0,4));
+  EXPECT_THROW(graphTest.getEdgeWeight(0,5), std::invalid_argument);
+  EXPECT_THROW(graphTest.getEdgeWeight(-1,0), std::out_of_range);
+  // edges and nodes added after the first query
+  graphTest.addEdge(1,0,1.5)->addEdge("0","1",0.9);
+  graphTest.addNode("node5", 1.0);
+  graphTest.addEdge(5,0,2.0);
+  EXPECT_EQ(graphTest.getNumEdges(), 6);
+  EXPECT_EQ(graphTest.getPredecessors(0), std::vector<int>({1,2,5}));
+  EXPECT_EQ(graphTest.inDegreeOfNode(0), 3);
+  EXPECT_EQ(graphTest.outDegreeOfNode(0), 3);
+  Matrix<double> adjacency = graphTest.getAdjacencyMatrix();
+  std::vector<double> absoluteOutWeights = graphTest.getAbsoluteOutWeights();
+  for(int i = 0; i < graphTest.getNumNodes(); i++){
+    double absoluteOutWeight = 0;
+    for(int j = 0; j < graphTest.getNumNodes(); j++){
+      EXPECT_FLOAT_EQ(adjacency.getValue(i,j), graphTest.getEdgeWeight(i,j));
+      absoluteOutWeight += std::abs(adjacency.getValue(i,j));
+    }
+    EXPECT_FLOAT_EQ(absoluteOutWeights[i], absoluteOutWeight);
+  }
+  EXPECT_FLOAT_EQ(adjacency.getValue(0,1), 0.9);
+  // the copies keep the same adjacency
+  WeightedEdgeGraph* copied = graphTest.copyNew();
+  WeightedEdgeGraph assigned(graphTest);
+  for(int i = 0; i < graphTest.getNumNodes(); i++){
+    EXPECT_EQ(copied->getSuccessors(i), graphTest.getSuccessors(i));
+    EXPECT_EQ(assigned.getPredecessors(i), graphTest.getPredecessors(i));
+    for(int j = 0; j < graphTest.getNumNodes(); j++){
+      EXPECT_FLOAT_EQ(copied->getEdgeWeight(i,j), graphTest.getEdgeWeight(i,j));
+      EXPECT_FLOAT_EQ(assigned.getEdgeWeight(i,j), graphTest.getEdgeWeight(i,j));
+    }
+  }
+  EXPECT_EQ(assigned.getEdgesVector(), graphTest.getEdgesVector());
+  EXPECT_EQ(assigned.getNodeName(5), "node5");
+  delete copied;
+}
+
+TEST_F(GraphTesting, addingEdgesInBulkMatchesAddingThemOneByOne){
+  std::vector<std::tuple<std::string,std::string,double>> edges{{"node3","node1",0.5},{"node1","node2",0.3},{"node1","node3",0.2},{"node3","node1",0.9},{"node5","node5",1.0},{"node2","node1",0.4}};
+  for(bool directed : {true, false}){
+    WeightedEdgeGraph bulk(nodeNames);
+    WeightedEdgeGraph oneByOne(nodeNames);
+    bulk.addEdge("node4","node1",0.1);
+    oneByOne.addEdge("node4","node1",0.1);
+    bulk.addEdges(edges, directed);
+    for(const auto& [node1, node2, weight] : edges){
+      oneByOne.addEdge(node1, node2, weight, directed);
+    }
+    EXPECT_EQ(bulk.getNumEdges(), oneByOne.getNumEdges());
+    EXPECT_EQ(bulk.getEdgesVector(), oneByOne.getEdgesVector());
+    for(int i = 0; i < bulk.getNumNodes(); i++){
+      EXPECT_EQ(bulk.getSuccessors(i), oneByOne.getSuccessors(i));
+      for(int j = 0; j < bulk.getNumNodes(); j++){
+        EXPECT_FLOAT_EQ(bulk.getEdgeWeight(i,j), oneByOne.getEdgeWeight(i,j));
+      }
+    }
+  }
+  WeightedEdgeGraph bulk(nodeNames);
+  EXPECT_FLOAT_EQ((bulk.addEdges(edges)->getEdgeWeight("node3","node1")), 0.9);
+  EXPECT_THROW(bulk.addEdges({{"node1","node4",0.3},{"node1","nodeNot",0.3}}), std::invalid_argument);
+  EXPECT_FALSE(bulk.hasEdge(0,3));
+  EXPECT_EQ(bulk.getNumEdges(), 5);
+}
+
+TEST_F(GraphTesting, repeatedNodeGrowthKeepsTheGraph){
+  WeightedEdgeGraph graph(nodeNames);
+  graph.addEdge("node1","node2",0.5);
+  graph.reserveNodes(graph.getNumNodes() + 200);
+  for(int i = 0; i < 100; i++){
+    graph.addNode("single" + std::to_string(i), i);
+  }
+  std::vector<std::string> batch;
+  for(int i = 0; i < 100; i++){
+    batch.push_back("batch" + std::to_string(i));
+  }
+  graph.addNodes(batch, std::vector<double>(batch.size(), -1.0));
+  WeightedEdgeGraph* augmented = graph.addNodesAndCopyNew(std::vector<std::string>{"virtual0","virtual1"});
+  EXPECT_EQ(augmented->getNumNodes(), static_cast<int>(nodeNames.size()) + 202);
+  EXPECT_FLOAT_EQ(augmented->getNodeValue("single42"), 42);
+  EXPECT_FLOAT_EQ(augmented->getNodeValue("batch7"), -1.0);
+  EXPECT_FLOAT_EQ(augmented->getNodeValue("virtual1"), 0);
+  EXPECT_EQ(augmented->getNodeName(augmented->getNumNodes()-1), "virtual1");
+  augmented->addEdge("virtual0","single42",0.7);
+  EXPECT_FLOAT_EQ(augmented->getEdgeWeight("node1","node2"), 0.5);
+  EXPECT_FLOAT_EQ(augmented->getEdgeWeight("virtual0","single42"), 0.7);
+  EXPECT_EQ(augmented->getNumEdges(), 2);
+  EXPECT_EQ(graph.getNumEdges(), 1);
+  EXPECT_THROW(graph.reserveNodes(-1), std::invalid_argument);
+  delete augmented;
+}
+
+TEST_F(GraphTesting, overlayMatchesTheCopyAndKeepsTheCoreUnchanged){
+  WeightedEdgeGraph core(nodeNames);
+  core.addEdges({{"node1","node2",0.5},{"node2","node3",0.3},{"node3","node1",0.2},{"node4","node4",0.1}});
+  std::vector<std::string> virtualNodes{"v-in:type1","v-out:type1"};
+  WeightedEdgeGraph* copied = core.addNodesAndCopyNew(virtualNodes);
+  WeightedEdgeGraph* overlay = core.addNodesAndOverlayNew(virtualNodes);
+  EXPECT_TRUE(overlay->isOverlay());
+  EXPECT_EQ(overlay->getCoreGraph(), &core);
+  EXPECT_FALSE(copied->isOverlay());
+  for(WeightedEdgeGraph* graph : {copied, overlay}){
+    graph->addEdge("v-in:type1","node2",0.7);
+    graph->addEdges({{"node3","v-out:type1",0.4},{"node1","v-out:type1",0.6}});
+    // changing a weight of the core only changes the overlay
+    graph->updateEdgeWeights(std::vector<std::tuple<std::string,std::string,double>>{{"node2","node3",0.9}});
+  }
+  EXPECT_EQ(overlay->getNumNodes(), copied->getNumNodes());
+  EXPECT_EQ(overlay->getNumEdges(), copied->getNumEdges());
+  EXPECT_EQ(overlay->getNodeNames(), copied->getNodeNames());
+  EXPECT_EQ(overlay->getNodeToIndexMap(), copied->getNodeToIndexMap());
+  EXPECT_EQ(overlay->getEdgesVector(), copied->getEdgesVector());
+  EXPECT_EQ(overlay->getAbsoluteOutWeights(), copied->getAbsoluteOutWeights());
+  Matrix<double> overlayAdjacency = overlay->getAdjacencyMatrix();
+  Matrix<double> copiedAdjacency = copied->getAdjacencyMatrix();
+  for(int i = 0; i < overlay->getNumNodes(); i++){
+    EXPECT_EQ(overlay->getSuccessors(i), copied->getSuccessors(i));
+    EXPECT_EQ(overlay->getPredecessors(i), copied->getPredecessors(i));
+    EXPECT_EQ(overlay->getNodeName(i), copied->getNodeName(i));
+    for(int j = 0; j < overlay->getNumNodes(); j++){
+      EXPECT_FLOAT_EQ(overlay->getEdgeWeight(i,j), copied->getEdgeWeight(i,j));
+      EXPECT_FLOAT_EQ(overlayAdjacency.getValue(i,j), copiedAdjacency.getValue(i,j));
+    }
+  }
+  EXPECT_EQ(overlay->getIndexFromName("v-out:type1"), static_cast<int>(nodeNames.size()) + 1);
+  EXPECT_TRUE(overlay->containsNode("node3"));
+  EXPECT_THROW(overlay->addNode("node3"), std::invalid_argument);
+  EXPECT_THROW(overlay->setNodeName("node3","nodeRenamed"), std::invalid_argument);
+  // the core is shared and read-only
+  EXPECT_EQ(core.getNumNodes(), static_cast<int>(nodeNames.size()));
+  EXPECT_EQ(core.getNumEdges(), 4);
+  EXPECT_FLOAT_EQ(core.getEdgeWeight("node2","node3"), 0.3);
+  EXPECT_FALSE(core.containsNode("v-in:type1"));
+  // the copy of an overlay does not depend on the core, the overlay of an overlay shares the core
+  WeightedEdgeGraph* flattened = overlay->copyNew();
+  WeightedEdgeGraph* secondOverlay = overlay->addNodesAndOverlayNew(std::vector<std::string>{"v-in:type2"});
+  EXPECT_FALSE(flattened->isOverlay());
+  EXPECT_EQ(secondOverlay->getCoreGraph(), &core);
+  EXPECT_FLOAT_EQ(flattened->getEdgeWeight("node2","node3"), 0.9);
+  EXPECT_FLOAT_EQ(secondOverlay->getEdgeWeight("node1","v-out:type1"), 0.6);
+  EXPECT_EQ(secondOverlay->getNumNodes(), overlay->getNumNodes() + 1);
+  delete secondOverlay;
+  delete flattened;
+  delete overlay;
+  delete copied;
+}
@@ -314,4 +314,48 @@ TEST_F(MatrixTesting,testAddRowEndQuick){
       else EXPECT_FLOAT_EQ(testing_matrix.getValue(i,j), 100);
     }
   }
-}
\ No newline at end of file
+}
+TEST_F(MatrixTesting,repeatedGrowthKeepsTheValues){
+  Matrix<double> testing_matrix = *m2_;
+  // the reserved memory is used by the columns added later
+  testing_matrix.reserve(10, 40);
+  int capacity = testing_matrix.getCapacity();
+  for(int k = 0; k < 28; k++){
+    testing_matrix.addColumnAtTheEnd(std::vector<double>(10, k));
+  }
+  EXPECT_EQ(testing_matrix.getCapacity(), capacity);
+  EXPECT_EQ(testing_matrix.getCols(), 40);
+  // rows, columns in the middle and zero blocks added many times grow the matrix geometrically
+  for(int k = 0; k < 50; k++){
+    testing_matrix.addRowAtTheEnd(std::vector<double>(testing_matrix.getCols(), -k));
+  }
+  testing_matrix.addColumn(std::vector<double>(testing_matrix.getRows(), 7), 3);
+  testing_matrix.addRowsColsWithZeros(2, 3);
+  EXPECT_EQ(testing_matrix.getRows(), 62);
+  EXPECT_EQ(testing_matrix.getCols(), 44);
+  for (int i = 0; i<testing_matrix.getRows(); i++) {
+    for (int j = 0; j<testing_matrix.getCols(); j++) {
+      int originalColumn = j < 3 ? j : j-1;
+      double expected;
+      if(i >= 60 || j >= 41) expected = 0;
+      else if(j == 3) expected = 7;
+      else if(i >= 10) expected = -(i-10);
+      else if(originalColumn >= 12) expected = originalColumn-12;
+      else expected = 100;
+      EXPECT_FLOAT_EQ(testing_matrix.getValue(i,j), expected);
+    }
+  }
+  EXPECT_THROW(testing_matrix.addRowsColsWithZeros(-1, 0), std::invalid_argument);
+}
+
+TEST_F(MatrixTesting,copyAndAddRowsColsWithZerosKeepsAllTheColumns){
+  Matrix<double> testing_matrix = m2_->copyAndAddRowsColsWithZeros(1, 2);
+  EXPECT_EQ(testing_matrix.getRows(), 11);
+  EXPECT_EQ(testing_matrix.getCols(), 14);
+  for (int i = 0; i<testing_matrix.getRows(); i++) {
+    for (int j = 0; j<testing_matrix.getCols(); j++) {
+      if(i < 10 && j < 12) EXPECT_FLOAT_EQ(testing_matrix.getValue(i,j), 100);
+      else EXPECT_FLOAT_EQ(testing_matrix.getValue(i,j), 0);
+    }
+  }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file ModelPluginTesting.cc
+ * @ingroup Testing
+ * @brief Contains unit tests for the models implemented by plugins loaded at runtime in MASFENON.
+ * @details The tests load the example plugin in src/plugins/ExampleModelPlugin.cxx and compare its models with the built-in ones.
+ * @warning This file is intended for testing purposes only and should not be used in production code.
+ * @see ModelPlugin.hxx
+ */
+#include <gtest/gtest.h>
+#include <armadillo>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "computation/ModelPlugin.hxx"
+#include "computation/DissipationModelPlugin.hxx"
+#include "computation/DissipationModelScaled.hxx"
+#include "computation/ConservationModel.hxx"
+#include "computation/ConservationModelPlugin.hxx"
+#include "computation/PropagationModelPlugin.hxx"
+#include "data_structures/WeightedEdgeGraph.hxx"
+#include "utils/armaUtilities.hxx"
+
+class ModelPluginTesting : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            plugin = std::make_shared<const ModelPlugin>(EXAMPLE_MODEL_PLUGIN_PATH);
+            graph = new WeightedEdgeGraph(4);
+            graph->addEdge(0,1,1);
+            graph->addEdge(1,2,2);
+            graph->addEdge(2,3,1);
+            graph->addEdge(3,0,0.5);
+        }
+        void TearDown() override {
+            delete graph;
+        }
+        std::shared_ptr<const ModelPlugin> plugin;
+        WeightedEdgeGraph* graph;
+        arma::Col<double> input = {1, -2, 0.5, 3};
+};
+
+TEST_F(ModelPluginTesting, loadingWorks) {
+    EXPECT_EQ(plugin->getName(), "example");
+    EXPECT_TRUE(plugin->provides(MASFENON_MODEL_DISSIPATION));
+    EXPECT_TRUE(plugin->provides(MASFENON_MODEL_CONSERVATION));
+    EXPECT_TRUE(plugin->provides(MASFENON_MODEL_PROPAGATION));
+    EXPECT_THROW(ModelPlugin("nonExistentPlugin.so"), std::invalid_argument);
+    EXPECT_THROW(DissipationModelPlugin(nullptr, 4), std::invalid_argument);
+}
+
+TEST_F(ModelPluginTesting, dissipationMatchesBuiltInModel) {
+    DissipationModelPlugin dissipation(plugin, 4, {0.3});
+    DissipationModelScaled builtIn(0.3);
+    EXPECT_TRUE(arma::approx_equal(dissipation.dissipate(input, 1.0), builtIn.dissipate(input, 1.0), "absdiff", 1e-12));
+    EXPECT_TRUE(arma::approx_equal(dissipation.dissipationTerm(input, 1.0), builtIn.dissipationTerm(input, 1.0), "absdiff", 1e-12));
+    EXPECT_THROW(dissipation.dissipationTerm(arma::Col<double>{1, 2}, 1.0), std::invalid_argument);
+    EXPECT_THROW(dissipation.dissipate(arma::Col<double>{1, 2, 3, 4, 5}, 1.0), std::invalid_argument);
+}
+
+TEST_F(ModelPluginTesting, conservationMatchesBuiltInModel) {
+    ConservationModelPlugin conservation(plugin, 4, {0.2});
+    ConservationModel builtIn(0.2);
+    arma::Mat<double> Wstar = normalize1Rows(graph->getAdjacencyMatrix().asArmadilloMatrix());
+    std::vector<double> q{1, 0.5, 2, 1};
+    EXPECT_TRUE(arma::approx_equal(conservation.conservationTerm(input, Wstar, 1.0, q), builtIn.conservationTerm(input, Wstar, 1.0, q), "absdiff", 1e-12));
+    EXPECT_TRUE(arma::approx_equal(conservation.conservationTerm(input, Wstar, 1.0), builtIn.conservationTerm(input, Wstar, 1.0), "absdiff", 1e-12));
+    EXPECT_FALSE(conservation.getProperties().constantScale);
+    EXPECT_THROW(conservation.conservationTerm(input, Wstar, 1.0, {1, 2}), std::invalid_argument);
+}
+
+TEST_F(ModelPluginTesting, propagationUsesTheAdjacencyMatrix) {
+    PropagationModelPlugin propagation(plugin, graph, {2.0});
+    arma::Mat<double> adjacency = graph->getAdjacencyMatrix().asArmadilloMatrix();
+    EXPECT_TRUE(arma::approx_equal(propagation.propagate(input, 1.0), input + 2.0 * adjacency.t() * input, "absdiff", 1e-12));
+    auto previousEdgeWeights = graph->updateEdgeWeights(std::vector<std::tuple<int,int,double>>{{1,2,4}});
+    propagation.updateEdgeWeights(graph, previousEdgeWeights);
+    adjacency = graph->getAdjacencyMatrix().asArmadilloMatrix();
+    EXPECT_TRUE(arma::approx_equal(propagation.propagationTerm(input, 1.0), 2.0 * adjacency.t() * input, "absdiff", 1e-12));
+    EXPECT_THROW(propagation.propagationTerm(arma::Col<double>{1, 2}, 1.0), std::invalid_argument);
+}
@@ -0,0 +1,84 @@
+/**
+ * @file NameInternerTesting.cc
+ * @ingroup Testing
+ * @brief Contains unit tests for the NameInterner and FlatHashMap classes in MASFENON.
+ * @details The tests cover the stable ids of the interned names, the names of the virtual nodes and the open addressing map.
+ * @warning This file is intended for testing purposes only and should not be used in production code.
+ * @see NameInterner.hxx
+ * @see FlatHashMap.hxx
+ */
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "data_structures/FlatHashMap.hxx"
+#include "utils/NameInterner.hxx"
+
+TEST(NameInternerTesting, namesHaveStableIds) {
+    NameInterner& interner = NameInterner::getInstance();
+    NameId first = interner.intern("NameInternerTesting-a");
+    const std::string& firstName = interner.getName(first);
+    // many new names do not move the names already interned
+    for(int i = 0; i < 1000; i++){
+        interner.intern("NameInternerTesting-" + std::to_string(i));
+    }
+    EXPECT_EQ(interner.intern("NameInternerTesting-a"), first);
+    EXPECT_EQ(interner.find("NameInternerTesting-a"), first);
+    EXPECT_EQ(&interner.getName(first), &firstName);
+    EXPECT_EQ(firstName, "NameInternerTesting-a");
+    EXPECT_EQ(interner.find("NameInternerTesting-never-interned"), NameInterner::invalidId);
+    EXPECT_THROW(interner.getName(NameInterner::invalidId), std::out_of_range);
+}
+
+TEST(NameInternerTesting, virtualNodesHaveTheNamesOfTheAugmentedGraphs) {
+    NameInterner& interner = NameInterner::getInstance();
+    NameId type = interner.intern("NameInternerTesting-type");
+    NameId node = interner.intern("node1");
+    EXPECT_EQ(interner.getName(interner.virtualInput(type)), "v-in:NameInternerTesting-type");
+    EXPECT_EQ(interner.getName(interner.virtualOutput(type, node)), "v-out:NameInternerTesting-type_node1");
+    EXPECT_EQ(interner.virtualOutput(type, node), interner.find("v-out:NameInternerTesting-type_node1"));
+    EXPECT_EQ(interner.virtualInput(type), interner.virtualInput(type));
+    EXPECT_NE(interner.virtualInput(type), interner.virtualOutput(type));
+}
+
+TEST(NameInternerTesting, concurrentInterningGivesTheSameIds) {
+    NameInterner& interner = NameInterner::getInstance();
+    std::vector<std::vector<NameId>> ids(4);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; t++){
+        threads.emplace_back([&interner, &ids, t](){
+            for(int i = 0; i < 500; i++){
+                ids[t].push_back(interner.intern("NameInternerTesting-concurrent-" + std::to_string(i)));
+            }
+        });
+    }
+    for(auto& thread : threads){
+        thread.join();
+    }
+    for(int t = 1; t < 4; t++){
+        EXPECT_EQ(ids[t], ids[0]);
+    }
+}
+
+TEST(FlatHashMapTesting, insertFindAndGrow) {
+    FlatHashMap<uint64_t, int> map;
+    EXPECT_EQ(map.find(3), nullptr);
+    for(int i = 0; i < 1000; i++){
+        EXPECT_TRUE(map.insert_or_assign(static_cast<uint64_t>(i) << 32, i));
+    }
+    EXPECT_FALSE(map.insert_or_assign(uint64_t(7) << 32, -7));
+    EXPECT_EQ(map.size(), 1000u);
+    for(int i = 0; i < 1000; i++){
+        ASSERT_NE(map.find(static_cast<uint64_t>(i) << 32), nullptr);
+        EXPECT_EQ(map.at(static_cast<uint64_t>(i) << 32), i == 7 ? -7 : i);
+    }
+    EXPECT_FALSE(map.contains(1));
+    EXPECT_THROW(map.at(1), std::out_of_range);
+    int sum = 0;
+    map.forEach([&sum](uint64_t, int value){sum += value;});
+    EXPECT_EQ(sum, 999 * 1000 / 2 - 14);
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(0));
+}
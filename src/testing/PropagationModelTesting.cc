@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "computation/PropagationModel.hxx"
 #include "computation/PropagationModelNeighbors.hxx"
+#include "computation/PropagationModelOriginal.hxx"
 #include "data_structures/WeightedEdgeGraph.hxx"
 #include <armadillo>
 #include <functional>
@@ -87,4 +88,19 @@ TEST_F(PropagationModelTesting, propagateWorksWithScaleFunction) {
   EXPECT_DOUBLE_EQ(output(3), 0);
   EXPECT_DOUBLE_EQ(output(4), 1);
   EXPECT_DOUBLE_EQ(output(5), 1);
-}
\ No newline at end of file
+}
+
+TEST_F(PropagationModelTesting, updateEdgeWeightsMatchesNewModel) {
+  PropagationModel* original = new PropagationModelOriginal(q1_);
+  auto previousWeights = q1_->updateEdgeWeights(std::vector<std::tuple<int,int,double>>{{1,2,0.5},{1,4,1.5}});
+  original->updateEdgeWeights(q1_, previousWeights);
+  m1_->updateEdgeWeights(q1_, previousWeights);
+  PropagationModel* originalExpected = new PropagationModelOriginal(q1_);
+  PropagationModel* neighborsExpected = new PropagationModelNeighbors(q1_,[](double time)-> double{return 1;});
+  arma::Col<double> input = {1,2,0,0,1,0};
+  EXPECT_TRUE(arma::approx_equal(original->propagate(input,0), originalExpected->propagate(input,0), "absdiff", 1e-10));
+  EXPECT_TRUE(arma::approx_equal(m1_->propagate(input,0), neighborsExpected->propagate(input,0), "absdiff", 1e-10));
+  delete original;
+  delete originalExpected;
+  delete neighborsExpected;
+}
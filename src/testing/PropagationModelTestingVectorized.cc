@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "computation/PropagationModel.hxx"
+#include "computation/PropagationModelOriginal.hxx"
+#include "computation/PropagationModelVectorized.hxx"
+#include "computation/PropagationModelOriginalVectorized.hxx"
+#include "computation/PropagationModelNeighborsVectorized.hxx"
+#include "computation/PropagationModelCustomVectorized.hxx"
+#include "data_structures/WeightedEdgeGraph.hxx"
+#include <armadillo>
+#include <functional>
+
+class PropagationModelTestingVectorized : public ::testing::Test {
+ protected:
+  void SetUp() override {
+
+    // first scenario, perturbation on nodes 0 and 4
+    input_(0,0) = 1;
+    input_(4,0) = 1;
+    // second scenario, perturbation on node 1
+    input_(1,1) = 1;
+
+    q0_ = new WeightedEdgeGraph(6);
+    q1_ = new WeightedEdgeGraph(6);
+
+    q1_->addEdge(0,1,1);
+    q1_->addEdge(1,2,1);
+    q1_->addEdge(2,3,1);
+    q1_->addEdge(3,4,1);
+    q1_->addEdge(4,5,1);
+
+    // q0_ is a graph with 6 nodes, 0 edges
+    // q1_ is a graph with 6 nodes, 5 edges
+    m0_  = new PropagationModelNeighborsVectorized(q0_);
+    m1_  = new PropagationModelNeighborsVectorized(q1_,[](double time)-> double{return 1;});
+    m2_  = new PropagationModelCustomVectorized(q1_,[](double time)-> arma::Col<double>{return arma::Col<double>{0,1,2,3,4,5};});
+  }
+  void TearDown() override{
+    delete m0_;
+    delete m1_;
+    delete m2_;
+    delete q0_;
+    delete q1_;
+  }
+
+  PropagationModelVectorized* m0_;       //testing default constructor for neighbors model
+  PropagationModelVectorized* m1_;       //testing constructor with scale function for neighbors model
+  PropagationModelVectorized* m2_;       //testing constructor with per node scale function for custom model
+
+  WeightedEdgeGraph *q0_;   // using graph with 6 nodes
+  WeightedEdgeGraph *q1_;   // using graph with 6 nodes and 5 edges
+
+  arma::Mat<double> input_{6,2,arma::fill::zeros};
+};
+
+TEST_F(PropagationModelTestingVectorized, propagateWorksWithDefaultScaleFunction) {
+  arma::Mat<double> output = m0_->propagate(input_,0);
+  ASSERT_EQ(output.n_rows, 6);
+  ASSERT_EQ(output.n_cols, 2);
+  EXPECT_TRUE(arma::approx_equal(output, input_, "absdiff", 1e-12));
+}
+
+TEST_F(PropagationModelTestingVectorized, propagateWorksWithScaleFunctionMultipleScenarios) {
+  arma::Mat<double> output = m1_->propagate(input_,0);
+  arma::Col<double> expectedFirst = {1,1,0,0,1,1};
+  arma::Col<double> expectedSecond = {0,1,1,0,0,0};
+  EXPECT_TRUE(arma::approx_equal(output.col(0), expectedFirst, "absdiff", 1e-12));
+  EXPECT_TRUE(arma::approx_equal(output.col(1), expectedSecond, "absdiff", 1e-12));
+}
+
+TEST_F(PropagationModelTestingVectorized, propagateWorksWithPerNodeScaleFunction) {
+  arma::Mat<double> output = m2_->propagate(input_,0);
+  arma::Col<double> expectedFirst = {1,1,0,0,1,5};
+  arma::Col<double> expectedSecond = {0,1,2,0,0,0};
+  EXPECT_TRUE(arma::approx_equal(output.col(0), expectedFirst, "absdiff", 1e-12));
+  EXPECT_TRUE(arma::approx_equal(output.col(1), expectedSecond, "absdiff", 1e-12));
+  arma::Mat<double> term = m2_->propagationTerm(input_,0);
+  EXPECT_TRUE(arma::approx_equal(term, output - input_, "absdiff", 1e-12));
+}
+
+TEST_F(PropagationModelTestingVectorized, originalModelMatchesSingleColumnModel) {
+  PropagationModel* single = new PropagationModelOriginal(q1_,[](double time)-> double{return 0.7;});
+  PropagationModelVectorized* batched = new PropagationModelOriginalVectorized(q1_,[](double time)-> double{return 0.7;});
+  arma::Mat<double> output = batched->propagate(input_,0);
+  for(arma::uword scenario = 0; scenario < input_.n_cols; scenario++){
+    arma::Col<double> expected = single->propagate(input_.col(scenario),0);
+    EXPECT_TRUE(arma::approx_equal(output.col(scenario), expected, "absdiff", 1e-12));
+  }
+  delete single;
+  delete batched;
+}
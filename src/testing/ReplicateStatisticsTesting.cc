@@ -0,0 +1,98 @@
+/**
+ * @file ReplicateStatisticsTesting.cc
+ * @ingroup Testing
+ * @brief Contains unit tests for the ReplicateStatistics class in MASFENON.
+ * @details The tests cover the streaming mean and variance, the exact quantiles of up to five replicates, the P-square estimates and the saved statistics.
+ * @warning This file is intended for testing purposes only and should not be used in production code.
+ * @see ReplicateStatistics.hxx
+ */
+#include <gtest/gtest.h>
+#include <armadillo>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "data_structures/ReplicateStatistics.hxx"
+
+TEST(ReplicateStatisticsTesting, meanAndVarianceAreStreamed) {
+    ReplicateStatistics statistics(2, 3, {0.5});
+    // the additional value (e.g. a virtual node) is ignored
+    for(double value : {1.0, 2.0, 4.0, 9.0}){
+        statistics.add(1, {value, -value, 100.0});
+    }
+    statistics.add(2, {5.0, 5.0});
+    EXPECT_EQ(statistics.getCount(1), 4u);
+    arma::Mat<double> means = statistics.getMeans();
+    arma::Mat<double> variances = statistics.getVariances();
+    EXPECT_DOUBLE_EQ(means(0, 1), 4.0);
+    EXPECT_DOUBLE_EQ(means(1, 1), -4.0);
+    EXPECT_DOUBLE_EQ(variances(0, 1), (9.0 + 4.0 + 0.0 + 25.0) / 3);
+    // the time without replicates and the variance of a single replicate are not defined
+    EXPECT_TRUE(std::isnan(means(0, 0)));
+    EXPECT_DOUBLE_EQ(means(0, 2), 5.0);
+    EXPECT_TRUE(std::isnan(variances(0, 2)));
+    EXPECT_THROW(statistics.add(3, {1.0, 1.0}), std::invalid_argument);
+    EXPECT_THROW(statistics.add(0, {1.0}), std::invalid_argument);
+    EXPECT_THROW(ReplicateStatistics(1, 1, {1.0}), std::invalid_argument);
+}
+
+TEST(ReplicateStatisticsTesting, quantilesAreExactForFewReplicatesAndEstimatedAfter) {
+    ReplicateStatistics statistics(1, 2, {0.1, 0.5, 0.9});
+    // less than five replicates, linear interpolation of the sorted values
+    for(double value : {3.0, 1.0, 2.0}){
+        statistics.add(0, {value});
+    }
+    EXPECT_DOUBLE_EQ(statistics.getQuantile(1)(0, 0), 2.0);
+    EXPECT_DOUBLE_EQ(statistics.getQuantile(0)(0, 0), 1.2);
+    EXPECT_THROW(statistics.getQuantile(3), std::invalid_argument);
+    // many replicates, the estimates are close to the quantiles of the observations
+    std::mt19937 generator(42);
+    std::normal_distribution<double> distribution(3.0, 2.0);
+    std::vector<double> values;
+    for(int replicate = 0; replicate < 10000; replicate++){
+        values.push_back(distribution(generator));
+        statistics.add(1, {values.back()});
+    }
+    std::sort(values.begin(), values.end());
+    EXPECT_NEAR(statistics.getQuantile(0)(0, 1), values[1000], 0.05);
+    EXPECT_NEAR(statistics.getQuantile(1)(0, 1), values[5000], 0.05);
+    EXPECT_NEAR(statistics.getQuantile(2)(0, 1), values[9000], 0.05);
+    EXPECT_NEAR(statistics.getMeans()(0, 1), 3.0, 0.1);
+    EXPECT_NEAR(statistics.getVariances()(0, 1), 4.0, 0.2);
+}
+
+TEST(ReplicateStatisticsTesting, quantilesAreExactForFiveReplicates) {
+    ReplicateStatistics statistics(1, 1, {0.1, 0.5, 0.9});
+    // the five observations are the initial markers, the tail quantiles are interpolated and not the outer markers
+    for(double value : {5.0, 1.0, 4.0, 2.0, 3.0}){
+        statistics.add(0, {value});
+    }
+    EXPECT_EQ(statistics.getCount(0), 5u);
+    EXPECT_DOUBLE_EQ(statistics.getQuantile(0)(0, 0), 1.4);
+    EXPECT_DOUBLE_EQ(statistics.getQuantile(1)(0, 0), 3.0);
+    EXPECT_DOUBLE_EQ(statistics.getQuantile(2)(0, 0), 4.6);
+}
+
+TEST(ReplicateStatisticsTesting, savedStatisticsHaveTheIterationMatrixLayout) {
+    std::filesystem::path folder = std::filesystem::temp_directory_path() / "ReplicateStatisticsTesting";
+    std::filesystem::create_directories(folder);
+    ReplicateStatistics statistics(2, 2, {0.25});
+    statistics.add(0, {1.0, 2.0});
+    statistics.add(0, {3.0, 2.0});
+    statistics.save(folder.string(), "t0", {"a", "b"}, {0.0, 0.5});
+    for(const std::string& name : {"mean", "variance", "q0.25"}){
+        EXPECT_TRUE(std::filesystem::exists(folder / ("t0_" + name + ".tsv")));
+    }
+    std::ifstream meanFile(folder / "t0_mean.tsv");
+    std::string header, row;
+    std::getline(meanFile, header);
+    std::getline(meanFile, row);
+    EXPECT_EQ(header, "nodeNames\t0\t0.5");
+    EXPECT_EQ(row, "a\t2\tnan");
+    EXPECT_THROW(statistics.save(folder.string(), "t0", {"a"}, {0.0, 0.5}), std::invalid_argument);
+    std::filesystem::remove_all(folder);
+}
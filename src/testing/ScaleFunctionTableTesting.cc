@@ -0,0 +1,86 @@
+/**
+ * @file ScaleFunctionTableTesting.cc
+ * @ingroup Testing
+ * @brief Contains unit tests for the ScaleFunctionTable class in MASFENON.
+ * @details The tests cover the compilation of scaling functions declared piecewise constant and the fallback for the other functions.
+ * @warning This file is intended for testing purposes only and should not be used in production code.
+ * @see ScaleFunctionTable.hxx
+ */
+#include <gtest/gtest.h>
+#include <armadillo>
+#include <cmath>
+#include <functional>
+#include <vector>
+#include "data_structures/ScaleFunctionTable.hxx"
+#include "CustomFunctions.hxx"
+
+class ScaleFunctionTableTesting : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            uniqueFunctions = {getDissipationScalingFunction(), getDissipationScalingFunction({0,-1,2}), getDissipationScalingFunction({1,2,3})};
+        }
+        std::vector<std::function<double(double)>> uniqueFunctions;
+        std::vector<arma::uword> nodeToUniqueFunction = {1,0,2,1,2,0};
+};
+
+TEST_F(ScaleFunctionTableTesting, compiledTableMatchesFunctions) {
+    ScaleFunctionTable table(getScalingFunctionBreakpoints(), uniqueFunctions, nodeToUniqueFunction, true);
+    EXPECT_TRUE(table.isCompiled());
+    EXPECT_EQ(table.getNumNodes(), 6u);
+    EXPECT_EQ(table.getNumUniqueFunctions(), 3u);
+    for(double time : {-3.0, 0.0, 5.0, 5.1, 6.0, 6.1, 10.0, 10.1, 100.0}){
+        arma::Col<double> values = table.evaluate(time);
+        ASSERT_EQ(values.n_elem, 6u);
+        for(size_t i = 0; i < nodeToUniqueFunction.size(); i++){
+            EXPECT_DOUBLE_EQ(values(i), uniqueFunctions[nodeToUniqueFunction[i]](time)) << "Mismatch at time " << time << " index " << i;
+        }
+    }
+}
+
+TEST_F(ScaleFunctionTableTesting, intervalIndexWorks) {
+    ScaleFunctionTable table(getScalingFunctionBreakpoints(), uniqueFunctions, nodeToUniqueFunction);
+    EXPECT_EQ(table.intervalIndex(5.0), 0u);
+    EXPECT_EQ(table.intervalIndex(5.5), 1u);
+    EXPECT_EQ(table.intervalIndex(6.0), 1u);
+    EXPECT_EQ(table.intervalIndex(7.0), 2u);
+    EXPECT_EQ(table.intervalIndex(11.0), 3u);
+    EXPECT_EQ(table.columnIndex(4.0), 0u);
+    EXPECT_EQ(table.columnIndex(5.0), 1u);
+    EXPECT_EQ(table.columnIndex(5.5), 2u);
+    EXPECT_EQ(table.columnIndex(11.0), 6u);
+}
+
+TEST_F(ScaleFunctionTableTesting, valuesAtTheBreakpointsAreCompiled) {
+    // right continuous at the breakpoint, unlike the functions with parameters
+    std::vector<std::function<double(double)>> functions = {[](double time){return time < 5.0 ? 1.0 : 0.0;}};
+    ScaleFunctionTable table({5.0}, functions, {0, 0}, true);
+    EXPECT_TRUE(table.isCompiled());
+    for(double time : {-10.0, 4.99, 5.0, 5.01, 100.0}){
+        arma::Col<double> values = table.evaluate(time);
+        ASSERT_EQ(values.n_elem, 2u);
+        EXPECT_DOUBLE_EQ(values(0), functions[0](time)) << "Mismatch at time " << time;
+        EXPECT_DOUBLE_EQ(values(1), functions[0](time)) << "Mismatch at time " << time;
+    }
+}
+
+TEST_F(ScaleFunctionTableTesting, undeclaredFunctionsAreNotCompiled) {
+    // constant on the three samples (6, nextafter(5), 5.5) of the interval (5,6] but not inside it, so it must not be guessed piecewise constant
+    uniqueFunctions.push_back([](double time){return std::abs(time - 5.75) < 0.1 ? 1.0 : 0.0;});
+    nodeToUniqueFunction.push_back(3);
+    ScaleFunctionTable table(getScalingFunctionBreakpoints(), uniqueFunctions, nodeToUniqueFunction);
+    EXPECT_FALSE(table.isCompiled());
+    auto scaleFunction = table.asFunction();
+    for(double time : {0.0, 5.5, 5.75, 7.3}){
+        arma::Col<double> values = scaleFunction(time);
+        ASSERT_EQ(values.n_elem, 7u);
+        for(size_t i = 0; i < nodeToUniqueFunction.size(); i++){
+            EXPECT_DOUBLE_EQ(values(i), uniqueFunctions[nodeToUniqueFunction[i]](time));
+        }
+    }
+}
+
+TEST_F(ScaleFunctionTableTesting, invalidArgumentsThrow) {
+    EXPECT_THROW(ScaleFunctionTable({6.0, 5.0}, uniqueFunctions, nodeToUniqueFunction), std::invalid_argument);
+    EXPECT_THROW(ScaleFunctionTable(getScalingFunctionBreakpoints(), {}, nodeToUniqueFunction), std::invalid_argument);
+    EXPECT_THROW(ScaleFunctionTable(getScalingFunctionBreakpoints(), uniqueFunctions, {0, 3}), std::invalid_argument);
+}
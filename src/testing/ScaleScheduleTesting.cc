@@ -0,0 +1,156 @@
+/**
+ * @file ScaleScheduleTesting.cc
+ * @ingroup Testing
+ * @brief Contains unit tests for the ScaleSchedule and ScaleSchedulePool classes in MASFENON.
+ * @details The tests cover the precomputation of the scaling values over the time grid and its use in the models.
+ * @warning This file is intended for testing purposes only and should not be used in production code.
+ * @see ScaleSchedule.hxx
+ */
+#include <gtest/gtest.h>
+#include <armadillo>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "computation/ScaleSchedule.hxx"
+#include "computation/ConservationModel.hxx"
+#include "computation/DissipationModelScaled.hxx"
+#include "computation/PropagationModelNeighbors.hxx"
+#include "data_structures/WeightedEdgeGraph.hxx"
+#include "CustomFunctions.hxx"
+
+class ScaleScheduleTesting : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            times = ScaleSchedule::simulationTimeGrid(3, 4, 5);
+            piecewiseFunction = [](double time)-> arma::Col<double>{
+                return arma::Col<double>{getDissipationScalingFunction({0,1,2})(time), getDissipationScalingFunction({3,4,5})(time)};
+            };
+        }
+        std::vector<double> times;
+        std::function<arma::Col<double>(double)> piecewiseFunction;
+};
+
+TEST_F(ScaleScheduleTesting, simulationTimeGridWorks) {
+    ASSERT_EQ(times.size(), 12u);
+    EXPECT_DOUBLE_EQ(times[0], 0);
+    EXPECT_DOUBLE_EQ(times[1], 1.25);
+    EXPECT_DOUBLE_EQ(times[4], 5);
+    EXPECT_DOUBLE_EQ(times[11], 13.75);
+}
+
+TEST_F(ScaleScheduleTesting, scheduleMatchesFunction) {
+    ScaleSchedule schedule(times, piecewiseFunction, 2);
+    for(const auto& time : times){
+        const arma::Col<double>* values = schedule.at(time);
+        ASSERT_NE(values, nullptr);
+        EXPECT_TRUE(arma::approx_equal(*values, piecewiseFunction(time), "absdiff", 0.0));
+    }
+    // consecutive times with the same values share the same column (t<=5 and t>6, no time of the grid is in (5,6])
+    EXPECT_EQ(schedule.getNumStoredColumns(), 2u);
+    EXPECT_EQ(schedule.at(0.3), nullptr);
+}
+
+TEST_F(ScaleScheduleTesting, prefixHashesFollowTheScalingValues) {
+    ScaleSchedule schedule(times, piecewiseFunction, 2);
+    // the second node changes only after time 6
+    ScaleSchedule laterChange(times, [](double time)-> arma::Col<double>{
+        return arma::Col<double>{getDissipationScalingFunction({0,1,2})(time), getDissipationScalingFunction({3,4,9})(time)};
+    }, 2);
+    EXPECT_EQ(schedule.changeTimes(), std::vector<double>({6.25}));
+    EXPECT_EQ(schedule.prefixHash(0), laterChange.prefixHash(0));
+    // the values at the time are not included
+    EXPECT_EQ(schedule.prefixHash(6.25), laterChange.prefixHash(6.25));
+    EXPECT_NE(schedule.prefixHash(7.5), laterChange.prefixHash(7.5));
+    EXPECT_NE(schedule.prefixHash(5), schedule.prefixHash(6.25));
+    EXPECT_TRUE(schedule.prefixHash(100).has_value());
+}
+
+TEST_F(ScaleScheduleTesting, wrongSizeThrows) {
+    EXPECT_THROW(ScaleSchedule(times, piecewiseFunction, 3), std::invalid_argument);
+}
+
+TEST_F(ScaleScheduleTesting, poolSharesIdenticalSchedules) {
+    ScaleSchedulePool pool;
+    auto first = pool.getSchedule(times, [](double time)-> arma::Col<double>{return arma::ones<arma::Col<double>>(4) * 0.5;}, 4);
+    auto second = pool.getSchedule(times, [](double time)-> arma::Col<double>{return arma::ones<arma::Col<double>>(4) * 0.5;}, 4);
+    auto third = pool.getSchedule(times, [](double time)-> arma::Col<double>{return arma::ones<arma::Col<double>>(4) * 0.25;}, 4);
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, third);
+    EXPECT_EQ(pool.size(), 2u);
+}
+
+TEST_F(ScaleScheduleTesting, modelsWithScheduleMatchModelsWithout) {
+    WeightedEdgeGraph graph(4);
+    graph.addEdge(0,1,1);
+    graph.addEdge(1,2,2);
+    graph.addEdge(2,3,1);
+    std::function<double(double)> periodic = [](double time)->double{return 0.5 + 0.25*std::sin(time);};
+    DissipationModelScaled dissipationScheduled(periodic), dissipation(periodic);
+    ConservationModel conservationScheduled(periodic), conservation(periodic);
+    PropagationModelNeighbors propagationScheduled(&graph, periodic), propagation(&graph, periodic);
+    ScaleSchedulePool pool;
+    EXPECT_TRUE(dissipationScheduled.precomputeScaleSchedule(times, 4, &pool));
+    EXPECT_TRUE(conservationScheduled.precomputeScaleSchedule(times, 4, &pool));
+    EXPECT_TRUE(propagationScheduled.precomputeScaleSchedule(times, 4, &pool));
+    // the three models use the same function, so they share the same schedule
+    EXPECT_EQ(pool.size(), 1u);
+    arma::Col<double> input = {1, 2, 0, -1};
+    arma::Mat<double> Wstar = graph.getAdjacencyMatrix().asArmadilloMatrix();
+    for(double time : {times[0], times[5], times[11], 0.3}){
+        EXPECT_TRUE(arma::approx_equal(dissipationScheduled.dissipate(input, time), dissipation.dissipate(input, time), "absdiff", 1e-12));
+        EXPECT_TRUE(arma::approx_equal(conservationScheduled.conservationTerm(input, Wstar, time), conservation.conservationTerm(input, Wstar, time), "absdiff", 1e-12));
+        EXPECT_TRUE(arma::approx_equal(propagationScheduled.propagate(input, time), propagation.propagate(input, time), "absdiff", 1e-12));
+    }
+}
+
+TEST_F(ScaleScheduleTesting, replacedScaleFunctionsMatchNewModels) {
+    WeightedEdgeGraph graph(4);
+    graph.addEdge(0,1,1);
+    graph.addEdge(1,2,2);
+    graph.addEdge(2,3,1);
+    std::function<arma::Col<double>(double)> candidate = [](double time)-> arma::Col<double>{return arma::Col<double>{0.1, 0.2, 0.3, 0.4} * (1 + time);};
+    DissipationModelScaled dissipationReplaced(0.5), dissipation(candidate);
+    ConservationModel conservationReplaced(0.5), conservation(candidate);
+    std::function<double(double)> constant = [](double time)->double{return 0.5;};
+    PropagationModelNeighbors propagationReplaced(&graph, constant), propagation(&graph, candidate);
+    EXPECT_TRUE(dissipationReplaced.getProperties().constantScale);
+    EXPECT_TRUE(propagationReplaced.precomputeScaleSchedule(times, 4));
+    dissipationReplaced.setScaleFunctionVectorized(candidate);
+    conservationReplaced.setScaleFunctionVectorized(candidate);
+    propagationReplaced.setScaleFunctionVectorized(candidate);
+    // the models are no longer constant and the schedule of the previous function is not used anymore
+    EXPECT_FALSE(dissipationReplaced.getProperties().constantScale);
+    EXPECT_FALSE(conservationReplaced.getProperties().constantScale);
+    arma::Col<double> input = {1, 2, 0, -1};
+    arma::Mat<double> Wstar = graph.getAdjacencyMatrix().asArmadilloMatrix();
+    for(double time : {times[0], times[5], 0.3}){
+        EXPECT_TRUE(arma::approx_equal(dissipationReplaced.dissipate(input, time), dissipation.dissipate(input, time), "absdiff", 1e-12));
+        EXPECT_TRUE(arma::approx_equal(conservationReplaced.conservationTerm(input, Wstar, time), conservation.conservationTerm(input, Wstar, time), "absdiff", 1e-12));
+        EXPECT_TRUE(arma::approx_equal(propagationReplaced.propagate(input, time), propagation.propagate(input, time), "absdiff", 1e-12));
+    }
+    EXPECT_TRUE(propagationReplaced.precomputeScaleSchedule(times, 4));
+    EXPECT_TRUE(arma::approx_equal(propagationReplaced.propagate(input, times[5]), propagation.propagate(input, times[5]), "absdiff", 1e-12));
+}
+
+TEST_F(ScaleScheduleTesting, restoredSchedulesMatchPrecomputedOnes) {
+    std::function<arma::Col<double>(double)> first = [](double time)-> arma::Col<double>{return arma::Col<double>{0.1, 0.2} * (1 + time);};
+    std::function<arma::Col<double>(double)> second = [](double time)-> arma::Col<double>{return arma::Col<double>{0.3, 0.4} * (2 + time);};
+    DissipationModelScaled dissipation(first), reference(first);
+    EXPECT_TRUE(dissipation.precomputeScaleSchedule(times, 2));
+    std::shared_ptr<const ScaleSchedule> kept = dissipation.getScaleSchedule();
+    // another candidate replaces the function and its schedule
+    dissipation.setScaleFunctionVectorized(second);
+    EXPECT_TRUE(dissipation.precomputeScaleSchedule(times, 2));
+    EXPECT_NE(dissipation.getScaleSchedule(), kept);
+    // the first candidate is restored without evaluating its function over the grid again
+    dissipation.setScaleFunctionVectorized(first);
+    dissipation.setScaleSchedule(kept);
+    EXPECT_EQ(dissipation.getScaleSchedule(), kept);
+    arma::Col<double> input = {1, -2};
+    for(double time : {times[0], times[5], 0.3}){
+        EXPECT_TRUE(arma::approx_equal(dissipation.dissipate(input, time), reference.dissipate(input, time), "absdiff", 1e-12));
+    }
+    dissipation.setScaleSchedule(nullptr);
+    EXPECT_EQ(dissipation.getScaleSchedule(), nullptr);
+}
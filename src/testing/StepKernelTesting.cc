@@ -0,0 +1,135 @@
+/**
+ * @file StepKernelTesting.cc
+ * @ingroup Testing
+ * @brief Contains unit tests for the StepKernel class template and its selection in MASFENON.
+ * @details The tests cover the selection of the kernels from the models and the equivalence of the specialized kernels with the generic one.
+ * @warning This file is intended for testing purposes only and should not be used in production code.
+ * @see StepKernel.hxx
+ */
+#include <gtest/gtest.h>
+#include <armadillo>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "computation/StepKernel.hxx"
+#include "computation/ConservationModel.hxx"
+#include "computation/DissipationModelPow.hxx"
+#include "computation/DissipationModelScaled.hxx"
+#include "computation/PropagationModelCustom.hxx"
+#include "computation/PropagationModelNeighbors.hxx"
+#include "computation/PropagationModelOriginal.hxx"
+#include "data_structures/WeightedEdgeGraph.hxx"
+#include "utils/armaUtilities.hxx"
+#include "utils/mathUtilities.hxx"
+
+class StepKernelTesting : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            graph = new WeightedEdgeGraph(4);
+            graph->addEdge(0,1,1);
+            graph->addEdge(1,2,2);
+            graph->addEdge(2,3,1);
+            graph->addEdge(3,0,0.5);
+            Wstar = normalize1Rows(graph->getAdjacencyMatrix().asArmadilloMatrix());
+            conservationWeights = Wstar * arma::ones<arma::Col<double>>(4);
+        }
+        void TearDown() override {
+            delete graph;
+        }
+        StepOperands operandsFor(DissipationModel* dissipationModel, PropagationModel* propagationModel, ConservationModel* conservationModel, const std::vector<double>* saturationVector){
+            StepOperands operands;
+            operands.input = &input;
+            operands.time = 1.5;
+            operands.dissipationModel = dissipationModel;
+            operands.propagationModel = propagationModel;
+            operands.conservationModel = conservationModel;
+            operands.dissipationScale = dissipationModel->getProperties().constantValue;
+            operands.conservationScale = conservationModel->getProperties().constantValue;
+            operands.conservationWeights = &conservationWeights;
+            operands.Wstar = &Wstar;
+            operands.q = &q;
+            operands.saturationVector = saturationVector;
+            operands.saturationFunction = &saturationFunction;
+            return operands;
+        }
+        WeightedEdgeGraph* graph;
+        arma::Mat<double> Wstar;
+        arma::Col<double> conservationWeights;
+        arma::Col<double> input = {1, -2, 0.5, 3};
+        std::vector<double> q;
+        BatchSaturationFunction saturationFunction = batchSaturationFromElementwise([](double value, double saturation)->double{
+            if(value > saturation) return saturation;
+            else if (value < -saturation) return -saturation;
+            else return value;
+        });
+};
+
+TEST_F(StepKernelTesting, kernelSelectionWorks) {
+    DissipationModelScaled noDissipation(0.0), constantDissipation(0.3), genericDissipation([](double time)->double{return 0.3;});
+    ConservationModel noConservation(0.0), constantConservation(0.2), genericConservation([](double time)->double{return 0.2;});
+    PropagationModelOriginal original(graph);
+    PropagationModelNeighbors neighbors(graph);
+    PropagationModelCustom custom(graph);
+    EXPECT_EQ(makeStepKernel(&noDissipation, &neighbors, &noConservation, true)->description(), "identity/neighbors/zero/clamp");
+    EXPECT_EQ(makeStepKernel(&constantDissipation, &original, &constantConservation, false)->description(), "constant/original/constant/generic");
+    EXPECT_EQ(makeStepKernel(&genericDissipation, &custom, &genericConservation, true)->description(), "generic/generic/generic/clamp");
+    EXPECT_TRUE(makeStepKernel(&genericDissipation, &custom, &genericConservation, true)->needsNormalizedAdjacency());
+    EXPECT_TRUE(makeStepKernel(&noDissipation, &custom, &constantConservation, true)->needsConservationWeights());
+    EXPECT_THROW(makeStepKernel(nullptr, &custom, &genericConservation, true), std::invalid_argument);
+}
+
+TEST_F(StepKernelTesting, specializedKernelsMatchGenericKernel) {
+    PropagationModelNeighbors neighbors(graph, [](double time)->double{return 0.8;});
+    PropagationModelOriginal original(graph);
+    std::vector<double> saturationVector(4, 1.0);
+    for(PropagationModel* propagationModel : std::vector<PropagationModel*>{&neighbors, &original}){
+        for(double dissipationScale : {0.0, 0.3}){
+            for(double conservationScale : {0.0, 0.2}){
+                DissipationModelScaled dissipationSpecialized(dissipationScale);
+                DissipationModelScaled dissipationGeneric([dissipationScale](double time)->double{return dissipationScale;});
+                ConservationModel conservationSpecialized(conservationScale);
+                ConservationModel conservationGeneric([conservationScale](double time)->double{return conservationScale;});
+                for(const std::vector<double>* saturation : {static_cast<const std::vector<double>*>(nullptr), &saturationVector}){
+                    StepOperands specializedOperands = operandsFor(&dissipationSpecialized, propagationModel, &conservationSpecialized, saturation);
+                    StepOperands genericOperands = operandsFor(&dissipationGeneric, propagationModel, &conservationGeneric, saturation);
+                    arma::Col<double> specialized = makeStepKernel(&dissipationSpecialized, propagationModel, &conservationSpecialized, true)->step(specializedOperands);
+                    arma::Col<double> generic = makeStepKernel(&dissipationGeneric, propagationModel, &conservationGeneric, false)->step(genericOperands);
+                    EXPECT_TRUE(arma::approx_equal(specialized, generic, "absdiff", 1e-12));
+                    if(saturation != nullptr){
+                        EXPECT_TRUE(arma::all(arma::abs(specialized) <= 1.0));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_F(StepKernelTesting, genericDissipationUsesTheModel) {
+    DissipationModelPow dissipation(2);
+    ConservationModel conservation(0.0);
+    PropagationModelNeighbors neighbors(graph);
+    StepOperands operands = operandsFor(&dissipation, &neighbors, &conservation, nullptr);
+    arma::Col<double> output = makeStepKernel(&dissipation, &neighbors, &conservation, true)->step(operands);
+    EXPECT_TRUE(arma::approx_equal(output, neighbors.propagate(dissipation.dissipate(input, 1.5), 1.5), "absdiff", 1e-12));
+}
+
+TEST_F(StepKernelTesting, batchSaturationFunctionsWork) {
+    std::vector<double> values{-3, -0.5, 0, 0.5, 3, 1e4};
+    std::vector<double> saturations{1, 1, 2, 0.25, 2, 1};
+    std::vector<double> clamped = values;
+    clampSaturationBatch(clamped.data(), saturations.data(), clamped.size());
+    std::vector<double> elementwise = values;
+    saturationFunction(elementwise.data(), saturations.data(), elementwise.size());
+    EXPECT_EQ(clamped, elementwise);
+    EXPECT_EQ(clamped, std::vector<double>({-1, -0.5, 0, 0.25, 2, 1}));
+    // the scaled hyperbolic tangent does not overflow for large values
+    std::vector<double> tanhSaturated = values;
+    hyperbolicTangentScaledBatch(tanhSaturated.data(), saturations.data(), tanhSaturated.size());
+    for(size_t i = 0; i < values.size(); i++){
+        EXPECT_FALSE(std::isnan(tanhSaturated[i]));
+        EXPECT_NEAR(tanhSaturated[i], hyperbolicTangentScaled(values[i], saturations[i]), 1e-12);
+        EXPECT_LE(std::abs(tanhSaturated[i]), saturations[i]);
+    }
+    EXPECT_DOUBLE_EQ(hyperbolicTangentScaled(1e4, 1), 1.0);
+}
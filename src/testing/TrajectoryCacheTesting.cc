@@ -0,0 +1,105 @@
+/**
+ * @file TrajectoryCacheTesting.cc
+ * @ingroup Testing
+ * @brief Contains unit tests for the TrajectoryCache class in MASFENON.
+ * @details The tests cover the keys of the states, the least recently used eviction and the states reached with the same scaling values.
+ * @warning This file is intended for testing purposes only and should not be used in production code.
+ * @see TrajectoryCache.hxx
+ */
+#include <gtest/gtest.h>
+#include <armadillo>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include "checkpoint/TrajectoryCache.hxx"
+#include "computation/Computation.hxx"
+#include "computation/ConservationModel.hxx"
+#include "computation/DissipationModelScaled.hxx"
+#include "computation/PropagationModelNeighbors.hxx"
+#include "computation/ScaleSchedule.hxx"
+#include "data_structures/Matrix.hxx"
+#include "CustomFunctions.hxx"
+
+namespace {
+    TrajectorySnapshot snapshotAt(int interIteration, double value){
+        TrajectorySnapshot snapshot;
+        snapshot.interIteration = interIteration;
+        snapshot.states = {{value, value}};
+        return snapshot;
+    }
+}
+
+TEST(TrajectoryCacheTesting, keysDependOnAllTheParts) {
+    EXPECT_EQ(TrajectoryCache::key(0, 2, 7), TrajectoryCache::key(0, 2, 7));
+    EXPECT_NE(TrajectoryCache::key(0, 2, 7), TrajectoryCache::key(1, 2, 7));
+    EXPECT_NE(TrajectoryCache::key(0, 2, 7), TrajectoryCache::key(0, 3, 7));
+    EXPECT_NE(TrajectoryCache::key(0, 2, 7), TrajectoryCache::key(0, 2, 8));
+    EXPECT_THROW(TrajectoryCache(0), std::invalid_argument);
+}
+
+TEST(TrajectoryCacheTesting, leastRecentlyUsedStateIsRemoved) {
+    TrajectoryCache cache(2);
+    cache.store(1, snapshotAt(1, 0.1));
+    cache.store(2, snapshotAt(2, 0.2));
+    // the first state becomes the most recently used, the second one is removed by the third
+    ASSERT_NE(cache.find(1), nullptr);
+    cache.store(3, snapshotAt(3, 0.3));
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_EQ(cache.find(2), nullptr);
+    const TrajectorySnapshot* snapshot = cache.find(3);
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(snapshot->interIteration, 3);
+    EXPECT_DOUBLE_EQ(snapshot->states[0][1], 0.3);
+    // the same key replaces the state
+    cache.store(3, snapshotAt(4, 0.4));
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.find(3)->interIteration, 4);
+    EXPECT_EQ(cache.getHits(), 3u);
+    EXPECT_EQ(cache.getMisses(), 1u);
+}
+
+TEST(TrajectoryCacheTesting, sameScalesBeforeTheTimeGiveTheSameState) {
+    std::vector<double> matrixVector{0,0.3,0,
+                                     0,0,0.7,
+                                     0.2,0,0};
+    Matrix<double> W(matrixVector,3,3);
+    std::vector<double> times = ScaleSchedule::simulationTimeGrid(4, 2, 2);
+    ConservationModel conservation(0.0);
+    // the dissipation scaling values are the same until time 7, only the last parameter is different
+    auto simulateUntil = [&](double lastParameter, double endTime, std::optional<uint64_t>* firstHash, std::optional<uint64_t>* secondHash)-> std::vector<double>{
+        Computation computation("type1", {1.0, 0.5, -0.5}, W, {"n1", "n2", "n3"});
+        computation.augmentGraphNoComputeInverse({"type1", "type2"});
+        arma::uword numNodes = computation.getAugmentedGraph()->getNumNodes();
+        DissipationModelScaled dissipation(std::function<arma::Col<double>(double)>([lastParameter, numNodes](double time)-> arma::Col<double>{
+            return arma::ones<arma::Col<double>>(numNodes) * getDissipationScalingFunction({0.1, 0.2, lastParameter})(time);
+        }));
+        PropagationModelNeighbors propagation(computation.getAugmentedGraph(), std::function<double(double)>([](double time)->double{return 0.5;}));
+        computation.setDissipationModel(&dissipation);
+        computation.setConservationModel(&conservation);
+        computation.setPropagationModel(&propagation);
+        computation.precomputeScaleSchedules(times);
+        EXPECT_EQ(computation.scaleChangeTimes(), std::vector<double>({6.0, 7.0}));
+        *firstHash = computation.scalePrefixHash(7.0);
+        *secondHash = computation.scalePrefixHash(8.0);
+        for(double time : times){
+            if(time >= endTime){
+                break;
+            }
+            computation.computeAugmentedPerturbationEnhanced4(time);
+            computation.updateInput(std::vector<double>(), true);
+        }
+        return computation.getInputAugmented();
+    };
+    std::optional<uint64_t> firstHashAt7, firstHashAt8, secondHashAt7, secondHashAt8;
+    std::vector<double> firstState = simulateUntil(0.3, 7.0, &firstHashAt7, &firstHashAt8);
+    std::vector<double> secondState = simulateUntil(0.6, 7.0, &secondHashAt7, &secondHashAt8);
+    ASSERT_TRUE(firstHashAt7.has_value());
+    EXPECT_EQ(firstHashAt7, secondHashAt7);
+    EXPECT_NE(firstHashAt8, secondHashAt8);
+    // the states before the first different scaling value are the same, after it they are different
+    EXPECT_EQ(firstState, secondState);
+    EXPECT_NE(simulateUntil(0.3, 8.0, &firstHashAt7, &firstHashAt8), simulateUntil(0.6, 8.0, &secondHashAt7, &secondHashAt8));
+}
@@ -53,4 +53,37 @@ TEST_F(armaUtilitiesTesting, matrixInitializationWorks) {
     EXPECT_EQ(identity(2,0), 0);
     EXPECT_EQ(identity(2,1), 0);
     EXPECT_EQ(identity(2,2), 1);
-}
\ No newline at end of file
+}
+
+TEST_F(armaUtilitiesTesting, shermanMorrisonColumnUpdateWorks) {
+    arma::Mat<double> A = {{4,1,0},{1,3,1},{0,1,2}};
+    arma::Mat<double> inverse = arma::inv(A);
+    arma::Col<double> newColumn = {2,-1,5};
+    arma::Col<double> columnDelta = newColumn - A.col(1);
+    EXPECT_TRUE(shermanMorrisonColumnUpdate(inverse, columnDelta, 1));
+    A.col(1) = newColumn;
+    EXPECT_TRUE(arma::approx_equal(inverse, arma::inv(A), "absdiff", 1e-10));
+}
+
+TEST_F(armaUtilitiesTesting, shermanMorrisonColumnUpdateSingular) {
+    arma::Mat<double> inverse = arma::inv(identity);
+    arma::Mat<double> inverseBefore = inverse;
+    // changing the first column of the identity to zeros makes the matrix singular
+    arma::Col<double> columnDelta = {-1,0,0};
+    EXPECT_FALSE(shermanMorrisonColumnUpdate(inverse, columnDelta, 0));
+    EXPECT_TRUE(arma::approx_equal(inverse, inverseBefore, "absdiff", 1e-12));
+    EXPECT_THROW(shermanMorrisonColumnUpdate(inverse, arma::Col<double>(2,arma::fill::zeros), 0), std::invalid_argument);
+}
+
+TEST_F(armaUtilitiesTesting, pseudoinverseWithInvertibilityWorks) {
+    bool invertible = false;
+    arma::Mat<double> A = {{4,1,0},{1,3,1},{0,1,2}};
+    arma::Mat<double> pseudoinverse = pseudoinverseWithInvertibility(A, invertible);
+    EXPECT_TRUE(invertible);
+    EXPECT_TRUE(arma::approx_equal(pseudoinverse, arma::inv(A), "absdiff", 1e-10));
+    // the last row is the sum of the first two
+    arma::Mat<double> singular = {{1,2,3},{4,5,6},{5,7,9}};
+    pseudoinverse = pseudoinverseWithInvertibility(singular, invertible);
+    EXPECT_FALSE(invertible);
+    EXPECT_TRUE(arma::approx_equal(pseudoinverse, arma::pinv(singular), "absdiff", 1e-10));
+}
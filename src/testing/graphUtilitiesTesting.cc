@@ -869,4 +869,25 @@ TEST_F(GraphUtilitiesTesting, testUnweightedShortestPathFloydWarshall){
         }
     }
 
-}
\ No newline at end of file
+}
+
+TEST_F(GraphUtilitiesTesting, ChangedNormalizedColumnsTest) {
+    auto previousWeights = graph3->updateEdgeWeights(std::vector<std::tuple<std::string,std::string,double>>{{"node1","node2",3.5}});
+    auto changedColumns = changedNormalizedColumns(*graph3, previousWeights);
+    ASSERT_EQ(changedColumns.size(), 1);
+    ASSERT_TRUE(changedColumns.contains(0));
+    // node1 has edges to node2 (1.0 -> 3.5) and node3 (1.5)
+    EXPECT_NEAR(changedColumns[0].first(1), 1.0/2.5, 1e-12);
+    EXPECT_NEAR(changedColumns[0].first(2), 1.5/2.5, 1e-12);
+    EXPECT_NEAR(changedColumns[0].second(1), 3.5/5.0, 1e-12);
+    EXPECT_NEAR(changedColumns[0].second(2), 1.5/5.0, 1e-12);
+    // the new column is the same column of the operator built from scratch
+    std::vector<double> normalizationFactors(graph3->getNumNodes(),0);
+    for (int i = 0; i < graph3->getNumNodes(); i++) {
+        for(int j = 0; j < graph3->getNumNodes();j++){
+            normalizationFactors[i] += std::abs(graph3->getEdgeWeight(i,j));
+        }
+    }
+    arma::Mat<double> Wmat = graph3->getAdjacencyMatrix().transpose().normalizeByVectorColumn(normalizationFactors).asArmadilloMatrix();
+    EXPECT_TRUE(arma::approx_equal(Wmat.col(0), changedColumns[0].second, "absdiff", 1e-12));
+}
@@ -11,6 +11,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -83,6 +84,67 @@ TEST_F(utilitiesTesting, dissipationScalingFunctionFromFileWorksFullParametersOr
     }
 }
 
+TEST_F(utilitiesTesting, scalingParameterSensitivitiesFromFileWorks) {
+    std::string fileName = "../data/testdata/testHeterogeneousTemporalGraphMultipleInteractions/parameters/dissipationParameters/t0.tsv";
+    std::vector<SensitivityParameter> parameters = scalingParameterSensitivitiesFromFile(fileName, orderedNodeNames_t0, SensitivityTarget::dissipation);
+    // three parameters for every node, in the order of the file
+    ASSERT_EQ(parameters.size(), 18u);
+    EXPECT_EQ(parameters[0].name, "dissipation:a0:p0");
+    EXPECT_EQ(parameters[10].name, "dissipation:e0:p1");
+    EXPECT_EQ(parameters[10].node, 3u);
+    EXPECT_EQ(parameters[10].target, SensitivityTarget::dissipation);
+    // the custom function is piecewise constant, the derivative with respect to a parameter is 1 in its interval and 0 elsewhere
+    for(double time : {0.0, 5.0, 5.5, 6.1, 20.0}){
+        EXPECT_NEAR(parameters[9].scaleDerivative(time), time <= 5.0 ? 1.0 : 0.0, 1e-6) << "time " << time;
+        EXPECT_NEAR(parameters[10].scaleDerivative(time), (time > 5.0 && time <= 6.0) ? 1.0 : 0.0, 1e-6) << "time " << time;
+        EXPECT_NEAR(parameters[11].scaleDerivative(time), time > 6.0 ? 1.0 : 0.0, 1e-6) << "time " << time;
+    }
+    // with an expression the derivatives follow the expression
+    parameters = scalingParameterSensitivitiesFromFile(fileName, orderedNodeNames_t0, SensitivityTarget::propagation, "p[0] + p[1]*t + p[2]*p[2]");
+    ASSERT_EQ(parameters.size(), 18u);
+    EXPECT_EQ(parameters[3].name, "propagation:b0:p0");
+    EXPECT_NEAR(parameters[3].scaleDerivative(2.0), 1.0, 1e-6);
+    EXPECT_NEAR(parameters[4].scaleDerivative(2.0), 2.0, 1e-6);
+    EXPECT_NEAR(parameters[5].scaleDerivative(2.0), 4.0, 1e-6);
+    EXPECT_THROW(scalingParameterSensitivitiesFromFile("missing.tsv", orderedNodeNames_t0, SensitivityTarget::dissipation), std::invalid_argument);
+}
+
+TEST_F(utilitiesTesting, dissipationScalingFunctionFromFileExpressionsAreNotFrozen) {
+    std::string fileName = "../data/testdata/testHeterogeneousTemporalGraphMultipleInteractions/parameters/dissipationParameters/t0.tsv";
+    // not piecewise constant in t (abs is not a comparison with a constant), and equal to 0 on the points t=10, t=6+, t=8 that would be sampled in (6,10]
+    auto scaleFunction = dissipationScalingFunctionFromFile(fileName, orderedNodeNames_t0, "abs(t-8) < 1 ? 1 : p[0]");
+    for(double time : {6.5, 7.5, 8.0, 8.5, 9.5, 10.0}){
+        arma::Col<double> result = scaleFunction(time);
+        ASSERT_EQ(result.n_elem, orderedNodeNames_t0.size());
+        for(size_t i = 0; i < result.n_elem; ++i){
+            EXPECT_DOUBLE_EQ(result(i), std::abs(time - 8) < 1 ? 1.0 : 0.0) << "Mismatch at time " << time << " index " << i;
+        }
+    }
+    // piecewise constant expressions are still exact at the breakpoints and inside the intervals
+    scaleFunction = dissipationScalingFunctionFromFile(fileName, orderedNodeNames_t0, "t < 7 ? p[1] : p[2]");
+    for(double time : {6.5, 7.0, 7.5}){
+        arma::Col<double> result = scaleFunction(time);
+        ASSERT_EQ(result.n_elem, orderedNodeNames_t0.size());
+        EXPECT_DOUBLE_EQ(result(1), time < 7 ? -1.0 : 2.0) << "Mismatch at time " << time;
+    }
+}
+
+TEST_F(utilitiesTesting, edgeWeightUpdatesFromFileWorks) {
+    std::string fileName = "../data/testdata/testHeterogeneousTemporalGraphMultipleInteractions/edgeWeightUpdates.tsv";
+    auto updates = edgeWeightUpdatesFromFile(fileName);
+    ASSERT_EQ(updates.size(), 2);
+    // the updates of the same type and time keep the order of the file
+    ASSERT_EQ(updates["t0"].size(), 2);
+    ASSERT_EQ(updates["t0"][2].size(), 2);
+    EXPECT_EQ(updates["t0"][2][0], std::make_tuple(std::string("a0"), std::string("b0"), 0.5));
+    EXPECT_EQ(updates["t0"][2][1], std::make_tuple(std::string("b0"), std::string("e0"), 0.25));
+    ASSERT_EQ(updates["t0"][4.5].size(), 1);
+    EXPECT_EQ(updates["t0"][4.5][0], std::make_tuple(std::string("a0"), std::string("b0"), 1.0));
+    ASSERT_EQ(updates["t1"][2].size(), 1);
+    EXPECT_EQ(updates["t1"][2][0], std::make_tuple(std::string("v-in:t0"), std::string("a1"), 0.3));
+    EXPECT_THROW(edgeWeightUpdatesFromFile("../data/testdata/testHeterogeneousTemporalGraphMultipleInteractions/notExisting.tsv"), std::invalid_argument);
+}
+
 TEST_F(utilitiesTesting, dissipationScalingFunctionFromFileWorksPartialParametersUnorderedPartial) {
     std::string fileName = "../data/testdata/testHeterogeneousTemporalGraphMultipleInteractions/parameters/dissipationParametersUnorderedPartial/t0.tsv";
     auto scaleFunction = dissipationScalingFunctionFromFile(fileName, orderedNodeNames_t0);
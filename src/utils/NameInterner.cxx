@@ -0,0 +1,81 @@
+/**
+ * @file NameInterner.cxx
+ * @ingroup Core
+ * @brief Implements the NameInterner class, the global table of the interned names.
+ */
+#include "utils/NameInterner.hxx"
+#include <mutex>
+#include <stdexcept>
+
+NameId NameInterner::internLocked(std::string_view name){
+    const NameId* id = ids.find(name);
+    if(id != nullptr){
+        return *id;
+    }
+    NameId newId = static_cast<NameId>(names.size());
+    names.emplace_back(name);
+    ids.insert_or_assign(std::string_view(names.back()), newId);
+    return newId;
+}
+
+NameId NameInterner::intern(std::string_view name){
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        const NameId* id = ids.find(name);
+        if(id != nullptr){
+            return *id;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return internLocked(name);
+}
+
+NameId NameInterner::find(std::string_view name) const{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    const NameId* id = ids.find(name);
+    return id != nullptr ? *id : invalidId;
+}
+
+const std::string& NameInterner::getName(NameId id) const{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if(id >= names.size()){
+        throw std::out_of_range("[ERROR] NameInterner::getName: the id " + std::to_string(id) + " was not assigned to any name");
+    }
+    return names[id];
+}
+
+NameId NameInterner::virtualNode(std::string_view prefix, FlatHashMap<uint64_t, NameId>& cache, NameId type, NameId node){
+    uint64_t key = pairKey(type, node);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        const NameId* id = cache.find(key);
+        if(id != nullptr){
+            return *id;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if(type >= names.size() || (node != invalidId && node >= names.size())){
+        throw std::out_of_range("[ERROR] NameInterner::virtualNode: the type or the node id was not assigned to any name");
+    }
+    // same format of the virtual nodes added to the augmented graphs, see Computation::augmentGraph
+    std::string name = std::string(prefix) + names[type];
+    if(node != invalidId){
+        name += "_" + names[node];
+    }
+    NameId id = internLocked(name);
+    cache.insert_or_assign(key, id);
+    return id;
+}
+
+NameId NameInterner::virtualInput(NameId type, NameId node){
+    return virtualNode("v-in:", virtualInputs, type, node);
+}
+
+NameId NameInterner::virtualOutput(NameId type, NameId node){
+    return virtualNode("v-out:", virtualOutputs, type, node);
+}
+
+size_t NameInterner::size() const{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return names.size();
+}
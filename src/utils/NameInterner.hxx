@@ -0,0 +1,110 @@
+/**
+ * @file NameInterner.hxx
+ * @ingroup Core
+ * @brief Defines the NameInterner class, the global table of the names of the nodes, the types and the virtual nodes.
+ * @details Every name is stored once and identified by a stable integer id, so the structures used in the simulation loop
+ * are keyed by integers: after the setup no name is built, hashed or compared while the iterations are computed.
+ * The names of the virtual nodes (v-in:type, v-out:type_node) are built only the first time they are requested for a type and a node.
+ */
+#pragma once
+
+#include "data_structures/FlatHashMap.hxx"
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Integer identifier of an interned name.
+ */
+using NameId = uint32_t;
+
+/**
+ * @class NameInterner
+ * @brief Singleton table that maps the names to stable integer ids and back.
+ * @details The ids are assigned in the order of interning and never change, the references returned by getName stay valid for the whole program.
+ * @note The table is guarded by a shared mutex, so the names can be interned by more threads while the computations are built.
+ */
+class NameInterner{
+    public:
+        static constexpr NameId invalidId = std::numeric_limits<NameId>::max(); ///< id returned for the names that were never interned
+        /**
+         * @brief Singleton instance accessor for the NameInterner.
+         * @return Reference to the NameInterner instance.
+         */
+        static NameInterner& getInstance(){
+            static NameInterner instance;
+            return instance;
+        }
+        NameInterner(const NameInterner&) = delete;
+        NameInterner& operator=(const NameInterner&) = delete;
+        /**
+         * @brief Get the id of a name, interning it if it is new.
+         * @param name The name.
+         * @return The id of the name.
+         */
+        NameId intern(std::string_view name);
+        /**
+         * @brief Get the id of a name without interning it.
+         * @param name The name.
+         * @return The id of the name, invalidId if the name was never interned.
+         */
+        NameId find(std::string_view name) const;
+        /**
+         * @brief Get the name of an id.
+         * @param id The id.
+         * @return The name, the reference is valid for the whole program.
+         * @throw std::out_of_range if the id was not assigned.
+         */
+        const std::string& getName(NameId id) const;
+        /**
+         * @brief Get the id of the virtual input node of a type, and of a node of the type if specified (v-in:type or v-in:type_node).
+         * @param type The id of the type.
+         * @param node The id of the node, invalidId for the virtual input of the whole type.
+         * @return The id of the name of the virtual input node.
+         */
+        NameId virtualInput(NameId type, NameId node = invalidId);
+        /**
+         * @brief Get the id of the virtual output node of a type, and of a node of the type if specified (v-out:type or v-out:type_node).
+         * @param type The id of the type.
+         * @param node The id of the node, invalidId for the virtual output of the whole type.
+         * @return The id of the name of the virtual output node.
+         */
+        NameId virtualOutput(NameId type, NameId node = invalidId);
+        /**
+         * @brief Get the number of interned names.
+         * @return The number of names.
+         */
+        size_t size() const;
+        /**
+         * @brief Pack the id of a type and the id of a node in a single key.
+         * @param type The id of the type.
+         * @param node The id of the node, invalidId for the whole type.
+         * @return The key, used by the tables of the virtual nodes.
+         */
+        static uint64_t pairKey(NameId type, NameId node = invalidId){return (static_cast<uint64_t>(type) << 32) | node;}
+    private:
+        NameInterner() = default;
+        /**
+         * @brief Get the id of a virtual node name, building the name only the first time.
+         * @param prefix The prefix of the virtual node (v-in: or v-out:).
+         * @param cache The table of the virtual nodes with the same prefix.
+         * @param type The id of the type.
+         * @param node The id of the node, invalidId for the whole type.
+         * @return The id of the name of the virtual node.
+         */
+        NameId virtualNode(std::string_view prefix, FlatHashMap<uint64_t, NameId>& cache, NameId type, NameId node);
+        /**
+         * @brief Intern a name, the lock must be held by the caller.
+         * @param name The name.
+         * @return The id of the name.
+         */
+        NameId internLocked(std::string_view name);
+        std::deque<std::string> names; ///< the interned names, indexed by id (the deque does not move the strings when growing)
+        FlatHashMap<std::string_view, NameId> ids; ///< ids of the names, the views point to the strings in names
+        FlatHashMap<uint64_t, NameId> virtualInputs; ///< ids of the virtual input names, keyed by the pair (type, node)
+        FlatHashMap<uint64_t, NameId> virtualOutputs; ///< ids of the virtual output names, keyed by the pair (type, node)
+        mutable std::shared_mutex mutex; ///< guards the tables
+};
@@ -24,6 +24,27 @@ void print_mat(arma::mat my_matrix){
     std::cout << "--------\n";
 }
 
+bool shermanMorrisonColumnUpdate(arma::Mat<double>& inverse, const arma::Col<double>& columnDelta, arma::uword column, double tolerance){
+    if(!inverse.is_square() || inverse.n_rows != columnDelta.n_elem || column >= inverse.n_cols){
+        throw std::invalid_argument("[ERROR] shermanMorrisonColumnUpdate: the sizes of the inverse and of the column delta are not compatible. abort");
+    }
+    // (A + u e_c^T)^-1 = A^-1 - (A^-1 u)(e_c^T A^-1) / (1 + e_c^T A^-1 u)
+    arma::Col<double> inverseTimesDelta = inverse * columnDelta;
+    double denominator = 1.0 + inverseTimesDelta(column);
+    if(std::abs(denominator) < tolerance){
+        return false;
+    }
+    arma::Row<double> inverseRow = inverse.row(column);
+    inverse -= (inverseTimesDelta / denominator) * inverseRow;
+    return true;
+}
+
+arma::Mat<double> pseudoinverseWithInvertibility(const arma::Mat<double>& matr, bool& invertible, double rcondThreshold){
+    // the determinant underflows or overflows for large graphs, the reciprocal condition number does not
+    invertible = matr.is_empty() || arma::rcond(matr) > rcondThreshold;
+    return arma::pinv(matr);
+}
+
 template<typename T>
 arma::Mat<T> normalizeColumns(arma::Mat<T> matr){
     arma::Mat<T> normalizedMatr(matr.n_rows, matr.n_cols);
@@ -105,6 +105,28 @@ arma::Mat<T> normalize1Columns(arma::Mat<T> matr);
 template<typename T>
 arma::Mat<T> normalize1Rows(arma::Mat<T> matr);
 
+/**
+ * @brief  update the inverse of a matrix after one of its columns has changed (Sherman-Morrison formula)
+ * @param inverse the inverse of the matrix A, updated in place to the inverse of A + columnDelta * e_column^T
+ * @param columnDelta the difference between the new and the previous column of A
+ * @param column the index of the changed column
+ * @param tolerance the minimum absolute value of the Sherman-Morrison denominator for the update to be considered stable
+ * @return true if the inverse was updated, false if the updated matrix is (numerically) singular and the inverse was left untouched
+ * @details  The update costs O(n^2) instead of the O(n^3) of a new inversion
+ * @throw std::invalid_argument if the sizes of the inverse and of the column are not compatible
+ */
+bool shermanMorrisonColumnUpdate(arma::Mat<double>& inverse, const arma::Col<double>& columnDelta, arma::uword column, double tolerance = 1e-12);
+
+/**
+ * @brief  compute the pseudoinverse of a square matrix and whether the matrix is numerically invertible
+ * @param matr the square matrix
+ * @param invertible set to true if the reciprocal condition number of the matrix is above the threshold, in which case the pseudoinverse is the inverse
+ * @param rcondThreshold the minimum reciprocal condition number for the matrix to be considered invertible
+ * @return the pseudoinverse of the matrix
+ * @details  The reciprocal condition number is estimated once, together with the pseudoinverse, so callers can decide whether rank-1 updates of the inverse are safe
+ */
+arma::Mat<double> pseudoinverseWithInvertibility(const arma::Mat<double>& matr, bool& invertible, double rcondThreshold = 1e-12);
+
 /**
  * @brief  print a Armadillo matrix
  * @param my_matrix the Armadillo matrix
@@ -6,7 +6,7 @@ double weighted_graph_metrics::averageEdgeWeight(const WeightedEdgeGraph& graph)
     }
     
     double totalWeight = 0.0;
-    for (const auto& edge : graph.edgesVector) {
+    for (const auto& edge : graph.getEdgesVector()) {
         totalWeight += std::get<2>(edge); // Get the weight from the tuple (node1ID, node2ID, weight)
     }
     
@@ -21,7 +21,7 @@ std::pair<std::string,double> weighted_graph_metrics::maxEdgeWeight(const Weight
     double maxWeight = std::numeric_limits<double>::lowest(); // Initialize to the lowest possible value
     std::string maxNodeName = ""; // Initialize an empty string for the node name
     std::pair<std::string, double> maxEdge; // Initialize a pair to hold the maximum edge information
-    for (const auto& edge : graph.edgesVector) {
+    for (const auto& edge : graph.getEdgesVector()) {
         //maxWeight = std::max(maxWeight, std::get<2>(edge)); // Get the weight from the tuple and find the maximum
         if(std::get<2>(edge) > maxWeight) {
             maxWeight = std::get<2>(edge); // Update the maximum weight
@@ -41,7 +41,7 @@ std::pair<std::string,double> weighted_graph_metrics::minEdgeWeight(const Weight
     double minWeight = std::numeric_limits<double>::max(); // Initialize to the maximum possible value
     std::string minNodeName = ""; // Initialize an empty string for the node name
     std::pair<std::string, double> minEdge; // Initialize a pair to hold the minimum edge information
-    for (const auto& edge : graph.edgesVector) {
+    for (const auto& edge : graph.getEdgesVector()) {
         //minWeight = std::min(minWeight, std::get<2>(edge)); // Get the weight from the tuple and find the minimum
         if(std::get<2>(edge) < minWeight) {
             minWeight = std::get<2>(edge); // Update the minimum weight
@@ -517,7 +517,7 @@ double weighted_graph_metrics::weightedPathWeight(const WeightedEdgeGraph& graph
 
 
 bool weighted_graph_metrics::hasNegativeWeights(const WeightedEdgeGraph& graph){
-    for (const auto& edge : graph.edgesVector) {
+    for (const auto& edge : graph.getEdgesVector()) {
         if (std::get<2>(edge) < 0) { // Check if any edge weight is negative
             return true; // Return true if a negative weight is found
         }
@@ -684,7 +684,7 @@ std::vector< std::pair<int,std::vector<int>>> weighted_graph_metrics::allWeighte
 
     // Relax edges up to (V-1) times, where V is the number of vertices
     for (int i = 0; i < graph.getNumNodes() - 1; ++i) {
-        for (const auto& edge : graph.edgesVector) {
+        for (const auto& edge : graph.getEdgesVector()) {
             int u = std::get<0>(edge);
             int v = std::get<1>(edge);
             double weight = std::get<2>(edge);
@@ -696,7 +696,7 @@ std::vector< std::pair<int,std::vector<int>>> weighted_graph_metrics::allWeighte
     }
 
     // Check for negative-weight cycles
-    for (const auto& edge : graph.edgesVector) {
+    for (const auto& edge : graph.getEdgesVector()) {
         int u = std::get<0>(edge);
         int v = std::get<1>(edge);
         double weight = std::get<2>(edge);
@@ -885,4 +885,31 @@ double weighted_graph_metrics::averageWeightedDistance(const WeightedEdgeGraph&
     }
 
     return (count > 0) ? (totalDistance / count) : 0.0; // Return average distance, or 0 if no pairs are reachable
-}
\ No newline at end of file
+}
+
+std::map<int, std::pair<arma::Col<double>, arma::Col<double>>> changedNormalizedColumns(const WeightedEdgeGraph& graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights){
+    int numNodes = graph.getNumNodes();
+    std::map<int, std::pair<arma::Col<double>, arma::Col<double>>> changedColumns;
+    // iterating in reverse order, so that the first previous weight of an entry (the weight before the whole set of updates) is the one kept
+    for(auto it = previousEdgeWeights.crbegin(); it != previousEdgeWeights.crend(); it++){
+        int source = std::get<0>(*it);
+        int target = std::get<1>(*it);
+        if(source < 0 || target < 0 || source >= numNodes || target >= numNodes){
+            throw std::out_of_range("[ERROR] changedNormalizedColumns: the edge (" + std::to_string(source) + "," + std::to_string(target) + ") is not in the graph. abort");
+        }
+        if(!changedColumns.contains(source)){
+            arma::Col<double> newColumn(numNodes);
+            for(int j = 0; j < numNodes; j++){
+                newColumn(j) = graph.getEdgeWeight(source, j);
+            }
+            changedColumns[source] = std::make_pair(newColumn, newColumn);
+        }
+        changedColumns[source].first(target) = std::get<2>(*it);
+    }
+    // same normalization as Matrix::normalizeByVectorColumn
+    for(auto& [source, columns] : changedColumns){
+        columns.first /= (arma::accu(arma::abs(columns.first)) + 1e-20);
+        columns.second /= (arma::accu(arma::abs(columns.second)) + 1e-20);
+    }
+    return changedColumns;
+}
@@ -5,6 +5,8 @@
  * @details The functions are used to work with graphs, and finding metrics
  */
 #pragma once
+#include <armadillo>
+#include <map>
 #include <vector>
 #include <tuple>
 #include <queue>
@@ -320,4 +322,15 @@ namespace weighted_graph_metrics {
      */
     double averageWeightedDistance(const WeightedEdgeGraph& graph);
 
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Computes the columns of the propagation operator that changed after an update of the edge weights.
+ * @param graph The weighted edge graph, with the new edge weights already set.
+ * @param previousEdgeWeights The previous weights of the updated edges, as returned by WeightedEdgeGraph::updateEdgeWeights (source index, target index, previous weight).
+ * @return A map from the index of every changed source node to the pair (previous column, new column) of the operator.
+ * @details The operator is the transposed adjacency matrix normalized by the sum of the absolute outgoing weights of every node, as built by the propagation models.
+ * @details An update of the edge (i,j) changes the normalization factor of i, hence the whole column i of the operator and only that column.
+ * @throw std::out_of_range if one of the nodes of the previous edge weights is not in the graph.
+ */
+std::map<int, std::pair<arma::Col<double>, arma::Col<double>>> changedNormalizedColumns(const WeightedEdgeGraph& graph, const std::vector<std::tuple<int,int,double>>& previousEdgeWeights);
@@ -5,6 +5,7 @@
  * @details  The functions are used to work on numbers, vectors and matrices
  */
 #include "utils/mathUtilities.hxx"
+#include <cstring>
 
 
 //random generation for different types
@@ -30,6 +31,90 @@ double randomRealNumber(double min, double max){
     return uniform_dist(e1);
 }
 
+namespace {
+    /**
+     * @brief Mixing function of splitmix64, used to derive the key of the counter-based generator from the seed and the stream
+     */
+    inline uint64_t splitmix64(uint64_t value){
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    inline std::array<uint32_t,2> counterBasedKey(uint64_t seed, uint64_t stream){
+        uint64_t key = splitmix64(seed ^ splitmix64(stream));
+        return {static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)};
+    }
+
+    /**
+     * @brief Convert the first two words of a Philox block to a double in [0,1) with 53 random bits
+     */
+    inline double wordsToUnitDouble(uint32_t high, uint32_t low){
+        uint64_t bits = ((static_cast<uint64_t>(high) << 32) | low) >> 11;
+        return static_cast<double>(bits) * 0x1.0p-53;
+    }
+}
+
+std::array<uint32_t,4> philox4x32(std::array<uint32_t,4> counter, std::array<uint32_t,2> key){
+    constexpr uint32_t multiplier0 = 0xD2511F53u;
+    constexpr uint32_t multiplier1 = 0xCD9E8D57u;
+    constexpr uint32_t weyl0 = 0x9E3779B9u;
+    constexpr uint32_t weyl1 = 0xBB67AE85u;
+    for(int round = 0; round < 10; round++){
+        if(round > 0){
+            key[0] += weyl0;
+            key[1] += weyl1;
+        }
+        uint64_t product0 = static_cast<uint64_t>(multiplier0) * counter[0];
+        uint64_t product1 = static_cast<uint64_t>(multiplier1) * counter[2];
+        counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                   static_cast<uint32_t>(product1),
+                   static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                   static_cast<uint32_t>(product0)};
+    }
+    return counter;
+}
+
+double counterBasedRealNumber(uint64_t seed, uint64_t stream, uint64_t index, uint64_t step, double min, double max){
+    std::array<uint32_t,4> words = philox4x32({static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), static_cast<uint32_t>(step), static_cast<uint32_t>(step >> 32)}, counterBasedKey(seed, stream));
+    return min + (max - min) * wordsToUnitDouble(words[0], words[1]);
+}
+
+void counterBasedRealNumberFill(double* output, size_t size, uint64_t seed, uint64_t stream, uint64_t step, double min, double max){
+    const std::array<uint32_t,2> key = counterBasedKey(seed, stream);
+    const uint32_t stepLow = static_cast<uint32_t>(step);
+    const uint32_t stepHigh = static_cast<uint32_t>(step >> 32);
+    const double range = max - min;
+    #pragma omp simd
+    for(size_t i = 0; i < size; i++){
+        std::array<uint32_t,4> words = philox4x32({static_cast<uint32_t>(i), static_cast<uint32_t>(static_cast<uint64_t>(i) >> 32), stepLow, stepHigh}, key);
+        output[i] = min + range * wordsToUnitDouble(words[0], words[1]);
+    }
+}
+
+uint64_t timeToCounter(double time){
+    // +0.0 and -0.0 are the same time
+    if(time == 0){
+        return 0;
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &time, sizeof(bits));
+    return bits;
+}
+
+uint64_t hashCombine(uint64_t seed, uint64_t value){
+    return splitmix64(seed ^ splitmix64(value));
+}
+
+uint64_t hashDoubles(const double* values, size_t size, uint64_t seed){
+    uint64_t hash = hashCombine(seed, size);
+    for(size_t i = 0; i < size; i++){
+        hash = hashCombine(hash, timeToCounter(values[i]));
+    }
+    return hash;
+}
+
 char generateRandomCharacter() {
   // Generate a random number between 0 and 25
   int randomNumberInt = randomNumber(0, 25);
@@ -111,9 +196,32 @@ bool definitelyLessThan(double a, double b, double epsilon)
 
 
 double hyperbolicTangentScaled(double xInput, double scaleFactor ){
-    double firstTerm = std::exp(xInput/scaleFactor);
-    double secondTerm = std::exp(-xInput/scaleFactor);
-    return scaleFactor*(firstTerm - secondTerm)/(firstTerm + secondTerm);
+    // the exponentials of the explicit formula overflow (inf/inf = NaN) for large inputs, tanh does not
+    return scaleFactor*std::tanh(xInput/scaleFactor);
+}
+
+void clampSaturationBatch(double* values, const double* saturations, size_t numElements){
+    #pragma omp simd
+    for(size_t i = 0; i < numElements; i++){
+        values[i] = std::min(std::max(values[i], -saturations[i]), saturations[i]);
+    }
+}
+
+void hyperbolicTangentScaledBatch(double* values, const double* saturations, size_t numElements){
+    #pragma omp simd
+    for(size_t i = 0; i < numElements; i++){
+        values[i] = saturations[i]*std::tanh(values[i]/saturations[i]);
+    }
+}
+
+BatchSaturationFunction batchSaturationFromElementwise(const std::function<double(double,double)>& saturationFunction){
+    return [saturationFunction](double* values, const double* saturations, size_t numElements){
+        for(size_t i = 0; i < numElements; i++){
+            if(std::abs(values[i]) > saturations[i]){
+                values[i] = saturationFunction(values[i], saturations[i]);
+            }
+        }
+    };
 }
 
 
@@ -125,27 +233,20 @@ double lerping(double a, double b, double t){
 }
 
 
-bool setDoubleContainsInterval(std::set<double> set, double lower, double upper){
+bool setDoubleContainsInterval(const std::set<double>& set, double lower, double upper){
     if(lower > upper){
         throw std::invalid_argument("utilities::setDoubleContainsInterval: lower bound is greater than upper bound");
     }
-    if(set.lower_bound(lower) != set.end() && *set.lower_bound(lower) < upper){
-        return true;
-    }
-    return false;
+    auto first = set.lower_bound(lower);
+    return first != set.end() && *first < upper;
 }
 
-int setDoubleIntervalWidth(std::set<double> set, double lower, double upper){
+int setDoubleIntervalWidth(const std::set<double>& set, double lower, double upper){
     if(lower > upper){
         throw std::invalid_argument("utilities::setDoubleContainsInterval: lower bound is greater than upper bound");
     }
-    int count = 0;
-    for(auto iter = set.cbegin(); iter != set.cend(); iter++){
-        if(*iter >= lower && *iter<upper){
-            count++;
-        }
-    }
-    return count;
+    // the values are sorted, only the ones in [lower, upper) are visited
+    return SizeToInt(std::distance(set.lower_bound(lower), set.lower_bound(upper)));
 }
 
 
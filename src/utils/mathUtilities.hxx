@@ -15,6 +15,10 @@
 #include <cmath>
 #include <map>
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 /**
  * @brief   Generate a random integer number between min and max
  * @return  the random number
@@ -29,6 +33,62 @@ int randomNumber(int min, int max);
  * @param  max : the maximum value
 */
 double randomRealNumber(double min, double max);
+/**
+ * @brief   Philox4x32-10 counter-based random generator
+ * @return  the four random 32-bit words associated with the counter and key
+ * @param  counter : the 128-bit counter
+ * @param  key : the 64-bit key
+ * @details the output only depends on the counter and the key, so the random numbers can be generated in any order and by any thread without shared state
+ */
+std::array<uint32_t,4> philox4x32(std::array<uint32_t,4> counter, std::array<uint32_t,2> key);
+/**
+ * @brief   Generate a reproducible random real number between min and max with the counter-based generator
+ * @return  the random number in [min,max)
+ * @param  seed : the seed of the simulation
+ * @param  stream : the stream of random numbers (e.g. the global index of the type)
+ * @param  index : the index of the element in the stream (e.g. the node index)
+ * @param  step : the step of the simulation (@see timeToCounter)
+ * @param  min : the minimum value
+ * @param  max : the maximum value
+ * @details the same (seed, stream, index, step) always returns the same number, independently of the number of ranks and threads
+ */
+double counterBasedRealNumber(uint64_t seed, uint64_t stream, uint64_t index, uint64_t step, double min = 0, double max = 1);
+/**
+ * @brief   Fill an array with reproducible random real numbers between min and max with the counter-based generator
+ * @param  output : the array to fill, output[i] is the number with index i
+ * @param  size : the number of elements to fill
+ * @param  seed : the seed of the simulation
+ * @param  stream : the stream of random numbers (e.g. the global index of the type)
+ * @param  step : the step of the simulation (@see timeToCounter)
+ * @param  min : the minimum value
+ * @param  max : the maximum value
+ * @details the elements are independent, so the loop is vectorized; output[i] is equal to counterBasedRealNumber(seed, stream, i, step, min, max)
+ */
+void counterBasedRealNumberFill(double* output, size_t size, uint64_t seed, uint64_t stream, uint64_t step, double min = 0, double max = 1);
+/**
+ * @brief   Convert a simulation time to the step counter used by the counter-based generator
+ * @return  the bit representation of the time
+ * @param  time : the simulation time
+ * @details different times give different counters, the same time always gives the same counter
+ */
+uint64_t timeToCounter(double time);
+/**
+ * @brief   Combine a value into a 64-bit hash
+ * @return  the combined hash
+ * @param  seed : the hash of the previous values
+ * @param  value : the value to combine
+ * @details the combination depends on the order of the values, it uses the mixing function of splitmix64
+ */
+uint64_t hashCombine(uint64_t seed, uint64_t value);
+/**
+ * @brief   Compute the 64-bit hash of an array of real numbers
+ * @return  the hash of the bit representations of the numbers
+ * @param  values : the array of numbers
+ * @param  size : the number of elements of the array
+ * @param  seed : the initial hash
+ * @details +0.0 and -0.0 give the same hash (@see timeToCounter), different NaN representations give different hashes
+ */
+uint64_t hashDoubles(const double* values, size_t size, uint64_t seed = 0);
 /**
  * @brief   Generate a random character between a and z
  * @return  the random character
@@ -198,9 +258,42 @@ bool definitelyLessThan(double a, double b, double epsilon);
  * @param  xInput : the input value
  * @param  scaleFactor : the scale factor
  * @details scale the hyperbolic tangent function, the return value is always < c , the function is also scaled to grow linearly before reaching the transient
+ * @details computed as scaleFactor*tanh(xInput/scaleFactor), that does not overflow for large inputs
 */
 double hyperbolicTangentScaled(double xInput, double scaleFactor );
 
+/**
+ * @brief  Saturation function applied to a whole array in place
+ * @details the function saturates values[i] with the saturation saturations[i], for every i < numElements
+ */
+using BatchSaturationFunction = std::function<void(double* values, const double* saturations, size_t numElements)>;
+
+/**
+ * @brief  Clamp the values in [-saturation, saturation], element by element
+ * @param  values : the values, saturated in place
+ * @param  saturations : the saturation of every value
+ * @param  numElements : the number of values
+ * @details same result as the default saturation function, computed without branches so that the loop is vectorized
+ */
+void clampSaturationBatch(double* values, const double* saturations, size_t numElements);
+
+/**
+ * @brief  Saturate the values with the scaled hyperbolic tangent saturation*tanh(value/saturation), element by element
+ * @param  values : the values, saturated in place
+ * @param  saturations : the saturation of every value
+ * @param  numElements : the number of values
+ * @see hyperbolicTangentScaled
+ */
+void hyperbolicTangentScaledBatch(double* values, const double* saturations, size_t numElements);
+
+/**
+ * @brief  Build a batch saturation function from a saturation function of a single value
+ * @return  the batch saturation function
+ * @param  saturationFunction : the function of the value and the saturation
+ * @details as for the single value saturation functions, the function is only applied to the values whose absolute value exceeds the saturation
+ */
+BatchSaturationFunction batchSaturationFromElementwise(const std::function<double(double,double)>& saturationFunction);
+
 /**
  * @brief  Linear interpolation between two values, a and b, with a parameter t going from 0 to 1
  * @return  the interpolated value
@@ -339,7 +432,7 @@ struct hash_quadruple_strings {
  * @param upper  is the upper bound of the interval
  * @return true if the set contains the interval, false otherwise
  */
-bool setDoubleContainsInterval(std::set<double> set, double lower, double upper);
+bool setDoubleContainsInterval(const std::set<double>& set, double lower, double upper);
 
 
 /**
@@ -349,7 +442,7 @@ bool setDoubleContainsInterval(std::set<double> set, double lower, double upper)
  * @param upper  is the upper bound of the interval
  * @return the number of values that fall in the interval
  */
-int setDoubleIntervalWidth(std::set<double> set, double lower, double upper);
+int setDoubleIntervalWidth(const std::set<double>& set, double lower, double upper);
 
 /**
  * @brief  Function that implements the subtraction of two vectors of the same size
@@ -5,6 +5,8 @@
  * @details  The functions are used to work on files, strings, vectors and matrices
  */
 #include "utils/utilities.hxx"
+#include "data_structures/ScaleFunctionTable.hxx"
+#include "data_structures/Expression.hxx"
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
@@ -16,6 +18,7 @@
 #include <map>
 #include <math.h>
 #include <random>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -620,6 +623,53 @@ std::map<std::string,std::vector<std::tuple<std::string,std::string,double>>> in
     return ret;
 }
 
+std::map<std::string, std::map<double, std::vector<std::tuple<std::string,std::string,double>>>> edgeWeightUpdatesFromFile(std::string filename){
+    string line;
+    std::map<std::string, std::map<double, std::vector<std::tuple<std::string,std::string,double>>>> ret;
+    if(!file_exists(filename)){
+        throw std::invalid_argument("utilities::edgeWeightUpdatesFromFile: file does not exists " + filename);
+    }
+    ifstream myfile (filename);
+    if (myfile.is_open())
+    {
+        getline (myfile,line);  // first line is header IMPORTANT
+        std::vector<std::string> entriesHeader = splitStringIntoVector(line, "\t");
+        int indexTime=-1,indexType=-1,indexStartNode=-1,indexEndNode=-1,indexWeight=-1;
+        for(uint i = 0; i < entriesHeader.size(); i++){
+            std::string columnName = boost::algorithm::to_lower_copy(entriesHeader[i]);
+            if (columnName == "time") {
+                indexTime = i;
+            } else if (columnName == "type") {
+                indexType = i;
+            } else if (columnName == "startnodename") {
+                indexStartNode = i;
+            } else if (columnName == "endnodename") {
+                indexEndNode = i;
+            } else if (columnName == "weight") {
+                indexWeight = i;
+            }
+        }
+        if(indexTime < 0 || indexType < 0 || indexStartNode < 0 || indexEndNode < 0 || indexWeight < 0){
+            throw std::invalid_argument("utilities::edgeWeightUpdatesFromFile: invalid file, the header does not contain a time, or a type, or a startNodeName, or a endNodeName, or a weight feature");
+        }
+        while ( getline (myfile,line) )
+        {
+            if(line.empty()){
+                continue;
+            }
+            std::vector<std::string> entries = splitStringIntoVector(line, "\t");
+            if(entries.size() != entriesHeader.size()){
+                throw std::invalid_argument("utilities::edgeWeightUpdatesFromFile: invalid file, the line \"" + line + "\" does not have the same number of columns as the header");
+            }
+            double time = std::stod(entries[indexTime]);
+            double weight = std::stod(entries[indexWeight]);
+            ret[entries[indexType]][time].push_back(std::tuple<std::string,std::string,double>(entries[indexStartNode], entries[indexEndNode], weight));
+        }
+        myfile.close();
+    }
+    return ret;
+}
+
 std::pair<std::map<std::string,std::vector<std::tuple<std::string,std::string,double>>>,std::vector<std::tuple<std::string, std::string, std::string, std::string, std::unordered_set<int>, double>>> interactionContactsFileToEdgesListAndNodesByName(std::string filename, std::vector<std::string> subtypes, int maximumIntertypeTime, std::string granularity,std::unordered_map<std::string,std::vector<std::string>> typeToNodeNames, bool undirectedTypeEdges){
     string line;
     std::pair<std::map<std::string,std::vector<std::tuple<std::string,std::string,double>>>,std::vector<std::tuple<std::string, std::string, std::string, std::string, std::unordered_set<int>, double>>> ret;
@@ -1061,71 +1111,143 @@ std::pair<std::map<std::string,std::vector<std::tuple<std::string,std::string,do
     return ret; 
 }
 
-std::function<arma::Col<double>(double)> dissipationScalingFunctionFromFile(std::string filename, std::vector<std::string> orderedNodeNames){
-    if(!file_exists(filename)){
-        throw std::invalid_argument("utilities::dissipationScalingFunctionFromFile: file does not exists " + filename);
-    }
-    std::ifstream infile(filename);
-    if (!infile.is_open()) {
-        throw std::invalid_argument("utilities::dissipationScalingFunctionFromFile: unable to open file " + filename);
-    }
-    std::function<arma::Col<double>(double)> ret;
-    //read the first line to get the header
-    std::string line;
-    getline(infile, line);
-    std::vector<std::string> entriesHeader = splitStringIntoVector(line, "\t");
-    // check if the header is valid
-    if(entriesHeader.size() < 2 || (boost::algorithm::to_lower_copy(entriesHeader[0]) != "name" || boost::algorithm::to_lower_copy(entriesHeader[1]) != "parameters")){
-        throw std::invalid_argument("utilities::dissipationScalingFunctionFromFile: invalid header in file " + filename + ", expected first column to be name, and second column to be parameters");
-    }
-    // read the rest of the file
-    std::vector<std::function<double(double)>> orderedFunctions = std::vector<std::function<double(double)>>(orderedNodeNames.size(), getDissipationScalingFunction());
-    while (getline(infile, line)) {
-        std::vector<std::string> entries = splitStringIntoVector(line, "\t");
-        if(entries.size() != 2){
-            throw std::invalid_argument("utilities::dissipationScalingFunctionFromFile: invalid entry in file " + filename + ", expected two columns, got " + std::to_string(entries.size()));
+namespace {
+    /**
+     * @brief Read the parameters of the per node scaling functions from a parameters file.
+     * @param filename the name of the file
+     * @param orderedNodeNames the vector of node names in the order they are expected
+     * @param callerName the name of the calling function, used in the error messages
+     * @return the index of the node and its parameters for every node of the file that is in orderedNodeNames, in the order of the file
+     */
+    std::vector<std::pair<size_t, std::vector<double>>> scalingParametersFromFile(const std::string& filename, const std::vector<std::string>& orderedNodeNames, const std::string& callerName){
+        if(!file_exists(filename)){
+            throw std::invalid_argument("utilities::" + callerName + ": file does not exists " + filename);
         }
-        std::string name = entries[0];
-        std::string parameters = entries[1];
-        std::vector<std::string> parametersVector = splitStringIntoVector(parameters, ",");
-        std::vector<double> parametersDouble;
-        for (const auto& param : parametersVector) {
-            try {
-                parametersDouble.push_back(std::stod(param));
-            } catch (const std::invalid_argument& e) {
-                throw std::invalid_argument("utilities::dissipationScalingFunctionFromFile: invalid parameter in file " + filename + ", expected a real number, got " + param);
-            }
+        std::ifstream infile(filename);
+        if (!infile.is_open()) {
+            throw std::invalid_argument("utilities::" + callerName + ": unable to open file " + filename);
         }
-        // find the index of the name in the orderedNodeNames vector
-        auto it = std::find(orderedNodeNames.begin(), orderedNodeNames.end(), name);
-        if (it != orderedNodeNames.end()) {
-            size_t index = std::distance(orderedNodeNames.begin(), it);
-            // create the function and store it in the orderedFunctions vector
-            // try to create the function, if it fails it means that the parameters are not valid for the function
-            try {
-                orderedFunctions[index] = getDissipationScalingFunction(parametersDouble);
-            } catch (const std::invalid_argument& e) {
-                throw std::invalid_argument("utilities::dissipationScalingFunctionFromFile: probably invalid parameters for function " + name + " in file " + filename + ", " + e.what());
+        //read the first line to get the header
+        std::string line;
+        getline(infile, line);
+        std::vector<std::string> entriesHeader = splitStringIntoVector(line, "\t");
+        // check if the header is valid
+        if(entriesHeader.size() < 2 || (boost::algorithm::to_lower_copy(entriesHeader[0]) != "name" || boost::algorithm::to_lower_copy(entriesHeader[1]) != "parameters")){
+            throw std::invalid_argument("utilities::" + callerName + ": invalid header in file " + filename + ", expected first column to be name, and second column to be parameters");
+        }
+        std::unordered_map<std::string, size_t> nodeNameToIndex;
+        for(size_t i = 0; i < orderedNodeNames.size(); i++){
+            nodeNameToIndex.emplace(orderedNodeNames[i], i);
+        }
+        std::vector<std::pair<size_t, std::vector<double>>> ret;
+        // read the rest of the file
+        while (getline(infile, line)) {
+            std::vector<std::string> entries = splitStringIntoVector(line, "\t");
+            if(entries.size() != 2){
+                throw std::invalid_argument("utilities::" + callerName + ": invalid entry in file " + filename + ", expected two columns, got " + std::to_string(entries.size()));
+            }
+            std::string name = entries[0];
+            std::string parameters = entries[1];
+            std::vector<std::string> parametersVector = splitStringIntoVector(parameters, ",");
+            std::vector<double> parametersDouble;
+            for (const auto& param : parametersVector) {
+                try {
+                    parametersDouble.push_back(std::stod(param));
+                } catch (const std::invalid_argument& e) {
+                    throw std::invalid_argument("utilities::" + callerName + ": invalid parameter in file " + filename + ", expected a real number, got " + param);
+                }
+            }
+            auto nodeIterator = nodeNameToIndex.find(name);
+            if (nodeIterator != nodeNameToIndex.end()) {
+                ret.emplace_back(nodeIterator->second, parametersDouble);
+            } else { // if the name is not found in the orderedNodeNames vector, ignore it and print a warning
+                Logger::getInstance().printWarning("utilities::" + callerName + ": name " + name + " not found in orderedNodeNames vector, ignoring it");
             }
-        } else { // if the name is not found in the orderedNodeNames vector, ignore it and print a warning
-            Logger::getInstance().printWarning("utilities::dissipationScalingFunctionFromFile: name " + name + " not found in orderedNodeNames vector, ignoring it");
-            //throw std::invalid_argument("utilities::dissipationScalingFunctionFromFile: name " + name + " not found in orderedNodeNames vector");
         }
+        infile.close();
+        return ret;
     }
-    infile.close();
-    // create the function that takes a double and returns a column vector with the values of the functions for each node
-    ret = [orderedFunctions](double t) -> arma::Col<double> {
-        arma::Col<double> result(orderedFunctions.size());
-        for (size_t i = 0; i < orderedFunctions.size(); ++i) {
-            result(i) = orderedFunctions[i](t);
+
+    /**
+     * @brief Get the scaling function of a node from its parameters.
+     * @param parameters the parameters of the node
+     * @param parametersFunction the generator of the scaling function from the parameters of a node
+     * @param expressionSource the expression of the time t used instead of parametersFunction, the parameters of a node are bound to p[0], p[1], ... (empty to use parametersFunction)
+     * @param breakpoints the set where the breakpoints of the compiled expression are added, nullptr to ignore them
+     * @param piecewiseConstant set to false if the compiled expression is not piecewise constant, nullptr to ignore it
+     * @return the scaling function of the node
+     */
+    std::function<double(double)> scalingFunctionFromParameters(const std::vector<double>& parameters, const std::function<std::function<double(double)>(std::vector<double>)>& parametersFunction, const std::string& expressionSource, std::set<double>* breakpoints = nullptr, bool* piecewiseConstant = nullptr){
+        if(expressionSource.empty()){
+            // the functions with parameters are piecewise constant over getScalingFunctionBreakpoints() by contract
+            return parametersFunction(parameters);
         }
-        return result;
-    };
-        
-    return ret;
+        Expression expression(expressionSource, {"t"}, parameters);
+        if(breakpoints != nullptr){
+            breakpoints->insert(expression.getBreakpoints().begin(), expression.getBreakpoints().end());
+        }
+        if(piecewiseConstant != nullptr && !expression.isPiecewiseConstant()){
+            *piecewiseConstant = false;
+        }
+        return expression.asScaleFunction();
+    }
+
+    /**
+     * @brief Read the per node scaling functions from a parameters file and compile them into a table.
+     * @param filename the name of the file
+     * @param orderedNodeNames the vector of node names in the order they are expected
+     * @param defaultFunction the scaling function used for the nodes that are not in the file
+     * @param parametersFunction the generator of the scaling function from the parameters of a node
+     * @param callerName the name of the calling function, used in the error messages
+     * @param expressionSource the expression of the time t used instead of parametersFunction, the parameters of a node are bound to p[0], p[1], ... (empty to use parametersFunction)
+     * @return the compiled table, nodes with the same parameters share the same scaling function
+     */
+    ScaleFunctionTable scalingFunctionTableFromFile(const std::string& filename, const std::vector<std::string>& orderedNodeNames, const std::function<double(double)>& defaultFunction, const std::function<std::function<double(double)>(std::vector<double>)>& parametersFunction, const std::string& callerName, const std::string& expressionSource){
+        // the default function is the first unique function, every distinct set of parameters adds a new one
+        std::vector<std::function<double(double)>> uniqueFunctions{defaultFunction};
+        std::map<std::vector<double>, arma::uword> parametersToUniqueFunction;
+        std::vector<arma::uword> nodeToUniqueFunction(orderedNodeNames.size(), 0);
+        // the breakpoints of the table are the ones of the default functions and the ones found in the compiled expressions
+        std::set<double> breakpoints;
+        // the table is compiled only if every expression was proven piecewise constant when compiled, otherwise the functions are evaluated at every step
+        bool piecewiseConstant = true;
+        for(const auto& breakpoint : getScalingFunctionBreakpoints()){
+            breakpoints.insert(breakpoint);
+        }
+        for(const auto& [nodeIndex, parameters] : scalingParametersFromFile(filename, orderedNodeNames, callerName)){
+            auto uniqueIterator = parametersToUniqueFunction.find(parameters);
+            if(uniqueIterator == parametersToUniqueFunction.end()){
+                // try to create the function, if it fails it means that the parameters are not valid for the function
+                try {
+                    uniqueFunctions.push_back(scalingFunctionFromParameters(parameters, parametersFunction, expressionSource, &breakpoints, &piecewiseConstant));
+                } catch (const std::invalid_argument& e) {
+                    throw std::invalid_argument("utilities::" + callerName + ": probably invalid parameters for function " + orderedNodeNames[nodeIndex] + " in file " + filename + ", " + e.what());
+                }
+                uniqueIterator = parametersToUniqueFunction.emplace(parameters, uniqueFunctions.size() - 1).first;
+            }
+            nodeToUniqueFunction[nodeIndex] = uniqueIterator->second;
+        }
+        return ScaleFunctionTable(std::vector<double>(breakpoints.begin(), breakpoints.end()), uniqueFunctions, nodeToUniqueFunction, piecewiseConstant);
+    }
+
+    /**
+     * @brief Get the table where all the nodes use the same default scaling function.
+     * @param numNodes the number of nodes
+     * @param defaultFunction the default scaling function
+     * @return the compiled table
+     */
+    ScaleFunctionTable defaultScalingFunctionTable(size_t numNodes, const std::function<double(double)>& defaultFunction){
+        return ScaleFunctionTable(getScalingFunctionBreakpoints(), {defaultFunction}, std::vector<arma::uword>(numNodes, 0), true);
+    }
+}
+
+std::function<arma::Col<double>(double)> dissipationScalingFunctionFromFile(std::string filename, std::vector<std::string> orderedNodeNames, std::string expression){
+    // the functions are compiled into a table of values per node, evaluated once per time instead of once per node
+    ScaleFunctionTable table = scalingFunctionTableFromFile(filename, orderedNodeNames, getDissipationScalingFunction(), [](std::vector<double> parameters){return getDissipationScalingFunction(parameters);}, "dissipationScalingFunctionFromFile", expression);
+    return table.asFunction();
 }
 
-std::map<std::string, std::function<arma::Col<double>(double)>> dissipationScalingFunctionsFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames){
+std::map<std::string, std::function<arma::Col<double>(double)>> dissipationScalingFunctionsFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames, std::string expression){
     std::map<std::string, std::function<arma::Col<double>(double)>> ret;
     std::vector<std::string> typesFromMap;
     for(const auto& [type, nodeNames] : typeToOrderedNodeNames){
@@ -1141,14 +1263,7 @@ std::map<std::string, std::function<arma::Col<double>(double)>> dissipationScali
         // if no files are found, use the default function for all types
         for(const auto& type : typesFromMap){
             auto orderedNames = typeToOrderedNodeNames[type];
-            ret[type] = [orderedNames](double t) -> arma::Col<double> {
-                arma::Col<double> result(orderedNames.size());
-                #pragma omp parallel for
-                for (size_t i = 0; i < orderedNames.size(); ++i) {
-                    result(i) = getDissipationScalingFunction()(t); // using the default function with the size of the ordered names
-                }
-                return result;
-            };
+            ret[type] = defaultScalingFunctionTable(orderedNames.size(), getDissipationScalingFunction()).asFunction();
                 
         }
         return ret;
@@ -1159,86 +1274,21 @@ std::map<std::string, std::function<arma::Col<double>(double)>> dissipationScali
             Logger::getInstance().printWarning("utilities::dissipationScalingFunctionsFromFolder: file " + folderPath + "/" + type + ".tsv not found, using default function for type " + type);
             // if the file is not found, use the default function with the correct number of returned length for the scaling function
             auto orderedNames = typeToOrderedNodeNames[type];
-            ret[type] = [orderedNames](double t) -> arma::Col<double> {
-                arma::Col<double> result(orderedNames.size());
-                #pragma omp parallel for
-                for (size_t i = 0; i < orderedNames.size(); ++i) {
-                    result(i) = getDissipationScalingFunction()(t); // using the default function with the size of the ordered names
-                }
-                return result;
-            };
+            ret[type] = defaultScalingFunctionTable(orderedNames.size(), getDissipationScalingFunction()).asFunction();
         } else {
-            ret[type] = dissipationScalingFunctionFromFile(folderPath + "/" + type + ".tsv", typeToOrderedNodeNames[type]);
+            ret[type] = dissipationScalingFunctionFromFile(folderPath + "/" + type + ".tsv", typeToOrderedNodeNames[type], expression);
         }
     }
     return ret;
 }
 
-std::function<arma::Col<double>(double)> conservationScalingFunctionFromFile(std::string filename, std::vector<std::string> orderedNodeNames){
-    if(!file_exists(filename)){
-        throw std::invalid_argument("utilities::conservationScalingFunctionFromFile: file does not exists " + filename);
-    }
-    std::ifstream infile(filename);
-    if (!infile.is_open()) {
-        throw std::invalid_argument("utilities::conservationScalingFunctionFromFile: unable to open file " + filename);
-    }
-    std::function<arma::Col<double>(double)> ret;
-    //read the first line to get the header
-    std::string line;
-    getline(infile, line);
-    std::vector<std::string> entriesHeader = splitStringIntoVector(line, "\t");
-    // check if the header is valid
-    if(entriesHeader.size() < 2 || (boost::algorithm::to_lower_copy(entriesHeader[0]) != "name" || boost::algorithm::to_lower_copy(entriesHeader[1]) != "parameters")){
-        throw std::invalid_argument("utilities::conservationScalingFunctionFromFile: invalid header in file " + filename + ", expected first column to be name, and second column to be parameters");
-    }
-    // read the rest of the file
-    std::vector<std::function<double(double)>> orderedFunctions = std::vector<std::function<double(double)>>(orderedNodeNames.size(), getConservationScalingFunction());
-    while (getline(infile, line)) {
-        std::vector<std::string> entries = splitStringIntoVector(line, "\t");
-        if(entries.size() != 2){
-            throw std::invalid_argument("utilities::conservationScalingFunctionFromFile: invalid entry in file " + filename + ", expected two columns, got " + std::to_string(entries.size()));
-        }
-        std::string name = entries[0];
-        std::string parameters = entries[1];
-        std::vector<std::string> parametersVector = splitStringIntoVector(parameters, ",");
-        std::vector<double> parametersDouble;
-        for (const auto& param : parametersVector) {
-            try {
-                parametersDouble.push_back(std::stod(param));
-            } catch (const std::invalid_argument& e) {
-                throw std::invalid_argument("utilities::conservationScalingFunctionFromFile: invalid parameter in file " + filename + ", expected a real number, got " + param);
-            }
-        }
-        // find the index of the name in the orderedNodeNames vector
-        auto it = std::find(orderedNodeNames.begin(), orderedNodeNames.end(), name);
-        if (it != orderedNodeNames.end()) {
-            size_t index = std::distance(orderedNodeNames.begin(), it);
-            // create the function and store it in the orderedFunctions vector
-            // try to create the function, if it fails it means that the parameters are not valid for the function
-            try {
-                orderedFunctions[index] = getConservationScalingFunction(parametersDouble);
-            } catch (const std::invalid_argument& e) {
-                throw std::invalid_argument("utilities::conservationScalingFunctionFromFile: probably invalid parameters for function " + name + " in file " + filename + ", " + e.what());
-            }
-        } else { // if the name is not found in the orderedNodeNames vector, ignore it and print a warning
-            Logger::getInstance().printWarning("utilities::conservationScalingFunctionFromFile: name " + name + " not found in orderedNodeNames vector, ignoring it");
-            //throw std::invalid_argument("utilities::conservationScalingFunctionFromFile: name " + name + " not found in orderedNodeNames vector");
-        }
-    }
-    infile.close();
-    // create the function that takes a double and returns a column vector with the values of the functions for each node
-    ret = [orderedFunctions](double t) -> arma::Col<double> {
-        arma::Col<double> result(orderedFunctions.size());
-        for (size_t i = 0; i < orderedFunctions.size(); ++i) {
-            result(i) = orderedFunctions[i](t);
-        }
-        return result;
-    };
-        
-    return ret;
+std::function<arma::Col<double>(double)> conservationScalingFunctionFromFile(std::string filename, std::vector<std::string> orderedNodeNames, std::string expression){
+    // the functions are compiled into a table of values per node, evaluated once per time instead of once per node
+    ScaleFunctionTable table = scalingFunctionTableFromFile(filename, orderedNodeNames, getConservationScalingFunction(), [](std::vector<double> parameters){return getConservationScalingFunction(parameters);}, "conservationScalingFunctionFromFile", expression);
+    return table.asFunction();
 }
 
-std::map<std::string, std::function<arma::Col<double>(double)>> conservationScalingFunctionsFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames){
+std::map<std::string, std::function<arma::Col<double>(double)>> conservationScalingFunctionsFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames, std::string expression){
     std::map<std::string, std::function<arma::Col<double>(double)>> ret;
     std::vector<std::string> typesFromMap;
     for(const auto& [type, nodeNames] : typeToOrderedNodeNames){
@@ -1254,14 +1304,7 @@ std::map<std::string, std::function<arma::Col<double>(double)>> conservationScal
         // if no files are found, use the default function for all types
         for(const auto& type : typesFromMap){
             auto orderedNames = typeToOrderedNodeNames[type];
-            ret[type] = [orderedNames](double t) -> arma::Col<double> {
-                arma::Col<double> result(orderedNames.size());
-                #pragma omp parallel for
-                for (size_t i = 0; i < orderedNames.size(); ++i) {
-                    result(i) = getConservationScalingFunction()(t); // using the default function with the size of the ordered names
-                }
-                return result;
-            };
+            ret[type] = defaultScalingFunctionTable(orderedNames.size(), getConservationScalingFunction()).asFunction();
                 
         }
         return ret;
@@ -1272,86 +1315,21 @@ std::map<std::string, std::function<arma::Col<double>(double)>> conservationScal
             Logger::getInstance().printWarning("utilities::conservationScalingFunctionsFromFolder: file " + folderPath + "/" + type + ".tsv not found, using default function for type " + type);
             // if the file is not found, use the default function with the correct number of returned length for the scaling function
             auto orderedNames = typeToOrderedNodeNames[type];
-            ret[type] = [orderedNames](double t) -> arma::Col<double> {
-                arma::Col<double> result(orderedNames.size());
-                #pragma omp parallel for
-                for (size_t i = 0; i < orderedNames.size(); ++i) {
-                    result(i) = getConservationScalingFunction()(t); // using the default function with the size of the ordered names
-                }
-                return result;
-            };
+            ret[type] = defaultScalingFunctionTable(orderedNames.size(), getConservationScalingFunction()).asFunction();
         } else {
-            ret[type] = conservationScalingFunctionFromFile(folderPath + "/" + type + ".tsv", typeToOrderedNodeNames[type]);
+            ret[type] = conservationScalingFunctionFromFile(folderPath + "/" + type + ".tsv", typeToOrderedNodeNames[type], expression);
         }
     }
     return ret;
 }
 
-std::function<arma::Col<double>(double)> propagationScalingFunctionFromFile(std::string filename, std::vector<std::string> orderedNodeNames){
-    if(!file_exists(filename)){
-        throw std::invalid_argument("utilities::propagationScalingFunctionFromFile: file does not exists " + filename);
-    }
-    std::ifstream infile(filename);
-    if (!infile.is_open()) {
-        throw std::invalid_argument("utilities::propagationScalingFunctionFromFile: unable to open file " + filename);
-    }
-    std::function<arma::Col<double>(double)> ret;
-    //read the first line to get the header
-    std::string line;
-    getline(infile, line);
-    std::vector<std::string> entriesHeader = splitStringIntoVector(line, "\t");
-    // check if the header is valid
-    if(entriesHeader.size() < 2 || (boost::algorithm::to_lower_copy(entriesHeader[0]) != "name" || boost::algorithm::to_lower_copy(entriesHeader[1]) != "parameters")){
-        throw std::invalid_argument("utilities::propagationScalingFunctionFromFile: invalid header in file " + filename + ", expected first column to be name, and second column to be parameters");
-    }
-    // read the rest of the file
-    std::vector<std::function<double(double)>> orderedFunctions = std::vector<std::function<double(double)>>(orderedNodeNames.size(), getPropagationScalingFunction());
-    while (getline(infile, line)) {
-        std::vector<std::string> entries = splitStringIntoVector(line, "\t");
-        if(entries.size() != 2){
-            throw std::invalid_argument("utilities::propagationScalingFunctionFromFile: invalid entry in file " + filename + ", expected two columns, got " + std::to_string(entries.size()));
-        }
-        std::string name = entries[0];
-        std::string parameters = entries[1];
-        std::vector<std::string> parametersVector = splitStringIntoVector(parameters, ",");
-        std::vector<double> parametersDouble;
-        for (const auto& param : parametersVector) {
-            try {
-                parametersDouble.push_back(std::stod(param));
-            } catch (const std::invalid_argument& e) {
-                throw std::invalid_argument("utilities::propagationScalingFunctionFromFile: invalid parameter in file " + filename + ", expected a real number, got " + param);
-            }
-        }
-        // find the index of the name in the orderedNodeNames vector
-        auto it = std::find(orderedNodeNames.begin(), orderedNodeNames.end(), name);
-        if (it != orderedNodeNames.end()) {
-            size_t index = std::distance(orderedNodeNames.begin(), it);
-            // create the function and store it in the orderedFunctions vector
-            // try to create the function, if it fails it means that the parameters are not valid for the function
-            try {
-                orderedFunctions[index] = getPropagationScalingFunction(parametersDouble);
-            } catch (const std::invalid_argument& e) {
-                throw std::invalid_argument("utilities::propagationScalingFunctionFromFile: probably invalid parameters for function " + name + " in file " + filename + ", " + e.what());
-            }
-        } else { // if the name is not found in the orderedNodeNames vector, ignore it and print a warning
-            Logger::getInstance().printWarning("utilities::propagationScalingFunctionFromFile: name " + name + " not found in orderedNodeNames vector, ignoring it");
-            //throw std::invalid_argument("utilities::conservationScalingFunctionFromFile: name " + name + " not found in orderedNodeNames vector");
-        }
-    }
-    infile.close();
-    // create the function that takes a double and returns a column vector with the values of the functions for each node
-    ret = [orderedFunctions](double t) -> arma::Col<double> {
-        arma::Col<double> result(orderedFunctions.size());
-        for (size_t i = 0; i < orderedFunctions.size(); ++i) {
-            result(i) = orderedFunctions[i](t);
-        }
-        return result;
-    };
-        
-    return ret;
+std::function<arma::Col<double>(double)> propagationScalingFunctionFromFile(std::string filename, std::vector<std::string> orderedNodeNames, std::string expression){
+    // the functions are compiled into a table of values per node, evaluated once per time instead of once per node
+    ScaleFunctionTable table = scalingFunctionTableFromFile(filename, orderedNodeNames, getPropagationScalingFunction(), [](std::vector<double> parameters){return getPropagationScalingFunction(parameters);}, "propagationScalingFunctionFromFile", expression);
+    return table.asFunction();
 }
 
-std::map<std::string, std::function<arma::Col<double>(double)>> propagationScalingFunctionsFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames){
+std::map<std::string, std::function<arma::Col<double>(double)>> propagationScalingFunctionsFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames, std::string expression){
     std::map<std::string, std::function<arma::Col<double>(double)>> ret;
     std::vector<std::string> typesFromMap;
     for(const auto& [type, nodeNames] : typeToOrderedNodeNames){
@@ -1367,14 +1345,7 @@ std::map<std::string, std::function<arma::Col<double>(double)>> propagationScali
         // if no files are found, use the default function for all types
         for(const auto& type : typesFromMap){
             auto orderedNames = typeToOrderedNodeNames[type];
-            ret[type] = [orderedNames](double t) -> arma::Col<double> {
-                arma::Col<double> result(orderedNames.size());
-                #pragma omp parallel for
-                for (size_t i = 0; i < orderedNames.size(); ++i) {
-                    result(i) = getPropagationScalingFunction()(t); // using the default function with the size of the ordered names
-                }
-                return result;
-            };
+            ret[type] = defaultScalingFunctionTable(orderedNames.size(), getPropagationScalingFunction()).asFunction();
                 
         }
         return ret;
@@ -1385,21 +1356,72 @@ std::map<std::string, std::function<arma::Col<double>(double)>> propagationScali
             Logger::getInstance().printWarning("utilities::propagationScalingFunctionsFromFolder: file " + folderPath + "/" + type + ".tsv not found, using default function for type " + type);
             // if the file is not found, use the default function with the correct number of returned length for the scaling function
             auto orderedNames = typeToOrderedNodeNames[type];
-            ret[type] = [orderedNames](double t) -> arma::Col<double> {
-                arma::Col<double> result(orderedNames.size());
-                #pragma omp parallel for
-                for (size_t i = 0; i < orderedNames.size(); ++i) {
-                    result(i) = getPropagationScalingFunction()(t); // using the default function with the size of the ordered names
-                }
-                return result;
-            };
+            ret[type] = defaultScalingFunctionTable(orderedNames.size(), getPropagationScalingFunction()).asFunction();
         } else {
-            ret[type] = propagationScalingFunctionFromFile(folderPath + "/" + type + ".tsv", typeToOrderedNodeNames[type]);
+            ret[type] = propagationScalingFunctionFromFile(folderPath + "/" + type + ".tsv", typeToOrderedNodeNames[type], expression);
+        }
+    }
+    return ret;
+}
+
+std::vector<SensitivityParameter> scalingParameterSensitivitiesFromFile(std::string filename, std::vector<std::string> orderedNodeNames, SensitivityTarget target, std::string expression){
+    std::string targetName;
+    std::function<std::function<double(double)>(std::vector<double>)> parametersFunction;
+    switch(target){
+        case SensitivityTarget::dissipation:
+            targetName = "dissipation";
+            parametersFunction = [](std::vector<double> parameters){return getDissipationScalingFunction(parameters);};
+            break;
+        case SensitivityTarget::propagation:
+            targetName = "propagation";
+            parametersFunction = [](std::vector<double> parameters){return getPropagationScalingFunction(parameters);};
+            break;
+        case SensitivityTarget::conservation:
+            targetName = "conservation";
+            parametersFunction = [](std::vector<double> parameters){return getConservationScalingFunction(parameters);};
+            break;
+    }
+    std::vector<SensitivityParameter> ret;
+    for(const auto& [nodeIndex, parameters] : scalingParametersFromFile(filename, orderedNodeNames, "scalingParameterSensitivitiesFromFile")){
+        for(size_t k = 0; k < parameters.size(); k++){
+            // central differences of the scaling function of the node, the simulation is not involved
+            double increment = 1e-6 * std::max(1.0, std::abs(parameters[k]));
+            std::vector<double> upperParameters = parameters, lowerParameters = parameters;
+            upperParameters[k] += increment;
+            lowerParameters[k] -= increment;
+            std::function<double(double)> upperFunction, lowerFunction;
+            try {
+                upperFunction = scalingFunctionFromParameters(upperParameters, parametersFunction, expression);
+                lowerFunction = scalingFunctionFromParameters(lowerParameters, parametersFunction, expression);
+            } catch (const std::invalid_argument& e) {
+                throw std::invalid_argument("utilities::scalingParameterSensitivitiesFromFile: probably invalid parameters for function " + orderedNodeNames[nodeIndex] + " in file " + filename + ", " + e.what());
+            }
+            SensitivityParameter parameter;
+            parameter.name = targetName + ":" + orderedNodeNames[nodeIndex] + ":p" + std::to_string(k);
+            parameter.target = target;
+            parameter.node = nodeIndex;
+            parameter.scaleDerivative = [upperFunction, lowerFunction, increment](double time)-> double{
+                return (upperFunction(time) - lowerFunction(time)) / (2 * increment);
+            };
+            ret.push_back(parameter);
         }
     }
     return ret;
 }
 
+std::map<std::string, std::vector<SensitivityParameter>> scalingParameterSensitivitiesFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames, SensitivityTarget target, std::string expression){
+    std::map<std::string, std::vector<SensitivityParameter>> ret;
+    std::vector<std::string> files = get_all(folderPath, ".tsv");
+    for(const auto& [type, orderedNodeNames] : typeToOrderedNodeNames){
+        if(std::find(files.begin(), files.end(), folderPath + "/" + type + ".tsv") == files.end()){
+            // the default function is used for the type, there are no parameters
+            ret[type] = std::vector<SensitivityParameter>();
+        } else {
+            ret[type] = scalingParameterSensitivitiesFromFile(folderPath + "/" + type + ".tsv", orderedNodeNames, target, expression);
+        }
+    }
+    return ret;
+}
 
 std::map<std::string, std::vector<std::string>> getFullNodesDescription(std::string filename){
     string line;
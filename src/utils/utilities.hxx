@@ -40,6 +40,7 @@
 #include "utils/mathUtilities.hxx"
 #include "utils/stringUtilities.hxx"
 #include "CustomFunctions.hxx"
+#include "computation/SensitivityParameter.hxx"
 
 /**
  * @brief print a vector of any type
@@ -196,6 +197,18 @@ std::map<std::string,std::vector<std::tuple<std::string,std::string,double>>> in
  * @note Other columns are ignored
  */
 std::map<std::string,std::vector<std::tuple<std::string,std::string,double>>> interactionFileToEdgesListAndNodesByName(std::string filename, std::vector<std::string> subtypes);
+/**
+ * @brief   Read the scheduled edge weight updates of the augmented graphs from a file
+ * @param filename the name of the file
+ * @return  the updates of every type, indexed by the time from which the new weights are used (@see Computation::scheduleEdgeWeightUpdates)
+ * @details  The file is read using the ifstream function, the updates of the same type and time keep the order of the file
+ * @note   The file must contain the following columns: time, type, startNodeName, endNodeName, weight. The nodes can be virtual nodes of the augmented graph of the type (v-in:<type> and v-out:<type>)
+ * @throw std::invalid_argument if the file does not exist
+ * @throw std::invalid_argument if the file does not contain the time, type, startNodeName, endNodeName or weight columns
+ * @throw std::invalid_argument if a line does not have the same number of columns as the header
+ * @note Other columns are ignored
+ */
+std::map<std::string, std::map<double, std::vector<std::tuple<std::string,std::string,double>>>> edgeWeightUpdatesFromFile(std::string filename);
 
 /**
  * @brief Read the node names from the names in a folder
@@ -286,77 +299,114 @@ std::vector<double> saturationFileToVector(std::string filename,const std::map<s
  * @brief Read the dissipation scaling function from a file
  * @param filename the name of the file
  * @param orderedNodeNames the vector of node names in the order they are expected
+ * @param expression the expression of the time t used as the scaling function, the parameters of a node are bound to p[0], p[1], ... (see Expression.hxx), empty to use the custom function
  * @return  the vectorized dissipation scaling function as a lambda function
  * @details  The file is read using the ifstream function
  * @note    The file must contain the following columns: node, <parameters>
  * @note This function returns the custom dissipation scaling function that is defined in \ref CustomFunctions.hxx
  * @note The nodes that are not in the orderedNodeNames vector will be ignored
  * @note The nodes that are not seen in the file will have a scaling function defined with the default one in CustomFunctions.hxx (getDissipationScalingFunction())
+ * @note If an expression is passed, it is compiled once for every distinct set of parameters and its breakpoints are added to the ones of the table
+ * @note Nodes with the same parameters share the same function, and the functions are compiled into a ScaleFunctionTable evaluated once per time
  * @throw std::invalid_argument if the file does not exist
  * @throw std::invalid_argument if the file does not contain the node or parameters columns
  * @throw std::runtime_error if the parameters are not valid for the dissipation scaling function (the function expects a specific format for the parameters)
  */
-std::function<arma::Col<double>(double)> dissipationScalingFunctionFromFile(std::string filename, std::vector<std::string> orderedNodeNames);
+std::function<arma::Col<double>(double)> dissipationScalingFunctionFromFile(std::string filename, std::vector<std::string> orderedNodeNames, std::string expression = "");
 /**
  * @brief Returns a map of vectorized dissipation scaling functions from a folder
  * @param folderPath the path of the folder
  * @param typeToOrderedNodeNames the map of the node names <type, vector of node names>
+ * @param expression the expression of the time t used as the scaling function of the nodes in the files, empty to use the custom function
  * @return  the vector of dissipation scaling functions
  * @details  The files are read using the dissipationScalingFunctionFromFile function
  * @details Also handles the case where the file for a specific type does not exist, in which case the default dissipation scaling function is used
  * @see dissipationScalingFunctionFromFile
  */
-std::map<std::string, std::function<arma::Col<double>(double)>> dissipationScalingFunctionsFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames);
+std::map<std::string, std::function<arma::Col<double>(double)>> dissipationScalingFunctionsFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames, std::string expression = "");
 /**
  * @brief   Returns the conservation scaling function from a file
  * @param filename the name of the file
  * @param orderedNodeNames the vector of node names in the order they are expected
+ * @param expression the expression of the time t used as the scaling function, the parameters of a node are bound to p[0], p[1], ... (see Expression.hxx), empty to use the custom function
  * @return  the vectorized conservation scaling function as a lambda function
  * @details  The file is read using the ifstream function
  * @note    The file must contain the following columns: node, <parameters>
  * @note This function returns the custom conservation scaling function that is defined in \ref CustomFunctions.hxx
  * @note The nodes that are not in the orderedNodeNames vector will be ignored
  * @note The nodes that are not seen in the file will have a scaling function defined with the default one in CustomFunctions.hxx (getConservationScalingFunction())
+ * @note If an expression is passed, it is compiled once for every distinct set of parameters and its breakpoints are added to the ones of the table
+ * @note Nodes with the same parameters share the same function, and the functions are compiled into a ScaleFunctionTable evaluated once per time
  * @throw std::invalid_argument if the file does not exist
  * @throw std::invalid_argument if the file does not contain the node or parameters columns
  * @throw std::runtime_error if the parameters are not valid for the conservation scaling function (the function expects a specific format for the parameters)
  */
-std::function<arma::Col<double>(double)> conservationScalingFunctionFromFile(std::string filename, std::vector<std::string> orderedNodeNames);
+std::function<arma::Col<double>(double)> conservationScalingFunctionFromFile(std::string filename, std::vector<std::string> orderedNodeNames, std::string expression = "");
 /**
  * @brief Returns a map of vectorized conservation scaling functions from a folder
  * @param folderPath the path of the folder
  * @param typeToOrderedNodeNames the map of the node names <type, vector of node names>
+ * @param expression the expression of the time t used as the scaling function of the nodes in the files, empty to use the custom function
  * @return  the vector of conservation scaling functions
  * @details  The files are read using the conservationScalingFunctionFromFile function
  * @details Also handles the case where the file for a specific type does not exist, in which case the default conservation scaling function is used
  * @see conservationScalingFunctionFromFile
  */
-std::map<std::string, std::function<arma::Col<double>(double)>> conservationScalingFunctionsFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames);
+std::map<std::string, std::function<arma::Col<double>(double)>> conservationScalingFunctionsFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames, std::string expression = "");
 /**
  * @brief Returns the propagation scaling function from a file
  * @param filename the name of the file
  * @param orderedNodeNames the vector of node names in the order they are expected
+ * @param expression the expression of the time t used as the scaling function, the parameters of a node are bound to p[0], p[1], ... (see Expression.hxx), empty to use the custom function
  * @return  the vectorized propagation scaling function as a lambda function
  * @details  The file is read using the ifstream function
  * @note    The file must contain the following columns: node, <parameters>
  * @note This function returns the custom propagation scaling function that is defined in \ref CustomFunctions.hxx
  * @note The nodes that are not in the orderedNodeNames vector will be ignored
  * @note The nodes that are not seen in the file will have a scaling function defined with the default one in CustomFunctions.hxx (getPropagationScalingFunction())
+ * @note If an expression is passed, it is compiled once for every distinct set of parameters and its breakpoints are added to the ones of the table
+ * @note Nodes with the same parameters share the same function, and the functions are compiled into a ScaleFunctionTable evaluated once per time
  * @throw std::invalid_argument if the file does not exist
  * @throw std::invalid_argument if the file does not contain the node or parameters columns
  * @throw std::runtime_error if the parameters are not valid for the propagation scaling function (the function expects a specific format for the parameters)
  */
-std::function<arma::Col<double>(double)> propagationScalingFunctionFromFile(std::string filename, std::vector<std::string> orderedNodeNames);
+std::function<arma::Col<double>(double)> propagationScalingFunctionFromFile(std::string filename, std::vector<std::string> orderedNodeNames, std::string expression = "");
 /**
  * @brief Returns a map of vectorized propagation scaling functions from a folder
  * @param folderPath the path of the folder
  * @param typeToOrderedNodeNames the map of the node names <type, vector of node names>
+ * @param expression the expression of the time t used as the scaling function of the nodes in the files, empty to use the custom function
  * @return  the vector of propagation scaling functions
  * @details  The files are read using the propagationScalingFunctionFromFile function
  * @details Also handles the case where the file for a specific type does not exist, in which case the default propagation scaling function is used
  * @see propagationScalingFunctionFromFile
  */
-std::map<std::string, std::function<arma::Col<double>(double)>> propagationScalingFunctionsFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames);
+std::map<std::string, std::function<arma::Col<double>(double)>> propagationScalingFunctionsFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames, std::string expression = "");
+/**
+ * @brief Returns the sensitivity parameters of the per node scaling functions from a parameters file
+ * @param filename the name of the file, with the same format of the files read by dissipationScalingFunctionFromFile, conservationScalingFunctionFromFile and propagationScalingFunctionFromFile
+ * @param orderedNodeNames the vector of node names in the order they are expected
+ * @param target the model whose scaling functions are read, also selects the custom function of CustomFunctions.hxx used when the expression is empty
+ * @param expression the expression of the time t used as the scaling function, the parameters of a node are bound to p[0], p[1], ... (see Expression.hxx), empty to use the custom function
+ * @return  one sensitivity parameter for every parameter of every node in the file, named <target>:<node name>:p<parameter index>
+ * @details The derivative of the scaling value of a node with respect to a parameter is computed with central differences of the scaling function of the node,
+ * exact for the parameters the function is linear in (e.g. the values of the piecewise constant custom functions)
+ * @note The nodes that are not in the orderedNodeNames vector will be ignored, the nodes that are not in the file have no parameters
+ * @throw std::invalid_argument if the file does not exist, if the file does not contain the node or parameters columns or if the parameters are not valid for the scaling function
+ * @see Computation::setSensitivityParameters
+ */
+std::vector<SensitivityParameter> scalingParameterSensitivitiesFromFile(std::string filename, std::vector<std::string> orderedNodeNames, SensitivityTarget target, std::string expression = "");
+/**
+ * @brief Returns a map of the sensitivity parameters of the per node scaling functions from a folder
+ * @param folderPath the path of the folder
+ * @param typeToOrderedNodeNames the map of the node names <type, vector of node names>
+ * @param target the model whose scaling functions are read
+ * @param expression the expression of the time t used as the scaling function of the nodes in the files, empty to use the custom function
+ * @return  the sensitivity parameters of every type, empty for the types without a file (the default functions have no parameters)
+ * @details  The files are read using the scalingParameterSensitivitiesFromFile function
+ * @see scalingParameterSensitivitiesFromFile
+ */
+std::map<std::string, std::vector<SensitivityParameter>> scalingParameterSensitivitiesFromFolder(std::string folderPath, std::map<std::string, std::vector<std::string>> typeToOrderedNodeNames, SensitivityTarget target, std::string expression = "");
 /**
  * @brief   Return the types taken from the file names in a folder with the extension .tsv
  *          that is if the folder contains the files: A.tsv, B.tsv, C.tsv, D.tsv, E.tsv